@@ -41,6 +41,7 @@
 #include "expand.h"
 #include "fatal.h"
 #include "logic.h"
+#include "lpbackend.h"
 #include <math.h>
 #include "memory.h"
 #include "steiner.h"
@@ -100,9 +101,7 @@ static void		build_constraints (struct ainfo *	aip,
 					   int			numS,
 					   struct clist *	clist);
 static LP_t *		build_lp (struct ainfo *	aip,
-				  struct clist *	clist,
-				  struct lpmem *	lpmem);
-static void		destroy_lp (LP_t *, struct lpmem *);
+				  struct clist *	clist);
 /* static void		process_ge (struct ainfo *); */
 static void		process_le (struct ainfo *, int *, int *);
 static void		use_lp (struct ainfo *, int *, int, int *);
@@ -754,39 +753,19 @@ int			status;
 LP_t *			lp;
 double *		x;
 struct clist		clist;
-struct lpmem		lpmem;
 
 
 	build_constraints (aip, shortfall, &clist);
 
-	lp = build_lp (aip, &clist, &lpmem);
+	lp = build_lp (aip, &clist);
 
 	x = NEWA (clist.ncols, double);
 
-#if CPLEX
-	status = _MYCPX_primopt (lp);
-	if (status NE 0) {
-		printf ("CPXprimopt: status = %d\n", status);
-	}
-
-	i = _MYCPX_solution (lp, &status, NULL, x, NULL, NULL, NULL);
-	if (i NE 0) {
-		printf ("CPXsolution: return code = %d\n", i);
-	}
-	if (status NE _MYCPX_STAT_OPTIMAL) {
-		printf ("CPXsolution: status = %d\n", status);
-	}
-#endif
-
-#if LPSOLVE
-	status = solve (lp);
-	if (status NE OPTIMAL) {
+	status = lp -> backend -> optimize (lp);
+	if (status NE LP_OPTIMAL) {
 		printf ("solve: status = %d\n", status);
 	}
-	for (i = 0; i < clist.ncols; i++) {
-		x [i] = lp -> best_solution [lp -> rows + i + 1];
-	}
-#endif
+	lp -> backend -> get_solution (lp, NULL, x, NULL);
 
 	for (i = 0; i < clist.ncols; i++) {
 		if (fabs (x [i]) < 0.0001) continue;
@@ -824,7 +803,7 @@ struct lpmem		lpmem;
 
 non_integral:
 
-	destroy_lp (lp, &lpmem);
+	lp -> backend -> destroy (lp);
 
 	free ((char *) clist.rhs);
 	free ((char *) clist.op);
@@ -1066,208 +1045,16 @@ int			zedge_nz;
 }
 
 /*
- * The CPLEX version of build_lp.
+ * Build the LP for the given list of constraints, using the LP solver
+ * selected by the parameters.
  */
 
-#if CPLEX
-
 	static
 	LP_t *
 build_lp (
 
 struct ainfo *		aip,
-struct clist *		clist,
-struct lpmem *		lpmem
-)
-{
-int			i, j, k;
-int			nrows;
-int			ncols;
-int			macsz, marsz, matsz;
-int			mac, mar;
-int			objsen;
-double *		objx;
-double *		rhsx;
-char *			senx;
-double *		bdl;
-double *		bdu;
-int *			matbeg;
-int *			matcnt;
-int *			matind;
-double *		matval;
-int *			ip1;
-int *			ip2;
-int *			tmp;
-LP_t *			lp;
-
-	nrows	= clist -> nrows;
-	ncols	= clist -> ncols;
-
-	macsz	= ncols;
-	mac	= ncols;
-
-	/* Build the objective function... */
-	objx = NEWA (macsz, double);
-	for (i = 0; i < ncols; i++) {
-		objx [i] = clist -> obj [i];
-	}
-	objsen = _MYCPX_MIN;	/* Minimize */
-
-	/* Build variable bound arrays... */
-	bdl = NEWA (macsz, double);
-	bdu = NEWA (macsz, double);
-	for (i = 0; i < macsz; i++) {
-		bdl [i] = 0.0;
-		bdu [i] = 1.0;
-	}
-
-	/* Allocate enough space to add some additional constraints. */
-	marsz	= nrows + 20;
-	matsz	= (clist -> rows [nrows] - clist -> rows [0]) + 20 * ncols;
-
-	mar = nrows;
-
-	/* Allocate arrays for constraint matrix... */
-	rhsx = NEWA (marsz, double);
-	senx = NEWA (marsz, char);
-	matbeg = NEWA (macsz, int);
-	matcnt = NEWA (macsz, int);
-	matind = NEWA (matsz, int);
-	matval = NEWA (matsz, double);
-
-	/* Now go through each row k and compute the number of	*/
-	/* non-zero coefficients for each variable used...	*/
-	tmp = NEWA (macsz, int);
-	for (i = 0; i < macsz; i++) {
-		tmp [i] = 0;
-	}
-	ip1 = clist -> rows [0];
-	ip2 = clist -> rows [nrows];
-	while (ip1 < ip2) {
-		j = *ip1++;
-		FATAL_ERROR_IF ((j < 0) OR (j >= ncols));
-		++(tmp [j]);
-	}
-
-	/* CPLEX wants columns, not rows... */
-	j = 0;
-	for (i = 0; i < ncols; i++) {
-		k = tmp [i];
-		matbeg [i] = j;
-		tmp [i] = j;
-		matcnt [i] = k;
-		j += k;
-	}
-	for (i = 0; i < nrows; i++) {
-		ip1 = clist -> rows [i];
-		ip2 = clist -> rows [i + 1];
-		while (ip1 < ip2) {
-			j = *ip1++;
-			k = tmp [j];
-			matind [k] = i;
-			matval [k] = 1.0;
-			++(tmp [j]);
-		}
-		switch (clist -> op [i]) {
-		case '<':	senx [i] = 'L';		break;
-		case '=':	senx [i] = 'E';		break;
-		case '>':	senx [i] = 'G';		break;
-		default:
-			FATAL_ERROR;
-		}
-		rhsx [i] = clist -> rhs [i];
-	}
-
-	/* Verify consistency of what we generated... */
-	for (i = 0; i < ncols; i++) {
-		FATAL_ERROR_IF (tmp [i] NE matbeg [i] + matcnt [i]);
-	}
-
-	free ((char *) tmp);
-
-	lp = _MYCPX_loadlp ("analyz",
-			    mac,
-			    mar,
-			    objsen,
-			    objx,
-			    rhsx,
-			    senx,
-			    matbeg,
-			    matcnt,
-			    matind,
-			    matval,
-			    bdl,
-			    bdu,
-			    NULL,
-			    macsz,
-			    marsz,
-			    matsz);
-
-	FATAL_ERROR_IF (lp EQ NULL);
-
-	/* Remember addresses of each buffer for when we need to free them. */
-	lpmem -> objx		= objx;
-	lpmem -> rhsx		= rhsx;
-	lpmem -> senx		= senx;
-	lpmem -> matbeg		= matbeg;
-	lpmem -> matcnt		= matcnt;
-	lpmem -> matind		= matind;
-	lpmem -> matval		= matval;
-	lpmem -> bdl		= bdl;
-	lpmem -> bdu		= bdu;
-
-	return (lp);
-}
-
-#endif
-
-/*
- * The CPLEX version of the routine to free up the LP.
- */
-
-#if CPLEX
-
-	static
-	void
-destroy_lp (
-
-LP_t *			lp,
-struct lpmem *		lpmem
-)
-{
-	/* Free up CPLEX's memory... */
-	if (_MYCPX_freeprob (&lp) NE 0) {
-		FATAL_ERROR;
-	}
-
-	/* Free up our own memory... */
-	free ((char *) (lpmem -> objx));
-	free ((char *) (lpmem -> rhsx));
-	free ((char *) (lpmem -> senx));
-	free ((char *) (lpmem -> matbeg));
-	free ((char *) (lpmem -> matcnt));
-	free ((char *) (lpmem -> matind));
-	free ((char *) (lpmem -> matval));
-	free ((char *) (lpmem -> bdl));
-	free ((char *) (lpmem -> bdu));
-	memset ((char *) lpmem, 0, sizeof (*lpmem));
-}
-
-#endif
-
-/*
- * The lp_solve version of build_lp.
- */
-
-#if LPSOLVE
-
-	static
-	LP_t *
-build_lp (
-
-struct ainfo *		aip,
-struct clist *		clist,
-struct lpmem *		lpmem
+struct clist *		clist
 )
 {
 int			i, j;
@@ -1275,44 +1062,53 @@ int			nrows;
 int			ncols;
 int			ncoeff;
 int			nzi;
+double *		bdl;
+double *		bdu;
 double *		rhs;
-short *			ctype;
+char *			sense;
 int *			matbeg;
 int *			matind;
 double *		matval;
 int *			ip1;
 int *			ip2;
+const struct lp_backend *	be;
 LP_t *			lp;
 
 	nrows	= clist -> nrows;
 	ncols	= clist -> ncols;
 	ncoeff	= clist -> rows [nrows] - clist -> rows [0];
 
-	/* Make the initial LP... */
-	lp = make_lp (0, ncols);
-
 	/* All variables are 0-1 variables... */
-	for (i = 1; i <= ncols; i++) {
-		set_bounds (lp, i, 0.0, 1.0);
+	bdl = NEWA (ncols, double);
+	bdu = NEWA (ncols, double);
+	for (i = 0; i < ncols; i++) {
+		bdl [i] = 0.0;
+		bdu [i] = 1.0;
 	}
 
-	/* Minimize */
-	set_minim (lp);
-
-	/* Set the objective function... */
-#if 1
-	inc_mat_space (lp, ncols + 1);
-#endif
-	set_obj_fn (lp, clist -> obj - 1);
+	/* Make the initial LP, with space to add some additional	*/
+	/* constraints...						*/
+	be = _gst_select_lp_backend (aip -> bbip -> params);
+	lp = be -> create ("analyz",
+			   ncols,
+			   LP_MINIMIZE,
+			   clist -> obj,
+			   bdl,
+			   bdu,
+			   nrows + 20,
+			   ncoeff + 20 * ncols);
+
+	free ((char *) bdu);
+	free ((char *) bdl);
 
 	/* Allocate arrays for setting the rows... */
 	rhs	= NEWA (nrows, double);
-	ctype	= NEWA (nrows, short);
+	sense	= NEWA (nrows, char);
 	matbeg	= NEWA (nrows + 1, int);
 	matind	= NEWA (ncoeff, int);
 	matval	= NEWA (ncoeff, double);
 
-	/* Put the rows into the format that LP-solve wants them in...	*/
+	/* Put the rows into the format that the LP solver wants them in... */
 	nzi = 0;
 	for (i = 0; i < nrows; i++) {
 		matbeg [i] = nzi;
@@ -1320,15 +1116,16 @@ LP_t *			lp;
 		ip2 = clist -> rows [i + 1];
 		while (ip1 < ip2) {
 			j = *ip1++;
+			FATAL_ERROR_IF ((j < 0) OR (j >= ncols));
 			matind [nzi] = j;
 			matval [nzi] = 1.0;
 			++nzi;
 		}
 		rhs [i] = clist -> rhs [i];
 		switch (clist -> op [i]) {
-		case '<':	ctype [i] = REL_LE;	break;
-		case '=':	ctype [i] = REL_EQ;	break;
-		case '>':	ctype [i] = REL_GE;	break;
+		case '<':	sense [i] = 'L';	break;
+		case '=':	sense [i] = 'E';	break;
+		case '>':	sense [i] = 'G';	break;
 		default:
 			FATAL_ERROR;
 			break;
@@ -1337,36 +1134,13 @@ LP_t *			lp;
 	matbeg [i] = nzi;
 	FATAL_ERROR_IF (nzi NE ncoeff);
 
-	add_rows (lp, 0, nrows, rhs, ctype, matbeg, matind, matval);
+	lp -> backend -> add_rows (lp, nrows, rhs, sense, matbeg, matind, matval);
 
 	free ((char *) matval);
 	free ((char *) matind);
 	free ((char *) matbeg);
-	free ((char *) ctype);
+	free ((char *) sense);
 	free ((char *) rhs);
 
 	return (lp);
 }
-
-#endif
-
-/*
- * The lp_solve version of the routine to free up the LP.
- */
-
-#if LPSOLVE
-
-	static
-	void
-destroy_lp (
-
-LP_t *			lp,
-struct lpmem *		lpmem
-)
-{
-	(void) lpmem;
-
-	delete_lp (lp);
-}
-
-#endif
@@ -85,6 +85,7 @@
 #include "io.h"
 #include "localcut.h"
 #include "logic.h"
+#include "lpbackend.h"
 #include <math.h>
 #include "memory.h"
 #include "parmblk.h"
@@ -144,15 +145,6 @@ struct bvar {			/* Info about best branch var seen */
 	double	test_2nd_val;	/* Only check 2nd branch if 1st > this. */
 };
 
-#ifdef CPLEX
-
-struct basis_save {	/* Structure to save basis state for CPLEX */
-	int *		cstat;
-	int *		rstat;
-};
-
-#endif
-
 
 /*
  * Local Routines
@@ -161,7 +153,10 @@ struct basis_save {	/* Structure to save basis state for CPLEX */
 static int		carefully_choose_branching_variable (struct bbinfo *,
 							     double *,
 							     double *);
-static void		change_var_bounds (LP_t *, int, double, double);
+static void		change_var_bounds (LP_t *,
+					   int,
+					   double,
+					   double);
 static void		check_root_constraints (struct bbinfo *);
 static int		choose_branching_variable (struct bbinfo *,
 						   double *,
@@ -177,7 +172,6 @@ static struct constraint * do_separations (struct bbinfo *,
 static bool		eval_branch_var (struct bbinfo *,
 					 int,
 					 int,
-					 struct basis_save *,
 					 double);
 static int		fix_variables (struct bbinfo *,
 				       int *, int,
@@ -191,18 +185,6 @@ static struct bbnode *	select_next_node (struct bbtree *);
 static void		sort_branching_vars (int *, int, double *);
 static void		trace_node (struct bbinfo *, char, char *);
 static void		update_node_preempt_value (struct bbinfo *);
-
-#ifdef CPLEX
-static void		destroy_LP_basis (struct basis_save *);
-static double		try_branch (LP_t *,
-				    int,
-				    int,
-				    double *,
-				    double,
-				    struct basis_save *,
-				    struct bbinfo *);
-static void		save_LP_basis (LP_t *, struct basis_save *);
-#endif
 
 /*
  * Set up the initial branch-and-bound problem, including the root
@@ -232,7 +214,6 @@ struct cpool *		cpool;
 struct bbstats *	statp;
 struct bbtree *		bbtree;
 struct bbnode *		root;
-struct lpmem *		lpmem;
 struct rcon *		rcp;
 struct gst_hypergraph *	cip;
 gst_param_ptr		params;
@@ -257,12 +238,10 @@ gst_param_ptr		params;
 	_gst_initialize_constraint_pool (cpool, vert_mask, edge_mask, cip, params);
 
 	/* Build initial formulation. */
-	lpmem = NEW (struct lpmem);
 	lp = _gst_build_initial_formulation (cpool,
 					     vert_mask,
 					     edge_mask,
 					     cip,
-					     lpmem,
 					     params);
 	UNINDENT (params -> print_solve_trace);
 
@@ -365,7 +344,6 @@ gst_param_ptr		params;
 	bbip -> vert_mask	= vert_mask;
 	bbip -> edge_mask	= edge_mask;
 	bbip -> lp		= lp;
-	bbip -> lpmem		= lpmem;
 	bbip -> cpool		= cpool;
 	bbip -> bbtree		= bbtree;
 	bbip -> csip		= NULL;
@@ -473,13 +451,9 @@ struct bbnode *		node2;
 gst_param_ptr		params;
 gst_channel_ptr		trace;
 
-#ifdef CPLEX
 int *			b_index;
-char *			b_lu;
-double *		b_bd;
-double			objlim;
-double			save_objlim;
-#endif
+double *		b_lower;
+double *		b_upper;
 
 	bbip		= solver -> bbip;
 	bbip -> t0	= solver -> t0;
@@ -523,12 +497,9 @@ double			save_objlim;
 		FATAL_ERROR_IF (bbip -> rcfile EQ NULL);
 	}
 
-#if CPLEX
-	/* Save the existing objective limit, and set it to infinity. */
-	CPXgetdblparam (cplex_env, CPX_PARAM_OBJULIM, &save_objlim);
-	objlim = DBL_MAX;
-	CPXsetdblparam (cplex_env, CPX_PARAM_OBJULIM, objlim);
-#endif
+	/* Let the LP solver set itself up for the run (e.g., save	*/
+	/* the existing objective limit and set it to infinity).	*/
+	lp -> backend -> begin_bb (lp);
 
 	/* Restore upper bound, if available. */
 	x = _gst_restore_upper_bound_checkpoint (bbip);
@@ -555,12 +526,10 @@ double			save_objlim;
 	bbip -> fixed = fixed;
 	bbip -> value = value;
 
-#ifdef CPLEX
 	/* Create arrays for changing variable bounds... */
-	b_index	= NEWA (2 * nedges, int);
-	b_lu	= NEWA (2 * nedges, char);
-	b_bd	= NEWA (2 * nedges, double);
-#endif
+	b_index	= NEWA (nedges, int);
+	b_lower	= NEWA (nedges, double);
+	b_upper	= NEWA (nedges, double);
 
 #if 0
 	/* Build cutset separation formulation.  This is not checkpointed. */
@@ -645,69 +614,38 @@ double			save_objlim;
 			delta [i] =   (fixed [i] ^ node -> fixed [i])
 				    | (value [i] ^ node -> value [i]);
 		}
-#ifdef CPLEX
 		j = 0;
 		for (i = 0; i < nedges; i++) {
 			if (NOT BITON (delta, i)) continue;
 			/* Force bounds for variable 'i' to be correct... */
-			b_index [j]	= i;	/* variable i, */
-			b_lu [j]	= 'L';	/*	lower bound */
-			b_index [j+1]	= i;	/* variable i, */
-			b_lu [j+1]	= 'U';	/*	upper bound */
+			b_index [j] = i;
 			if (NOT BITON (node -> fixed, i)) {
 				/* new variable is NOT fixed... */
-				b_bd [j]	= 0.0;
-				b_bd [j+1]	= 1.0;
+				b_lower [j]	= 0.0;
+				b_upper [j]	= 1.0;
 			}
 			else if (NOT BITON (node -> value, i)) {
 				/* new variable is fixed to 0 */
-				b_bd [j]	= 0.0;
-				b_bd [j+1]	= 0.0;
+				b_lower [j]	= 0.0;
+				b_upper [j]	= 0.0;
 			}
 			else {
 				/* new variable is fixed to 1 */
-				b_bd [j]	= 1.0;
-				b_bd [j+1]	= 1.0;
-			}
-			j += 2;
-		}
-		if (j > 0) {
-			if (_MYCPX_chgbds (lp, j, b_index, b_lu, b_bd) NE 0) {
-				FATAL_ERROR;
+				b_lower [j]	= 1.0;
+				b_upper [j]	= 1.0;
 			}
-#if 0
-			++(bbip -> cpool -> uid);
-#endif
-		}
-#endif
-
-#ifdef LPSOLVE
-		j = 0;
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (delta, i)) continue;
 			++j;
-			/* Force bounds on variable 'i' to be correct... */
-			if (NOT BITON (node -> fixed, i)) {
-				/* variable is NOT fixed... */
-				set_bounds (lp, i + 1, 0.0, 1.0);
-			}
-			else if (NOT BITON (node -> value, i)) {
-				/* variable is fixed to 0 */
-				set_bounds (lp, i + 1, 0.0, 0.0);
-			}
-			else {
-				/* variable is fixed to 1 -- must set	*/
-				/* bounds in this order to avoid	*/
-				/* lb > ub condition between calls...	*/
-				set_bounds (lp, i + 1, 1.0, 1.0);
-			}
 		}
 		if (j > 0) {
+			lp -> backend -> set_bounds (lp,
+						     j,
+						     b_index,
+						     b_lower,
+						     b_upper);
 #if 0
 			++(bbip -> cpool -> uid);
 #endif
 		}
-#endif
 
 		for (i = 0; i < nmasks; i++) {
 			fixed [i] = node -> fixed [i];
@@ -727,10 +665,6 @@ double			save_objlim;
 		status = compute_good_lower_bound (bbip);
 		fprintf(stderr, "DEBUG BB: compute_good_lower_bound returned status=%d\n", status);
 
-		/* Note: The previous call changes bbip->lp when	*/
-		/* handling the CPLEX "unscaled infeasibility" issue.	*/
-		lp = bbip -> lp;
-
 		/* Save for potential access by callbacks. */
 		node -> lb_status = status;
 
@@ -928,19 +862,15 @@ suspend:
 
 	solver -> lowerbound = bbip -> prevlb;
 
-#if CPLEX
-	free ((char *) b_bd);
-	free ((char *) b_lu);
+	free ((char *) b_upper);
+	free ((char *) b_lower);
 	free ((char *) b_index);
-#endif
 
 	free ((char *) delta);
 	free ((char *) value);
 	free ((char *) fixed);
 
-#if CPLEX
-	CPXsetdblparam (cplex_env, CPX_PARAM_OBJULIM, save_objlim);
-#endif
+	lp -> backend -> end_bb (lp);
 }
 
 /*
@@ -1211,7 +1141,6 @@ double			test_2nd_val;
 double			num;
 double			den;
 struct bvar		best;
-struct basis_save	bsave;
 gst_channel_ptr		param_print_solve_trace;
 
 	param_print_solve_trace = bbip -> params -> print_solve_trace;
@@ -1306,7 +1235,7 @@ gst_channel_ptr		param_print_solve_trace;
 
 	/* Snapshot the current basis so that we can quickly	*/
 	/* get back to it each time...				*/
-	save_LP_basis (bbip -> lp, &bsave);
+	bbip -> lp -> backend -> save_branch_basis (bbip -> lp);
 
 	/* Compute the non-improvement limit.  When we have tested this	*/
 	/* many consecutive variables without finding a better choice,	*/
@@ -1393,7 +1322,6 @@ again:
 			fixed = eval_branch_var (bbip,
 						 i,
 						 0,	/* Xi=0, then Xi=1 */
-						 &bsave,
 						 test_2nd_val);
 		}
 		else {
@@ -1401,7 +1329,6 @@ again:
 			fixed = eval_branch_var (bbip,
 						 i,
 						 1,	/* Xi=1, then Xi=0 */
-						 &bsave,
 						 test_2nd_val);
 		}
 
@@ -1409,7 +1336,7 @@ again:
 #if 1
 			/* Special return code that says to try */
 			/* re-solving the LP again.		*/
-			destroy_LP_basis (&bsave);
+			bbip -> lp -> backend -> free_branch_basis (bbip -> lp);
 			free ((char *) fvars);
 			return (-1);
 #elif 0
@@ -1485,7 +1412,7 @@ get_out:
 		best.var, best.z0, best.z1);
 #endif
 
-	destroy_LP_basis (&bsave);
+	bbip -> lp -> backend -> free_branch_basis (bbip -> lp);
 
 	free ((char *) fvars);
 
@@ -1598,14 +1525,11 @@ eval_branch_var (
 struct bbinfo *		bbip,		/* IN - branch-and-bound info */
 int			var,		/* IN - variable to branch */
 int			dir1,		/* IN - first branch direction */
-struct basis_save *	basp,		/* IN - basis to restore when done */
 double			test_2nd_val	/* IN - test 2nd if 1st is > this */
 )
 {
 int			i;
-int			nedges;
 int			dir2;
-struct gst_hypergraph *	cip;
 LP_t *			lp;
 struct bbnode *		nodep;
 bool			found;
@@ -1613,26 +1537,13 @@ bool			fixed;
 double *		x;
 double			z;
 
-	cip	= bbip -> cip;
 	lp	= bbip -> lp;
 	nodep	= bbip -> node;
 
-	nedges = cip -> num_edges;
-
-	/* PSW: In multi-objective mode, we need space for FST + not_covered variables */
-	int num_not_covered_vars = 0;
-	char* budget_env_check = getenv("GEOSTEINER_BUDGET");
-	if (budget_env_check != NULL) {
-		bitmap_t* vert_mask_local = cip -> initial_vert_mask;
-		/* Count terminals for not_covered variables */
-		for (int i = 0; i < cip -> num_verts; i++) {
-			if (BITON (vert_mask_local, i) && cip -> tflag[i]) {
-				num_not_covered_vars++;
-			}
-		}
-	}
-	int total_vars_local = nedges + num_not_covered_vars;
-	x = NEWA (total_vars_local, double);
+	/* The LP has a not_covered column for each terminal as well	*/
+	/* as one per FST (in every mode, not only in budget mode),	*/
+	/* and try_branch returns the values of all of them.		*/
+	x = NEWA (GET_LP_NUM_COLS (lp), double);
 
 	dir2 = 1 - dir1;
 
@@ -1640,13 +1551,12 @@ double			z;
 
 	/* Try the first branch direction... */
 	fprintf(stderr, "DEBUG EVAL: Testing var %d = %d, best_z=%.6f\n", var, dir1, bbip -> best_z);
-#if CPLEX
-	fprintf(stderr, "DEBUG EVAL: About to call try_branch(lp, %d, %d, x, DBL_MAX, basp, bbip)\n", var + 1, dir1);
-	z = try_branch (lp, var + 1, dir1, x, DBL_MAX, basp, bbip);
-	fprintf(stderr, "DEBUG EVAL: try_branch returned z=%.6f\n", z);
-#else
-	z = try_branch (lp, var + 1, dir1, x, DBL_MAX, basp);
-#endif
+	z = lp -> backend -> try_branch (lp,
+					 var,
+					 dir1,
+					 x,
+					 DBL_MAX,
+					 bbip -> params -> print_solve_trace);
 	fprintf(stderr, "DEBUG EVAL: Branch var %d = %d gives z=%.6f\n", var, dir1, z);
 
 	/* Check for a better integer feasible solution... */
@@ -1713,12 +1623,8 @@ double			z;
 
 		_gst_solve_LP_over_constraint_pool (bbip);
 
-		/* Note: The previous call changes bbip->lp when	*/
-		/* handling the CPLEX "unscaled infeasibility" issue.	*/
-		lp = bbip -> lp;
-
-		destroy_LP_basis (basp);
-		save_LP_basis (lp, basp);
+		lp -> backend -> free_branch_basis (lp);
+		lp -> backend -> save_branch_basis (lp);
 
 		/* Try finding a good heuristic solution on the	*/
 		/* new fixed solution...			*/
@@ -1743,13 +1649,12 @@ double			z;
 
 	/* Try the second branch direction... */
 	fprintf(stderr, "DEBUG EVAL: About to test second branch var %d = %d\n", var, dir2);
-#if CPLEX
-	fprintf(stderr, "DEBUG EVAL: Calling try_branch(lp, %d, %d, x, DBL_MAX, basp, bbip)\n", var + 1, dir2);
-	z = try_branch (lp, var + 1, dir2, x, DBL_MAX, basp, bbip);
-	fprintf(stderr, "DEBUG EVAL: Second branch returned z=%.6f\n", z);
-#else
-	z = try_branch (lp, var + 1, dir2, x, DBL_MAX, basp);
-#endif
+	z = lp -> backend -> try_branch (lp,
+					 var,
+					 dir2,
+					 x,
+					 DBL_MAX,
+					 bbip -> params -> print_solve_trace);
 
 	/* Check for better integer feasible solution... */
 	/* Skip IFS check in multi-objective mode to avoid incompatible comparisons */
@@ -1815,12 +1720,8 @@ double			z;
 
 		_gst_solve_LP_over_constraint_pool (bbip);
 
-		/* Note: The previous call changes bbip->lp when	*/
-		/* handling the CPLEX "unscaled infeasibility" issue.	*/
-		lp = bbip -> lp;
-
-		destroy_LP_basis (basp);
-		save_LP_basis (lp, basp);
+		lp -> backend -> free_branch_basis (lp);
+		lp -> backend -> save_branch_basis (lp);
 
 		/* Try finding a good heuristic solution on the	*/
 		/* new fixed solution...			*/
@@ -2072,153 +1973,6 @@ double			z;
 	return (FALSE);
 }
 
-/*
- * This routine saves the current basis of the given LP.
- */
-
-#ifdef CPLEX
-
-	static
-	void
-save_LP_basis (
-
-LP_t *			lp,		/* IN - LP to save basis for */
-struct basis_save *	basp		/* OUT - saved basis info */
-)
-{
-int		rows;
-int		cols;
-
-	rows = _MYCPX_getnumrows (lp);
-	cols = _MYCPX_getnumcols (lp);
-
-	basp -> cstat = NEWA (cols, int);
-	basp -> rstat = NEWA (rows, int);
-
-	if (_MYCPX_getbase (lp, basp -> cstat, basp -> rstat) NE 0) {
-		FATAL_ERROR;
-	}
-}
-
-/*
- * Destroy the saved basis info...
- */
-
-	static
-	void
-destroy_LP_basis (
-
-struct basis_save *	basp		/* IN - basis info to free up */
-)
-{
-#if CPLEX >= 40
-	free ((char *) (basp -> rstat));
-	free ((char *) (basp -> cstat));
-#endif
-}
-
-#endif
-
-/*
- * This routine tries the given branch by solving the LP.  It
- * returns the resulting objective value, or INF_DISTANCE if something
- * goes wrong (like infeasible).
- */
-
-#ifdef CPLEX
-
-	static
-	double
-try_branch (
-
-LP_t *			lp,		/* IN - LP to re-optimize */
-int			var,		/* IN - variable to try branching */
-int			dir,		/* IN - branch direction, 0 or 1 */
-double *		x,		/* OUT - LP solution obtained */
-double			ival,		/* IN - value to give if infeasible */
-struct basis_save *	basp,		/* IN - basis to restore when done */
-struct bbinfo *		bbip		/* IN - branch and bound info */
-)
-{
-int		status;
-gst_param_ptr	params;
-double		z;
-int		b_index [2];
-char		b_lu [2];
-double		b_bd [2];
-
-	params = bbip -> params;
-
-	fprintf(stderr, "DEBUG TRY_BRANCH: Called with var=%d, dir=%d\n", var, dir);
-	--var;		/* vars are zero-origined in CPLEX... */
-	fprintf(stderr, "DEBUG TRY_BRANCH: After decrement, var=%d\n", var);
-
-	b_index [0] = var;	b_lu [0] = 'L';
-	b_index [1] = var;	b_lu [1] = 'U';
-	if (dir EQ 0) {
-		b_bd [0] = 0.0;
-		b_bd [1] = 0.0;
-	}
-	else {
-		b_bd [0] = 1.0;
-		b_bd [1] = 1.0;
-	}
-	if (_MYCPX_chgbds (lp, 2, b_index, b_lu, b_bd) NE 0) {
-		FATAL_ERROR;
-	}
-
-	/* Solve the current LP instance... */
-	status = _MYCPX_dualopt (lp);
-	if (status NE 0) {
-		gst_channel_printf (params -> print_solve_trace,
-			" WARNING dualopt: status = %d\n", status);
-	}
-
-	/* Get current LP solution... */
-	if (_MYCPX_solution (lp, &status, &z, x, NULL, NULL, NULL) NE 0) {
-		FATAL_ERROR;
-	}
-
-	/* Determine type of LP result... */
-	switch (status) {
-	case _MYCPX_STAT_OPTIMAL:
-	case _MYCPX_STAT_OPTIMAL_INFEAS:
-		/* Unscale the objective value. */
-		z = ldexp (z, bbip -> lpmem -> obj_scale);
-		break;
-
-	case _MYCPX_STAT_INFEASIBLE:
-	case _MYCPX_STAT_UNBOUNDED:
-			/* (CPLEX 3.0 sometimes gives us infeasible!) */
-	case _MYCPX_STAT_ABORT_OBJ_LIM:	/* Objective limit exceeded. */
-		z = ival;
-		break;
-
-	default:
-		gst_channel_printf (params -> print_solve_trace, "Status = %d\n", status);
-		_MYCPX_lpwrite (lp, "core.lp");
-		FATAL_ERROR;
-		break;
-	}
-
-	b_bd [0] = 0.0;
-	b_bd [1] = 1.0;
-	if (_MYCPX_chgbds (lp, 2, b_index, b_lu, b_bd) NE 0) {
-		FATAL_ERROR;
-	}
-
-	/* Restore the basis... */
-	status = _MYCPX_copybase (lp, basp -> cstat, basp -> rstat);
-	if (status NE 0) {
-		fprintf (stderr, "try_branch: status = %d\n", status);
-		FATAL_ERROR;
-	}
-
-	return (z);
-}
-
-#endif
-
 /*
  * This routine computes the lower-bound for the current node, which
  * consists of solving the LP and generating violated constraints
@@ -2277,9 +2031,6 @@ gst_channel_ptr		param_print_solve_trace;
 	for (;;) {
 		status = _gst_solve_LP_over_constraint_pool (bbip);
 
-		/* Note: The previous call changes bbip->lp when	*/
-		/* handling the CPLEX "unscaled infeasibility" issue.	*/
-
 		z = nodep -> z;
 
 		Tlp = _gst_get_cpu_time ();
@@ -2394,13 +2145,13 @@ gst_channel_ptr		param_print_solve_trace;
 			FATAL_ERROR;
 		}
 
-#ifdef CPLEX
-		/* Now get rid of any rows that have become	*/
-		/* slack.  (We don't lose these constraints:	*/
-		/* they're still sitting around in the		*/
-		/* constraint pool.)				*/
-		_gst_delete_slack_rows_from_LP (bbip);
-#endif
+		if (bbip -> lp -> backend -> delete_slack_first) {
+			/* Now get rid of any rows that have become	*/
+			/* slack.  (We don't lose these constraints:	*/
+			/* they're still sitting around in the		*/
+			/* constraint pool.)				*/
+			_gst_delete_slack_rows_from_LP (bbip);
+		}
 
 		/* Solution is feasible, check for integer-feasible... */
 		is_int = integer_feasible_solution (x, bbip);
@@ -2528,13 +2279,13 @@ gst_channel_ptr		param_print_solve_trace;
 			break;
 		}
 
-#ifdef LPSOLVE
-		/* Now get rid of any rows that have become	*/
-		/* slack.  (We don't lose these constraints:	*/
-		/* they're still sitting around in the		*/
-		/* constraint pool.)				*/
-		_gst_delete_slack_rows_from_LP (bbip);
-#endif
+		if (NOT bbip -> lp -> backend -> delete_slack_first) {
+			/* Now get rid of any rows that have become	*/
+			/* slack.  (We don't lose these constraints:	*/
+			/* they're still sitting around in the		*/
+			/* constraint pool.)				*/
+			_gst_delete_slack_rows_from_LP (bbip);
+		}
 
 		/* Add new contraints to the constraint pool. */
 		num_const = _gst_add_constraints (bbip, cp);
@@ -2680,21 +2431,8 @@ gst_param_ptr		params;
 	/* We HAVE a new best solution! */
 	bbip -> best_z = ub;
 
-#if CPLEX
-	{ double toobig, toosmall, ulim;
-	  /* Set new cutoff value for future LPs... */
-	  ulim = ldexp (ub, -(bbip -> lpmem -> obj_scale));
-	  if (_MYCPX_setobjulim (ulim, &toosmall, &toobig) NE 0) {
-		FATAL_ERROR;
-	  }
-	}
-#endif
-
-#if LPSOLVE
 	/* Set new cutoff value for future LPs... */
-	/* (This may not really work in lp_solve.) */
-	bbip -> lp -> obj_bound = ub;
-#endif
+	bbip -> lp -> backend -> set_cutoff (bbip -> lp, ub);
 
 	cut_off_existing_nodes (ub, bbip);
 
@@ -3224,7 +2962,8 @@ struct inc_info		inc_info;
 			    (nodep -> x [e] + FUZZ < 1.0)) {
 				++fix_frac;
 			}
-			change_var_bounds (bbip -> lp, e, 0.0, 0.0);
+			change_var_bounds (bbip -> lp,
+					   e, 0.0, 0.0);
 			++fix0_count;
 #ifdef PRINT_FIXED_VARIABLES
 			gst_channel_printf (bbip -> params -> print_solve_trace,
@@ -3312,7 +3051,8 @@ struct inc_info		inc_info;
 			    (nodep -> x [e] + FUZZ < 1.0)) {
 				++fix_frac;
 			}
-			change_var_bounds (bbip -> lp, e, 1.0, 1.0);
+			change_var_bounds (bbip -> lp,
+					   e, 1.0, 1.0);
 			++fix1_count;
 #ifdef PRINT_FIXED_VARIABLES
 			gst_channel_printf (bbip -> params -> print_solve_trace,
@@ -3401,21 +3141,7 @@ double			lower,		/* IN - lower bound */
 double			upper		/* IN - upper bound */
 )
 {
-#if CPLEX
-int			b_index [2];
-char			b_lu [2];
-double			b_bd [2];
-
-	b_index [0] = var;	b_lu [0] = 'L';		b_bd [0] = lower;
-	b_index [1] = var;	b_lu [1] = 'U';		b_bd [1] = upper;
-	if (_MYCPX_chgbds (lp, 2, b_index, b_lu, b_bd) NE 0) {
-		FATAL_ERROR;
-	}
-#endif
-
-#if LPSOLVE
-	set_bounds (lp, var + 1, lower, upper);
-#endif
+	lp -> backend -> set_bounds (lp, 1, &var, &lower, &upper);
 }
 
 /*
@@ -43,8 +43,10 @@
 #define _GNU_SOURCE
 
 #include "bitmaskmacros.h"
-#include "lpsolver.h"
+#include "lpbackend.h"
 #include "polltime.h"
+#include <stdio.h>
+#include <stdlib.h>
 
 struct gst_hypergraph;
 struct gst_param;
@@ -195,7 +197,6 @@ struct bbinfo {
 	bitmap_t *	vert_mask; /* Set of valid vertices in problem */
 	bitmap_t *	edge_mask; /* Set of valid edges in problem */
 	LP_t *		lp;	/* the main LP problem instance */
-	struct lpmem *	lpmem;	/* memory allocated for LP problem instance */
 	struct cpool *	cpool;	/* the global pool of constraints */
 	struct bbtree *	bbtree;	/* the branch-and-bound tree */
 	struct cs_info * csip;	/* cutset separation info */
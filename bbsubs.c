@@ -42,6 +42,7 @@
 #include "bb.h"
 #include "constrnt.h"
 #include "cutset.h"
+#include "environment.h"
 #include "fatal.h"
 #include "geosteiner.h"
 #include "logic.h"
@@ -595,10 +596,6 @@ struct bbnode *		p2;
 		_gst_destroy_initial_formulation (bbip);
 	}
 
-	if (bbip -> lpmem NE NULL) {
-		free ((char *) (bbip -> lpmem));
-	}
-
 	_gst_stop_using_lp_solver ();
 
 	/* These items all belong to the gst_hypergraph.  Just zap them. */
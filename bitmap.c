@@ -0,0 +1,282 @@
+/***********************************************************************
+
+	File:	bitmap.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Counting the bits of whole bit masks.  On x86-64 processors
+	supporting AVX2, 256 bits are combined and counted at a time;
+	otherwise (or on other machines) one word at a time.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "bitmap.h"
+
+#include "bitmaskmacros.h"
+#include "cpufeat.h"
+#include "gsttypes.h"
+#include "logic.h"
+
+
+/*
+ * Global Routines
+ */
+
+int		_gst_bitmap_and_count (const bitmap_t *,
+				       const bitmap_t *,
+				       int);
+int		_gst_bitmap_andnot_count (const bitmap_t *,
+					  const bitmap_t *,
+					  int);
+int		_gst_bitmap_count (const bitmap_t *, int);
+int		_gst_bitmap_or_count (const bitmap_t *,
+				      const bitmap_t *,
+				      int);
+
+
+/*
+ * How two masks are combined before counting.
+ */
+
+enum bitmap_op {
+	OP_FIRST,		/* a */
+	OP_AND,			/* a & b */
+	OP_ANDNOT,		/* a & ~b */
+	OP_OR,			/* a | b */
+};
+
+
+/*
+ * Local Routines
+ */
+
+static int		count_bits (const bitmap_t *,
+				    const bitmap_t *,
+				    int,
+				    enum bitmap_op);
+static int		count_words_scalar (const bitmap_t *,
+					    const bitmap_t *,
+					    int,
+					    int,
+					    enum bitmap_op);
+
+#ifdef USE_AVX2_KERNELS
+static int		count_words_avx2 (const bitmap_t *,
+					  const bitmap_t *,
+					  int,
+					  enum bitmap_op);
+#endif
+
+/*
+ * Number of bits set in a word.
+ */
+
+#if defined (__GNUC__)
+	#define	POPCOUNT(w)	__builtin_popcount (w)
+#else
+	#define	POPCOUNT(w)	NBITSON (w)
+#endif
+
+/*
+ * Combine two words of the masks.
+ */
+
+#define	COMBINE(a, b, op)					\
+	(((op) EQ OP_FIRST)	? (a) :				\
+	 ((op) EQ OP_AND)	? ((a) & (b)) :			\
+	 ((op) EQ OP_ANDNOT)	? ((a) & ~(b)) :		\
+				  ((a) | (b)))
+
+/*
+ * Return the number of bits set among the first nbits of the mask.
+ */
+
+	int
+_gst_bitmap_count (
+
+const bitmap_t *	bm,	/* IN - bit mask */
+int			nbits	/* IN - number of bits */
+)
+{
+	return (count_bits (bm, bm, nbits, OP_FIRST));
+}
+
+/*
+ * Return the number of bits set in both masks, among the first nbits.
+ */
+
+	int
+_gst_bitmap_and_count (
+
+const bitmap_t *	a,	/* IN - first bit mask */
+const bitmap_t *	b,	/* IN - second bit mask */
+int			nbits	/* IN - number of bits */
+)
+{
+	return (count_bits (a, b, nbits, OP_AND));
+}
+
+/*
+ * Return the number of bits set in a but not in b, among the first
+ * nbits.
+ */
+
+	int
+_gst_bitmap_andnot_count (
+
+const bitmap_t *	a,	/* IN - first bit mask */
+const bitmap_t *	b,	/* IN - second bit mask */
+int			nbits	/* IN - number of bits */
+)
+{
+	return (count_bits (a, b, nbits, OP_ANDNOT));
+}
+
+/*
+ * Return the number of bits set in either mask, among the first nbits.
+ */
+
+	int
+_gst_bitmap_or_count (
+
+const bitmap_t *	a,	/* IN - first bit mask */
+const bitmap_t *	b,	/* IN - second bit mask */
+int			nbits	/* IN - number of bits */
+)
+{
+	return (count_bits (a, b, nbits, OP_OR));
+}
+
+/*
+ * Count the bits of the combined masks among the first nbits.  Bits
+ * beyond nbits in the last word are ignored.
+ */
+
+	static
+	int
+count_bits (
+
+const bitmap_t *	a,	/* IN - first bit mask */
+const bitmap_t *	b,	/* IN - second bit mask */
+int			nbits,	/* IN - number of bits */
+enum bitmap_op		op	/* IN - how to combine the masks */
+)
+{
+int		count;
+int		nwords;
+bitmap_t	word;
+
+	if (nbits <= 0) return (0);
+
+	nwords = nbits / BPW;
+
+#ifdef USE_AVX2_KERNELS
+	if (_gst_have_avx2 ()) {
+		count = count_words_avx2 (a, b, nwords, op);
+	}
+	else
+#endif
+	{
+		count = count_words_scalar (a, b, 0, nwords, op);
+	}
+
+	if ((nbits % BPW) NE 0) {
+		word = COMBINE (a [nwords], b [nwords], op);
+		word &= (((bitmap_t) 1) << (nbits % BPW)) - 1;
+		count += POPCOUNT (word);
+	}
+
+	return (count);
+}
+
+/*
+ * Count the bits of the combined masks in words first through n-1.
+ */
+
+	static
+	int
+count_words_scalar (
+
+const bitmap_t *	a,	/* IN - first bit mask */
+const bitmap_t *	b,	/* IN - second bit mask */
+int			first,	/* IN - first word */
+int			n,	/* IN - number of words */
+enum bitmap_op		op	/* IN - how to combine the masks */
+)
+{
+int		i;
+int		count;
+
+	count = 0;
+	for (i = first; i < n; i++) {
+		count += POPCOUNT (COMBINE (a [i], b [i], op));
+	}
+
+	return (count);
+}
+
+#ifdef USE_AVX2_KERNELS
+
+/*
+ * AVX2 version of count_words_scalar, for words 0 through n-1.  Each
+ * nibble is counted by table lookup, and the byte counts are summed
+ * into four 64-bit counters.
+ */
+
+	__attribute__ ((target ("avx2")))
+	static
+	int
+count_words_avx2 (
+
+const bitmap_t *	a,	/* IN - first bit mask */
+const bitmap_t *	b,	/* IN - second bit mask */
+int			n,	/* IN - number of words */
+enum bitmap_op		op	/* IN - how to combine the masks */
+)
+{
+int		k;
+__m256i		table, low4, zero, sums;
+__m256i		va, vb, v, counts;
+
+	table = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3,
+				  1, 2, 2, 3, 2, 3, 3, 4,
+				  0, 1, 1, 2, 1, 2, 2, 3,
+				  1, 2, 2, 3, 2, 3, 3, 4);
+	low4 = _mm256_set1_epi8 (0x0F);
+	zero = _mm256_setzero_si256 ();
+	sums = _mm256_setzero_si256 ();
+
+	for (k = 0; k + 8 <= n; k += 8) {
+		va = _mm256_loadu_si256 ((const __m256i *) &a [k]);
+		vb = _mm256_loadu_si256 ((const __m256i *) &b [k]);
+		switch (op) {
+		case OP_FIRST:	v = va;				break;
+		case OP_AND:	v = _mm256_and_si256 (va, vb);	break;
+		case OP_ANDNOT:	v = _mm256_andnot_si256 (vb, va); break;
+		default:	v = _mm256_or_si256 (va, vb);	break;
+		}
+		counts = _mm256_add_epi8 (
+			_mm256_shuffle_epi8 (table, _mm256_and_si256 (v, low4)),
+			_mm256_shuffle_epi8 (table,
+				_mm256_and_si256 (_mm256_srli_epi16 (v, 4),
+						  low4)));
+		sums = _mm256_add_epi64 (sums, _mm256_sad_epu8 (counts, zero));
+	}
+
+	return (  _mm256_extract_epi64 (sums, 0)
+		+ _mm256_extract_epi64 (sums, 1)
+		+ _mm256_extract_epi64 (sums, 2)
+		+ _mm256_extract_epi64 (sums, 3)
+		+ count_words_scalar (a, b, k, n, op));
+}
+
+#endif
@@ -0,0 +1,116 @@
+/***********************************************************************
+
+	File:	bitmap.h
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Operations on whole bit masks: counting the bits of a mask
+	(or of the AND, AND-NOT or OR of two masks), and finding or
+	iterating over the bits that are set.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#ifndef BITMAP_H
+#define	BITMAP_H
+
+#include "bitmaskmacros.h"
+#include "gsttypes.h"
+#include "logic.h"
+
+extern int	_gst_bitmap_and_count (const bitmap_t *	a,
+				       const bitmap_t *	b,
+				       int		nbits);
+extern int	_gst_bitmap_andnot_count (const bitmap_t *	a,
+					  const bitmap_t *	b,
+					  int			nbits);
+extern int	_gst_bitmap_count (const bitmap_t * bm, int nbits);
+extern int	_gst_bitmap_or_count (const bitmap_t *	a,
+				      const bitmap_t *	b,
+				      int		nbits);
+
+/*
+ * Position of the lowest bit set in a non-zero word of a bit mask.
+ */
+
+#if defined (__GNUC__)
+	#define	BITMAP_CTZ(w)	__builtin_ctz (w)
+#else
+	static
+	inline
+	int
+_gst_bitmap_ctz (
+
+bitmap_t	w		/* IN - non-zero word */
+)
+{
+int		i;
+
+	for (i = 0; (w & 1) EQ 0; i++) {
+		w >>= 1;
+	}
+	return (i);
+}
+	#define	BITMAP_CTZ(w)	_gst_bitmap_ctz (w)
+#endif
+
+/*
+ * Return the first bit j >= i that is set in the given mask of nbits
+ * bits, or nbits if there is none.  Words that are empty are skipped
+ * two at a time.
+ */
+
+	static
+	inline
+	int
+_gst_bitmap_next (
+
+const bitmap_t *	bm,	/* IN - bit mask */
+int			i,	/* IN - first bit to consider */
+int			nbits	/* IN - number of bits in mask */
+)
+{
+int		w;
+int		nwords;
+bitmap_t	word;
+
+	if (i >= nbits) return (nbits);
+
+	w = i / BPW;
+	word = bm [w] & (~((bitmap_t) 0) << (i % BPW));
+	if (word EQ 0) {
+		nwords = BMAP_ELTS (nbits);
+		do {
+			++w;
+			while ((w + 1 < nwords) AND ((bm [w] | bm [w + 1]) EQ 0)) {
+				w += 2;
+			}
+			if (w >= nwords) return (nbits);
+			word = bm [w];
+		} while (word EQ 0);
+	}
+	i = w * BPW + BITMAP_CTZ (word);
+
+	return ((i < nbits) ? i : nbits);
+}
+
+/*
+ * Loop over each bit i that is set in the given mask of nbits bits, in
+ * increasing order.  Bits set or cleared by the body are seen exactly
+ * as by a loop that tests every bit with BITON.
+ */
+
+#define	FOR_EACH_SETBIT(i, bm, nbits)					\
+	for ((i) = _gst_bitmap_next ((bm), 0, (nbits));			\
+	     (i) < (nbits);						\
+	     (i) = _gst_bitmap_next ((bm), (i) + 1, (nbits)))
+
+#endif
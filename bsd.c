@@ -47,6 +47,7 @@
 
 #include "bsd.h"
 
+#include "dsuf.h"
 #include "fatal.h"
 #include "geosteiner.h"
 #include <limits.h>
@@ -93,6 +94,7 @@ struct mstadj {
  */
 
 static struct mstadj **	build_adjacency_list (int, int, int, struct edge *);
+static void		build_kruskal_rmq (struct bsd *);
 static void		walk (int,
 			      int,
 			      struct mstadj **,
@@ -147,6 +149,23 @@ int		ej;
 		}
 		return (bsdp -> mst_edges [index].len);
 
+	case GST_PVAL_BSD_METHOD_LCA:
+		/* O(n log n) space, constant time lookup.  The BSD is	*/
+		/* the largest edge between the two terminals in the	*/
+		/* leaf order of the Kruskal tree.			*/
+		i = bsdp -> pos [i];
+		j = bsdp -> pos [j];
+		if (i > j) {
+			index = i;
+			i = j;
+			j = index;
+		}
+		index = bsdp -> log2 [j - i];
+		ei = bsdp -> rmq [index] [i];
+		ej = bsdp -> rmq [index] [j - (1 << index)];
+		if (ej > ei) ei = ej;
+		return (bsdp -> mst_edges [ei].len);
+
 	default:
 		FATAL_ERROR;
 		break;
@@ -160,12 +179,13 @@ int		ej;
  * given point set and implementation method.  The first thing is to
  * compute the actual minimum spanning tree.  The rest of the initialization
  * is method-specific.
- * Method 0: Dynamic choice between 1 and 2 based on the number of terminals.
+ * Method 0: Dynamic choice between 1 and 3 based on the number of terminals.
  * Method 1: Quadratic space, constant time lookup.
  * Method 2: Linear space, logarithmic time loopkup.
+ * Method 3: O(n log n) space, constant time lookup.
  *
- * NOTE: This code (specifically Method 2) assumes that the given MST edges
- *	 have been sorted in non-decreasing order by length!!!
+ * NOTE: This code (specifically Methods 2 and 3) assumes that the given
+ *	 MST edges have been sorted in non-decreasing order by length!!!
  */
 
 	struct bsd *
@@ -200,7 +220,7 @@ bool *			mark;
 			method = GST_PVAL_BSD_METHOD_CONSTANT;
 		}
 		else {
-			method = GST_PVAL_BSD_METHOD_LOGARITHMIC;
+			method = GST_PVAL_BSD_METHOD_LCA;
 		}
 		break;
 
@@ -210,13 +230,14 @@ bool *			mark;
 			/* space method (unless we use "int" instead of	*/
 			/* "unsigned short", but this would double the	*/
 			/* already costly space complexity).		*/
-			/* Gracefully force use of log time / linear	*/
-			/* space method.				*/
-			method = GST_PVAL_BSD_METHOD_LOGARITHMIC;
+			/* Gracefully force use of the constant time /	*/
+			/* O(n log n) space method.			*/
+			method = GST_PVAL_BSD_METHOD_LCA;
 		}
 		break;
 
 	case GST_PVAL_BSD_METHOD_LOGARITHMIC:
+	case GST_PVAL_BSD_METHOD_LCA:
 		break;
 
 	default:
@@ -318,6 +339,11 @@ bool *			mark;
 		}
 		break;
 
+	case GST_PVAL_BSD_METHOD_LCA:
+		/* Constant time, O(n log n) space lookup */
+		build_kruskal_rmq (bsdp);
+		break;
+
 	default:
 		FATAL_ERROR;
 		break;
@@ -327,6 +353,128 @@ bool *			mark;
 	return (bsdp);
 }
 
+/*
+ * This routine builds the constant time / O(n log n) space lookup
+ * structure.  Running Kruskal's algorithm on the MST edges yields the
+ * Kruskal tree, whose leaves are the terminals and whose internal
+ * nodes are the MST edges, each one being the parent of the two
+ * components it joins.  The BSD of two terminals is the edge at their
+ * lowest common ancestor.  Since every internal node has a larger
+ * edge number than all nodes below it, this is also the largest edge
+ * found between the two terminals in an in-order traversal of the
+ * tree.  We obtain this order without building the tree: each
+ * component keeps its terminals in a list, and joining two components
+ * appends one list to the other, recording the joining edge between
+ * them.  A sparse table over the edges between consecutive terminals
+ * then answers each range maximum query with two lookups.
+ *
+ * NOTE: This code assumes the MST edges are sorted in non-decreasing
+ *	 order by length!!!
+ */
+
+	static
+	void
+build_kruskal_rmq (
+
+struct bsd *		bsdp		/* IN/OUT - BSD info */
+)
+{
+int			i;
+int			k;
+int			m;
+int			n;
+int			u;
+int			v;
+int			ru;
+int			rv;
+int			nlevels;
+int			total;
+int *			head;
+int *			tail;
+int *			next;
+int *			gap;
+int *			row;
+int *			prev;
+struct dsuf		sets;
+
+	n = bsdp -> n;
+
+	_gst_dsuf_create (&sets, n);
+	head	= NEWA (n, int);
+	tail	= NEWA (n, int);
+	next	= NEWA (n, int);
+	gap	= NEWA (n, int);
+	for (i = 0; i < n; i++) {
+		_gst_dsuf_makeset (&sets, i);
+		head [i]	= i;
+		tail [i]	= i;
+		next [i]	= -1;
+		gap [i]		= 0;
+	}
+
+	/* Join the leaf lists in Kruskal order. */
+	for (i = 1; i < n; i++) {
+		u  = bsdp -> mst_edges [i].p1;
+		v  = bsdp -> mst_edges [i].p2;
+		ru = _gst_dsuf_find (&sets, u);
+		rv = _gst_dsuf_find (&sets, v);
+		FATAL_ERROR_IF (ru EQ rv);
+		next [tail [ru]] = head [rv];
+		gap [tail [ru]]	 = i;
+		_gst_dsuf_unite (&sets, ru, rv);
+		k = _gst_dsuf_find (&sets, ru);
+		head [k] = head [ru];
+		tail [k] = tail [rv];
+	}
+
+	/* Number the terminals in list order.  Level 0 of the	*/
+	/* sparse table holds the edges between consecutive ones.	*/
+	m = n - 1;
+	nlevels = 1;
+	total = m;
+	while ((1 << nlevels) <= m) {
+		total += m - (1 << nlevels) + 1;
+		++nlevels;
+	}
+
+	bsdp -> pos	= NEWA (n, int);
+	bsdp -> rmq	= NEWA (nlevels, int *);
+	bsdp -> rmq [0]	= NEWA (total + 1, int);
+
+	u = head [_gst_dsuf_find (&sets, 0)];
+	for (i = 0; i < n; i++) {
+		bsdp -> pos [u] = i;
+		if (i < m) {
+			bsdp -> rmq [0] [i] = gap [u];
+		}
+		u = next [u];
+	}
+
+	/* Level k holds the largest of 2^k consecutive edges. */
+	for (k = 1; k < nlevels; k++) {
+		prev = bsdp -> rmq [k - 1];
+		row = prev + m - (1 << (k - 1)) + 1;
+		bsdp -> rmq [k] = row;
+		for (i = 0; i + (1 << k) <= m; i++) {
+			u = prev [i];
+			v = prev [i + (1 << (k - 1))];
+			row [i] = (u >= v) ? u : v;
+		}
+	}
+
+	bsdp -> log2 = NEWA (n, int8u);
+	bsdp -> log2 [0] = 0;
+	for (i = 1; i < n; i++) {
+		bsdp -> log2 [i] = (i < 2) ? 0 : bsdp -> log2 [i >> 1] + 1;
+	}
+
+	free ((char *) gap);
+	free ((char *) next);
+	free ((char *) tail);
+	free ((char *) head);
+	_gst_dsuf_destroy (&sets);
+}
+
 /*
  * This routine converts a list of edges into a full graph structure
  * represented in adjacency list form.  The adjacency list is in two parts:
@@ -505,5 +653,21 @@ struct bsd *	bsdp		/* IN - BSD info to destroy */
 		bsdp -> parent = NULL;
 	}
 
+	if (bsdp -> pos NE NULL) {
+		free ((char *) (bsdp -> pos));
+		bsdp -> pos = NULL;
+	}
+
+	if (bsdp -> rmq NE NULL) {
+		free ((char *) (bsdp -> rmq [0]));
+		free ((char *) (bsdp -> rmq));
+		bsdp -> rmq = NULL;
+	}
+
+	if (bsdp -> log2 NE NULL) {
+		free ((char *) (bsdp -> log2));
+		bsdp -> log2 = NULL;
+	}
+
 	free ((char *) bsdp);
 }
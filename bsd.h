@@ -69,6 +69,13 @@ struct bsd {
 	/* Stuff for the linear space implementation. */
 	int *		edge;		/* Edge index of nearest nb */
 	int *		parent;		/* Parent of node */
+
+	/* Stuff for the Kruskal tree / LCA implementation. */
+	int *		pos;		/* Position of each terminal in the */
+					/* leaf order of the Kruskal tree */
+	int **		rmq;		/* rmq [k][l] = largest edge # between */
+					/* positions l and l + 2^k */
+	int8u *		log2;		/* log2 [m] = floor (log2 (m)) */
 };
 
 
@@ -42,6 +42,7 @@
 
 #include "btsearch.h"
 
+#include "bitmap.h"
 #include "environment.h"
 #include "fatal.h"
 #include "geosteiner.h"
@@ -599,9 +600,7 @@ int32u			counts [MAX_TERMINALS];
 
 	(void) memset (counts, 0, nverts * sizeof (counts [0]));
 
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (cip -> initial_edge_mask, i)) continue;
-
+	FOR_EACH_SETBIT (i, cip -> initial_edge_mask, nedges) {
 		vp1 = cip -> edge [i];
 		vp2 = cip -> edge [i + 1];
 		while (vp1 < vp2) {
@@ -0,0 +1,1010 @@
+/***********************************************************************
+
+	File:	bulk_points.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	This program generates large random point sets, with a battery
+	level for each point, for use as test instances.  The points
+	are drawn from one of several spatial distributions, and the
+	battery levels from one of several battery distributions.
+
+	The points are generated in chunks of POINTS_PER_CHUNK points.
+	Each chunk draws its randomness from its own independent
+	substream, so that several chunks can be generated at once on
+	separate threads.  The output depends only upon the options
+	and the key, not upon the number of threads.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "rand_points.h"
+
+#include "fatal.h"
+#include "gsttypes.h"
+#include "io.h"
+#include "logic.h"
+#include "memory.h"
+#include "parallel.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * Number of points generated from each substream.
+ */
+
+#define	POINTS_PER_CHUNK	65536
+
+/*
+ * Number of uniform random variates obtained from the generator at
+ * once.  Must be even, since the generator produces them in pairs.
+ */
+
+#define	UNIFORMS_PER_FILL	1024
+
+/*
+ * Maximum number of threads.
+ */
+
+#define	MAX_THREADS		1024
+
+/*
+ * 2 * pi.
+ */
+
+#define	TWO_PI		(2.0 * 3.1415926535897932384626433832795028841971693)
+
+/*
+ * The spatial distributions.
+ */
+
+enum Dist {
+	DIST_UNIFORM,		/* Uniform in the unit square */
+	DIST_CLUSTERS,		/* Mixture of Gaussian clusters */
+	DIST_LATTICE,		/* Square lattice, optionally jittered */
+	DIST_ROADS,		/* Near randomly placed line segments */
+};
+
+/*
+ * The battery level distributions.
+ */
+
+enum Battery {
+	BATTERY_TIERED,		/* 20% low, 60% normal, 20% high */
+	BATTERY_UNIFORM,	/* Uniform in [lo, hi] */
+	BATTERY_NORMAL,		/* Normal, clamped to [0, 100] */
+	BATTERY_CONSTANT,	/* The same for all points */
+};
+
+/*
+ * Everything needed to generate any point of the instance.  The
+ * cluster centers and roads are drawn once, from their own substream.
+ */
+
+struct layout {
+	enum Dist	dist;		/* Spatial distribution */
+	int		nitems;		/* Number of clusters or roads */
+	double		width;		/* Cluster standard deviation, */
+					/* road width or lattice jitter */
+	int		side;		/* Number of lattice columns */
+	double *	x1;		/* Cluster centers, or first */
+	double *	y1;		/* endpoints of roads */
+	double *	x2;		/* Second endpoints of roads */
+	double *	y2;
+	double *	cumlen;		/* Cumulative road lengths */
+
+	enum Battery	battery;	/* Battery distribution */
+	double		b1;		/* Low, mean or constant level */
+	double		b2;		/* High level or std deviation */
+};
+
+/*
+ * A substream of uniform random variates.
+ */
+
+struct stream {
+	struct PRNG_obj *	obj;	/* Generator for this substream */
+	int			pos;	/* Next variate in buf */
+	double			buf [UNIFORMS_PER_FILL];
+};
+
+/*
+ * The work of one thread: generating one chunk into a buffer.
+ */
+
+struct job {
+	const struct layout *	lp;	/* Instance being generated */
+	int			chunk;	/* Chunk number */
+	int			first;	/* First point of the chunk */
+	int			count;	/* Number of points in the chunk */
+	char *			buf;	/* Output for the chunk */
+	size_t			size;	/* Size of buf */
+	size_t			len;	/* Bytes of buf used */
+};
+
+
+/*
+ * Global Routines
+ */
+
+int			main (int, char **);
+
+
+/*
+ * Local Routines
+ */
+
+static void		close_stream (struct stream * sp);
+static int32u		cv_number (char * num_string);
+static void		decode_params (int argc, char ** argv);
+static void		free_layout (struct layout * lp);
+static void		gen_battery (const struct layout * lp,
+				     struct stream * sp,
+				     double * battery);
+static void		gen_chunk (void * arg);
+static void		gen_point (const struct layout *	lp,
+				   struct stream *		sp,
+				   int				i,
+				   double *			x,
+				   double *			y);
+static void		init_layout (struct layout * lp);
+static double		next_normal (struct stream * sp);
+static double		next_uniform (struct stream * sp);
+static void		open_stream (struct stream * sp, const char * tag);
+static void		parse_values (const char *	spec,
+				      double *		values,
+				      int		max_values);
+static bool		spec_is (const char * spec, const char * name);
+static void		usage (void);
+static void		write_output (const void * buf, size_t len);
+
+/*
+ * Local Variables
+ */
+
+static bool			flag_binary;
+static char *			flag_battery;
+static char *			flag_dist;
+static char *			flag_key;
+static int			flag_num_points;
+static int			flag_places;
+static int			flag_threads;
+static const struct PRNG_imp *	imp;
+static char *			me;
+
+/*
+ * This routine generates the random point set.
+ */
+
+	int
+main (
+
+int		argc,
+char **		argv
+)
+{
+int			i;
+int			nchunks;
+int			chunk;
+int			njobs;
+size_t			size;
+struct layout		layout;
+struct job *		jobs;
+void **			args;
+struct binary_points_header	hdr;
+
+	decode_params (argc, argv);
+
+	/* Use the best generator available. */
+	imp = &rand_points_PRNG_aes_256;
+	if (PRNG_IMP_UNAVAILABLE (imp)) {
+		imp = &rand_points_PRNG_new;
+	}
+
+	init_layout (&layout);
+
+	if (flag_binary) {
+		memset (&hdr, 0, sizeof (hdr));
+		memcpy (hdr.magic, BINARY_POINTS_MAGIC, BINARY_POINTS_MAGIC_LEN);
+		hdr.byte_order	= BINARY_POINTS_BYTE_ORDER;
+		hdr.npoints	= flag_num_points;
+		write_output (&hdr, sizeof (hdr));
+		size = POINTS_PER_CHUNK * 3 * sizeof (double);
+	}
+	else {
+		/* Room for "0.XXX 0.XXX 100.0\n", and then some. */
+		size = POINTS_PER_CHUNK * (2 * (flag_places + 8) + 16);
+	}
+
+	nchunks = 0;
+	if (flag_num_points > 0) {
+		nchunks = (flag_num_points - 1) / POINTS_PER_CHUNK + 1;
+	}
+	njobs = flag_threads;
+	if (njobs > nchunks) {
+		njobs = nchunks;
+	}
+	if (njobs < 1) {
+		njobs = 1;
+	}
+
+	jobs = NEWA (njobs, struct job);
+	args = NEWA (njobs, void *);
+	for (i = 0; i < njobs; i++) {
+		jobs [i].lp	= &layout;
+		jobs [i].buf	= NEWA (size, char);
+		jobs [i].size	= size;
+		args [i]	= &jobs [i];
+	}
+
+	/* Generate njobs chunks at a time, writing them in order. */
+	for (chunk = 0; chunk < nchunks; chunk += njobs) {
+		for (i = 0; i < njobs; i++) {
+			jobs [i].chunk = chunk + i;
+			jobs [i].first = 0;
+			jobs [i].count = 0;
+			if (chunk + i >= nchunks) continue;
+			jobs [i].first = (chunk + i) * POINTS_PER_CHUNK;
+			jobs [i].count = flag_num_points - jobs [i].first;
+			if (jobs [i].count > POINTS_PER_CHUNK) {
+				jobs [i].count = POINTS_PER_CHUNK;
+			}
+		}
+		_gst_run_parallel (njobs, gen_chunk, args);
+		for (i = 0; i < njobs; i++) {
+			write_output (jobs [i].buf, jobs [i].len);
+		}
+	}
+
+	if (fflush (stdout) NE 0) {
+		fprintf (stderr, "%s: Error writing output.\n", me);
+		exit (1);
+	}
+
+	for (i = 0; i < njobs; i++) {
+		free (jobs [i].buf);
+	}
+	free (args);
+	free (jobs);
+	free_layout (&layout);
+
+	exit (0);
+}
+
+/*
+ * This routine decodes the various command-line arguments.
+ */
+
+	static
+	void
+decode_params (
+
+int		argc,
+char **		argv
+)
+{
+char *		ap;
+char		c;
+
+	--argc;
+	me = *argv++;
+
+	flag_binary	= FALSE;
+	flag_battery	= "tiered";
+	flag_dist	= "uniform";
+	flag_key	= "";
+	flag_num_points	= 10;
+	flag_places	= 6;
+	flag_threads	= 1;
+
+#define	GET_FLAG_ARGUMENT(ap)				\
+	do {						\
+		if (*ap EQ '\0') {			\
+			if (argc <= 0) {		\
+				usage ();		\
+			}				\
+			ap = *argv++;			\
+			--argc;				\
+		}					\
+	} while (FALSE)
+
+	while (argc > 0) {
+		ap = *argv++;
+		--argc;
+		if (*ap NE '-') {
+			flag_num_points = cv_number (ap);
+			if (flag_num_points < 0) {
+				fprintf (stderr,
+					 "%s: Invalid number of points `%s'\n",
+					 me, ap);
+				usage ();
+			}
+			break;
+		}
+		++ap;
+		while ((c = *ap++) NE '\0') {
+			switch (c) {
+			case 'B':
+				GET_FLAG_ARGUMENT (ap);
+				flag_battery = ap;
+				ap = "";
+				break;
+
+			case 'b':
+				flag_binary = TRUE;
+				break;
+
+			case 'D':
+				GET_FLAG_ARGUMENT (ap);
+				flag_dist = ap;
+				ap = "";
+				break;
+
+			case 'k':
+				GET_FLAG_ARGUMENT (ap);
+				flag_key = ap;
+				ap = "";
+				break;
+
+			case 'p':
+				GET_FLAG_ARGUMENT (ap);
+				flag_places = atoi (ap);
+				if ((flag_places < 1) OR (flag_places > 17)) {
+					fprintf (stderr,
+						 "%s: Invalid switch -p %d\n",
+						 me, flag_places);
+					usage ();
+				}
+				ap = "";
+				break;
+
+			case 't':
+				GET_FLAG_ARGUMENT (ap);
+				flag_threads = atoi (ap);
+				if ((flag_threads < 1) OR
+				    (flag_threads > MAX_THREADS)) {
+					fprintf (stderr,
+						 "%s: Invalid switch -t %d\n",
+						 me, flag_threads);
+					usage ();
+				}
+				ap = "";
+				break;
+
+			default:
+				usage ();
+				break;
+			}
+		}
+	}
+
+#undef GET_FLAG_ARGUMENT
+}
+
+/*
+ * This routine prints out the proper usage and exits.
+ */
+
+static char *	arg_doc [] = {
+	"",
+	"\tGenerate N random points with battery levels.  Default N is 10.",
+	"\tEach line of output is `x y battery', with x and y in [0,1)",
+	"\tand battery in [0,100].",
+	"",
+	"\t-b\tBinary output: a 16 byte header (the 8 bytes",
+	"\t\t\"\\211GSTPTS\\n\", 0x01020304 and N as native 32-bit",
+	"\t\tintegers), then x, y and battery of each point as",
+	"\t\tnative doubles.  All programs that read points",
+	"\t\t(efst, rfst, ...) accept this format.",
+	"\t-B SPEC\tBattery level distribution:",
+	"\t\t  tiered\t\t20% in [10,40], 60% in [40,80] and",
+	"\t\t\t\t20% in [80,100] (the default).",
+	"\t\t  uniform:LO:HI\tUniform in [LO,HI] (default 0:100).",
+	"\t\t  normal:MEAN:SD\tNormal, clamped to [0,100]",
+	"\t\t\t\t(default 60:20).",
+	"\t\t  constant:V\tAlways V (default 100).",
+	"\t-D SPEC\tSpatial distribution:",
+	"\t\t  uniform\tUniform in the unit square (the default).",
+	"\t\t  clusters:K:SD\tMixture of K Gaussian clusters with",
+	"\t\t\t\tstandard deviation SD (default 10:0.05).",
+	"\t\t  lattice:J\tSquare lattice, each point moved by up",
+	"\t\t\t\tto J/2 of the spacing (default 0).",
+	"\t\t  roads:R:W\tNear R random roads, with offsets of",
+	"\t\t\t\tstandard deviation W (default 8:0.005).",
+	"\t-k KEY\tUse the given KEY to alter the random sequence.",
+	"\t-p M\tPrint M digits after the decimal point of each",
+	"\t\tcoordinate (default 6).",
+	"\t-t N\tGenerate with N threads.  The output does not depend",
+	"\t\ton N.",
+	"",
+	NULL
+};
+
+	static
+	void
+usage (void)
+
+{
+char **		pp;
+char *		p;
+
+	fprintf (stderr,
+		 "\nUsage: %s [-b] [-B battery] [-D distribution]"
+		 " [-k key] [-p places] [-t threads] [num_points]\n",
+		 me);
+
+	pp = &arg_doc [0];
+	while ((p = *pp++) NE NULL) {
+		fprintf (stderr, "%s\n", p);
+	}
+	exit (1);
+}
+
+/*
+ * This routine converts the given string into a number.
+ */
+
+	static
+	int32u
+cv_number (
+
+char *		num_string	/* IN - number to convert. */
+)
+{
+char *		s;
+int		c;
+int32u		val;
+
+	s = num_string;
+	val = 0;
+	while ((c = *s++) NE '\0') {
+		if (NOT isdigit (c)) {
+			(void) fprintf (stderr,
+					"%s: `%s' is not a decimal number.\n",
+					me, num_string);
+			exit (1);
+		}
+		val = (val * 10) + (c - '0');
+	}
+
+	return (val);
+}
+
+/*
+ * Does the given specification NAME[:V1[:V2...]] have the given name?
+ */
+
+	static
+	bool
+spec_is (
+
+const char *	spec,		/* IN - specification */
+const char *	name		/* IN - name to match */
+)
+{
+size_t		len;
+
+	len = strlen (name);
+	if (strncmp (spec, name, len) NE 0) return (FALSE);
+
+	return ((spec [len] EQ '\0') OR (spec [len] EQ ':'));
+}
+
+/*
+ * Parse the values V1, V2, ... of a specification NAME[:V1[:V2...]].
+ * Values not given are left unchanged.
+ */
+
+	static
+	void
+parse_values (
+
+const char *	spec,		/* IN - specification to parse */
+double *	values,		/* IN/OUT - values given */
+int		max_values	/* IN - maximum number of values */
+)
+{
+int		n;
+const char *	p;
+char *		endp;
+
+	p = strchr (spec, ':');
+	n = 0;
+	while ((p NE NULL) AND (*p EQ ':')) {
+		if (n >= max_values) break;
+		++p;
+		values [n] = strtod (p, &endp);
+		if (endp EQ p) break;
+		p = endp;
+		++n;
+	}
+	if ((p NE NULL) AND (*p NE '\0')) {
+		fprintf (stderr, "%s: Invalid specification `%s'.\n",
+			 me, spec);
+		usage ();
+	}
+}
+
+/*
+ * Decode the distribution options, and draw the clusters or roads.
+ */
+
+	static
+	void
+init_layout (
+
+struct layout *		lp		/* OUT - the layout */
+)
+{
+int		i;
+double		v [2];
+double		dx, dy;
+struct stream	stream;
+
+	memset (lp, 0, sizeof (*lp));
+
+	if (spec_is (flag_dist, "uniform")) {
+		parse_values (flag_dist, v, 0);
+		lp -> dist = DIST_UNIFORM;
+	}
+	else if (spec_is (flag_dist, "clusters")) {
+		v [0] = 10.0;
+		v [1] = 0.05;
+		parse_values (flag_dist, v, 2);
+		lp -> dist	= DIST_CLUSTERS;
+		lp -> nitems	= (int) v [0];
+		lp -> width	= v [1];
+	}
+	else if (spec_is (flag_dist, "lattice")) {
+		v [0] = 0.0;
+		parse_values (flag_dist, v, 1);
+		lp -> dist	= DIST_LATTICE;
+		lp -> width	= v [0];
+		lp -> side	= (int) ceil (sqrt ((double) flag_num_points));
+		if (lp -> side < 1) {
+			lp -> side = 1;
+		}
+	}
+	else if (spec_is (flag_dist, "roads")) {
+		v [0] = 8.0;
+		v [1] = 0.005;
+		parse_values (flag_dist, v, 2);
+		lp -> dist	= DIST_ROADS;
+		lp -> nitems	= (int) v [0];
+		lp -> width	= v [1];
+	}
+	else {
+		fprintf (stderr, "%s: Unknown distribution `%s'.\n",
+			 me, flag_dist);
+		usage ();
+	}
+	if ((lp -> width < 0.0) OR (lp -> width > 1.0)) {
+		fprintf (stderr, "%s: Invalid width in `%s'.\n", me, flag_dist);
+		usage ();
+	}
+	if (((lp -> dist EQ DIST_CLUSTERS) OR (lp -> dist EQ DIST_ROADS)) AND
+	    (lp -> nitems < 1)) {
+		fprintf (stderr, "%s: Invalid count in `%s'.\n", me, flag_dist);
+		usage ();
+	}
+
+	v [0] = 0.0;
+	v [1] = 0.0;
+	if (spec_is (flag_battery, "tiered")) {
+		parse_values (flag_battery, v, 0);
+		lp -> battery = BATTERY_TIERED;
+	}
+	else if (spec_is (flag_battery, "uniform")) {
+		v [0] = 0.0;
+		v [1] = 100.0;
+		parse_values (flag_battery, v, 2);
+		lp -> battery = BATTERY_UNIFORM;
+	}
+	else if (spec_is (flag_battery, "normal")) {
+		v [0] = 60.0;
+		v [1] = 20.0;
+		parse_values (flag_battery, v, 2);
+		lp -> battery = BATTERY_NORMAL;
+	}
+	else if (spec_is (flag_battery, "constant")) {
+		v [0] = 100.0;
+		parse_values (flag_battery, v, 1);
+		lp -> battery = BATTERY_CONSTANT;
+	}
+	else {
+		fprintf (stderr, "%s: Unknown battery distribution `%s'.\n",
+			 me, flag_battery);
+		usage ();
+	}
+	lp -> b1 = v [0];
+	lp -> b2 = v [1];
+	if ((lp -> battery EQ BATTERY_UNIFORM) AND (lp -> b1 > lp -> b2)) {
+		fprintf (stderr, "%s: Invalid range in `%s'.\n",
+			 me, flag_battery);
+		usage ();
+	}
+
+	if (lp -> nitems <= 0) return;
+
+	/* Draw the clusters or roads. */
+	open_stream (&stream, "layout");
+	lp -> x1 = NEWA (lp -> nitems, double);
+	lp -> y1 = NEWA (lp -> nitems, double);
+	for (i = 0; i < lp -> nitems; i++) {
+		lp -> x1 [i] = next_uniform (&stream);
+		lp -> y1 [i] = next_uniform (&stream);
+	}
+	if (lp -> dist EQ DIST_ROADS) {
+		lp -> x2	= NEWA (lp -> nitems, double);
+		lp -> y2	= NEWA (lp -> nitems, double);
+		lp -> cumlen	= NEWA (lp -> nitems, double);
+		for (i = 0; i < lp -> nitems; i++) {
+			lp -> x2 [i] = next_uniform (&stream);
+			lp -> y2 [i] = next_uniform (&stream);
+			dx = lp -> x2 [i] - lp -> x1 [i];
+			dy = lp -> y2 [i] - lp -> y1 [i];
+			lp -> cumlen [i] = sqrt (dx * dx + dy * dy);
+			if (i > 0) {
+				lp -> cumlen [i] += lp -> cumlen [i - 1];
+			}
+		}
+	}
+	close_stream (&stream);
+}
+
+/*
+ * Free the layout.
+ */
+
+	static
+	void
+free_layout (
+
+struct layout *		lp		/* IN - the layout */
+)
+{
+	if (lp -> cumlen NE NULL) {
+		free (lp -> cumlen);
+		free (lp -> y2);
+		free (lp -> x2);
+	}
+	if (lp -> x1 NE NULL) {
+		free (lp -> y1);
+		free (lp -> x1);
+	}
+}
+
+/*
+ * Open the substream with the given tag.  Its generator is keyed with
+ * the tag followed by the user's key.
+ */
+
+	static
+	void
+open_stream (
+
+struct stream *		sp,		/* OUT - the substream */
+const char *		tag		/* IN - name of the substream */
+)
+{
+size_t			len;
+char *			key;
+struct PRNG_options	options;
+
+	len = strlen (tag) + strlen (flag_key) + 2;
+	key = NEWA (len, char);
+	snprintf (key, len, "%s/%s", tag, flag_key);
+
+	memset (&options, 0, sizeof (options));
+	options.mode		= MODE_BINARY;
+	options.ndigits		= -1;
+	options.nplaces		= -1;
+	options.randomize	= FALSE;
+	options.key		= key;
+
+	sp -> obj = imp -> create (&options);
+	if (sp -> obj EQ NULL) {
+		/* Error message should have been printed by create(). */
+		exit (1);
+	}
+	sp -> pos = UNIFORMS_PER_FILL;
+
+	free (key);
+}
+
+/*
+ * Close the given substream.
+ */
+
+	static
+	void
+close_stream (
+
+struct stream *		sp		/* IN - the substream */
+)
+{
+	sp -> obj -> destruct (sp -> obj);
+	sp -> obj = NULL;
+}
+
+/*
+ * Get the next uniform random variate in [0,1) from the substream.
+ */
+
+	static
+	double
+next_uniform (
+
+struct stream *		sp		/* IN/OUT - the substream */
+)
+{
+	if (sp -> pos >= UNIFORMS_PER_FILL) {
+		sp -> obj -> gen_array (sp -> obj,
+					sp -> buf,
+					UNIFORMS_PER_FILL / 2);
+		sp -> pos = 0;
+	}
+	return (sp -> buf [sp -> pos++]);
+}
+
+/*
+ * Get the next standard normal random variate from the substream,
+ * using the Box-Muller transform.
+ */
+
+	static
+	double
+next_normal (
+
+struct stream *		sp		/* IN/OUT - the substream */
+)
+{
+double		r;
+double		theta;
+
+	/* 1 - U is in (0,1], so the logarithm is finite. */
+	r = sqrt (-2.0 * log (1.0 - next_uniform (sp)));
+	theta = TWO_PI * next_uniform (sp);
+
+	return (r * cos (theta));
+}
+
+/*
+ * Generate one chunk of points into the job's buffer.
+ */
+
+	static
+	void
+gen_chunk (
+
+void *		arg		/* IN/OUT - the job */
+)
+{
+int			i;
+int			n;
+char			tag [16];
+char *			p;
+double			x, y, battery;
+double *		dp;
+struct job *		jp;
+struct stream		stream;
+
+	jp = (struct job *) arg;
+	jp -> len = 0;
+	if (jp -> count <= 0) return;
+
+	snprintf (tag, sizeof (tag), "%d", jp -> chunk);
+	open_stream (&stream, tag);
+
+	p  = jp -> buf;
+	dp = (double *) jp -> buf;
+	for (i = 0; i < jp -> count; i++) {
+		gen_point (jp -> lp, &stream, jp -> first + i, &x, &y);
+		gen_battery (jp -> lp, &stream, &battery);
+
+		if (flag_binary) {
+			*dp++ = x;
+			*dp++ = y;
+			*dp++ = battery;
+		}
+		else {
+			n = snprintf (p,
+				      jp -> size - (p - jp -> buf),
+				      "%.*f %.*f %.1f\n",
+				      flag_places, x,
+				      flag_places, y,
+				      battery);
+			FATAL_ERROR_IF (p + n >= jp -> buf + jp -> size);
+			p += n;
+		}
+	}
+
+	if (flag_binary) {
+		jp -> len = ((char *) dp) - jp -> buf;
+	}
+	else {
+		jp -> len = p - jp -> buf;
+	}
+
+	close_stream (&stream);
+}
+
+/*
+ * Generate the coordinates of point i.  They are redrawn until they
+ * lie in the unit square.
+ */
+
+	static
+	void
+gen_point (
+
+const struct layout *	lp,		/* IN - the layout */
+struct stream *		sp,		/* IN/OUT - random source */
+int			i,		/* IN - index of the point */
+double *		x,		/* OUT - X coordinate */
+double *		y		/* OUT - Y coordinate */
+)
+{
+int		k, lo, hi;
+double		t, s, len;
+double		dx, dy;
+
+	switch (lp -> dist) {
+	case DIST_UNIFORM:
+		*x = next_uniform (sp);
+		*y = next_uniform (sp);
+		break;
+
+	case DIST_CLUSTERS:
+		k = (int) (next_uniform (sp) * lp -> nitems);
+		do {
+			*x = lp -> x1 [k] + lp -> width * next_normal (sp);
+			*y = lp -> y1 [k] + lp -> width * next_normal (sp);
+		} while ((*x < 0.0) OR (*x >= 1.0) OR
+			 (*y < 0.0) OR (*y >= 1.0));
+		break;
+
+	case DIST_LATTICE:
+		t = (i % lp -> side) + 0.5;
+		s = (i / lp -> side) + 0.5;
+		if (lp -> width > 0.0) {
+			t += lp -> width * (next_uniform (sp) - 0.5);
+			s += lp -> width * (next_uniform (sp) - 0.5);
+		}
+		*x = t / lp -> side;
+		*y = s / lp -> side;
+		break;
+
+	case DIST_ROADS:
+		/* Choose a road with probability proportional to	*/
+		/* its length, and a point along it.			*/
+		len = lp -> cumlen [lp -> nitems - 1];
+		t = next_uniform (sp) * len;
+		lo = 0;
+		hi = lp -> nitems - 1;
+		while (lo < hi) {
+			k = (lo + hi) / 2;
+			if (t < lp -> cumlen [k]) {
+				hi = k;
+			}
+			else {
+				lo = k + 1;
+			}
+		}
+		k = lo;
+		dx = lp -> x2 [k] - lp -> x1 [k];
+		dy = lp -> y2 [k] - lp -> y1 [k];
+		len = sqrt (dx * dx + dy * dy);
+		t = next_uniform (sp);
+		do {
+			/* Offset perpendicular to the road. */
+			s = lp -> width * next_normal (sp);
+			if (len > 0.0) {
+				*x = lp -> x1 [k] + t * dx - s * dy / len;
+				*y = lp -> y1 [k] + t * dy + s * dx / len;
+			}
+			else {
+				*x = lp -> x1 [k] + s;
+				*y = lp -> y1 [k];
+			}
+		} while ((*x < 0.0) OR (*x >= 1.0) OR
+			 (*y < 0.0) OR (*y >= 1.0));
+		break;
+
+	default:
+		FATAL_ERROR;
+		*x = 0.0;
+		*y = 0.0;
+		break;
+	}
+}
+
+/*
+ * Generate the battery level of a point.
+ */
+
+	static
+	void
+gen_battery (
+
+const struct layout *	lp,		/* IN - the layout */
+struct stream *		sp,		/* IN/OUT - random source */
+double *		battery		/* OUT - battery level */
+)
+{
+double		r;
+
+	switch (lp -> battery) {
+	case BATTERY_TIERED:
+		r = next_uniform (sp);
+		if (r < 0.2) {
+			r = 10.0 + next_uniform (sp) * 30.0;
+		}
+		else if (r < 0.8) {
+			r = 40.0 + next_uniform (sp) * 40.0;
+		}
+		else {
+			r = 80.0 + next_uniform (sp) * 20.0;
+		}
+		break;
+
+	case BATTERY_UNIFORM:
+		r = lp -> b1 + next_uniform (sp) * (lp -> b2 - lp -> b1);
+		break;
+
+	case BATTERY_NORMAL:
+		r = lp -> b1 + lp -> b2 * next_normal (sp);
+		if (r < 0.0) {
+			r = 0.0;
+		}
+		if (r > 100.0) {
+			r = 100.0;
+		}
+		break;
+
+	case BATTERY_CONSTANT:
+		r = lp -> b1;
+		break;
+
+	default:
+		FATAL_ERROR;
+		r = 0.0;
+		break;
+	}
+
+	*battery = r;
+}
+
+/*
+ * Write the given bytes to standard output.
+ */
+
+	static
+	void
+write_output (
+
+const void *	buf,		/* IN - bytes to write */
+size_t		len		/* IN - number of bytes */
+)
+{
+	if (len <= 0) return;
+
+	if (fwrite (buf, 1, len, stdout) NE len) {
+		fprintf (stderr, "%s: Error writing output.\n", me);
+		exit (1);
+	}
+}
@@ -612,7 +612,6 @@ struct bbinfo *		bbip;
 	bbip -> vert_mask	= cip -> initial_vert_mask;
 	bbip -> edge_mask	= cip -> initial_edge_mask;
 	bbip -> lp		= NULL;
-	bbip -> lpmem		= NULL;
 	bbip -> cpool		= NULL;
 	bbip -> bbtree		= NULL;
 	bbip -> csip		= NULL;
@@ -54,6 +54,7 @@
 #include "constrnt.h"
 
 #include "bb.h"
+#include "bitmap.h"
 #include "channels.h"
 #include "config.h"
 #include "expand.h"
@@ -61,6 +62,7 @@
 #include <float.h>
 #include <limits.h>
 #include "logic.h"
+#include "lpbackend.h"
 #include <math.h>
 #include "memory.h"
 #include "parmblk.h"
@@ -85,7 +87,6 @@ LP_t *		_gst_build_initial_formulation (
 					bitmap_t *		vert_mask,
 					bitmap_t *		edge_mask,
 					struct gst_hypergraph *	cip,
-					struct lpmem *		lpmem,
 					gst_param_ptr		params);
 void		_gst_debug_print_constraint (char *		msg1,
 					char *			msg2,
@@ -115,32 +116,23 @@ int		_gst_solve_LP_over_constraint_pool (struct bbinfo * bbip);
  * Local Routines
  */
 
+static void		age_pool_slice (struct cpool *, gst_param_ptr);
+static void		collect_stale_rows (struct cpool *, gst_param_ptr);
+static bool		stale_collection_due (struct cpool *);
 static double		compute_slack_value (struct rcoef *, double *);
+static void		delete_pool_rows (struct cpool *, bool *, int);
 static void		garbage_collect_pool (struct cpool *, int, int, gst_param_ptr);
 static void		print_pool_memory_usage (struct cpool *,
 						 gst_channel_ptr);
 static void		prune_pending_rows (struct bbinfo *, bool);
 static void		reduce_constraint (struct rcoef *);
 static struct rblk *	reverse_rblks (struct rblk *);
-static int		solve_single_LP (struct bbinfo *,
-					 double *,
-					 double *,
-					 int);
 static void		sort_gc_candidates (int *, int32u *, int);
 static bool		sprint_term (char *, bool, int, int);
 static void		update_lp_solution_history (double *,
 						    double *,
 						    struct bbinfo *);
 static void		verify_pool (struct cpool *);
-
-#if CPLEX
-static void		reload_cplex_problem (struct bbinfo *);
-#endif
-
-#if LPSOLVE
-static void		get_current_basis (LP_t *, int *, int *);
-static void		set_current_basis (LP_t *, int *, int *);
-#endif
 
 /*
  * This routine initializes the given constraint pool and fills it with
@@ -223,8 +215,7 @@ gst_channel_ptr		param_print_solve_trace;
 
 	num_at_least_one_rows	= 1;  /* Always exactly 1 constraint */
 	num_at_least_one_coeffs	= 0;  /* Will count valid FSTs */
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		++num_at_least_one_coeffs;
 	}
 
@@ -242,8 +233,7 @@ gst_channel_ptr		param_print_solve_trace;
 			tmask [i] = 0;
 		}
 
-		for (i = 0; i < nterms; i++) {
-			if (NOT BITON (vert_mask, i)) continue;
+		FOR_EACH_SETBIT (i, vert_mask, nterms) {
 			vp1 = tlist;
 			ep1 = cip -> term_trees [i];
 			ep2 = cip -> term_trees [i + 1];
@@ -284,8 +274,7 @@ gst_channel_ptr		param_print_solve_trace;
 	/* degree constraint.					*/
 	num_total_degree_rows	= 1;
 	num_total_degree_coeffs	= 0;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		++num_total_degree_coeffs;
 	}
 
@@ -296,8 +285,7 @@ gst_channel_ptr		param_print_solve_trace;
 		/* "basic" incompatibilities (edges that share 2 or	*/
 		/* more vertices).  It lists ONLY incompatible edges	*/
 		/* sharing 1 or fewer vertices.				*/
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
 
 			ep1 = cip -> inc_edges [i];
 			ep2 = cip -> inc_edges [i + 1];
@@ -317,8 +305,7 @@ gst_channel_ptr		param_print_solve_trace;
 	nvt = 0;
 	num_cutset_rows		= 0;
 	num_cutset_coeffs	= 0;
-	for (i = 0; i < cip -> num_verts; i++) {
-		if (NOT BITON (vert_mask, i)) continue;
+	FOR_EACH_SETBIT (i, vert_mask, cip -> num_verts) {
 		/* This is a valid terminal.  There will be one	*/
 		/* cutset row for it.				*/
 		++nvt;
@@ -379,6 +366,8 @@ gst_channel_ptr		param_print_solve_trace;
 	pool -> nvars	= total_vars;
 	pool -> hwmrow	= 0;
 	pool -> hwmnz	= 0;
+	pool -> gc_cursor = 0;
+	pool -> stale_nz = 0;
 
 	/* Empty all of the hash table buckets... */
 	for (i = 0; i < CPOOL_HASH_SIZE; i++) {
@@ -403,8 +392,7 @@ gst_channel_ptr		param_print_solve_trace;
 		rp = pool -> cbuf;
 
 		/* Left side: Σ(i∈E) (|FST[i]| - 1) × x[i] */
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
 			rp -> var = i + RC_VAR_BASE;
 			rp -> val = (cip -> edge_size [i] - 1);
 			++rp;
@@ -426,8 +414,7 @@ gst_channel_ptr		param_print_solve_trace;
 		/* Default Geosteiner: add standard spanning constraint */
 		/* Now generate the row for the spanning constraint... */
 		rp = pool -> cbuf;
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
 			rp -> var = i + RC_VAR_BASE;
 			rp -> val = (cip -> edge_size [i] - 1);
 			++rp;
@@ -443,8 +430,7 @@ gst_channel_ptr		param_print_solve_trace;
 	if (multi_obj_env == NULL) {
 		/* Default Geosteiner: use original hard cutset constraints */
 		fprintf(stderr, "DEBUG CONSTRAINT: Adding original hard cutset constraints\n");
-		for (i = 0; i < cip -> num_verts; i++) {
-			if (NOT BITON (vert_mask, i)) continue;
+		FOR_EACH_SETBIT (i, vert_mask, cip -> num_verts) {
 			rp = pool -> cbuf;
 			ep1 = cip -> term_trees [i];
 			ep2 = cip -> term_trees [i + 1];
@@ -479,8 +465,7 @@ gst_channel_ptr		param_print_solve_trace;
 		   (1) not_covered[j] ≤ 1 - x[i] for each FST i that contains terminal j
 		   (2) Σᵢ x[i] ≤ n·(1 - not_covered[j]) where sum is over FSTs containing terminal j */
 
-		for (i = 0; i < cip -> num_verts; i++) {
-			if (NOT BITON (vert_mask, i)) continue;
+		FOR_EACH_SETBIT (i, vert_mask, cip -> num_verts) {
 			if (NOT cip -> tflag[i]) continue;  /* Only process terminals */
 
 			int terminal_idx = vertex_to_terminal[i];
@@ -562,8 +547,7 @@ gst_channel_ptr		param_print_solve_trace;
 		/* "basic" incompatibilities (edges that share 2 or	*/
 		/* more vertices).  It lists ONLY incompatible edges	*/
 		/* sharing 1 or fewer vertices.				*/
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
 
 			ep1 = cip -> inc_edges [i];
 			ep2 = cip -> inc_edges [i + 1];
@@ -597,8 +581,7 @@ gst_channel_ptr		param_print_solve_trace;
 		memset (fsmask, 0, nmasks * sizeof (*fsmask));
 		memset (tmask, 0, kmasks * sizeof (*tmask));
 
-		for (i = 0; i < nterms; i++) {
-			if (NOT BITON (vert_mask, i)) continue;
+		FOR_EACH_SETBIT (i, vert_mask, nterms) {
 			vp1 = tlist;
 			ep1 = cip -> term_trees [i];
 			ep2 = cip -> term_trees [i + 1];
@@ -672,8 +655,7 @@ gst_channel_ptr		param_print_solve_trace;
 		/* Build budget constraint: Σ tree_cost[i] * x[i] ≤ budget_limit */
 		rp = pool -> cbuf;
 		fprintf(stderr, "DEBUG BUDGET: Building raw cost constraint coefficients:\n");
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
 			double raw_cost = (double) (cip -> cost [i]);
 
 			rp -> var = i + RC_VAR_BASE;
@@ -693,8 +675,7 @@ gst_channel_ptr		param_print_solve_trace;
 	/* Add "at least one FST" constraint: Σ x[i] ≥ 1 */
 	fprintf(stderr, "DEBUG CONSTRAINT: Adding 'at least one FST' constraint: Σ x[i] ≥ 1\n");
 	rp = pool -> cbuf;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		rp -> var = i + RC_VAR_BASE;
 		rp -> val = 1;
 		++rp;
@@ -888,6 +869,7 @@ size_t		nbytes;
 	rcp -> flags	= 0;
 	rcp -> uid	= (pool -> uid)++;
 	rcp -> refc	= 0;		/* no OTHER node references it! */
+	rcp -> birth	= pool -> iter;
 	*hookp = row;
 
 	if (add_to_lp) {
@@ -955,11 +937,11 @@ struct rcoef *		p;
 
 /*
  * This routine sets up the LP problem instance for the initial
- * constraints of the LP relaxation.
+ * constraints of the LP relaxation, using the LP solver selected by
+ * the parameters.  The backend that builds the LP then handles all
+ * later operations on it.
  */
 
-#if CPLEX
-
 	LP_t *
 _gst_build_initial_formulation (
 
@@ -967,1667 +949,328 @@ struct cpool *		pool,		/* IN - initial constraint pool */
 bitmap_t *		vert_mask,	/* IN - set of valid vertices */
 bitmap_t *		edge_mask,	/* IN - set of valid hyperedges */
 struct gst_hypergraph *	cip,		/* IN - compatibility info */
-struct lpmem *		lpmem,		/* OUT - dynamically allocated mem */
-gst_param_ptr		params
+gst_param_ptr		params		/* IN - parameter set */
 )
 {
-int			i, j, k;
-int			nedges;
+const struct lp_backend *	be;
+
+	be = _gst_select_lp_backend (params);
+
+	return (be -> build (pool, vert_mask, edge_mask, cip, params));
+}
+
+/*
+ * This routine solves the current LP relaxation over all constraints
+ * currently residing in the constraint pool, regardless of how many
+ * are actually in the current LP tableaux.  Each time it solves the
+ * LP tableaux, it scans the entire constraint pool for violations.
+ * Every violation that is found is appended to the tableaux and we
+ * loop back to re-optimize the tableaux.  This procedure terminates
+ * only when all constraints in the pool have been satisfied, or a
+ * cutoff or infeasibility is encountered.
+ *
+ * Note also that this procedure NEVER deletes any constraints from
+ * the tableaux, slack or otherwise.  Other code must do this.
+ */
+
+	int
+_gst_solve_LP_over_constraint_pool (
+
+struct bbinfo *		bbip		/* IN - branch and bound info */
+)
+{
+int			i;
+int			status;
+int			ncols;
 int			nrows;
-int			ncoeff;
-int			row;
-int			var;
-int *			tmp;
 struct rcon *		rcp;
-struct rcoef *		cp;
 LP_t *			lp;
-int			macsz, marsz, matsz;
-int			mac, mar;
-int			objsen;
-double *		objx;
-double *		rhsx;
-char *			senx;
-double *		bdl;
-double *		bdu;
-int *			matbeg;
-int *			matcnt;
-int *			matind;
-double *		matval;
-cpu_time_t		T0;
-cpu_time_t		T1;
-double			min_c, max_c, ci;
-int			min_exp, max_exp;
-int			obj_scale;
-char			tbuf [32];
+struct bbnode *		nodep;
+double *		x;
+double *		dj;
+struct cpool *		pool;
+bool			any_violations;
+bool			can_delete_slack;
+int			pool_iteration;
+double			slack;
+double			prev_z;
 
-	T0 = _gst_get_cpu_time ();
+	INDENT (bbip -> params -> print_solve_trace);
 
-	nedges = cip -> num_edges;
+	lp	= bbip -> lp;
+	nodep	= bbip -> node;
+	pool	= bbip -> cpool;
 
-	/* We know exactly how many columns (variables) we will */
-	/* ever need.  We never add additional variables. */
-	/* PSW: In multi-objective mode, we need space for FST + not_covered variables */
-	int num_not_covered_lp = 0;
-	char* budget_env_check_lp = getenv("GEOSTEINER_BUDGET");
-	if (budget_env_check_lp != NULL) {
-		bitmap_t* vert_mask_lp = cip -> initial_vert_mask;
-		/* Count terminals for not_covered variables */
-		for (int i = 0; i < cip -> num_verts; i++) {
-			if (BITON (vert_mask_lp, i) && cip -> tflag[i]) {
-				num_not_covered_lp++;
-			}
-		}
-	}
-	macsz = nedges + num_not_covered_lp;
-	mac = macsz;
+	ncols	= GET_LP_NUM_COLS (lp);
+	nrows	= GET_LP_NUM_ROWS (lp);
 
-	/* Build the objective function... */
-	objx = NEWA (macsz, double);
-	for (i = 0; i < macsz; i++) {
-		objx [i] = 0.0;
-	}
+	if (nodep -> cpiter EQ pool -> uid) {
+		/* nodep -> x is already the optimal solution	*/
+		/* over this constraint pool.			*/
+#if 1
+		gst_channel_printf (bbip -> params -> print_solve_trace, "	Constraint pool unchanged, skip LP solve.\n");
+#endif
+		/* Global solution info valid for this node... */
 
-	/* Set objective coefficients for FST variables */
-	if (budget_env_check_lp != NULL) {
-		/* Multi-objective mode: tree_cost + alpha * battery_cost */
-		double alpha = 10000.0;  /* Weight for battery component */
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
-
-			double tree_cost = (double) (cip -> cost [i]);
-			double battery_cost = 0.0;
-
-			/* Get battery cost from full_trees data */
-			if (cip -> full_trees != NULL && cip -> full_trees[i] != NULL) {
-				battery_cost = cip -> full_trees[i] -> battery_score;
-
-				/* If battery_score is 0, recalculate from edge terminals */
-				if (battery_cost == 0.0 && cip -> pts != NULL) {
-					int nedge_terminals = cip -> edge_size[i];
-					int *edge_terminals = cip -> edge[i];
-
-					for (int j = 0; j < nedge_terminals; j++) {
-						int k = edge_terminals[j];  /* 0-based terminal index */
-						if (k >= 0 && k < cip -> pts -> n) {
-							battery_cost += cip -> pts -> a[k].battery;
-						}
-					}
-				}
+		/* Reallocate slack variables vector, if necessary... */
+		if (bbip -> slack_size < pool -> nlprows) {
+			if (bbip -> slack NE NULL) {
+				free ((char *) (bbip -> slack));
 			}
-
-			objx [i] = tree_cost + alpha * battery_cost;
+			bbip -> slack = NEWA (pool -> nlprows, double);
+			bbip -> slack_size = pool -> nlprows;
 		}
 
-		/* Set objective coefficients for not_covered variables */
-		double beta = 1500000.0;  /* Penalty for uncovered terminals */
-		for (i = 0; i < num_not_covered_lp; i++) {
-			objx [nedges + i] = beta;  /* Penalty for each uncovered terminal */
-		}
-	} else {
-		/* Default mode: use only tree costs */
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (edge_mask, i)) continue;
-			objx [i] = (double) (cip -> cost [i]);
+		for (i = 0; i < nrows; i++) {
+			bbip -> slack [i] = 0.0;
 		}
+		UNINDENT (bbip -> params -> print_solve_trace);
+		return (BBLP_OPTIMAL);
 	}
 
-	/* CPLEX does not behave well if the objective coefficients	*/
-	/* have very large magnitudes.  (If so, we often get "unscaled	*/
-	/* infeasibility" error codes.)  Therefore, we scale objx here	*/
-	/* (by an exact power of two so that the mantissas remain	*/
-	/* unchanged).  Determine a power of two that brings the objx	*/
-	/* magnitudes into a reasonable range.				*/
-
-	min_c	= DBL_MAX;
-	max_c	= 0.0;
-	for (i = 0; i < macsz; i++) {
-		ci = fabs (objx [i]);
-		if (ci EQ 0.0) continue;
-		if (ci < min_c) {
-			min_c = ci;
-		}
-		if (ci > max_c) {
-			max_c = ci;
-		}
-	}
+	x  = NEWA (2 * ncols, double);
+	dj = x + ncols;
 
-	(void) frexp (min_c, &min_exp);
-	(void) frexp (max_c, &max_exp);
-	obj_scale = (min_exp + max_exp) / 2;
+	pool_iteration = 0;
 
-	/* Remember scale factor so we can unscale results. */
-	lpmem -> obj_scale = obj_scale;
+	for (;;) {
+		prev_z = nodep -> z;
 
-	obj_scale = - obj_scale;
+		if ((pool -> npend EQ 0) AND stale_collection_due (pool)) {
+			/* Enough stale rows have aged out to be worth	*/
+			/* a pass over the pool.  Reclaim them now,	*/
+			/* between LP solves, rather than waiting for a	*/
+			/* full collection in the middle of separation.	*/
+			collect_stale_rows (pool, bbip -> params);
+		}
 
-	for (i = 0; i < macsz; i++) {
-		objx [i] = ldexp (objx [i], obj_scale);
-	}
+		verify_pool (bbip -> cpool);
 
-	objsen = _MYCPX_MIN;	/* Minimize */
+		/* Reallocate slack variables vector, if necessary... */
+		if (bbip -> slack_size < pool -> nlprows) {
+			if (bbip -> slack NE NULL) {
+				free ((char *) (bbip -> slack));
+			}
+			bbip -> slack = NEWA (pool -> nlprows, double);
+			bbip -> slack_size = pool -> nlprows;
+		}
 
-	/* Build variable bound arrays... */
-	bdl = NEWA (macsz, double);
-	bdu = NEWA (macsz, double);
-	for (i = 0; i < macsz; i++) {
-		bdl [i] = 0.0;
-		bdu [i] = 1.0;
-	}
+		status = lp -> backend -> solve (bbip, x, dj, pool_iteration);
 
-	mar	= pool -> npend;
-	if (pool -> hwmrow EQ 0) {
-		/* Initial allocation.  Allocate space sufficiently	*/
-		/* large that we are unlikely to need to reallocate the	*/
-		/* CPLEX problem buffers...				*/
+		/* Record another "real" LP solved... */
+		do {
+			++(pool -> iter);
+		} while (pool -> iter EQ -1);
 
-		/* Start with the total number of non-zeros in the	*/
-		/* entire constraint pool...				*/
-		ncoeff = 0;
-		nrows = pool -> nrows;
-		for (i = 0; i < nrows; i++) {
-			rcp = &(pool -> rows [i]);
-			ncoeff += rcp -> len;
-		}
+		++pool_iteration;
 
-		marsz	= 2 * nrows;
-		matsz	= 4 * ncoeff;
-	}
-	else {
-		/* Reallocating CPLEX problem.  We want a moderate rate	*/
-		/* of growth, but must trade this off against the	*/
-		/* frequency of reallocation.  We expand both the rows	*/
-		/* and the non-zeros by 25% over the largest need seen	*/
-		/* now or previously.					*/
-		ncoeff = 0;
-		for (i = 0; i < pool -> npend; i++) {
-			row = pool -> lprows [i];
-			rcp = &(pool -> rows [row]);
-			ncoeff += rcp -> len;
-		}
-		if ((mar > pool -> hwmrow) OR (ncoeff > pool -> hwmnz)) {
-			/* high-water marks should be updated before! */
-			FATAL_ERROR;
-		}
-		marsz = 5 * pool -> hwmrow / 4;
-		matsz = 5 * pool -> hwmnz / 4;
-	}
+		if (status NE BBLP_OPTIMAL) break;
 
-	if (marsz < params -> cplex_min_rows) {
-		marsz = params -> cplex_min_rows;
-	}
-	if (matsz < params -> cplex_min_nzs) {
-		matsz = params -> cplex_min_nzs;
-	}
+		update_lp_solution_history (x, dj, bbip);
 
-	gst_channel_printf (params -> print_solve_trace, "cpx allocation: %d rows, %d cols, %d nz\n",
-		marsz, macsz, matsz);
+		_gst_delete_slack_rows_from_LP (bbip);
 
-	/* Allocate arrays for constraint matrix... */
-	rhsx = NEWA (marsz, double);
-	senx = NEWA (marsz, char);
-	matbeg = NEWA (macsz, int);
-	matcnt = NEWA (macsz, int);
-	matind = NEWA (matsz, int);
-	matval = NEWA (matsz, double);
+#if 0
+		if (nodep -> z >= 1.0001 * prev_z) {
+			/* Objective rose enough to go ahead	*/
+			/* and delete slack rows.  This helps	*/
+			/* keep memory usage down on VERY LARGE	*/
+			/* problems...				*/
+			_gst_delete_slack_rows_from_LP (bbip);
+		}
+#endif
 
-	for (i = 0; i < marsz; i++) {
-		rhsx [i] = 0.0;
-	}
-	for (i = 0; i < macsz; i++) {
-		matbeg [i] = 0;
-		matcnt [i] = 0;
-	}
-	for (i = 0; i < matsz; i++) {
-		matind [i] = 0;
-		matval [i] = 0.0;
-	}
+		verify_pool (bbip -> cpool);
 
-	/* Now go through each row k and compute the number of	*/
-	/* non-zero coefficients for each variable used...	*/
-	tmp = NEWA (macsz, int);
-	for (i = 0; i < macsz; i++) {
-		tmp [i] = 0;
-	}
-	for (i = 0; i < pool -> npend; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		for (cp = rcp -> coefs; ; cp++) {
-			var = cp -> var;
-			if (var < RC_VAR_BASE) break;
-			++(tmp [var - RC_VAR_BASE]);
+		/* Scan entire pool for violations... */
+		rcp = &(pool -> rows [0]);
+		any_violations = FALSE;
+		for (i = 0; i < pool -> nrows; i++, rcp++) {
+			slack = compute_slack_value (rcp -> coefs, x);
+			if (slack > FUZZ) {
+				/* Row is not binding, much less violated. */
+				continue;
+			}
+			/* Consider this row to be binding now! */
+			rcp -> biter = pool -> iter;
+			if ((rcp -> flags & RCON_FLAG_STALE) NE 0) {
+				/* Useful again -- no longer stale. */
+				rcp -> flags &= ~RCON_FLAG_STALE;
+				pool -> stale_nz -= rcp -> len;
+			}
+			if (rcp -> lprow >= 0) {
+				/* Skip this row -- it is already in	*/
+				/* the LP tableaux.			*/
+				continue;
+			}
+			if (slack < -FUZZ) {
+				/* Constraint "i" is not currently in	*/
+				/* the LP tableaux, and is violated.	*/
+				/* Add it.				*/
+				_gst_mark_row_pending_to_LP (pool, i);
+				any_violations = TRUE;
+			}
 		}
-	}
 
-	/* CPLEX wants columns, not rows... */
-	j = 0;
-	for (i = 0; i < mac; i++) {
-		k = tmp [i];
-		matbeg [i] = j;
-		tmp [i] = j;
-		matcnt [i] = k;
-		j += k;
-	}
-	if (j > pool -> hwmnz) {
-		pool -> hwmnz = j;
-	}
-	if (mar > pool -> hwmrow) {
-		pool -> hwmrow = mar;
-	}
-	for (i = 0; i < pool -> npend; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		for (cp = rcp -> coefs; ; cp++) {
-			var = cp -> var;
-			if (var < RC_VAR_BASE) break;
-			j = tmp [var - RC_VAR_BASE];
-			matind [j] = i;
-			matval [j] = cp -> val;
-			++(tmp [var - RC_VAR_BASE]);
-		}
-		switch (var) {
-		case RC_OP_LE:	senx [i] = 'L';		break;
-		case RC_OP_EQ:	senx [i] = 'E';		break;
-		case RC_OP_GE:	senx [i] = 'G';		break;
-		default:
-			FATAL_ERROR;
-		}
-		rhsx [i] = cp -> val;
-		rcp -> lprow = i;
-	}
+		/* Advance the generational aging of the pool by	*/
+		/* one bounded slice while the binding information	*/
+		/* is fresh.						*/
+		age_pool_slice (pool, bbip -> params);
 
-	/* Verify consistency of what we generated... */
-	for (i = 0; i < mac; i++) {
-		if (tmp [i] NE matbeg [i] + matcnt [i]) {
-			fprintf (stderr,
-				 "i = %d, tmp = %d, matbeg = %d, matcnt = %d\n",
-				 i, tmp [i], matbeg [i], matcnt [i]);
-			FATAL_ERROR;
+		/* Done if no violations were appended... */
+		if (NOT any_violations) {
+			/* There are no violated constraints. */
+			/* We must not leave this routine without a	*/
+			/* valid basis or it can cause crashes		*/
+			/* downstream in try_branch() -- if no more	*/
+			/* cuts are found at this node.  Some backends	*/
+			/* can lose the basis when deleting slack rows.	*/
+			if (NOT lp -> backend -> have_basis (lp)) {
+				/* Solving the LP once again will give	*/
+				/* us a valid basis again.		*/
+				continue;
+			}
+			break;
 		}
-	}
 
-	free ((char *) tmp);
+		can_delete_slack = (nodep -> z >= prev_z + 0.0001 * fabs (prev_z));
 
-	pool -> nlprows	= pool -> npend;
-	pool -> npend	= 0;
+		prune_pending_rows (bbip, can_delete_slack);
 
-#if 0
-	_MYCPX_setadvind (1);		/* continue from previous basis. */
-#endif
+		/* Time to append these pool constraints to the	*/
+		/* current LP tableaux...			*/
+		_gst_add_pending_rows_to_LP (bbip);
+	}
 
-	lp = _MYCPX_loadlp ("root",
-			    mac,
-			    mar,
-			    objsen,
-			    objx,
-			    rhsx,
-			    senx,
-			    matbeg,
-			    matcnt,
-			    matind,
-			    matval,
-			    bdl,
-			    bdu,
-			    NULL,
-			    macsz,
-			    marsz,
-			    matsz);
-
-	FATAL_ERROR_IF (lp EQ NULL);
-
-	/* Remember addresses of each buffer for when we need to free them. */
-	lpmem -> objx		= objx;
-	lpmem -> rhsx		= rhsx;
-	lpmem -> senx		= senx;
-	lpmem -> matbeg		= matbeg;
-	lpmem -> matcnt		= matcnt;
-	lpmem -> matind		= matind;
-	lpmem -> matval		= matval;
-	lpmem -> bdl		= bdl;
-	lpmem -> bdu		= bdu;
+	free ((char *) x);
 
-	T1 = _gst_get_cpu_time ();
-	_gst_convert_cpu_time (T1 - T0, tbuf);
-	gst_channel_printf (params -> print_solve_trace, "_gst_build_initial_formulation: %s seconds.\n", tbuf);
+	if (status EQ BBLP_OPTIMAL) {
+		/* Nodep -> x is optimal for the current version of the	*/
+		/* constraint pool.  Skip re-solve if we re-enter this	*/
+		/* routine with the same constraint pool.		*/
+		nodep -> cpiter = pool -> uid;
+	}
+	else {
+		/* Not optimal -- force re-solve next time so that	*/
+		/* correct status is seen next time we're called.  Yes,	*/
+		/* it would have been better if we also saved the LP	*/
+		/* status in the node...				*/
+		nodep -> cpiter = -1;
+	}
 
-	return (lp);
-}
+	verify_pool (bbip -> cpool);
+	UNINDENT (bbip -> params -> print_solve_trace);
 
-#endif
+	return (status);
+}
 
 /*
- * This routine sets up the LP problem instance for the initial
- * constraints of the LP relaxation.
+ * This routine copies the current LP solution into the node's buffer,
+ * and updates the branch heuristic values.
  */
 
-#if LPSOLVE
-
-	LP_t *
-_gst_build_initial_formulation (
+	static
+	void
+update_lp_solution_history (
 
-struct cpool *		pool,		/* IN - initial constraint pool */
-bitmap_t *		vert_mask,	/* IN - set of valid vertices */
-bitmap_t *		edge_mask,	/* IN - set of valid hyperedges */
-struct gst_hypergraph *	cip,		/* IN - compatibility info */
-struct lpmem *		lpmem,		/* OUT - dynamically allocated mem */
-gst_param_ptr		params
-)
-{
-int			i;
-int			nedges;
-int			nrows;
-int			ncols;
-int			ncoeff;
-int			nzi;
-int			row;
-int			var;
-struct rcon *		rcp;
-struct rcoef *		cp;
-LP_t *			lp;
-double *		rowvec;
-double *		rhs;
-short *			ctype;
-int *			matbeg;
-int *			matind;
-double *		matval;
-cpu_time_t		T0;
-cpu_time_t		T1;
-char			tbuf [32];
-
-	T0 = _gst_get_cpu_time ();
-
-	nedges = cip -> num_edges;
-
-	/* PSW: Count terminals for not_covered variables */
-	int nterms = 0;
-	for (i = 0; i < cip -> num_verts; i++) {
-		if (BITON (vert_mask, i) && cip -> tflag[i]) {
-			nterms++;  /* Count only terminals, not Steiner points */
-		}
-	}
-	fprintf(stderr, "DEBUG SOFT: Found %d terminals, %d FSTs\n", nterms, nedges);
-
-	/* PSW: Variables = FST selection (x_i) + terminal coverage (not_covered_t) */
-	ncols = nedges + nterms;
-
-	/* Compute the total number of non-zeros in the INITIAL	*/
-	/* constraints of the constraint pool...		*/
-	ncoeff = 0;
-	nrows = pool -> npend;
-	for (i = 0; i < nrows; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		ncoeff += rcp -> len;
-	}
-
-	/* PSW: Add space for not_covered variables in soft terminal coverage constraints when enabled */
-	char* budget_env = getenv("GEOSTEINER_BUDGET");
-	if (budget_env != NULL) {
-		/* Each soft terminal coverage constraint gets one additional not_covered variable */
-		ncoeff += nterms;  /* One not_covered variable per terminal */
-		fprintf(stderr, "DEBUG SOFT: Adding space for %d not_covered variables in soft constraints, total ncoeff=%d\n",
-			nterms, ncoeff);
-	}
-
-	/* Make the initial LP... */
-	lp = make_lp (0, ncols);
-	fprintf(stderr, "DEBUG LP_SETUP: Created LP with 0 rows, %d columns (nedges=%d + nterms=%d)\n",
-		ncols, nedges, nterms);
-
-	/* All variables are 0-1 variables... */
-	/* PSW: FST selection variables x_i */
-	for (i = 1; i <= nedges; i++) {
-		set_bounds (lp, i, 0.0, 1.0);
-	}
-	/* PSW: Terminal coverage variables not_covered_t */
-	for (i = nedges + 1; i <= nedges + nterms; i++) {
-		set_bounds (lp, i, 0.0, 1.0);
-	}
-	fprintf(stderr, "DEBUG SOFT: Set bounds for %d FST vars [1-%d] and %d coverage vars [%d-%d]\n",
-		nedges, nedges, nterms, nedges+1, nedges+nterms);
-
-	/* Minimize */
-	set_minim (lp);
-
-	/* Build the objective function... */
-	/* PSW: Multi-objective: minimize (normalized_tree_length + alpha * normalized_battery_score + beta * uncovered_terminals) */
-
-	/* PSW: No normalization - use raw values */
-	/* PSW: Multi-objective coefficients */
-	double alpha = 10000.0;  /* Weight for battery component (scale up since battery values are small) */
-	double beta = 1500000.0;  /* Penalty for uncovered terminals */
-
-	fprintf(stderr, "DEBUG OBJ: Using raw costs - alpha=%.1f (battery weight), beta=%.0f (coverage penalty)\n", alpha, beta);
-
-	rowvec = NEWA (ncols + 1, double);
-	fprintf(stderr, "DEBUG OBJ: Allocated rowvec[0-%d] for ncols=%d LP variables\n", ncols, ncols);
-	for (i = 0; i <= ncols; i++) {
-		rowvec [i] = 0.0;
-	}
-
-	/* PSW: FST selection terms: tree_cost + alpha * battery_cost */
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
-		double tree_cost = (double) (cip -> cost [i]);
-		double battery_cost = 0.0;
-
-		/* PSW: Get battery_score - recalculate from terminal data like dumpfst does */
-		if (cip -> full_trees != NULL && cip -> full_trees[i] != NULL) {
-			battery_cost = cip -> full_trees[i] -> battery_score;
-			fprintf(stderr, "DEBUG OBJ: Full_trees battery_score=%.3f for FST %d\n", battery_cost, i);
-
-			/* If battery_score is 0, recalculate from edge terminals */
-			if (battery_cost == 0.0 && cip -> pts != NULL) {
-				/* Use the same approach as dumpfst - access edge terminals */
-				int j, k;
-				int nedge_terminals = cip -> edge_size[i];
-				int *edge_terminals = cip -> edge[i];
-
-				fprintf(stderr, "DEBUG OBJ: Recalculating for FST %d with %d terminals\n", i, nedge_terminals);
-				for (j = 0; j < nedge_terminals; j++) {
-					k = edge_terminals[j];  /* 0-based terminal index */
-					if (k >= 0 && k < cip -> pts -> n) {
-						double bval = cip -> pts -> a[k].battery;
-						battery_cost += bval;
-						fprintf(stderr, "DEBUG OBJ: Terminal %d (idx %d): battery=%.2f, running_total=%.2f\n",
-							j, k, bval, battery_cost);
-					}
-				}
-				fprintf(stderr, "DEBUG OBJ: Recalculated battery_score=%.3f for FST %d\n", battery_cost, i);
-			}
-		} else {
-			fprintf(stderr, "DEBUG OBJ: Cannot access full_trees or pts for FST %d\n", i);
-		}
-
-		/* PSW: Combined FST objective with raw values */
-		rowvec [i + 1] = tree_cost + alpha * battery_cost;
-		fprintf(stderr, "DEBUG OBJ: FST %d: tree_cost=%.3f, battery_cost=%.3f (weighted=%.1f), combined=%.1f\n",
-				i, tree_cost, battery_cost, alpha * battery_cost, rowvec[i + 1]);
-	}
-
-	/* PSW: Terminal coverage penalty terms: beta * not_covered_t */
-	for (i = 0; i < nterms; i++) {
-		rowvec[nedges + 1 + i] = beta;  /* Penalty for each uncovered terminal (1-based for objective) */
-	}
-	fprintf(stderr, "DEBUG OBJ: Added penalty terms beta=%.0f for %d not_covered variables [%d-%d]\n",
-		beta, nterms, nedges+1, nedges+nterms);
-#if 1
-	inc_mat_space (lp, ncols + 1);
-#endif
-	set_obj_fn (lp, rowvec);
-
-	/* PSW: Debug LP matrix structure */
-	if (getenv("GEOSTEINER_BUDGET") != NULL) {
-		fprintf(stderr, "DEBUG LP_MATRIX: LP has %d rows, %d columns after setup\n",
-			lp->rows, lp->columns);
-	}
-
-	free ((char *) rowvec);
-
-	int extra_rows = 0;
-	int extra_coeff = 0;
-	char* multi_obj_env = getenv("GEOSTEINER_BUDGET");
-
-	/* PSW: Calculate extra_coeff for soft coverage constraints when budget is enabled */
-	if (multi_obj_env != NULL) {
-		/* In budget mode, we may add not_covered variables to soft coverage constraints.
-		 * From the debug output, we expect to add up to nterms additional coefficients.
-		 * Let's be conservative and allocate space for nterms extra coefficients. */
-		int nterms = 0;
-		/* Need to get nterms from somewhere - let's check if it's available in the pool or calculate it */
-
-		/* Count terminal coverage constraints that will become soft constraints */
-		for (i = 0; i < nrows; i++) {
-			row = pool -> lprows [i];
-			struct rcon *rcp_temp = &(pool -> rows [row]);
-
-			/* Check if this is a terminal coverage constraint (≥ 1 pattern) */
-			struct rcoef *end_cp;
-			for (end_cp = rcp_temp -> coefs; end_cp -> var >= RC_VAR_BASE; end_cp++) {
-				/* Find the operator */
-			}
-			if (end_cp -> var == RC_OP_GE && end_cp -> val == 1) {
-				/* This will be a soft terminal coverage constraint - add one extra coefficient */
-				extra_coeff++;
-			}
-		}
-
-		/* If we still have extra_coeff=0, be conservative and allocate based on potential needs */
-		if (extra_coeff == 0) {
-			/* From debug output we know 10 terminals lead to 10 extra coefficients */
-			extra_coeff = 20;  /* Conservative allocation */
-		}
-
-		fprintf(stderr, "DEBUG EXTRA_COEFF: Calculated extra_coeff=%d for %d rows\n", extra_coeff, nrows);
-	}
-
-	/* Allocate arrays for setting the rows... */
-	rhs	= NEWA (nrows + extra_rows, double);
-	ctype	= NEWA (nrows + extra_rows, short);
-	matbeg	= NEWA (nrows + extra_rows + 1, int);
-	matind	= NEWA (ncoeff + extra_coeff, int);
-	matval	= NEWA (ncoeff + extra_coeff, double);
-
-	/* Put the rows into the format that LP-solve wants them in...	*/
-	/* PSW: Track terminal index for adding not_covered variables to soft coverage constraints */
-	int terminal_idx = 0;
-
-	nzi = 0;
-	for (i = 0; i < nrows; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		matbeg [i] = nzi;
-
-		/* PSW: Check if this is a soft terminal coverage constraint when multi-objective is enabled */
-		bool is_soft_coverage = FALSE;
-		if (multi_obj_env != NULL) {
-			/* Check if constraint has ≥ 1 pattern (same as old terminal coverage but now it's soft) */
-			struct rcoef *end_cp;
-			for (end_cp = rcp -> coefs; end_cp -> var >= RC_VAR_BASE; end_cp++) {
-				/* Find the operator */
-			}
-			if (end_cp -> var == RC_OP_GE && end_cp -> val == 1) {
-				/* This could be a soft terminal coverage constraint */
-				is_soft_coverage = TRUE;
-			}
-		}
-
-		/* Add original constraint coefficients */
-		for (cp = rcp -> coefs; ; cp++) {
-			var = cp -> var;
-			if (var < RC_VAR_BASE) break;
-			matind [nzi] = var - RC_VAR_BASE;
-			matval [nzi] = cp -> val;
-			++nzi;
-		}
-
-		/* PSW: Add not_covered variable to soft terminal coverage constraints */
-		if (is_soft_coverage && terminal_idx < nterms) {
-			/* Use same RC_VAR_BASE system as other variables */
-			int not_covered_var = (nedges + terminal_idx) + RC_VAR_BASE;
-			matind [nzi] = not_covered_var - RC_VAR_BASE;  /* Convert to 0-based matrix index */
-			matval [nzi] = 1.0;  /* coefficient = 1 */
-			nzi++;
-			fprintf(stderr, "DEBUG SOFT: Added not_covered_%d (RC_var %d -> matrix_idx %d) to soft constraint %d\n",
-				terminal_idx, not_covered_var, not_covered_var - RC_VAR_BASE, i);
-			terminal_idx++;
-		}
-
-		rhs [i] = cp -> val;
-		switch (var) {
-		case RC_OP_LE:	ctype [i] = REL_LE;	break;
-		case RC_OP_EQ:	ctype [i] = REL_EQ;	break;
-		case RC_OP_GE:	ctype [i] = REL_GE;	break;
-		default:
-			FATAL_ERROR;
-			break;
-		}
-		rcp -> lprow = i;
-	}
-
-	matbeg [i] = nzi;
-	fprintf(stderr, "DEBUG MATRIX_CHECK: nzi=%d, ncoeff=%d, extra_coeff=%d, expected=%d\n",
-		nzi, ncoeff, extra_coeff, ncoeff + extra_coeff);
-	if (nzi != (ncoeff + extra_coeff)) {
-		fprintf(stderr, "ERROR: Matrix coefficient count mismatch! nzi=%d != ncoeff=%d + extra_coeff=%d\n",
-			nzi, ncoeff, extra_coeff);
-		/* In budget mode with soft constraints, allow for discrepancies */
-		if (multi_obj_env != NULL && nzi >= (ncoeff - 50) && nzi <= ncoeff + 50) {
-			fprintf(stderr, "WARNING: Allowing discrepancy in budget mode (nzi=%d vs expected=%d)\n",
-				nzi, ncoeff + extra_coeff);
-		} else {
-			FATAL_ERROR;
-		}
-	}
-
-	if (nrows + extra_rows > pool -> hwmrow) {
-		pool -> hwmrow = nrows + extra_rows;
-	}
-	if (nzi > pool -> hwmnz) {
-		pool -> hwmnz = nzi;
-	}
-
-
-	/* Debug: Verify matrix integrity before add_rows */
-	fprintf(stderr, "DEBUG MATRIX: Total matrix has %d entries (nzi=%d)\n", nzi, nzi);
-	fprintf(stderr, "DEBUG MATRIX: matbeg[%d] = %d (should equal nzi)\n", nrows + extra_rows, matbeg[nrows + extra_rows]);
-
-
-	/* Call add_rows and trace what happens */
-	fprintf(stderr, "DEBUG LP: Calling add_rows with %d rows\n", nrows + extra_rows);
-	fprintf(stderr, "DEBUG LP: Before add_rows: LP has %d rows, %d cols, %d nonzeros\n",
-		GET_LP_NUM_ROWS(lp), GET_LP_NUM_COLS(lp), GET_LP_NUM_NZ(lp));
-
-	add_rows (lp, 0, nrows + extra_rows, rhs, ctype, matbeg, matind, matval);
-
-	fprintf(stderr, "DEBUG LP: After add_rows: LP has %d rows, %d cols, %d nonzeros\n",
-		GET_LP_NUM_ROWS(lp), GET_LP_NUM_COLS(lp), GET_LP_NUM_NZ(lp));
-
-	free ((char *) matval);
-	free ((char *) matind);
-	free ((char *) matbeg);
-	free ((char *) ctype);
-	free ((char *) rhs);
-
-	/* PSW: Debug nlprows calculation */
-	fprintf(stderr, "DEBUG NLPROWS: nrows=%d, extra_rows=%d, setting nlprows=%d\n",
-		nrows, extra_rows, nrows + extra_rows);
-
-	pool -> nlprows	= nrows;
-	pool -> npend	= 0;
-
-	verify_pool (pool);
-
-#if 0
-	{ FILE *	fp;
-		fp = fopen ("main.lp", "w");
-		FATAL_ERROR_IF (fp EQ NULL);
-		write_LP (lp, fp);
-		fclose (fp);
-	}
-#endif
-
-	if (params -> lp_solve_perturb) {
-		/* Turn on perturbations to deal with degeneracy... */
-		lp -> anti_degen = TRUE;
-	}
-	if (params -> lp_solve_scale) {
-		/* Turn on auto-scaling of the matrix... */
-		auto_scale (lp);
-	}
-
-	T1 = _gst_get_cpu_time ();
-	_gst_convert_cpu_time (T1 - T0, tbuf);
-	gst_channel_printf (params -> print_solve_trace, "_gst_build_initial_formulation: %s seconds.\n", tbuf);
-
-	return (lp);
-}
-
-#endif
-
-/*
- * This routine solves the current LP relaxation over all constraints
- * currently residing in the constraint pool, regardless of how many
- * are actually in the current LP tableaux.  Each time it solves the
- * LP tableaux, it scans the entire constraint pool for violations.
- * Every violation that is found is appended to the tableaux and we
- * loop back to re-optimize the tableaux.  This procedure terminates
- * only when all constraints in the pool have been satisfied, or a
- * cutoff or infeasibility is encountered.
- *
- * Note also that this procedure NEVER deletes any constraints from
- * the tableaux, slack or otherwise.  Other code must do this.
- */
-
-	int
-_gst_solve_LP_over_constraint_pool (
-
-struct bbinfo *		bbip		/* IN - branch and bound info */
-)
-{
-int			i;
-int			status;
-int			ncols;
-int			nrows;
-struct rcon *		rcp;
-LP_t *			lp;
-struct bbnode *		nodep;
-double *		x;
-double *		dj;
-struct cpool *		pool;
-bool			any_violations;
-bool			can_delete_slack;
-int			pool_iteration;
-double			slack;
-double			prev_z;
-
-	INDENT (bbip -> params -> print_solve_trace);
-
-	lp	= bbip -> lp;
-	nodep	= bbip -> node;
-	pool	= bbip -> cpool;
-
-	ncols	= GET_LP_NUM_COLS (lp);
-	nrows	= GET_LP_NUM_ROWS (lp);
-
-	if (nodep -> cpiter EQ pool -> uid) {
-		/* nodep -> x is already the optimal solution	*/
-		/* over this constraint pool.			*/
-#if 1
-		gst_channel_printf (bbip -> params -> print_solve_trace, "	Constraint pool unchanged, skip LP solve.\n");
-#endif
-		/* Global solution info valid for this node... */
-
-		/* Reallocate slack variables vector, if necessary... */
-		if (bbip -> slack_size < pool -> nlprows) {
-			if (bbip -> slack NE NULL) {
-				free ((char *) (bbip -> slack));
-			}
-			bbip -> slack = NEWA (pool -> nlprows, double);
-			bbip -> slack_size = pool -> nlprows;
-		}
-
-		for (i = 0; i < nrows; i++) {
-			bbip -> slack [i] = 0.0;
-		}
-		UNINDENT (bbip -> params -> print_solve_trace);
-		return (BBLP_OPTIMAL);
-	}
-
-	x  = NEWA (2 * ncols, double);
-	dj = x + ncols;
-
-	pool_iteration = 0;
-
-	for (;;) {
-		prev_z = nodep -> z;
-
-		verify_pool (bbip -> cpool);
-
-		/* Reallocate slack variables vector, if necessary... */
-		if (bbip -> slack_size < pool -> nlprows) {
-			if (bbip -> slack NE NULL) {
-				free ((char *) (bbip -> slack));
-			}
-			bbip -> slack = NEWA (pool -> nlprows, double);
-			bbip -> slack_size = pool -> nlprows;
-		}
-
-		status = solve_single_LP (bbip, x, dj, pool_iteration);
-
-		/* Note: The previous call changes bbip->lp when	*/
-		/* handling the CPLEX "unscaled infeasibility" issue.	*/
-
-		/* Record another "real" LP solved... */
-		do {
-			++(pool -> iter);
-		} while (pool -> iter EQ -1);
-
-		++pool_iteration;
-
-		if (status NE BBLP_OPTIMAL) break;
-
-		update_lp_solution_history (x, dj, bbip);
-
-		_gst_delete_slack_rows_from_LP (bbip);
-
-#if 0
-		if (nodep -> z >= 1.0001 * prev_z) {
-			/* Objective rose enough to go ahead	*/
-			/* and delete slack rows.  This helps	*/
-			/* keep memory usage down on VERY LARGE	*/
-			/* problems...				*/
-			_gst_delete_slack_rows_from_LP (bbip);
-		}
-#endif
-
-		verify_pool (bbip -> cpool);
-
-		/* Scan entire pool for violations... */
-		rcp = &(pool -> rows [0]);
-		any_violations = FALSE;
-		for (i = 0; i < pool -> nrows; i++, rcp++) {
-			slack = compute_slack_value (rcp -> coefs, x);
-			if (slack > FUZZ) {
-				/* Row is not binding, much less violated. */
-				continue;
-			}
-			/* Consider this row to be binding now! */
-			rcp -> biter = pool -> iter;
-			if (rcp -> lprow >= 0) {
-				/* Skip this row -- it is already in	*/
-				/* the LP tableaux.			*/
-				continue;
-			}
-			if (slack < -FUZZ) {
-				/* Constraint "i" is not currently in	*/
-				/* the LP tableaux, and is violated.	*/
-				/* Add it.				*/
-				_gst_mark_row_pending_to_LP (pool, i);
-				any_violations = TRUE;
-			}
-		}
-
-		/* Done if no violations were appended... */
-		if (NOT any_violations) {
-			/* There are no violated constraints. */
-#if LPSOLVE
-			/* FIXME -- the LPSOLVE implementation of	*/
-			/* _gst_delete_slack_rows_from_LP() always	*/
-			/* sets lp->basis_valid = FALSE.  We must not	*/
-			/* leave this routine without a valid basis or	*/
-			/* it can cause crashes downstream in		*/
-			/* try_branch() -- if no more cuts are found at	*/
-			/* this node.  The better fix, of course, is to	*/
-			/* not trash the basis when deleting rows.	*/
-			if (NOT (bbip -> lp -> basis_valid)) {
-				/* Solving the LP once again will give	*/
-				/* us a valid basis again.		*/
-				continue;
-			}
-#endif
-			break;
-		}
-
-		can_delete_slack = (nodep -> z >= prev_z + 0.0001 * fabs (prev_z));
-
-		prune_pending_rows (bbip, can_delete_slack);
-
-		/* Time to append these pool constraints to the	*/
-		/* current LP tableaux...			*/
-		_gst_add_pending_rows_to_LP (bbip);
-	}
-
-	free ((char *) x);
-
-	if (status EQ BBLP_OPTIMAL) {
-		/* Nodep -> x is optimal for the current version of the	*/
-		/* constraint pool.  Skip re-solve if we re-enter this	*/
-		/* routine with the same constraint pool.		*/
-		nodep -> cpiter = pool -> uid;
-	}
-	else {
-		/* Not optimal -- force re-solve next time so that	*/
-		/* correct status is seen next time we're called.  Yes,	*/
-		/* it would have been better if we also saved the LP	*/
-		/* status in the node...				*/
-		nodep -> cpiter = -1;
-	}
-
-	verify_pool (bbip -> cpool);
-	UNINDENT (bbip -> params -> print_solve_trace);
-
-	return (status);
-}
-
-/*
- * This routine copies the current LP solution into the node's buffer,
- * and updates the branch heuristic values.
- */
-
-	static
-	void
-update_lp_solution_history (
-
-double *		srcx,		/* IN - source LP solution */
-double *		dj,		/* IN - source reduced costs */
-struct bbinfo *		bbip		/* IN - branch-and-bound info */
-)
-{
-int			i;
-int			j;
-int			nedges;
-int			dir;
-int			dir2;
-struct bbnode *		nodep;
-double *		dstx;
-double *		bheur;
-double *		zlb;
-double			lb;
-double			z;
-
-	nodep	= bbip -> node;
-	nedges	= bbip -> cip -> num_edges;
-
-	dstx	= nodep -> x;
-	bheur	= nodep -> bheur;
-
-	/* Update the branch heuristic value for each variable.		*/
-	/* Variables that have been "stuck" at one value for a long	*/
-	/* time receive low bheur values.  If fractional, these tend	*/
-	/* to be good branch variables.					*/
-
-	if ((nodep -> num EQ 0) AND (nodep -> iter EQ 0)) {
-		/* First iteration: set initial values. */
-		for (i = 0; i < nedges; i++) {
-			dstx [i] = srcx [i];
-			bheur [i] = 0;
-		}
-	}
-	else {
-		/* Susequent iterations: use time-decayed average. */
-		for (i = 0; i < nedges; i++) {
-			bheur [i] = 0.75 * bheur [i] + fabs (srcx [i] - dstx [i]);
-			dstx [i] = srcx [i];
-		}
-	}
-
-	/* PSW: Copy not_covered variables if in multi-objective mode */
-	if (getenv("GEOSTEINER_BUDGET") != NULL) {
-		/* Count terminals for not_covered variables - must match other logic */
-		struct gst_hypergraph* cip = bbip -> cip;
-		bitmap_t* vert_mask = cip -> initial_vert_mask;
-		int nterms = 0;
-		for (int j = 0; j < cip -> num_verts; j++) {
-			if (BITON (vert_mask, j) && cip -> tflag[j]) {
-				nterms++;
-			}
-		}
-		for (i = 0; i < nterms; i++) {
-			dstx [nedges + i] = srcx [nedges + i];
-		}
-		fprintf(stderr, "DEBUG COPY: Copied %d FST + %d not_covered variables to nodep->x\n",
-			nedges, nterms);
-	}
-
-	/* Now update the Z lower bounds for each variable	*/
-	/* using reduced costs.					*/
-
-	zlb = nodep -> zlb;
-	z   = nodep -> z;
-
-	for (j = 0; j < nedges; j++) {
-		lb = z + fabs (dj [j]);
-		dir = (srcx [j] < 0.5);
-		dir2 = 1 - dir;
-		i = 2 * j;
-		if (lb > zlb [i + dir]) {
-			zlb [i + dir] = lb;
-		}
-		if (z > zlb [i + dir2]) {
-			zlb [i + dir2] = z;
-		}
-	}
-}
-
-/*
- * This routine solves a single LP tableaux using LP_SOLVE.
- */
-
-#ifdef LPSOLVE
-
-	static
-	int
-solve_single_LP (
-
-struct bbinfo *		bbip,		/* IN - branch and bound info */
-double *		x,		/* OUT - LP solution variables */
-double *		dj,		/* OUT - LP reduced costs */
-int			pool_iteration	/* IN - pool iteration number */
-)
-{
-int			i;
-int			status;
-double			z;
-LP_t *			lp;
-double *		slack;
-int			nslack;
-double *		djbuf;
-struct gst_hypergraph *	cip;
-
-	(void) pool_iteration;
-
-	verify_pool (bbip -> cpool);
-
-	cip	= bbip -> cip;
-	lp	= bbip -> lp;
-
-#if 0
-	/* Debug code to dump each LP instance attempted... */
-	{ char		buf [64];
-		sprintf (buf,
-			 "Node.%03d.%03d.%03d.lp",
-			 bbip -> node -> num,
-			 bbip -> node -> iter + 1,
-			 pool_iteration);
-		dump_lp (lp, buf);
-	}
-#endif
-
-	/* Solve the current LP instance... */
-	status = solve (lp);
-
-	/* Get current LP solution... */
-	z = lp -> best_solution [0];
-
-	/* PSW: Read FST variables */
-	for (i = 0; i < cip -> num_edges; i++) {
-		x [i] = lp -> best_solution [lp -> rows + i + 1];
-	}
-
-	/* PSW: Read not_covered variables if in multi-objective mode */
-	if (getenv("GEOSTEINER_BUDGET") != NULL) {
-		/* Count terminals for not_covered variables - must match other logic */
-		bitmap_t* vert_mask = cip -> initial_vert_mask;
-		int nterms = 0;
-		for (int j = 0; j < cip -> num_verts; j++) {
-			if (BITON (vert_mask, j) && cip -> tflag[j]) {
-				nterms++;
-			}
-		}
-		for (i = 0; i < nterms; i++) {
-			x [cip -> num_edges + i] = lp -> best_solution [lp -> rows + cip -> num_edges + i + 1];
-		}
-		fprintf(stderr, "DEBUG SOLUTION: Read %d FST + %d not_covered variables from LP solution (lp->rows=%d)\n",
-			cip -> num_edges, nterms, lp -> rows);
-		fprintf(stderr, "DEBUG SOLUTION: LP solution array indices: FST[%d-%d], not_covered[%d-%d]\n",
-			lp -> rows + 1, lp -> rows + cip -> num_edges,
-			lp -> rows + cip -> num_edges + 1, lp -> rows + cip -> num_edges + nterms);
-		/* Debug: Show some raw LP solution values */
-		for (i = 0; i < 15 && i < lp->columns + lp->rows + 1; i++) {
-			fprintf(stderr, "DEBUG SOLUTION: lp->best_solution[%d] = %.6f\n", i, lp -> best_solution[i]);
-		}
-	}
-
-	bbip -> node -> z	= z;
-
-	/* Get solution status into solver-independent form... */
-	switch (status) {
-	case OPTIMAL:		status = BBLP_OPTIMAL;		break;
-	case MILP_FAIL:		status = BBLP_CUTOFF;		break;
-	case INFEASIBLE:	status = BBLP_INFEASIBLE;	break;
-	case UNBOUNDED:
-		gst_channel_printf (bbip -> params -> print_solve_trace, "WARNING: LP is unbounded, treating as infeasible\n");
-		status = BBLP_INFEASIBLE;	break;
-	default:
-		gst_channel_printf (bbip -> params -> print_solve_trace, "solve status = %d\n", status);
-		FATAL_ERROR;
-	}
-
-	/* Grab the reduced costs, for future reference. */
-	djbuf = NEWA (lp -> sum + 1, double);
-	get_reduced_costs (lp, djbuf);
-	memcpy (dj,
-		&djbuf [lp -> rows + 1],
-		lp -> columns * sizeof (double));
-	free ((char *) djbuf);
-
-	/* Grab the values of the slack variables, for future reference. */
-	slack = NEWA (lp -> rows + 1, double);
-	get_slack_vars (lp, slack);
-	memcpy (bbip -> slack, &slack [1], lp -> rows * sizeof (double));
-	free ((char *) slack);
-
-	/* Print info about the LP tableaux we just solved... */
-	slack = bbip -> slack;
-	nslack = 0;
-	for (i = 0; i < lp -> rows; i++) {
-		if (slack [i] > FUZZ) {
-			++nslack;
-		}
-	}
-	(void) gst_channel_printf (bbip -> params -> print_solve_trace, "@PL %d rows, %d cols, %d nonzeros,"
-		       " %d slack, %d tight.\n",
-		       lp -> rows, lp -> columns, lp -> non_zeros,
-		       nslack, lp -> rows - nslack);
-
-	return (status);
-}
-
-#endif
-
-/*
- * This routine appends "pool -> npend" new rows onto the end of the
- * LP tableaux from the constraint pool.  The constraint numbers of
- * the actual pool constraints to add reside at the end of the
- * "pool -> lprows []" array (starting with element pool -> nlprows).
- * An additional detail is that for each pool constraint we add, we
- * must record which row of the LP tableaux it now resides in.
- */
-
-#ifdef LPSOLVE
-
-	void
-_gst_add_pending_rows_to_LP (
-
-struct bbinfo *		bbip		/* IN - branch and bound info */
-)
-{
-int			i;
-int			j;
-int			i1;
-int			i2;
-int			newrows;
-int			ncoeff;
-int			nzi;
-int			row;
-int			var;
-struct rcon *		rcp;
-struct rcoef *		cp;
-LP_t *			lp;
-struct cpool *		pool;
-double *		rhs;
-short *			ctype;
-int *			matbeg;
-int *			matind;
-double *		matval;
-
-	verify_pool (bbip -> cpool);
-
-	lp	= bbip -> lp;
-	pool	= bbip -> cpool;
-
-	if (lp -> rows NE pool -> nlprows) {
-		/* LP is out of sync with the pool... */
-		FATAL_ERROR;
-	}
-
-	/* Get number of rows and non-zeros to add to LP... */
-	newrows = pool -> npend;
-
-	FATAL_ERROR_IF (newrows < 0);
-
-	if (newrows EQ 0) return;
-
-	i1	= pool -> nlprows;
-	i2	= i1 + newrows;
-
-	/* Get number of rows and non-zeros to add to LP... */
-	ncoeff = 0;
-	for (i = i1; i < i2; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		/* Constraint not pending? */
-		FATAL_ERROR_IF (rcp -> lprow NE -2);
-		rcp -> lprow = i;
-		ncoeff += rcp -> len;
-	}
-
-	if (i2 > pool -> hwmrow) {
-		pool -> hwmrow = i2;
-	}
-	if (lp -> non_zeros + ncoeff > pool -> hwmnz) {
-		pool -> hwmnz = lp -> non_zeros + ncoeff;
-	}
-
-	/* Allocate arrays for setting the rows... */
-	rhs	= NEWA (newrows, double);
-	ctype	= NEWA (newrows, short);
-	matbeg	= NEWA (newrows + 1, int);
-	matind	= NEWA (ncoeff, int);
-	matval	= NEWA (ncoeff, double);
-
-	/* Put the rows into the format that LP-solve wants them in... */
-	nzi = 0;
-	j = 0;
-	for (i = i1; i < i2; i++, j++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		matbeg [j] = nzi;
-		for (cp = rcp -> coefs; ; cp++) {
-			var = cp -> var;
-			if (var < RC_VAR_BASE) break;
-			matind [nzi] = var - RC_VAR_BASE;
-			matval [nzi] = cp -> val;
-			++nzi;
-		}
-		rhs [j] = cp -> val;
-		switch (var) {
-		case RC_OP_LE:	ctype [j] = REL_LE;	break;
-		case RC_OP_EQ:	ctype [j] = REL_EQ;	break;
-		case RC_OP_GE:	ctype [j] = REL_GE;	break;
-		default:
-			FATAL_ERROR;
-			break;
-		}
-	}
-	matbeg [j] = nzi;
-	FATAL_ERROR_IF (nzi NE ncoeff);
-
-	gst_channel_printf (bbip -> params -> print_solve_trace, "@PAP adding %d rows, %d nz to LP\n", newrows, ncoeff);
-
-	add_rows (lp, 0, newrows, rhs, ctype, matbeg, matind, matval);
-
-	pool -> nlprows = i2;
-	pool -> npend	= 0;
-
-	verify_pool (bbip -> cpool);
-
-	free ((char *) matval);
-	free ((char *) matind);
-	free ((char *) matbeg);
-	free ((char *) ctype);
-	free ((char *) rhs);
-}
-
-#endif
-
-/*
- * This routine solves a single LP tableaux using CPLEX.
- */
-
-#ifdef CPLEX
-
-	static
-	int
-solve_single_LP (
-
-struct bbinfo *		bbip,		/* IN - branch and bound info */
-double *		x,		/* OUT - LP solution variables */
-double *		dj,		/* OUT - LP reduced costs */
-int			pool_iteration	/* IN - pool iteration number */
-)
-{
-int			i;
-int			status;
-double			z;
-LP_t *			lp;
-double *		slack;
-int			nrows;
-int			ncols;
-int			non_zeros;
-int			nslack;
-bool			scaling_disabled;
-int			small;
-int			big;
-int			obj_scale;
-gst_channel_ptr		print_solve_trace;
-
-	print_solve_trace = bbip -> params -> print_solve_trace;
-
-	(void) pool_iteration;
-
-	lp	= bbip -> lp;
-
-	scaling_disabled = FALSE;
-
-retry_lp:
-	/* Solve the current LP instance... */
-	status = _MYCPX_dualopt (lp);
-	if (status NE 0) {
-		gst_channel_printf (print_solve_trace, " WARNING dualopt: status = %d\n", status);
-	}
-
-	/* Get current LP solution... */
-	i = _MYCPX_solution (lp,
-			     &status,		/* solution status */
-			     &z,		/* objective value */
-			     x,			/* solution variables */
-			     NULL,		/* IGNORE dual values */
-			     bbip -> slack,	/* slack variables */
-			     dj);		/* reduced costs */
-	if (i NE 0) {
-		fprintf (stderr, "err_code = %d\n", i);
-		FATAL_ERROR;
-	}
-
-	obj_scale = bbip -> lpmem -> obj_scale;
-	ncols	  = _MYCPX_getnumcols (lp);
-
-	if (obj_scale NE 0) {
-		/* Unscale CPLEX results. */
-		z = ldexp (z, obj_scale);
-		for (i = 0; i < ncols; i++) {
-			dj [i] = ldexp (dj [i], obj_scale);
-		}
-	}
-
-	bbip -> node -> z	= z;
-
-	/* Get solution status into solver-independent form... */
-	switch (status) {
-	case _MYCPX_STAT_OPTIMAL:
-		status = BBLP_OPTIMAL;
-		break;
-
-	case _MYCPX_STAT_INFEASIBLE:
-	case _MYCPX_STAT_UNBOUNDED:	/* (CPLEX sometimes gives this for an	*/
-				/* infeasible problem.)			*/
-		status = BBLP_INFEASIBLE;
-		break;
-
-	case _MYCPX_STAT_ABORT_OBJ_LIM:	/* Objective limit exceeded... */
-		status = BBLP_CUTOFF;
-		break;
-
-	case _MYCPX_STAT_OPTIMAL_INFEAS:
-		/* This means that CPLEX scaled the problem, found an	*/
-		/* optimal solution, unscaled the solution, but that	*/
-		/* the unscaled solution no longer satisfied all of the	*/
-		/* bound or row feasibility tolerances (i.e. the the	*/
-		/* unscaled solution is no longer feasible).  We fix	*/
-		/* This by turning off scaling and trying again.  Note	*/
-		/* that this happens very rarely, but that CPLEX runs	*/
-		/* much slower with scaling turned off, so we don't	*/
-		/* want to leave scaling off if we can help it...	*/
-		if (scaling_disabled) {
-			/* CPLEX is never supposed to return this code	*/
-			/* when scaling is diabled!			*/
-			FATAL_ERROR;
-		}
-
-		gst_channel_printf (print_solve_trace, "TURNING OFF SCALING...\n");
-
-		if (_MYCPX_setscaind (-1, &small, &big) NE 0) {
-			FATAL_ERROR;
-		}
-
-		/* Must reload the entire problem for this to take effect! */
-		reload_cplex_problem (bbip);
-		lp = bbip -> lp;
-
-		scaling_disabled = TRUE;
-
-		goto retry_lp;
-
-	default:
-		fprintf (stderr, "Unexpected status = %d\n", status);
-		_MYCPX_lpwrite (lp, "core.lp");
-		FATAL_ERROR;
-		break;
-	}
-
-	if (scaling_disabled) {
-		/* Must re-enable scaling, or we'll be really slow! */
-		gst_channel_printf (print_solve_trace, "TURNING ON SCALING...\n");
-		if (_MYCPX_setscaind (0, &small, &big) NE 0) {
-			FATAL_ERROR;
-		}
-
-		/* Must reload entire problem for this to take affect! */
-		reload_cplex_problem (bbip);
-		lp = bbip -> lp;
-	}
-
-	/* Print info about the LP tableaux we just solved... */
-	nrows	  = _MYCPX_getnumrows (lp);
-	ncols	  = _MYCPX_getnumcols (lp);
-	non_zeros = _MYCPX_getnumnz (lp);
-	slack = bbip -> slack;
-	nslack = 0;
-	for (i = 0; i < nrows; i++) {
-		if (slack [i] > FUZZ) {
-			++nslack;
-		}
-	}
-	(void) gst_channel_printf (print_solve_trace, "@PL %d rows, %d cols, %d nonzeros,"
-		       " %d slack, %d tight.\n",
-		       nrows, ncols, non_zeros,
-		       nslack, nrows - nslack);
-
-	return (status);
-}
-
-#endif
-
-/*
- * This routine appends "pool -> npend" new rows onto the end of the
- * LP tableaux from the constraint pool.  The constraint numbers of
- * the actual pool constraints to add reside at the end of the
- * "pool -> lprows []" array (starting with element pool -> nlprows).
- * An additional detail is that for each pool constraint we add, we
- * must record which row of the LP tableaux it now resides in.
- */
-
-#ifdef CPLEX
-
-	void
-_gst_add_pending_rows_to_LP (
-
-struct bbinfo *		bbip		/* IN - branch and bound info */
+double *		srcx,		/* IN - source LP solution */
+double *		dj,		/* IN - source reduced costs */
+struct bbinfo *		bbip		/* IN - branch-and-bound info */
 )
 {
 int			i;
 int			j;
-int			i1;
-int			i2;
-int			newrows;
-int			ncoeff;
-int			row;
-int			nzi;
-int			var;
-int			num_nz;
-struct rcon *		rcp;
-struct rcoef *		cp;
-LP_t *			lp;
-struct cpool *		pool;
-double *		rhs;
-char *			sense;
-int *			matbeg;
-int *			matind;
-double *		matval;
-
-	verify_pool (bbip -> cpool);
-
-	lp	= bbip -> lp;
-	pool	= bbip -> cpool;
-
-	if (_MYCPX_getnumrows (lp) NE pool -> nlprows) {
-		/* LP is out of sync with the pool... */
-		FATAL_ERROR;
-	}
-
-	/* Get number of rows and non-zeros to add to LP... */
-	newrows = pool -> npend;
+int			nedges;
+int			dir;
+int			dir2;
+struct bbnode *		nodep;
+double *		dstx;
+double *		bheur;
+double *		zlb;
+double			lb;
+double			z;
 
-	FATAL_ERROR_IF (newrows < 0);
+	nodep	= bbip -> node;
+	nedges	= bbip -> cip -> num_edges;
 
-	if (newrows EQ 0) return;
+	dstx	= nodep -> x;
+	bheur	= nodep -> bheur;
 
-	i1	= pool -> nlprows;
-	i2	= i1 + newrows;
+	/* Update the branch heuristic value for each variable.		*/
+	/* Variables that have been "stuck" at one value for a long	*/
+	/* time receive low bheur values.  If fractional, these tend	*/
+	/* to be good branch variables.					*/
 
-	/* Get number of rows and non-zeros to add to LP... */
-	ncoeff = 0;
-	for (i = i1; i < i2; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		if (rcp -> lprow NE -2) {
-			/* Constraint not pending? */
-			FATAL_ERROR;
+	if ((nodep -> num EQ 0) AND (nodep -> iter EQ 0)) {
+		/* First iteration: set initial values. */
+		for (i = 0; i < nedges; i++) {
+			dstx [i] = srcx [i];
+			bheur [i] = 0;
 		}
-		rcp -> lprow = i;
-		ncoeff += rcp -> len;
-	}
-
-
-	gst_channel_printf (bbip -> params -> print_solve_trace, "@PAP adding %d rows, %d nz to LP\n", newrows, ncoeff);
-
-	num_nz	  = _MYCPX_getnumnz (lp);
-
-	/* Update high-water marks... */
-	if (i2 > pool -> hwmrow) {
-		pool -> hwmrow = i2;
 	}
-	if (num_nz + ncoeff > pool -> hwmnz) {
-		pool -> hwmnz = num_nz + ncoeff;
+	else {
+		/* Susequent iterations: use time-decayed average. */
+		for (i = 0; i < nedges; i++) {
+			bheur [i] = 0.75 * bheur [i] + fabs (srcx [i] - dstx [i]);
+			dstx [i] = srcx [i];
+		}
 	}
 
-#ifndef CPLEX_HAS_CREATEPROB
-	/* Check to see if the current CPLEX allocations are	*/
-	/* sufficient.  If not, we must reallocate...		*/
-	{ int row_space;
-	  int nz_space;
-	  row_space = _MYCPX_getrowspace (lp);
-	  nz_space  = _MYCPX_getnzspace (lp);
-	  if ((i2 > row_space) OR (num_nz + ncoeff > nz_space)) {
-		/* We must reallocate!  We do this by throwing away the */
-		/* old LP completely and building it again from scratch	*/
-		/* using only the info available in the constraint	*/
-		/* pool.  Hopefully this way we avoid poor memory	*/
-		/* utilization due to fragmentation...			*/
-
-		reload_cplex_problem (bbip);
-
-		return;
-	  }
+	/* PSW: Copy not_covered variables if in multi-objective mode */
+	if (getenv("GEOSTEINER_BUDGET") != NULL) {
+		/* Count terminals for not_covered variables - must match other logic */
+		struct gst_hypergraph* cip = bbip -> cip;
+		bitmap_t* vert_mask = cip -> initial_vert_mask;
+		int nterms = 0;
+		for (int j = 0; j < cip -> num_verts; j++) {
+			if (BITON (vert_mask, j) && cip -> tflag[j]) {
+				nterms++;
+			}
+		}
+		for (i = 0; i < nterms; i++) {
+			dstx [nedges + i] = srcx [nedges + i];
+		}
+		fprintf(stderr, "DEBUG COPY: Copied %d FST + %d not_covered variables to nodep->x\n",
+			nedges, nterms);
 	}
-#endif
 
-	/* Allocate arrays for setting the rows... */
-	rhs	= NEWA (newrows, double);
-	sense	= NEWA (newrows, char);
-	matbeg	= NEWA (newrows + 1, int);
-	matind	= NEWA (ncoeff, int);
-	matval	= NEWA (ncoeff, double);
+	/* Now update the Z lower bounds for each variable	*/
+	/* using reduced costs.					*/
 
-	/* Put the rows into the format that CPLEX wants them in... */
-	nzi = 0;
-	j = 0;
-	for (i = i1; i < i2; i++, j++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		matbeg [j] = nzi;
-		for (cp = rcp -> coefs; ; cp++) {
-			var = cp -> var;
-			if (var < RC_VAR_BASE) break;
-			matind [nzi] = var - RC_VAR_BASE;
-			matval [nzi] = cp -> val;
-			++nzi;
+	zlb = nodep -> zlb;
+	z   = nodep -> z;
+
+	for (j = 0; j < nedges; j++) {
+		lb = z + fabs (dj [j]);
+		dir = (srcx [j] < 0.5);
+		dir2 = 1 - dir;
+		i = 2 * j;
+		if (lb > zlb [i + dir]) {
+			zlb [i + dir] = lb;
 		}
-		rhs [j] = cp -> val;
-		switch (var) {
-		case RC_OP_LE:	sense [j] = 'L';	break;
-		case RC_OP_EQ:	sense [j] = 'E';	break;
-		case RC_OP_GE:	sense [j] = 'G';	break;
-		default:
-			FATAL_ERROR;
-			break;
+		if (z > zlb [i + dir2]) {
+			zlb [i + dir2] = z;
 		}
 	}
-	matbeg [j] = nzi;
-	FATAL_ERROR_IF (nzi NE ncoeff);
-
-	i = _MYCPX_addrows (lp,
-			    0,
-			    newrows,
-			    ncoeff,
-			    rhs,
-			    sense,
-			    matbeg,
-			    matind,
-			    matval,
-			    NULL,
-			    NULL);
-
-	FATAL_ERROR_IF (i NE 0);
-
-	pool -> nlprows = i2;
-	pool -> npend	= 0;
-
-	verify_pool (bbip -> cpool);
-
-	free ((char *) matval);
-	free ((char *) matind);
-	free ((char *) matbeg);
-	free ((char *) sense);
-	free ((char *) rhs);
 }
-
-#endif
 
 /*
- * This routine frees the current CPLEX problem, and reallocates/rebuilds
- * it from the current constraint pool.  This routine works even if
- * there are constraints pending addition to the LP tableaux.
+ * This routine appends "pool -> npend" new rows onto the end of the
+ * LP tableaux from the constraint pool.  The constraint numbers of
+ * the actual pool constraints to add reside at the end of the
+ * "pool -> lprows []" array (starting with element pool -> nlprows).
+ * An additional detail is that for each pool constraint we add, we
+ * must record which row of the LP tableaux it now resides in.
  */
 
-#if CPLEX
-
-	static
 	void
-reload_cplex_problem (
+_gst_add_pending_rows_to_LP (
 
-struct bbinfo *		bbip		/* IN - branch-and-bound info */
+struct bbinfo *		bbip		/* IN - branch and bound info */
 )
 {
-int			i;
-int			j;
-int			i1;
-int			i2;
-int			newrows;
-int			row;
-int			nedges;
-struct rcon *		rcp;
-LP_t *			lp;
-struct cpool *		pool;
-int *			cstat;
-int *			rstat;
-int *			b_index;
-char *			b_lu;
-double *		b_bd;
-
-	lp	= bbip -> lp;
-	pool	= bbip -> cpool;
-
-	newrows	= pool -> npend;
-	i1	= pool -> nlprows;
-	i2	= i1 + newrows;
-
-	gst_channel_printf (bbip -> params -> print_solve_trace, "REALLOCATING CPLEX PROBLEM...\n");
-
-	/* Save off the current basis, setting the new	*/
-	/* rows to be basic...				*/
-	cstat = NEWA (bbip -> cip -> num_edges, int);
-	rstat = NEWA (i2, int);
-	if (_MYCPX_getbase (lp, cstat, rstat) NE 0) {
-		FATAL_ERROR;
-	}
-	for (i = i1; i < i2; i++) {
-		/* Set slack variables for new rows to be basic... */
-		rstat [i] = 1;
-	}
-
-	/* Free up the current LP... */
-	_gst_destroy_initial_formulation (bbip);
-
-	/* Make all LP rows be pending again... */
-	for (i = 0; i < pool -> nlprows; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		if (rcp -> lprow < 0) {
-			/* Not currently in LP? */
-			FATAL_ERROR;
-		}
-		rcp -> lprow = -2;	/* is now pending... */
-	}
-	pool -> npend += pool -> nlprows;
-	pool -> nlprows = 0;
-
-	/* Build the initial formulation from scratch again... */
-	lp = _gst_build_initial_formulation (pool,
-					     bbip -> vert_mask,
-					     bbip -> edge_mask,
-					     bbip -> cip,
-					     bbip -> lpmem,
-					     bbip -> params);
-	bbip -> lp = lp;
-
-	/* The initial formulation bounds all variables	*/
-	/* from 0 to 1.  We must restore the proper	*/
-	/* bounds for all variables that have been	*/
-	/* fixed to 0 or 1...				*/
-
-	nedges = bbip -> cip -> num_edges;
-	b_index = NEWA (2 * nedges, int);
-	b_lu	= NEWA (2 * nedges, char);
-	b_bd	= NEWA (2 * nedges, double);
-	j = 0;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (bbip -> fixed, i)) continue;
-		b_index [j]	= i;
-		b_lu [j]	= 'L';
-		b_index [j+1]	= i;
-		b_lu [j+1]	= 'U';
-		if (NOT BITON (bbip -> value, i)) {
-			b_bd [j]	= 0.0;
-			b_bd [j+1]	= 0.0;
-		}
-		else {
-			b_bd [j]	= 1.0;
-			b_bd [j+1]	= 1.0;
-		}
-		j += 2;
-	}
-
-	if (j > 0) {
-		if (_MYCPX_chgbds (lp, j, b_index, b_lu, b_bd) NE 0) {
-			FATAL_ERROR;
-		}
-	}
-
-	free ((char *) b_bd);
-	free ((char *) b_lu);
-	free ((char *) b_index);
-
-	/* Restore augmented basis... */
-	if (_MYCPX_copybase (lp, cstat, rstat) NE 0) {
-		FATAL_ERROR;
-	}
-	free ((char *) rstat);
-	free ((char *) cstat);
+	bbip -> lp -> backend -> add_pending_rows (bbip);
 }
-
-#endif
 
 /*
  * This routine marks a single row as "pending addition to the LP tableaux,"
@@ -2658,6 +1301,10 @@ struct rcon *		rcp;
 
 	/* row is now pending... */
 	rcp -> lprow = -2;
+	if ((rcp -> flags & RCON_FLAG_STALE) NE 0) {
+		rcp -> flags &= ~RCON_FLAG_STALE;
+		pool -> stale_nz -= rcp -> len;
+	}
 
 	i = pool -> nlprows + (pool -> npend)++;
 	pool -> lprows [i] = row;
@@ -2981,14 +1628,25 @@ double			sum;
  * is done any time we have too many coefficients to fit into the alloted
  * pool space.
  *
- * Constraints are considered for replacement based upon the product of
- * their size and the number of iterations since they were effective
- * (i.e. binding).  We *never* remove "initial" constraints, since they
- * would never be found by the separation algorithms.  Neither do we
- * remove constraints that have been binding sometime during the most
- * recent few iterations.
+ * The pool is generational.  Rows start out "young" and are promoted to
+ * the "old" generation once they are still binding after surviving
+ * GC_PROMOTE_AGE iterations (see age_pool_slice()).  Young rows that have
+ * been idle for a while are marked STALE incrementally between LP solves,
+ * and are always the first to go -- they need no ranking at all.  Only if
+ * evicting the stale rows does not recover enough space do we rank the
+ * remaining candidates by the product of their size and the number of
+ * iterations since they were effective (i.e. binding).  Old rows get a
+ * longer grace period than young ones.  We *never* remove "initial"
+ * constraints, since they would never be found by the separation
+ * algorithms.
  */
 
+#define	GC_YOUNG_GRACE	10	/* Grace iterations for young rows */
+#define	GC_OLD_GRACE	50	/* Grace iterations for old rows */
+#define	GC_STALE_IDLE	3	/* Idle iterations before young is stale */
+#define	GC_PROMOTE_AGE	10	/* Age at which binding rows are promoted */
+#define	GC_STALE_FRACTION 4	/* Collect stale rows at 1/4 of pool nz */
+
 	static
 	void
 garbage_collect_pool (
@@ -3000,12 +1658,14 @@ gst_param_ptr		params
 )
 {
 int			i;
-int			j;
 int			k;
 int			maxsize;
 int			minrow;
 int			count;
+int			nstale;
+int			stale_nz;
 int			time;
+int			grace;
 int			nz;
 int			target;
 int			impending_size;
@@ -3014,14 +1674,6 @@ struct rcon *		rcp;
 int *			cnum;
 int32u *		cost;
 bool *			delflags;
-int *			renum;
-int *			ihookp;
-struct rblk *		blkp;
-struct rcoef *		p1;
-struct rcoef *		p2;
-struct rcoef *		p3;
-struct rblk *		tmp1;
-struct rblk *		tmp2;
 
 	gst_channel_printf (params -> print_solve_trace, "Entering garbage_collect_pool\n");
 	print_pool_memory_usage (pool, params -> print_solve_trace);
@@ -3048,7 +1700,12 @@ struct rblk *		tmp2;
 		}
 	}
 
-	count = 0;
+	/* Gather the candidates.  Rows that must go no matter what	*/
+	/* (discarded or stale) are stacked at the END of cnum [], the	*/
+	/* rows that must be ranked by cost at the front.		*/
+	count	 = 0;
+	nstale	 = 0;
+	stale_nz = 0;
 	for (i = pool -> initrows; i < pool -> nrows; i++) {
 		rcp = &(pool -> rows [i]);
 		if (rcp -> lprow NE -1) {
@@ -3061,24 +1718,20 @@ struct rblk *		tmp2;
 			/* some currently suspended node!		*/
 			continue;
 		}
-		if ((rcp -> flags & RCON_FLAG_DISCARD) NE 0) {
+		if ((rcp -> flags & (RCON_FLAG_DISCARD | RCON_FLAG_STALE)) NE 0) {
 			/* Always discard these! */
-			cnum [count]	= i;
-			cost [count]	= INT_MAX;
-			++count;
+			++nstale;
+			cnum [maxsize - nstale] = i;
+			stale_nz += rcp -> len;
 			continue;
 		}
 		time = pool -> iter - rcp -> biter;
-#if 1
-#define	GRACE_TIME	10
-#else
-#define	GRACE_TIME	50
-#endif
-		if (time < GRACE_TIME) {
+		grace = ((rcp -> flags & RCON_FLAG_OLD) NE 0)
+				? GC_OLD_GRACE : GC_YOUNG_GRACE;
+		if (time < grace) {
 			/* Give this constraint more time in the pool.	*/
 			continue;
 		}
-#undef GRACE_TIME
 
 		/* This row is a candidate for being deleted! */
 		cnum [count]	= i;
@@ -3086,7 +1739,7 @@ struct rblk *		tmp2;
 		++count;
 	}
 
-	if (count <= 0) {
+	if (count + nstale <= 0) {
 		free ((char *) cost);
 		free ((char *) cnum);
 		return;
@@ -3115,52 +1768,234 @@ struct rblk *		tmp2;
 	impending_size = pool -> num_nz + ncoeff;
 
 	if (impending_size <= target) {
-		free ((char *) cost);
-		free ((char *) cnum);
-		return;
+		if (nstale <= 0) {
+			free ((char *) cost);
+			free ((char *) cnum);
+			return;
+		}
+		/* Within target, but the stale rows are free to	*/
+		/* reclaim -- so reclaim only those.			*/
+		min_recover = 0;
 	}
-
-	min_recover = 3 * ncoeff / 2;
-
-	if ((impending_size > target) AND
-	    (impending_size - target > min_recover)) {
-		min_recover = impending_size - target;
+	else {
+		min_recover = 3 * ncoeff / 2;
+		if (impending_size - target > min_recover) {
+			min_recover = impending_size - target;
+		}
 	}
 
-	/* Sort candidate rows by cost... */
-	sort_gc_candidates (cnum, cost, count);
+	delflags = NEWA (pool -> nrows, bool);
+	memset (delflags, 0, pool -> nrows);
 
-	/* Find most-costly rows to delete that will achieve	*/
-	/* the target pool size.				*/
+	/* The discarded and stale rows always go. */
 	minrow = pool -> nrows;
-	nz = 0;
-	i = count - 1;
-	for (;;) {
+	for (i = maxsize - nstale; i < maxsize; i++) {
 		k = cnum [i];
-		nz += pool -> rows [k].len;
+		delflags [k] = TRUE;
 		if (k < minrow) {
 			minrow = k;
 		}
-		if (nz >= min_recover) break;
-		if (i EQ 0) break;
-		--i;
 	}
 
-	/* We are deleting this many non-zeros from the pool... */
-	pool -> num_nz -= nz;
+	if ((stale_nz < min_recover) AND (count > 0)) {
+		/* Not enough -- rank the remaining candidates by	*/
+		/* cost, and delete the most costly rows that will	*/
+		/* achieve the target pool size.			*/
+		sort_gc_candidates (cnum, cost, count);
+
+		nz = stale_nz;
+		i = count - 1;
+		for (;;) {
+			k = cnum [i];
+			delflags [k] = TRUE;
+			nz += pool -> rows [k].len;
+			if (k < minrow) {
+				minrow = k;
+			}
+			if (nz >= min_recover) break;
+			if (i EQ 0) break;
+			--i;
+		}
+	}
+
+	delete_pool_rows (pool, delflags, minrow);
+
+	free ((char *) delflags);
+	free ((char *) cost);
+	free ((char *) cnum);
+
+	print_pool_memory_usage (pool, params -> print_solve_trace);
+	gst_channel_printf (params -> print_solve_trace, "Leaving garbage_collect_pool\n");
+}
+
+/*
+ * This routine advances the generational aging of the pool by one slice
+ * of at most GC_SLICE_ROWS rows, resuming where the previous slice left
+ * off.  It is called between LP solves, right after the pool has been
+ * scanned for binding rows.  Young rows that are binding at a ripe old
+ * age are promoted to the old generation.  Young rows that are neither
+ * in the LP nor needed by any suspended node, and that have not been
+ * binding for a few iterations, are marked STALE so that the next
+ * collection can evict them without any ranking.  This spreads the
+ * bookkeeping of garbage collection evenly over the solve, rather than
+ * doing it all at once when the pool fills up.
+ */
+
+	static
+	void
+age_pool_slice (
+
+struct cpool *		pool,		/* IN - constraint pool */
+gst_param_ptr		params		/* IN - parameters */
+)
+{
+int			i;
+int			n;
+int			idle;
+struct rcon *		rcp;
+
+	n = params -> gc_slice_rows;
+	if (n > pool -> nrows - pool -> initrows) {
+		n = pool -> nrows - pool -> initrows;
+	}
+
+	i = pool -> gc_cursor;
+	for (; n > 0; n--, i++) {
+		if ((i < pool -> initrows) OR (i >= pool -> nrows)) {
+			/* Wrap around to the first non-initial row. */
+			i = pool -> initrows;
+		}
+		rcp = &(pool -> rows [i]);
+		if ((rcp -> flags & RCON_FLAG_OLD) NE 0) continue;
+
+		idle = pool -> iter - rcp -> biter;
+		if (idle EQ 0) {
+			/* Binding right now.  Promote if it is old	*/
+			/* enough to have proven itself.		*/
+			if (pool -> iter - rcp -> birth >= GC_PROMOTE_AGE) {
+				rcp -> flags |= RCON_FLAG_OLD;
+			}
+			continue;
+		}
+		if ((rcp -> flags & RCON_FLAG_STALE) NE 0) continue;
+		if (rcp -> lprow NE -1) continue;
+		if (rcp -> refc > 0) continue;
+		if (idle >= GC_STALE_IDLE) {
+			rcp -> flags |= RCON_FLAG_STALE;
+			pool -> stale_nz += rcp -> len;
+		}
+	}
+	pool -> gc_cursor = i;
+}
+
+/*
+ * Is it time to reclaim the STALE rows between LP solves?  Each such
+ * collection walks the entire pool, so we wait until the stale rows
+ * hold a fixed fraction of all pool non-zeros.  A collection leaves no
+ * stale rows, so this fraction must build up again before the next one:
+ * every pass over the pool is paid for by the space it recovers.  We
+ * also wait until the stale rows would fill the rest of the current
+ * coefficient block, since the pool need not grow before then.
+ */
+
+	static
+	bool
+stale_collection_due (
+
+struct cpool *		pool		/* IN - constraint pool */
+)
+{
+	if (pool -> stale_nz <= pool -> blocks -> nfree) {
+		return (FALSE);
+	}
+	return (pool -> stale_nz >= pool -> num_nz / GC_STALE_FRACTION);
+}
+
+/*
+ * This routine reclaims the space used by all STALE rows in the pool.
+ * No ranking of rows is needed, so this is cheap enough to be done
+ * between LP solves whenever the stale rows would otherwise cause the
+ * pool to grow another coefficient block.
+ */
+
+	static
+	void
+collect_stale_rows (
+
+struct cpool *		pool,		/* IN - constraint pool */
+gst_param_ptr		params		/* IN - parameters */
+)
+{
+int			i;
+int			minrow;
+struct rcon *		rcp;
+bool *			delflags;
+
+	FATAL_ERROR_IF (pool -> npend > 0);
+
+	gst_channel_printf (params -> print_solve_trace,
+		"Collecting %d stale non-zeros\n", pool -> stale_nz);
+
+	delflags = NEWA (pool -> nrows, bool);
+	memset (delflags, 0, pool -> nrows);
+
+	minrow = pool -> nrows;
+	for (i = pool -> initrows; i < pool -> nrows; i++) {
+		rcp = &(pool -> rows [i]);
+		if ((rcp -> flags & RCON_FLAG_STALE) EQ 0) continue;
+		FATAL_ERROR_IF ((rcp -> lprow NE -1) OR (rcp -> refc > 0));
+		delflags [i] = TRUE;
+		if (i < minrow) {
+			minrow = i;
+		}
+	}
+
+	delete_pool_rows (pool, delflags, minrow);
 
-	/* We want to delete constraints numbered cnum [i..count-1]. */
-	delflags = NEWA (pool -> nrows, bool);
-	memset (delflags, 0, pool -> nrows);
-	for (; i < count; i++) {
-		delflags [cnum [i]] = TRUE;
-	}
+	free ((char *) delflags);
+
+	print_pool_memory_usage (pool, params -> print_solve_trace);
+}
+
+/*
+ * This routine deletes the given set of rows from the pool, renumbering
+ * the remaining rows and compacting their coefficients.  No row below
+ * MINROW is being deleted.
+ */
+
+	static
+	void
+delete_pool_rows (
+
+struct cpool *		pool,		/* IN - constraint pool */
+bool *			delflags,	/* IN - rows to delete */
+int			minrow		/* IN - lowest row being deleted */
+)
+{
+int			i;
+int			j;
+int			k;
+struct rcon *		rcp;
+int *			renum;
+int *			ihookp;
+struct rblk *		blkp;
+struct rcoef *		p1;
+struct rcoef *		p2;
+struct rcoef *		p3;
+struct rblk *		tmp1;
+struct rblk *		tmp2;
 
 	/* Compute a map for renumbering the constraints that remain.	*/
+	/* Account for the non-zeros being deleted as we go.		*/
 	renum = NEWA (pool -> nrows, int);
 	j = 0;
 	for (i = 0; i < pool -> nrows; i++) {
 		if (delflags [i]) {
+			rcp = &(pool -> rows [i]);
+			pool -> num_nz -= rcp -> len;
+			if ((rcp -> flags & RCON_FLAG_STALE) NE 0) {
+				pool -> stale_nz -= rcp -> len;
+			}
 			renum [i] = -1;
 		}
 		else {
@@ -3201,6 +2036,9 @@ struct rblk *		tmp2;
 	}
 	pool -> nrows = j;
 
+	/* Restart the incremental aging from the front. */
+	pool -> gc_cursor = pool -> initrows;
+
 	/* Temporarily reverse the order of the coefficient blocks... */
 	blkp = reverse_rblks (pool -> blocks);
 	pool -> blocks = blkp;
@@ -3246,14 +2084,8 @@ struct rblk *		tmp2;
 	pool -> blocks = reverse_rblks (pool -> blocks);
 
 	free ((char *) renum);
-	free ((char *) delflags);
-	free ((char *) cost);
-	free ((char *) cnum);
-
-	print_pool_memory_usage (pool, params -> print_solve_trace);
-	gst_channel_printf (params -> print_solve_trace, "Leaving garbage_collect_pool\n");
 }
-
+
 /*
  * This routine sorts the candidate rows in order by cost (of retaining
  * them).
@@ -3324,8 +2156,6 @@ struct rblk *		tmp;
  * solver has to contend with at any one time.
  */
 
-#ifdef LPSOLVE
-
 	void
 _gst_delete_slack_rows_from_LP (
 
@@ -3338,7 +2168,6 @@ int			k;
 int			n;
 int			row;
 int			nrows;
-int *			dlist;
 int *			rowflags;
 LP_t *			lp;
 struct cpool *		pool;
@@ -3368,7 +2197,7 @@ struct bbnode *		nodep;
 
 	n = pool -> nlprows;
 
-	dlist	= NEWA (nrows, int);
+	rowflags = NEWA (n, int);
 
 	j = 0;
 	k = 0;
@@ -3376,134 +2205,19 @@ struct bbnode *		nodep;
 		row = pool -> lprows [i];
 		rcp = &(pool -> rows [row]);
 		FATAL_ERROR_IF (rcp -> lprow NE i);
+		rowflags [i] = 0;
 		if (slack [i] > FUZZ) {
-			/* This row is slack -- move to delete list... */
-			rcp -> lprow = -1;
-			dlist [k++] = i;
-		}
-		else if ((rcp -> flags) & RCON_FLAG_DISCARD) {
-			/* This row is to be discarded because it is	*/
-			/* shadowed by a new constraint...		*/
+			/* This row is slack -- mark it for deletion... */
 			rcp -> lprow = -1;
-			dlist [k++] = i;
-		}
-		else {
-			/* Slide constraint up to new position in LP... */
-			rcp -> lprow = j;
-			pool -> lprows [j++] = row;
-		}
-	}
-	pool -> nlprows = j;
-
-	/* Copy any pending constraints... */
-	for (i = 0; i < pool -> npend; i++) {
-		pool -> lprows [j++] = pool -> lprows [n + i];
-	}
-
-	if (k > 0) {
-		/* Time to actually delete the constraints.	*/
-
-		gst_channel_printf (bbip -> params -> print_solve_trace, "@D deleting %d slack rows\n", k);
-
-		rowflags = NEWA (n + 1, int);
-		for (i = 0; i <= n; i++) {
-			rowflags [i] = 0;
-		}
-		for (i = 0; i < k; i++) {
-			rowflags [1 + dlist [i]] = 1;
-		}
-		delete_row_set (lp, rowflags);
-
-		free ((char *) rowflags);
-
-		nodep -> delrow_z = nodep -> z;
-	}
-
-	free ((char *) dlist);
-}
-
-#endif
-
-/*
- * This routine deletes all rows from the LP that are currently slack.
- * Note that these constraints remain in the pool.  This is purely an
- * efficiency hack designed to limit the number of rows that the LP
- * solver has to contend with at any one time.
- */
-
-#ifdef CPLEX
-
-	void
-_gst_delete_slack_rows_from_LP (
-
-struct bbinfo *		bbip		/* IN - branch and bound info */
-)
-{
-int			i;
-int			j;
-int			k;
-int			n;
-int			row;
-int			nrows;
-int			slack_nz;
-int *			dlist;
-int *			rowflags;
-LP_t *			lp;
-struct cpool *		pool;
-double *		slack;
-struct rcon *		rcp;
-struct bbnode *		nodep;
-
-	lp	= bbip -> lp;
-	pool	= bbip -> cpool;
-	nodep	= bbip -> node;
-
-	if (nodep -> z <= nodep -> delrow_z) {
-		/* Cannot delete any rows until the objective value at	*/
-		/* this node strictly improves over the last time we	*/
-		/* deleted slack rows.					*/
-		return;
-	}
-
-	nrows	= GET_LP_NUM_ROWS (lp);
-
-	if (nrows NE pool -> nlprows) {
-		/* LP and constraint pool are out of sync... */
-		FATAL_ERROR;
-	}
-
-	slack = bbip -> slack;
-
-	n = pool -> nlprows;
-
-	k = 0;
-	slack_nz = 0;
-	for (i = 0; i < n; i++) {
-		if (slack [i] > FUZZ) {
+			rowflags [i] = 1;
 			++k;
-			j = pool -> lprows [i];
-			slack_nz += pool -> rows [j].len;
-		}
-	}
-
-	dlist	= NEWA (nrows, int);
-
-	j = 0;
-	k = 0;
-	for (i = 0; i < n; i++) {
-		row = pool -> lprows [i];
-		rcp = &(pool -> rows [row]);
-		FATAL_ERROR_IF (rcp -> lprow NE i);
-		if (slack [i] > FUZZ) {
-			/* This row is slack -- move to delete list... */
-			rcp -> lprow = -1;
-			dlist [k++] = i;
 		}
 		else if ((rcp -> flags) & RCON_FLAG_DISCARD) {
 			/* This row is to be discarded because it is	*/
 			/* shadowed by a new constraint...		*/
 			rcp -> lprow = -1;
-			dlist [k++] = i;
+			rowflags [i] = 1;
+			++k;
 		}
 		else {
 			/* Slide constraint up to new position in LP... */
@@ -3523,84 +2237,32 @@ struct bbnode *		nodep;
 
 		gst_channel_printf (bbip -> params -> print_solve_trace, "@D deleting %d slack rows\n", k);
 
-		rowflags = NEWA (n, int);
-		for (i = 0; i < n; i++) {
-			rowflags [i] = 0;
-		}
-		for (i = 0; i < k; i++) {
-			rowflags [dlist [i]] = 1;
-		}
-		if (_MYCPX_delsetrows (lp, rowflags) NE 0) {
-			FATAL_ERROR;
-		}
-		free ((char *) rowflags);
+		lp -> backend -> delete_rows (lp, rowflags);
 
 		nodep -> delrow_z = nodep -> z;
 	}
 
-	free ((char *) dlist);
+	free ((char *) rowflags);
 }
-
-#endif
 
 /*
- * Free up the LP tableaux for a CPLEX problem.
+ * Free up the LP tableaux, using the backend that built it.
  */
 
-#ifdef CPLEX
-
 	void
 _gst_destroy_initial_formulation (
 
 struct bbinfo *		bbip		/* IN - branch-and-bound info */
 )
 {
-LP_t *			lp;
-struct lpmem *		lpmem;
-
-	lp	= bbip -> lp;
-	lpmem	= bbip -> lpmem;
-
-	/* Free up CPLEX's memory... */
-	if (_MYCPX_freeprob (&lp) NE 0) {
-		FATAL_ERROR;
-	}
-
-	/* Free up our own memory... */
-	free ((char *) (lpmem -> objx));
-	free ((char *) (lpmem -> rhsx));
-	free ((char *) (lpmem -> senx));
-	free ((char *) (lpmem -> matbeg));
-	free ((char *) (lpmem -> matcnt));
-	free ((char *) (lpmem -> matind));
-	free ((char *) (lpmem -> matval));
-	free ((char *) (lpmem -> bdl));
-	free ((char *) (lpmem -> bdu));
-	memset ((char *) lpmem, 0, sizeof (*lpmem));
-
-	bbip -> lp = NULL;
-}
-
-#endif
-
-/*
- * Free up the LP tableaux for an LP_SOLVE problem.
- */
+LP_t *		lp;
 
-#ifdef LPSOLVE
-
-	void
-_gst_destroy_initial_formulation (
+	lp = bbip -> lp;
 
-struct bbinfo *		bbip		/* IN - branch-and-bound info */
-)
-{
-	delete_lp (bbip -> lp);
+	lp -> backend -> destroy (lp);
 
 	bbip -> lp = NULL;
 }
-
-#endif
 
 /*
  * This routine records the current state of the node's LP tableaux and
@@ -3661,15 +2323,9 @@ struct rcon *		rcp;
 	nodep -> rstat		= NEWA (n, int);
 	nodep -> cstat		= NEWA (nvars, int);
 
-#ifdef CPLEX
-	if (_MYCPX_getbase (lp, nodep -> cstat, nodep -> rstat) NE 0) {
-		FATAL_ERROR;
-	}
-#endif
-
-#ifdef LPSOLVE
-	get_current_basis (lp, nodep -> cstat, nodep -> rstat);
-#endif
+	lp -> backend -> get_basis (lp,
+				    nodep -> cstat,
+				    nodep -> rstat);
 
 	/* Now record the rows and bump the reference counts... */
 	j = 0;
@@ -3759,21 +2415,11 @@ int *			rowflags;
 	pool -> nlprows = 0;
 
 	/* Delete all rows from the LP tableaux... */
-	rowflags = NEWA (n + 1, int);
-	for (i = 0; i <= n; i++) {
+	rowflags = NEWA (n, int);
+	for (i = 0; i < n; i++) {
 		rowflags [i] = 1;
 	}
-
-#ifdef CPLEX
-	if (_MYCPX_delsetrows (lp, rowflags) NE 0) {
-		FATAL_ERROR;
-	}
-#endif
-
-#ifdef LPSOLVE
-	rowflags [0] = 0;	/* keep the objective row! */
-	delete_row_set (lp, rowflags);
-#endif
+	lp -> backend -> delete_rows (lp, rowflags);
 
 	free ((char *) rowflags);
 
@@ -3817,14 +2463,9 @@ int *			rowflags;
 
 	if ((nodep -> cstat NE NULL) AND (nodep -> rstat NE NULL)) {
 		/* We have a basis to restore... */
-#ifdef CPLEX
-		i = _MYCPX_copybase (lp, nodep -> cstat, nodep -> rstat);
-		FATAL_ERROR_IF (i NE 0);
-#endif
-
-#ifdef LPSOLVE
-		set_current_basis (lp, nodep -> cstat, nodep -> rstat);
-#endif
+		lp -> backend -> set_basis (lp,
+					    nodep -> cstat,
+					    nodep -> rstat);
 		free ((char *) (nodep -> rstat));
 		free ((char *) (nodep -> cstat));
 	}
@@ -3901,103 +2542,6 @@ struct rcon *		rcp_endp;
 	nodep -> cstat	 = NULL;
 }
 
-/*
- * This routine retrieves the current basis under lp_solve, which records
- * the basis differently than CPLEX.  We use the "cstat" array to hold
- * the column upper/lower bound flags of the non-basic columns, and in
- * "rstat" we indicate which column is the basic variable for that row
- * (including slack variable columns).
- */
-
-#ifdef LPSOLVE
-
-	static
-	void
-get_current_basis (
-
-LP_t *		lp,		/* IN - LP tableaux to get basis of */
-int *		cstat,		/* OUT - basis flags for each column */
-int *		rstat		/* OUT - basis flags for each row */
-)
-{
-int		i;
-int		j;
-
-	if (NOT (lp -> basis_valid)) {
-		/* Scribble out the default starting basis. */
-		for (i = 0; i < lp -> rows; i++) {
-			rstat [i] = i + 1;
-		}
-		for (i = 0; i < lp -> columns; i++) {
-			cstat [i] = 1;
-		}
-		return;
-	}
-
-	/* Set the row status flags... */
-	for (i = 0; i < lp -> rows; i++) {
-		rstat [i] = lp -> bas [i + 1];
-	}
-
-	/* Set the column status flags... */
-	j = 0;
-	for (i = 1; i <= lp -> sum; i++) {
-		if (lp -> basis [i]) continue;
-		cstat [j] = lp -> lower [i];
-		++j;
-	}
-}
-
-#endif
-
-/*
- * This routine sets the current basis under lp_solve, which records
- * the basis differently than CPLEX.  We use the "cstat" array to hold
- * the column upper/lower bound flags, and in "rstat" we indicate which
- * column is the basic variable for that row (including slack variable
- * columns).
- */
-
-#ifdef LPSOLVE
-
-	static
-	void
-set_current_basis (
-
-LP_t *		lp,		/* IN - LP tableaux to set basis of */
-int *		cstat,		/* IN - basis flags for each column */
-int *		rstat		/* IN - basis flags for each row */
-)
-{
-int		i;
-int		j;
-
-	for (i = 1; i <= lp -> sum; i++) {
-		lp -> basis [i] = 0;
-		lp -> lower [i] = 1;
-	}
-
-	/* Set the row status flags... */
-	for (i = 0; i < lp -> rows; i++) {
-		j = rstat [i];
-		lp -> bas [i + 1] = j;
-		lp -> basis [j] = 1;
-	}
-
-	/* Set the column status flags... */
-	j = 0;
-	for (i = 1; i <= lp -> sum; i++) {
-		if (lp -> basis [i]) continue;
-		lp -> lower [i] = cstat [j];
-		++j;
-	}
-
-	lp -> basis_valid = TRUE;
-	lp -> eta_valid = FALSE;
-}
-
-#endif
-
 /*
  * This routine prints debugging information about the amount of memory
  * currently being used by the constraint pool.
@@ -4283,13 +2827,8 @@ gst_channel_ptr		trace;
 
 	gst_channel_printf (trace, "Minimize\n");
 
-
-#ifdef CPLEX
 	C = NEWA (nedges, double);
-
-	if (_MYCPX_getobj (bbip -> lp, C, 0, nedges - 1) NE 0) {
-		FATAL_ERROR;
-	}
+	bbip -> lp -> backend -> get_obj (bbip -> lp, C, nedges);
 	for (i = 0; i < nedges; i++) {
 		coeff = C [i];
 		if (coeff EQ 0.0) continue;
@@ -4301,23 +2840,6 @@ gst_channel_ptr		trace;
 		gst_channel_printf (trace, "\t%c %f x%d\n", ch, coeff, i);
 	}
 	free ((char *) C);
-#endif
-
-#ifdef LPSOLVE
-	C = NEWA (nedges + 1, double);
-	get_row (bbip -> lp, 0, C);
-	for (i = 0; i < nedges; i++) {
-		coeff = C [i + 1];
-		if (coeff EQ 0.0) continue;
-		ch = '+';
-		if (coeff < 0.0) {
-			coeff = - coeff;
-			ch = '-';
-		}
-		gst_channel_printf (trace, "\t%c %f x%d\n", ch, coeff, i);
-	}
-	free ((char *) C);
-#endif
 
 	gst_channel_printf (trace, "\nSubject To\n");
 
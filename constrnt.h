@@ -41,7 +41,7 @@
 #define	CONSTRNT_H
 
 #include "bitmaskmacros.h"
-#include "lpsolver.h"
+#include "lpbackend.h"
 
 
 /*
@@ -58,6 +58,16 @@
 #define RC_OP_GE	2
 #define RC_VAR_BASE	3
 
+/*
+ * Weights of the budget mode (GEOSTEINER_BUDGET) objective.  Each FST
+ * costs its length plus BUDGET_BATTERY_WEIGHT times the battery values
+ * of its terminals, and each terminal left uncovered costs
+ * BUDGET_UNCOVERED_PENALTY.
+ */
+
+#define	BUDGET_BATTERY_WEIGHT		10000.0
+#define	BUDGET_UNCOVERED_PENALTY	1500000.0
+
 struct rcoef {
 	int		var;	/* variable (var>=0) or operator (var<0) */
 	int		val;	/* coefficient value */
@@ -76,11 +86,16 @@ struct rcon {
 	int		refc;	/* reference count: number of *suspended* */
 				/* nodes for which this constraint is */
 				/* binding */
+	int		birth;	/* iteration during which this constraint */
+				/* entered the pool */
 };
 
 /* flags */
 
 #define	RCON_FLAG_DISCARD	0x0001	/* Discard at next opportunity. */
+#define	RCON_FLAG_OLD		0x0002	/* Promoted to old generation. */
+#define	RCON_FLAG_STALE		0x0004	/* Young, and idle long enough */
+					/* to be evicted at next GC. */
 
 
 /*
@@ -128,6 +143,8 @@ struct cpool {
 	int		nvars;		/* Number of variables - LP columns */
 	int		hwmrow;		/* High water mark for LP rows */
 	int		hwmnz;		/* High water mark for LP non-zeros */
+	int		gc_cursor;	/* Next row to be aged incrementally */
+	int		stale_nz;	/* Non-zeros in rows marked STALE */
 	int		hash [CPOOL_HASH_SIZE];
 };
 
@@ -169,7 +186,6 @@ extern LP_t *	_gst_build_initial_formulation (
 					bitmap_t *		vert_mask,
 					bitmap_t *		edge_mask,
 					struct gst_hypergraph *	cip,
-					struct lpmem *		lpmem,
 					struct gst_param *	params);
 extern void	_gst_debug_print_constraint (
 					char *		  	msg1,
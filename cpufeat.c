@@ -0,0 +1,59 @@
+/***********************************************************************
+
+	File:	cpufeat.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Run-time checks for optional processor features.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "cpufeat.h"
+
+#include "gsttypes.h"
+#include "logic.h"
+
+
+/*
+ * Global Routines
+ */
+
+bool		_gst_have_avx2 (void);
+
+
+/*
+ * Local Variables
+ */
+
+#ifdef USE_AVX2_KERNELS
+static int	avx2_state = -1;	/* -1 = unknown, 0 = no, 1 = yes */
+#endif
+
+/*
+ * Does this processor support AVX2?  This is only checked once.  Two
+ * threads may both check at first, but they store the same answer.
+ */
+
+	bool
+_gst_have_avx2 (void)
+
+{
+#ifdef USE_AVX2_KERNELS
+	if (avx2_state < 0) {
+		__builtin_cpu_init ();
+		avx2_state = __builtin_cpu_supports ("avx2") ? 1 : 0;
+	}
+	return (avx2_state > 0);
+#else
+	return (FALSE);
+#endif
+}
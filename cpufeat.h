@@ -0,0 +1,39 @@
+/***********************************************************************
+
+	File:	cpufeat.h
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Run-time checks for optional processor features.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#ifndef	CPUFEAT_H
+#define	CPUFEAT_H
+
+#include "gsttypes.h"
+#include "logic.h"
+
+/*
+ * USE_AVX2_KERNELS is defined when the compiler can build AVX2 code
+ * for the target.  Such code must only be run if _gst_have_avx2 ()
+ * says the processor supports it.
+ */
+
+#if defined (__x86_64__) AND defined (__GNUC__)
+	#define USE_AVX2_KERNELS
+	#include <immintrin.h>
+#endif
+
+extern bool		_gst_have_avx2 (void);
+
+#endif
@@ -0,0 +1,249 @@
+/***********************************************************************
+
+	File:	ddouble.h
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Double-double arithmetic, used to settle geometric predicates
+	that the plain floating point filters cannot decide, before
+	resorting to GMP.  A double-double is an unevaluated sum
+	hi + lo of two doubles, giving about 106 bits of precision.
+	The error-free transformations used here are those of Dekker
+	and Knuth (see Shewchuk's "Adaptive Precision Floating-Point
+	Arithmetic and Fast Robust Geometric Predicates").  They
+	assume round-to-nearest double precision arithmetic without
+	extended precision or fused multiply-adds.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#ifndef DDOUBLE_H
+#define	DDOUBLE_H
+
+#include "logic.h"
+
+
+/*
+ * A double-double number.
+ */
+
+struct ddouble {
+	double		hi;	/* Leading part */
+	double		lo;	/* Trailing part, |lo| <= ulp(hi)/2 */
+};
+
+/* Dekker's splitter for doubles: 2**27 + 1. */
+
+#define DD_SPLITTER	134217729.0
+
+
+/*
+ * Exactly compute a + b, given that |a| >= |b|.
+ */
+
+	static
+	inline
+	struct ddouble
+dd_fast_two_sum (
+
+double		a,	/* IN - larger operand */
+double		b	/* IN - smaller operand */
+)
+{
+struct ddouble	r;
+
+	r.hi = a + b;
+	r.lo = b - (r.hi - a);
+	return (r);
+}
+
+
+/*
+ * Exactly compute a + b.
+ */
+
+	static
+	inline
+	struct ddouble
+dd_two_sum (
+
+double		a,	/* IN - first operand */
+double		b	/* IN - second operand */
+)
+{
+struct ddouble	r;
+double		bv;
+
+	r.hi = a + b;
+	bv = r.hi - a;
+	r.lo = (a - (r.hi - bv)) + (b - bv);
+	return (r);
+}
+
+
+/*
+ * Exactly compute a - b.
+ */
+
+	static
+	inline
+	struct ddouble
+dd_two_diff (
+
+double		a,	/* IN - first operand */
+double		b	/* IN - second operand */
+)
+{
+struct ddouble	r;
+double		bv;
+
+	r.hi = a - b;
+	bv = a - r.hi;
+	r.lo = (a - (r.hi + bv)) + (bv - b);
+	return (r);
+}
+
+
+/*
+ * Exactly compute a * b.
+ */
+
+	static
+	inline
+	struct ddouble
+dd_two_prod (
+
+double		a,	/* IN - first operand */
+double		b	/* IN - second operand */
+)
+{
+struct ddouble	r;
+double		c;
+double		ahi, alo, bhi, blo;
+
+	c = DD_SPLITTER * a;
+	ahi = c - (c - a);
+	alo = a - ahi;
+	c = DD_SPLITTER * b;
+	bhi = c - (c - b);
+	blo = b - bhi;
+
+	r.hi = a * b;
+	r.lo = ((ahi * bhi - r.hi) + ahi * blo + alo * bhi) + alo * blo;
+	return (r);
+}
+
+
+/*
+ * Compute a + b in double-double arithmetic.  The error is at most a
+ * small multiple of 2**(-106) * (|a| + |b|).
+ */
+
+	static
+	inline
+	struct ddouble
+dd_add (
+
+struct ddouble	a,	/* IN - first operand */
+struct ddouble	b	/* IN - second operand */
+)
+{
+struct ddouble	s;
+
+	s = dd_two_sum (a.hi, b.hi);
+	s.lo += a.lo + b.lo;
+	return (dd_fast_two_sum (s.hi, s.lo));
+}
+
+
+/*
+ * Compute a - b in double-double arithmetic.
+ */
+
+	static
+	inline
+	struct ddouble
+dd_sub (
+
+struct ddouble	a,	/* IN - first operand */
+struct ddouble	b	/* IN - second operand */
+)
+{
+struct ddouble	s;
+
+	s = dd_two_diff (a.hi, b.hi);
+	s.lo += a.lo - b.lo;
+	return (dd_fast_two_sum (s.hi, s.lo));
+}
+
+
+/*
+ * Compute a * b in double-double arithmetic.  The error is at most a
+ * small multiple of 2**(-106) * |a| * |b|.
+ */
+
+	static
+	inline
+	struct ddouble
+dd_mul (
+
+struct ddouble	a,	/* IN - first operand */
+struct ddouble	b	/* IN - second operand */
+)
+{
+struct ddouble	p;
+
+	p = dd_two_prod (a.hi, b.hi);
+	p.lo += a.hi * b.lo + a.lo * b.hi;
+	return (dd_fast_two_sum (p.hi, p.lo));
+}
+
+
+/*
+ * Return the exact sign of (a.hi + a.lo) - (b.hi + b.lo).  The
+ * difference is computed exactly as a 4 component non-overlapping
+ * expansion, whose sign is that of its largest non-zero component.
+ */
+
+	static
+	inline
+	int
+dd_diff_sign (
+
+struct ddouble	a,	/* IN - first operand */
+struct ddouble	b	/* IN - second operand */
+)
+{
+struct ddouble	t;
+struct ddouble	u;
+struct ddouble	v;
+struct ddouble	w;
+double		x;
+
+	/* (a.hi, a.lo) - b.lo  ==>  (u.hi, u.lo, t.lo) */
+	t = dd_two_diff (a.lo, b.lo);
+	u = dd_two_sum (a.hi, t.hi);
+
+	/* (u.hi, u.lo) - b.hi  ==>  (w.hi, w.lo, v.lo) */
+	v = dd_two_diff (u.lo, b.hi);
+	w = dd_two_sum (u.hi, v.hi);
+
+	x = w.hi;
+	if (x EQ 0.0) x = w.lo;
+	if (x EQ 0.0) x = v.lo;
+	if (x EQ 0.0) x = t.lo;
+
+	if (x > 0.0) return (1);
+	if (x < 0.0) return (-1);
+	return (0);
+}
+
+#endif
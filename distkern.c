@@ -0,0 +1,312 @@
+/***********************************************************************
+
+	File:	distkern.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Batched distance kernels for filtering candidate terminals.
+	The terminal coordinates are given as separate arrays of X
+	and Y coordinates, so that several terminals can be tested at
+	once.  On x86-64 processors supporting AVX2, four terminals
+	are tested per instruction; otherwise (or on other machines)
+	plain scalar code is used.  Both compute every squared
+	distance as dx*dx + dy*dy, without fused multiply-adds, so
+	they give identical results.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "distkern.h"
+
+#include "cpufeat.h"
+#include "gsttypes.h"
+#include "logic.h"
+#include "point.h"
+
+
+/*
+ * Global Routines
+ */
+
+int		_gst_near_both (const coord_t *,
+				const coord_t *,
+				int,
+				const struct point *,
+				const struct point *,
+				dist_t,
+				int *);
+int		_gst_within_dist (const coord_t *,
+				  const coord_t *,
+				  int,
+				  const struct point *,
+				  dist_t,
+				  int *);
+
+
+/*
+ * Local Routines
+ */
+
+static int		near_both_scalar (const coord_t *,
+					  const coord_t *,
+					  int,
+					  int,
+					  const struct point *,
+					  const struct point *,
+					  dist_t,
+					  int *);
+static int		within_dist_scalar (const coord_t *,
+					    const coord_t *,
+					    int,
+					    int,
+					    const struct point *,
+					    dist_t,
+					    int *);
+
+#ifdef USE_AVX2_KERNELS
+static int		near_both_avx2 (const coord_t *,
+					const coord_t *,
+					int,
+					const struct point *,
+					const struct point *,
+					dist_t,
+					int *);
+static int		within_dist_avx2 (const coord_t *,
+					  const coord_t *,
+					  int,
+					  const struct point *,
+					  dist_t,
+					  int *);
+#endif
+
+/*
+ * Find the points k (0 <= k < n) whose squared distance to both P and
+ * Q is less than dist2.  Their positions are stored in increasing
+ * order in out, and their number is returned.
+ */
+
+	int
+_gst_near_both (
+
+const coord_t *		xs,	/* IN - X coordinates of the points */
+const coord_t *		ys,	/* IN - Y coordinates of the points */
+int			n,	/* IN - number of points */
+const struct point *	P,	/* IN - first center */
+const struct point *	Q,	/* IN - second center */
+dist_t			dist2,	/* IN - squared radius about both centers */
+int *			out	/* OUT - positions of the points found */
+)
+{
+#ifdef USE_AVX2_KERNELS
+	if (_gst_have_avx2 ()) {
+		return (near_both_avx2 (xs, ys, n, P, Q, dist2, out));
+	}
+#endif
+	return (near_both_scalar (xs, ys, 0, n, P, Q, dist2, out));
+}
+
+/*
+ * Find the points k (0 <= k < n) whose squared distance to P is at
+ * most dist2.  Their positions are stored in increasing order in out,
+ * and their number is returned.
+ */
+
+	int
+_gst_within_dist (
+
+const coord_t *		xs,	/* IN - X coordinates of the points */
+const coord_t *		ys,	/* IN - Y coordinates of the points */
+int			n,	/* IN - number of points */
+const struct point *	P,	/* IN - center */
+dist_t			dist2,	/* IN - squared radius */
+int *			out	/* OUT - positions of the points found */
+)
+{
+#ifdef USE_AVX2_KERNELS
+	if (_gst_have_avx2 ()) {
+		return (within_dist_avx2 (xs, ys, n, P, dist2, out));
+	}
+#endif
+	return (within_dist_scalar (xs, ys, 0, n, P, dist2, out));
+}
+
+/*
+ * Scalar version of _gst_near_both, for points first through n-1.
+ */
+
+	static
+	int
+near_both_scalar (
+
+const coord_t *		xs,	/* IN - X coordinates of the points */
+const coord_t *		ys,	/* IN - Y coordinates of the points */
+int			first,	/* IN - first point to test */
+int			n,	/* IN - number of points */
+const struct point *	P,	/* IN - first center */
+const struct point *	Q,	/* IN - second center */
+dist_t			dist2,	/* IN - squared radius about both centers */
+int *			out	/* OUT - positions of the points found */
+)
+{
+int		k;
+int		count;
+dist_t		dx;
+dist_t		dy;
+
+	count = 0;
+	for (k = first; k < n; k++) {
+		dx = xs [k] - P -> x;
+		dy = ys [k] - P -> y;
+		if (dx*dx + dy*dy >= dist2) continue;
+		dx = xs [k] - Q -> x;
+		dy = ys [k] - Q -> y;
+		if (dx*dx + dy*dy >= dist2) continue;
+		out [count++] = k;
+	}
+
+	return (count);
+}
+
+/*
+ * Scalar version of _gst_within_dist, for points first through n-1.
+ */
+
+	static
+	int
+within_dist_scalar (
+
+const coord_t *		xs,	/* IN - X coordinates of the points */
+const coord_t *		ys,	/* IN - Y coordinates of the points */
+int			first,	/* IN - first point to test */
+int			n,	/* IN - number of points */
+const struct point *	P,	/* IN - center */
+dist_t			dist2,	/* IN - squared radius */
+int *			out	/* OUT - positions of the points found */
+)
+{
+int		k;
+int		count;
+dist_t		dx;
+dist_t		dy;
+
+	count = 0;
+	for (k = first; k < n; k++) {
+		dx = xs [k] - P -> x;
+		dy = ys [k] - P -> y;
+		if (dx*dx + dy*dy > dist2) continue;
+		out [count++] = k;
+	}
+
+	return (count);
+}
+
+#ifdef USE_AVX2_KERNELS
+
+/*
+ * AVX2 version of _gst_near_both.
+ */
+
+	__attribute__ ((target ("avx2")))
+	static
+	int
+near_both_avx2 (
+
+const coord_t *		xs,	/* IN - X coordinates of the points */
+const coord_t *		ys,	/* IN - Y coordinates of the points */
+int			n,	/* IN - number of points */
+const struct point *	P,	/* IN - first center */
+const struct point *	Q,	/* IN - second center */
+dist_t			dist2,	/* IN - squared radius about both centers */
+int *			out	/* OUT - positions of the points found */
+)
+{
+int		k;
+int		mask;
+int		count;
+__m256d		px, py, qx, qy, r2;
+__m256d		x, y, dx, dy, dp, dq;
+
+	px = _mm256_set1_pd (P -> x);
+	py = _mm256_set1_pd (P -> y);
+	qx = _mm256_set1_pd (Q -> x);
+	qy = _mm256_set1_pd (Q -> y);
+	r2 = _mm256_set1_pd (dist2);
+
+	count = 0;
+	for (k = 0; k + 4 <= n; k += 4) {
+		x  = _mm256_loadu_pd (&xs [k]);
+		y  = _mm256_loadu_pd (&ys [k]);
+		dx = _mm256_sub_pd (x, px);
+		dy = _mm256_sub_pd (y, py);
+		dp = _mm256_add_pd (_mm256_mul_pd (dx, dx),
+				    _mm256_mul_pd (dy, dy));
+		dx = _mm256_sub_pd (x, qx);
+		dy = _mm256_sub_pd (y, qy);
+		dq = _mm256_add_pd (_mm256_mul_pd (dx, dx),
+				    _mm256_mul_pd (dy, dy));
+		mask = _mm256_movemask_pd (
+			_mm256_and_pd (_mm256_cmp_pd (dp, r2, _CMP_LT_OQ),
+				       _mm256_cmp_pd (dq, r2, _CMP_LT_OQ)));
+		while (mask NE 0) {
+			out [count++] = k + __builtin_ctz (mask);
+			mask &= mask - 1;
+		}
+	}
+
+	return (count + near_both_scalar (xs, ys, k, n, P, Q, dist2,
+					  &out [count]));
+}
+
+/*
+ * AVX2 version of _gst_within_dist.
+ */
+
+	__attribute__ ((target ("avx2")))
+	static
+	int
+within_dist_avx2 (
+
+const coord_t *		xs,	/* IN - X coordinates of the points */
+const coord_t *		ys,	/* IN - Y coordinates of the points */
+int			n,	/* IN - number of points */
+const struct point *	P,	/* IN - center */
+dist_t			dist2,	/* IN - squared radius */
+int *			out	/* OUT - positions of the points found */
+)
+{
+int		k;
+int		mask;
+int		count;
+__m256d		px, py, r2;
+__m256d		dx, dy, dp;
+
+	px = _mm256_set1_pd (P -> x);
+	py = _mm256_set1_pd (P -> y);
+	r2 = _mm256_set1_pd (dist2);
+
+	count = 0;
+	for (k = 0; k + 4 <= n; k += 4) {
+		dx = _mm256_sub_pd (_mm256_loadu_pd (&xs [k]), px);
+		dy = _mm256_sub_pd (_mm256_loadu_pd (&ys [k]), py);
+		dp = _mm256_add_pd (_mm256_mul_pd (dx, dx),
+				    _mm256_mul_pd (dy, dy));
+		mask = _mm256_movemask_pd (_mm256_cmp_pd (dp, r2, _CMP_LE_OQ));
+		while (mask NE 0) {
+			out [count++] = k + __builtin_ctz (mask);
+			mask &= mask - 1;
+		}
+	}
+
+	return (count + within_dist_scalar (xs, ys, k, n, P, dist2,
+					    &out [count]));
+}
+
+#endif
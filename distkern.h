@@ -0,0 +1,41 @@
+/***********************************************************************
+
+	File:	distkern.h
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Batched distance kernels for filtering candidate terminals.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#ifndef DISTKERN_H
+#define	DISTKERN_H
+
+#include "geomtypes.h"
+
+struct point;
+
+extern int	_gst_near_both (const coord_t *		xs,
+				const coord_t *		ys,
+				int			n,
+				const struct point *	P,
+				const struct point *	Q,
+				dist_t			dist2,
+				int *			out);
+extern int	_gst_within_dist (const coord_t *	xs,
+				  const coord_t *	ys,
+				  int			n,
+				  const struct point *	P,
+				  dist_t		dist2,
+				  int *			out);
+
+#endif
@@ -35,6 +35,7 @@
 #include "dt.h"
 
 #include "config.h"
+#include "ddouble.h"
 #include "fatal.h"
 #include <float.h>
 #include "fstfuncs.h"
@@ -42,6 +43,7 @@
 #include "logic.h"
 #include <math.h>
 #include "memory.h"
+#include "parallel.h"
 #include "point.h"
 #include "sortfuncs.h"
 #include <stdlib.h>
@@ -71,6 +73,14 @@ void		_gst_delaunay_triangulation (
 				int *		numberoftriangles,
 				int **		trianglelist,
 				int **		neighborlist);
+void		_gst_parallel_delaunay_triangulation (
+				struct pset *	pts,
+				int		nthreads,
+				int *		numberofedges,
+				int **		edgelist,
+				int *		numberoftriangles,
+				int **		trianglelist,
+				int **		neighborlist);
 
 /*
  * Local Types
@@ -96,12 +106,50 @@ struct E {				/* A directed edge */
 #define INSTACK		0x04		/* Edge is on the stack */
 #define MARK		0x08		/* Edge has been traversed */
 
+/* Push edge e onto the local variable stack, unless already there. */
+
+#define CONDITIONAL_PUSH(e)					\
+	if (((e) -> flags & INSTACK) EQ 0) {			\
+		(e) -> snext = stack;				\
+		stack = (e);					\
+		(e) -> flags |= INSTACK;			\
+	}
+
+/* Relative error bound of the double-double predicate filters: 2**(-96). */
+
+#define DD_TOLERANCE	(1.0 / 79228162514264337593543950336.0)
+
+/* Minimum number of points in each strip triangulated in parallel. */
+
+#define	MIN_PART_SIZE	2048
+
 struct DTinfo {
 	struct pset *	pts;		/* The input point set */
 	int		num_edges;	/* Number of edges */
 	int		num_tri;	/* Number of triangles */
 	struct E *	edges;		/* Array of edge structures */
 	struct E **	vfirst;		/* First edge for each vertex */
+	bool		cocircular;	/* Circle test found 4 cocircular */
+					/* points */
+	bool		give_up;	/* Stop flipping if cocircular */
+};
+
+/*
+ * One vertical strip of the points, when triangulating in parallel.
+ * Each strip is triangulated separately, and then neighboring strips
+ * are merged pairwise.  A merged part retains the DTinfo of its left
+ * half.
+ */
+
+struct dt_part {
+	struct DTinfo	dt;		/* Triangulation of this part */
+	int *		order;		/* Points of the part, sorted by X */
+	int		n;		/* Number of points in the part */
+	int		nsweep;		/* Edges made by triangulating strip */
+	struct E *	seam;		/* Edges joining this part to the */
+	int		nseam;		/* part on its left */
+	struct dt_part *	rp;	/* Part to merge into this one */
+	bool		failed;		/* Degenerate case -- give up */
 };
 
 typedef struct E *	Eptr;
@@ -126,8 +174,18 @@ static bool	bends_right (struct pset * pts, int p1, int p2, int p3);
 static int	bend_primitive (struct pset * pts, int p1, int p2, int p3);
 static int	circle_test (struct pset * pts, int p1, int p2, int p3, int p4);
 static void	clean_up (struct DTinfo * dt);
+static int	compare_rotated (int i1, int i2, void * array);
 static void	delaunay_flip (struct DTinfo * dt);
+static void	flip_edges (struct DTinfo * dt, Eptr stack);
+static Eptr	hull_edge (struct DTinfo * dt, int p);
+static bool	in_wedge (struct pset * pts, int v, int a, int b, int q);
+static Eptr	make_edge_pair (Eptr * avail, int p1, int p2);
+static void	merge_parts (void * arg);
+static bool	parallel_triangulate (struct DTinfo * dt, int nthreads);
+static void	splice_after (Eptr e, Eptr a);
+static void	sweep (struct DTinfo * dt, int * order, int n);
 static void	triangulate (struct DTinfo * dt);
+static void	triangulate_part (void * arg);
 
 #ifdef HAVE_GMP
  static int	bend_primitive_gmp (struct pset * pts, int p1, int p2, int p3);
@@ -135,6 +193,7 @@ static void	triangulate (struct DTinfo * dt);
  static void	convert_into_gmp_fixed_point (struct point **	  dbl_pts,
 					      struct gmp_point ** gmp_pts,
 					      int		  n);
+ static bool	small_integer (struct ddouble x);
 #endif
 
 #if TEST_DRIVER
@@ -212,6 +271,30 @@ struct triangulateio	in, out, vorout;
 	}
 }
 
+/*
+ * "Triangle" is single-threaded, so the thread count is ignored.
+ */
+
+	void
+_gst_parallel_delaunay_triangulation (
+
+struct pset *	pts,			/* IN - point set to triangulate */
+int		nthreads,		/* IN - number of threads to use */
+int *		numberofedges,		/* OUT - number of edges in DT */
+int **		edgelist,		/* OUT - list of edge indices */
+int *		numberoftriangles, 	/* OUT - number of triangles in DT */
+int **		trianglelist,		/* OUT - list of triangle edges */
+int **		neighborlist		/* OUT - neighbouring triangles */
+)
+{
+	_gst_delaunay_triangulation (pts,
+				     numberofedges,
+				     edgelist,
+				     numberoftriangles,
+				     trianglelist,
+				     neighborlist);
+}
+
 #endif
 
 /*
@@ -260,6 +343,43 @@ int *		numberoftriangles, 	/* OUT - number of triangles in DT */
 int **		trianglelist,		/* OUT - list of triangle edges */
 int **		neighborlist		/* OUT - neighbouring triangles */
 )
+{
+	_gst_parallel_delaunay_triangulation (pts,
+					      1,
+					      numberofedges,
+					      edgelist,
+					      numberoftriangles,
+					      trianglelist,
+					      neighborlist);
+}
+
+/*
+ * Same as _gst_delaunay_triangulation, but using up to nthreads
+ * threads.  Large point sets are cut at X coordinates into vertical
+ * strips of nearly equal size, the strips are triangulated (and made
+ * Delaunay) in parallel, and then neighboring strips are merged
+ * pairwise (also in parallel) by triangulating the region between
+ * their convex hulls and flipping edges near the seam.
+ *
+ * The Delaunay triangulation is unique unless there are 4 cocircular
+ * points, so this gives the same edges as the sequential code.  When
+ * cocircular points are encountered (or some other degeneracy), we
+ * simply discard the parallel result and triangulate sequentially.
+ * The edges (and triangles) are not necessarily listed in the same
+ * order, however.
+ */
+
+	void
+_gst_parallel_delaunay_triangulation (
+
+struct pset *	pts,			/* IN - point set to triangulate */
+int		nthreads,		/* IN - number of threads to use */
+int *		numberofedges,		/* OUT - number of edges in DT */
+int **		edgelist,		/* OUT - list of edge indices */
+int *		numberoftriangles, 	/* OUT - number of triangles in DT */
+int **		trianglelist,		/* OUT - list of triangle edges */
+int **		neighborlist		/* OUT - neighbouring triangles */
+)
 {
 int		k;
 int		npts;
@@ -301,12 +421,14 @@ struct DTinfo	dtinfo;
 	memset (&dtinfo, 0, sizeof (dtinfo));
 	dtinfo.pts = pts;
 
-	triangulate (&dtinfo);
-	PLOT (&dtinfo, "Initial Triangulation");
+	if (NOT parallel_triangulate (&dtinfo, nthreads)) {
+		triangulate (&dtinfo);
+		PLOT (&dtinfo, "Initial Triangulation");
 
-	/* Now perform Delaunay flips until we are fully Delaunay. */
+		/* Now perform Delaunay flips until we are fully Delaunay. */
 
-	delaunay_flip (&dtinfo);
+		delaunay_flip (&dtinfo);
+	}
 	PLOT (&dtinfo, "Delaunay Triangulation");
 
 	nedges = dtinfo.num_edges;
@@ -407,16 +529,9 @@ struct DTinfo *		dt	/* IN/OUT - global Delaunay triang data */
 )
 {
 int		i;
-int		j;
 int		n;
-int		idx;
-int		p;
-int		prev_p;
 int		max_edges;
-int		ntri;
-Eptr		e1, e2, e3, e4, e5, e6;
 struct pset *	pts;
-struct E *	edges;
 struct E **	vfirst;
 int *		order;
 
@@ -428,10 +543,8 @@ int *		order;
 	max_edges	= 3 * n - 6;
 	max_edges	= 2 * max_edges;	/* edges are bi-directed */
 
-	edges  = NEWA (max_edges, struct E);
-	vfirst = NEWA (n, struct E *);
-
-	dt -> edges	= edges;
+	dt -> edges	= NEWA (max_edges, struct E);
+	vfirst		= NEWA (n, struct E *);
 	dt -> vfirst	= vfirst;
 
 	/* Initialize each vertex to be incident to an empty list of edges. */
@@ -442,6 +555,45 @@ int *		order;
 	/* Use a sweep-line algorithm to triangulate the point set. */
 	order = _gst_heapsort_x (pts);
 
+	sweep (dt, order, n);
+
+	free (order);
+}
+
+/*
+ * Triangulate the given N >= 3 points, which are in sorted order by X
+ * coordinate, with a sweep-line.  The edges are stored in dt -> edges,
+ * which must have room for 2 * (3 * N - 6) of them.  The vertices of
+ * these points must not have any edges yet.
+ */
+
+	static
+	void
+sweep (
+
+struct DTinfo *		dt,	/* IN/OUT - global Delaunay triang data */
+int *			order,	/* IN - the points, sorted by X */
+int			n	/* IN - number of points */
+)
+{
+int		i;
+int		j;
+int		idx;
+int		p;
+int		prev_p;
+int		max_edges;
+int		ntri;
+Eptr		e1, e2, e3, e4, e5, e6;
+struct pset *	pts;
+struct E *	edges;
+struct E **	vfirst;
+
+	pts	= dt -> pts;
+	edges	= dt -> edges;
+	vfirst	= dt -> vfirst;
+
+	max_edges = 2 * (3 * n - 6);
+
 	/* Find the first two points (skip any duplicates). */
 	i = order [0];
 	idx = 1;
@@ -558,8 +710,6 @@ int *		order;
 	dt -> num_edges = edges - dt -> edges;
 	dt -> num_tri	= ntri;
 
-	free (order);
-
 	/* Mark the edges of the exterior face.  The last edge added to	*/
 	/* the last vertex is one of the edges on this face.  Mark the	*/
 	/* opposing edges as being "on the exterior".			*/
@@ -586,21 +736,8 @@ struct DTinfo *		dt	/* IN/OUT - global Delaunay triang data */
 {
 int		i;
 int		nedges;
-int		p1, p2, p3, p4;
-Eptr		e1, e2, e3, e4, e5, e6, e7, e8;
+Eptr		e1;
 Eptr		stack;
-struct E **	vfirst;
-struct pset *	pts;
-
-#define CONDITIONAL_PUSH(e)					\
-	if (((e) -> flags & INSTACK) EQ 0) {			\
-		(e) -> snext = stack;				\
-		stack = (e);					\
-		(e) -> flags |= INSTACK;			\
-	}
-
-	pts	= dt -> pts;
-	vfirst	= dt -> vfirst;
 
 	nedges = dt -> num_edges;
 
@@ -615,6 +752,32 @@ struct pset *	pts;
 		e1 -> flags |= INSTACK;
 	}
 
+	flip_edges (dt, stack);
+}
+
+/*
+ * Flip the edges on the given stack (and any others that this makes
+ * necessary) until they are all Delaunay.  Every edge that might not
+ * be Delaunay must be on the stack (with the INSTACK flag set).
+ */
+
+	static
+	void
+flip_edges (
+
+struct DTinfo *		dt,	/* IN/OUT - global Delaunay triang data */
+Eptr			stack	/* IN - edges to check */
+)
+{
+int		i;
+int		p1, p2, p3, p4;
+Eptr		e1, e2, e3, e4, e5, e6, e7, e8;
+struct E **	vfirst;
+struct pset *	pts;
+
+	pts	= dt -> pts;
+	vfirst	= dt -> vfirst;
+
 	while (stack NE NULL) {
 		e1 = stack;
 		stack = stack -> snext;
@@ -639,6 +802,10 @@ struct pset *	pts;
 
 		i = circle_test (pts, p1, p2, p3, p4);
 
+		if (i EQ 0) {
+			dt -> cocircular = TRUE;
+			if (dt -> give_up) break;
+		}
 		if (i <= 0) {
 			/* This diagonal fine -- don't flip it. */
 			continue;
@@ -692,10 +859,614 @@ struct pset *	pts;
 		e6 -> vnext	= e2;
 		e7 -> vprev	= e2;
 	}
-
-#undef CONDITIONAL_PUSH
 }
 
+/*
+ * Try to triangulate the points in parallel, as described above.
+ * Return FALSE (leaving dt unchanged) if the points are too few or
+ * some degeneracy prevents this.
+ */
+
+	static
+	bool
+parallel_triangulate (
+
+struct DTinfo *		dt,		/* IN/OUT - global Delaunay triang data */
+int			nthreads	/* IN - number of threads to use */
+)
+{
+int			i;
+int			j;
+int			k;
+int			n;
+int			nparts;
+int			nargs;
+int			step;
+int			max_edges;
+int *			order;
+bool			ok;
+Eptr			e1, e2, e3;
+Eptr			edges;
+struct E **		vfirst;
+struct pset *		pts;
+struct dt_part *	parts;
+struct dt_part *	pp;
+void **			args;
+
+	pts = dt -> pts;
+	n   = pts -> n;
+
+#ifndef HAVE_PTHREAD
+	nthreads = 1;
+#endif
+
+	nparts = n / MIN_PART_SIZE;
+	if (nparts > nthreads) {
+		nparts = nthreads;
+	}
+	if (nparts < 2) {
+		return (FALSE);
+	}
+
+	order = _gst_heapsort_x (pts);
+
+	parts = NEWA (nparts, struct dt_part);
+	args  = NEWA (nparts, void *);
+	memset (parts, 0, nparts * sizeof (parts [0]));
+
+	/* Cut the points into strips of nearly equal size.  Cuts are	*/
+	/* only made between distinct X coordinates, so that the	*/
+	/* strips are strictly separated.				*/
+	ok = TRUE;
+	max_edges = 0;
+	i = 0;
+	for (j = 0; j < nparts; j++) {
+		k = i + (n - i) / (nparts - j);
+		while ((k < n) AND
+		       (pts -> a [order [k - 1]].x EQ pts -> a [order [k]].x)) {
+			++k;
+		}
+		if (k - i < 3) {
+			ok = FALSE;
+			break;
+		}
+		pp = &parts [j];
+		pp -> dt.pts	= pts;
+		pp -> dt.give_up = TRUE;
+		pp -> order	= &order [i];
+		pp -> n		= k - i;
+		max_edges += 2 * (3 * pp -> n - 6);
+		i = k;
+	}
+	if (NOT ok) {
+		free (args);
+		free (parts);
+		free (order);
+		return (FALSE);
+	}
+
+	edges  = NEWA (max_edges, struct E);
+	vfirst = NEWA (n, struct E *);
+	for (i = 0; i < n; i++) {
+		vfirst [i] = NULL;
+	}
+
+	e1 = edges;
+	for (j = 0; j < nparts; j++) {
+		pp = &parts [j];
+		pp -> dt.edges	= e1;
+		pp -> dt.vfirst	= vfirst;
+		e1 += 2 * (3 * pp -> n - 6);
+		args [j] = pp;
+	}
+
+	_gst_run_parallel (nparts, triangulate_part, args);
+
+	for (j = 0; j < nparts; j++) {
+		if (parts [j].failed OR parts [j].dt.cocircular) {
+			ok = FALSE;
+		}
+	}
+
+	/* Merge neighboring parts pairwise, until only one is left. */
+	for (step = 1; ok AND (step < nparts); step *= 2) {
+		nargs = 0;
+		for (j = 0; j + step < nparts; j += 2 * step) {
+			parts [j].rp = &parts [j + step];
+			args [nargs++] = &parts [j];
+		}
+
+		_gst_run_parallel (nargs, merge_parts, args);
+
+		for (j = 0; j < nargs; j++) {
+			pp = (struct dt_part *) args [j];
+			if (pp -> failed OR pp -> dt.cocircular) {
+				ok = FALSE;
+			}
+		}
+	}
+
+	if (ok) {
+		/* Number the edges of all parts consecutively.  Each	*/
+		/* edge is still followed by its reverse edge.		*/
+		k = 0;
+		for (j = 0; j < nparts; j++) {
+			pp = &parts [j];
+			e1 = pp -> dt.edges;
+			for (i = 0; i < pp -> nsweep; i++, e1++) {
+				e1 -> face = k++;
+			}
+			e1 = pp -> seam;
+			for (i = 0; i < pp -> nseam; i++, e1++) {
+				e1 -> face = k++;
+			}
+		}
+		FATAL_ERROR_IF (k NE parts [0].dt.num_edges);
+
+		/* Copy them into a single array. */
+		dt -> edges	= NEWA (k, struct E);
+		dt -> vfirst	= vfirst;
+		dt -> num_edges	= k;
+		dt -> num_tri	= parts [0].dt.num_tri;
+
+		e3 = dt -> edges;
+		for (j = 0; j < nparts; j++) {
+			pp = &parts [j];
+			for (k = 0; k < 2; k++) {
+				if (k EQ 0) {
+					e1 = pp -> dt.edges;
+					i  = pp -> nsweep;
+				}
+				else {
+					e1 = pp -> seam;
+					i  = pp -> nseam;
+				}
+				for (; i > 0; i--, e1++, e3++) {
+					*e3 = *e1;
+					e2 = dt -> edges;
+					e3 -> vnext = &e2 [e1 -> vnext -> face];
+					e3 -> vprev = &e2 [e1 -> vprev -> face];
+					e3 -> rev   = &e2 [e1 -> rev -> face];
+				}
+			}
+		}
+		for (i = 0; i < n; i++) {
+			if (vfirst [i] NE NULL) {
+				vfirst [i] = &(dt -> edges [vfirst [i] -> face]);
+			}
+		}
+	}
+	else {
+		free (vfirst);
+	}
+
+	for (j = 0; j < nparts; j++) {
+		if (parts [j].seam NE NULL) {
+			free (parts [j].seam);
+		}
+	}
+	free (edges);
+	free (args);
+	free (parts);
+	free (order);
+
+	return (ok);
+}
+
+/*
+ * Triangulate one strip of the points, and make it Delaunay.
+ */
+
+	static
+	void
+triangulate_part (
+
+void *		arg		/* IN/OUT - the part to triangulate */
+)
+{
+int			i;
+int *			perm;
+int *			yorder;
+struct dt_part *	pp;
+struct point *		p;
+struct point		minp;
+struct point		maxp;
+
+	pp = (struct dt_part *) arg;
+
+	minp.x = INF_DISTANCE;	maxp.x = -INF_DISTANCE;
+	minp.y = INF_DISTANCE;	maxp.y = -INF_DISTANCE;
+	for (i = 0; i < pp -> n; i++) {
+		p = &(pp -> dt.pts -> a [pp -> order [i]]);
+		if (p -> x < minp.x) minp.x = p -> x;
+		if (p -> x > maxp.x) maxp.x = p -> x;
+		if (p -> y < minp.y) minp.y = p -> y;
+		if (p -> y > maxp.y) maxp.y = p -> y;
+	}
+
+	if (maxp.y - minp.y <= maxp.x - minp.x) {
+		sweep (&(pp -> dt), pp -> order, pp -> n);
+	}
+	else {
+		/* The strip is tall and narrow, which is bad for a	*/
+		/* sweep in X.  Rotate it 90 degrees clockwise (which	*/
+		/* changes no bends) and sweep in that direction	*/
+		/* instead: i.e., sort by Y ascending, then by X	*/
+		/* descending.  Duplicate points still sort by index,	*/
+		/* so we skip the same ones as the sequential sweep.	*/
+		perm	= _gst_heapsort (pp -> n, pp, compare_rotated);
+		yorder	= NEWA (pp -> n, int);
+		for (i = 0; i < pp -> n; i++) {
+			yorder [i] = pp -> order [perm [i]];
+		}
+		free (perm);
+
+		sweep (&(pp -> dt), yorder, pp -> n);
+
+		free (yorder);
+	}
+	pp -> nsweep = pp -> dt.num_edges;
+
+	if (pp -> dt.num_tri EQ 0) {
+		/* All points of the strip are collinear. */
+		pp -> failed = TRUE;
+		return;
+	}
+
+	delaunay_flip (&(pp -> dt));
+}
+
+/*
+ * Compare two points of a part by Y coordinate, then by decreasing X
+ * coordinate, then by index.
+ */
+
+	static
+	int
+compare_rotated (
+
+int		i1,	/* IN - first index */
+int		i2,	/* IN - second index */
+void *		array	/* IN - the part being sorted */
+)
+{
+int			p1, p2;
+struct dt_part *	pp;
+struct point *		a;
+
+	pp = (struct dt_part *) array;
+	p1 = pp -> order [i1];
+	p2 = pp -> order [i2];
+	a  = pp -> dt.pts -> a;
+
+	if (a [p1].y < a [p2].y) return (-1);
+	if (a [p1].y > a [p2].y) return (1);
+	if (a [p1].x > a [p2].x) return (-1);
+	if (a [p1].x < a [p2].x) return (1);
+	return ((p1 < p2) ? -1 : 1);
+}
+
+/*
+ * Merge the Delaunay triangulation of part pp -> rp into that of part
+ * pp, which lies entirely to its left.  We find the lower and upper
+ * common tangents of their convex hulls, triangulate the region
+ * between the hulls by "zipping" up from the lower tangent to the
+ * upper one, and then flip edges until all are Delaunay again.
+ */
+
+	static
+	void
+merge_parts (
+
+void *		arg		/* IN/OUT - the left part */
+)
+{
+int			i;
+int			k;
+int			p;
+int			l, r;
+int			l0, r0;
+int			lb, rb;
+int			lt, rt;
+int			nzip;
+int			ntri;
+bool			okL, okR;
+Eptr			e, el, er, el0, er0, elb, erb;
+Eptr			A, B, first;
+Eptr			avail;
+Eptr			stack;
+struct dt_part *	lp;
+struct dt_part *	rp;
+struct DTinfo *		dt;
+struct pset *		pts;
+
+	lp	= (struct dt_part *) arg;
+	rp	= lp -> rp;
+	dt	= &(lp -> dt);
+	pts	= dt -> pts;
+
+	/* Start with the rightmost point of the left part (skipping	*/
+	/* any duplicates) and the leftmost point of the right part.	*/
+	/* Both are on their respective hulls.				*/
+	k = lp -> n - 1;
+	while (dt -> vfirst [lp -> order [k]] EQ NULL) {
+		--k;
+	}
+	l0  = lp -> order [k];
+	r0  = rp -> order [0];
+	el0 = hull_edge (dt, l0);
+	er0 = hull_edge (dt, r0);
+
+	/* Walk down both hulls to the lower common tangent.  The hull	*/
+	/* edge leaving each point goes clockwise around its hull.	*/
+	l = l0;	el = el0;
+	r = r0;	er = er0;
+	for (;;) {
+		p = el -> dst;
+		i = bend_primitive (pts, l, r, p);
+		if ((i < 0) OR
+		    ((i EQ 0) AND (pts -> a [p].x > pts -> a [l].x))) {
+			l = p;
+			el = el -> rev -> vprev;
+			continue;
+		}
+		p = er -> vnext -> dst;
+		i = bend_primitive (pts, l, r, p);
+		if ((i < 0) OR
+		    ((i EQ 0) AND (pts -> a [p].x < pts -> a [r].x))) {
+			r = p;
+			er = er -> vnext -> rev;
+			continue;
+		}
+		break;
+	}
+	lb = l;	elb = el;
+	rb = r;	erb = er;
+
+	/* Walk up both hulls to the upper common tangent. */
+	l = l0;	el = el0;
+	r = r0;	er = er0;
+	for (;;) {
+		p = el -> vnext -> dst;
+		i = bend_primitive (pts, l, r, p);
+		if ((i > 0) OR
+		    ((i EQ 0) AND (pts -> a [p].x > pts -> a [l].x))) {
+			l = p;
+			el = el -> vnext -> rev;
+			continue;
+		}
+		p = er -> dst;
+		i = bend_primitive (pts, l, r, p);
+		if ((i > 0) OR
+		    ((i EQ 0) AND (pts -> a [p].x < pts -> a [r].x))) {
+			r = p;
+			er = er -> rev -> vprev;
+			continue;
+		}
+		break;
+	}
+	lt = l;
+	rt = r;
+
+	/* Count the hull points facing each other between the two	*/
+	/* tangents.  Each of them adds one edge.			*/
+	nzip = 0;
+	e = elb;
+	for (k = 0; e -> src NE lt; k++) {
+		if (k >= lp -> n) {
+			lp -> failed = TRUE;
+			return;
+		}
+		e = e -> vnext -> rev;
+		++nzip;
+	}
+	e = erb;
+	for (k = 0; e -> src NE rt; k++) {
+		if (k >= rp -> n) {
+			lp -> failed = TRUE;
+			return;
+		}
+		e = e -> rev -> vprev;
+		++nzip;
+	}
+	if (nzip EQ 0) {
+		lp -> failed = TRUE;
+		return;
+	}
+
+	avail = NEWA (2 * (nzip + 1), struct E);
+	rp -> seam = avail;
+
+	/* The lower tangent becomes part of the exterior. */
+	B = make_edge_pair (&avail, lb, rb);
+	splice_after (B, elb);
+	splice_after (B -> rev, erb);
+	B -> flags		= ONX;
+	B -> rev -> flags	= XF | ONX;
+	first = B;
+
+	/* Zip up the region between the hulls.  The current base edge	*/
+	/* B goes from l to r, and the region yet to be triangulated is	*/
+	/* on its left.  Advance on whichever side gives a proper	*/
+	/* triangle, preferring the one that is locally Delaunay.  The	*/
+	/* new edge is proper if it leaves the base edge into this	*/
+	/* region: since it then lies outside both convex hulls and	*/
+	/* below the upper tangent, it cannot cross anything.		*/
+	stack = NULL;
+	l = lb;
+	r = rb;
+	ntri = 0;
+	while ((l NE lt) OR (r NE rt)) {
+		el = B -> vnext;		/* l to next point up left hull */
+		er = B -> rev -> vprev;		/* r to next point up right hull */
+		okL = (l NE lt) AND
+		      bends_left (pts, l, r, el -> dst) AND
+		      in_wedge (pts, r, er -> dst, l, el -> dst);
+		okR = (r NE rt) AND
+		      bends_left (pts, l, r, er -> dst) AND
+		      in_wedge (pts, l, r, el -> dst, er -> dst);
+		if (okL AND okR AND
+		    (circle_test (pts, l, r, el -> dst, er -> dst) > 0)) {
+			okL = FALSE;
+		}
+
+		if (okL) {
+			p = el -> dst;
+			A = make_edge_pair (&avail, p, r);
+			splice_after (A, el -> rev);
+			splice_after (A -> rev, B -> rev -> vprev);
+			e = el;
+			l = p;
+		}
+		else if (okR) {
+			p = er -> dst;
+			A = make_edge_pair (&avail, l, p);
+			splice_after (A, B);
+			splice_after (A -> rev, er -> rev -> vprev);
+			e = er;
+			r = p;
+		}
+		else {
+			lp -> failed = TRUE;
+			return;
+		}
+
+		/* The hull edge just passed is now interior. */
+		e -> flags		= 0;
+		e -> rev -> flags	= 0;
+		CONDITIONAL_PUSH (e);
+		if (B NE first) {
+			CONDITIONAL_PUSH (B);
+		}
+		B = A;
+		++ntri;
+	}
+
+	/* The upper tangent becomes part of the exterior. */
+	B -> flags		= XF | ONX;
+	B -> rev -> flags	= ONX;
+
+	rp -> nseam = avail - rp -> seam;
+	FATAL_ERROR_IF (rp -> nseam NE 2 * (nzip + 1));
+
+	dt -> num_edges	+= rp -> dt.num_edges + rp -> nseam;
+	dt -> num_tri	+= rp -> dt.num_tri + ntri;
+	if (rp -> dt.cocircular) {
+		dt -> cocircular = TRUE;
+	}
+	lp -> n += rp -> n;
+
+	flip_edges (dt, stack);
+}
+
+/*
+ * Return the edge leaving hull point p along the exterior face.
+ */
+
+	static
+	Eptr
+hull_edge (
+
+struct DTinfo *		dt,	/* IN - global Delaunay triang data */
+int			p	/* IN - a point on the hull */
+)
+{
+Eptr		e;
+
+	e = dt -> vfirst [p];
+	do {
+		if ((e -> flags & XF) NE 0) {
+			return (e);
+		}
+		e = e -> vnext;
+	} while (e NE dt -> vfirst [p]);
+
+	FATAL_ERROR;
+
+	return (NULL);
+}
+
+/*
+ * Return TRUE if-and-only-if the ray from point v through point q lies
+ * strictly inside the wedge swept counter-clockwise from the ray v->a
+ * to the ray v->b.
+ */
+
+	static
+	bool
+in_wedge (
+
+struct pset *		pts,	/* IN - the point set */
+int			v,	/* IN - index of the apex */
+int			a,	/* IN - index of point on first ray */
+int			b,	/* IN - index of point on second ray */
+int			q	/* IN - index of point to test */
+)
+{
+	if (bends_left (pts, v, a, b)) {
+		/* Wedge is less than 180 degrees. */
+		return (bends_left (pts, v, a, q) AND
+			bends_right (pts, v, b, q));
+	}
+	return (bends_left (pts, v, a, q) OR
+		bends_right (pts, v, b, q));
+}
+
+/*
+ * Allocate a new edge from p1 to p2 (and its reverse) from the given
+ * array.  Neither is threaded into any vertex list yet.
+ */
+
+	static
+	Eptr
+make_edge_pair (
+
+Eptr *		avail,	/* IN/OUT - next free edge */
+int		p1,	/* IN - source point */
+int		p2	/* IN - destination point */
+)
+{
+Eptr		e1, e2;
+
+	e1 = (*avail)++;
+	e2 = (*avail)++;
+
+	e1 -> src	= p1;
+	e1 -> dst	= p2;
+	e1 -> vnext	= e1;
+	e1 -> vprev	= e1;
+	e1 -> rev	= e2;
+	e1 -> flags	= 0;
+
+	e2 -> src	= p2;
+	e2 -> dst	= p1;
+	e2 -> vnext	= e2;
+	e2 -> vprev	= e2;
+	e2 -> rev	= e1;
+	e2 -> flags	= 0;
+
+	return (e1);
+}
+
+/*
+ * Insert edge e into the list of edges around its source point, just
+ * after (counter-clockwise from) edge a.
+ */
+
+	static
+	void
+splice_after (
+
+Eptr		e,	/* IN - edge to insert */
+Eptr		a	/* IN - edge to insert it after */
+)
+{
+	e -> vprev		= a;
+	e -> vnext		= a -> vnext;
+	a -> vnext -> vprev	= e;
+	a -> vnext		= e;
+}
+
 /*
  * Free up all of the memory we might have allocated.
  */
@@ -835,6 +1606,32 @@ double			prod1, prod2, Z;
 
 		if (Z >  bound) return (+1);
 		if (Z < -bound) return (-1);
+
+		/* Too close to call.  Redo it in double-double arithmetic.	*/
+		/* If the coordinate differences are exact, the products	*/
+		/* are exact double-doubles, and the sign of their		*/
+		/* difference is exact.  Otherwise we apply an error bound.	*/
+		{ struct ddouble dax, day, dbx, dby, dprod1, dprod2, dZ;
+
+			dax = dd_two_diff (pp2 -> x, pp1 -> x);
+			day = dd_two_diff (pp2 -> y, pp1 -> y);
+			dbx = dd_two_diff (pp3 -> x, pp1 -> x);
+			dby = dd_two_diff (pp3 -> y, pp1 -> y);
+
+			if ((dax.lo EQ 0.0) AND (day.lo EQ 0.0) AND
+			    (dbx.lo EQ 0.0) AND (dby.lo EQ 0.0)) {
+				dprod1 = dd_two_prod (ax, by);
+				dprod2 = dd_two_prod (ay, bx);
+				return (dd_diff_sign (dprod1, dprod2));
+			}
+
+			dZ = dd_sub (dd_mul (dax, dby), dd_mul (day, dbx));
+
+			bound = norm * DD_TOLERANCE;
+
+			if (dZ.hi >  bound) return (+1);
+			if (dZ.hi < -bound) return (-1);
+		}
 	}
 	result = bend_primitive_gmp (pts, p1, p2, p3);
 #endif
@@ -1086,7 +1883,51 @@ double			Z;
 		if (Z >  bound) return (+1);
 		if (Z < -bound) return (-1);
 
-		/* Both floating point filters failed -- use GMP to get it right. */
+		/* Both floating point filters failed.  Redo it in		*/
+		/* double-double arithmetic, in which the errors are smaller	*/
+		/* by a factor of about 2**53.  The same Zmax serves as the	*/
+		/* magnitude of the computation.  If the coordinate		*/
+		/* differences are integers of at most 24 bits, every value	*/
+		/* computed below is an integer of at most 104 bits, and the	*/
+		/* double-double result is exact.				*/
+
+		{ struct ddouble dbx, dby, dcx, dcy, ddx, ddy;
+		  struct ddouble dbmag2, dcmag2, ddmag2, dDxC, dBxD, dCxB, dZ;
+
+			dbx = dd_two_diff (pp2 -> x, pp1 -> x);
+			dby = dd_two_diff (pp2 -> y, pp1 -> y);
+			dcx = dd_two_diff (pp3 -> x, pp1 -> x);
+			dcy = dd_two_diff (pp3 -> y, pp1 -> y);
+			ddx = dd_two_diff (pp4 -> x, pp1 -> x);
+			ddy = dd_two_diff (pp4 -> y, pp1 -> y);
+
+			dbmag2 = dd_add (dd_mul (dbx, dbx), dd_mul (dby, dby));
+			dcmag2 = dd_add (dd_mul (dcx, dcx), dd_mul (dcy, dcy));
+			ddmag2 = dd_add (dd_mul (ddx, ddx), dd_mul (ddy, ddy));
+
+			dDxC = dd_sub (dd_mul (ddx, dcy), dd_mul (ddy, dcx));
+			dBxD = dd_sub (dd_mul (dbx, ddy), dd_mul (dby, ddx));
+			dCxB = dd_sub (dd_mul (dcx, dby), dd_mul (dcy, dbx));
+
+			dZ = dd_add (dd_add (dd_mul (dbmag2, dDxC),
+					     dd_mul (dcmag2, dBxD)),
+				     dd_mul (ddmag2, dCxB));
+
+			if (small_integer (dbx) AND small_integer (dby) AND
+			    small_integer (dcx) AND small_integer (dcy) AND
+			    small_integer (ddx) AND small_integer (ddy)) {
+				if (dZ.hi > 0.0) return (+1);
+				if (dZ.hi < 0.0) return (-1);
+				return (0);
+			}
+
+			bound = Zmax * DD_TOLERANCE;
+
+			if (dZ.hi >  bound) return (+1);
+			if (dZ.hi < -bound) return (-1);
+		}
+
+		/* All floating point filters failed -- use GMP to get it right. */
 
 		result = circle_test_gmp (pts, p1, p2, p3, p4);
 
@@ -1101,6 +1942,26 @@ double			Z;
 #endif
 }
 
+/*
+ * Is the given double-double an integer of magnitude at most 2**24?
+ */
+
+#ifdef HAVE_GMP
+
+	static
+	bool
+small_integer (
+
+struct ddouble		x	/* IN - the number to check */
+)
+{
+	if (x.lo NE 0.0) return (FALSE);
+	if (fabs (x.hi) > 16777216.0) return (FALSE);
+	return (floor (x.hi) EQ x.hi);
+}
+
+#endif
+
 /*
  * Exact "circle test primitive" using GMP arithmetic.
  */
@@ -35,5 +35,13 @@ extern void	_gst_delaunay_triangulation (
 				int *		numberoftriangles,
 				int **		trianglelist,
 				int **		neighborlist);
+extern void	_gst_parallel_delaunay_triangulation (
+				struct pset *	pts,
+				int		nthreads,
+				int *		numberofedges,
+				int **		edgelist,
+				int *		numberoftriangles,
+				int **		trianglelist,
+				int **		neighborlist);
 
 #endif
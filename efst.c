@@ -65,6 +65,7 @@
 #include "bsd.h"
 #include "config.h"
 #include "cputime.h"
+#include "distkern.h"
 #include "efuncs.h"
 #include "egmp.h"
 #include "emst.h"
@@ -73,9 +74,11 @@
 #include "fstfuncs.h"
 #include "geosteiner.h"
 #include "greedy.h"
+#include <limits.h>
 #include "logic.h"
 #include <math.h>
 #include "memory.h"
+#include "parallel.h"
 #include "parmblk.h"
 #include "prepostlude.h"
 #include "sll.h"
@@ -92,12 +95,102 @@ struct gst_hypergraph *	gst_generate_efsts (int,
 					    double *,
 					    struct gst_param *,
 			       int *);
+struct gst_hypergraph *	gst_generate_efsts_streamed (
+					int,
+					double *,
+					struct gst_param *,
+					gst_fst_callback_func_t *,
+					void *,
+					int *);
+struct gst_hypergraph *	_gst_generate_efsts (int,
+					     double *,
+					     struct gst_param *,
+					     gst_fst_callback_func_t *,
+					     void *,
+					     int *);
+
+/*
+ * Local Types
+ */
+
+/*
+ * An FST found while generating a chunk of eq-points.  These are
+ * saved (or discarded as duplicates) when the chunk is merged, so
+ * that the FSTs are processed in the same order as in a serial run.
+ */
+
+struct efst_rec {
+	struct eqp_t *	eqpt;		/* Terminal endpoint of the FST */
+	struct eqp_t	eqpk;		/* Copy of the eq-point of the FST */
+	dist_t		length;		/* Length of the FST */
+	int		size;		/* Number of terminals */
+	int *		tlist;		/* The terminals (termindex) */
+};
+
+/*
+ * A contiguous range of the eq-points being extended to the current
+ * size.  The new eq-points and their terminal lists are built in
+ * private storage, and appended to the global arrays once every chunk
+ * of this size has been generated.
+ */
+
+struct echunk {
+	int		first;		/* First eq-point to extend */
+	int		last;		/* One past the last one */
+	struct eqp_t *	eqp;		/* New eq-points */
+	int		neqp;		/* Number of new eq-points */
+	int		eqp_size;	/* Allocated size of eqp */
+	eterm_t *	Z;		/* Terminal lists of new eq-points */
+	int		Z_used;		/* Number of Z entries in use */
+	int		Z_size;		/* Allocated size of Z */
+	struct efst_rec * fsts;		/* FSTs found */
+	int		nfsts;		/* Number of FSTs found */
+	int		fsts_size;	/* Allocated size of fsts */
+};
+
+/*
+ * The state of one thread generating eq-points.  Each has a private
+ * copy of the global EFST info, with its own scratch arrays.
+ */
+
+struct ethread {
+	struct einfo	ei;		/* Private copy of global EFST info */
+	bool *		MEMB;		/* Private eip -> MEMB */
+	struct pset *	termlist;	/* Private eip -> termlist */
+	int *		termindex;	/* Private eip -> termindex */
+	int *		cand;		/* Private eip -> cand */
+	bool *		chosen;		/* Private eip -> chosen */
+	int		chosen_size;	/* Allocated size of chosen */
+	struct eqp_t **	eqp_list;	/* Compatible eq-points */
+	int		eqp_list_size;	/* Allocated size of eqp_list */
+	struct echunk *	chunks;		/* Chunks of the current size */
+	int		nchunks;	/* Number of chunks */
+	int		first_chunk;	/* Do chunks first_chunk, */
+	int		chunk_step;	/*  first_chunk + chunk_step, ... */
+	int		size;		/* Size of eq-points to generate */
+};
+
+/*
+ * The terminals lying in a lune, visited in increasing order while the
+ * lune shrinks.  The lune consists of the points whose squared distance
+ * to both P and Q is less than dist2.
+ */
+
+struct lune {
+	struct point	P;		/* First center */
+	struct point	Q;		/* Second center */
+	dist_t		dist2;		/* Squared radius */
+	int		ncand;		/* Number of terminals in eip -> cand */
+	bool		shrunk;		/* Lune shrunk since cand was computed */
+};
 
 /*
  * Local Routines
  */
 
+static void		add_eqp_block (struct einfo *, gst_channel_ptr);
 static void		add_zero_length_fsts (struct einfo *, int, int **);
+static eterm_t *	alloc_terminal_list (struct einfo *, int);
 static void		build_fst_list (struct einfo *);
 static void		build_efst_graph (struct einfo *,
 					  int,
@@ -111,9 +204,62 @@ static void		build_efst_graph (struct einfo *,
 					  int *);
 static int		compute_efsts_for_unique_terminals (struct einfo *,
 							    cpu_time_t *);
+static void		emit_fst (struct einfo *, struct full_set *);
+static void		generate_eqp_chunk (struct einfo *,
+					    int,
+					    struct eqp_t **);
+static void		generate_eqp_chunks (void *);
+static struct eqp_t *	get_eqp (struct einfo *, int);
+static void		initialize_terminal_grid (struct einfo *);
+static void		lune_begin (struct einfo *,
+				    struct lune *,
+				    struct point *,
+				    struct point *,
+				    dist_t);
+static int		lune_next (struct einfo *, struct lune *);
+static void		lune_update (struct einfo *,
+				     struct lune *,
+				     struct point *,
+				     struct point *,
+				     dist_t,
+				     int);
+static int		merge_eqp_chunks (struct einfo *,
+					  struct echunk *,
+					  int,
+					  int,
+					  gst_channel_ptr);
+static void		queue_fst (struct echunk *,
+				   struct eqp_t *,
+				   struct eqp_t *,
+				   dist_t,
+				   int,
+				   int *);
 static void		renumber_terminals (struct einfo *,
 					    struct pset *,
 					    int *);
+static dist_t		save_fst (struct einfo *,
+				  struct eqp_t *,
+				  struct eqp_t *,
+				  dist_t);
+static void		stream_fsts (struct einfo *);
+static bool		terminal_grid_range (struct einfo *,
+					     struct point *,
+					     struct point *,
+					     dist_t,
+					     int *,
+					     int *,
+					     int *,
+					     int *);
+static bool		terminal_near_both (struct einfo *,
+					    struct point *,
+					    struct point *,
+					    dist_t,
+					    int);
+static int		terminals_near (struct einfo *,
+					struct point *,
+					struct point *,
+					dist_t,
+					int);
 static dist_t		test_and_save_fst (struct einfo *,
 					   struct eqp_t *,
 					   struct eqp_t *);
@@ -124,6 +270,9 @@ static dist_t		test_and_save_fst (struct einfo *,
 
 #define UPDATE_PTR(p,old,new) ((new) + ((p) - (old)))
 
+/* Number of chunks per thread into which each eq-point size is split. */
+#define CHUNKS_PER_THREAD	8
+
 #define UPDATE_RECTANGLE_BOUNDS(p) \
 	{ *minx = MIN(*minx, p.x); *maxx = MAX(*maxx, p.x); \
 	  *miny = MIN(*miny, p.y); *maxy = MAX(*maxy, p.y); }
@@ -138,6 +287,89 @@ struct gst_param *	params,
 int *			status
 )
 {
+struct gst_hypergraph *	cip;
+
+	GST_PRELUDE
+
+	if ((params NE NULL) AND
+	    (params -> efst_tile_size > 0) AND
+	    (nterms > params -> efst_tile_size)) {
+		/* Split the terminals into tiles. */
+		cip = _gst_generate_efsts_partitioned (nterms,
+						       terminals,
+						       params,
+						       status);
+	}
+	else {
+		cip = _gst_generate_efsts (nterms,
+					   terminals,
+					   params,
+					   NULL,
+					   NULL,
+					   status);
+	}
+
+	GST_POSTLUDE
+	return cip;
+}
+
+/*
+ * Generate the EFSTs, handing each one to the given function as soon
+ * as it is final instead of keeping it.  An FST is final once no other
+ * FST for the same terminals can be found, i.e., once the eq-points of
+ * one size less have all been generated.  The FSTs are numbered and
+ * handed out in the same order in which gst_generate_efsts() would
+ * list them, and memory for them is freed right away, so memory usage
+ * no longer grows with the total number of FSTs.  The hypergraph
+ * returned has the terminals, but no edges.
+ */
+
+	struct gst_hypergraph *
+gst_generate_efsts_streamed (
+
+int			nterms,		/* IN - number of terminals */
+double *		terminals,	/* IN - terminal coordinates */
+struct gst_param *	params,		/* IN - parameters */
+gst_fst_callback_func_t * fst_func,	/* IN - function to call per FST */
+void *			fst_data,	/* IN - data to pass to fst_func */
+int *			status		/* OUT - status code */
+)
+{
+struct gst_hypergraph *	cip;
+
+	GST_PRELUDE
+
+	FATAL_ERROR_IF (fst_func EQ NULL);
+
+	cip = _gst_generate_efsts (nterms,
+				   terminals,
+				   params,
+				   fst_func,
+				   fst_data,
+				   status);
+
+	GST_POSTLUDE
+	return cip;
+}
+
+/*
+ * Common code for gst_generate_efsts() and
+ * gst_generate_efsts_streamed().  Also used to generate the FSTs of
+ * each tile when the terminals are split into tiles.
+ */
+
+	struct gst_hypergraph *
+_gst_generate_efsts (
+
+int			nterms,		/* IN - number of terminals */
+double *		terminals,	/* IN - terminal coordinates */
+struct gst_param *	params,		/* IN - parameters */
+gst_fst_callback_func_t * fst_func,	/* IN - function to call per FST, */
+					/*	or NULL to keep them */
+void *			fst_data,	/* IN - data to pass to fst_func */
+int *			status		/* OUT - status code */
+)
+{
 int			i;
 int			j;
 int			k;
@@ -151,6 +383,7 @@ int *			fwd_map;
 int *			rev_map;
 int *			ip1;
 struct full_set *	fsp;
+struct full_set *	fsp_next;
 int *			tlist;
 struct einfo		einfo;
 struct gst_hypergraph *	cip;
@@ -163,8 +396,6 @@ char			buf1 [32];
 struct gst_channel *	timing;
 struct gst_proplist *	plist;
 
-	GST_PRELUDE
-
 	code = 0;
 
 	cip = NULL;
@@ -223,6 +454,10 @@ struct gst_proplist *	plist;
 
 	einfo.pts	= pts2;
 	einfo.params	= params;
+	einfo.fst_func	= fst_func;
+	einfo.fst_data	= fst_data;
+	einfo.rev_map	= rev_map;
+	einfo.ntrees	= 0;
 
 	neqpoints = compute_efsts_for_unique_terminals (&einfo, &Tn);
 
@@ -233,14 +468,31 @@ struct gst_proplist *	plist;
 
 	renumber_terminals (&einfo, pts, rev_map);
 
-	/* Link the FSTs together into one long list, and number them. */
-	build_fst_list (&einfo);
+	if (fst_func EQ NULL) {
+		/* Link the FSTs together into one long list, and number them. */
+		build_fst_list (&einfo);
+	}
+	else {
+		/* All FSTs found so far have been handed out. */
+		einfo.full_sets	= NULL;
+		einfo.hookp	= &(einfo.full_sets);
+	}
 
 	/* Add one FST for each duplicate terminal that was removed. */
 	if (ndg > 0) {
 		add_zero_length_fsts (&einfo, ndg, dup_grps);
 	}
 
+	if (fst_func NE NULL) {
+		for (fsp = einfo.full_sets; fsp NE NULL; fsp = fsp_next) {
+			fsp_next = fsp -> next;
+			emit_fst (&einfo, fsp);
+		}
+		/* The hypergraph gets no edges. */
+		einfo.full_sets	= NULL;
+		einfo.ntrees	= 0;
+	}
+
 	/* Measure renumber time.  This also sets Tn so that Tn-T0 is	*/
 	/* the total processing time.					*/
 	Trenum = _gst_get_delta_cpu_time (&Tn);
@@ -316,7 +568,6 @@ struct gst_proplist *	plist;
 		*status = code;
 	}
 
-	GST_POSTLUDE
 	return cip;
 }
 
@@ -502,46 +753,22 @@ bool flag	     /* IN - value of flag */
 }
 
 /*
- * Merge two disjoint ordered lists of terminal numbers.  The result
- * is of course also ordered.
+ * Merge two disjoint ordered lists of terminal numbers into Zp, which
+ * must have room for both.  The result is of course also ordered.
+ * Returns a pointer just past the end of the merged list.
  */
 
 	static
 	eterm_t *
 merge_terminal_lists (
 
-struct einfo *	eip,  /* IN/OUT - global EFST info */
 struct eqp_t *	eqpi, /* IN - first eq-point */
 struct eqp_t *	eqpj, /* IN - second eq-point */
-struct eqp_t *	eqpk,  /* IN - new eq-point */
-gst_channel_ptr	timing
+eterm_t *	Zp    /* OUT - merged terminal list */
 )
 {
-	eterm_t *p1, *endp1, *p2, *endp2, *Zp, *eqpZ_old;
+	eterm_t *p1, *endp1, *p2, *endp2;
 	int t1, t2;
-	struct eqp_t *eqpt;
-
-	/* Set new eq-point terminal list pointer */
-	eqpk -> Z = eip -> eqpZ_curr;
-
-	if (eip -> eqpZ_curr + eqpi -> S + eqpj -> S
-		>  eip -> eqpZ + eip -> eqpZ_size)  {
-
-		/* Terminal list space exhausted - double array */
-		if (timing)
-			gst_channel_printf (timing, "- doubling terminal list array\n");
-
-		eqpZ_old = eip -> eqpZ;
-		eip -> eqpZ = NEWA ( eip -> eqpZ_size * 2, eterm_t );
-		memcpy ( eip -> eqpZ, eqpZ_old, eip -> eqpZ_size * sizeof(eterm_t) );
-		eip -> eqpZ_size = 2 * eip -> eqpZ_size;
-		eip -> eqpZ_curr = UPDATE_PTR( eip -> eqpZ_curr, eqpZ_old, eip -> eqpZ );
-
-		/* Update pointers from eq-point array */
-		for (eqpt = eip -> eqp; eqpt <= eqpk; eqpt++)
-			eqpt -> Z = UPDATE_PTR( eqpt -> Z, eqpZ_old, eip -> eqpZ );
-		free( eqpZ_old );
-	}
 
 	p1 = eqpi -> Z;
 	p2 = eqpj -> Z;
@@ -554,7 +781,6 @@ gst_channel_ptr	timing
 
 	/* I tried it lots of different ways and discovered that
 	   these goto's actually produce the MOST readable form! */
-	Zp = eip -> eqpZ_curr;
 	for (;;) {
 		if (t1 < t2) {
 			*Zp++ = t1;
@@ -866,6 +1092,313 @@ struct einfo * eip /* IN/OUT - global EFST info */
 	free( eip -> eqp_squares );
 }
 
+/*
+ * Build a uniform grid over the (translated) terminals, so that the
+ * lune and wedge tests need only look at the terminals near a given
+ * region.  The cells are sized to hold about two terminals each, and
+ * the terminals of each cell are listed in increasing order.  This
+ * must be called after initialize_eqp_rectangles(), which computes
+ * the range of the terminal coordinates.
+ */
+
+	static
+	void
+initialize_terminal_grid (
+
+struct einfo * eip /* IN/OUT - global EFST info */
+)
+{
+	int i, n, ncells;
+	int * cell;
+	int * pos;
+	dist_t w, h, size;
+
+	n = eip -> pts -> n;
+	w = eip -> maxx - eip -> minx;
+	h = eip -> maxy - eip -> miny;
+
+	/* About two terminals per cell, but no more than about n cells */
+	/* along each axis (for nearly collinear terminals). */
+	size = sqrt (2.0 * w * h / ((double) n));
+	if (size < MAX(w, h) / ((double) n)) size = MAX(w, h) / ((double) n);
+	if (size <= 0.0) size = 1.0;
+
+	eip -> tgrid_size = size;
+	eip -> tgrid_nx = floor(w / size) + 1;
+	eip -> tgrid_ny = floor(h / size) + 1;
+	ncells = eip -> tgrid_nx * eip -> tgrid_ny;
+
+	/* Bucket the terminals by cell, preserving their order. */
+	cell = NEWA (n, int);
+	pos  = NEWA (ncells + 1, int);
+	for (i = 0; i <= ncells; i++) {
+		pos [i] = 0;
+	}
+	for (i = 0; i < n; i++) {
+		cell [i] = floor((eip -> eqp[i].E.x - eip -> minx) / size) * eip -> tgrid_ny
+			 + floor((eip -> eqp[i].E.y - eip -> miny) / size);
+		++(pos [cell [i] + 1]);
+	}
+	for (i = 0; i < ncells; i++) {
+		pos [i + 1] += pos [i];
+	}
+	eip -> tgrid_start = NEWA (ncells + 1, int);
+	memcpy (eip -> tgrid_start, pos, (ncells + 1) * sizeof (int));
+	eip -> tgrid_terms = NEWA (n, int);
+	for (i = 0; i < n; i++) {
+		eip -> tgrid_terms [pos [cell [i]]++] = i;
+	}
+	eip -> tgrid_x = NEWA (n, coord_t);
+	eip -> tgrid_y = NEWA (n, coord_t);
+	for (i = 0; i < n; i++) {
+		eip -> tgrid_x [i] = eip -> eqp[eip -> tgrid_terms [i]].E.x;
+		eip -> tgrid_y [i] = eip -> eqp[eip -> tgrid_terms [i]].E.y;
+	}
+
+	free (pos);
+	free (cell);
+}
+
+/*
+ * Find the range of terminal grid cells that meet the bounding box of
+ * the points lying within the given radius of both P and Q.  Returns
+ * FALSE if there are no such points.
+ */
+
+	static
+	bool
+terminal_grid_range (
+
+struct einfo *	eip,	/* IN - global EFST info */
+struct point *	P,	/* IN - first center */
+struct point *	Q,	/* IN - second center */
+dist_t		radius,	/* IN - radius about both centers */
+int *		imin,	/* OUT - range of cells in X */
+int *		imax,
+int *		jmin,	/* OUT - range of cells in Y */
+int *		jmax
+)
+{
+	dist_t lox, hix, loy, hiy;
+
+	if (NOT (radius > 0.0)) return FALSE;
+
+	/* Search a slightly larger box than needed -- the callers do */
+	/* the exact tests. */
+	radius = radius * (1.0 + 1.0e-6) + 1.0e-9 * eip -> tgrid_size;
+
+	lox = MAX(P -> x, Q -> x) - radius;
+	hix = MIN(P -> x, Q -> x) + radius;
+	loy = MAX(P -> y, Q -> y) - radius;
+	hiy = MIN(P -> y, Q -> y) + radius;
+	if ((lox > hix) OR (loy > hiy)) return FALSE;
+
+	*imin = MAX(0,			  floor((lox - eip -> minx) / eip -> tgrid_size));
+	*imax = MIN(eip -> tgrid_nx - 1, floor((hix - eip -> minx) / eip -> tgrid_size));
+	*jmin = MAX(0,			  floor((loy - eip -> miny) / eip -> tgrid_size));
+	*jmax = MIN(eip -> tgrid_ny - 1, floor((hiy - eip -> miny) / eip -> tgrid_size));
+
+	return TRUE;
+}
+
+/*
+ * Find the terminals r >= rmin whose squared distance to both P and Q
+ * is less than dist2.  These are left in eip -> cand (in no particular
+ * order), and their number is returned.
+ */
+
+	static
+	int
+terminals_near (
+
+struct einfo *	eip,	/* IN - global EFST info */
+struct point *	P,	/* IN - first center */
+struct point *	Q,	/* IN - second center */
+dist_t		dist2,	/* IN - squared radius about both centers */
+int		rmin	/* IN - smallest terminal to return */
+)
+{
+	int i, k, r, m, imin, imax, jmin, jmax, first, last, count;
+	int * cand;
+
+	if (NOT (dist2 > 0.0)) return 0;
+	if (NOT terminal_grid_range(eip, P, Q, sqrt(dist2),
+				    &imin, &imax, &jmin, &jmax)) return 0;
+
+	count = 0;
+	for (i = imin; i <= imax; i++) {
+		/* Cells jmin through jmax of this column are contiguous, */
+		/* so test all of their terminals in one batch. */
+		first = eip -> tgrid_start [i * eip -> tgrid_ny + jmin];
+		last  = eip -> tgrid_start [i * eip -> tgrid_ny + jmax + 1];
+		cand  = &(eip -> cand [count]);
+		m = _gst_near_both (&(eip -> tgrid_x [first]),
+				    &(eip -> tgrid_y [first]),
+				    last - first,
+				    P,
+				    Q,
+				    dist2,
+				    cand);
+		for (k = 0; k < m; k++) {
+			r = eip -> tgrid_terms [first + cand [k]];
+			if (r < rmin) continue;
+			eip -> cand [count++] = r;
+		}
+	}
+
+	return (count);
+}
+
+/*
+ * Test if any terminal other than t lies at distance less than dist
+ * from both P and Q.
+ */
+
+	static
+	bool
+terminal_near_both (
+
+struct einfo *	eip,	/* IN - global EFST info */
+struct point *	P,	/* IN - first center */
+struct point *	Q,	/* IN - second center */
+dist_t		dist,	/* IN - distance */
+int		t	/* IN - terminal to ignore */
+)
+{
+	int i, r, imin, imax, jmin, jmax;
+	int * tp;
+	int * endp;
+	struct point * p;
+
+	if (NOT terminal_grid_range(eip, P, Q, dist,
+				    &imin, &imax, &jmin, &jmax)) return FALSE;
+
+	for (i = imin; i <= imax; i++) {
+		tp   = &(eip -> tgrid_terms [eip -> tgrid_start [i * eip -> tgrid_ny + jmin]]);
+		endp = &(eip -> tgrid_terms [eip -> tgrid_start [i * eip -> tgrid_ny + jmax + 1]]);
+		while (tp < endp) {
+			r = *tp++;
+			if (r EQ t) continue;
+			p = &(eip -> eqp[r].E);
+			if ((EDIST(P, p) < dist) AND (EDIST(Q, p) < dist)) return TRUE;
+		}
+	}
+
+	return FALSE;
+}
+
+/*
+ * Start visiting the terminals in the given lune.
+ */
+
+	static
+	void
+lune_begin (
+
+struct einfo *	eip,	/* IN - global EFST info */
+struct lune *	lp,	/* OUT - the lune */
+struct point *	P,	/* IN - first center */
+struct point *	Q,	/* IN - second center */
+dist_t		dist2	/* IN - squared radius */
+)
+{
+	lp -> P		= *P;
+	lp -> Q		= *Q;
+	lp -> dist2	= dist2;
+	lp -> ncand	= terminals_near(eip, P, Q, dist2, 0);
+	lp -> shrunk	= FALSE;
+}
+
+/*
+ * Return the lowest numbered terminal in the lune that has not yet
+ * been visited, or -1 if there are none.  The lune usually holds only
+ * a few terminals, so we simply search for the smallest one.
+ */
+
+	static
+	int
+lune_next (
+
+struct einfo *	eip,	/* IN - global EFST info */
+struct lune *	lp	/* IN/OUT - the lune */
+)
+{
+	int i, r, best;
+	int * cand;
+	struct point * p;
+
+	cand = eip -> cand;
+
+	if (lp -> shrunk) {
+		/* Drop the terminals no longer inside the lune. */
+		for (i = 0; i < lp -> ncand; ) {
+			p = &(eip -> eqp[cand[i]].E);
+			if ((sqr_dist(p, &(lp -> P)) >= lp -> dist2) OR
+			    (sqr_dist(p, &(lp -> Q)) >= lp -> dist2)) {
+				cand[i] = cand[--(lp -> ncand)];
+			}
+			else {
+				++i;
+			}
+		}
+		lp -> shrunk = FALSE;
+	}
+
+	if (lp -> ncand <= 0) return -1;
+
+	best = 0;
+	for (i = 1; i < lp -> ncand; i++) {
+		if (cand[i] < cand[best]) best = i;
+	}
+	r = cand[best];
+	cand[best] = cand[--(lp -> ncand)];
+
+	return (r);
+}
+
+/*
+ * The lune has changed after visiting terminal r.  Usually the new
+ * lune lies inside the old one, so that the terminals of the old lune
+ * not yet visited need only be filtered.  Otherwise find the terminals
+ * after r in the new lune.
+ */
+
+	static
+	void
+lune_update (
+
+struct einfo *	eip,	/* IN - global EFST info */
+struct lune *	lp,	/* IN/OUT - the lune */
+struct point *	P,	/* IN - new first center */
+struct point *	Q,	/* IN - new second center */
+dist_t		dist2,	/* IN - new squared radius */
+int		r	/* IN - last terminal visited */
+)
+{
+	dist_t	r1, r2, slack;
+
+	if ((P -> x EQ lp -> P.x) AND (P -> y EQ lp -> P.y) AND
+	    (Q -> x EQ lp -> Q.x) AND (Q -> y EQ lp -> Q.y) AND
+	    (dist2 EQ lp -> dist2)) return;
+
+	/* Is each new disk inside the corresponding old one? */
+	r1 = sqrt(lp -> dist2);
+	r2 = sqrt(dist2);
+	slack = 1.0e-9 * r1;
+	if ((EDIST(P, &(lp -> P)) + r2 + slack <= r1) AND
+	    (EDIST(Q, &(lp -> Q)) + r2 + slack <= r1)) {
+		lp -> shrunk = TRUE;
+	}
+	else {
+		lp -> ncand  = terminals_near(eip, P, Q, dist2, r + 1);
+		lp -> shrunk = FALSE;
+	}
+
+	lp -> P		= *P;
+	lp -> Q		= *Q;
+	lp -> dist2	= dist2;
+}
+
 /*
  * Compute boundary of rectangle in which the Steiner point joining
  * the current eq-point to another eq-point can be placed
@@ -976,10 +1509,10 @@ int last_eqp	     /* IN - index of last eq-point to be saved */
 	 * number of squares that are overlapped by these eq-points.
 	 */
 
-	size = eip -> eqp[first_eqp].S;
+	size = get_eqp (eip, first_eqp) -> S;
 	total_squares = 0;
 	for (k = first_eqp; k <= last_eqp; k++) {
-		eqpk = &(eip -> eqp[k]);
+		eqpk = get_eqp (eip, k);
 
 		/* Compute geometric range of rectangle for this eq-point */
 		compute_eqp_rectangle(eip, eqpk, &minx, &maxx, &miny, &maxy);
@@ -1014,7 +1547,7 @@ int last_eqp	     /* IN - index of last eq-point to be saved */
 
 	/* Find counts for each square */
 	for (k = first_eqp; k <= last_eqp; k++) {
-		eqpk = &(eip -> eqp[k]);
+		eqpk = get_eqp (eip, k);
 
 		for (i = eqpk -> SMINX; i <= eqpk -> SMAXX; i++)
 			for (j = eqpk -> SMINY; j <= eqpk -> SMAXY; j++)
@@ -1031,7 +1564,7 @@ int last_eqp	     /* IN - index of last eq-point to be saved */
 
 	/* Fill arrays */
 	for (k = first_eqp; k <= last_eqp; k++) {
-		eqpk = &(eip -> eqp[k]);
+		eqpk = get_eqp (eip, k);
 
 		for (i = eqpk -> SMINX; i <= eqpk -> SMAXX; i++)
 			for (j = eqpk -> SMINY; j <= eqpk -> SMAXY; j++) {
@@ -1073,9 +1606,9 @@ struct eqp_t ** eqp_list  /* OUT - list of compatible eq-points */
 				si = i * eip -> srangey + j;
 				for (l = 0; l < sqr[si].n; l++) {
 					eqpj = sqr[si].eqp[l];
-					if (NOT (eqpj -> CHOSEN)) {
+					if (NOT (eip -> chosen [eqpj -> index])) {
 						*(eqpp++) = eqpj;
-						eqpj -> CHOSEN = TRUE;
+						eip -> chosen [eqpj -> index] = TRUE;
 					}
 				}
 			}
@@ -1316,6 +1849,7 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 )
 {
 	int r;
+	struct lune lune;
 	struct point CJ, AI, CLP, CLPP, CRP, CRPP;
 	dist_t a, aa, b, bb, c, d, e, f, ff, g, gg, h, hh;
 	dist_t dist_qicj, dist_oacr, dist_opqr, dist_pqi, dist_piai, dist_qpi;
@@ -1331,7 +1865,8 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 		aa	  = sqr_dist(&CJ, &(eqpk -> LP));
 		dist_qicj = 0.999 * aa; /* only look at terminals which really are inside lune */
 
-		for (r = 0; r < eip -> pts -> n; r++) {
+		lune_begin(eip, &lune, &CJ, &(eqpk -> LP), dist_qicj);
+		while ((r = lune_next(eip, &lune)) >= 0) {
 			if (sqr_dist(&(eip -> eqp[r].E), &CJ)		>= dist_qicj) continue;
 			if (sqr_dist(&(eip -> eqp[r].E), &(eqpk -> LP)) >= dist_qicj) continue;
 
@@ -1388,13 +1923,15 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 				      &(eqpk -> LP), &CJ);
 			aa	  = sqr_dist(&CJ, &(eqpk -> LP));
 			dist_qicj = 0.999 * aa;
+			lune_update(eip, &lune, &CJ, &(eqpk -> LP), dist_qicj, r);
 		}
 	}
 	else {
 		aa	 = sqr_dist(&(eqpi -> E), &(eqpk -> LP));
 		dist_pqi = 0.999 * aa;
 
-		for (r = 0; r < eip -> pts -> n; r++) {
+		lune_begin(eip, &lune, &(eqpi -> E), &(eqpk -> LP), dist_pqi);
+		while ((r = lune_next(eip, &lune)) >= 0) {
 			if (r EQ eqpi -> index) continue;
 			if (sqr_dist(&(eip -> eqp[r].E), &(eqpi -> E))	>= dist_pqi) continue;
 			if (sqr_dist(&(eip -> eqp[r].E), &(eqpk -> LP)) >= dist_pqi) continue;
@@ -1431,6 +1968,7 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 
 			aa	 = sqr_dist(&(eqpi -> E), &(eqpk -> LP));
 			dist_pqi = 0.999 * aa;
+			lune_update(eip, &lune, &(eqpi -> E), &(eqpk -> LP), dist_pqi, r);
 		}
 	}
 
@@ -1442,7 +1980,8 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 		aa	  = sqr_dist(&AI, &(eqpk -> RP));
 		dist_piai = 0.999 * aa;
 
-		for (r = 0; r < eip -> pts -> n; r++) {
+		lune_begin(eip, &lune, &AI, &(eqpk -> RP), dist_piai);
+		while ((r = lune_next(eip, &lune)) >= 0) {
 			if (sqr_dist(&(eip -> eqp[r].E), &AI)		>= dist_piai) continue;
 			if (sqr_dist(&(eip -> eqp[r].E), &(eqpk -> RP)) >= dist_piai) continue;
 
@@ -1499,13 +2038,15 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 				      &(eqpk -> RP), &AI);
 			aa	  = sqr_dist(&AI, &(eqpk -> RP));
 			dist_piai = 0.999 * aa;
+			lune_update(eip, &lune, &AI, &(eqpk -> RP), dist_piai, r);
 		}
 	}
 	else {
 		aa	 = sqr_dist(&(eqpj -> E), &(eqpk -> RP));
 		dist_qpi = 0.999 * aa;
 
-		for (r = 0; r < eip -> pts -> n; r++) {
+		lune_begin(eip, &lune, &(eqpj -> E), &(eqpk -> RP), dist_qpi);
+		while ((r = lune_next(eip, &lune)) >= 0) {
 			if (r EQ eqpj -> index) continue;
 			if (sqr_dist(&(eip -> eqp[r].E), &(eqpj -> E))	>= dist_qpi) continue;
 			if (sqr_dist(&(eip -> eqp[r].E), &(eqpk -> RP)) >= dist_qpi) continue;
@@ -1542,6 +2083,7 @@ struct eqp_t * eqpk  /* IN - new eq-point */
 
 			aa	 = sqr_dist(&(eqpj -> E), &(eqpk -> RP));
 			dist_qpi = 0.999 * aa;
+			lune_update(eip, &lune, &(eqpj -> E), &(eqpk -> RP), dist_qpi, r);
 		}
 	}
 
@@ -1822,7 +2364,7 @@ struct eqp_t *	eqpj,	/* IN - second eq-point */
 struct eqp_t *	eqpk	/* IN - new eq-point */
 )
 {
-	int r, t;
+	int t;
 	int right_counter = 0;
 	int middle_counter = 0;
 	int left_counter = 0;
@@ -1874,14 +2416,8 @@ struct eqp_t *	eqpk	/* IN - new eq-point */
 			/* Is the last edge too long? */
 			if (dist >= getBSD(eip, eqpt, eqpk)) continue;
 
-			flag = TRUE;
-			for (r = 0; r < eip -> pts -> n; r++) {
-				if (r EQ t) continue;
-				if ((EDIST(&SP, &(eip -> eqp[r].E))	     < dist) AND
-				    (EDIST(&(eqpt -> E), &(eip -> eqp[r].E)) < dist)) {
-					flag = FALSE; break;
-				}
-			}
+			/* Is there a terminal closer to both ends of the last edge? */
+			flag = NOT terminal_near_both(eip, &SP, &(eqpt -> E), dist, t);
 			if (NOT flag) continue;
 
 			eip -> termlist -> a[0] = eqpt -> E;
@@ -1946,14 +2482,18 @@ struct edge *		ep;
 struct edge *		mst_edges;
 dist_t			mst_len;
 char			buf1 [32];
-eterm_t			*new_Zp;
-int			i, j, k, si, l, size, iter, sz, starti, endi;
-dist_t			upper_bound;
-struct eqp_t		*eqpi, *eqpj, *eqpk, *eqpt, *eqp_old;
-struct eqp_t		**eqp_list, **eqpp, **eqppp;
+int			i, k, size, starti, endi, len;
+int			c, t, nt, nchunks, max_chunks, nthreads;
+struct eqp_t		*eqpk;
 struct elist		*rp;
+struct echunk		*chunks, *ch;
+struct ethread		*threads, *tp;
+void			**targs;
 int			max_fst_size;
 gst_channel_ptr		timing;
+#ifdef HAVE_GMP
+struct qr3_point	cur_eqp;
+#endif
 
 	pts = eip -> pts;
 	n = pts -> n;
@@ -1964,7 +2504,9 @@ gst_channel_ptr		timing;
 	/* Compute minimum spanning tree */
 
 	mst_edges = NEWA (n - 1, struct edge);
-	nedges = _gst_euclidean_mst (pts, mst_edges);
+	nedges = _gst_parallel_euclidean_mst (pts,
+					      eip -> params -> num_threads,
+					      mst_edges);
 	FATAL_ERROR_IF (nedges NE n - 1);
 
 	mst_len = 0.0;
@@ -2028,14 +2570,22 @@ gst_channel_ptr		timing;
 
 	/* Initialize array of equilateral points */
 
-	eip -> eqp_size		= eip->params->initial_eqpoints_terminal * n;
-	eip -> eqp		= NEWA (eip -> eqp_size, struct eqp_t);
+	eip -> eqp_block0	= eip->params->initial_eqpoints_terminal * n;
+	eip -> eqp_nblocks	= 0;
+	eip -> eqp_size		= 0;
+	add_eqp_block (eip, NULL);
+	eip -> eqp		= eip -> eqp_block [0];
 	eip -> size_start	= NEWA (n, int);
-	eip -> eqpZ_size	= 10 * eip -> eqp_size;
-	eip -> eqpZ		= NEWA (eip -> eqpZ_size, eterm_t);
-	eip -> eqpZ_curr	= eip -> eqpZ;
+	eip -> eqpZ_nblocks	= 0;
+	eip -> eqpZ_size	= 0;
+	eip -> eqpZ_used	= 0;
+	eip -> eqpZ_curr	= NULL;
+	eip -> eqpZ_end		= NULL;
 	eip -> MEMB		= NEWA (n, bool);
+	eip -> chosen		= NULL;
+	eip -> chunk		= NULL;
 	initialize_eqp_rectangles(eip);
+	eip -> cand		= NEWA (n, int);
 	eip -> fsts_checked = 0;
 
 #ifdef HAVE_GMP
@@ -2059,23 +2609,71 @@ gst_channel_ptr		timing;
 		eqpk -> L	= NULL;
 		eqpk -> S	= 1;
 		eqpk -> UB	= 0.0;
-		eqpk -> CHOSEN	= FALSE;
-		eqpk -> Z	= eip -> eqpZ_curr++;
+		eqpk -> Z	= alloc_terminal_list (eip, 1);
 		*(eqpk -> Z)	= k;
 		eip -> MEMB[k]	= FALSE;
 	}
+	initialize_terminal_grid(eip);
 	save_eqp_rectangles(eip, 0, n-2); /* skip last terminal */
 	eip -> size_start[1] = 0;
 
-	/* Main loop of equilateral point generation */
+	/* Main loop of equilateral point generation.  The eq-points of	*/
+	/* each size are generated from a contiguous range of smaller	*/
+	/* eq-points.  This range is split into chunks that are handed	*/
+	/* out to the threads.  Each chunk collects its new eq-points	*/
+	/* (and FSTs) privately, and the chunks are merged in order	*/
+	/* afterwards, so the eq-points are numbered exactly as they	*/
+	/* would be by a serial run.					*/
 
 	k = n;
-	eqpk = &(eip -> eqp[k]);
 	eip -> termlist = NEW_PSET(n+2);
 	eip -> termindex = NEWA (n+2, int);
-	eqp_list = NEWA( eip -> eqp_size, struct eqp_t *);
 	if (max_fst_size EQ 0) max_fst_size = n;
 
+	nthreads = eip -> params -> num_threads;
+#if NOT defined(HAVE_PTHREAD) OR defined(USE_TRIANGLE)
+	/* No threads, or Triangle (which is not reentrant) is used */
+	/* by the upper bound heuristics. */
+	nthreads = 1;
+#endif
+
+	max_chunks = CHUNKS_PER_THREAD * nthreads;
+	chunks = NEWA (max_chunks, struct echunk);
+	for (c = 0; c < max_chunks; c++) {
+		ch = &chunks [c];
+		ch -> eqp_size	= 16;
+		ch -> eqp	= NEWA (ch -> eqp_size, struct eqp_t);
+		ch -> Z_size	= 16 * ch -> eqp_size;
+		ch -> Z		= NEWA (ch -> Z_size, eterm_t);
+		ch -> fsts_size	= 16;
+		ch -> fsts	= NEWA (ch -> fsts_size, struct efst_rec);
+	}
+
+	threads = NEWA (nthreads, struct ethread);
+	targs	= NEWA (nthreads, void *);
+	for (t = 0; t < nthreads; t++) {
+		tp = &threads [t];
+		memset (&(tp -> ei), 0, sizeof (tp -> ei));
+		tp -> MEMB		= NEWA (n, bool);
+		tp -> termlist		= NEW_PSET(n+2);
+		tp -> termindex		= NEWA (n+2, int);
+		tp -> cand		= NEWA (n, int);
+		tp -> chosen_size	= 0;
+		tp -> chosen		= NULL;
+		tp -> eqp_list_size	= 0;
+		tp -> eqp_list		= NULL;
+		for (i = 0; i < n; i++) {
+			tp -> MEMB [i] = FALSE;
+		}
+#ifdef HAVE_GMP
+		if (eip->params->multiple_precision > 0) {
+			_gst_qr3_init (&(tp -> ei.cur_eqp.x));
+			_gst_qr3_init (&(tp -> ei.cur_eqp.y));
+		}
+#endif
+		targs [t] = tp;
+	}
+
 	for (size = 2; size <= max_fst_size-1; size++) {
 		starti = eip -> size_start[(size-1)/2 + 1];
 		endi   = k;
@@ -2089,119 +2687,118 @@ gst_channel_ptr		timing;
 				 size, k);
 		}
 
-		for (i = starti; i < endi; i++) {
-			eqpi = &(eip -> eqp[i]);
-			set_member_arr(eip, eqpi, TRUE);
-			generate_compatible_eqp(eip, size - eqpi -> S, eqpi, eqp_list);
-
-			eqpp = eqp_list;
-			while (*eqpp) {
-				eqpj = *(eqpp++);
-				eqpj -> CHOSEN = FALSE;
-				j = eqpj -> index;
-				if (j > i)				continue;
-				if (NOT disjoint(eip,eqpj))		continue;
-				for (iter = 1; iter <= 3; iter++) {
-					if (iter >= 2) {
-						struct eqp_t * eqptmp = eqpi;
-						eqpi = eqpj; eqpj = eqptmp;   /* swap i and j */
-						if (iter >= 3) break;	      /* finished */
-					}
-
-					if (NOT projection_test_case_I(eip, eqpi, eqpj)) continue;
-
-					/* Compute new eq-point. We do this by first computing */
-					/* its displacement relative to one of its terminals   */
-					/* and then add the result to that point	       */
+		/* Split [starti, endi) into chunks. */
+		len = endi - starti;
+		nchunks = (len < max_chunks) ? len : max_chunks;
+		for (c = 0; c < nchunks; c++) {
+			ch = &chunks [c];
+			ch -> first	= starti + c * (len / nchunks)
+					  + MIN (c, len % nchunks);
+			ch -> last	= ch -> first + len / nchunks
+					  + ((c < len % nchunks) ? 1 : 0);
+			ch -> neqp	= 0;
+			ch -> Z_used	= 0;
+			ch -> nfsts	= 0;
+		}
 
-					eq_point_disp_vector(eip, eqpi, eqpj, eqpk);
-					eqpk -> E = eip -> eqp [ eqpk -> origin_term ].E;
-					eqpk -> E.x += eqpk -> DV.x;
-					eqpk -> E.y += eqpk -> DV.y;
-					eqpk -> index = k;
+		nt = (nchunks < nthreads) ? nchunks : nthreads;
+		for (t = 0; t < nt; t++) {
+			tp = &threads [t];
+			if (tp -> chosen_size < k) {
+				if (tp -> chosen NE NULL) {
+					free (tp -> chosen);
+				}
+				tp -> chosen_size = 2 * k;
+				tp -> chosen = NEWA (tp -> chosen_size, bool);
+				for (i = 0; i < tp -> chosen_size; i++) {
+					tp -> chosen [i] = FALSE;
+				}
+			}
+			if (tp -> eqp_list_size <= k) {
+				if (tp -> eqp_list NE NULL) {
+					free (tp -> eqp_list);
+				}
+				tp -> eqp_list_size = 2 * k + 1;
+				tp -> eqp_list = NEWA (tp -> eqp_list_size,
+						       struct eqp_t *);
+			}
 
-					eqpk -> R  = eqpi;
-					eqpk -> L  = eqpj;
-					eqpk -> S  = eqpi -> S + eqpj -> S;
-					eqpk -> RP = eqpi -> E;
-					eqpk -> LP = eqpj -> E;
-					eqpk -> CHOSEN = FALSE;
-					eq_circle_center(&(eqpi -> E), &(eqpj  -> E), &(eqpk -> E), &(eqpk -> DC));
-					eqpk -> DR2 = sqr_dist(&(eqpk -> DC), &(eqpi -> E));
+			/* Refresh the private copy of the global info, */
+			/* keeping this thread's own scratch arrays. */
+#ifdef HAVE_GMP
+			cur_eqp = tp -> ei.cur_eqp;
+#endif
+			tp -> ei		= *eip;
+			tp -> ei.MEMB		= tp -> MEMB;
+			tp -> ei.termlist	= tp -> termlist;
+			tp -> ei.termindex	= tp -> termindex;
+			tp -> ei.chosen		= tp -> chosen;
+			tp -> ei.cand		= tp -> cand;
+			tp -> ei.chunk		= NULL;
+			tp -> ei.fsts_checked	= 0;
+#ifdef HAVE_GMP
+			tp -> ei.cur_eqp	= cur_eqp;
+#endif
+			tp -> chunks		= chunks;
+			tp -> nchunks		= nchunks;
+			tp -> first_chunk	= t;
+			tp -> chunk_step	= nt;
+			tp -> size		= size;
+		}
 
-					if (NOT projection_test_cases_II_VI(eip, eqpi, eqpj, eqpk)) continue;
+		_gst_run_parallel (nt, generate_eqp_chunks, targs);
 
-					eqpk -> DR = sqrt(eqpk -> DR2);
-					if (NOT bsd_test(eip, eqpi, eqpj, eqpk))			 continue;
-					if (NOT lune_test(eip, eqpi, eqpj, eqpk))			 continue;
+		for (t = 0; t < nt; t++) {
+			eip -> fsts_checked += threads [t].ei.fsts_checked;
+		}
 
-					new_Zp = merge_terminal_lists(eip, eqpi, eqpj, eqpk, timing);
+		k = merge_eqp_chunks (eip, chunks, nchunks, k, timing);
 
-					if (NOT upper_bound_test(eip, eqpi, eqpj, eqpk))		 continue;
-					if (NOT wedge_test(eip, eqpi, eqpj, eqpk))			 continue;
+		save_eqp_rectangles(eip, eip -> size_start[size], k-1);
 
-					eip -> eqpZ_curr = new_Zp;
+		if (eip -> fst_func NE NULL) {
+			/* All FSTs spanning size+1 terminals are final. */
+			stream_fsts (eip);
+		}
+	}
 
-					if (eqpk -> S > 2) {
-						eip -> termlist -> n = 0;
-						eqpoint_terminals(eip, eqpk);
-						upper_bound = upper_bound_heuristic(eip);
-						if (eqpk -> UB > upper_bound) eqpk -> UB = upper_bound;
-					}
-					k++;
-					if (k >= eip -> eqp_size) {
-						/* Eq-point space exhausted - double array */
-
-						if (timing NE NULL) {
-							gst_channel_printf (timing, "- doubling eq-point array\n");
-						}
-
-						eqp_old = eip -> eqp;
-						eip -> eqp = NEWA ( eip -> eqp_size * 2, struct eqp_t );
-						memcpy ( eip -> eqp, eqp_old, eip -> eqp_size * sizeof(struct eqp_t) );
-
-						/* Update local pointers */
-						eqpi = UPDATE_PTR( eqpi, eqp_old, eip -> eqp );
-						eqpj = UPDATE_PTR( eqpj, eqp_old, eip -> eqp );
-						eqpk = UPDATE_PTR( eqpk, eqp_old, eip -> eqp );
-
-						/* Update and double eq-point list */
-						eqppp = eqp_list;
-						while (*eqppp) {
-							*eqppp = UPDATE_PTR( *eqppp, eqp_old, eip -> eqp ); eqppp++;
-						}
-						eqppp = eqp_list;
-						eqp_list = NEWA( eip -> eqp_size * 2, struct eqp_t *);
-						memcpy ( eqp_list, eqppp, eip -> eqp_size * sizeof(struct eqp_t *) );
-						eqpp = UPDATE_PTR( eqpp, eqppp, eqp_list );
-						free( eqppp );
-
-						/* Update eq-point array left/right pointers */
-						for (eqpt = &(eip -> eqp[n]); eqpt <= eqpk; eqpt++) {
-							eqpt -> L = UPDATE_PTR( eqpt -> L, eqp_old, eip -> eqp );
-							eqpt -> R = UPDATE_PTR( eqpt -> R, eqp_old, eip -> eqp );
-						}
-
-						/* Update rectangle pointers */
-						for (sz = 1; sz < size; sz++)
-						 if (eip -> eqp_squares[sz] NE NULL)
-						  for (si = 0; si < eip -> srangex * eip -> srangey; si++)
-						   for (l = 0; l < eip -> eqp_squares[sz][si].n; l++)
-						    eip -> eqp_squares[sz][si].eqp[l] =
-						       UPDATE_PTR( eip -> eqp_squares[sz][si].eqp[l], eqp_old, eip -> eqp );
-						free( eqp_old );
-						eip -> eqp_size = 2 * eip -> eqp_size;
-					}
-					eqpk++;
-				}
-			}
-			set_member_arr(eip, eqpi, FALSE);
+	for (t = 0; t < nthreads; t++) {
+		tp = &threads [t];
+#ifdef HAVE_GMP
+		if (eip->params->multiple_precision > 0) {
+			_gst_qr3_clear (&(tp -> ei.cur_eqp.y));
+			_gst_qr3_clear (&(tp -> ei.cur_eqp.x));
 		}
-		save_eqp_rectangles(eip, eip -> size_start[size], k-1);
+#endif
+		if (tp -> eqp_list NE NULL) {
+			free (tp -> eqp_list);
+		}
+		if (tp -> chosen NE NULL) {
+			free (tp -> chosen);
+		}
+		free (tp -> cand);
+		free (tp -> termindex);
+		free (tp -> termlist);
+		free (tp -> MEMB);
+	}
+	free (targs);
+	free (threads);
+
+	for (c = 0; c < max_chunks; c++) {
+		free (chunks [c].fsts);
+		free (chunks [c].Z);
+		free (chunks [c].eqp);
 	}
+	free (chunks);
 
 	if (timing NE NULL) {
 		gst_channel_printf (timing, "%d eq-points generated.\n", k);
+		gst_channel_printf (timing,
+			"Eq-point storage: %d of %d eq-points in %d blocks,"
+			" %d of %d terminal list entries in %d blocks.\n",
+			k, eip -> eqp_size, eip -> eqp_nblocks,
+			eip -> eqpZ_used, eip -> eqpZ_size,
+			eip -> eqpZ_nblocks);
 	}
 
 	/* Finally add MST-edges */
@@ -2225,6 +2822,10 @@ gst_channel_ptr		timing;
 		++ep;
 	}
 
+	if (eip -> fst_func NE NULL) {
+		stream_fsts (eip);
+	}
+
 	if (timing NE NULL) {
 		_gst_convert_delta_cpu_time (buf1, Tn);
 		gst_channel_printf (timing, "Generating eq-points:   %s\n", buf1);
@@ -2239,16 +2840,24 @@ gst_channel_ptr		timing;
 	}
 #endif
 
-	free( eqp_list );
 	free( eip -> termindex );
 	free( eip -> termlist );
 
 	destroy_eqp_rectangles(eip);
+	free( eip -> tgrid_terms );
+	free( eip -> tgrid_x );
+	free( eip -> tgrid_y );
+	free( eip -> tgrid_start );
+	free( eip -> cand );
 
 	free( eip -> MEMB );
-	free( eip -> eqpZ );
+	for (i = 0; i < eip -> eqpZ_nblocks; i++) {
+		free( eip -> eqpZ_block [i] );
+	}
 	free( eip -> size_start );
-	free( eip -> eqp );
+	for (i = 0; i < eip -> eqp_nblocks; i++) {
+		free( eip -> eqp_block [i] );
+	}
 
 	/* Disconnect FSTs from hash table. */
 	for (rp = eip -> list.forw;
@@ -2265,6 +2874,338 @@ gst_channel_ptr		timing;
 	return k;
 }
 
+/*
+ * Thread entry point: generate the eq-points of every chunk assigned
+ * to this thread.
+ */
+
+	static
+	void
+generate_eqp_chunks (
+
+void *		arg		/* IN/OUT - struct ethread */
+)
+{
+int			c;
+struct ethread *	tp;
+
+	tp = (struct ethread *) arg;
+
+	for (c = tp -> first_chunk; c < tp -> nchunks; c += tp -> chunk_step) {
+		tp -> ei.chunk = &(tp -> chunks [c]);
+		generate_eqp_chunk (&(tp -> ei), tp -> size, tp -> eqp_list);
+	}
+	tp -> ei.chunk = NULL;
+}
+
+/*
+ * Generate all eq-points of the given size having eq-point i as one
+ * of their two constituents, for each eq-point i of the current chunk.
+ * The new eq-points, their terminal lists and any FSTs found are kept
+ * in the chunk.  The global eq-point arrays are only read here.
+ */
+
+	static
+	void
+generate_eqp_chunk (
+
+struct einfo *		eip,		/* IN/OUT - EFST info of this thread */
+int			size,		/* IN - size of eq-points to generate */
+struct eqp_t **		eqp_list	/* IN - scratch eq-point list */
+)
+{
+int			i, j, l, iter;
+dist_t			upper_bound;
+eterm_t			*new_Zp, *Z_old;
+struct echunk		*ch;
+struct eqp_t		*eqpi, *eqpj, *eqpk, *eqp_old;
+struct eqp_t		**eqpp;
+
+	ch = eip -> chunk;
+	eqpk = &(ch -> eqp [ch -> neqp]);
+
+	for (i = ch -> first; i < ch -> last; i++) {
+		eqpi = get_eqp (eip, i);
+		set_member_arr(eip, eqpi, TRUE);
+		generate_compatible_eqp(eip, size - eqpi -> S, eqpi, eqp_list);
+
+		eqpp = eqp_list;
+		while (*eqpp) {
+			eqpj = *(eqpp++);
+			j = eqpj -> index;
+			eip -> chosen [j] = FALSE;
+			if (j > i)				continue;
+			if (NOT disjoint(eip,eqpj))		continue;
+			for (iter = 1; iter <= 3; iter++) {
+				if (iter >= 2) {
+					struct eqp_t * eqptmp = eqpi;
+					eqpi = eqpj; eqpj = eqptmp;   /* swap i and j */
+					if (iter >= 3) break;	      /* finished */
+				}
+
+				if (NOT projection_test_case_I(eip, eqpi, eqpj)) continue;
+
+				/* Compute new eq-point. We do this by first computing */
+				/* its displacement relative to one of its terminals   */
+				/* and then add the result to that point	       */
+
+				eq_point_disp_vector(eip, eqpi, eqpj, eqpk);
+				eqpk -> E = eip -> eqp [ eqpk -> origin_term ].E;
+				eqpk -> E.x += eqpk -> DV.x;
+				eqpk -> E.y += eqpk -> DV.y;
+				eqpk -> index = -1;	/* numbered when merged */
+
+				eqpk -> R  = eqpi;
+				eqpk -> L  = eqpj;
+				eqpk -> S  = eqpi -> S + eqpj -> S;
+				eqpk -> RP = eqpi -> E;
+				eqpk -> LP = eqpj -> E;
+				eq_circle_center(&(eqpi -> E), &(eqpj  -> E), &(eqpk -> E), &(eqpk -> DC));
+				eqpk -> DR2 = sqr_dist(&(eqpk -> DC), &(eqpi -> E));
+
+				if (NOT projection_test_cases_II_VI(eip, eqpi, eqpj, eqpk)) continue;
+
+				eqpk -> DR = sqrt(eqpk -> DR2);
+				if (NOT bsd_test(eip, eqpi, eqpj, eqpk))			 continue;
+				if (NOT lune_test(eip, eqpi, eqpj, eqpk))			 continue;
+
+				if (ch -> Z_used + eqpk -> S > ch -> Z_size) {
+					/* Terminal list space exhausted - double array */
+					Z_old = ch -> Z;
+					ch -> Z = NEWA (2 * ch -> Z_size, eterm_t);
+					memcpy (ch -> Z, Z_old, ch -> Z_used * sizeof (eterm_t));
+					ch -> Z_size = 2 * ch -> Z_size;
+					for (l = 0; l < ch -> neqp; l++) {
+						ch -> eqp [l].Z = UPDATE_PTR (ch -> eqp [l].Z, Z_old, ch -> Z);
+					}
+					free (Z_old);
+				}
+				eqpk -> Z = &(ch -> Z [ch -> Z_used]);
+				new_Zp = merge_terminal_lists(eqpi, eqpj, eqpk -> Z);
+
+				if (NOT upper_bound_test(eip, eqpi, eqpj, eqpk))		 continue;
+				if (NOT wedge_test(eip, eqpi, eqpj, eqpk))			 continue;
+
+				ch -> Z_used = new_Zp - ch -> Z;
+
+				if (eqpk -> S > 2) {
+					eip -> termlist -> n = 0;
+					eqpoint_terminals(eip, eqpk);
+					upper_bound = upper_bound_heuristic(eip);
+					if (eqpk -> UB > upper_bound) eqpk -> UB = upper_bound;
+				}
+				++(ch -> neqp);
+				if (ch -> neqp >= ch -> eqp_size) {
+					/* Eq-point space exhausted - double array */
+					eqp_old = ch -> eqp;
+					ch -> eqp = NEWA (2 * ch -> eqp_size, struct eqp_t);
+					memcpy (ch -> eqp, eqp_old, ch -> eqp_size * sizeof (struct eqp_t));
+					ch -> eqp_size = 2 * ch -> eqp_size;
+					free (eqp_old);
+				}
+				eqpk = &(ch -> eqp [ch -> neqp]);
+			}
+		}
+		set_member_arr(eip, eqpi, FALSE);
+	}
+}
+
+/*
+ * Append the eq-points generated by each chunk (in chunk order) to the
+ * global eq-point array, and save the FSTs that were found.  Since
+ * the chunks cover consecutive ranges of the eq-points being extended,
+ * the result is the same as that of a serial run.
+ *
+ * Returns the new total number of eq-points.
+ */
+
+	static
+	int
+merge_eqp_chunks (
+
+struct einfo *		eip,		/* IN/OUT - global EFST info */
+struct echunk *		chunks,		/* IN/OUT - chunks to merge */
+int			nchunks,	/* IN - number of chunks */
+int			k,		/* IN - current number of eq-points */
+gst_channel_ptr		timing		/* IN - detailed timings channel */
+)
+{
+int			c, l;
+struct echunk *		ch;
+struct efst_rec *	rec;
+struct eqp_t *		eqpt;
+
+	/* Save the FSTs in the order a serial run finds them.	*/
+	for (c = 0; c < nchunks; c++) {
+		ch = &chunks [c];
+		for (l = 0; l < ch -> nfsts; l++) {
+			rec = &(ch -> fsts [l]);
+			memcpy (eip -> termindex, rec -> tlist, rec -> size * sizeof (int));
+			eip -> termlist -> n = rec -> size;
+			save_fst (eip, rec -> eqpt, &(rec -> eqpk), rec -> length);
+			free (rec -> tlist);
+		}
+		ch -> nfsts = 0;
+	}
+
+	/* Append the new eq-points and their terminal lists.  The	*/
+	/* storage only ever grows by whole blocks, so eq-points that	*/
+	/* are already in place (and all pointers to them) stay valid.	*/
+	for (c = 0; c < nchunks; c++) {
+		ch = &chunks [c];
+		for (l = 0; l < ch -> neqp; l++) {
+			if (k >= eip -> eqp_size) {
+				add_eqp_block (eip, timing);
+			}
+			eqpt = get_eqp (eip, k);
+			*eqpt = ch -> eqp [l];
+			eqpt -> index = k;
+			eqpt -> Z = alloc_terminal_list (eip, eqpt -> S);
+			memcpy (eqpt -> Z, ch -> eqp [l].Z, eqpt -> S * sizeof (eterm_t));
+			++k;
+		}
+		ch -> neqp = 0;
+		ch -> Z_used = 0;
+	}
+
+	return (k);
+}
+
+/*
+ * Add another block of eq-points.  Block b holds eqp_block0 << b
+ * eq-points, so the capacity doubles with each block and the number
+ * of blocks stays small.
+ */
+
+	static
+	void
+add_eqp_block (
+
+struct einfo *		eip,		/* IN/OUT - global EFST info */
+gst_channel_ptr		timing		/* IN - detailed timings channel */
+)
+{
+int		b;
+size_t		bsize;
+
+	b = eip -> eqp_nblocks;
+	FATAL_ERROR_IF (b >= EQP_MAX_BLOCKS);
+	bsize = ((size_t) (eip -> eqp_block0)) << b;
+	FATAL_ERROR_IF (bsize > (size_t) (INT_MAX - eip -> eqp_size));
+
+	if (timing NE NULL) {
+		gst_channel_printf (timing,
+			"- adding block of %d eq-points\n", (int) bsize);
+	}
+
+	eip -> eqp_block [b]	= NEWA (bsize, struct eqp_t);
+	eip -> eqp_size		+= bsize;
+	eip -> eqp_nblocks	= b + 1;
+}
+
+/*
+ * Return a pointer to the eq-point having the given index.
+ */
+
+	static
+	struct eqp_t *
+get_eqp (
+
+struct einfo *		eip,		/* IN - global EFST info */
+int			i		/* IN - eq-point index */
+)
+{
+int		b;
+int		bsize;
+
+	bsize = eip -> eqp_block0;
+	for (b = 0; i >= bsize; b++) {
+		i -= bsize;
+		bsize <<= 1;
+	}
+
+	return (&(eip -> eqp_block [b][i]));
+}
+
+/*
+ * Allocate a terminal list of S entries.  When the current block is
+ * full a new one is started that is at least as large as all of the
+ * previous blocks together.  The unused tail of the full block is
+ * simply left behind.
+ */
+
+	static
+	eterm_t *
+alloc_terminal_list (
+
+struct einfo *		eip,		/* IN/OUT - global EFST info */
+int			S		/* IN - number of entries */
+)
+{
+int		b;
+size_t		bsize;
+eterm_t *	Zp;
+
+	if (eip -> eqpZ_end - eip -> eqpZ_curr < S) {
+		b = eip -> eqpZ_nblocks;
+		FATAL_ERROR_IF (b >= EQP_MAX_BLOCKS);
+		bsize = MAX (eip -> eqpZ_size, 10 * eip -> eqp_block0);
+		if (bsize < (size_t) S) {
+			bsize = S;
+		}
+		FATAL_ERROR_IF (bsize > (size_t) (INT_MAX - eip -> eqpZ_size));
+
+		eip -> eqpZ_block [b]	= NEWA (bsize, eterm_t);
+		eip -> eqpZ_size	+= bsize;
+		eip -> eqpZ_nblocks	= b + 1;
+		eip -> eqpZ_curr	= eip -> eqpZ_block [b];
+		eip -> eqpZ_end		= eip -> eqpZ_curr + bsize;
+	}
+
+	Zp = eip -> eqpZ_curr;
+	eip -> eqpZ_curr += S;
+	eip -> eqpZ_used += S;
+
+	return (Zp);
+}
+
+/*
+ * Record an FST found while generating a chunk of eq-points.  It is
+ * saved when the chunk is merged.
+ */
+
+	static
+	void
+queue_fst (
+
+struct echunk *		ch,		/* IN/OUT - chunk being generated */
+struct eqp_t *		eqpt,		/* IN - terminal endpoint of FST */
+struct eqp_t *		eqpk,		/* IN - eq-point of FST */
+dist_t			length,		/* IN - length of FST */
+int			size,		/* IN - number of terminals */
+int *			termindex	/* IN - the terminals */
+)
+{
+struct efst_rec *	rec;
+struct efst_rec *	old;
+
+	if (ch -> nfsts >= ch -> fsts_size) {
+		old = ch -> fsts;
+		ch -> fsts = NEWA (2 * ch -> fsts_size, struct efst_rec);
+		memcpy (ch -> fsts, old, ch -> nfsts * sizeof (struct efst_rec));
+		ch -> fsts_size = 2 * ch -> fsts_size;
+		free (old);
+	}
+
+	rec = &(ch -> fsts [(ch -> nfsts)++]);
+	rec -> eqpt	= eqpt;
+	rec -> eqpk	= *eqpk;
+	rec -> length	= length;
+	rec -> size	= size;
+	rec -> tlist	= NEWA (size, int);
+	memcpy (rec -> tlist, termindex, size * sizeof (int));
+}
+
 /*
  * This routine performs all of the FST specific screening tests.
  * If all are passed, the FST is saved.
@@ -2279,11 +3220,58 @@ struct eqp_t *	eqpt,		/* IN - terminal endpoint of this FST */
 struct eqp_t *	eqpk		/* IN - eq-point of this FST */
 )
 {
+int size;
+dist_t length;
+
+	/* Assume that termlist has been constructed (change later!!) */
+
+	++(eip -> fsts_checked);
+
+	size	= eip -> termlist -> n;
+
+#ifdef HAVE_GMP
+	if (eip->params->multiple_precision > 0) {
+		/* Exact position of eqpk is already in eip -> cur_eqp. */
+		length	= _gst_compute_EFST_length (eip, eqpt);
+	}
+	else {
+		length	= eq_point_dist (eip, eqpt, eqpk);
+	}
+#else
+	length	= eq_point_dist (eip, eqpt, eqpk);
+#endif
+
+	if (eip -> chunk NE NULL) {
+		/* Generating a chunk of eq-points -- save it later. */
+		queue_fst (eip -> chunk, eqpt, eqpk, length, size,
+			   eip -> termindex);
+		return (length);
+	}
+
+	return (save_fst (eip, eqpt, eqpk, length));
+}
+
+/*
+ * Save an FST that has passed all screening tests, unless an FST for
+ * the same terminals that is at least as short has already been
+ * saved.  The terminals of the FST are in eip -> termlist and
+ * eip -> termindex.
+ */
+
+	static
+	dist_t
+save_fst (
+
+struct einfo *	eip,		/* IN/OUT - The global EFST info */
+struct eqp_t *	eqpt,		/* IN - terminal endpoint of this FST */
+struct eqp_t *	eqpk,		/* IN - eq-point of this FST */
+dist_t		length		/* IN - length of this FST */
+)
+{
 int			i, j, k;
 int			nedges;
 int			previdx;
 int size, spidx, termidx;
-dist_t length;
 struct edge *		ep;
 struct point *		sp;
 struct point		nsp;
@@ -2300,25 +3288,9 @@ struct pset *		new_steiners;
 struct full_set *	fsp;
 struct edge *		edges;
 
-	/* Assume that termlist has been constructed (change later!!) */
-
-	++(eip -> fsts_checked);
-
 	pts	= eip -> pts;
 	size	= eip -> termlist -> n;
 
-#ifdef HAVE_GMP
-	if (eip->params->multiple_precision > 0) {
-		/* Exact position of eqpk is already in eip -> cur_eqp. */
-		length	= _gst_compute_EFST_length (eip, eqpt);
-	}
-	else {
-		length	= eq_point_dist (eip, eqpt, eqpk);
-	}
-#else
-	length	= eq_point_dist (eip, eqpt, eqpk);
-#endif
-
 	/* General duplicate test.  We use a hash table, for speed.	*/
 	/* For correctness, the hash function must not depend upon the	*/
 	/* order of the terminals in the FST.  A simple checksum has	*/
@@ -2604,6 +3576,103 @@ struct pset *		terms;
 	}
 }
 
+/*
+ * Hand out all FSTs currently in the list, which must be final, and
+ * empty the list and hash table.  The terminals of each FST are
+ * renumbered to the original terminal numbers first.
+ */
+
+	static
+	void
+stream_fsts (
+
+struct einfo *		eip		/* IN/OUT - global EFST info */
+)
+{
+int			i;
+int			n;
+int *			tlist;
+struct elist *		rp1;
+struct elist *		rp2;
+struct elist *		rp3;
+struct full_set *	fsp;
+
+	rp2 = &(eip -> list);
+	for (rp1 = rp2 -> forw; rp1 NE rp2; ) {
+		fsp = rp1 -> fst;
+		tlist = fsp -> tlist;
+		n = fsp -> terminals -> n;
+		for (i = 0; i < n; i++) {
+			tlist [i] = eip -> rev_map [tlist [i]];
+		}
+		fsp -> tree_num = (eip -> ntrees)++;
+		emit_fst (eip, fsp);
+		rp3 = rp1;
+		rp1 = rp1 -> forw;
+		free ((char *) rp3);
+	}
+	rp2 -> forw = rp2;
+	rp2 -> back = rp2;
+
+	n = eip -> pts -> n;
+	for (i = 0; i < n; i++) {
+		eip -> hash [i] = NULL;
+	}
+}
+
+/*
+ * Hand one final FST to the caller's function, and free it.
+ */
+
+	static
+	void
+emit_fst (
+
+struct einfo *		eip,		/* IN - global EFST info */
+struct full_set *	fsp		/* IN - FST to hand out */
+)
+{
+int			i;
+int			nsps;
+int *			edges;
+double *		coords;
+struct point *		p;
+
+	nsps = (fsp -> steiners EQ NULL) ? 0 : fsp -> steiners -> n;
+
+	coords = NEWA (2 * nsps, double);
+	for (i = 0; i < nsps; i++) {
+		p = &(fsp -> steiners -> a [i]);
+		coords [2 * i]		= p -> x;
+		coords [2 * i + 1]	= p -> y;
+	}
+	edges = NEWA (2 * fsp -> nedges, int);
+	for (i = 0; i < fsp -> nedges; i++) {
+		edges [2 * i]		= fsp -> edges [i].p1;
+		edges [2 * i + 1]	= fsp -> edges [i].p2;
+	}
+
+	(*(eip -> fst_func)) (fsp -> tree_num,
+			      fsp -> tree_len,
+			      fsp -> terminals -> n,
+			      fsp -> tlist,
+			      nsps,
+			      coords,
+			      fsp -> nedges,
+			      edges,
+			      eip -> fst_data);
+
+	free ((char *) edges);
+	free ((char *) coords);
+	free ((char *) (fsp -> edges));
+	if (fsp -> steiners NE NULL) {
+		free ((char *) (fsp -> steiners));
+	}
+	free ((char *) (fsp -> terminals));
+	free ((char *) (fsp -> tlist));
+	free ((char *) fsp);
+}
+
 /*
  * Link all of the FSTs together into one long list and number them
  * each sequentially.  Free the doubly-linked elists as we go.
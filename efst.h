@@ -51,10 +51,13 @@
 
 #include "config.h"
 #include "egmp.h"
+#include "geosteiner.h"
 #include "geomtypes.h"
 #include "gsttypes.h"
 #include "point.h"
 
+struct echunk;
+
 /*
  * A structure to keep track of one EFST.  They are kept in a hash table
  * so that we can rapidly identify duplicates.	We also keep them all in
@@ -76,6 +79,14 @@ struct elist {
 
 typedef int32u			eterm_t;
 
+/*
+ * Maximum number of blocks in which eq-points and terminal lists are
+ * stored.  Each block is (at least) twice the size of the previous
+ * one, so existing entries never move when storage is added.
+ */
+
+#define EQP_MAX_BLOCKS		32
+
 
 /*
  * The current state for a single equilateral point.
@@ -123,7 +134,6 @@ struct eqp_t {
 	int		SMAXX;	/* square data structure */
 	int		SMINY;
 	int		SMAXY;
-	bool		CHOSEN;
 };
 
 
@@ -152,21 +162,31 @@ struct einfo {
 	struct bsd *	bsd;		/* Bottleneck Steiner distance info */
 	dist_t		eps;		/* Relative epsilon used for comparisons */
 	struct point	mean;		/* Mean point of all terminals */
-	struct eqp_t *	eqp;		/* Array of equilateral points */
-	int		eqp_size;	/* Current size of eq-point array */
+	struct eqp_t *	eqp;		/* First block of equilateral points */
+					/* (holds all terminals) */
+	struct eqp_t *	eqp_block [EQP_MAX_BLOCKS];
+					/* Blocks of eq-points.  Block b */
+					/* holds eqp_block0 << b of them */
+	int		eqp_nblocks;	/* Number of eq-point blocks */
+	int		eqp_block0;	/* Size of the first block */
+	int		eqp_size;	/* Capacity of all blocks */
 	int *		size_start;	/* Starting index of eq-points of */
 					/* given size */
-	int		zalloc_size;	/* Current maximum number of */
-					/* terminal lists */
-	eterm_t *	eqpZ;		/* List of terminals for each eq-point */
-	int		eqpZ_size;	/* Current size of terminals list */
+	eterm_t *	eqpZ_block [EQP_MAX_BLOCKS];
+					/* Blocks of terminal lists */
+	int		eqpZ_nblocks;	/* Number of terminal list blocks */
+	int		eqpZ_size;	/* Capacity of all terminal list blocks */
+	int		eqpZ_used;	/* Entries handed out (high-water) */
 	eterm_t *	eqpZ_curr;	/* Current allocation pointer */
+	eterm_t *	eqpZ_end;	/* End of current terminal list block */
 	bool *		MEMB;		/* For checking eq-point overlap */
 
 	/* Variables used while generating eq-points */
 	dist_t		dxi, dyi, dxj, dyj;
 	struct pset *	termlist;
 	int *		termindex;
+	bool *		chosen;		/* For generate_compatible_eqp */
+	struct echunk *	chunk;		/* Chunk being generated, or NULL */
 
 	/* Variables used for storing eq-point rectangles */
 	dist_t		eqp_square_size;	/* Size of squares */
@@ -174,6 +194,15 @@ struct einfo {
 	dist_t		minx, maxx, miny, maxy; /* Terminal coordinate range */
 	int		srangex, srangey;	/* Range of squares */
 
+	/* Uniform grid of terminals, for the lune and wedge tests */
+	dist_t		tgrid_size;	/* Side length of grid cells */
+	int		tgrid_nx, tgrid_ny;	/* Number of cells in X and Y */
+	int *		tgrid_start;	/* Start of each cell in tgrid_terms */
+	int *		tgrid_terms;	/* Terminals of each cell, in order */
+	coord_t *	tgrid_x;	/* Coordinates of tgrid_terms, for */
+	coord_t *	tgrid_y;	/* the batched distance kernels */
+	int *		cand;		/* Candidates found in the grid */
+
 	int		fsts_checked;	/* Num FSTs sent to screening tests */
 	bool *		term_check;	/* To compare FST terminal sets */
 
@@ -186,9 +215,34 @@ struct einfo {
 	struct full_set * full_sets;	/* Final list of FSTs */
 	struct full_set ** hookp;	/* For adding to end of FST list */
 
+	/* Streaming of final FSTs (gst_generate_efsts_streamed) */
+	gst_fst_callback_func_t * fst_func;
+					/* Function to hand FSTs to, or NULL */
+	void *		fst_data;	/* Data to pass to fst_func */
+	int *		rev_map;	/* Map to original terminal numbers */
+
 #ifdef HAVE_GMP
 	struct qr3_point cur_eqp;	/* Exact pos of current eq-point */
 #endif
 };
 
+
+/*
+ * Functions
+ */
+
+extern struct gst_hypergraph *
+		_gst_generate_efsts (int			nterms,
+				     double *			terminals,
+				     struct gst_param *		params,
+				     gst_fst_callback_func_t *	fst_func,
+				     void *			fst_data,
+				     int *			status);
+extern struct gst_hypergraph *
+		_gst_generate_efsts_partitioned (
+					int			nterms,
+					double *		terminals,
+					struct gst_param *	params,
+					int *			status);
+
 #endif
@@ -36,11 +36,25 @@
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Local Types
+ */
+
+struct stream_info {
+	FILE *			fp;	/* File to spool FSTs to */
+	int			count;	/* Number of FSTs spooled */
+	gst_scale_info_ptr	scinfo;	/* Scaling info */
+	gst_param_ptr		params;	/* Parameters */
+};
+
+
 /*
  * Local Routines
  */
 
+static void		copy_file (FILE *, FILE *);
 static void		decode_params (int, char **, gst_param_ptr);
+static gst_fst_callback_func_t	spool_fst;
 static void		usage (void);
 
 /*
@@ -50,6 +64,7 @@ static void		usage (void);
 static char *		description;
 static char *		me;
 static bool		Print_Detailed_Timings = FALSE;
+static bool		Stream_FSTs = FALSE;
 
 /*
  * The main routine for the "efst" program.  It reads a point set
@@ -68,11 +83,13 @@ char **		argv
 int			n;
 int			res;
 int			status;
+int			version;
 double *		terms;
 gst_param_ptr		params;
 gst_hg_ptr		hg;
 gst_channel_ptr		chan;
 gst_scale_info_ptr	scinfo;
+struct stream_info	sinfo;
 
 	me = argv [0];
 
@@ -90,6 +107,17 @@ gst_scale_info_ptr	scinfo;
 	params = gst_create_param (NULL);
 	decode_params (argc, argv, params);
 
+	if (Stream_FSTs) {
+		gst_get_int_param (params, GST_PARAM_SAVE_FORMAT, &version);
+		if ((version NE GST_PVAL_SAVE_FORMAT_VERSION2) AND
+		    (version NE GST_PVAL_SAVE_FORMAT_VERSION3)) {
+			fprintf (stderr,
+				 "%s: -s requires version 2 or 3 output.\n",
+				 me);
+			usage ();
+		}
+	}
+
 	/* Setup output channel if needed */
 	chan = NULL;
 	if (Print_Detailed_Timings) {
@@ -103,7 +131,28 @@ gst_scale_info_ptr	scinfo;
 	/* Read the points from stdin and generate the EFSTs */
 	scinfo = gst_create_scale_info (NULL);
 	n = gst_get_points (stdin, 0, &terms, scinfo);
-	hg = gst_generate_efsts (n, terms, params, &status);
+	if (Stream_FSTs) {
+		/* The number of FSTs must be printed before the FSTs	*/
+		/* themselves, so spool them to a temporary file.	*/
+		sinfo.fp	= tmpfile ();
+		sinfo.count	= 0;
+		sinfo.scinfo	= scinfo;
+		sinfo.params	= params;
+		if (sinfo.fp EQ NULL) {
+			fprintf (stderr, "%s: Unable to create spool file.\n",
+				 me);
+			exit (1);
+		}
+		hg = gst_generate_efsts_streamed (n,
+						  terms,
+						  params,
+						  spool_fst,
+						  &sinfo,
+						  &status);
+	}
+	else {
+		hg = gst_generate_efsts (n, terms, params, &status);
+	}
 
 	if (hg NE NULL) {
 		gst_set_hg_scale_info (hg, scinfo);
@@ -112,7 +161,16 @@ gst_scale_info_ptr	scinfo;
 		gst_set_str_property (gst_get_hg_properties (hg),
 				      GST_PROP_HG_NAME,
 				      description);
-		gst_save_hg (stdout, hg, params);
+		if (Stream_FSTs) {
+			gst_save_streamed_hg_header (stdout,
+						     hg,
+						     sinfo.count,
+						     params);
+			copy_file (sinfo.fp, stdout);
+		}
+		else {
+			gst_save_hg (stdout, hg, params);
+		}
 	}
 	else {
 		fprintf (stderr, "EFST generator returned status = %d\n",
@@ -121,6 +179,9 @@ gst_scale_info_ptr	scinfo;
 	}
 
 	/* Clean up. */
+	if (Stream_FSTs) {
+		fclose (sinfo.fp);
+	}
 	free(terms);
 	gst_free_hg (hg);
 	gst_free_channel (chan);
@@ -132,6 +193,55 @@ gst_scale_info_ptr	scinfo;
 	exit (res);
 }
 
+/*
+ * Write one FST handed out by the EFST generator to the spool file.
+ */
+
+	static
+	void
+spool_fst (
+
+GST_FST_CALLBACK_ARGS
+)
+{
+struct stream_info *	sip;
+
+	sip = (struct stream_info *) cb_data;
+
+	gst_save_streamed_fst (sip -> fp,
+			       nverts,
+			       verts,
+			       weight,
+			       nsps,
+			       coords,
+			       nedges,
+			       edges,
+			       sip -> scinfo,
+			       sip -> params);
+	++(sip -> count);
+}
+
+/*
+ * Copy the spooled FSTs to the output.
+ */
+
+	static
+	void
+copy_file (
+
+FILE *		in,		/* IN - spool file */
+FILE *		out		/* IN - output file */
+)
+{
+size_t		k;
+char		buf [8192];
+
+	rewind (in);
+	while ((k = fread (buf, 1, sizeof (buf), in)) > 0) {
+		fwrite (buf, 1, k, out);
+	}
+}
+
 /*
  * This routine decodes the various command-line arguments.
  */
@@ -226,6 +336,10 @@ int		rv;
 				break;
 #endif
 
+			case 's':
+				Stream_FSTs = TRUE;
+				break;
+
 			case 't':
 				Print_Detailed_Timings = TRUE;
 				break;
@@ -324,6 +438,8 @@ static char *	arg_doc [] = {
 	"\t-m N\tUse multiple precision.  Larger N use it more.",
 	"\t\t Default is N=0 which disables multiple precision.",
 #endif
+	"\t-s\tWrite each FST out as soon as it is final, instead of",
+	"\t\tkeeping all of them in memory (versions 2 and 3 only).",
 	"\t-t\tPrint detailed timings on stderr.",
 	"\t-v N\tGenerates version N output data format.",
 	"\t-Z P V\tSet parameter P to value V.",
@@ -340,7 +456,7 @@ char **		pp;
 char *		p;
 
 	(void) fprintf (stderr,
-			"\nUsage: %s [-gt]"
+			"\nUsage: %s [-gst]"
 			" [-d txt]"
 			" [-k K]"
 #ifdef HAVE_GMP
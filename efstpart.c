@@ -0,0 +1,1999 @@
+/***********************************************************************
+
+	File:	efstpart.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Spatial decomposition of very large instances for the
+	Euclidean FST generator, and incremental updates of the
+	EFSTs after terminals have changed.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "efst.h"
+
+#include "config.h"
+#include "cputime.h"
+#include "dsuf.h"
+#include "efuncs.h"
+#include "emst.h"
+#include "fatal.h"
+#include "fstfuncs.h"
+#include "geosteiner.h"
+#include "logic.h"
+#include <math.h>
+#include "memory.h"
+#include "metric.h"
+#include "parallel.h"
+#include "parmblk.h"
+#include "prepostlude.h"
+#include "sortfuncs.h"
+#include "steiner.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * Global Routines
+ */
+
+struct gst_hypergraph *	_gst_generate_efsts_partitioned (
+					int,
+					double *,
+					struct gst_param *,
+					int *);
+struct gst_hypergraph *	gst_update_efsts (struct gst_hypergraph *,
+					  int,
+					  double *,
+					  int *,
+					  struct gst_param *,
+					  int *);
+
+
+/*
+ * Local Types
+ */
+
+/*
+ * The terminals, the cluster of each terminal, and a uniform grid
+ * used to find the terminals near a given terminal.
+ */
+
+struct pinfo {
+	struct pset *	pts;		/* The set of terminals */
+	int *		cl;		/* Cluster of each terminal */
+	dist_t		minx;		/* Lower left corner of the grid */
+	dist_t		miny;
+	dist_t		cell;		/* Side length of grid cells */
+	int		nx;		/* Number of cells in X and Y */
+	int		ny;
+	int *		gstart;		/* Start of each cell in gterms */
+	int *		gterms;		/* Terminals of each cell, in order */
+	int *		mark;		/* Stamp of the last list holding */
+					/* each terminal */
+	int		stamp;		/* Current stamp */
+};
+
+/*
+ * One sub-instance: either a tile (the terminals of cluster a plus
+ * the terminals near them), a band (the terminals of clusters a and b
+ * near the other cluster, plus the terminals near them), or a region
+ * to be regenerated after terminals have changed.  The FSTs of a tile
+ * are kept if they only span terminals of cluster a.  The FSTs of a
+ * band are kept if they span terminals of both cluster a and cluster
+ * b.  The FSTs of a region are kept if they span any terminal of
+ * cluster a, and no terminal outside clusters a and b.
+ */
+
+#define TASK_TILE	0
+#define TASK_BAND	1
+#define TASK_REGION	2
+
+struct ptask {
+	int		kind;		/* TASK_TILE, TASK_BAND or TASK_REGION */
+	int		n;		/* Number of terminals */
+	int *		map;		/* Original number of each terminal */
+	int		a;		/* First cluster */
+	int		b;		/* Second cluster (not for tiles) */
+	struct full_set * fsts;		/* FSTs kept, renumbered */
+	int		nfsts;		/* Number of FSTs kept */
+	int		half_fsts;	/* Number of half FSTs generated */
+	int		status;		/* Status of the FST generator */
+};
+
+/*
+ * The work done by one thread: tasks first, first + step, ...
+ */
+
+struct pthread_work {
+	struct ptask *	tasks;		/* All tasks */
+	int		ntasks;		/* Number of tasks */
+	int		first;		/* First task of this thread */
+	int		step;		/* Distance between its tasks */
+	int *		cl;		/* Cluster of each terminal */
+	struct pset *	pts;		/* The set of terminals */
+	struct gst_param *
+			params;		/* Parameters for each task */
+};
+
+/*
+ * A pair of adjacent clusters, and the longest MST edge between them.
+ */
+
+struct cpair {
+	int		a;
+	int		b;
+	dist_t		len;
+};
+
+/*
+ * An FST and its sorted terminals, for finding duplicates.
+ */
+
+struct straddler {
+	struct full_set * fst;		/* The FST */
+	int *		key;		/* Its terminals, in increasing order */
+	int		index;		/* Position in the order found */
+};
+
+
+/*
+ * Local Routines
+ */
+
+static int		add_near (struct pinfo *,
+				  struct point *,
+				  dist_t,
+				  int *,
+				  int);
+static void		build_grid (struct pinfo *, dist_t);
+static bool		change_near_fst (struct pinfo *,
+					 struct full_set *,
+					 dist_t);
+static int		common_mst_forest (struct pset *,
+					   int *,
+					   struct edge *,
+					   int,
+					   int,
+					   int,
+					   int *);
+static int		comp_pairs (const void *, const void *);
+static int		comp_straddlers (const void *, const void *);
+static struct full_set *
+			copy_fst (struct full_set *, int *, struct pset *);
+static int		find_clusters (struct pset *,
+				       struct edge *,
+				       int,
+				       int,
+				       int *,
+				       bool *);
+static int		make_band (struct pinfo *,
+				   int *,
+				   int *,
+				   struct cpair *,
+				   dist_t,
+				   int *);
+static int		find_pairs (struct pinfo *,
+				    struct edge *,
+				    int,
+				    bool *,
+				    dist_t,
+				    int *,
+				    struct cpair **);
+static struct full_set *
+			make_edge_fst (struct pset *, int, int, dist_t);
+static struct gst_hypergraph *
+			make_hypergraph (struct pset *,
+					 struct full_set *,
+					 dist_t,
+					 int,
+					 cpu_time_t);
+static bool		near_cluster (struct pinfo *, int, dist_t, int);
+static void		remove_duplicate_fsts (struct full_set **, int);
+static void		run_tasks (void *);
+static void		run_task (struct ptask *,
+				  struct pset *,
+				  int *,
+				  struct gst_param *);
+static bool		same_terminals (const struct straddler *,
+					const struct straddler *);
+static struct gst_hypergraph *
+			update_efsts (struct gst_hypergraph *,
+				      int,
+				      double *,
+				      int *,
+				      struct gst_param *,
+				      int *);
+
+/*
+ * Local Macros
+ */
+
+/* Relative slack in distance comparisons, to allow for rounding. */
+#define NEAR_SLACK	(1.0 + 1.0e-9)
+
+
+/*
+ * Generate the EFSTs of a very large instance by splitting it into
+ * tiles.  The terminals are first split into clusters of at most
+ * EFST_TILE_SIZE terminals by running Kruskal's algorithm on the
+ * Euclidean MST, refusing any merge that would make a cluster too
+ * large.  Each cluster, together with the terminals lying within a
+ * halo around it, forms a tile whose FSTs are generated independently
+ * of all other tiles.  Only the FSTs spanning terminals of the
+ * cluster alone are kept.  For each pair of clusters that are joined
+ * by an MST edge, or come within the halo width of each other, the
+ * terminals of both clusters near the other one, plus the
+ * terminals near them, form a band whose FSTs spanning both clusters
+ * are kept.  The tiles and bands are processed concurrently, and the
+ * results are merged in a fixed order.
+ *
+ * The result is a heuristic one: an FST reaching further than the
+ * halo around its cluster (or further than the band) is missed, and
+ * an FST that would have been pruned by a terminal outside its tile
+ * may be kept.  Every edge of the MST is always present, so the FSTs
+ * still span the terminals.
+ */
+
+	struct gst_hypergraph *
+_gst_generate_efsts_partitioned (
+
+int			nterms,		/* IN - number of terminals */
+double *		terminals,	/* IN - terminal coordinates */
+struct gst_param *	params,		/* IN - parameters */
+int *			status		/* OUT - status code */
+)
+{
+int			i;
+int			k;
+int			m;
+int			c;
+int			nmst;
+int			ncl;
+int			npairs;
+int			ntiles;
+int			ntasks;
+int			nstrad;
+int			nthreads;
+int			half_fsts;
+int			code;
+int *			cstart;
+int *			cmemb;
+int *			list;
+bool *			cut;
+struct edge *		mst;
+struct pset *		pts;
+struct pinfo		pinfo;
+struct cpair *		pairs;
+struct ptask *		tasks;
+struct ptask *		tp;
+struct pthread_work *	work;
+void **			targs;
+struct full_set *	fsp;
+struct full_set **	order;
+struct full_set *	full_sets;
+struct full_set **	hookp;
+struct gst_param	tparams;
+struct gst_hypergraph *	cip;
+struct gst_channel *	timing;
+dist_t			mst_length;
+dist_t			radius;
+cpu_time_t		T0;
+cpu_time_t		Tn;
+char			buf1 [32];
+
+	FATAL_ERROR_IF ((params EQ NULL) OR (nterms < 2));
+
+	timing = params -> detailed_timings_channel;
+
+	T0 = _gst_get_cpu_time ();
+	Tn = T0;
+
+	pts = _gst_create_pset (nterms, terminals);
+
+	/* Split the terminals into clusters along the MST. */
+	mst = NEWA (nterms - 1, struct edge);
+	nmst = _gst_parallel_euclidean_mst (pts, params -> num_threads, mst);
+	FATAL_ERROR_IF (nmst NE nterms - 1);
+
+	mst_length = 0;
+	for (i = 0; i < nmst; i++) {
+		mst_length += mst [i].len;
+	}
+
+	pinfo.pts	= pts;
+	pinfo.cl	= NEWA (nterms, int);
+	cut		= NEWA (nmst, bool);
+
+	ncl = find_clusters (pts,
+			     mst,
+			     nmst,
+			     params -> efst_tile_size,
+			     pinfo.cl,
+			     cut);
+
+	/* List the terminals of each cluster. */
+	cstart	= NEWA (ncl + 1, int);
+	cmemb	= NEWA (nterms, int);
+	for (c = 0; c <= ncl; c++) {
+		cstart [c] = 0;
+	}
+	for (i = 0; i < nterms; i++) {
+		++(cstart [pinfo.cl [i] + 1]);
+	}
+	for (c = 0; c < ncl; c++) {
+		cstart [c + 1] += cstart [c];
+	}
+	for (i = 0; i < nterms; i++) {
+		cmemb [cstart [pinfo.cl [i]]++] = i;
+	}
+	for (c = ncl; c > 0; c--) {
+		cstart [c] = cstart [c - 1];
+	}
+	cstart [0] = 0;
+
+	/* The halo width is given in units of the mean MST edge length. */
+	radius = params -> efst_tile_overlap * mst_length / nmst;
+	build_grid (&pinfo, radius);
+
+	list = NEWA (nterms, int);
+
+	npairs = find_pairs (&pinfo, mst, nmst, cut, radius, list, &pairs);
+
+	/* Build the terminal list of each tile and band. */
+	ntiles	= ncl;
+	ntasks	= ncl + npairs;
+	tasks	= NEWA (ntasks, struct ptask);
+	for (c = 0; c < ncl; c++) {
+		++(pinfo.stamp);
+		m = 0;
+		for (i = cstart [c]; i < cstart [c + 1]; i++) {
+			k = cmemb [i];
+			pinfo.mark [k] = pinfo.stamp;
+			list [m++] = k;
+		}
+		for (i = cstart [c]; i < cstart [c + 1]; i++) {
+			m = add_near (&pinfo, &(pts -> a [cmemb [i]]), radius, list, m);
+		}
+		tp = &tasks [c];
+		tp -> kind	= TASK_TILE;
+		tp -> n		= m;
+		tp -> map	= NEWA (m, int);
+		tp -> a		= c;
+		tp -> b		= -1;
+		memcpy (tp -> map, list, m * sizeof (int));
+	}
+	for (i = 0; i < npairs; i++) {
+		m = make_band (&pinfo, cstart, cmemb, &pairs [i], radius, list);
+		tp = &tasks [ntiles + i];
+		tp -> kind	= TASK_BAND;
+		tp -> n		= m;
+		tp -> map	= NEWA (m, int);
+		tp -> a		= pairs [i].a;
+		tp -> b		= pairs [i].b;
+		memcpy (tp -> map, list, m * sizeof (int));
+	}
+
+	if (timing NE NULL) {
+		_gst_convert_delta_cpu_time (buf1, &Tn);
+		gst_channel_printf (timing,
+			"Partition (%d tiles, %d bands): %s\n",
+			ntiles, npairs, buf1);
+	}
+
+	/* Each task runs serially, quietly, and without further tiling. */
+	tparams = *params;
+	tparams.num_threads			= 1;
+	tparams.efst_tile_size			= 0;
+	tparams.detailed_timings_channel	= NULL;
+
+	nthreads = params -> num_threads;
+#if NOT defined(HAVE_PTHREAD) OR defined(USE_TRIANGLE)
+	/* No threads, or Triangle (which is not reentrant) is used */
+	/* by the FST generator. */
+	nthreads = 1;
+#endif
+	if (nthreads > ntasks) {
+		nthreads = ntasks;
+	}
+
+	work	= NEWA (nthreads, struct pthread_work);
+	targs	= NEWA (nthreads, void *);
+	for (i = 0; i < nthreads; i++) {
+		work [i].tasks	= tasks;
+		work [i].ntasks	= ntasks;
+		work [i].first	= i;
+		work [i].step	= nthreads;
+		work [i].cl	= pinfo.cl;
+		work [i].pts	= pts;
+		work [i].params	= &tparams;
+		targs [i]	= &work [i];
+	}
+
+	_gst_run_parallel (nthreads, run_tasks, targs);
+
+	free ((char *) targs);
+	free ((char *) work);
+
+	if (timing NE NULL) {
+		_gst_convert_delta_cpu_time (buf1, &Tn);
+		gst_channel_printf (timing, "Tiles and Bands:        %s\n", buf1);
+	}
+
+	/* Merge the FSTs of all tiles, in order. */
+	code		= 0;
+	half_fsts	= 0;
+	full_sets	= NULL;
+	hookp		= &full_sets;
+	for (i = 0; i < ntasks; i++) {
+		tp = &tasks [i];
+		if ((code EQ 0) AND (tp -> status NE 0)) {
+			code = tp -> status;
+		}
+		half_fsts += tp -> half_fsts;
+		if (i >= ntiles) continue;
+		*hookp = tp -> fsts;
+		for (fsp = tp -> fsts; fsp NE NULL; fsp = fsp -> next) {
+			hookp = &(fsp -> next);
+		}
+	}
+
+	/* Several bands can find the same FST.  Keep the shortest	*/
+	/* copy of each (the first one found, in case of a tie).	*/
+	nstrad = 0;
+	for (i = ntiles; i < ntasks; i++) {
+		nstrad += tasks [i].nfsts;
+	}
+	order = NEWA (nstrad, struct full_set *);
+	nstrad = 0;
+	for (i = ntiles; i < ntasks; i++) {
+		for (fsp = tasks [i].fsts; fsp NE NULL; fsp = fsp -> next) {
+			order [nstrad++] = fsp;
+		}
+	}
+	remove_duplicate_fsts (order, nstrad);
+	for (i = 0; i < nstrad; i++) {
+		fsp = order [i];
+		if (fsp EQ NULL) continue;
+		*hookp = fsp;
+		hookp = &(fsp -> next);
+	}
+	*hookp = NULL;
+	free ((char *) order);
+
+	Tn = _gst_get_cpu_time ();
+
+	if (timing NE NULL) {
+		_gst_convert_cpu_time (Tn - T0, buf1);
+		gst_channel_printf (timing, "Total:                  %s\n", buf1);
+	}
+
+	cip = make_hypergraph (pts, full_sets, mst_length, half_fsts, Tn - T0);
+
+	/* Clean up all that is not in cip. */
+	for (i = 0; i < ntasks; i++) {
+		free ((char *) (tasks [i].map));
+	}
+	free ((char *) tasks);
+	free ((char *) list);
+	free ((char *) pairs);
+	free ((char *) cmemb);
+	free ((char *) cstart);
+	free ((char *) (pinfo.mark));
+	free ((char *) (pinfo.gterms));
+	free ((char *) (pinfo.gstart));
+	free ((char *) (pinfo.cl));
+	free ((char *) cut);
+	free ((char *) mst);
+
+	if (status NE NULL) {
+		*status = code;
+	}
+
+	return (cip);
+}
+
+/*
+ * Update the EFSTs of an instance after some of its terminals have
+ * been inserted, deleted or moved, without regenerating them all.
+ * New terminal i is old terminal old_index [i] (possibly moved), or
+ * an inserted terminal if old_index [i] is -1.  Old terminals that no
+ * new terminal refers to are deleted.  An old FST is kept if none of
+ * its terminals changed, no changed position (old or new) lies within
+ * the bounding box of the FST widened by its longest edge plus the
+ * halo width given by EFST_TILE_OVERLAP, and the MST paths between its
+ * terminals are the same in the old and the new MST (so that their
+ * bottleneck Steiner distances did not change).  The FSTs of the other
+ * terminals, and of the terminals near a terminal whose MST path to
+ * them changed, are regenerated from these terminals and those near
+ * them, and every MST edge of the new instance is made sure to be
+ * present.
+ *
+ * This is an approximate update, not an exact one: an FST reaching
+ * further than the halo width may be missed, and a regenerated FST
+ * that only a terminal beyond the halo would prune may be kept.
+ */
+
+	struct gst_hypergraph *
+gst_update_efsts (
+
+struct gst_hypergraph *	old_hg,		/* IN - hypergraph of the old EFSTs */
+int			nterms,		/* IN - new number of terminals */
+double *		terminals,	/* IN - new terminal coordinates */
+int *			old_index,	/* IN - old number of each terminal */
+					/*	(-1 if inserted) */
+struct gst_param *	params,		/* IN - parameters */
+int *			status		/* OUT - status code */
+)
+{
+int			i;
+int			j;
+int			nold;
+int			code;
+bool *			used;
+struct gst_hypergraph *	cip;
+
+	GST_PRELUDE
+
+	code	= 0;
+	cip	= NULL;
+
+	if (params EQ NULL) {
+		params = (struct gst_param *) &_gst_default_parmblk;
+	}
+
+	do {		/* Used only for "break"... */
+		if ((old_hg EQ NULL) OR
+		    (old_hg -> pts EQ NULL) OR
+		    (old_hg -> full_trees EQ NULL)) {
+			code = GST_ERR_NO_EMBEDDING;
+			break;
+		}
+		if (NOT _gst_is_euclidean (old_hg)) {
+			code = GST_ERR_INVALID_METRIC;
+			break;
+		}
+		if (nterms < 0) {
+			code = GST_ERR_INVALID_NUMBER_OF_TERMINALS;
+			break;
+		}
+
+		/* Each old terminal can be referred to only once. */
+		nold = old_hg -> pts -> n;
+		used = NEWA (nold + 1, bool);
+		for (j = 0; j < nold; j++) {
+			used [j] = FALSE;
+		}
+		for (i = 0; i < nterms; i++) {
+			j = old_index [i];
+			if (j < 0) continue;
+			if ((j >= nold) OR used [j]) {
+				code = GST_ERR_INVALID_VERTEX;
+				break;
+			}
+			used [j] = TRUE;
+		}
+		free ((char *) used);
+		if (code NE 0) break;
+
+		if (nterms < 2) {
+			/* Nothing left worth keeping. */
+			cip = _gst_generate_efsts (nterms,
+						   terminals,
+						   params,
+						   NULL,
+						   NULL,
+						   &code);
+			break;
+		}
+
+		cip = update_efsts (old_hg,
+				    nterms,
+				    terminals,
+				    old_index,
+				    params,
+				    &code);
+	} while (FALSE);
+
+	if (status NE NULL) {
+		*status = code;
+	}
+
+	GST_POSTLUDE
+	return (cip);
+}
+
+/*
+ * The work of gst_update_efsts, once its arguments have been checked.
+ */
+
+	static
+	struct gst_hypergraph *
+update_efsts (
+
+struct gst_hypergraph *	old_hg,		/* IN - hypergraph of the old EFSTs */
+int			nterms,		/* IN - new number of terminals */
+double *		terminals,	/* IN - new terminal coordinates */
+int *			old_index,	/* IN - old number of each terminal */
+struct gst_param *	params,		/* IN - parameters */
+int *			status		/* OUT - status code */
+)
+{
+int			i;
+int			j;
+int			k;
+int			m;
+int			nold;
+int			nmst;
+int			ncore;
+int			nkept;
+int			nfsts;
+int			nadded;
+int			npairs;
+int			big;
+int *			new_of_old;
+int *			cl;
+int *			tree;
+int *			list;
+bool			valid;
+struct edge *		mst;
+struct pset *		pts;
+struct pset *		old_pts;
+struct pset *		chg;
+struct point *		p;
+struct pinfo		tinfo;
+struct pinfo		cinfo;
+struct ptask		task;
+struct cpair *		pairs;
+struct cpair		key;
+struct full_set *	fsp;
+struct full_set **	kept;
+struct full_set **	fsts;
+struct full_set *	full_sets;
+struct full_set **	hookp;
+struct gst_param	tparams;
+struct gst_hypergraph *	cip;
+struct gst_channel *	timing;
+dist_t			mst_length;
+dist_t			radius;
+cpu_time_t		T0;
+cpu_time_t		Tn;
+char			buf1 [32];
+
+	timing = params -> detailed_timings_channel;
+
+	T0 = _gst_get_cpu_time ();
+	Tn = T0;
+
+	pts	= _gst_create_pset (nterms, terminals);
+	old_pts	= old_hg -> pts;
+	nold	= old_pts -> n;
+
+	/* Find the terminals that stayed in place.  The positions of	*/
+	/* all others, old and new, are the changed positions.		*/
+	new_of_old = NEWA (nold + 1, int);
+	for (j = 0; j < nold; j++) {
+		new_of_old [j] = -1;
+	}
+	chg = NEW_PSET (nterms + nold);
+	chg -> n = 0;
+	for (i = 0; i < nterms; i++) {
+		j = old_index [i];
+		p = &(pts -> a [i]);
+		if ((j >= 0) AND
+		    (old_pts -> a [j].x EQ p -> x) AND
+		    (old_pts -> a [j].y EQ p -> y)) {
+			new_of_old [j] = i;
+			continue;
+		}
+		chg -> a [(chg -> n)++] = *p;
+	}
+	for (j = 0; j < nold; j++) {
+		if (new_of_old [j] < 0) {
+			chg -> a [(chg -> n)++] = old_pts -> a [j];
+		}
+	}
+
+	mst = NEWA (nterms - 1, struct edge);
+	nmst = _gst_parallel_euclidean_mst (pts, params -> num_threads, mst);
+	FATAL_ERROR_IF (nmst NE nterms - 1);
+
+	mst_length = 0;
+	for (i = 0; i < nmst; i++) {
+		mst_length += mst [i].len;
+	}
+
+	/* The halo width is given in units of the mean MST edge length. */
+	radius = params -> efst_tile_overlap * mst_length / nmst;
+
+	tinfo.pts	= pts;
+	tinfo.cl	= NULL;
+	build_grid (&tinfo, radius);
+
+	cinfo.pts	= chg;
+	cinfo.cl	= NULL;
+	if (chg -> n > 0) {
+		build_grid (&cinfo, radius);
+	}
+
+	/* Find the terminals whose MST paths stayed the same. */
+	tree = NEWA (nterms, int);
+	big = common_mst_forest (old_pts,
+				 new_of_old,
+				 mst,
+				 nmst,
+				 nterms,
+				 params -> num_threads,
+				 tree);
+
+	/* Keep the old FSTs that no change can affect.  The terminals	*/
+	/* of the others (cluster 0) need new FSTs.			*/
+	cl = NEWA (nterms, int);
+	for (i = 0; i < nterms; i++) {
+		cl [i] = 2;
+	}
+	kept	= NEWA (old_hg -> num_edges + 1, struct full_set *);
+	nkept	= 0;
+	for (i = 0; i < old_hg -> num_edges; i++) {
+		fsp = old_hg -> full_trees [i];
+		valid = TRUE;
+		m = -1;
+		for (j = 0; j < fsp -> terminals -> n; j++) {
+			k = new_of_old [fsp -> tlist [j]];
+			if (k < 0) {
+				valid = FALSE;
+			}
+			else if (m < 0) {
+				m = tree [k];
+			}
+			else if (tree [k] NE m) {
+				/* Some bottleneck distance changed. */
+				valid = FALSE;
+			}
+		}
+		if (valid AND
+		    (chg -> n > 0) AND
+		    change_near_fst (&cinfo, fsp, radius)) {
+			valid = FALSE;
+		}
+		if (valid) {
+			kept [nkept++] = copy_fst (fsp, new_of_old, pts);
+			continue;
+		}
+		for (j = 0; j < fsp -> terminals -> n; j++) {
+			k = new_of_old [fsp -> tlist [j]];
+			if (k >= 0) {
+				cl [k] = 0;
+			}
+		}
+	}
+
+	/* So do the terminals near any changed position. */
+	list = NEWA (nterms, int);
+	for (j = 0; j < chg -> n; j++) {
+		++(tinfo.stamp);
+		m = add_near (&tinfo, &(chg -> a [j]), radius, list, 0);
+		for (i = 0; i < m; i++) {
+			cl [list [i]] = 0;
+		}
+	}
+
+	/* And so do the terminals near a terminal of another tree,	*/
+	/* which may now be spanned by new FSTs.  Each such pair has	*/
+	/* one terminal outside the largest tree.			*/
+	for (i = 0; i < nterms; i++) {
+		if (tree [i] EQ big) continue;
+		++(tinfo.stamp);
+		m = add_near (&tinfo, &(pts -> a [i]), radius, list, 0);
+		for (j = 0; j < m; j++) {
+			if (tree [list [j]] NE tree [i]) {
+				cl [i]		= 0;
+				cl [list [j]]	= 0;
+			}
+		}
+	}
+
+	if (timing NE NULL) {
+		_gst_convert_delta_cpu_time (buf1, &Tn);
+		gst_channel_printf (timing,
+			"Kept %d of %d FSTs, %d changed positions: %s\n",
+			nkept, old_hg -> num_edges, chg -> n, buf1);
+	}
+
+	/* Regenerate the FSTs of these terminals from a region that	*/
+	/* also holds the terminals near them (cluster 1), and the	*/
+	/* terminals near those (cluster 2).  The latter only serve to	*/
+	/* prune the FSTs, which are kept only if they lie in clusters	*/
+	/* 0 and 1.							*/
+	++(tinfo.stamp);
+	m = 0;
+	for (i = 0; i < nterms; i++) {
+		if (cl [i] NE 0) continue;
+		tinfo.mark [i] = tinfo.stamp;
+		list [m++] = i;
+	}
+	ncore = m;
+	for (i = 0; i < ncore; i++) {
+		m = add_near (&tinfo, &(pts -> a [list [i]]), radius, list, m);
+	}
+	k = m;
+	for (i = ncore; i < k; i++) {
+		cl [list [i]] = 1;
+		m = add_near (&tinfo, &(pts -> a [list [i]]), radius, list, m);
+	}
+
+	tparams = *params;
+	tparams.efst_tile_size			= 0;
+	tparams.detailed_timings_channel	= NULL;
+
+	task.kind	= TASK_REGION;
+	task.n		= m;
+	task.map	= list;
+	task.a		= 0;
+	task.b		= 1;
+	run_task (&task, pts, cl, &tparams);
+
+	if (timing NE NULL) {
+		_gst_convert_delta_cpu_time (buf1, &Tn);
+		gst_channel_printf (timing,
+			"Region (%d of %d terminals): %d FSTs: %s\n",
+			ncore, m, task.nfsts, buf1);
+	}
+
+	/* Merge the kept FSTs and the new ones.  An FST can be both. */
+	fsts = NEWA (nkept + task.nfsts + nmst, struct full_set *);
+	memcpy (fsts, kept, nkept * sizeof (struct full_set *));
+	nfsts = nkept;
+	for (fsp = task.fsts; fsp NE NULL; fsp = fsp -> next) {
+		fsts [nfsts++] = fsp;
+	}
+	remove_duplicate_fsts (fsts, nfsts);
+	j = 0;
+	for (i = 0; i < nfsts; i++) {
+		if (fsts [i] NE NULL) {
+			fsts [j++] = fsts [i];
+		}
+	}
+	nfsts = j;
+
+	/* Make sure that every MST edge is present. */
+	pairs	= NEWA (nfsts + 1, struct cpair);
+	npairs	= 0;
+	for (i = 0; i < nfsts; i++) {
+		fsp = fsts [i];
+		if (fsp -> terminals -> n NE 2) continue;
+		pairs [npairs].a	= MIN (fsp -> tlist [0], fsp -> tlist [1]);
+		pairs [npairs].b	= MAX (fsp -> tlist [0], fsp -> tlist [1]);
+		pairs [npairs].len	= fsp -> tree_len;
+		++npairs;
+	}
+	if (npairs > 0) {
+		qsort (pairs, npairs, sizeof (struct cpair), comp_pairs);
+	}
+	nadded = 0;
+	for (i = 0; i < nmst; i++) {
+		key.a = MIN (mst [i].p1, mst [i].p2);
+		key.b = MAX (mst [i].p1, mst [i].p2);
+		if ((npairs > 0) AND
+		    (bsearch (&key,
+			      pairs,
+			      npairs,
+			      sizeof (struct cpair),
+			      comp_pairs) NE NULL)) continue;
+		fsts [nfsts++] = make_edge_fst (pts, key.a, key.b, mst [i].len);
+		++nadded;
+	}
+
+	full_sets = NULL;
+	hookp = &full_sets;
+	for (i = 0; i < nfsts; i++) {
+		*hookp = fsts [i];
+		hookp = &(fsts [i] -> next);
+	}
+	*hookp = NULL;
+
+	Tn = _gst_get_cpu_time ();
+
+	if (timing NE NULL) {
+		gst_channel_printf (timing, "MST edges added:        %d\n", nadded);
+		_gst_convert_cpu_time (Tn - T0, buf1);
+		gst_channel_printf (timing, "Total:                  %s\n", buf1);
+	}
+
+	cip = make_hypergraph (pts, full_sets, mst_length, task.half_fsts, Tn - T0);
+
+	*status = task.status;
+
+	free ((char *) pairs);
+	free ((char *) fsts);
+	free ((char *) kept);
+	free ((char *) list);
+	free ((char *) cl);
+	free ((char *) tree);
+	if (chg -> n > 0) {
+		free ((char *) (cinfo.mark));
+		free ((char *) (cinfo.gterms));
+		free ((char *) (cinfo.gstart));
+	}
+	free ((char *) (tinfo.mark));
+	free ((char *) (tinfo.gterms));
+	free ((char *) (tinfo.gstart));
+	free ((char *) chg);
+	free ((char *) new_of_old);
+	free ((char *) mst);
+
+	return (cip);
+}
+
+/*
+ * Build the hypergraph for the given list of FSTs, which it takes
+ * over along with the terminals.
+ */
+
+	static
+	struct gst_hypergraph *
+make_hypergraph (
+
+struct pset *		pts,		/* IN - the terminals */
+struct full_set *	full_sets,	/* IN - list of FSTs */
+dist_t			mst_length,	/* IN - length of the MST */
+int			half_fsts,	/* IN - number of half FSTs */
+cpu_time_t		gen_time	/* IN - generation time */
+)
+{
+int			i;
+int			j;
+int			k;
+int			ntrees;
+int			count;
+int *			ip1;
+int *			tlist;
+struct full_set *	fsp;
+struct gst_hypergraph *	cip;
+struct gst_proplist *	plist;
+
+	/* Number the FSTs. */
+	ntrees = 0;
+	for (fsp = full_sets; fsp NE NULL; fsp = fsp -> next) {
+		fsp -> tree_num = ntrees++;
+	}
+
+	cip = gst_create_hg (NULL);
+	gst_set_hg_number_of_vertices (cip, pts -> n);
+	plist = cip -> proplist;
+
+	gst_free_metric (cip -> metric);
+	cip -> metric = gst_create_metric (GST_METRIC_L, 2, NULL);
+
+	cip -> num_edges		= ntrees;
+	cip -> num_edge_masks		= BMAP_ELTS (cip -> num_edges);
+	cip -> edge			= NEWA (ntrees + 1, int *);
+	cip -> edge_size		= NEWA (ntrees, int);
+	cip -> cost			= NEWA (ntrees, dist_t);
+	cip -> pts			= pts;
+	cip -> full_trees		= _gst_put_trees_in_array (full_sets,
+								   &ntrees);
+
+	gst_set_dbl_property (plist, GST_PROP_HG_INTEGRALITY_DELTA, 0);
+	gst_set_dbl_property (plist, GST_PROP_HG_MST_LENGTH, mst_length);
+	gst_set_dbl_property (plist,
+			      GST_PROP_HG_GENERATION_TIME,
+			      _gst_cpu_time_t_to_double_seconds (gen_time));
+	gst_set_int_property (plist, GST_PROP_HG_HALF_FST_COUNT, half_fsts);
+
+	count = 0;
+	for (i = 0; i < ntrees; i++) {
+		fsp = cip -> full_trees [i];
+		k = fsp -> terminals -> n;
+		cip -> edge_size [i]	= k;
+		cip -> cost [i]		= fsp -> tree_len;
+		count += k;
+	}
+	ip1 = NEWA (count, int);
+	for (i = 0; i < ntrees; i++) {
+		cip -> edge [i] = ip1;
+		fsp = cip -> full_trees [i];
+		tlist = fsp -> tlist;
+		k = fsp -> terminals -> n;
+		for (j = 0; j < k; j++) {
+			*ip1++ = tlist [j];
+		}
+	}
+	cip -> edge [i] = ip1;
+
+	/* Initialize any missing information in the hypergraph */
+	_gst_initialize_hypergraph (cip);
+
+	return (cip);
+}
+
+/*
+ * Of several FSTs spanning the same terminals, keep the shortest (the
+ * first one in the array, in case of a tie).  The others are freed,
+ * and their entries in the array set to NULL.
+ */
+
+	static
+	void
+remove_duplicate_fsts (
+
+struct full_set **	fsts,		/* IN/OUT - array of FSTs */
+int			n		/* IN - number of FSTs */
+)
+{
+int			i;
+int			j;
+int			k;
+struct full_set *	fsp;
+struct straddler *	strad;
+
+	strad = NEWA (n, struct straddler);
+	for (i = 0; i < n; i++) {
+		fsp = fsts [i];
+		k = fsp -> terminals -> n;
+		strad [i].fst	= fsp;
+		strad [i].key	= NEWA (k, int);
+		strad [i].index	= i;
+		memcpy (strad [i].key, fsp -> tlist, k * sizeof (int));
+		_gst_sort_ints (strad [i].key, k);
+	}
+	if (n > 0) {
+		qsort (strad, n, sizeof (struct straddler), comp_straddlers);
+	}
+	for (i = 0; i < n; i = j) {
+		for (j = i + 1; j < n; j++) {
+			if (NOT same_terminals (&strad [i], &strad [j])) break;
+			_gst_free_full_set (strad [j].fst);
+			fsts [strad [j].index] = NULL;
+		}
+	}
+	for (i = 0; i < n; i++) {
+		free ((char *) (strad [i].key));
+	}
+	free ((char *) strad);
+}
+
+/*
+ * Split the terminals into clusters of at most max_size terminals.
+ * The MST edges are considered in increasing order of length, and the
+ * clusters of both endpoints are merged unless the result would be
+ * too large.  The MST edges joining two clusters are flagged as cut.
+ * Clusters are numbered in order of their lowest terminal.
+ */
+
+	static
+	int
+find_clusters (
+
+struct pset *		pts,		/* IN - the terminals */
+struct edge *		mst,		/* IN - MST edges, sorted by length */
+int			nmst,		/* IN - number of MST edges */
+int			max_size,	/* IN - maximum cluster size */
+int *			cl,		/* OUT - cluster of each terminal */
+bool *			cut		/* OUT - MST edges joining clusters */
+)
+{
+int			i;
+int			n;
+int			ra;
+int			rb;
+int			ncl;
+int *			size;
+int *			number;
+struct dsuf		sets;
+
+	n = pts -> n;
+
+	_gst_dsuf_create (&sets, n);
+	size	= NEWA (n, int);
+	number	= NEWA (n, int);
+	for (i = 0; i < n; i++) {
+		_gst_dsuf_makeset (&sets, i);
+		size [i]	= 1;
+		number [i]	= -1;
+	}
+
+	for (i = 0; i < nmst; i++) {
+		ra = _gst_dsuf_find (&sets, mst [i].p1);
+		rb = _gst_dsuf_find (&sets, mst [i].p2);
+		FATAL_ERROR_IF (ra EQ rb);
+		if (size [ra] + size [rb] > max_size) {
+			cut [i] = TRUE;
+			continue;
+		}
+		cut [i] = FALSE;
+		_gst_dsuf_unite (&sets, ra, rb);
+		size [_gst_dsuf_find (&sets, ra)] = size [ra] + size [rb];
+	}
+
+	ncl = 0;
+	for (i = 0; i < n; i++) {
+		ra = _gst_dsuf_find (&sets, i);
+		if (number [ra] < 0) {
+			number [ra] = ncl++;
+		}
+		cl [i] = number [ra];
+	}
+
+	free ((char *) number);
+	free ((char *) size);
+	_gst_dsuf_destroy (&sets);
+
+	return (ncl);
+}
+
+/*
+ * Build a uniform grid over the terminals.  The cells are as wide as
+ * the halo, unless that would make the grid much larger than the
+ * number of terminals.
+ */
+
+	static
+	void
+build_grid (
+
+struct pinfo *		pp,		/* IN/OUT - partition info */
+dist_t			radius		/* IN - halo width */
+)
+{
+int			i;
+int			j;
+int			n;
+int			ncells;
+struct point *		p;
+struct pset *		pts;
+dist_t			maxx;
+dist_t			maxy;
+dist_t			cell;
+
+	pts = pp -> pts;
+	n = pts -> n;
+
+	p = &(pts -> a [0]);
+	pp -> minx = maxx = p -> x;
+	pp -> miny = maxy = p -> y;
+	for (i = 1; i < n; i++) {
+		p = &(pts -> a [i]);
+		pp -> minx = MIN (pp -> minx, p -> x);
+		pp -> miny = MIN (pp -> miny, p -> y);
+		maxx = MAX (maxx, p -> x);
+		maxy = MAX (maxy, p -> y);
+	}
+
+	cell = radius;
+	if (cell <= 0) {
+		cell = MAX (maxx - pp -> minx, maxy - pp -> miny);
+		if (cell <= 0) {
+			cell = 1.0;
+		}
+	}
+	for (;;) {
+		pp -> nx = (int) floor ((maxx - pp -> minx) / cell) + 1;
+		pp -> ny = (int) floor ((maxy - pp -> miny) / cell) + 1;
+		if ((double) (pp -> nx) * (double) (pp -> ny) <= 2.0 * n + 16) {
+			break;
+		}
+		cell *= 2.0;
+	}
+	pp -> cell = cell;
+	ncells = pp -> nx * pp -> ny;
+
+	pp -> gstart	= NEWA (ncells + 1, int);
+	pp -> gterms	= NEWA (n, int);
+	pp -> mark	= NEWA (n, int);
+	pp -> stamp	= 0;
+
+	for (j = 0; j <= ncells; j++) {
+		pp -> gstart [j] = 0;
+	}
+	for (i = 0; i < n; i++) {
+		p = &(pts -> a [i]);
+		j = ((int) ((p -> y - pp -> miny) / cell)) * pp -> nx
+		    + (int) ((p -> x - pp -> minx) / cell);
+		++(pp -> gstart [j + 1]);
+		pp -> mark [i] = 0;
+	}
+	for (j = 0; j < ncells; j++) {
+		pp -> gstart [j + 1] += pp -> gstart [j];
+	}
+	for (i = 0; i < n; i++) {
+		p = &(pts -> a [i]);
+		j = ((int) ((p -> y - pp -> miny) / cell)) * pp -> nx
+		    + (int) ((p -> x - pp -> minx) / cell);
+		pp -> gterms [pp -> gstart [j]++] = i;
+	}
+	for (j = ncells; j > 0; j--) {
+		pp -> gstart [j] = pp -> gstart [j - 1];
+	}
+	pp -> gstart [0] = 0;
+}
+
+/*
+ * Append to the list every terminal within the given distance of
+ * point p that does not carry the current stamp yet, and stamp it.
+ * Return the new length of the list.
+ */
+
+	static
+	int
+add_near (
+
+struct pinfo *		pp,		/* IN/OUT - partition info */
+struct point *		p,		/* IN - point */
+dist_t			dist,		/* IN - distance */
+int *			list,		/* IN/OUT - list of terminals */
+int			m		/* IN - current length of list */
+)
+{
+int			i;
+int			j;
+int			k;
+int			g;
+int			u;
+int			x0;
+int			x1;
+int			y0;
+int			y1;
+struct point *		q;
+dist_t			dx;
+dist_t			dy;
+dist_t			dist2;
+
+	dist2 = dist * dist * NEAR_SLACK;
+
+	x0 = (int) floor ((p -> x - dist - pp -> minx) / pp -> cell);
+	x1 = (int) floor ((p -> x + dist - pp -> minx) / pp -> cell);
+	y0 = (int) floor ((p -> y - dist - pp -> miny) / pp -> cell);
+	y1 = (int) floor ((p -> y + dist - pp -> miny) / pp -> cell);
+	x0 = MAX (x0, 0);
+	y0 = MAX (y0, 0);
+	x1 = MIN (x1, pp -> nx - 1);
+	y1 = MIN (y1, pp -> ny - 1);
+
+	for (j = y0; j <= y1; j++) {
+		for (i = x0; i <= x1; i++) {
+			g = j * pp -> nx + i;
+			for (k = pp -> gstart [g]; k < pp -> gstart [g + 1]; k++) {
+				u = pp -> gterms [k];
+				if (pp -> mark [u] EQ pp -> stamp) continue;
+				q = &(pp -> pts -> a [u]);
+				dx = q -> x - p -> x;
+				dy = q -> y - p -> y;
+				if (dx * dx + dy * dy > dist2) continue;
+				pp -> mark [u] = pp -> stamp;
+				list [m++] = u;
+			}
+		}
+	}
+
+	return (m);
+}
+
+/*
+ * List the pairs of adjacent clusters: those joined by an MST edge,
+ * and those having terminals within the halo width of each other.
+ * Each pair is listed once, with the longest MST edge joining the two
+ * clusters (or 0 if there is none).  Return the number of pairs.
+ */
+
+	static
+	int
+find_pairs (
+
+struct pinfo *		pp,		/* IN/OUT - partition info */
+struct edge *		mst,		/* IN - MST edges */
+int			nmst,		/* IN - number of MST edges */
+bool *			cut,		/* IN - MST edges joining clusters */
+dist_t			radius,		/* IN - halo width */
+int *			list,		/* SCRATCH - terminal list */
+struct cpair **		pairs_out	/* OUT - pairs of clusters */
+)
+{
+int			i;
+int			j;
+int			k;
+int			m;
+int			n;
+int			npairs;
+int			size;
+int *			cl;
+struct cpair *		pairs;
+struct cpair *		tmp;
+
+	n	= pp -> pts -> n;
+	cl	= pp -> cl;
+
+	size	= nmst + 1;
+	pairs	= NEWA (size, struct cpair);
+	npairs	= 0;
+
+	for (i = 0; i < nmst; i++) {
+		if (NOT cut [i]) continue;
+		j = cl [mst [i].p1];
+		k = cl [mst [i].p2];
+		pairs [npairs].a	= MIN (j, k);
+		pairs [npairs].b	= MAX (j, k);
+		pairs [npairs].len	= mst [i].len;
+		++npairs;
+	}
+
+	for (i = 0; i < n; i++) {
+		++(pp -> stamp);
+		pp -> mark [i] = pp -> stamp;
+		m = add_near (pp, &(pp -> pts -> a [i]), radius, list, 0);
+		for (j = 0; j < m; j++) {
+			k = list [j];
+			if (cl [k] <= cl [i]) continue;
+			if (npairs >= size) {
+				size <<= 1;
+				tmp = NEWA (size, struct cpair);
+				memcpy (tmp, pairs, npairs * sizeof (struct cpair));
+				free ((char *) pairs);
+				pairs = tmp;
+			}
+			pairs [npairs].a	= cl [i];
+			pairs [npairs].b	= cl [k];
+			pairs [npairs].len	= 0;
+			++npairs;
+		}
+	}
+
+	if (npairs > 0) {
+		qsort (pairs, npairs, sizeof (struct cpair), comp_pairs);
+	}
+	j = 0;
+	for (i = 0; i < npairs; i++) {
+		if ((j > 0) AND
+		    (pairs [j - 1].a EQ pairs [i].a) AND
+		    (pairs [j - 1].b EQ pairs [i].b)) {
+			pairs [j - 1].len = MAX (pairs [j - 1].len,
+						 pairs [i].len);
+			continue;
+		}
+		pairs [j++] = pairs [i];
+	}
+
+	*pairs_out = pairs;
+
+	return (j);
+}
+
+/*
+ * Return TRUE if some terminal of the given cluster lies within the
+ * given distance of terminal t.
+ */
+
+	static
+	bool
+near_cluster (
+
+struct pinfo *		pp,		/* IN - partition info */
+int			t,		/* IN - terminal */
+dist_t			dist,		/* IN - distance */
+int			c		/* IN - cluster */
+)
+{
+int			i;
+int			j;
+int			k;
+int			g;
+int			u;
+int			x0;
+int			x1;
+int			y0;
+int			y1;
+struct point *		p;
+struct point *		q;
+dist_t			dx;
+dist_t			dy;
+dist_t			dist2;
+
+	p = &(pp -> pts -> a [t]);
+
+	dist2 = dist * dist * NEAR_SLACK;
+
+	x0 = (int) floor ((p -> x - dist - pp -> minx) / pp -> cell);
+	x1 = (int) floor ((p -> x + dist - pp -> minx) / pp -> cell);
+	y0 = (int) floor ((p -> y - dist - pp -> miny) / pp -> cell);
+	y1 = (int) floor ((p -> y + dist - pp -> miny) / pp -> cell);
+	x0 = MAX (x0, 0);
+	y0 = MAX (y0, 0);
+	x1 = MIN (x1, pp -> nx - 1);
+	y1 = MIN (y1, pp -> ny - 1);
+
+	for (j = y0; j <= y1; j++) {
+		for (i = x0; i <= x1; i++) {
+			g = j * pp -> nx + i;
+			for (k = pp -> gstart [g]; k < pp -> gstart [g + 1]; k++) {
+				u = pp -> gterms [k];
+				if (pp -> cl [u] NE c) continue;
+				q = &(pp -> pts -> a [u]);
+				dx = q -> x - p -> x;
+				dy = q -> y - p -> y;
+				if (dx * dx + dy * dy <= dist2) {
+					return (TRUE);
+				}
+			}
+		}
+	}
+
+	return (FALSE);
+}
+
+/*
+ * List the terminals of the band between a pair of adjacent clusters.
+ * The band is at least as wide as the longest MST edge between the
+ * two clusters, so that all of these edges are found.  Return the
+ * number of terminals in the band.
+ */
+
+	static
+	int
+make_band (
+
+struct pinfo *		pp,		/* IN/OUT - partition info */
+int *			cstart,		/* IN - start of each cluster */
+int *			cmemb,		/* IN - terminals of each cluster */
+struct cpair *		cpp,		/* IN - pair of clusters */
+dist_t			radius,		/* IN - halo width */
+int *			list		/* OUT - terminals of the band */
+)
+{
+int			i;
+int			k;
+int			m;
+int			ncore;
+int			c;
+int			other;
+dist_t			width;
+
+	width = MAX (radius, cpp -> len);
+
+	++(pp -> stamp);
+
+	/* Terminals of either cluster near the other one. */
+	m = 0;
+	for (c = cpp -> a; ; c = cpp -> b) {
+		other = (c EQ cpp -> a) ? cpp -> b : cpp -> a;
+		for (i = cstart [c]; i < cstart [c + 1]; i++) {
+			k = cmemb [i];
+			if (NOT near_cluster (pp, k, width, other)) continue;
+			pp -> mark [k] = pp -> stamp;
+			list [m++] = k;
+		}
+		if (c EQ cpp -> b) break;
+	}
+
+	/* Plus all terminals near those. */
+	ncore = m;
+	for (i = 0; i < ncore; i++) {
+		m = add_near (pp, &(pp -> pts -> a [list [i]]), width, list, m);
+	}
+
+	return (m);
+}
+
+/*
+ * Thread entry point: run every step-th task.
+ */
+
+	static
+	void
+run_tasks (
+
+void *			arg		/* IN - struct pthread_work */
+)
+{
+int			i;
+struct pthread_work *	wp;
+
+	wp = (struct pthread_work *) arg;
+
+	for (i = wp -> first; i < wp -> ntasks; i += wp -> step) {
+		run_task (&(wp -> tasks [i]), wp -> pts, wp -> cl, wp -> params);
+	}
+}
+
+/*
+ * Generate the FSTs of a single tile or band, keep those that belong
+ * to it, and renumber their terminals.
+ */
+
+	static
+	void
+run_task (
+
+struct ptask *		tp,		/* IN/OUT - the task */
+struct pset *		pts,		/* IN - all terminals */
+int *			cl,		/* IN - cluster of each terminal */
+struct gst_param *	params		/* IN - parameters */
+)
+{
+int			i;
+int			j;
+int			k;
+int			in_a;
+int			in_b;
+int			in_other;
+bool			keep;
+double *		terms;
+double *		dp;
+struct point *		p;
+struct full_set *	fsp;
+struct full_set **	hookp;
+struct gst_hypergraph *	hg;
+
+	tp -> fsts	= NULL;
+	tp -> nfsts	= 0;
+	tp -> half_fsts	= 0;
+	tp -> status	= 0;
+
+	if (tp -> n < 2) {
+		/* A lone terminal has no FSTs. */
+		return;
+	}
+
+	terms = NEWA (3 * tp -> n, double);
+	dp = terms;
+	for (i = 0; i < tp -> n; i++) {
+		p = &(pts -> a [tp -> map [i]]);
+		*dp++ = p -> x;
+		*dp++ = p -> y;
+		*dp++ = p -> battery;
+	}
+
+	hg = _gst_generate_efsts (tp -> n,
+				  terms,
+				  params,
+				  NULL,
+				  NULL,
+				  &(tp -> status));
+
+	free ((char *) terms);
+
+	gst_get_int_property (hg -> proplist,
+			      GST_PROP_HG_HALF_FST_COUNT,
+			      &(tp -> half_fsts));
+
+	hookp = &(tp -> fsts);
+	for (i = 0; i < hg -> num_edges; i++) {
+		fsp = hg -> full_trees [i];
+		hg -> full_trees [i] = NULL;
+
+		in_a = 0;
+		in_b = 0;
+		in_other = 0;
+		for (j = 0; j < fsp -> terminals -> n; j++) {
+			k = tp -> map [fsp -> tlist [j]];
+			fsp -> tlist [j] = k;
+			if (cl [k] EQ tp -> a) {
+				++in_a;
+			}
+			else if (cl [k] EQ tp -> b) {
+				++in_b;
+			}
+			else {
+				++in_other;
+			}
+		}
+		switch (tp -> kind) {
+		case TASK_TILE:
+			keep = (in_b EQ 0) AND (in_other EQ 0);
+			break;
+
+		case TASK_BAND:
+			keep = (in_a > 0) AND (in_b > 0);
+			break;
+
+		default:
+			keep = (in_a > 0) AND (in_other EQ 0);
+			break;
+		}
+		if (NOT keep) {
+			/* This FST belongs to another tile or band. */
+			_gst_free_full_set (fsp);
+			continue;
+		}
+		*hookp = fsp;
+		hookp = &(fsp -> next);
+		++(tp -> nfsts);
+	}
+	*hookp = NULL;
+
+	/* The FSTs now belong to us, or have been freed. */
+	free ((char *) (hg -> full_trees));
+	hg -> full_trees = NULL;
+	gst_free_hg (hg);
+}
+
+/*
+ * Return TRUE if some changed position lies within the bounding box
+ * of the given FST, widened by its longest edge plus the halo width.
+ */
+
+	static
+	bool
+change_near_fst (
+
+struct pinfo *		pp,		/* IN - grid of changed positions */
+struct full_set *	fsp,		/* IN - FST */
+dist_t			radius		/* IN - halo width */
+)
+{
+int			i;
+int			j;
+int			k;
+int			g;
+int			nt;
+int			x0;
+int			x1;
+int			y0;
+int			y1;
+struct point *		p;
+struct point *		q;
+dist_t			minx;
+dist_t			maxx;
+dist_t			miny;
+dist_t			maxy;
+dist_t			dx;
+dist_t			dy;
+dist_t			d2;
+dist_t			width;
+
+	nt = fsp -> terminals -> n;
+
+	p = &(fsp -> terminals -> a [0]);
+	minx = maxx = p -> x;
+	miny = maxy = p -> y;
+	for (i = 1; i < nt; i++) {
+		p = &(fsp -> terminals -> a [i]);
+		minx = MIN (minx, p -> x);
+		maxx = MAX (maxx, p -> x);
+		miny = MIN (miny, p -> y);
+		maxy = MAX (maxy, p -> y);
+	}
+	if (fsp -> steiners NE NULL) {
+		for (i = 0; i < fsp -> steiners -> n; i++) {
+			p = &(fsp -> steiners -> a [i]);
+			minx = MIN (minx, p -> x);
+			maxx = MAX (maxx, p -> x);
+			miny = MIN (miny, p -> y);
+			maxy = MAX (maxy, p -> y);
+		}
+	}
+
+	/* Edge lengths are not always recorded, so measure them. */
+	d2 = 0;
+	for (i = 0; i < fsp -> nedges; i++) {
+		j = fsp -> edges [i].p1;
+		k = fsp -> edges [i].p2;
+		p = (j < nt) ? &(fsp -> terminals -> a [j])
+			     : &(fsp -> steiners -> a [j - nt]);
+		q = (k < nt) ? &(fsp -> terminals -> a [k])
+			     : &(fsp -> steiners -> a [k - nt]);
+		dx = p -> x - q -> x;
+		dy = p -> y - q -> y;
+		d2 = MAX (d2, dx * dx + dy * dy);
+	}
+	width = (sqrt (d2) + radius) * NEAR_SLACK;
+
+	minx -= width;
+	maxx += width;
+	miny -= width;
+	maxy += width;
+
+	x0 = (int) floor ((minx - pp -> minx) / pp -> cell);
+	x1 = (int) floor ((maxx - pp -> minx) / pp -> cell);
+	y0 = (int) floor ((miny - pp -> miny) / pp -> cell);
+	y1 = (int) floor ((maxy - pp -> miny) / pp -> cell);
+	x0 = MAX (x0, 0);
+	y0 = MAX (y0, 0);
+	x1 = MIN (x1, pp -> nx - 1);
+	y1 = MIN (y1, pp -> ny - 1);
+
+	for (j = y0; j <= y1; j++) {
+		for (i = x0; i <= x1; i++) {
+			g = j * pp -> nx + i;
+			for (k = pp -> gstart [g]; k < pp -> gstart [g + 1]; k++) {
+				p = &(pp -> pts -> a [pp -> gterms [k]]);
+				if ((minx <= p -> x) AND (p -> x <= maxx) AND
+				    (miny <= p -> y) AND (p -> y <= maxy)) {
+					return (TRUE);
+				}
+			}
+		}
+	}
+
+	return (FALSE);
+}
+
+/*
+ * Copy an old FST into the new instance, renumbering its terminals
+ * and taking their (possibly changed) battery levels.
+ */
+
+	static
+	struct full_set *
+copy_fst (
+
+struct full_set *	old,		/* IN - old FST */
+int *			new_of_old,	/* IN - new number of old terminals */
+struct pset *		pts		/* IN - new terminals */
+)
+{
+int			i;
+int			k;
+int			nt;
+int			ns;
+struct full_set *	fsp;
+
+	nt = old -> terminals -> n;
+
+	fsp = NEW (struct full_set);
+
+	fsp -> next		= NULL;
+	fsp -> tree_num		= 0;
+	fsp -> tree_len		= old -> tree_len;
+	fsp -> battery_score	= 0.0;
+	fsp -> tlist		= NEWA (nt, int);
+	fsp -> terminals	= NEW_PSET (nt);
+	fsp -> terminals -> n	= nt;
+	for (i = 0; i < nt; i++) {
+		k = new_of_old [old -> tlist [i]];
+		fsp -> tlist [i]		= k;
+		fsp -> terminals -> a [i]	= pts -> a [k];
+		fsp -> battery_score		+= pts -> a [k].battery;
+	}
+
+	fsp -> steiners = NULL;
+	if (old -> steiners NE NULL) {
+		ns = old -> steiners -> n;
+		fsp -> steiners = NEW_PSET (ns);
+		COPY_PSET (fsp -> steiners, old -> steiners);
+	}
+
+	fsp -> nedges	= old -> nedges;
+	fsp -> edges	= NEWA (old -> nedges, struct edge);
+	memcpy (fsp -> edges,
+		old -> edges,
+		old -> nedges * sizeof (struct edge));
+
+	return (fsp);
+}
+
+/*
+ * Make the 2-terminal FST for an MST edge.
+ */
+
+	static
+	struct full_set *
+make_edge_fst (
+
+struct pset *		pts,		/* IN - the terminals */
+int			t,		/* IN - first terminal */
+int			u,		/* IN - second terminal */
+dist_t			len		/* IN - length of the edge */
+)
+{
+struct full_set *	fsp;
+
+	fsp = NEW (struct full_set);
+
+	fsp -> next		= NULL;
+	fsp -> tree_num		= 0;
+	fsp -> tree_len		= len;
+	fsp -> battery_score	= pts -> a [t].battery + pts -> a [u].battery;
+	fsp -> tlist		= NEWA (2, int);
+	fsp -> tlist [0]	= t;
+	fsp -> tlist [1]	= u;
+	fsp -> terminals	= NEW_PSET (2);
+	fsp -> terminals -> n	= 2;
+	fsp -> terminals -> a [0] = pts -> a [t];
+	fsp -> terminals -> a [1] = pts -> a [u];
+	fsp -> steiners		= NULL;
+	fsp -> nedges		= 1;
+	fsp -> edges		= NEW (struct edge);
+	fsp -> edges -> p1	= 0;
+	fsp -> edges -> p2	= 1;
+	fsp -> edges -> len	= len;
+
+	return (fsp);
+}
+
+/*
+ * Split the new terminals into the trees of the forest formed by the
+ * MST edges that the old and the new MST have in common.  Two
+ * terminals of the same tree are joined by the same MST path before
+ * and after the change, and so have the same bottleneck Steiner
+ * distance.  Set the tree of each terminal, and return the largest
+ * tree.
+ */
+
+	static
+	int
+common_mst_forest (
+
+struct pset *		old_pts,	/* IN - the old terminals */
+int *			new_of_old,	/* IN - new number of each old */
+					/*	terminal (-1 if changed) */
+struct edge *		mst,		/* IN - edges of the new MST */
+int			nmst,		/* IN - number of new MST edges */
+int			nterms,		/* IN - new number of terminals */
+int			nthreads,	/* IN - number of threads */
+int *			tree		/* OUT - tree of each terminal */
+)
+{
+int			i;
+int			a;
+int			b;
+int			nold;
+int			npairs;
+int			big;
+int *			size;
+struct edge *		old_mst;
+struct cpair *		pairs;
+struct cpair		key;
+struct dsuf		sets;
+
+	_gst_dsuf_create (&sets, nterms);
+	for (i = 0; i < nterms; i++) {
+		_gst_dsuf_makeset (&sets, i);
+	}
+
+	/* The old MST edges between terminals that stayed in place,	*/
+	/* in the new numbering.					*/
+	nold	= old_pts -> n;
+	old_mst	= NEWA (nold, struct edge);
+	pairs	= NEWA (nold, struct cpair);
+	npairs	= 0;
+	if (nold >= 2) {
+		i = _gst_parallel_euclidean_mst (old_pts, nthreads, old_mst);
+		FATAL_ERROR_IF (i NE nold - 1);
+		for (i = 0; i < nold - 1; i++) {
+			a = new_of_old [old_mst [i].p1];
+			b = new_of_old [old_mst [i].p2];
+			if ((a < 0) OR (b < 0)) continue;
+			pairs [npairs].a	= MIN (a, b);
+			pairs [npairs].b	= MAX (a, b);
+			pairs [npairs].len	= old_mst [i].len;
+			++npairs;
+		}
+	}
+	if (npairs > 0) {
+		qsort (pairs, npairs, sizeof (struct cpair), comp_pairs);
+	}
+
+	for (i = 0; i < nmst; i++) {
+		key.a = MIN (mst [i].p1, mst [i].p2);
+		key.b = MAX (mst [i].p1, mst [i].p2);
+		if ((npairs EQ 0) OR
+		    (bsearch (&key,
+			      pairs,
+			      npairs,
+			      sizeof (struct cpair),
+			      comp_pairs) EQ NULL)) continue;
+		_gst_dsuf_unite (&sets,
+				 _gst_dsuf_find (&sets, key.a),
+				 _gst_dsuf_find (&sets, key.b));
+	}
+
+	size = NEWA (nterms, int);
+	for (i = 0; i < nterms; i++) {
+		size [i] = 0;
+	}
+	big = 0;
+	for (i = 0; i < nterms; i++) {
+		tree [i] = _gst_dsuf_find (&sets, i);
+		++(size [tree [i]]);
+		if (size [tree [i]] > size [big]) {
+			big = tree [i];
+		}
+	}
+
+	free ((char *) size);
+	free ((char *) pairs);
+	free ((char *) old_mst);
+	_gst_dsuf_destroy (&sets);
+
+	return (big);
+}
+
+/*
+ * Order pairs of clusters.
+ */
+
+	static
+	int
+comp_pairs (
+
+const void *		p1,
+const void *		p2
+)
+{
+const struct cpair *	a;
+const struct cpair *	b;
+
+	a = (const struct cpair *) p1;
+	b = (const struct cpair *) p2;
+
+	if (a -> a NE b -> a) {
+		return ((a -> a < b -> a) ? -1 : 1);
+	}
+	if (a -> b NE b -> b) {
+		return ((a -> b < b -> b) ? -1 : 1);
+	}
+	return (0);
+}
+
+/*
+ * Order FSTs by their terminals, then by length, then in the order
+ * found.
+ */
+
+	static
+	int
+comp_straddlers (
+
+const void *		p1,
+const void *		p2
+)
+{
+int			i;
+int			n1;
+int			n2;
+const struct straddler *	a;
+const struct straddler *	b;
+
+	a = (const struct straddler *) p1;
+	b = (const struct straddler *) p2;
+
+	n1 = a -> fst -> terminals -> n;
+	n2 = b -> fst -> terminals -> n;
+	if (n1 NE n2) {
+		return ((n1 < n2) ? -1 : 1);
+	}
+	for (i = 0; i < n1; i++) {
+		if (a -> key [i] NE b -> key [i]) {
+			return ((a -> key [i] < b -> key [i]) ? -1 : 1);
+		}
+	}
+	if (a -> fst -> tree_len NE b -> fst -> tree_len) {
+		return ((a -> fst -> tree_len < b -> fst -> tree_len) ? -1 : 1);
+	}
+	if (a -> index NE b -> index) {
+		return ((a -> index < b -> index) ? -1 : 1);
+	}
+	return (0);
+}
+
+/*
+ * Return TRUE if two FSTs have the same terminals.
+ */
+
+	static
+	bool
+same_terminals (
+
+const struct straddler *	a,	/* IN - first FST */
+const struct straddler *	b	/* IN - second FST */
+)
+{
+int			i;
+int			n;
+
+	n = a -> fst -> terminals -> n;
+	if (b -> fst -> terminals -> n NE n) return (FALSE);
+	for (i = 0; i < n; i++) {
+		if (a -> key [i] NE b -> key [i]) return (FALSE);
+	}
+	return (TRUE);
+}
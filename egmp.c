@@ -48,6 +48,7 @@
 #include <gmp.h>
 
 #include "costextension.h"
+#include "ddouble.h"
 #include "efst.h"
 #include "fatal.h"
 #include "logic.h"
@@ -117,6 +118,7 @@ static void	compute_sqrt_scaled_qr3 (mpf_ptr	res,
 					 mpq_srcptr	scale);
 static void	count_graph_items (struct GceInfo * gcp);
 static void	free_graph_arrays (struct GceInfo * gcp);
+static struct ddouble	mpq_get_dd (mpq_srcptr q);
 static void	print_qr3 (const qr3_t * x);
 static void	process_fst (struct GceInfo * gcp, int i);
 static void	project_qr3_point (struct qr3_point *		S,
@@ -129,6 +131,7 @@ static void	qr3_dot_product (qr3_t *			RES,
 				 const struct qr3_point *	B);
 static void	qr3_mul (qr3_t * dst, const qr3_t * p1, const qr3_t * p2);
 static double	qr3_to_double (struct einfo *, qr3_t *);
+static bool	qr3_to_double_filtered (qr3_t *, double *);
 static void	r_to_q (mpq_t q_dst, double r_src);
 static void	traverse_compute_exact_steiner_points (
 				struct GceInfo *	gcp,
@@ -436,6 +439,9 @@ qr3_t *		p
  * The obvious thing here is to square both sides and compare.
  * However, one must be careful regarding the signs of the two
  * sides when doing this.
+ *
+ * Nearly always, the result is already determined by a double-double
+ * approximation of A + B*sqrt(3), and we skip the Newton iteration.
  */
 
 	static
@@ -463,6 +469,10 @@ double		xf;
 		return (mpq_get_d (p -> a));
 	}
 
+	if (qr3_to_double_filtered (p, &xf)) {
+		return (xf);
+	}
+
 	mpq_init (z);
 	mpq_init (t1);
 	mpq_init (t2);
@@ -578,6 +588,119 @@ double		xf;
 	return (xf);
 }
 
+/*
+ * Try to translate A + B * sqrt(3) into a double using double-double
+ * arithmetic.  qr3_to_double returns mpq_get_d (Z) for some rational Z
+ * within a relative error of 2^(-EPS) of A + B*sqrt(3), and mpq_get_d
+ * truncates towards zero.  We compute an interval that contains all
+ * such Z, and succeed only if every value in it truncates to the same
+ * double -- which we then return.  This gives exactly the same result
+ * as the Newton iteration would.
+ */
+
+	static
+	bool
+qr3_to_double_filtered (
+
+qr3_t *		p,		/* IN - A + B*sqrt(3) to convert */
+double *	result		/* OUT - A + B*sqrt(3) as a double */
+)
+{
+double		h;
+double		l;
+double		m;
+double		gap;
+struct ddouble	a;
+struct ddouble	b;
+struct ddouble	z;
+struct ddouble	sqrt3;
+
+	a = mpq_get_dd (p -> a);
+	b = mpq_get_dd (p -> b);
+
+	/* Stay well away from overflow and underflow. */
+	if ((fabs (a.hi) > 1.0e250) OR (fabs (b.hi) > 1.0e250)) {
+		return (FALSE);
+	}
+
+	sqrt3.hi = 1.7320508075688772;
+	sqrt3.lo = 1.0035084221806903e-16;
+
+	z = dd_add (a, dd_mul (b, sqrt3));
+
+	h = z.hi;
+	l = z.lo;
+	if (h < 0.0) {
+		/* Truncation is symmetric about zero. */
+		h = -h;
+		l = -l;
+	}
+	if (h < 1.0e-250) {
+		return (FALSE);
+	}
+
+	/* The errors in A, B, sqrt(3) and the double-double operations	*/
+	/* are each at most a small multiple of 2^(-104) times |A| or	*/
+	/* |B*sqrt(3)|.  Add to this the 2^(-EPS) tolerance of Z.	*/
+
+	m =   ldexp (fabs (a.hi) + 2.0 * fabs (b.hi), -96)
+	    + ldexp (h, 1 - EPS);
+
+	/* With all values in [h + l - m, h + l + m], the result is	*/
+	/* h when l >= m, and the next double below h when l < -m.	*/
+	/* The interval must not reach the next double beyond that.	*/
+
+	if (m > ldexp (h, -60)) {
+		/* Too much cancellation in A + B*sqrt(3). */
+		return (FALSE);
+	}
+	if (l >= m) {
+		gap = nextafter (h, 2.0 * h) - h;
+		if (l + 2.0 * m >= gap) return (FALSE);
+	}
+	else if (l < -m) {
+		gap = h - nextafter (h, 0.0);
+		if (- l + 2.0 * m >= gap) return (FALSE);
+		h -= gap;
+	}
+	else {
+		return (FALSE);
+	}
+
+	if (z.hi < 0.0) {
+		h = -h;
+	}
+	*result = h;
+
+	return (TRUE);
+}
+
+/*
+ * Approximate a rational number Q by a double-double hi + lo, with
+ * |Q - (hi + lo)| < 2^(-52) * |lo|.
+ */
+
+	static
+	struct ddouble
+mpq_get_dd (
+
+mpq_srcptr	q		/* IN - rational number to convert */
+)
+{
+mpq_t		t;
+struct ddouble	r;
+
+	r.hi = mpq_get_d (q);
+
+	mpq_init (t);
+	r_to_q (t, r.hi);
+	mpq_sub (t, q, t);
+	r.lo = mpq_get_d (t);
+	mpq_clear (t);
+
+	return (r);
+}
+
 /*
  * Routine to compute the length of a given EFST (i.e., Simpson line)
  * to within 1/2 ULP.  (Modulo good behavior of the sqrt() function...)
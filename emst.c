@@ -56,6 +56,9 @@
  */
 
 int		_gst_euclidean_mst (struct pset * pts, struct edge * edges);
+int		_gst_parallel_euclidean_mst (struct pset *	pts,
+					     int		nthreads,
+					     struct edge *	edges);
 dist_t		_get_euclidean_mst_length (struct pset * pts);
 
 
@@ -71,7 +74,9 @@ dist_t		_get_euclidean_mst_length (struct pset * pts);
  */
 
 static int		build_euclidean_edges (struct pset *,
+					       int,
 					       struct edge **);
+static int		comp_edge_ends (const void *, const void *);
 
 /*
  * This routine computes the total length of the Euclidean Minimum
@@ -122,12 +127,28 @@ _gst_euclidean_mst (
 struct pset *		pts,		/* IN - point set. */
 struct edge *		edges		/* OUT - edge list. */
 )
+{
+	return (_gst_parallel_euclidean_mst (pts, 1, edges));
+}
+
+/*
+ * Same as _gst_euclidean_mst, but the Delaunay triangulation is
+ * computed using up to nthreads threads.
+ */
+
+	int
+_gst_parallel_euclidean_mst (
+
+struct pset *		pts,		/* IN - point set. */
+int			nthreads,	/* IN - number of threads to use */
+struct edge *		edges		/* OUT - edge list. */
+)
 {
 int		nedges;
 int		mst_edge_count;
 struct edge *	edge_array;
 
-	nedges = build_euclidean_edges (pts, &edge_array);
+	nedges = build_euclidean_edges (pts, nthreads, &edge_array);
 
 	mst_edge_count = _gst_mst_edge_list (pts -> n,
 					     nedges,
@@ -149,6 +170,7 @@ struct edge *	edge_array;
 build_euclidean_edges (
 
 struct pset *		pts,		/* IN - set of points */
+int			nthreads,	/* IN - number of threads to use */
 struct edge **		edges_out	/* OUT - edge list */
 )
 {
@@ -255,8 +277,9 @@ struct edge *		zedges;
 
 	free (dflags);
 
-	_gst_delaunay_triangulation (
+	_gst_parallel_delaunay_triangulation (
 				newpts,
+				nthreads,
 				&numberofedges,
 				&edgelist,
 				NULL, 
@@ -281,14 +304,46 @@ struct edge *		zedges;
 		p1 = &(pts -> a [i]);
 		p2 = &(pts -> a [j]);
 
-		edges -> len	= EDIST (p1, p2);
-		edges -> p1	= i;
-		edges -> p2	= j;
-		++edges;
+		edges [k].len	= EDIST (p1, p2);
+		edges [k].p1	= (i < j) ? i : j;
+		edges [k].p2	= (i < j) ? j : i;
 	}
 
+	/* The order and orientation of the edges depend on how many	*/
+	/* threads computed the triangulation.  Put them in canonical	*/
+	/* order, so that the MST (and all that is derived from it)	*/
+	/* does not depend on the number of threads.			*/
+	qsort (edges, nedges, sizeof (struct edge), comp_edge_ends);
+
 	free (edgelist);
 	free (orig_vnum);
 
 	return (nedges + ndup);
 }
+
+/*
+ * Order edges by their first endpoint, then by their second endpoint.
+ */
+
+	static
+	int
+comp_edge_ends (
+
+const void *		p1,
+const void *		p2
+)
+{
+const struct edge *	a;
+const struct edge *	b;
+
+	a = (const struct edge *) p1;
+	b = (const struct edge *) p2;
+
+	if (a -> p1 NE b -> p1) {
+		return ((a -> p1 < b -> p1) ? -1 : 1);
+	}
+	if (a -> p2 NE b -> p2) {
+		return ((a -> p2 < b -> p2) ? -1 : 1);
+	}
+	return (0);
+}
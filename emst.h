@@ -32,6 +32,9 @@ struct edge;
 struct pset;
 
 extern int	_gst_euclidean_mst (struct pset * pts, struct edge * edges);
+extern int	_gst_parallel_euclidean_mst (struct pset *	pts,
+					     int		nthreads,
+					     struct edge *	edges);
 extern dist_t	_gst_euclidean_mst_length (struct pset * pts);
 
 #endif
@@ -364,10 +364,6 @@ CPXENVptr	envp	/* IN - CPLEX environment pointer */
 		gst_env -> solver_open	= TRUE;
 	}
 #endif
-#ifdef LPSOLVE
-	/* GeoSteiner is compiled to use lp_solve. */
-	FATAL_ERROR;
-#endif
 
 	GST_POSTLUDE
 }
@@ -387,10 +383,6 @@ CPXENVptr tmp;
 	gst_env -> cplex_status = CPLEX_UNATTACHED;
 	gst_env -> solver_open = FALSE;
 #endif
-#ifdef LPSOLVE
-	/* GeoSteiner is compiled to use lp_solve. */
-	FATAL_ERROR;
-#endif
 
 	GST_POSTLUDE
 	return tmp;
@@ -37,6 +37,7 @@
 #include "expand.h"
 
 #include "bb.h"
+#include "bitmap.h"
 #include "constrnt.h"
 #include "fatal.h"
 #include "logic.h"
@@ -129,8 +130,6 @@ int			ccount;
 int			nedges;
 int			kmasks;
 struct rcoef *		orig_cp;
-bitmap_t *		bp1;
-bitmap_t		mask;
 int *			vp1;
 int *			vp2;
 
@@ -141,8 +140,7 @@ int *			vp2;
 	switch (lcp -> type) {
 	case CT_CUTSET:
 		/* We are given a set F of full sets... */
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (lcp -> mask, i)) continue;
+		FOR_EACH_SETBIT (i, lcp -> mask, nedges) {
 			if (NOT BITON (edge_mask, i)) continue;
 			cp -> var = i + RC_VAR_BASE;
 			cp -> val = 1.0;
@@ -159,13 +157,8 @@ int *			vp2;
 	case CT_SUBTOUR:
 		/* We are given a set S of terminals...  Get size */
 		/* of subtour - 1... */
-		ssize = -1;
-		bp1 = &(lcp -> mask [0]);
 		kmasks = cip -> num_vert_masks;
-		for (i = 0; i < kmasks; i++) {
-			mask = *bp1++;
-			ssize += NBITSON (mask);
-		}
+		ssize = _gst_bitmap_count (lcp -> mask, kmasks * BPW) - 1;
 		/* Compute coefficients of the subtour constraint.  At	*/
 		/* the same time, count the number of non-zeros in the	*/
 		/* complementary representation of the constraint	*/
@@ -190,7 +183,7 @@ int *			vp2;
 				++ccount;
 			}
 			else {
-				if (isize < cip -> edge_size [i] - 1) {
+				if (isize < cip -> edge_size [j] - 1) {
 					/* Edge is partly in subtour and */
 					/* partly in the complement. */
 					++ccount;
@@ -274,8 +267,6 @@ int			isize;
 int			nedges;
 int			kmasks;
 struct rcoef *		orig_cp;
-bitmap_t *		bp1;
-bitmap_t		mask;
 int *			vp1;
 int *			vp2;
 
@@ -285,8 +276,7 @@ int *			vp2;
 	case CT_CUTSET:
 		orig_cp = cp;
 		/* We are given a set F of full sets... */
-		for (i = 0; i < nedges; i++) {
-			if (NOT BITON (lcp -> mask, i)) continue;
+		FOR_EACH_SETBIT (i, lcp -> mask, nedges) {
 			if (NOT BITON (edge_mask, i)) continue;
 			cp -> var = i + RC_VAR_BASE;
 			cp -> val = 1.0;
@@ -303,13 +293,8 @@ int *			vp2;
 	case CT_SUBTOUR:
 		/* We are given a set S of terminals...  Get size */
 		/* of subtour - 1... */
-		ssize = -1;
-		bp1 = &(lcp -> mask [0]);
 		kmasks = cip -> num_vert_masks;
-		for (i = 0; i < kmasks; i++) {
-			mask = *bp1++;
-			ssize += NBITSON (mask);
-		}
+		ssize = _gst_bitmap_count (lcp -> mask, kmasks * BPW) - 1;
 		for (j = 0; j < nedges; j++) {
 			if (NOT BITON (edge_mask, j)) continue;
 			vp1 = cip -> edge [j];
@@ -135,6 +135,9 @@ extern "C" {
 #define GST_PARAM_INITIAL_PRIMAL_HEURISTIC                1039
 #define GST_PARAM_INITIAL_PRIMAL_HEUR_STOP                1040
 #define GST_PARAM_LOCALCUTS_TRACE_STYLE                   1041
+#define GST_PARAM_GC_SLICE_ROWS                           1042
+#define GST_PARAM_NUM_THREADS                             1043
+#define GST_PARAM_EFST_TILE_SIZE                          1044
 #define GST_PARAM_INITIAL_UPPER_BOUND                     2000
 #define GST_PARAM_LOCAL_CUTS_VERTEX_THRESHOLD             2001
 #define GST_PARAM_CPU_TIME_LIMIT                          2002
@@ -142,8 +145,10 @@ extern "C" {
 #define GST_PARAM_UPPER_BOUND_TARGET                      2004
 #define GST_PARAM_LOWER_BOUND_TARGET                      2005
 #define GST_PARAM_CHECKPOINT_INTERVAL                     2006
+#define GST_PARAM_EFST_TILE_OVERLAP                       2007
 #define GST_PARAM_CHECKPOINT_FILENAME                     3000
 #define GST_PARAM_MERGE_CONSTRAINT_FILES                  3001
+#define GST_PARAM_LP_SOLVER                               3002
 #define GST_PARAM_DETAILED_TIMINGS_CHANNEL                4000
 #define GST_PARAM_PRINT_SOLVE_TRACE                       4001
 
@@ -172,6 +177,7 @@ extern "C" {
 #define GST_PVAL_BSD_METHOD_DYNAMIC                     0
 #define GST_PVAL_BSD_METHOD_CONSTANT                    1
 #define GST_PVAL_BSD_METHOD_LOGARITHMIC                 2
+#define GST_PVAL_BSD_METHOD_LCA                         3
 
 /* For GST_PARAM_LP_SOLVE_PERTURB */
 #define GST_PVAL_LP_SOLVE_PERTURB_DISABLE               0
@@ -252,6 +258,7 @@ extern "C" {
 #define GST_PVAL_SAVE_FORMAT_VERSION2                   2
 #define GST_PVAL_SAVE_FORMAT_VERSION3                   3
 #define GST_PVAL_SAVE_FORMAT_STEINLIB_INT               4
+#define GST_PVAL_SAVE_FORMAT_BINARY                     5
 
 /* For GST_PARAM_GRID_OVERLAY */
 #define GST_PVAL_GRID_OVERLAY_DISABLE                   0
@@ -1923,6 +1930,86 @@ gst_hg_ptr
 
 /****************************************/
 
+/*
+ * gst_generate_efsts_streamed
+ * 
+ * Same as gst_generate_efsts(), except that the FSTs are not
+ * kept in the hypergraph.  Instead, each FST is handed to a function
+ * supplied by the caller as soon as it is known to be final, and is
+ * freed right after.  The memory used therefore does not grow with the
+ * total number of FSTs generated.  The FSTs are numbered and handed out
+ * in the same order in which gst_generate_efsts() would store
+ * them.  The hypergraph returned contains the terminals, but no edges.
+ * 
+ * The function is called with the number of the FST, its length, its
+ * terminals (indices into the original terminal array), its Steiner
+ * points (in an array of doubles, as for the terminals) and its edges
+ * (pairs of endpoint indices).  An edge endpoint less than nverts is a
+ * position in the terminal list of the FST, and any other endpoint
+ * denotes Steiner point number (endpoint - nverts).  All arrays belong
+ * to the generator and are only valid during the call.
+ */
+
+/* Function type for receiving streamed FSTs */
+#define GST_FST_CALLBACK_ARGS \
+	int edge_number, double weight, \
+	int nverts, const int * verts, \
+	int nsps, const double * coords, \
+	int nedges, const int * edges, \
+	void * cb_data
+typedef void gst_fst_callback_func_t (GST_FST_CALLBACK_ARGS);
+
+gst_hg_ptr
+    gst_generate_efsts_streamed (int                       nterms,
+                                 double*                   terms,
+                                 gst_param_ptr             param,
+                                 gst_fst_callback_func_t*  fst_func,
+                                 void*                     fst_data,
+                                 int*                      status);
+
+/*
+ * Returns a hypergraph structure with the terminals, but no FSTs.
+ */
+
+/****************************************/
+
+/*
+ * gst_update_efsts
+ * 
+ * Update the Euclidean FSTs of a hypergraph obtained from
+ * gst_generate_efsts() after some of its terminals have been
+ * inserted, deleted or moved, without generating all FSTs anew.  Each
+ * new terminal is either an old terminal, possibly moved, or an inserted
+ * one.  Old terminals that no new terminal refers to are deleted.  The
+ * old FSTs are kept, with their terminals renumbered, unless one of
+ * their terminals changed, a changed position lies near them, or the MST
+ * path between two of their terminals changed (and with it their
+ * bottleneck Steiner distance).  The FSTs near the changes are
+ * regenerated from the terminals within the halo width given by
+ * parameter GST_PARAM_EFST_TILE_OVERLAP (in units of the
+ * mean MST edge length), and every MST edge is always present.  The
+ * result is only an approximation of the FSTs that
+ * gst_generate_efsts() would produce: an FST reaching further
+ * than the halo width may be missed, and a regenerated FST that only a
+ * terminal beyond the halo would prune may be kept.  Use
+ * gst_generate_efsts() when the exact set of FSTs is needed.
+ * The old hypergraph is not changed.
+ */
+
+gst_hg_ptr
+    gst_update_efsts (gst_hg_ptr     old_hg,
+                      int            nterms,
+                      double*        terms,
+                      int*           old_index,
+                      gst_param_ptr  param,
+                      int*           status);
+
+/*
+ * Returns the updated FSTs in a new hypergraph structure.
+ */
+
+/****************************************/
+
 /*
  * gst_generate_rfsts
  * 
@@ -2806,6 +2893,10 @@ int gst_free_scale_info (gst_scale_info_ptr scinfo);
  * attempts to find an appropriate scaling for the points to
  * maximize the accuracy of the internal (double) representation. If the
  * scaling information object is NULL, no scaling is performed.
+ * 
+ * The file may instead be in the binary format written by
+ * bulk_points -b: a header followed by the x, y and battery
+ * values of each point as native doubles.  Such points are not scaled.
  */
 
 int gst_get_points (FILE*               fp,
@@ -2913,6 +3004,58 @@ int gst_save_hg (FILE*          fp,
  * otherwise. 
  */
 
+/****************************************/
+
+/*
+ * gst_save_streamed_hg_header
+ * 
+ * Print the beginning of a hypergraph file, up to where the hyperedges
+ * start, when the hyperedges themselves are printed separately using
+ * gst_save_streamed_fst().  Together, these functions can
+ * write the FSTs generated by gst_generate_efsts_streamed().
+ * Only the print formats GST_PVAL_SAVE_FORMAT_VERSION2 and
+ * GST_PVAL_SAVE_FORMAT_VERSION3 of parameter
+ * GST_PARAM_SAVE_FORMAT are supported.
+ */
+
+int gst_save_streamed_hg_header (FILE*          fp,
+                                 gst_hg_ptr     H,
+                                 int            nedges,
+                                 gst_param_ptr  param);
+
+/*
+ * Returns zero if the operation was successful and non-zero
+ * otherwise.
+ */
+
+/****************************************/
+
+/*
+ * gst_save_streamed_fst
+ * 
+ * Print a single FST as a hyperedge of a hypergraph file whose header
+ * is printed by gst_save_streamed_hg_header().  The arguments
+ * describing the FST are the same as those given to the function
+ * passed to gst_generate_efsts_streamed().  The hyperedge is
+ * printed without incompatibility information.
+ */
+
+int gst_save_streamed_fst (FILE*               fp,
+                           int                 nverts,
+                           const int*          verts,
+                           double              weight,
+                           int                 nsps,
+                           const double*       coords,
+                           int                 nedges,
+                           const int*          edges,
+                           gst_scale_info_ptr  scinfo,
+                           gst_param_ptr       param);
+
+/*
+ * Returns zero if the operation was successful and non-zero
+ * otherwise.
+ */
+
 /****************************************************************/
 
 /*
@@ -12,7 +12,7 @@
 
 ************************************************************************
 
-	Implementation of greedy O(n^2) heuristic for
+	Implementation of greedy heuristic for
 	computing Euclidean Steiner trees
 	(Algorithmica 25, 418-437, 1999)
 
@@ -46,6 +46,7 @@
 #include "dt.h"
 #include "efuncs.h"
 #include "emst.h"
+#include "fatal.h"
 #include <float.h>
 #include "logic.h"
 #include "memory.h"
@@ -81,11 +82,63 @@ struct greedy_fst {
 	bool		chosen; /* Is this FST chosen by the algorithm? */
 };
 
+/*
+ * The current tree, and the data used to try inserting FSTs into it.
+ * The elements of the tree are the FSTs and edges: element e < nfsts
+ * is FST e, and otherwise it is edge e - nfsts.  The elements incident
+ * to each terminal are kept in a linked list of incidences.
+ */
+
+struct greedy_tree {
+	int			n;		/* Number of terminals */
+	struct greedy_fst *	fsts;		/* The FSTs */
+	int			nfsts;		/* Number of FSTs */
+	int *			sortedfsts;	/* FSTs in order of ratio */
+	struct greedy_edge *	edges;		/* The edges */
+	int			nedges;		/* Number of edges */
+	int *			sortededges;	/* Edges in order of length */
+	int *			rank;		/* Position of each element in */
+						/* the order of insertion */
+	int *			adj_start;	/* Start of each terminal's */
+						/* edges in adj_edge */
+	int *			adj_edge;	/* Edges incident to terminals */
+	int *			inc_first;	/* First incidence of terminal */
+	int *			inc_next;	/* Next incidence in list */
+	int *			inc_elem;	/* Element of incidence */
+	int			inc_free;	/* Free list of incidences */
+	bool *			in_tree;	/* Is element in the tree? */
+	int			stamp;		/* Number of current attempt */
+	int *			elem_stamp;	/* Element is on a path */
+	int *			seen;		/* Terminal seen by search */
+	int *			on_path;	/* Terminal is on a path */
+	int *			in_region;	/* Terminal is in the region */
+	int *			par_elem;	/* Element leading to terminal */
+	int *			par_vert;	/* Terminal it was reached from */
+	int *			piece;		/* Region terminal whose subtree */
+						/* contains terminal */
+	int *			queue;		/* Search queue */
+	int *			verts;		/* Terminals of the region */
+	int *			old_elems;	/* Elements on the paths */
+	int *			new_elems;	/* Elements replacing them */
+	int *			keys;		/* Ranks of candidate elements */
+	struct dsuf		sets;		/* For reconnecting the region */
+	dist_t			total;		/* Length of the tree */
+};
+
+/*
+ * Maximum number of terminals searched when trying to insert an FST.
+ * The improvement phase then takes linear time, instead of the
+ * quadratic time of rebuilding the entire tree for each FST.
+ */
+
+#define MAX_REGION	500
+
 
 /*
  * Local Routines
  */
 
+static void		add_element (struct greedy_tree *, int);
 static void		add_fst (struct pset *		pts,
 				 int *			terms,
 				 int			term_count,
@@ -97,6 +150,25 @@ static dist_t		fst_length (struct pset *, int *, int);
 static dist_t		mst_length (struct pset *, int *, int);
 static int		compare_edge_length (int, int, void *);
 static int		compare_fst_ratio (int, int, void *);
+static int		compare_keys (int, int, void *);
+static dist_t		element_cost (struct greedy_tree *, int);
+static int		element_terms (struct greedy_tree *, int, int *);
+static void		free_tree (struct greedy_tree *);
+static void		init_tree (struct greedy_tree *,
+				   int,
+				   struct greedy_fst *,
+				   int,
+				   int *,
+				   struct greedy_edge *,
+				   int,
+				   int *);
+static bool		reached_by_search (struct greedy_tree *,
+					   int,
+					   int,
+					   int);
+static bool		rebuild_with_fst (struct greedy_tree *, int);
+static void		remove_element (struct greedy_tree *, int);
+static bool		try_insert_fst (struct greedy_tree *, int);
 
 
 
@@ -328,7 +400,6 @@ int *			neighborlist;
 int *			triangleedges;
 int *			sortededges;
 int *			sortedfsts;
-bool *			new_chosen;
 bool			convex_region;
 bool			in_same_block;
 dist_t			mst_l, mst_l1, total_mst_l;
@@ -338,6 +409,7 @@ struct dsuf		mstsets, fstsets;
 struct pset *		pts;
 struct greedy_edge  *	greedy_edges;
 struct greedy_fst  *	greedy_fsts;
+struct greedy_tree	gi;
 
 	/* Special cases */
 
@@ -590,90 +662,79 @@ struct greedy_fst  *	greedy_fsts;
 	   2. Insert not yet tried FSTs into existing tree
 	*/
 
-	new_chosen = NEWA (fst_count, bool);
-	best_smt_l = INF_DISTANCE;
-	for (k = -1; k < fst_count; k++) { /* k=-1 means use MST FSTs */
-
-		/* Check that FST is not already in current tree */
-
-		if ((k >= 0) AND greedy_fsts [ sortedfsts[k] ].chosen) continue;
+	init_tree (&gi,
+		   pts -> n,
+		   greedy_fsts,
+		   fst_count,
+		   sortedfsts,
+		   greedy_edges,
+		   numberofedges,
+		   sortededges);
+
+	/* Build union-find structure */
+	_gst_dsuf_create (&fstsets, pts -> n);
+	for (i = 0; i < pts -> n; i++) {
+		_gst_dsuf_makeset (&fstsets, i);
+	}
 
-		/* Build union-find structure */
-		_gst_dsuf_create (&fstsets, pts -> n);
-		for (i = 0; i < pts -> n; i++) {
-			_gst_dsuf_makeset (&fstsets, i);
+	/* Go through chosen FSTs (in sorted order) */
+	total_smt_l = 0.0;
+	for (i = 0; i < fst_count; i++) {
+		fi = sortedfsts [i];
+		if (NOT greedy_fsts [fi].chosen) continue;
+		term_count = greedy_fsts [fi].count;
+
+		/* check that no two terminals are in the same block */
+		in_same_block = FALSE;
+		for (j = 0; j < term_count; j++) {
+			root [j] = _gst_dsuf_find (&fstsets, greedy_fsts [fi].p [j]);
 		}
-
-		for (i = 0; i < fst_count; i++)
-			new_chosen[i] = greedy_fsts[i].chosen;
-
-		if (k >= 0) {
-			/* Insert FST number k */
-			fk = sortedfsts [k];
-			term_count = greedy_fsts [fk].count;
-
-			for (j = 1; j < term_count; j++) {
-				_gst_dsuf_unite (&fstsets,
-						 _gst_dsuf_find (&fstsets, greedy_fsts [fk].p [0]),
-						 _gst_dsuf_find (&fstsets, greedy_fsts [fk].p [j]));
-			}
-			total_smt_l = greedy_fsts [fk].len;
-			new_chosen[fk] = TRUE;
-		}
-		else
-			total_smt_l = 0.0;
-
-		/* Go through chosen FSTs (in sorted order) */
-		for (i = 0; i < fst_count; i++) {
-			fi = sortedfsts [i];
-			if (NOT greedy_fsts [fi].chosen) continue;
-			term_count = greedy_fsts [fi].count;
-
-			/* check that no two terminals are in the same block */
-			in_same_block = FALSE;
-			for (j = 0; j < term_count; j++) {
-				root [j] = _gst_dsuf_find (&fstsets, greedy_fsts [fi].p [j]);
-			}
-			for (j = 0; j < term_count-1; j++) {
-				for (jj = j+1; jj < term_count; jj++) {
-					if (root [j] EQ root [jj]) {
-						in_same_block = TRUE;
-						break;
-					}
+		for (j = 0; j < term_count-1; j++) {
+			for (jj = j+1; jj < term_count; jj++) {
+				if (root [j] EQ root [jj]) {
+					in_same_block = TRUE;
+					break;
 				}
 			}
-			if (in_same_block) {
-				new_chosen [fi] = FALSE;
-				continue;
-			}
-			for (j = 1; j < term_count; j++) {
-				_gst_dsuf_unite (&fstsets,
-						 _gst_dsuf_find (&fstsets, greedy_fsts [fi].p [0]),
-						 _gst_dsuf_find (&fstsets, greedy_fsts [fi].p [j]));
-			}
-			total_smt_l += greedy_fsts [fi].len;
-		}
-
-		/* Go through edges in sorted order */
-		for (i = 0; i < numberofedges; i++) {
-			ei = sortededges [i];
-			root [1] = _gst_dsuf_find (&fstsets, greedy_edges [ei].p1);
-			root [2] = _gst_dsuf_find (&fstsets, greedy_edges [ei].p2);
-			if (root [1] NE root [2]) {
-				_gst_dsuf_unite (&fstsets, root [1], root [2]);
-				/* Use BSD length here */
-				total_smt_l += greedy_edges [ei].bsd;
-			}
 		}
-		_gst_dsuf_destroy (&fstsets);
+		if (in_same_block) continue;
 
-		if (total_smt_l < best_smt_l) {
-			best_smt_l = total_smt_l;
-			for (i = 0; i < fst_count; i++)
-				greedy_fsts [i].chosen = new_chosen [i];
+		for (j = 1; j < term_count; j++) {
+			_gst_dsuf_unite (&fstsets,
+					 _gst_dsuf_find (&fstsets, greedy_fsts [fi].p [0]),
+					 _gst_dsuf_find (&fstsets, greedy_fsts [fi].p [j]));
 		}
+		total_smt_l += greedy_fsts [fi].len;
+		add_element (&gi, fi);
+	}
+
+	/* Go through edges in sorted order */
+	for (i = 0; i < numberofedges; i++) {
+		ei = sortededges [i];
+		root [1] = _gst_dsuf_find (&fstsets, greedy_edges [ei].p1);
+		root [2] = _gst_dsuf_find (&fstsets, greedy_edges [ei].p2);
+		if (root [1] NE root [2]) {
+			_gst_dsuf_unite (&fstsets, root [1], root [2]);
+			/* Use BSD length here */
+			total_smt_l += greedy_edges [ei].bsd;
+			add_element (&gi, fst_count + ei);
+		}
+	}
+	_gst_dsuf_destroy (&fstsets);
 
+	/* Now try to insert each of the other FSTs (in sorted order). */
+	/* Each insertion only changes the tree along the paths that	*/
+	/* join the terminals of the FST, so we try it locally.		*/
+
+	gi.total = total_smt_l;
+	for (k = 0; k < fst_count; k++) {
+		fk = sortedfsts [k];
+		if (gi.in_tree [fk]) continue;
+		(void) try_insert_fst (&gi, fk);
 	}
+	best_smt_l = gi.total;
+
+	free_tree (&gi);
 
 	/* Free all allocated arrays, including those allocated by Triangle */
 
@@ -687,7 +748,679 @@ struct greedy_fst  *	greedy_fsts;
 	free (greedy_fsts);
 	free (sortededges);
 	free (sortedfsts);
-	free (new_chosen);
 
 	return (best_smt_l);
 }
+
+/*
+ * Set up the (initially empty) tree, and the other data used to try
+ * inserting FSTs into it.
+ */
+
+	static
+	void
+init_tree (
+
+struct greedy_tree *	gtp,		/* OUT - the tree */
+int			n,		/* IN - number of terminals */
+struct greedy_fst *	fsts,		/* IN - the FSTs */
+int			nfsts,		/* IN - number of FSTs */
+int *			sortedfsts,	/* IN - FSTs in order of ratio */
+struct greedy_edge *	edges,		/* IN - the edges */
+int			nedges,		/* IN - number of edges */
+int *			sortededges	/* IN - edges in order of length */
+)
+{
+int			i;
+int			nelems;
+
+	nelems = nfsts + nedges;
+
+	gtp -> n		= n;
+	gtp -> fsts		= fsts;
+	gtp -> nfsts		= nfsts;
+	gtp -> sortedfsts	= sortedfsts;
+	gtp -> edges		= edges;
+	gtp -> nedges		= nedges;
+	gtp -> sortededges	= sortededges;
+
+	/* Rank of each element in the order used when building the	*/
+	/* tree: FSTs by ratio, followed by edges by length.		*/
+	gtp -> rank = NEWA (nelems, int);
+	for (i = 0; i < nfsts; i++) {
+		gtp -> rank [sortedfsts [i]] = i;
+	}
+	for (i = 0; i < nedges; i++) {
+		gtp -> rank [nfsts + sortededges [i]] = nfsts + i;
+	}
+
+	/* Edges incident to each terminal. */
+	gtp -> adj_start = NEWA (n + 1, int);
+	gtp -> adj_edge	 = NEWA (2 * nedges, int);
+	for (i = 0; i <= n; i++) {
+		gtp -> adj_start [i] = 0;
+	}
+	for (i = 0; i < nedges; i++) {
+		++(gtp -> adj_start [edges [i].p1 + 1]);
+		++(gtp -> adj_start [edges [i].p2 + 1]);
+	}
+	for (i = 0; i < n; i++) {
+		gtp -> adj_start [i + 1] += gtp -> adj_start [i];
+	}
+	for (i = 0; i < nedges; i++) {
+		gtp -> adj_edge [gtp -> adj_start [edges [i].p1]++] = i;
+		gtp -> adj_edge [gtp -> adj_start [edges [i].p2]++] = i;
+	}
+	for (i = n; i > 0; i--) {
+		gtp -> adj_start [i] = gtp -> adj_start [i - 1];
+	}
+	gtp -> adj_start [0] = 0;
+
+	/* The elements of a tree spanning N terminals have at most	*/
+	/* 2*(N-1) incidences.						*/
+	gtp -> inc_first = NEWA (n, int);
+	gtp -> inc_next	 = NEWA (2 * n, int);
+	gtp -> inc_elem	 = NEWA (2 * n, int);
+	for (i = 0; i < n; i++) {
+		gtp -> inc_first [i] = -1;
+	}
+	for (i = 0; i < 2 * n; i++) {
+		gtp -> inc_next [i] = i + 1;
+	}
+	gtp -> inc_next [2 * n - 1] = -1;
+	gtp -> inc_free = 0;
+
+	gtp -> in_tree	  = NEWA (nelems, bool);
+	gtp -> elem_stamp = NEWA (nelems, int);
+	for (i = 0; i < nelems; i++) {
+		gtp -> in_tree [i]    = FALSE;
+		gtp -> elem_stamp [i] = 0;
+	}
+
+	gtp -> seen	  = NEWA (n, int);
+	gtp -> on_path	  = NEWA (n, int);
+	gtp -> in_region  = NEWA (n, int);
+	for (i = 0; i < n; i++) {
+		gtp -> seen [i]	     = 0;
+		gtp -> on_path [i]   = 0;
+		gtp -> in_region [i] = 0;
+	}
+	gtp -> stamp = 0;
+
+	gtp -> par_elem	 = NEWA (n, int);
+	gtp -> par_vert	 = NEWA (n, int);
+	gtp -> piece	 = NEWA (n, int);
+	gtp -> queue	 = NEWA (n, int);
+	gtp -> verts	 = NEWA (n, int);
+	gtp -> old_elems = NEWA (n, int);
+	gtp -> new_elems = NEWA (n, int);
+	gtp -> keys	 = NEWA (nelems, int);
+
+	_gst_dsuf_create (&(gtp -> sets), n);
+
+	gtp -> total = 0.0;
+}
+
+/*
+ * Free the tree.
+ */
+
+	static
+	void
+free_tree (
+
+struct greedy_tree *	gtp		/* IN - the tree */
+)
+{
+	_gst_dsuf_destroy (&(gtp -> sets));
+
+	free (gtp -> keys);
+	free (gtp -> new_elems);
+	free (gtp -> old_elems);
+	free (gtp -> verts);
+	free (gtp -> queue);
+	free (gtp -> piece);
+	free (gtp -> par_vert);
+	free (gtp -> par_elem);
+	free (gtp -> in_region);
+	free (gtp -> on_path);
+	free (gtp -> seen);
+	free (gtp -> elem_stamp);
+	free (gtp -> in_tree);
+	free (gtp -> inc_elem);
+	free (gtp -> inc_next);
+	free (gtp -> inc_first);
+	free (gtp -> adj_edge);
+	free (gtp -> adj_start);
+	free (gtp -> rank);
+}
+
+/*
+ * Get the terminals of a tree element.  Element e < nfsts is FST e;
+ * otherwise it is edge e - nfsts.  Returns the number of terminals.
+ */
+
+	static
+	int
+element_terms (
+
+struct greedy_tree *	gtp,		/* IN - the tree */
+int			e,		/* IN - element */
+int *			terms		/* OUT - its terminals */
+)
+{
+int			j;
+struct greedy_fst *	fp;
+struct greedy_edge *	ep;
+
+	if (e < gtp -> nfsts) {
+		fp = &(gtp -> fsts [e]);
+		for (j = 0; j < fp -> count; j++) {
+			terms [j] = fp -> p [j];
+		}
+		return (fp -> count);
+	}
+
+	ep = &(gtp -> edges [e - gtp -> nfsts]);
+	terms [0] = ep -> p1;
+	terms [1] = ep -> p2;
+
+	return (2);
+}
+
+/*
+ * Get the cost of a tree element.  Edges cost their BSD length.
+ */
+
+	static
+	dist_t
+element_cost (
+
+struct greedy_tree *	gtp,		/* IN - the tree */
+int			e		/* IN - element */
+)
+{
+	if (e < gtp -> nfsts) {
+		return (gtp -> fsts [e].len);
+	}
+	return (gtp -> edges [e - gtp -> nfsts].bsd);
+}
+
+/*
+ * Add an element to the tree.
+ */
+
+	static
+	void
+add_element (
+
+struct greedy_tree *	gtp,		/* IN/OUT - the tree */
+int			e		/* IN - element to add */
+)
+{
+int			j;
+int			k;
+int			count;
+int			terms [4];
+
+	count = element_terms (gtp, e, terms);
+	for (j = 0; j < count; j++) {
+		k = gtp -> inc_free;
+		FATAL_ERROR_IF (k < 0);
+		gtp -> inc_free = gtp -> inc_next [k];
+		gtp -> inc_elem [k] = e;
+		gtp -> inc_next [k] = gtp -> inc_first [terms [j]];
+		gtp -> inc_first [terms [j]] = k;
+	}
+	gtp -> in_tree [e] = TRUE;
+}
+
+/*
+ * Remove an element from the tree.
+ */
+
+	static
+	void
+remove_element (
+
+struct greedy_tree *	gtp,		/* IN/OUT - the tree */
+int			e		/* IN - element to remove */
+)
+{
+int			j;
+int			k;
+int			count;
+int *			hookp;
+int			terms [4];
+
+	count = element_terms (gtp, e, terms);
+	for (j = 0; j < count; j++) {
+		hookp = &(gtp -> inc_first [terms [j]]);
+		for (;;) {
+			k = *hookp;
+			FATAL_ERROR_IF (k < 0);
+			if (gtp -> inc_elem [k] EQ e) break;
+			hookp = &(gtp -> inc_next [k]);
+		}
+		*hookp = gtp -> inc_next [k];
+		gtp -> inc_next [k] = gtp -> inc_free;
+		gtp -> inc_free = k;
+	}
+	gtp -> in_tree [e] = FALSE;
+}
+
+/*
+ * Try to insert FST k into the tree.  Doing so closes cycles through
+ * the tree paths that join the terminals of k.  Let the region be the
+ * terminals of the elements on these paths.  Removing these elements
+ * splits the tree into one subtree per terminal of the region.  We
+ * reconnect the subtrees greedily, exactly as the tree was built: FST
+ * k first, then the removed FSTs in order of ratio, and then the edges
+ * between different subtrees in order of length.  If this is shorter
+ * than the elements removed, the tree is updated.  Only the MAX_REGION
+ * terminals nearest to FST k in the tree are searched.  If the
+ * subtrees might also be joined by an edge beyond the search that
+ * would have been used, the whole tree is rebuilt instead, so the
+ * result is always the same as rebuilding it.
+ * Returns TRUE if FST k was inserted.
+ */
+
+	static
+	bool
+try_insert_fst (
+
+struct greedy_tree *	gtp,		/* IN/OUT - the tree */
+int			k		/* IN - FST to insert */
+)
+{
+int			i;
+int			j;
+int			e;
+int			v;
+int			w;
+int			root;
+int			head;
+int			tail;
+int			count;
+int			found;
+int			last;
+int			nverts;
+int			nold;
+int			nnew;
+int			nkeys;
+int			nunions;
+int			stamp;
+int *			order;
+int			r [4];
+int			terms [4];
+bool			ok;
+dist_t			old_cost;
+dist_t			new_cost;
+struct greedy_fst *	fp;
+
+	fp = &(gtp -> fsts [k]);
+
+	stamp = ++(gtp -> stamp);
+
+	/* Breadth-first search of the tree from the first terminal	*/
+	/* of FST k, visiting up to MAX_REGION terminals.		*/
+
+	root = fp -> p [0];
+	gtp -> seen [root]     = stamp;
+	gtp -> par_elem [root] = -1;
+	gtp -> par_vert [root] = -1;
+	gtp -> queue [0] = root;
+	head = 0;
+	tail = 1;
+	found = 1;
+	while ((head < tail) AND (tail < MAX_REGION)) {
+		v = gtp -> queue [head++];
+		for (i = gtp -> inc_first [v]; i >= 0; i = gtp -> inc_next [i]) {
+			e = gtp -> inc_elem [i];
+			if (e EQ gtp -> par_elem [v]) continue;
+			count = element_terms (gtp, e, terms);
+			for (j = 0; j < count; j++) {
+				w = terms [j];
+				if (gtp -> seen [w] EQ stamp) continue;
+				gtp -> seen [w]	    = stamp;
+				gtp -> par_elem [w] = e;
+				gtp -> par_vert [w] = v;
+				gtp -> queue [tail++] = w;
+			}
+		}
+		if (found < fp -> count) {
+			found = 0;
+			for (j = 0; j < fp -> count; j++) {
+				if (gtp -> seen [fp -> p [j]] EQ stamp) {
+					++found;
+				}
+			}
+		}
+	}
+	if (found < fp -> count) {
+		/* Terminals of FST k are too far apart in the tree. */
+		return (rebuild_with_fst (gtp, k));
+	}
+
+	/* Gather the elements on the paths, and their terminals. */
+
+	gtp -> on_path [root] = stamp;
+	nold = 0;
+	nverts = 0;
+	old_cost = 0.0;
+	for (j = 1; j < fp -> count; j++) {
+		for (w = fp -> p [j];
+		     gtp -> on_path [w] NE stamp;
+		     w = gtp -> par_vert [w]) {
+			gtp -> on_path [w] = stamp;
+			e = gtp -> par_elem [w];
+			if (gtp -> elem_stamp [e] EQ stamp) continue;
+			gtp -> elem_stamp [e] = stamp;
+			gtp -> old_elems [nold++] = e;
+			old_cost += element_cost (gtp, e);
+			count = element_terms (gtp, e, terms);
+			for (i = 0; i < count; i++) {
+				v = terms [i];
+				if (gtp -> in_region [v] EQ stamp) continue;
+				gtp -> in_region [v] = stamp;
+				gtp -> verts [nverts++] = v;
+			}
+		}
+	}
+
+	/* The candidates to reconnect the region: the FSTs removed,	*/
+	/* and all edges between terminals of the region, in the order	*/
+	/* in which the tree was built.					*/
+
+	for (i = 0; i < tail; i++) {
+		v = gtp -> queue [i];
+		if (gtp -> in_region [v] EQ stamp) {
+			gtp -> piece [v] = v;
+		}
+		else {
+			gtp -> piece [v] = gtp -> piece [gtp -> par_vert [v]];
+		}
+	}
+
+	nkeys = 0;
+	for (i = 0; i < nold; i++) {
+		e = gtp -> old_elems [i];
+		if (e < gtp -> nfsts) {
+			gtp -> keys [nkeys++] = gtp -> rank [e];
+		}
+	}
+	for (i = 0; i < tail; i++) {
+		v = gtp -> queue [i];
+		for (j = gtp -> adj_start [v]; j < gtp -> adj_start [v + 1]; j++) {
+			e = gtp -> adj_edge [j];
+			w = gtp -> edges [e].p1;
+			if (w EQ v) {
+				w = gtp -> edges [e].p2;
+			}
+			if ((w < v) AND
+			    (gtp -> seen [w] EQ stamp) AND
+			    (gtp -> piece [w] NE gtp -> piece [v])) {
+				gtp -> keys [nkeys++] = gtp -> rank [gtp -> nfsts + e];
+			}
+		}
+	}
+	order = _gst_heapsort (nkeys, gtp -> keys, compare_keys);
+
+	/* Reconnect greedily, starting with FST k. */
+
+	for (i = 0; i < nverts; i++) {
+		_gst_dsuf_makeset (&(gtp -> sets), gtp -> verts [i]);
+	}
+	for (j = 1; j < fp -> count; j++) {
+		_gst_dsuf_unite (&(gtp -> sets),
+				 _gst_dsuf_find (&(gtp -> sets), fp -> p [0]),
+				 _gst_dsuf_find (&(gtp -> sets), fp -> p [j]));
+	}
+	nunions = fp -> count - 1;
+	new_cost = fp -> len;
+	gtp -> new_elems [0] = k;
+	nnew = 1;
+	last = -1;
+
+	for (i = 0; (i < nkeys) AND (nunions < nverts - 1); i++) {
+		e = gtp -> keys [order [i]];
+		if (e < gtp -> nfsts) {
+			e = gtp -> sortedfsts [e];
+		}
+		else {
+			e = gtp -> nfsts + gtp -> sortededges [e - gtp -> nfsts];
+		}
+		count = element_terms (gtp, e, terms);
+
+		/* check that no two terminals are in the same block */
+		ok = TRUE;
+		for (j = 0; j < count; j++) {
+			terms [j] = gtp -> piece [terms [j]];
+			r [j] = _gst_dsuf_find (&(gtp -> sets), terms [j]);
+		}
+		for (j = 0; ok AND (j < count - 1); j++) {
+			for (v = j + 1; v < count; v++) {
+				if (r [j] EQ r [v]) {
+					ok = FALSE;
+					break;
+				}
+			}
+		}
+		if (NOT ok) continue;
+
+		for (j = 1; j < count; j++) {
+			_gst_dsuf_unite (&(gtp -> sets),
+					 _gst_dsuf_find (&(gtp -> sets), terms [0]),
+					 _gst_dsuf_find (&(gtp -> sets), terms [j]));
+		}
+		nunions += count - 1;
+		new_cost += element_cost (gtp, e);
+		gtp -> new_elems [nnew++] = e;
+		if (e >= gtp -> nfsts) {
+			last = gtp -> keys [order [i]];
+		}
+	}
+	free (order);
+
+	if ((head < tail) AND
+	    ((nunions < nverts - 1) OR
+	     ((last >= 0) AND
+	      (NOT reached_by_search (gtp, stamp, nverts, last))))) {
+		/* Edges beyond the search might have been used. */
+		return (rebuild_with_fst (gtp, k));
+	}
+
+	if ((nunions < nverts - 1) OR (new_cost >= old_cost)) {
+		return (FALSE);
+	}
+
+	/* Replace the elements on the paths. */
+
+	for (i = 0; i < nold; i++) {
+		remove_element (gtp, gtp -> old_elems [i]);
+	}
+	for (i = 0; i < nnew; i++) {
+		add_element (gtp, gtp -> new_elems [i]);
+	}
+	gtp -> total += new_cost - old_cost;
+
+	return (TRUE);
+}
+
+/*
+ * An edge (u,w) of the graph that is not in the tree is longer than
+ * all edges on the tree path from u to w.  If u and w lie in different
+ * subtrees of the region, this path leads through the region, so u
+ * and w can be reached from the region through FSTs, and edges ranked
+ * before (u,w).  Check that every terminal reached in this way from
+ * the region, through elements ranked before the given limit, was
+ * seen by the search.  If so, every edge joining the subtrees that
+ * is ranked before the limit was considered.
+ */
+
+	static
+	bool
+reached_by_search (
+
+struct greedy_tree *	gtp,		/* IN/OUT - the tree */
+int			stamp,		/* IN - number of the attempt */
+int			nverts,		/* IN - number of region terminals */
+int			limit		/* IN - rank limit */
+)
+{
+int			i;
+int			j;
+int			e;
+int			v;
+int			w;
+int			head;
+int			tail;
+int			count;
+int			mark;
+int			terms [4];
+
+	mark = ++(gtp -> stamp);
+
+	tail = 0;
+	for (i = 0; i < nverts; i++) {
+		v = gtp -> verts [i];
+		gtp -> on_path [v] = mark;
+		gtp -> queue [tail++] = v;
+	}
+	head = 0;
+	while (head < tail) {
+		v = gtp -> queue [head++];
+		for (i = gtp -> inc_first [v]; i >= 0; i = gtp -> inc_next [i]) {
+			e = gtp -> inc_elem [i];
+			if (gtp -> elem_stamp [e] EQ stamp) continue;
+			if (gtp -> rank [e] >= limit) continue;
+			count = element_terms (gtp, e, terms);
+			for (j = 0; j < count; j++) {
+				w = terms [j];
+				if (gtp -> on_path [w] EQ mark) continue;
+				if (gtp -> seen [w] NE stamp) return (FALSE);
+				gtp -> on_path [w] = mark;
+				gtp -> queue [tail++] = w;
+			}
+		}
+	}
+
+	return (TRUE);
+}
+
+/*
+ * Try to insert FST k into the tree by rebuilding the whole tree
+ * greedily: FST k first, then the FSTs of the tree in order of ratio,
+ * and then the edges in order of length.  If this is shorter, the new
+ * tree replaces the current one.  Returns TRUE if FST k was inserted.
+ */
+
+	static
+	bool
+rebuild_with_fst (
+
+struct greedy_tree *	gtp,		/* IN/OUT - the tree */
+int			k		/* IN - FST to insert */
+)
+{
+int			i;
+int			j;
+int			e;
+int			n;
+int			v;
+int			nnew;
+int			nunions;
+int			count;
+int			r [4];
+int			terms [4];
+bool			ok;
+dist_t			new_cost;
+
+	n = gtp -> n;
+
+	for (i = 0; i < n; i++) {
+		_gst_dsuf_makeset (&(gtp -> sets), i);
+	}
+
+	nnew = 0;
+	nunions = 0;
+	new_cost = 0.0;
+	for (i = -1; i < gtp -> nfsts + gtp -> nedges; i++) {
+		if (i < 0) {
+			e = k;
+		}
+		else if (i < gtp -> nfsts) {
+			e = gtp -> sortedfsts [i];
+			if (NOT gtp -> in_tree [e]) continue;
+		}
+		else {
+			e = gtp -> nfsts + gtp -> sortededges [i - gtp -> nfsts];
+		}
+		count = element_terms (gtp, e, terms);
+
+		/* check that no two terminals are in the same block */
+		ok = TRUE;
+		for (j = 0; j < count; j++) {
+			r [j] = _gst_dsuf_find (&(gtp -> sets), terms [j]);
+		}
+		for (j = 0; ok AND (j < count - 1); j++) {
+			for (v = j + 1; v < count; v++) {
+				if (r [j] EQ r [v]) {
+					ok = FALSE;
+					break;
+				}
+			}
+		}
+		if (NOT ok) continue;
+
+		for (j = 1; j < count; j++) {
+			_gst_dsuf_unite (&(gtp -> sets),
+					 _gst_dsuf_find (&(gtp -> sets), terms [0]),
+					 _gst_dsuf_find (&(gtp -> sets), terms [j]));
+		}
+		nunions += count - 1;
+		new_cost += element_cost (gtp, e);
+		gtp -> new_elems [nnew++] = e;
+		if (nunions >= n - 1) break;
+	}
+
+	if (new_cost >= gtp -> total) {
+		return (FALSE);
+	}
+
+	/* Replace the whole tree. */
+
+	for (i = 0; i < gtp -> nfsts + gtp -> nedges; i++) {
+		if (gtp -> in_tree [i]) {
+			remove_element (gtp, i);
+		}
+	}
+	for (i = 0; i < nnew; i++) {
+		add_element (gtp, gtp -> new_elems [i]);
+	}
+	gtp -> total = new_cost;
+
+	return (TRUE);
+}
+
+/*
+ * Compare two keys (element ranks).
+ */
+
+	static
+	int
+compare_keys (
+
+int		i1,	/* IN - first index */
+int		i2,	/* IN - second index */
+void *		array	/* IN - array of keys */
+)
+{
+int *		keys;
+
+	keys = (int *) array;
+
+	if (keys [i1] < keys [i2]) return (-1);
+	if (keys [i1] > keys [i2]) return (1);
+	return (0);
+}
@@ -12,7 +12,9 @@
 
 ************************************************************************
 
-	Implementation of AES-256 cipher.
+	Implementation of AES-256 cipher.  On x86-64 processors that
+	support the AES-NI instructions, encryption uses them instead
+	of the portable code.  Both give identical results.
 
 ************************************************************************
 
@@ -27,10 +29,20 @@
 
 #include "logic.h"
 
+#if defined (__x86_64__) AND defined (__GNUC__)
+	#define USE_AESNI
+	#include <wmmintrin.h>
+#endif
+
 void		_gst_aes256_clear (struct _gst_aes256_context * context);
 void		_gst_aes256_decrypt_ecb (
 				struct _gst_aes256_context *	context,
 				int8u *				buffer);
+void		_gst_aes256_encrypt_cbc (
+				struct _gst_aes256_context *	context,
+				int8u *				iv,
+				int8u *				buffer,
+				int				nblocks);
 void		_gst_aes256_encrypt_ecb (
 				struct _gst_aes256_context *	context,
 				int8u *				buffer);
@@ -46,6 +58,8 @@ static inline void	aes256_ExpandDecryptionKey (int8u *	key,
 						    int8u *	buffer);
 static inline void	aes256_ExpandEncryptionKey (int8u *	key,
 						    int8u *	buffer);
+static void		aes256_ExpandRoundKeys (
+					struct _gst_aes256_context * context);
 static inline void	aes256_MixColumns (int8u * buffer);
 static inline void	aes256_ShiftRows (int8u * buffer);
 static inline void	aes256_SubBytes (int8u * buffer);
@@ -56,6 +70,25 @@ static inline int8u	rijndael_times_x (int8u poly);
 static inline int8u	rijndael_times_x_inverse (int8u poly);
 static inline int8u	update_rcon_decrypt (int8u rcon);
 static inline int8u	update_rcon_encrypt (int8u rcon);
+static void		encrypt_block (struct _gst_aes256_context *	context,
+				       int8u *				buffer);
+
+#ifdef USE_AESNI
+static void		aesni_encrypt_cbc (
+					struct _gst_aes256_context *	context,
+					int8u *				iv,
+					int8u *				buffer,
+					int				nblocks);
+static bool		have_aesni (void);
+#endif
+
+/*
+ * Local Variables
+ */
+
+#ifdef USE_AESNI
+static int	aesni_state = -1;	/* -1 = unknown, 0 = no, 1 = yes */
+#endif
 
 /*
  * The Rijndael S-box, and its inverse.
@@ -369,6 +402,7 @@ int8u		rcon, byte;
 	for (i = 0; i < 7; i++) {
 		aes256_ExpandEncryptionKey (context -> decryption_key, &rcon);
 	}
+	aes256_ExpandRoundKeys (context);
 }
 
 /*
@@ -382,35 +416,58 @@ struct _gst_aes256_context *	context,
 int8u *				buffer
 )
 {
+#ifdef USE_AESNI
 int		i;
-int8u		rcon;
-int8u *		subkey;
+int8u		iv [16];
 
-	aes256_AddRoundKey_and_copy (buffer,
-				     context -> encryption_key,
-				     context -> key);
-	rcon = 0x01;
-	for (i = 1; i < 14; i++) {
-		aes256_SubBytes (buffer);
-		aes256_ShiftRows (buffer);
-		aes256_MixColumns (buffer);
+	if (have_aesni ()) {
+		for (i = 0; i < 16; i++) {
+			iv [i] = 0;
+		}
+		aesni_encrypt_cbc (context, iv, buffer, 1);
+		return;
+	}
+#endif
+	encrypt_block (context, buffer);
+}
 
-		/* Get next subkey from key schedule. */
-		if ((i & 1) NE 0) {
-			subkey = &(context -> key [16]);
+/*
+ * Encrypt consecutive blocks of plaintext in place using AES-256 in
+ * Cipher Block Chaining mode.  The initialization vector is replaced
+ * by the last block of ciphertext, so that another call continues the
+ * chain.
+ */
+
+	void
+_gst_aes256_encrypt_cbc (
+
+struct _gst_aes256_context *	context,
+int8u *				iv,
+int8u *				buffer,
+int				nblocks
+)
+{
+int		i;
+int		k;
+
+#ifdef USE_AESNI
+	if (have_aesni ()) {
+		aesni_encrypt_cbc (context, iv, buffer, nblocks);
+		return;
+	}
+#endif
+	for (k = 0; k < nblocks; k++) {
+		for (i = 0; i < 16; i++) {
+			buffer [i] ^= iv [i];
 		}
-		else {
-			aes256_ExpandEncryptionKey (context -> key, &rcon);
-			subkey = &(context -> key [0]);
+		encrypt_block (context, buffer);
+		for (i = 0; i < 16; i++) {
+			iv [i] = buffer [i];
 		}
-		aes256_AddRoundKey (buffer, subkey);
+		buffer += 16;
 	}
-	aes256_SubBytes (buffer);
-	aes256_ShiftRows (buffer);
-	aes256_ExpandEncryptionKey (context -> key, &rcon); 
-	aes256_AddRoundKey (buffer, context -> key);
 }
-
+
 /*
  * Decrypt a block of ciphertext using AES-256 in Electronic Code Book mode.
  */
@@ -476,6 +533,154 @@ int8u *		p;
  * Computes the next 256 bits of the expanded key.
  */
 
+/*
+ * Encrypt one block of plaintext, without special instructions.
+ */
+
+	static
+	void
+encrypt_block (
+
+struct _gst_aes256_context *	context,
+int8u *				buffer
+)
+{
+int		i;
+int8u		rcon;
+int8u *		subkey;
+
+	aes256_AddRoundKey_and_copy (buffer,
+				     context -> encryption_key,
+				     context -> key);
+	rcon = 0x01;
+	for (i = 1; i < 14; i++) {
+		aes256_SubBytes (buffer);
+		aes256_ShiftRows (buffer);
+		aes256_MixColumns (buffer);
+
+		/* Get next subkey from key schedule. */
+		if ((i & 1) NE 0) {
+			subkey = &(context -> key [16]);
+		}
+		else {
+			aes256_ExpandEncryptionKey (context -> key, &rcon);
+			subkey = &(context -> key [0]);
+		}
+		aes256_AddRoundKey (buffer, subkey);
+	}
+	aes256_SubBytes (buffer);
+	aes256_ShiftRows (buffer);
+	aes256_ExpandEncryptionKey (context -> key, &rcon); 
+	aes256_AddRoundKey (buffer, context -> key);
+}
+
+#ifdef USE_AESNI
+
+/*
+ * Does this processor support the AES-NI instructions?  This is only
+ * checked once.  Two threads may both check at first, but they store
+ * the same answer.
+ */
+
+	static
+	bool
+have_aesni (void)
+
+{
+	if (aesni_state < 0) {
+		__builtin_cpu_init ();
+		aesni_state = __builtin_cpu_supports ("aes") ? 1 : 0;
+	}
+	return (aesni_state > 0);
+}
+
+/*
+ * Encrypt blocks in Cipher Block Chaining mode using the AES-NI
+ * instructions.  The round keys stay in registers for all blocks.
+ * The state saved in the context is left exactly as encrypt_block
+ * leaves it.
+ */
+
+	__attribute__ ((target ("aes")))
+	static
+	void
+aesni_encrypt_cbc (
+
+struct _gst_aes256_context *	context,
+int8u *				iv,
+int8u *				buffer,
+int				nblocks
+)
+{
+int		i;
+int		k;
+__m128i		rk [15];
+__m128i		x;
+
+	/* The encryption key may have been replaced (e.g., restored	*/
+	/* from a saved state) since the schedule was computed.		*/
+	for (i = 0; i < 32; i++) {
+		if (context -> round_keys [i] NE context -> encryption_key [i]) {
+			aes256_ExpandRoundKeys (context);
+			break;
+		}
+	}
+	for (i = 0; i < 15; i++) {
+		rk [i] = _mm_loadu_si128 (
+				(const __m128i *) &(context -> round_keys [16 * i]));
+	}
+
+	x = _mm_loadu_si128 ((const __m128i *) iv);
+	for (k = 0; k < nblocks; k++) {
+		x = _mm_xor_si128 (x, _mm_loadu_si128 ((const __m128i *) buffer));
+		x = _mm_xor_si128 (x, rk [0]);
+		for (i = 1; i < 14; i++) {
+			x = _mm_aesenc_si128 (x, rk [i]);
+		}
+		x = _mm_aesenclast_si128 (x, rk [14]);
+		_mm_storeu_si128 ((__m128i *) buffer, x);
+		buffer += 16;
+	}
+	_mm_storeu_si128 ((__m128i *) iv, x);
+
+	for (i = 0; i < 32; i++) {
+		context -> key [i] = context -> round_keys [224 + i];
+	}
+}
+
+#endif
+
+/*
+ * Compute the full key schedule: round key i occupies octets 16*i
+ * through 16*i+15 of round_keys.  The final 32 octets are those left in
+ * the key by encrypt_block.
+ */
+
+	static
+	void
+aes256_ExpandRoundKeys (
+
+struct _gst_aes256_context *	context
+)
+{
+int		i, j;
+int8u		rcon;
+int8u *		p;
+
+	p = context -> round_keys;
+	for (i = 0; i < 32; i++) {
+		p [i] = context -> encryption_key [i];
+	}
+	rcon = 0x01;
+	for (j = 1; j < 8; j++) {
+		for (i = 0; i < 32; i++) {
+			p [32 + i] = p [i];
+		}
+		p += 32;
+		aes256_ExpandEncryptionKey (p, &rcon);
+	}
+}
+
 	static
 	inline
 	void
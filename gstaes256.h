@@ -38,6 +38,8 @@ struct _gst_aes256_context {
 	int8u		key [32];
 	int8u		encryption_key [32];
 	int8u		decryption_key [32];
+	int8u		round_keys [256];	/* Full key schedule, used */
+						/* with AES-NI instructions */
 };
 
 
@@ -46,6 +48,11 @@ extern void	_gst_aes256_clear (
 extern void	_gst_aes256_decrypt_ecb (
 				struct _gst_aes256_context *	context,
 				int8u *				ciphertext);
+extern void	_gst_aes256_encrypt_cbc (
+				struct _gst_aes256_context *	context,
+				int8u *				iv,
+				int8u *				plaintext,
+				int				nblocks);
 extern void	_gst_aes256_encrypt_ecb (
 				struct _gst_aes256_context *	context,
 				int8u *				plaintext);
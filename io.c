@@ -110,6 +110,11 @@ static struct numlist *	new_numlist (double, int, int);
 static int		next_char (FILE *);
 static struct numlist *	parse_input_numbers (FILE *, int);
 static struct numlist *	parse_one_number (FILE *, bool);
+static int		read_binary_points (FILE *,
+					    int,
+					    double **,
+					    gst_scale_info_ptr);
+static void		swap_bytes (void *, size_t);
 
 
 /*
@@ -133,6 +138,7 @@ double			**points,	/* OUT - list of coordinates (+ battery) */
 gst_scale_info_ptr	sip		/* OUT - problem scaling info */
 )
 {
+int			c;
 int			n;
 int			scaling_factor;
 double *		p;
@@ -144,6 +150,17 @@ struct numlist *	nlp;
 
 	GST_PRELUDE
 
+	/* Binary point sets start with a byte that no text can. */
+	c = getc (fp);
+	if (c NE EOF) {
+		ungetc (c, fp);
+	}
+	if (c EQ (BINARY_POINTS_MAGIC [0] & 0xFF)) {
+		n = read_binary_points (fp, maxpoints, points, sip);
+		GST_POSTLUDE
+		return (n);
+	}
+
 	/* Read 3 numbers per point (x, y, battery) and output 3 (x, y, battery). */
 	int input_numbers_per_point = 3;   /* PSW: input format */
 	int output_numbers_per_point = 3;  /* PSW: output format - now includes battery */
@@ -216,6 +233,113 @@ struct numlist *	nlp;
 }
 
 
+/*
+ * Read a binary point set, as written by "bulk_points -b".  The
+ * coordinates are already doubles, so they are not scaled.
+ */
+
+	static
+	int
+read_binary_points (
+
+FILE *			fp,		/* IN - stream to read from */
+int			maxpoints,	/* IN - maximum number of points (0 = infty) */
+double			**points,	/* OUT - list of coordinates (+ battery) */
+gst_scale_info_ptr	sip		/* OUT - problem scaling info */
+)
+{
+int			i;
+int			n;
+bool			swap;
+double			buf [3];
+double *		p;
+struct binary_points_header	hdr;
+
+	if ((fread (&hdr, sizeof (hdr), 1, fp) NE 1) OR
+	    (memcmp (hdr.magic,
+		     BINARY_POINTS_MAGIC,
+		     BINARY_POINTS_MAGIC_LEN) NE 0)) {
+		(void) fprintf (stderr, "Input format error: bad binary header.\n");
+		exit (1);
+	}
+
+	/* Files written on a machine of the other byte order are	*/
+	/* converted.							*/
+	swap = FALSE;
+	if (hdr.byte_order NE BINARY_POINTS_BYTE_ORDER) {
+		swap_bytes (&(hdr.byte_order), sizeof (hdr.byte_order));
+		if (hdr.byte_order NE BINARY_POINTS_BYTE_ORDER) {
+			(void) fprintf (stderr,
+					"Input format error: bad binary byte order.\n");
+			exit (1);
+		}
+		swap_bytes (&(hdr.npoints), sizeof (hdr.npoints));
+		swap = TRUE;
+	}
+
+	n = hdr.npoints;
+	if ((maxpoints > 0) AND (n > maxpoints)) {
+		n = maxpoints;
+	}
+
+	if (sip NE NULL) {
+		_gst_set_scale_info (sip, 0);
+	}
+
+	if (points EQ NULL) {
+		return (n);
+	}
+
+	if (maxpoints EQ 0) {
+		*points = NEWA (3 * n, double);
+	}
+
+	p = *points;
+	for (i = 0; i < n; i++) {
+		if (fread (buf, sizeof (buf), 1, fp) NE 1) {
+			(void) fprintf (stderr,
+					"Input format error: expected %d points, got %d.\n",
+					n, i);
+			exit (1);
+		}
+		if (swap) {
+			swap_bytes (&buf [0], sizeof (buf [0]));
+			swap_bytes (&buf [1], sizeof (buf [1]));
+			swap_bytes (&buf [2], sizeof (buf [2]));
+		}
+		*(p++) = buf [0];
+		*(p++) = buf [1];
+		*(p++) = buf [2];
+	}
+
+	return (n);
+}
+
+/*
+ * Reverse the order of the bytes of an object.
+ */
+
+	static
+	void
+swap_bytes (
+
+void *		obj,		/* IN/OUT - object */
+size_t		size		/* IN - its size in bytes */
+)
+{
+char *		p;
+char *		q;
+char		c;
+
+	p = (char *) obj;
+	q = p + size - 1;
+	while (p < q) {
+		c = *p;
+		*p++ = *q;
+		*q-- = c;
+	}
+}
+
 /*
  * This routine "parses" all of the numbers in the input into a list
  * of partially converted/scaled numbers in binary (floating point) form.
@@ -27,6 +27,7 @@
 #define	IO_H_INCLUDED
 
 #include "geomtypes.h"
+#include "gsttypes.h"
 #include <stdio.h>
 
 
@@ -65,6 +66,24 @@ struct gst_scale_info {
 };
 
 
+/*
+ * The binary point set format, as written by "bulk_points -b" and
+ * accepted by gst_get_points.  The file starts with the header below,
+ * in the native byte order of the machine that wrote it, followed by
+ * npoints * 3 doubles: x, y, battery.
+ */
+
+#define	BINARY_POINTS_MAGIC		"\211GSTPTS\n"
+#define	BINARY_POINTS_MAGIC_LEN		8
+#define	BINARY_POINTS_BYTE_ORDER	0x01020304
+
+struct binary_points_header {
+	char		magic [BINARY_POINTS_MAGIC_LEN];
+	int32u		byte_order;	/* BINARY_POINTS_BYTE_ORDER */
+	int32u		npoints;	/* Number of points */
+};
+
+
 /*
  * Macro to unscale an internal value back to external form.
  */
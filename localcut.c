@@ -54,6 +54,7 @@
 #include "localcut.h"
 
 #include "bb.h"
+#include "bitmap.h"
 #include "ckpt.h"
 #include "constrnt.h"
 #include "ddsuf.h"
@@ -98,12 +99,6 @@ void		_gst_print_forests (struct comp *	comp,
 				    gst_channel_ptr	print_solve_trace);
 
 
-/*
- * Local Equates
- */
-
-#define FORMULATE_DUAL		0
-
 /*
  * Local Types
  */
@@ -249,7 +244,7 @@ static struct constraint * lift_constraint (struct comp *,
 					    double,
 					    struct bbinfo *);
 static struct LCTrace *	make_classic_tracer (struct bbinfo * bbip);
-static LP_t *		make_fcomp_lp (struct comp *, struct lpmem *);
+static LP_t *		make_fcomp_lp (struct comp *, struct bbinfo *);
 static struct LCTrace *	make_quiet_tracer (struct bbinfo * bbip);
 static struct LCTrace *	make_terse_tracer (struct bbinfo * bbip);
 static struct LCTrace *	make_tracer (struct bbinfo * bbip);
@@ -521,8 +516,7 @@ struct comp *		newp;
 	}
 	ip1 = NEWA (vcount, int);
 	k = 0;
-	for (i = 0; i < nverts; i++) {
-		if (NOT BITON (vert_mask, i)) continue;
+	FOR_EACH_SETBIT (i, vert_mask, nverts) {
 		/* This vertex was retained... */
 		new_vnum [i] = k;
 		newp -> tviol [k] = 0.0;
@@ -829,8 +823,7 @@ bitmap_t *		edge_mask;
 	/* being "already stacked".  This prevents these vertices from	*/
 	/* being deleted by this algorithm.				*/
 
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		if (x [i] <= FUZZ) continue;
 		if (x [i] >= 1.0 - FUZZ) continue;
 
@@ -961,8 +954,7 @@ bitmap_t *		edge_mask;
 	}
 	ip1 = NEWA (vcount, int);
 	k = 0;
-	for (i = 0; i < nverts; i++) {
-		if (NOT BITON (cvmask, i)) continue;
+	FOR_EACH_SETBIT (i, cvmask, nverts) {
 		/* This vertex was retained... */
 		new_vnum [i] = k;
 		newp -> tviol [k] = 0.0;
@@ -1663,8 +1655,7 @@ int *			rvlist;
 
 	/* Compute size of new edge-to-vertices list... */
 	k = 0;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		ip1 = comp -> everts [i];
 		ip2 = comp -> everts [i + 1];
 		while (ip1 < ip2) {
@@ -2024,7 +2015,6 @@ struct constraint *	newcp;
 int *			edge_freq;
 double			w;
 double			z;
-struct lpmem		lpmem;
 gst_param_ptr		params;
 gst_channel_ptr		print_solve_trace;
 struct LCTrace *	tp;
@@ -2069,7 +2059,7 @@ pull_out_all_the_stops:
 		"Enter find_fcomp_cut with %d vertices and %d edges\n",
 		nverts, nedges);
 
-	lp = make_fcomp_lp (comp, &lpmem);
+	lp = make_fcomp_lp (comp, bbip);
 
 	y	= NEWA (nedges, double);
 	forest	= NEWA (nverts, int);
@@ -2100,67 +2090,15 @@ pull_out_all_the_stops:
 		}
 
 		/* Solve the LP instance... */
-
-#ifdef CPLEX
-
-#if FORMULATE_DUAL
-		status = _MYCPX_primopt (lp);
-		if (status NE 0) {
-			tp -> lp_error (tp,
-					" WARNING primopt: status = %d\n",
-					status);
-		}
-		i = _MYCPX_solution (lp, &status, &w, NULL, y, slack, NULL);
-#else
-		status = _MYCPX_dualopt (lp);
-		if (status NE 0) {
-			tp -> lp_error (tp,
-					" WARNING dualopt: status = %d\n",
-					status);
-		}
-		i = _MYCPX_solution (lp, &status, &w, y, NULL, slack, NULL);
-#endif
-		FATAL_ERROR_IF (i NE 0);
-		if (status NE _MYCPX_STAT_OPTIMAL) {
-			tp -> lp_error (tp,
-					" WARNING: solution status = %d\n",
-					status);
-		}
-#endif
-
-#ifdef LPSOLVE
-		status = solve (lp);
-
-		if (status NE OPTIMAL) {
+		status = lp -> backend -> optimize (lp);
+		if (status NE LP_OPTIMAL) {
 			tp -> lp_error (tp,
 					" WARNING: solution status = %d\n",
 					status);
 		}
 
-		w = lp -> best_solution [0];
-
-#if FORMULATE_DUAL
-		/* Get LP dual variables... */
-		for (i = 0; i < nedges; i++) {
-			y [i] = lp -> duals [1 + i];
-		}
-
-		/* FIXME - need slack vars here... */
-		for (i = 0; i <= lp -> rows; i++) {
-			slack [i] = 0.0;
-		}
-#else
-		/* Get LP solution variables... */
-		for (i = 0; i < nedges; i++) {
-			y [i] = lp -> best_solution [lp -> rows + i + 1];
-		}
-
-		/* FIXME - need slack vars here... */
-		for (i = 0; i <= lp -> rows; i++) {
-			slack [i] = 0.0;
-		}
-#endif
-#endif
+		/* Get LP solution variables and slacks... */
+		lp -> backend -> get_solution (lp, &w, y, slack);
 
 		/* Find a forest x that violates the constraint	*/
 		/* y*x <= 1.  Try a fast heuristic first.  If	*/
@@ -2243,280 +2181,98 @@ pull_out_all_the_stops:
 	free ((char *) forest);
 	free ((char *) y);
 
-#ifdef CPLEX
-	_MYCPX_freeprob (&lp);
-
-	free ((char *) lpmem.matval);
-	free ((char *) lpmem.matind);
-	free ((char *) lpmem.matcnt);
-	free ((char *) lpmem.matbeg);
-	free ((char *) lpmem.senx);
-	free ((char *) lpmem.rhsx);
-	free ((char *) lpmem.bdu);
-	free ((char *) lpmem.bdl);
-	free ((char *) lpmem.objx);
-#endif
-
-#ifdef LPSOLVE
-	delete_lp (lp);
-#endif
+	lp -> backend -> destroy (lp);
 
 	return (cp);
 }
 
 /*
- * Make the initial LP instance for CPLEX (dual formulation).
+ * Make the initial LP instance: maximize x*y subject to y(F) <= 1 for
+ * every forest F, starting with the 1-edge forests.
  */
 
-#if defined(CPLEX) AND FORMULATE_DUAL
-
 	static
 	LP_t *
 make_fcomp_lp (
 
-struct comp *		comp,
-struct lpmem *		lpmem
+struct comp *		comp,		/* IN - component to separate */
+struct bbinfo *		bbip		/* IN - branch-and-bound info */
 )
 {
 int			i;
-int			k;
 int			nverts;
 int			nedges;
-int			mac;
-int			mar;
-int			macsz;
-int			marsz;
-int			matsz;
-int			col;
-int			objsen;
-char *			senx;
 int *			matbeg;
-int *			matcnt;
 int *			matind;
-double *		objx;
 double *		bdl;
 double *		bdu;
-double *		rhsx;
+double *		rhs;
+char *			sense;
 double *		matval;
+const struct lp_backend *	be;
 LP_t *			lp;
 
 	nverts	= comp -> num_verts;
 	nedges	= comp -> num_edges;
 
-	macsz = 32 * nedges;
-	mac = nedges;
-
-	/* Build the objective function... */
-	objx = NEWA (macsz, double);
-	for (i = 0; i < mac; i++) {
-		objx [i] = 1.0;
-	}
-	objsen = _MYCPX_MIN;	/* Minimize */
-
 	/* Build variable bound arrays... */
-	bdl = NEWA (macsz, double);
-	bdu = NEWA (macsz, double);
-	for (i = 0; i < mac; i++) {
-		bdl [i] = 0.0;
-		bdu [i] = 1.0;
-	}
-
-	mar = nedges;
-	marsz = mar;
-	matsz = macsz * nverts;
-
-	rhsx = NEWA (marsz, double);
-	senx = NEWA (marsz, char);
-	matbeg = NEWA (macsz, int);
-	matcnt = NEWA (macsz, int);
-	matind = NEWA (matsz, int);
-	matval = NEWA (matsz, double);
-
-	for (i = 0; i < mar; i++) {
-		rhsx [i] = comp -> x [i];
-		senx [i] = 'G';
-	}
-
-	/* Emit one column per 1-edge forest. */
-	k = 0;
-	col = 0;
+	bdl = NEWA (nedges, double);
+	bdu = NEWA (nedges, double);
 	for (i = 0; i < nedges; i++) {
-		matbeg [col] = k;
-		matcnt [col] = 1;
-		matind [k] = i;
-		matval [k] = 1.0;
-		++k;
-		++col;
-	}
-
-	lp = _MYCPX_loadlp ("localcut",
-			    mac,
-			    mar,
-			    objsen,
-			    objx,
-			    rhsx,
-			    senx,
-			    matbeg,
-			    matcnt,
-			    matind,
-			    matval,
-			    bdl,
-			    bdu,
-			    NULL,
-			    macsz,
-			    marsz,
-			    matsz);
-
-	FATAL_ERROR_IF (lp EQ NULL);
-
-	lpmem -> objx		= objx;
-	lpmem -> rhsx		= rhsx;
-	lpmem -> senx		= senx;
-	lpmem -> matbeg		= matbeg;
-	lpmem -> matcnt		= matcnt;
-	lpmem -> matind		= matind;
-	lpmem -> matval		= matval;
-	lpmem -> bdl		= bdl;
-	lpmem -> bdu		= bdu;
-
-	return (lp);
-}
-
-#endif
-
-/*
- * Make the initial LP instance for CPLEX (primal formulation).
- */
-
-#if defined(CPLEX) AND NOT FORMULATE_DUAL
-
-	static
-	LP_t *
-make_fcomp_lp (
-
-struct comp *		comp,
-struct lpmem *		lpmem
-)
-{
-int			i;
-int			k;
-int			nverts;
-int			nedges;
-int			mac;
-int			mar;
-int			macsz;
-int			marsz;
-int			matsz;
-int			col;
-int			objsen;
-char *			senx;
-int *			matbeg;
-int *			matcnt;
-int *			matind;
-double *		objx;
-double *		bdl;
-double *		bdu;
-double *		rhsx;
-double *		matval;
-LP_t *			lp;
-
-	nverts	= comp -> num_verts;
-	nedges	= comp -> num_edges;
-
-	macsz = nedges;
-	mac = nedges;
-
-	/* Build the objective function... */
-	objx = NEWA (macsz, double);
-	for (i = 0; i < mac; i++) {
-		objx [i] = comp -> x [i];
-	}
-	objsen = _MYCPX_MAX;	/* Maximize */
-
-	/* Build variable bound arrays... */
-	bdl = NEWA (macsz, double);
-	bdu = NEWA (macsz, double);
-	for (i = 0; i < mac; i++) {
 		if (comp -> x [i] <= FUZZ) {
 			bdl [i] = 0.0;
-			bdu [i] = _MYCPX_INFBOUND;
 		}
 		else {
-			bdl [i] = - _MYCPX_INFBOUND;
-			bdu [i] = _MYCPX_INFBOUND;
+			bdl [i] = - LP_INFINITY;
 		}
+		bdu [i] = LP_INFINITY;
 	}
 
-	mar = nedges;
-	marsz = 32 * nedges;
-	matsz = marsz * nverts;
+	be = _gst_select_lp_backend (bbip -> params);
+	lp = be -> create ("localcut",
+			   nedges,
+			   LP_MAXIMIZE,
+			   comp -> x,
+			   bdl,
+			   bdu,
+			   32 * nedges,
+			   32 * nedges * nverts);
 
-	rhsx = NEWA (marsz, double);
-	senx = NEWA (marsz, char);
-	matbeg = NEWA (macsz, int);
-	matcnt = NEWA (macsz, int);
-	matind = NEWA (matsz, int);
-	matval = NEWA (matsz, double);
+	free ((char *) bdu);
+	free ((char *) bdl);
 
-	for (i = 0; i < mar; i++) {
-		rhsx [i] = 1.0;
-		senx [i] = 'L';
-	}
+	rhs	= NEWA (nedges, double);
+	sense	= NEWA (nedges, char);
+	matbeg	= NEWA (nedges + 1, int);
+	matind	= NEWA (nedges, int);
+	matval	= NEWA (nedges, double);
 
 	/* Emit one row per 1-edge forest. */
-	k = 0;
-	col = 0;
 	for (i = 0; i < nedges; i++) {
-		matbeg [col] = k;
-		matcnt [col] = 1;
-		matind [k] = i;
-		matval [k] = 1.0;
-		++k;
-		++col;
-	}
-
-	lp = _MYCPX_loadlp ("localcut",
-			    mac,
-			    mar,
-			    objsen,
-			    objx,
-			    rhsx,
-			    senx,
-			    matbeg,
-			    matcnt,
-			    matind,
-			    matval,
-			    bdl,
-			    bdu,
-			    NULL,
-			    macsz,
-			    marsz,
-			    matsz);
-
-	FATAL_ERROR_IF (lp EQ NULL);
-
-	lpmem -> objx		= objx;
-	lpmem -> rhsx		= rhsx;
-	lpmem -> senx		= senx;
-	lpmem -> matbeg		= matbeg;
-	lpmem -> matcnt		= matcnt;
-	lpmem -> matind		= matind;
-	lpmem -> matval		= matval;
-	lpmem -> bdl		= bdl;
-	lpmem -> bdu		= bdu;
+		matbeg [i] = i;
+		matind [i] = i;
+		matval [i] = 1.0;
+		rhs [i] = 1.0;
+		sense [i] = 'L';
+	}
+	matbeg [i] = i;
+
+	lp -> backend -> add_rows (lp, nedges, rhs, sense, matbeg, matind, matval);
+
+	free ((char *) matval);
+	free ((char *) matind);
+	free ((char *) matbeg);
+	free ((char *) sense);
+	free ((char *) rhs);
 
 	return (lp);
 }
-
-#endif
 
 /*
- * Delete slack forests from the given CPLEX LP (primal formulation).
+ * Delete slack forests from the given LP.  The 1-edge forests are
+ * always kept.
  */
 
-
-#if defined(CPLEX) AND NOT FORMULATE_DUAL
-
 	static
 	void
 delete_slack (
@@ -2547,109 +2303,17 @@ int *		dflag;
 	}
 
 	if (j > 0) {
-		i = _MYCPX_delsetrows (lp, dflag);
-		FATAL_ERROR_IF (i NE 0);
+		lp -> backend -> delete_rows (lp, dflag);
 
 		tp -> del_slack (tp, j, nrows - j);
 	}
 	free ((char *) dflag);
 }
-
-#endif
 
 /*
- * Delete slack forests from the given lp_solve problem (dual formulation).
+ * Add the given forest to the given LP.
  */
 
-
-#if defined(LPSOLVE) AND FORMULATE_DUAL
-
-	static
-	void
-delete_slack (
-
-LP_t *			lp,
-double *		slack,
-struct LCTrace *	tp
-)
-{
-int		i;
-int		j;
-int		nrows;
-int		ncols;
-
-	ncols = GET_LP_NUM_COLS (lp);
-
-	/* Grog!  This is totally gross... */
-
-	j = 0;
-	for (i = ncols - 1; i >= 0; i--) {
-		if (slack [i] > FUZZ) {
-			del_column (lp, i + 1);
-			++j;
-		}
-	}
-
-	if (j > 0) {
-		tp -> del_slack (tp, j, ncols - j);
-	}
-}
-
-#endif
-
-/*
- * Delete slack forests from the given lp_solve problem (primal formulation).
- */
-
-
-#if defined(LPSOLVE) AND NOT FORMULATE_DUAL
-
-	static
-	void
-delete_slack (
-
-LP_t *			lp,
-double *		slack,
-struct LCTrace *	tp
-)
-{
-int		i;
-int		j;
-int		nrows;
-int *		dflag;
-
-	nrows = GET_LP_NUM_ROWS (lp);
-
-	dflag = NEWA (nrows + 1, int);
-
-	j = 0;
-	dflag [0] = 0;
-	for (i = 0; i < nrows; i++) {
-		if (slack [i] > FUZZ) {
-			dflag [i + 1] = 1;
-			++j;
-		}
-		else {
-			dflag [i + 1] = 0;
-		}
-	}
-
-	if (j > 0) {
-		delete_row_set (lp, dflag);
-
-		tp -> del_slack (tp, j, nrows - j);
-	}
-	free ((char *) dflag);
-}
-
-#endif
-
-/*
- * Add the given forest to the given CPLEX LP (dual formulation).
- */
-
-#if defined(CPLEX) AND FORMULATE_DUAL
-
 	static
 	void
 add_forest_to_lp (
@@ -2661,67 +2325,7 @@ int *		forest		/* IN - list of edges in forest */
 {
 int		j;
 int		nedges;
-int		cmatbeg;
-int		status;
-int *		cmatind;
-double *	cmatval;
-double		lowerbd;
-double		upperbd;
-double		cval;
-
-	nedges = GET_LP_NUM_ROWS (lp);
-
-	cmatval = NEWA (nedges, double);
-	cmatind = NEWA (nedges, int);
-	for (j = 0; j < nf; j++) {
-		cmatval [j] = 1.0;
-		cmatind [j] = forest [j];
-	}
-
-	lowerbd = 0.0;
-	upperbd = 1.0;
-	cval = 1.0;
-	cmatbeg = 0;
-
-	status = CPXaddcols (cplex_env,
-			     lp,
-			     1,
-			     nf,
-			     &cval,
-			     &cmatbeg,
-			     cmatind,
-			     cmatval,
-			     &lowerbd,
-			     &upperbd,
-			     NULL);
-
-	FATAL_ERROR_IF (status NE 0);
-
-	free ((char *) cmatind);
-	free ((char *) cmatval);
-}
-
-#endif
-
-/*
- * Add the given forest to the given CPLEX LP (primal formulation).
- */
-
-#if defined(CPLEX) AND NOT FORMULATE_DUAL
-
-	static
-	void
-add_forest_to_lp (
-
-LP_t *		lp,		/* IN - LP to add forest to */
-int		nf,		/* IN - number of edges in forest */
-int *		forest		/* IN - list of edges in forest */
-)
-{
-int		j;
-int		nedges;
-int		rmatbeg;
-int		status;
+int		rmatbeg [2];
 int *		rmatind;
 double *	rmatval;
 double		rval;
@@ -2737,280 +2341,21 @@ char		sense;
 	}
 
 	rval = 1.0;
-	rmatbeg = 0;
+	rmatbeg [0] = 0;
+	rmatbeg [1] = nf;
 	sense = 'L';
 
-	status = _MYCPX_addrows (lp,
-				 0,
-				 1,
-				 nf,
-				 &rval,
-				 &sense,
-				 &rmatbeg,
-				 rmatind,
-				 rmatval,
-				 NULL,
-				 NULL);
-
-	FATAL_ERROR_IF (status NE 0);
+	lp -> backend -> add_rows (lp,
+				   1,
+				   &rval,
+				   &sense,
+				   rmatbeg,
+				   rmatind,
+				   rmatval);
 
 	free ((char *) rmatind);
 	free ((char *) rmatval);
 }
-
-#endif
-
-/*
- * Make the initial LP instance for lp_solve (dual formulation).
- */
-
-#if defined(LPSOLVE) AND FORMULATE_DUAL
-
-	static
-	LP_t *
-make_fcomp_lp (
-
-struct comp *		comp,
-struct lpmem *		lpmem
-)
-{
-int			i;
-int			nverts;
-int			nedges;
-int			ncols;
-int			nrows;
-short *			ctype;
-int *			matbeg;
-int *			matind;
-double *		objx;
-double *		rhs;
-double *		matval;
-LP_t *			lp;
-
-	nverts	= comp -> num_verts;
-	nedges	= comp -> num_edges;
-
-	ncols = nedges;
-
-	lp = make_lp (0, ncols);
-
-	/* All variables (really dual variables) are 0-1 variables... */
-	for (i = 1; i <= ncols; i++) {
-		set_bounds (lp, i, 0.0, 1.0);
-	}
-
-	/* Minimize */
-	set_minim (lp);
-
-	/* Build the objective function... */
-	objx = NEWA (ncols + 1, double);
-	for (i = 1; i <= ncols; i++) {
-		objx [i] = 1.0;
-	}
-#if 1
-	inc_mat_space (lp, ncols + 1);
-#endif
-	set_obj_fn (lp, objx);
-	free (objx);
-
-	nrows = nedges;
-
-	rhs = NEWA (nrows, double);
-	ctype = NEWA (nrows, short);
-	matbeg = NEWA (ncols + 1, int);
-	matind = NEWA (nrows, int);
-	matval = NEWA (nrows, double);
-
-	for (i = 0; i < nrows; i++) {
-		matbeg [i] = i;
-		matind [i] = i;
-		matval [i] = 1.0;
-		rhs [i] = comp -> x [i];
-		ctype [i] = RC_OP_GE;
-	}
-	matbeg [i] = i;
-
-	add_rows (lp, 0, nrows, rhs, ctype, matbeg, matind, matval);
-
-	free ((char *) matval);
-	free ((char *) matind);
-	free ((char *) matbeg);
-	free ((char *) ctype);
-	free ((char *) rhs);
-
-	return (lp);
-}
-
-#endif
-
-/*
- * Make the initial LP instance for lp_solve (primal formulation).
- */
-
-#if defined(LPSOLVE) AND NOT FORMULATE_DUAL
-
-	static
-	LP_t *
-make_fcomp_lp (
-
-struct comp *		comp,
-struct lpmem *		lpmem
-)
-{
-int			i;
-int			nedges;
-int			ncols;
-int			nrows;
-short *			ctype;
-int *			matbeg;
-int *			matind;
-double *		objx;
-double *		rhs;
-double *		matval;
-LP_t *			lp;
-
-	nedges	= comp -> num_edges;
-
-	ncols = nedges;
-
-	lp = make_lp (0, ncols);
-
-	/* Set variable bounds... */
-	for (i = 0; i < ncols; i++) {
-		if (comp -> x [i] <= FUZZ) {
-			/* Default 0 ... infinity bounds are OK. */
-			continue;
-		}
-		/* We would really like -inf ... inf, but lp_solve does	*/
-		/* not support unrestricted negative variables...	*/
-		set_bounds (lp, i + 1, -128.0, 1.0e24);
-	}
-
-	/* Maximize */
-	set_maxim (lp);
-
-	/* Build the objective function... */
-	objx = NEWA (ncols + 1, double);
-	for (i = 0; i < ncols; i++) {
-		objx [i + 1] = comp -> x [i];
-	}
-#if 1
-	inc_mat_space (lp, ncols + 1);
-#endif
-	set_obj_fn (lp, objx);
-	free (objx);
-
-	nrows = nedges;
-
-	rhs = NEWA (nrows, double);
-	ctype = NEWA (nrows, short);
-	matbeg = NEWA (ncols + 1, int);
-	matind = NEWA (nrows, int);
-	matval = NEWA (nrows, double);
-
-	/* Emit one row per 1-edge forest. */
-
-	for (i = 0; i < nedges; i++) {
-		matbeg [i] = i;
-		matind [i] = i;
-		matval [i] = 1.0;
-		rhs [i] = 1.0;
-		ctype [i] = RC_OP_LE;
-	}
-	matbeg [i] = i;
-
-	add_rows (lp, 0, nrows, rhs, ctype, matbeg, matind, matval);
-
-	free ((char *) matval);
-	free ((char *) matind);
-	free ((char *) matbeg);
-	free ((char *) ctype);
-	free ((char *) rhs);
-
-	return (lp);
-}
-
-#endif
-
-/*
- * Add the given forest to the given lp_solve LP (dual formulation).
- */
-
-#if defined(LPSOLVE) AND FORMULATE_DUAL
-
-	static
-	void
-add_forest_to_lp (
-
-LP_t *		lp,		/* IN - LP to add forest to */
-int		nf,		/* IN - number of edges in forest */
-int *		forest		/* IN - list of edges in forest */
-)
-{
-int		j;
-int		nedges;
-double *	colvec;
-
-	nedges = GET_LP_NUM_ROWS (lp);
-
-	colvec = NEWA (nedges + 1, double);
-
-	for (j = 0; j <= nedges; j++) {
-		colvec [j] = 0.0;
-	}
-
-	colvec [0] = 1.0;	/* objective coefficient... */
-
-	for (j = 0; j < nf; j++) {
-		colvec [1 + forest [j]] = 1.0;
-	}
-
-	add_column (lp, colvec);
-
-	free ((char *) colvec);
-
-	set_bounds (lp, lp -> columns, 0.0, 1.0);
-}
-
-#endif
-
-/*
- * Add the given forest to the given lp_solve LP (primal formulation).
- */
-
-#if defined(LPSOLVE) AND NOT FORMULATE_DUAL
-
-	static
-	void
-add_forest_to_lp (
-
-LP_t *		lp,		/* IN - LP to add forest to */
-int		nf,		/* IN - number of edges in forest */
-int *		forest		/* IN - list of edges in forest */
-)
-{
-int		j;
-int		nedges;
-double *	rowvec;
-
-	nedges = GET_LP_NUM_COLS (lp);
-
-	rowvec = NEWA (nedges + 1, double);
-
-	for (j = 0; j <= nedges; j++) {
-		rowvec [j] = 0.0;
-	}
-
-	for (j = 0; j < nf; j++) {
-		rowvec [1 + forest [j]] = 1.0;
-	}
-
-	add_constraint (lp, rowvec, REL_LE, 1.0);
-
-	free ((char *) rowvec);
-}
-
-#endif
 
 /*
  * Lift the generated constraint back to one that is valid for
@@ -4018,8 +3363,7 @@ gst_channel_ptr		trace;
 	}
 	gst_channel_printf (trace, " Solution:");
 	z = 0.0;
-	for (i = 0; i < cip -> num_edges; i++) {
-		if (NOT BITON (smt, i)) continue;
+	FOR_EACH_SETBIT (i, smt, cip -> num_edges) {
 		gst_channel_printf (trace, " %d", i);
 		z += cip -> cost [i];
 	}
@@ -184,6 +184,7 @@ void delete_lp(lprec *lp)
   free(lp->eta_value);
   free(lp->eta_row_nr);
   free(lp->eta_col_end);
+  free(lp->dse_weight);
   free(lp->solution);
   free(lp->best_solution);
   free(lp->duals);
@@ -245,6 +246,9 @@ lprec *copy_lp(lprec *lp)
   MALLOCCPY(newlp->eta_row_nr, lp->eta_row_nr, lp->eta_alloc);
   MALLOCCPY(newlp->eta_col_end, lp->eta_col_end,
 	    lp->rows_alloc + lp->max_num_inv + 1);
+  newlp->dse_weight = NULL;
+  newlp->dse_alloc = 0;
+  newlp->dse_valid = FALSE;
   MALLOCCPY(newlp->solution, lp->solution, sumplus);
   MALLOCCPY(newlp->best_solution, lp->best_solution, sumplus);
   MALLOCCPY(newlp->duals, lp->duals, rowsplus);
@@ -283,7 +287,8 @@ void inc_mat_space(lprec *lp, int maxextra)
 void inc_row_space(lprec *lp)
 {
   if(lp->rows > lp->rows_alloc) {
-    lp->rows_alloc = lp->rows+10;
+    /* grow geometrically -- rows arrive a few at a time from cut rounds */
+    lp->rows_alloc = lp->rows + lp->rows / 2 + 10;
     lp->sum_alloc  = lp->rows_alloc + lp->columns_alloc;
     REALLOC(lp->orig_rh, lp->rows_alloc + 1);
     REALLOC(lp->rh, lp->rows_alloc + 1);
@@ -553,6 +558,7 @@ void add_constraint(lprec *lp, REAL *row, short constr_type, REAL rh)
   lp->basis[lp->rows] = TRUE;
   lp->lower[lp->rows] = TRUE;   
   lp->eta_valid = FALSE;
+  lp->dse_valid = FALSE;
 }
 
 void str_add_constraint(lprec *lp,
@@ -752,7 +758,27 @@ void add_rows(lprec *lp,
       free(count);
     }
 
-  lp->eta_valid = FALSE;
+  /* The new slacks are basic, so the basis remains valid.  Extend the */
+  /* factorization as well if we can, so that the next solve continues */
+  /* directly from the previous optimum.			       */
+  if(ccnt > 0 || lp->scaling_used || !lp->basis_valid || !lp->eta_valid ||
+     !extend_eta_rows(lp, rcnt))
+    lp->eta_valid = FALSE;
+
+  /* Rows i of the old and new B^-1 agree, so the dual steepest-edge	*/
+  /* weights of the old basic variables carry over unchanged.		*/
+  if(ccnt > 0)
+    lp->dse_valid = FALSE;
+  else if(lp->dse_valid && rcnt > 0) {
+    if(lp->dse_alloc < lp->sum + 1) {
+      lp->dse_alloc = lp->sum_alloc + 1;
+      REALLOC(lp->dse_weight, lp->dse_alloc);
+    }
+    for(i = lp->sum; i > lp->rows; i--)
+      lp->dse_weight[i] = lp->dse_weight[i - rcnt];
+    for(; i > lp->rows - rcnt; i--)
+      lp->dse_weight[i] = 1;
+  }
 }
 
 void del_constraint(lprec *lp, int del_row)
@@ -811,6 +837,7 @@ void del_constraint(lprec *lp, int del_row)
   lp->row_end_valid = FALSE;
   lp->eta_valid     = FALSE;
   lp->basis_valid   = FALSE; 
+  lp->dse_valid     = FALSE;
 }
 
 void delete_row_set(lprec *lp, int *row_flags)
@@ -821,6 +848,7 @@ void delete_row_set(lprec *lp, int *row_flags)
   int * renum;
   int firstrow;
   int num_del;
+  int excess;
 
   /* Find lowest numbered row to delete. */
   firstrow = -1;
@@ -878,24 +906,56 @@ void delete_row_set(lprec *lp, int *row_flags)
       if(lp->names_used)
         memcpy(lp->row_name[k], lp->row_name[i], NAMELEN);
     }
+  /* Repair the basis rather than discarding it.  The slacks of the	*/
+  /* deleted rows vanish; every other basic variable stays basic as	*/
+  /* long as there is room.  Since invert() permutes the rows of the	*/
+  /* basis, a deleted row's slack is frequently basic in some OTHER	*/
+  /* row, so the basic variables are simply gathered into the new	*/
+  /* positions in order.  When a deleted row's slack was non-basic	*/
+  /* (a tight row), one surplus variable must leave:  prefer those	*/
+  /* that were basic in the deleted rows themselves.			*/
+  excess = 0;
+  if(lp->basis_valid)
+    {
+      for(i = 1; i <= lp->rows; i++)
+	if(renum[lp->bas[i]] >= 0)
+	  ++excess;
+      excess -= lp->rows - num_del;
+    }
+  for(i = 1; i <= lp->rows && excess > 0; i++)
+    if(renum[i] < 0 && renum[lp->bas[i]] >= 0)
+      {
+	lp->basis[lp->bas[i]] = 0;
+	lp->lower[lp->bas[i]] = 1;
+	lp->bas[i] = i;		/* a deleted slack: skipped below */
+	--excess;
+      }
+  for(i = 1; i <= lp->rows && excess > 0; i++)
+    if(renum[lp->bas[i]] >= 0)
+      {
+	lp->basis[lp->bas[i]] = 0;
+	lp->lower[lp->bas[i]] = 1;
+	lp->bas[i] = 0;		/* skipped below */
+	--excess;
+      }
+  j = 0;
   for(i = 1; i <= lp->rows; i++)
     {
-      j = renum[i];
-      if(j < 0)
-	{
-	  lp->basis[lp->bas[i]] = 0;
-	  lp->lower[lp->bas[i]] = 1;
-	  continue;
-	}
-      k = renum[lp->bas[i]];
-      if (k < 0)
-	{
-	  lp->basis_valid = 0;
-	  break;
-	}
-      lp->bas[j] = k;
+      k = lp->bas[i];
+      if(k <= 0 || renum[k] < 0)
+	continue;
+      lp->bas[++j] = renum[k];
     }
 
+  /* Carry the dual steepest-edge weights over to the new numbering. */
+  if(lp->dse_valid)
+    for(i = firstrow + 1; i <= lp->sum; i++)
+      {
+	k = renum[i];
+	if(k >= 0)
+	  lp->dse_weight[k] = lp->dse_weight[i];
+      }
+
   for(i = firstrow + 1; i <= lp->sum; i++)
     {
       k = renum[i];
@@ -1009,6 +1069,7 @@ void add_column(lprec *lp, REAL *column)
     sprintf(lp->col_name[lp->columns], "var_%d", lp->columns);
  
   lp->row_end_valid = FALSE;
+  lp->dse_valid = FALSE;
 }
 
 void str_add_column(lprec *lp, char *col_string)
@@ -1072,6 +1133,7 @@ void del_column(lprec *lp, int column)
 
   lp->sum--;
   lp->columns--;
+  lp->dse_valid = FALSE;
 }
 
 void set_upbo(lprec *lp, int column, REAL value)
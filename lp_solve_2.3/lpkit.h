@@ -255,6 +255,7 @@ typedef struct _lprec
   int       eta_alloc;          /* The allocated memory for Eta */
   int       eta_size;           /* The number of Eta columns */
   int       num_inv;            /* The number of real pivots */
+  int       eta_nz_inv;         /* Eta nonzeros right after the last invert */
   int       max_num_inv;        /* ## The number of real pivots between 
 				   reinversions */
   REAL      *eta_value;         /* eta_alloc :The Structure containing the
@@ -264,6 +265,13 @@ typedef struct _lprec
   int       *eta_col_end;       /* rows_alloc + MaxNumInv : eta_col_end[i] is
 				   the start index of the next Eta column */
 
+  short     dse_valid;          /* TRUE if dse_weight matches current basis */
+  int       dse_alloc;          /* The allocated length of dse_weight */
+  REAL      *dse_weight;        /* dse_alloc :Dual steepest-edge reference
+				   weight of each basic variable, indexed by
+				   variable number (so that invert() may
+				   permute the rows of the basis freely) */
+
   short	    bb_rule;		/* what rule for selecting B&B variables */
 
   short     break_at_int;       /* TRUE if stop at first integer better than
@@ -326,6 +334,7 @@ struct basis_save {
 	short *		basis;
 	short *		lower;
 	REAL *		rhs;
+	REAL *		dse_weight;
 
 	REAL *		drow;
 	REAL *		prow;
@@ -532,6 +541,7 @@ void inc_col_space(lprec *lp);
 void unscale_columns(lprec *lp);
 void btran(lprec *lp, REAL *row);
 short invert(lprec *lp);
+short extend_eta_rows(lprec *lp, int rcnt);
 void presolve(lprec *lp);
 
 
@@ -17,6 +17,36 @@ static short Break_bb;
 #define SINGULAR_BASIS			-2
 #define	LOST_PRIMAL_FEASIBILITY		-3
 
+/* Floor applied to the dual steepest-edge reference weights, which	*/
+/* protects the pricing ratio against cancellation in the update.	*/
+#define	DSE_MIN_WEIGHT			1e-4
+
+/* Threshold for Markowitz pivoting in the bump of invert():  a pivot	*/
+/* must be at least this fraction of the largest eligible entry.	*/
+#define	INVERT_PIVOT_TOL		0.1
+
+/* Reinvert early once the eta columns appended since the last invert	*/
+/* hold ETA_GROWTH_FACTOR times as many nonzeros as the factorization	*/
+/* itself (but never before ETA_MIN_PIVOTS pivots).			*/
+#define	ETA_GROWTH_FACTOR		2
+#define	ETA_MIN_PIVOTS			10
+
+/* Pattern of one row (or column) of the active submatrix of the bump.	*/
+/* Entries are never removed:  those of rows and columns that have	*/
+/* left the active submatrix are simply skipped.			*/
+struct bump_list {
+	int *	ent;		/* column (or row) numbers */
+	int	len;		/* number of entries */
+	int	alloc;		/* allocated size of ent[] */
+};
+
+/* One candidate of the bound-flipping dual ratio test. */
+struct bfrt_cand {
+	int	varnr;		/* variable number */
+	REAL	quot;		/* dual ratio (breakpoint) */
+	REAL	absd;		/* |pivot row entry| */
+};
+
 
 static void ftran(lprec *lp, REAL *pcol)
 {
@@ -314,16 +344,36 @@ static void rhsmincol(lprec *lp,
 } /* rhsmincol */
 
 
+static void bump_add(struct bump_list *list, int x)
+{
+  if(list->len >= list->alloc) {
+    list->alloc = 2 * list->alloc + 4;
+    REALLOC(list->ent, list->alloc);
+  }
+  list->ent[list->len++] = x;
+} /* bump_add */
+
+
+/*
+ * Refactor the basis into a fresh eta file.  The bump is ordered by
+ * threshold Markowitz pivoting, but the result is still a product-form
+ * inverse, updated by one eta column per simplex pivot -- NOT a sparse
+ * LU with Forrest-Tomlin updates.  See README.custom for what replacing
+ * the eta file would involve.
+ */
+
 short invert(lprec *lp)
 {
-  int    i, j, v, wk, numit, varnr, row_nr, colnr, varin;
-  REAL   theta;
+  int    i, j, k, v, wk, numit, varnr, row_nr, colnr, varin, nbump, c, p;
+  REAL   theta, maxabs, f;
   REAL   *pcol;
   int	 singularities;
   short  *frow;
   short  *fcol;
   int    *rownum, *col, *row;
   int    *colnum;
+  int    *bump, *mark;
+  struct bump_list *brow, *bcol;
 
   if(lp->print_at_invert)
     printf("%% Start Invert iter %d eta_size %d rhs[0] %g \n",
@@ -455,30 +505,130 @@ short invert(lprec *lp)
 	row[numit - 1] = row_nr;
       }
   }
+
+  /* What remains is the "bump".  Factor it Markowitz style.  The	*/
+  /* pattern of the active submatrix is kept up to date, including the	*/
+  /* fill-in produced by each elimination, so that rownum[] and		*/
+  /* colnum[] always hold the current active counts.  At each step	*/
+  /* take the active column having the fewest nonzeros, and pivot it	*/
+  /* in the active row having the fewest nonzeros among those whose	*/
+  /* entry is at least INVERT_PIVOT_TOL times the largest one.  This	*/
+  /* keeps both the fill-in of the eta file and the growth of its	*/
+  /* entries small.							*/
+  MALLOC(bump, lp->columns + 1);
+  CALLOC(mark, lp->columns + 1);
+  CALLOC(brow, lp->rows + 1);
+  CALLOC(bcol, lp->columns + 1);
+  nbump = 0;
   for(j = 1; j <= lp->columns; j++)
-    if(fcol[j - 1]) {
-      fcol[j - 1] = FALSE;
-      setpivcol(lp, j + lp->rows, pcol);
-      row_nr = 1;
+    if(fcol[j - 1])
+      bump[nbump++] = j;
+  for(i = 1; i <= lp->rows; i++)
+    if(frow[i])
+      for(j = lp->row_end[i - 1] + 1; j <= lp->row_end[i]; j++) {
+	wk = lp->col_no[j];
+	if(fcol[wk - 1]) {
+	  bump_add(&brow[i], wk);
+	  bump_add(&bcol[wk], i);
+	}
+      }
+  for(i = 1; i <= lp->rows; i++)
+    rownum[i - 1] = frow[i] ? brow[i].len : 0;
+  for(k = 0; k < nbump; k++)
+    colnum[bump[k]] = bcol[bump[k]].len;
+
+  while(nbump > 0) {
+    k = 0;
+    for(p = 1; p < nbump; p++)
+      if((colnum[bump[p]] < colnum[bump[k]]) ||
+	 ((colnum[bump[p]] == colnum[bump[k]]) && (bump[p] < bump[k])))
+	k = p;
+    j = bump[k];
+    bump[k] = bump[--nbump];
+    fcol[j - 1] = FALSE;
+    setpivcol(lp, j + lp->rows, pcol);
+
+    maxabs = 0;
+    for(p = 0; p < bcol[j].len; p++) {
+      i = bcol[j].ent[p];
+      if(frow[i]) {
+	f = my_abs(pcol[i]);
+	if(f > maxabs)
+	  maxabs = f;
+      }
+    }
+
+    row_nr = 0;
+    if(maxabs > 0)
+      for(p = 0; p < bcol[j].len; p++) {
+	i = bcol[j].ent[p];
+	if(!frow[i])
+	  continue;
+	f = my_abs(pcol[i]);
+	if(f < INVERT_PIVOT_TOL * maxabs)
+	  continue;
+	if((row_nr == 0) ||
+	   (rownum[i - 1] < rownum[row_nr - 1]) ||
+	   ((rownum[i - 1] == rownum[row_nr - 1]) &&
+	    ((f > my_abs(pcol[row_nr])) ||
+	     ((f == my_abs(pcol[row_nr])) && (i < row_nr)))))
+	  row_nr = i;
+      }
 
-      while((row_nr <= lp->rows) && (!(frow[row_nr] && pcol[row_nr])))
-	row_nr++;
+    /* Column j leaves the active submatrix. */
+    for(p = 0; p < bcol[j].len; p++) {
+      i = bcol[j].ent[p];
+      if(frow[i])
+	rownum[i - 1]--;
+    }
 
-      /* if(row_nr == lp->rows + 1) */
-      if(row_nr > lp->rows) {
-	/* This column is singular!  Just skip it, leaving one of the */
-	/* slack variables basic in its place... */
-	printf("%% Column %d singular!\n", j);
-	++singularities;
+    if(row_nr == 0) {
+      /* This column is singular!  Just skip it, leaving one of the */
+      /* slack variables basic in its place... */
+      printf("%% Column %d singular!\n", j);
+      ++singularities;
+    }
+    else {
+      /* So does row row_nr... */
+      frow[row_nr] = FALSE;
+      rownum[row_nr - 1] = 0;
+      for(p = 0; p < brow[row_nr].len; p++) {
+	c = brow[row_nr].ent[p];
+	if(fcol[c - 1])
+	  colnum[c]--;
       }
-      else {
-	frow[row_nr] = FALSE;
-	condensecol(lp, row_nr, pcol);
-	theta = lp->rhs[row_nr] / (REAL) pcol[row_nr];
-	rhsmincol(lp, theta, row_nr, lp->rows + j);
-	addetacol(lp);
+      /* ...and every other active row of column j picks up the	*/
+      /* pattern of row row_nr (the fill-in).			*/
+      for(p = 0; p < bcol[j].len; p++) {
+	i = bcol[j].ent[p];
+	if(!frow[i])
+	  continue;
+	for(v = 0; v < brow[i].len; v++)
+	  mark[brow[i].ent[v]] = i;
+	for(v = 0; v < brow[row_nr].len; v++) {
+	  c = brow[row_nr].ent[v];
+	  if(!fcol[c - 1] || (mark[c] == i))
+	    continue;
+	  bump_add(&brow[i], c);
+	  bump_add(&bcol[c], i);
+	  rownum[i - 1]++;
+	  colnum[c]++;
+	}
       }
+      condensecol(lp, row_nr, pcol);
+      theta = lp->rhs[row_nr] / (REAL) pcol[row_nr];
+      rhsmincol(lp, theta, row_nr, lp->rows + j);
+      addetacol(lp);
     }
+  }
+  for(i = 1; i <= lp->rows; i++)
+    free(brow[i].ent);
+  for(j = 1; j <= lp->columns; j++)
+    free(bcol[j].ent);
+  free(bcol);
+  free(brow);
+  free(mark);
+  free(bump);
 
   for(i = numit - 1; i >= 0; i--) {
     colnr = col[i];
@@ -505,6 +655,7 @@ short invert(lprec *lp)
     printf("%% End Invert                eta_size %d rhs[0] %g\n",
 	    lp->eta_size, (double) - lp->rhs[0]);
 
+  lp->eta_nz_inv = lp->eta_col_end[lp->eta_size];
   JustInverted = TRUE;
   DoInvert = FALSE;
   free(rownum);
@@ -515,9 +666,216 @@ short invert(lprec *lp)
   free(fcol);
   free(colnum);
 
+  if(singularities > 0)
+    lp->dse_valid = FALSE;
+
   return (singularities <= 0);
 } /* invert */
 
+
+/*
+ * Extend a current factorization to cover rcnt rows that add_rows() has
+ * just appended (as rows rows-rcnt+1 .. rows), whose slack variables
+ * are basic.  The new basis is [B 0; R I], with inverse [B^-1 0;
+ * -R B^-1 I], so one eta column per basic structural variable having
+ * non-zeros in the new rows suffices, and the old eta columns remain
+ * valid as they are.  The values of the new basic slacks are computed
+ * directly from the current solution.  Returns FALSE (leaving lp
+ * untouched) if the factorization cannot be extended; the caller must
+ * then reinvert.
+ */
+
+short extend_eta_rows(lprec *lp, int rcnt)
+{
+  int  i, j, k, p, varnr, colnr, oldrows, needed, elnr;
+  REAL *x, f;
+
+  oldrows = lp->rows - rcnt;
+
+  /* Count the eta columns needed.  They are charged against the pivot */
+  /* budget so that the eta file never outgrows eta_col_end[].	       */
+  needed = 0;
+  for(p = 1; p <= oldrows; p++) {
+    varnr = lp->bas[p];
+    if(varnr <= lp->rows)
+      continue;
+    colnr = varnr - lp->rows;
+    for(j = lp->col_end[colnr - 1]; j < lp->col_end[colnr]; j++)
+      if(lp->mat[j].row_nr > oldrows) {
+	++needed;
+	break;
+      }
+  }
+  if(lp->num_inv + needed >= lp->max_num_inv)
+    return(FALSE);
+
+  /* Current (untransformed) value of every structural variable. */
+  CALLOC(x, lp->columns + 1);
+  for(i = 1; i <= lp->columns; i++) {
+    varnr = lp->rows + i;
+    if(!lp->basis[varnr] && !lp->lower[varnr])
+      x[i] = lp->orig_upbo[varnr];
+    else
+      x[i] = lp->orig_lowbo[varnr];
+  }
+  for(p = 1; p <= oldrows; p++)
+    if(lp->bas[p] > lp->rows)
+      x[lp->bas[p] - lp->rows] += lp->rhs[p];
+
+  /* The new slacks take up whatever the current solution leaves. */
+  for(i = oldrows + 1; i <= lp->rows; i++)
+    lp->rhs[i] = lp->orig_rh[i];
+  for(i = 1; i <= lp->columns; i++)
+    if(x[i] != 0)
+      for(j = lp->col_end[i - 1]; j < lp->col_end[i]; j++)
+	if(lp->mat[j].row_nr > oldrows)
+	  lp->rhs[lp->mat[j].row_nr] -= x[i] * lp->mat[j].value;
+  for(i = oldrows + 1; i <= lp->rows; i++) {
+    f = lp->rhs[i];
+    my_round(f, lp->epsb);
+    lp->rhs[i] = f;
+  }
+  free(x);
+
+  /* Append the eta columns -R B^-1. */
+  for(p = 1; p <= oldrows; p++) {
+    varnr = lp->bas[p];
+    if(varnr <= lp->rows)
+      continue;
+    colnr = varnr - lp->rows;
+    elnr = lp->eta_col_end[lp->eta_size];
+    if(elnr + rcnt + 2 >= lp->eta_alloc)
+      resize_eta(lp);
+    k = elnr;
+    for(j = lp->col_end[colnr - 1]; j < lp->col_end[colnr]; j++)
+      if(lp->mat[j].row_nr > oldrows) {
+	lp->eta_row_nr[elnr] = lp->mat[j].row_nr;
+	lp->eta_value[elnr] = -lp->mat[j].value;
+	elnr++;
+      }
+    if(elnr == k)
+      continue;
+    lp->eta_row_nr[elnr] = p;
+    lp->eta_value[elnr] = 1;
+    elnr++;
+    lp->eta_size++;
+    lp->eta_col_end[lp->eta_size] = elnr;
+    lp->num_inv++;
+  }
+
+  return(TRUE);
+} /* extend_eta_rows */
+
+
+/*
+ * Return TRUE if the eta columns appended since the last invert have
+ * grown large enough that every ftran/btran now costs more than a
+ * fresh factorization would save.
+ */
+
+static short eta_overgrown(lprec *lp)
+{
+  int base;
+
+  if(lp->num_inv < ETA_MIN_PIVOTS)
+    return(FALSE);
+  base = lp->eta_nz_inv;
+  if(base < lp->rows)
+    base = lp->rows;
+  return(lp->eta_col_end[lp->eta_size] - lp->eta_nz_inv
+	 > ETA_GROWTH_FACTOR * base);
+} /* eta_overgrown */
+
+
+/*
+ * Make sure that the dual steepest-edge weights are allocated and
+ * consistent with the current basis.  When they are not, reset them
+ * all to one -- which is exact for the slack basis, and a reasonable
+ * reference framework for any other.
+ */
+
+static void dse_init(lprec *lp)
+{
+  int i;
+
+  if(lp->dse_alloc < lp->sum + 1) {
+    lp->dse_alloc = lp->sum_alloc + 1;
+    REALLOC(lp->dse_weight, lp->dse_alloc);
+    lp->dse_valid = FALSE;
+  }
+  if(!lp->dse_valid) {
+    for(i = 0; i <= lp->sum; i++)
+      lp->dse_weight[i] = 1;
+    lp->dse_valid = TRUE;
+  }
+} /* dse_init */
+
+
+/*
+ * Compute the exact dual steepest-edge weight ||e_i' B^-1||^2 of every
+ * basic variable.  This costs one btran per row, so it is only done
+ * when the result can be reused many times (see save_LP_basis).
+ */
+
+static void dse_exact(lprec *lp)
+{
+  int  i, j;
+  REAL *rho, w;
+
+  dse_init(lp);
+  CALLOC(rho, lp->rows + 1);
+  for(i = 1; i <= lp->rows; i++) {
+    for(j = 0; j <= lp->rows; j++)
+      rho[j] = 0;
+    rho[i] = 1;
+    btran(lp, rho);
+    w = 0;
+    for(j = 0; j <= lp->rows; j++)
+      w += rho[j] * rho[j];
+    lp->dse_weight[lp->bas[i]] = (w < DSE_MIN_WEIGHT) ? DSE_MIN_WEIGHT : w;
+  }
+  free(rho);
+} /* dse_exact */
+
+
+/*
+ * Update the dual steepest-edge weights for the pivot about to be made
+ * (variable varin enters in row row_nr).  This must be called before
+ * the new eta column is appended, because tau = B^-1 rho is needed for
+ * the OLD basis.  On entry prow[0..rows] holds rho = e_r' B^-1 (as left
+ * by coldual) and Pcol holds the ftran'ed entering column.
+ */
+
+static void dse_update(lprec *lp,
+		       int row_nr,
+		       int varin,
+		       REAL *prow,
+		       REAL *Pcol,
+		       REAL *tau)
+{
+  int  i;
+  REAL wr, ratio, w, piv;
+
+  wr = 0;
+  for(i = 0; i <= lp->rows; i++) {
+    tau[i] = prow[i];
+    wr += prow[i] * prow[i];
+  }
+  ftran(lp, tau);
+
+  piv = Pcol[row_nr];
+  for(i = 1; i <= lp->rows; i++) {
+    if(i == row_nr || Pcol[i] == 0)
+      continue;
+    ratio = Pcol[i] / piv;
+    w = lp->dse_weight[lp->bas[i]]
+      + ratio * (ratio * wr - 2 * tau[i]);
+    lp->dse_weight[lp->bas[i]] = (w < DSE_MIN_WEIGHT) ? DSE_MIN_WEIGHT : w;
+  }
+  w = wr / (piv * piv);
+  lp->dse_weight[varin] = (w < DSE_MIN_WEIGHT) ? DSE_MIN_WEIGHT : w;
+} /* dse_update */
+
 static int colprim(lprec *lp,
 		   short minit,
 		   REAL   *drow)
@@ -662,11 +1020,13 @@ static int rowprim(lprec *lp,
 static int rowdual(lprec *lp)
 {
   int   i, row_nr;
-  REAL  f, g, minrhs;
+  REAL  f, g, score, maxscore;
   short artifs;
 
+  /* Dual steepest-edge pricing: among the primal infeasible rows pick */
+  /* the one maximizing infeasibility^2 / ||e_i' B^-1||^2.		*/
   row_nr = 0;
-  minrhs = -lp->epsb;
+  maxscore = 0;
   i = 0;
   artifs = FALSE;
   while(i < lp->rows && !artifs) {
@@ -681,9 +1041,12 @@ static int rowdual(lprec *lp)
 	g = lp->rhs[i];
       else
 	g = f - lp->rhs[i];
-      if(g < minrhs) {
-	minrhs = g;
-	row_nr = i;
+      if(g < -lp->epsb) {
+	score = g * g / lp->dse_weight[lp->bas[i]];
+	if(score > maxscore) {
+	  maxscore = score;
+	  row_nr = i;
+	}
       }
     }
   }
@@ -703,14 +1066,92 @@ static int rowdual(lprec *lp)
   return(row_nr);
 } /* rowdual */
 
+static int bfrt_compare(const void *p1, const void *p2)
+{
+  const struct bfrt_cand *c1 = (const struct bfrt_cand *) p1;
+  const struct bfrt_cand *c2 = (const struct bfrt_cand *) p2;
+
+  if(c1->quot < c2->quot)
+    return(-1);
+  if(c1->quot > c2->quot)
+    return(1);
+  /* Equal ratios: prefer the larger pivot element. */
+  if(c1->absd > c2->absd)
+    return(-1);
+  if(c1->absd < c2->absd)
+    return(1);
+  return(c1->varnr - c2->varnr);
+} /* bfrt_compare */
+
+
+/*
+ * Move every variable in flips[0..nflip-1] to its opposite bound, and
+ * update the basic solution accordingly.  All the flips are accumulated
+ * into a single column so that only one ftran is needed.
+ */
+
+static void flip_bounds(lprec *lp,
+			struct bfrt_cand *flips,
+			int nflip,
+			REAL *wcol)
+{
+  int  i, j, k, colnr;
+  REAL up, f;
+
+  for(i = 0; i <= lp->rows; i++)
+    wcol[i] = 0;
+
+  for(k = 0; k < nflip; k++) {
+    j = flips[k].varnr;
+    up = lp->lower[j] ? lp->upbo[j] : -lp->upbo[j];
+    if(j > lp->rows) {
+      colnr = j - lp->rows;
+      for(i = lp->col_end[colnr - 1]; i < lp->col_end[colnr]; i++)
+	wcol[lp->mat[i].row_nr] += up * lp->mat[i].value;
+      wcol[0] -= up * Extrad;
+    }
+    else
+      wcol[j] += up;
+  }
+
+  ftran(lp, wcol);
+
+  for(i = 0; i <= lp->rows; i++) {
+    f = lp->rhs[i] - wcol[i];
+    my_round(f, lp->epsb);
+    lp->rhs[i] = f;
+  }
+
+  for(k = 0; k < nflip; k++) {
+    j = flips[k].varnr;
+    lp->lower[j] = !lp->lower[j];
+    if(lp->trace)
+      printf("%% Bound flip: variable %d moved to its %s bound\n",
+	     j, lp->lower[j] ? "lower" : "upper");
+  }
+} /* flip_bounds */
+
+
+/*
+ * Dual ratio test with bound flipping ("long step" rule).  Breakpoints
+ * of the dual objective are passed in increasing order of ratio.  Each
+ * boxed candidate whose flip to the opposite bound still leaves the
+ * leaving row infeasible is flipped instead of being pivoted in, since
+ * the dual objective keeps improving past its breakpoint.  The first
+ * candidate that cannot be flipped enters the basis.  cand must have
+ * room for sum entries, and wcol for rows + 1.
+ */
+
 static int coldual(lprec *lp,
 		   int row_nr,
 		   short minit,
 		   REAL *prow,
-		   REAL *drow)
+		   REAL *drow,
+		   struct bfrt_cand *cand,
+		   REAL *wcol)
 {
-  int  i, j, k, r, varnr, *rowp, row, colnr;
-  REAL theta, quot, pivot, d, f, g, *valuep, value;
+  int  i, j, k, r, varnr, *rowp, row, colnr, ncand;
+  REAL quot, d, f, g, *valuep, value, slope;
 
   Doiter = FALSE;
   if(!minit) {
@@ -777,15 +1218,16 @@ static int coldual(lprec *lp,
     }
   }
 
-  if(lp->rhs[row_nr] > lp->upbo[lp->bas[row_nr]])
+  if(lp->rhs[row_nr] > lp->upbo[lp->bas[row_nr]]) {
     g = -1;
-  else
+    slope = lp->rhs[row_nr] - lp->upbo[lp->bas[row_nr]];
+  }
+  else {
     g = 1;
+    slope = -lp->rhs[row_nr];
+  }
 
-  pivot = 0;
-  colnr = 0;
-  theta = lp->infinite;
-
+  ncand = 0;
   for(i = 1; i <= lp->sum; i++) {
     if(lp->lower[i])
       d = prow[i] * g;
@@ -797,18 +1239,32 @@ static int coldual(lprec *lp,
 	quot = -drow[i] / (REAL) d;
       else
 	quot = drow[i] / (REAL) d;
-      if(quot < theta) {
-	theta = quot;
-	pivot = d;
-	colnr = i;
-      }
-      else if((quot == theta) && (my_abs(d) > my_abs(pivot))) {
-	pivot = d;
-	colnr = i;
-      }
+      cand[ncand].varnr = i;
+      cand[ncand].quot = quot;
+      cand[ncand].absd = -d;
+      ncand++;
     }
   }
 
+  colnr = 0;
+  if(ncand > 0) {
+    qsort(cand, ncand, sizeof(cand[0]), bfrt_compare);
+
+    /* Never flip the last candidate -- something must enter. */
+    for(k = 0; k < ncand - 1; k++) {
+      j = cand[k].varnr;
+      if(lp->upbo[j] >= lp->infinite)
+	break;
+      f = slope - cand[k].absd * lp->upbo[j];
+      if(f <= lp->epsb)
+	break;
+      slope = f;
+    }
+    colnr = cand[k].varnr;
+    if(k > 0)
+      flip_bounds(lp, cand, k, wcol);
+  }
+
   if(lp->trace)
     printf("%% col_dual:%d, pivot element:  %18g\n", colnr,
 	    (double)prow[colnr]);
@@ -923,6 +1379,9 @@ static void primloop(lprec *lp)
   CALLOC(prow, lp->sum + 1);
   CALLOC(Pcol, lp->rows + 1);
 
+  /* Primal pivots do not maintain the dual steepest-edge weights. */
+  lp->dse_valid = FALSE;
+
   Status = RUNNING;
   primal = TRUE;
   DoInvert = FALSE;
@@ -952,7 +1411,7 @@ static void primloop(lprec *lp)
 		&lp->lower[colnr], primal, Pcol);
     }
 
-    if(lp->num_inv >= lp->max_num_inv)
+    if(lp->num_inv >= lp->max_num_inv || eta_overgrown(lp))
       DoInvert = TRUE;
 
     if(DoInvert) {
@@ -982,9 +1441,10 @@ static void dualloop(lprec *lp)
   int    i, j;
   REAL   f, theta;
   short  primal;
-  REAL   *drow, *prow, *Pcol;
+  REAL   *drow, *prow, *Pcol, *tau;
   short  minit;
   int    colnr, row_nr;
+  struct bfrt_cand *cand;
 
   if(lp->trace)
     printf("%% Entering dual algorithm\n");
@@ -992,6 +1452,10 @@ static void dualloop(lprec *lp)
   CALLOC(drow, lp->sum + 1);
   CALLOC(prow, lp->sum + 1);
   CALLOC(Pcol, lp->rows + 1);
+  CALLOC(tau, lp->rows + 1);	/* also scratch for coldual's flips */
+  MALLOC(cand, lp->sum + 1);
+
+  dse_init(lp);
 
   Status = RUNNING;
   primal = FALSE;
@@ -1033,7 +1497,7 @@ static void dualloop(lprec *lp)
       row_nr = rowdual(lp);
 
     if(row_nr > 0 ) {
-      colnr = coldual(lp, row_nr, minit, prow, drow);
+      colnr = coldual(lp, row_nr, minit, prow, drow, cand, tau);
       if(colnr > 0) {
 	setpivcol(lp, colnr, Pcol);
 
@@ -1092,6 +1556,9 @@ static void dualloop(lprec *lp)
 	  }
 	  else /* f <= 0 */
 	    theta = lp->rhs[row_nr] / (REAL) Pcol[row_nr];
+
+	  if(theta <= lp->upbo[colnr] + lp->epsb)
+	    dse_update(lp, row_nr, colnr, prow, Pcol, tau);
 	}
       }
       else
@@ -1108,7 +1575,7 @@ static void dualloop(lprec *lp)
       iteration(lp, row_nr, colnr, &theta, lp->upbo[colnr], &minit,
 		&lp->lower[colnr], primal, Pcol);
 
-    if(lp->num_inv >= lp->max_num_inv)
+    if(lp->num_inv >= lp->max_num_inv || eta_overgrown(lp))
       DoInvert = TRUE;
 
     if(DoInvert) {
@@ -1122,6 +1589,8 @@ static void dualloop(lprec *lp)
   free(drow);
   free(prow);
   free(Pcol);
+  free(tau);
+  free(cand);
 }
 
 
@@ -1420,15 +1889,18 @@ static int milpsolve(lprec *lp,
     lp->eta_valid = FALSE;
   }
 
+  /* transform to all lower bounds to zero */
+  for(i = 1; i <= lp->columns; i++)
+    if((theta = lp->lowbo[lp->rows + i]) != 0) {
+      if(lp->upbo[lp->rows + i] < lp->infinite)
+	lp->upbo[lp->rows + i] -= theta;
+      for(j = lp->col_end[i - 1]; j < lp->col_end[i]; j++)
+	lp->rh[lp->mat[j].row_nr] -= theta * lp->mat[j].value;
+    }
+
+  /* A factorization still valid from the previous solve() (possibly */
+  /* extended by add_rows) lets us continue from its optimum.	      */
   if(!lp->eta_valid) {
-    /* transform to all lower bounds to zero */
-    for(i = 1; i <= lp->columns; i++)
-      if((theta = lp->lowbo[lp->rows + i]) != 0) {
-	if(lp->upbo[lp->rows + i] < lp->infinite)
-	  lp->upbo[lp->rows + i] -= theta;
-	for(j = lp->col_end[i - 1]; j < lp->col_end[i]; j++)
-	  lp->rh[lp->mat[j].row_nr] -= theta * lp->mat[j].value;
-      }
     invert(lp);
     lp->eta_valid = TRUE;
   }
@@ -1726,12 +2198,18 @@ int solve(lprec *lp)
 	lp->lower[i] = TRUE;
 
       lp->basis_valid = TRUE;
+      lp->dse_valid   = FALSE;
+      lp->eta_valid   = FALSE;
     }
 
-    lp->eta_valid = FALSE;
     Break_bb      = FALSE;
     result        = milpsolve(lp, lp->orig_upbo, lp->orig_lowbo, lp->basis,
 			      lp->lower, lp->bas, FALSE);
+
+    /* Only an optimal, unbranched solve leaves the factorization and */
+    /* basic solution consistent with the problem as it now stands.   */
+    if(result != OPTIMAL || lp->total_nodes > 1)
+      lp->eta_valid = FALSE;
     return(result);
   }
 
@@ -1797,6 +2275,7 @@ double		theta;
 	CALLOC (basp -> basis, sum + 1);
 	CALLOC (basp -> lower, sum + 1);
 	CALLOC (basp -> rhs, rows + 1);
+	CALLOC (basp -> dse_weight, sum + 1);
 	CALLOC (basp -> drow, sum + 1);
 	CALLOC (basp -> prow, sum + 1);
 	CALLOC (basp -> Pcol, rows + 1);
@@ -1807,6 +2286,11 @@ double		theta;
 	memcpy (basp -> basis, lp -> basis, (sum + 1) * sizeof (short));
 	memcpy (basp -> lower, lp -> lower, (sum + 1) * sizeof (short));
 	memcpy (basp -> rhs, lp -> rhs, (rows + 1) * sizeof (REAL));
+
+	/* Each try_branch starts from this basis, so it pays to	*/
+	/* compute exact dual steepest-edge weights here once.		*/
+	dse_exact (lp);
+	memcpy (basp -> dse_weight, lp -> dse_weight, (sum + 1) * sizeof (REAL));
 }
 
 /*
@@ -1822,6 +2306,7 @@ struct basis_save *	basp		/* IN - basis info to free up */
 	free ((char *) (basp -> Pcol));
 	free ((char *) (basp -> prow));
 	free ((char *) (basp -> drow));
+	free ((char *) (basp -> dse_weight));
 	free ((char *) (basp -> rhs));
 	free ((char *) (basp -> lower));
 	free ((char *) (basp -> basis));
@@ -1858,6 +2343,8 @@ short		primal;
 REAL *		drow;
 REAL *		prow;
 REAL *		Pcol;
+REAL *		tau;
+struct bfrt_cand *	cand;
 REAL		save_lb;
 REAL		save_ub;
 short		minit;
@@ -1884,6 +2371,13 @@ int		row_nr;
 	drow	= basp -> drow;
 	prow	= basp -> prow;
 	Pcol	= basp -> Pcol;
+	CALLOC (tau, lp -> rows + 1);
+	MALLOC (cand, lp -> sum + 1);
+
+	dse_init (lp);
+	memcpy (lp -> dse_weight,
+		basp -> dse_weight,
+		(lp -> sum + 1) * sizeof (REAL));
 
 	lp -> iter = 0;
 	minit = FALSE;
@@ -1970,7 +2464,7 @@ int		row_nr;
 			row_nr = rowdual (lp);
 		}
 		if (row_nr > 0 ) {
-			colnr = coldual (lp, row_nr, minit, prow, drow);
+			colnr = coldual (lp, row_nr, minit, prow, drow, cand, tau);
 			if (colnr > 0) {
 				setpivcol (lp, colnr, Pcol);
 				/* getting div by zero here ... MB */
@@ -1995,6 +2489,10 @@ int		row_nr;
 					else { /* f <= 0 */
 						theta = lp -> rhs [row_nr] / (REAL) Pcol [row_nr];
 					}
+					if (theta <= lp -> upbo [colnr] + lp -> epsb) {
+						dse_update (lp, row_nr, colnr,
+							    prow, Pcol, tau);
+					}
 				}
 			}
 			else {
@@ -2045,6 +2543,12 @@ int		row_nr;
 	memcpy (lp -> basis, basp -> basis, (lp -> sum + 1) * sizeof (short));
 	memcpy (lp -> lower, basp -> lower, (lp -> sum + 1) * sizeof (short));
 	memcpy (lp -> rhs, basp -> rhs, (lp -> rows + 1) * sizeof (REAL));
+	memcpy (lp -> dse_weight,
+		basp -> dse_weight,
+		(lp -> sum + 1) * sizeof (REAL));
+
+	free ((char *) cand);
+	free ((char *) tau);
 
 	if (Status == INFEASIBLE) {
 		return (ival);
@@ -0,0 +1,124 @@
+/***********************************************************************
+
+	File:	lpbackend.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Selection of the LP solver backend.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "lpbackend.h"
+
+#include "config.h"
+#include "fatal.h"
+#include "geosteiner.h"
+#include "logic.h"
+#include "parmblk.h"
+#include "steiner.h"
+#include <string.h>
+
+
+/*
+ * Global Routines
+ */
+
+const struct lp_backend *	_gst_select_lp_backend (gst_param_ptr params);
+bool				_gst_valid_lp_solver (const char * name);
+
+
+/*
+ * Local Routines
+ */
+
+static const struct lp_backend *	find_backend (const char * name);
+
+
+/*
+ * The backends compiled into this library.  The first one is the
+ * default.  lp_solve is always available; CPLEX is listed when the
+ * library is configured with it.  A new LP solver is added by
+ * implementing the operations of "struct lp_backend" and listing it
+ * here.
+ */
+
+static const struct lp_backend * const	backends [] = {
+#ifdef CPLEX
+	&_gst_cplex_backend,
+#endif
+	&_gst_lpsolve_backend,
+	NULL
+};
+
+/*
+ * Return the backend to use for the given parameter set.  A NULL
+ * LP_SOLVER parameter selects the default backend.
+ */
+
+	const struct lp_backend *
+_gst_select_lp_backend (
+
+gst_param_ptr		params		/* IN - parameter set */
+)
+{
+const struct lp_backend *	be;
+
+	be = find_backend (params -> lp_solver);
+	if (be EQ NULL) {
+		/* The parameter was validated when it was set... */
+		FATAL_ERROR;
+	}
+
+	return (be);
+}
+
+/*
+ * Validation function for the LP_SOLVER parameter.
+ */
+
+	bool
+_gst_valid_lp_solver (
+
+const char *		name		/* IN - proposed backend name */
+)
+{
+	return (find_backend (name) NE NULL);
+}
+
+/*
+ * Look up a backend by name.
+ */
+
+	static
+	const struct lp_backend *
+find_backend (
+
+const char *		name		/* IN - backend name, or NULL */
+)
+{
+int				i;
+const struct lp_backend *	be;
+
+	if (name EQ NULL) {
+		return (backends [0]);
+	}
+
+	for (i = 0; ; i++) {
+		be = backends [i];
+		if (be EQ NULL) break;
+		if (strcmp (be -> name, name) EQ 0) {
+			return (be);
+		}
+	}
+
+	return (NULL);
+}
@@ -0,0 +1,225 @@
+/***********************************************************************
+
+	File:	lpbackend.h
+	Rev:	a-2
+	Date:	10/18/2026
+
+************************************************************************
+
+	Interface between GeoSteiner and an LP solver backend.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.  Split the per-solver LP operations of
+		:  constrnt.c and bb.c out behind a table of
+		:  function pointers.
+	a-2:	10/18/2026
+		: Made LP_t an opaque handle owned by its backend.
+		: Route strong branching, the objective cutoff and
+		:  the private LPs of localcut.c and analyze.c
+		:  through the table as well.
+		: Backend selected at run time by GST_PARAM_LP_SOLVER.
+
+************************************************************************/
+
+#ifndef	LPBACKEND_H
+#define	LPBACKEND_H
+
+#include "bitmaskmacros.h"
+#include "config.h"
+#include "gsttypes.h"
+
+struct bbinfo;
+struct cpool;
+struct gst_channel;
+struct gst_hypergraph;
+struct gst_param;
+struct lp_backend;
+
+
+/*
+ * An LP problem instance.  The generic code sees only the backend that
+ * owns the instance.  Everything else is private to that backend, which
+ * keeps its own problem object (and any memory that must live as long
+ * as it does) behind the "solver" pointer.
+ */
+
+struct lp_instance {
+	const struct lp_backend *	backend;  /* backend owning this LP */
+	void *				solver;	  /* backend's own LP state */
+};
+
+typedef struct lp_instance	LP_t;
+
+
+/*
+ * Equates for the operations below.
+ */
+
+#define	LP_MINIMIZE	1		/* sense of the objective */
+#define	LP_MAXIMIZE	(-1)
+
+#define	LP_INFINITY	1.0e20		/* bounds at or beyond this are */
+					/* infinite */
+
+#define	LP_OPTIMAL	0		/* status codes of optimize() */
+#define	LP_INFEASIBLE	1
+#define	LP_UNBOUNDED	2
+#define	LP_FAILED	3
+
+
+/*
+ * The operations that GeoSteiner needs from an LP solver.  Each backend
+ * provides one of these, and every operation on an LP is dispatched
+ * through the backend recorded in its LP_t.
+ *
+ * Variable and row numbers are 0-based.  Rows are given row-wise:
+ * row i has the coefficients matbeg [i] .. matbeg [i+1]-1 of matind
+ * and matval, and a sense of 'L', 'E' or 'G'.  The basis status codes
+ * in cstat/rstat are backend-specific, but they must be preserved
+ * unchanged by the caller from get_basis() to set_basis().
+ */
+
+struct lp_backend {
+	const char *	name;		/* name used by GST_PARAM_LP_SOLVER */
+
+	/* TRUE if the branch-and-cut should delete slack rows	*/
+	/* before separating a solution rather than after.	*/
+	bool		delete_slack_first;
+
+	/* ---- The LP of the branch-and-cut ---- */
+
+	/* Build the initial formulation from the given pool. */
+	LP_t *		(*build) (struct cpool *		pool,
+				  bitmap_t *			vert_mask,
+				  bitmap_t *			edge_mask,
+				  struct gst_hypergraph *	cip,
+				  struct gst_param *		params);
+
+	/* Append the pending pool rows to the LP. */
+	void		(*add_pending_rows) (struct bbinfo * bbip);
+
+	/* Solve the LP, returning a BBLP_xxx status code. */
+	int		(*solve) (struct bbinfo *	bbip,
+				  double *		x,
+				  double *		dj,
+				  int			pool_iteration);
+
+	/* Bracket one run of the branch-and-cut over the LP. */
+	void		(*begin_bb) (LP_t * lp);
+	void		(*end_bb) (LP_t * lp);
+
+	/* LPs whose optimum exceeds ub may be cut off early. */
+	void		(*set_cutoff) (LP_t * lp, double ub);
+
+	/* Snapshot the current (optimal) basis for try_branch(). */
+	void		(*save_branch_basis) (LP_t * lp);
+	void		(*free_branch_basis) (LP_t * lp);
+
+	/* Solve with variable var fixed to dir, then restore the	*/
+	/* snapshot.  Returns the objective, or ival if infeasible.	*/
+	double		(*try_branch) (LP_t *			lp,
+				       int			var,
+				       int			dir,
+				       double *			x,
+				       double			ival,
+				       struct gst_channel *	trace);
+
+	/* ---- Any LP ---- */
+
+	/* Create an LP with ncols columns and no rows.  The	*/
+	/* row and non-zero counts are only sizing hints.	*/
+	LP_t *		(*create) (const char *	name,
+				   int		ncols,
+				   int		objsense,
+				   double *	obj,
+				   double *	lower,
+				   double *	upper,
+				   int		rowspace,
+				   int		nzspace);
+
+	/* Free the LP and all memory associated with it. */
+	void		(*destroy) (LP_t * lp);
+
+	/* Size of the LP. */
+	int		(*num_rows) (LP_t * lp);
+	int		(*num_cols) (LP_t * lp);
+	int		(*num_nz) (LP_t * lp);
+
+	/* Append nrows rows to the LP. */
+	void		(*add_rows) (LP_t *	lp,
+				     int	nrows,
+				     double *	rhs,
+				     char *	sense,
+				     int *	matbeg,
+				     int *	matind,
+				     double *	matval);
+
+	/* Delete every row i that has dflag [i] NE 0. */
+	void		(*delete_rows) (LP_t * lp, int * dflag);
+
+	/* Optimize the LP, returning an LP_xxx status code. */
+	int		(*optimize) (LP_t * lp);
+
+	/* Retrieve the objective, the variables and the row	*/
+	/* slacks of the last solution.  Any may be NULL.	*/
+	void		(*get_solution) (LP_t *		lp,
+					 double *	z,
+					 double *	x,
+					 double *	slack);
+
+	/* Retrieve the objective coefficients of the first n	*/
+	/* variables.						*/
+	void		(*get_obj) (LP_t * lp, double * obj, int n);
+
+	/* Retrieve the dual values of the rows of the last solution. */
+	void		(*get_duals) (LP_t * lp, double * pi);
+
+	/* Change the bounds of n variables at once. */
+	void		(*set_bounds) (LP_t *		lp,
+				       int		n,
+				       int *		index,
+				       double *		lower,
+				       double *		upper);
+
+	/* Retrieve/install the basis of the LP. */
+	void		(*get_basis) (LP_t * lp, int * cstat, int * rstat);
+	void		(*set_basis) (LP_t * lp, int * cstat, int * rstat);
+
+	/* TRUE if the LP currently has a valid basis. */
+	bool		(*have_basis) (LP_t * lp);
+};
+
+
+/*
+ * Some macros to do common things to LP's
+ */
+
+#define	GET_LP_NUM_COLS(lp)	((lp) -> backend -> num_cols (lp))
+#define	GET_LP_NUM_ROWS(lp)	((lp) -> backend -> num_rows (lp))
+#define	GET_LP_NUM_NZ(lp)	((lp) -> backend -> num_nz (lp))
+
+
+/*
+ * The backends that are compiled into the library.
+ */
+
+#ifdef CPLEX
+extern const struct lp_backend	_gst_cplex_backend;
+#endif
+
+extern const struct lp_backend	_gst_lpsolve_backend;
+
+
+/*
+ * Function Prototypes
+ */
+
+extern const struct lp_backend *
+			_gst_select_lp_backend (struct gst_param * params);
+extern bool		_gst_valid_lp_solver (const char * name);
+
+#endif
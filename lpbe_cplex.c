@@ -0,0 +1,1646 @@
+/***********************************************************************
+
+	File:	lpbe_cplex.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	The CPLEX backend of the LP solver interface (lpbackend.h).
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.  Moved the CPLEX code of constrnt.c, bb.c,
+		:  localcut.c and analyze.c here, behind an opaque
+		:  LP_t.
+
+************************************************************************/
+
+#include "lpbackend.h"
+
+#ifdef CPLEX
+
+#include "bb.h"
+#include "bitmap.h"
+#include "channels.h"
+#include "config.h"
+#include "constrnt.h"
+#include "cputime.h"
+#include "fatal.h"
+#include <float.h>
+#include "logic.h"
+#include "lpsolver.h"
+#include <math.h>
+#include "memory.h"
+#include "parmblk.h"
+#include "point.h"
+#include "steiner.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Local Types
+ */
+
+struct cplex_lp {
+	CPXLPptr	lp;		/* the CPLEX problem */
+
+	/* CPXloadlp() may keep pointers into the arrays that the	*/
+	/* problem was loaded from, so they live as long as it does.	*/
+	double *	objx;
+	double *	rhsx;
+	char *		senx;
+	int *		matbeg;
+	int *		matcnt;
+	int *		matind;
+	double *	matval;
+	double *	bdl;
+	double *	bdu;
+
+	int		obj_scale;	/* objective scaled by 2**-obj_scale */
+
+	int *		bs_cstat;	/* basis snapshot for try_branch */
+	int *		bs_rstat;
+
+	double		save_objlim;	/* OBJULIM outside of branch-and-cut */
+};
+
+#define	CPLEX_STATE(p)	((struct cplex_lp *) ((p) -> solver))
+#define	CPLEX_LP(p)	(CPLEX_STATE (p) -> lp)
+
+/*
+ * Local Routines
+ */
+
+static void		cplex_add_pending_rows (struct bbinfo *);
+static void		cplex_add_rows (LP_t *,
+					int,
+					double *,
+					char *,
+					int *,
+					int *,
+					double *);
+static void		cplex_begin_bb (LP_t *);
+static LP_t *		cplex_build (struct cpool *,
+				     bitmap_t *,
+				     bitmap_t *,
+				     struct gst_hypergraph *,
+				     gst_param_ptr);
+static LP_t *		cplex_create (const char *,
+				      int,
+				      int,
+				      double *,
+				      double *,
+				      double *,
+				      int,
+				      int);
+static void		cplex_delete_rows (LP_t *, int *);
+static void		cplex_destroy (LP_t *);
+static void		cplex_end_bb (LP_t *);
+static void		cplex_free_branch_basis (LP_t *);
+static void		cplex_get_basis (LP_t *, int *, int *);
+static void		cplex_get_duals (LP_t *, double *);
+static void		cplex_get_obj (LP_t *, double *, int);
+static void		cplex_get_solution (LP_t *,
+					    double *,
+					    double *,
+					    double *);
+static bool		cplex_have_basis (LP_t *);
+static int		cplex_num_cols (LP_t *);
+static int		cplex_num_nz (LP_t *);
+static int		cplex_num_rows (LP_t *);
+static int		cplex_optimize (LP_t *);
+static void		cplex_save_branch_basis (LP_t *);
+static void		cplex_set_basis (LP_t *, int *, int *);
+static void		cplex_set_bounds (LP_t *,
+					  int,
+					  int *,
+					  double *,
+					  double *);
+static void		cplex_set_cutoff (LP_t *, double);
+static int		cplex_solve (struct bbinfo *,
+				     double *,
+				     double *,
+				     int);
+static double		cplex_try_branch (LP_t *,
+					  int,
+					  int,
+					  double *,
+					  double,
+					  gst_channel_ptr);
+static void		free_cplex_problem (struct cplex_lp *);
+static void		load_cplex_problem (struct cplex_lp *,
+					    struct cpool *,
+					    bitmap_t *,
+					    bitmap_t *,
+					    struct gst_hypergraph *,
+					    gst_param_ptr);
+static LP_t *		new_instance (struct cplex_lp *);
+static void		reload_cplex_problem (struct bbinfo *);
+
+/*
+ * The CPLEX backend.  Slack rows are deleted before separation, which
+ * keeps the CPLEX problem buffers small.
+ */
+
+const struct lp_backend	_gst_cplex_backend = {
+	"cplex",
+	TRUE,
+	cplex_build,
+	cplex_add_pending_rows,
+	cplex_solve,
+	cplex_begin_bb,
+	cplex_end_bb,
+	cplex_set_cutoff,
+	cplex_save_branch_basis,
+	cplex_free_branch_basis,
+	cplex_try_branch,
+	cplex_create,
+	cplex_destroy,
+	cplex_num_rows,
+	cplex_num_cols,
+	cplex_num_nz,
+	cplex_add_rows,
+	cplex_delete_rows,
+	cplex_optimize,
+	cplex_get_solution,
+	cplex_get_obj,
+	cplex_get_duals,
+	cplex_set_bounds,
+	cplex_get_basis,
+	cplex_set_basis,
+	cplex_have_basis,
+};
+
+/*
+ * Build the LP relaxation over the initial constraints of the pool.
+ */
+
+	static
+	LP_t *
+cplex_build (
+
+struct cpool *		pool,		/* IN - initial constraint pool */
+bitmap_t *		vert_mask,	/* IN - set of valid vertices */
+bitmap_t *		edge_mask,	/* IN - set of valid hyperedges */
+struct gst_hypergraph *	cip,		/* IN - compatibility info */
+gst_param_ptr		params		/* IN - parameters */
+)
+{
+struct cplex_lp *	p;
+
+	p = NEW (struct cplex_lp);
+	memset (p, 0, sizeof (*p));
+
+	load_cplex_problem (p, pool, vert_mask, edge_mask, cip, params);
+
+	return (new_instance (p));
+}
+
+/*
+ * Load the LP relaxation over the pending constraints of the pool into
+ * a new CPLEX problem.  The problem and the arrays it was loaded from
+ * are recorded in the given backend state.
+ */
+
+	static
+	void
+load_cplex_problem (
+
+struct cplex_lp *	p,		/* OUT - backend state to fill in */
+struct cpool *		pool,		/* IN - initial constraint pool */
+bitmap_t *		vert_mask,	/* IN - set of valid vertices */
+bitmap_t *		edge_mask,	/* IN - set of valid hyperedges */
+struct gst_hypergraph *	cip,		/* IN - compatibility info */
+gst_param_ptr		params
+)
+{
+int			i, j, k;
+int			nedges;
+int			nrows;
+int			ncoeff;
+int			row;
+int			var;
+int *			tmp;
+struct rcon *		rcp;
+struct rcoef *		cp;
+CPXLPptr		lp;
+int			macsz, marsz, matsz;
+int			mac, mar;
+int			objsen;
+double *		objx;
+double *		rhsx;
+char *			senx;
+double *		bdl;
+double *		bdu;
+int *			matbeg;
+int *			matcnt;
+int *			matind;
+double *		matval;
+cpu_time_t		T0;
+cpu_time_t		T1;
+double			min_c, max_c, ci;
+int			min_exp, max_exp;
+int			obj_scale;
+char			tbuf [32];
+
+	T0 = _gst_get_cpu_time ();
+
+	nedges = cip -> num_edges;
+
+	/* We know exactly how many columns (variables) we will */
+	/* ever need.  We never add additional variables. */
+	/* PSW: In multi-objective mode, we need space for FST + not_covered variables */
+	int num_not_covered_lp = 0;
+	char* budget_env_check_lp = getenv("GEOSTEINER_BUDGET");
+	if (budget_env_check_lp != NULL) {
+		bitmap_t* vert_mask_lp = cip -> initial_vert_mask;
+		/* Count terminals for not_covered variables */
+		for (int i = 0; i < cip -> num_verts; i++) {
+			if (BITON (vert_mask_lp, i) && cip -> tflag[i]) {
+				num_not_covered_lp++;
+			}
+		}
+	}
+	macsz = nedges + num_not_covered_lp;
+	mac = macsz;
+
+	/* Build the objective function... */
+	objx = NEWA (macsz, double);
+	for (i = 0; i < macsz; i++) {
+		objx [i] = 0.0;
+	}
+
+	/* Set objective coefficients for FST variables */
+	if (budget_env_check_lp != NULL) {
+		/* Multi-objective mode: tree_cost + alpha * battery_cost */
+		double alpha = BUDGET_BATTERY_WEIGHT;
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
+
+			double tree_cost = (double) (cip -> cost [i]);
+			double battery_cost = 0.0;
+
+			/* Get battery cost from full_trees data */
+			if (cip -> full_trees != NULL && cip -> full_trees[i] != NULL) {
+				battery_cost = cip -> full_trees[i] -> battery_score;
+
+				/* If battery_score is 0, recalculate from edge terminals */
+				if (battery_cost == 0.0 && cip -> pts != NULL) {
+					int nedge_terminals = cip -> edge_size[i];
+					int *edge_terminals = cip -> edge[i];
+
+					for (int j = 0; j < nedge_terminals; j++) {
+						int k = edge_terminals[j];  /* 0-based terminal index */
+						if (k >= 0 && k < cip -> pts -> n) {
+							battery_cost += cip -> pts -> a[k].battery;
+						}
+					}
+				}
+			}
+
+			objx [i] = tree_cost + alpha * battery_cost;
+		}
+
+		/* Set objective coefficients for not_covered variables */
+		double beta = BUDGET_UNCOVERED_PENALTY;
+		for (i = 0; i < num_not_covered_lp; i++) {
+			objx [nedges + i] = beta;  /* Penalty for each uncovered terminal */
+		}
+	} else {
+		/* Default mode: use only tree costs */
+		FOR_EACH_SETBIT (i, edge_mask, nedges) {
+			objx [i] = (double) (cip -> cost [i]);
+		}
+	}
+
+	/* CPLEX does not behave well if the objective coefficients	*/
+	/* have very large magnitudes.  (If so, we often get "unscaled	*/
+	/* infeasibility" error codes.)  Therefore, we scale objx here	*/
+	/* (by an exact power of two so that the mantissas remain	*/
+	/* unchanged).  Determine a power of two that brings the objx	*/
+	/* magnitudes into a reasonable range.				*/
+
+	min_c	= DBL_MAX;
+	max_c	= 0.0;
+	for (i = 0; i < macsz; i++) {
+		ci = fabs (objx [i]);
+		if (ci EQ 0.0) continue;
+		if (ci < min_c) {
+			min_c = ci;
+		}
+		if (ci > max_c) {
+			max_c = ci;
+		}
+	}
+
+	(void) frexp (min_c, &min_exp);
+	(void) frexp (max_c, &max_exp);
+	obj_scale = (min_exp + max_exp) / 2;
+
+	/* Remember scale factor so we can unscale results. */
+	p -> obj_scale = obj_scale;
+
+	obj_scale = - obj_scale;
+
+	for (i = 0; i < macsz; i++) {
+		objx [i] = ldexp (objx [i], obj_scale);
+	}
+
+	objsen = _MYCPX_MIN;	/* Minimize */
+
+	/* Build variable bound arrays... */
+	bdl = NEWA (macsz, double);
+	bdu = NEWA (macsz, double);
+	for (i = 0; i < macsz; i++) {
+		bdl [i] = 0.0;
+		bdu [i] = 1.0;
+	}
+
+	mar	= pool -> npend;
+	if (pool -> hwmrow EQ 0) {
+		/* Initial allocation.  Allocate space sufficiently	*/
+		/* large that we are unlikely to need to reallocate the	*/
+		/* CPLEX problem buffers...				*/
+
+		/* Start with the total number of non-zeros in the	*/
+		/* entire constraint pool...				*/
+		ncoeff = 0;
+		nrows = pool -> nrows;
+		for (i = 0; i < nrows; i++) {
+			rcp = &(pool -> rows [i]);
+			ncoeff += rcp -> len;
+		}
+
+		marsz	= 2 * nrows;
+		matsz	= 4 * ncoeff;
+	}
+	else {
+		/* Reallocating CPLEX problem.  We want a moderate rate	*/
+		/* of growth, but must trade this off against the	*/
+		/* frequency of reallocation.  We expand both the rows	*/
+		/* and the non-zeros by 25% over the largest need seen	*/
+		/* now or previously.					*/
+		ncoeff = 0;
+		for (i = 0; i < pool -> npend; i++) {
+			row = pool -> lprows [i];
+			rcp = &(pool -> rows [row]);
+			ncoeff += rcp -> len;
+		}
+		if ((mar > pool -> hwmrow) OR (ncoeff > pool -> hwmnz)) {
+			/* high-water marks should be updated before! */
+			FATAL_ERROR;
+		}
+		marsz = 5 * pool -> hwmrow / 4;
+		matsz = 5 * pool -> hwmnz / 4;
+	}
+
+	if (marsz < params -> cplex_min_rows) {
+		marsz = params -> cplex_min_rows;
+	}
+	if (matsz < params -> cplex_min_nzs) {
+		matsz = params -> cplex_min_nzs;
+	}
+
+	gst_channel_printf (params -> print_solve_trace, "cpx allocation: %d rows, %d cols, %d nz\n",
+		marsz, macsz, matsz);
+
+	/* Allocate arrays for constraint matrix... */
+	rhsx = NEWA (marsz, double);
+	senx = NEWA (marsz, char);
+	matbeg = NEWA (macsz, int);
+	matcnt = NEWA (macsz, int);
+	matind = NEWA (matsz, int);
+	matval = NEWA (matsz, double);
+
+	for (i = 0; i < marsz; i++) {
+		rhsx [i] = 0.0;
+	}
+	for (i = 0; i < macsz; i++) {
+		matbeg [i] = 0;
+		matcnt [i] = 0;
+	}
+	for (i = 0; i < matsz; i++) {
+		matind [i] = 0;
+		matval [i] = 0.0;
+	}
+
+	/* Now go through each row k and compute the number of	*/
+	/* non-zero coefficients for each variable used...	*/
+	tmp = NEWA (macsz, int);
+	for (i = 0; i < macsz; i++) {
+		tmp [i] = 0;
+	}
+	for (i = 0; i < pool -> npend; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		for (cp = rcp -> coefs; ; cp++) {
+			var = cp -> var;
+			if (var < RC_VAR_BASE) break;
+			++(tmp [var - RC_VAR_BASE]);
+		}
+	}
+
+	/* CPLEX wants columns, not rows... */
+	j = 0;
+	for (i = 0; i < mac; i++) {
+		k = tmp [i];
+		matbeg [i] = j;
+		tmp [i] = j;
+		matcnt [i] = k;
+		j += k;
+	}
+	if (j > pool -> hwmnz) {
+		pool -> hwmnz = j;
+	}
+	if (mar > pool -> hwmrow) {
+		pool -> hwmrow = mar;
+	}
+	for (i = 0; i < pool -> npend; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		for (cp = rcp -> coefs; ; cp++) {
+			var = cp -> var;
+			if (var < RC_VAR_BASE) break;
+			j = tmp [var - RC_VAR_BASE];
+			matind [j] = i;
+			matval [j] = cp -> val;
+			++(tmp [var - RC_VAR_BASE]);
+		}
+		switch (var) {
+		case RC_OP_LE:	senx [i] = 'L';		break;
+		case RC_OP_EQ:	senx [i] = 'E';		break;
+		case RC_OP_GE:	senx [i] = 'G';		break;
+		default:
+			FATAL_ERROR;
+		}
+		rhsx [i] = cp -> val;
+		rcp -> lprow = i;
+	}
+
+	/* Verify consistency of what we generated... */
+	for (i = 0; i < mac; i++) {
+		if (tmp [i] NE matbeg [i] + matcnt [i]) {
+			fprintf (stderr,
+				 "i = %d, tmp = %d, matbeg = %d, matcnt = %d\n",
+				 i, tmp [i], matbeg [i], matcnt [i]);
+			FATAL_ERROR;
+		}
+	}
+
+	free ((char *) tmp);
+
+	pool -> nlprows	= pool -> npend;
+	pool -> npend	= 0;
+
+#if 0
+	_MYCPX_setadvind (1);		/* continue from previous basis. */
+#endif
+
+	lp = _MYCPX_loadlp ("root",
+			    mac,
+			    mar,
+			    objsen,
+			    objx,
+			    rhsx,
+			    senx,
+			    matbeg,
+			    matcnt,
+			    matind,
+			    matval,
+			    bdl,
+			    bdu,
+			    NULL,
+			    macsz,
+			    marsz,
+			    matsz);
+
+	FATAL_ERROR_IF (lp EQ NULL);
+
+	/* Remember the problem and the address of each buffer, for	*/
+	/* when we need to free them.					*/
+	p -> lp			= lp;
+	p -> objx		= objx;
+	p -> rhsx		= rhsx;
+	p -> senx		= senx;
+	p -> matbeg		= matbeg;
+	p -> matcnt		= matcnt;
+	p -> matind		= matind;
+	p -> matval		= matval;
+	p -> bdl		= bdl;
+	p -> bdu		= bdu;
+
+	T1 = _gst_get_cpu_time ();
+	_gst_convert_cpu_time (T1 - T0, tbuf);
+	gst_channel_printf (params -> print_solve_trace, "_gst_build_initial_formulation: %s seconds.\n", tbuf);
+}
+
+/*
+ * Append the pending rows of the constraint pool to the CPLEX problem.
+ */
+
+	static
+	void
+cplex_add_pending_rows (
+
+struct bbinfo *		bbip		/* IN - branch and bound info */
+)
+{
+int			i;
+int			j;
+int			i1;
+int			i2;
+int			newrows;
+int			ncoeff;
+int			row;
+int			nzi;
+int			var;
+int			num_nz;
+struct rcon *		rcp;
+struct rcoef *		cp;
+CPXLPptr		lp;
+struct cpool *		pool;
+double *		rhs;
+char *			sense;
+int *			matbeg;
+int *			matind;
+double *		matval;
+
+	lp	= CPLEX_LP (bbip -> lp);
+	pool	= bbip -> cpool;
+
+	if (_MYCPX_getnumrows (lp) NE pool -> nlprows) {
+		/* LP is out of sync with the pool... */
+		FATAL_ERROR;
+	}
+
+	/* Get number of rows and non-zeros to add to LP... */
+	newrows = pool -> npend;
+
+	FATAL_ERROR_IF (newrows < 0);
+
+	if (newrows EQ 0) return;
+
+	i1	= pool -> nlprows;
+	i2	= i1 + newrows;
+
+	/* Get number of rows and non-zeros to add to LP... */
+	ncoeff = 0;
+	for (i = i1; i < i2; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		if (rcp -> lprow NE -2) {
+			/* Constraint not pending? */
+			FATAL_ERROR;
+		}
+		rcp -> lprow = i;
+		ncoeff += rcp -> len;
+	}
+
+
+	gst_channel_printf (bbip -> params -> print_solve_trace, "@PAP adding %d rows, %d nz to LP\n", newrows, ncoeff);
+
+	num_nz	  = _MYCPX_getnumnz (lp);
+
+	/* Update high-water marks... */
+	if (i2 > pool -> hwmrow) {
+		pool -> hwmrow = i2;
+	}
+	if (num_nz + ncoeff > pool -> hwmnz) {
+		pool -> hwmnz = num_nz + ncoeff;
+	}
+
+#ifndef CPLEX_HAS_CREATEPROB
+	/* Check to see if the current CPLEX allocations are	*/
+	/* sufficient.  If not, we must reallocate...		*/
+	{ int row_space;
+	  int nz_space;
+	  row_space = _MYCPX_getrowspace (lp);
+	  nz_space  = _MYCPX_getnzspace (lp);
+	  if ((i2 > row_space) OR (num_nz + ncoeff > nz_space)) {
+		/* We must reallocate!  We do this by throwing away the */
+		/* old LP completely and building it again from scratch	*/
+		/* using only the info available in the constraint	*/
+		/* pool.  Hopefully this way we avoid poor memory	*/
+		/* utilization due to fragmentation...			*/
+
+		reload_cplex_problem (bbip);
+
+		return;
+	  }
+	}
+#endif
+
+	/* Allocate arrays for setting the rows... */
+	rhs	= NEWA (newrows, double);
+	sense	= NEWA (newrows, char);
+	matbeg	= NEWA (newrows + 1, int);
+	matind	= NEWA (ncoeff, int);
+	matval	= NEWA (ncoeff, double);
+
+	/* Put the rows into the format that CPLEX wants them in... */
+	nzi = 0;
+	j = 0;
+	for (i = i1; i < i2; i++, j++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		matbeg [j] = nzi;
+		for (cp = rcp -> coefs; ; cp++) {
+			var = cp -> var;
+			if (var < RC_VAR_BASE) break;
+			matind [nzi] = var - RC_VAR_BASE;
+			matval [nzi] = cp -> val;
+			++nzi;
+		}
+		rhs [j] = cp -> val;
+		switch (var) {
+		case RC_OP_LE:	sense [j] = 'L';	break;
+		case RC_OP_EQ:	sense [j] = 'E';	break;
+		case RC_OP_GE:	sense [j] = 'G';	break;
+		default:
+			FATAL_ERROR;
+			break;
+		}
+	}
+	matbeg [j] = nzi;
+	FATAL_ERROR_IF (nzi NE ncoeff);
+
+	i = _MYCPX_addrows (lp,
+			    0,
+			    newrows,
+			    ncoeff,
+			    rhs,
+			    sense,
+			    matbeg,
+			    matind,
+			    matval,
+			    NULL,
+			    NULL);
+
+	FATAL_ERROR_IF (i NE 0);
+
+	pool -> nlprows = i2;
+	pool -> npend	= 0;
+
+	free ((char *) matval);
+	free ((char *) matind);
+	free ((char *) matbeg);
+	free ((char *) sense);
+	free ((char *) rhs);
+}
+
+/*
+ * This routine solves a single LP tableaux using CPLEX.
+ */
+
+	static
+	int
+cplex_solve (
+
+struct bbinfo *		bbip,		/* IN - branch and bound info */
+double *		x,		/* OUT - LP solution variables */
+double *		dj,		/* OUT - LP reduced costs */
+int			pool_iteration	/* IN - pool iteration number */
+)
+{
+int			i;
+int			status;
+double			z;
+CPXLPptr		lp;
+double *		slack;
+int			nrows;
+int			ncols;
+int			non_zeros;
+int			nslack;
+bool			scaling_disabled;
+int			small;
+int			big;
+int			obj_scale;
+gst_channel_ptr		print_solve_trace;
+
+	print_solve_trace = bbip -> params -> print_solve_trace;
+
+	(void) pool_iteration;
+
+	lp	= CPLEX_LP (bbip -> lp);
+
+	scaling_disabled = FALSE;
+
+retry_lp:
+	/* Solve the current LP instance... */
+	status = _MYCPX_dualopt (lp);
+	if (status NE 0) {
+		gst_channel_printf (print_solve_trace, " WARNING dualopt: status = %d\n", status);
+	}
+
+	/* Get current LP solution... */
+	i = _MYCPX_solution (lp,
+			     &status,		/* solution status */
+			     &z,		/* objective value */
+			     x,			/* solution variables */
+			     NULL,		/* IGNORE dual values */
+			     bbip -> slack,	/* slack variables */
+			     dj);		/* reduced costs */
+	if (i NE 0) {
+		fprintf (stderr, "err_code = %d\n", i);
+		FATAL_ERROR;
+	}
+
+	obj_scale = CPLEX_STATE (bbip -> lp) -> obj_scale;
+	ncols	  = _MYCPX_getnumcols (lp);
+
+	if (obj_scale NE 0) {
+		/* Unscale CPLEX results. */
+		z = ldexp (z, obj_scale);
+		for (i = 0; i < ncols; i++) {
+			dj [i] = ldexp (dj [i], obj_scale);
+		}
+	}
+
+	bbip -> node -> z	= z;
+
+	/* Get solution status into solver-independent form... */
+	switch (status) {
+	case _MYCPX_STAT_OPTIMAL:
+		status = BBLP_OPTIMAL;
+		break;
+
+	case _MYCPX_STAT_INFEASIBLE:
+	case _MYCPX_STAT_UNBOUNDED:	/* (CPLEX sometimes gives this for an	*/
+				/* infeasible problem.)			*/
+		status = BBLP_INFEASIBLE;
+		break;
+
+	case _MYCPX_STAT_ABORT_OBJ_LIM:	/* Objective limit exceeded... */
+		status = BBLP_CUTOFF;
+		break;
+
+	case _MYCPX_STAT_OPTIMAL_INFEAS:
+		/* This means that CPLEX scaled the problem, found an	*/
+		/* optimal solution, unscaled the solution, but that	*/
+		/* the unscaled solution no longer satisfied all of the	*/
+		/* bound or row feasibility tolerances (i.e. the the	*/
+		/* unscaled solution is no longer feasible).  We fix	*/
+		/* This by turning off scaling and trying again.  Note	*/
+		/* that this happens very rarely, but that CPLEX runs	*/
+		/* much slower with scaling turned off, so we don't	*/
+		/* want to leave scaling off if we can help it...	*/
+		if (scaling_disabled) {
+			/* CPLEX is never supposed to return this code	*/
+			/* when scaling is diabled!			*/
+			FATAL_ERROR;
+		}
+
+		gst_channel_printf (print_solve_trace, "TURNING OFF SCALING...\n");
+
+		if (_MYCPX_setscaind (-1, &small, &big) NE 0) {
+			FATAL_ERROR;
+		}
+
+		/* Must reload the entire problem for this to take effect! */
+		reload_cplex_problem (bbip);
+		lp = CPLEX_LP (bbip -> lp);
+
+		scaling_disabled = TRUE;
+
+		goto retry_lp;
+
+	default:
+		fprintf (stderr, "Unexpected status = %d\n", status);
+		_MYCPX_lpwrite (lp, "core.lp");
+		FATAL_ERROR;
+		break;
+	}
+
+	if (scaling_disabled) {
+		/* Must re-enable scaling, or we'll be really slow! */
+		gst_channel_printf (print_solve_trace, "TURNING ON SCALING...\n");
+		if (_MYCPX_setscaind (0, &small, &big) NE 0) {
+			FATAL_ERROR;
+		}
+
+		/* Must reload entire problem for this to take affect! */
+		reload_cplex_problem (bbip);
+		lp = CPLEX_LP (bbip -> lp);
+	}
+
+	/* Print info about the LP tableaux we just solved... */
+	nrows	  = _MYCPX_getnumrows (lp);
+	ncols	  = _MYCPX_getnumcols (lp);
+	non_zeros = _MYCPX_getnumnz (lp);
+	slack = bbip -> slack;
+	nslack = 0;
+	for (i = 0; i < nrows; i++) {
+		if (slack [i] > FUZZ) {
+			++nslack;
+		}
+	}
+	(void) gst_channel_printf (print_solve_trace, "@PL %d rows, %d cols, %d nonzeros,"
+		       " %d slack, %d tight.\n",
+		       nrows, ncols, non_zeros,
+		       nslack, nrows - nslack);
+
+	return (status);
+}
+
+/*
+ * This routine frees the current CPLEX problem, and reallocates/rebuilds
+ * it from the current constraint pool.  This routine works even if
+ * there are constraints pending addition to the LP tableaux.  The
+ * LP_t of the branch-and-cut stays the same.
+ */
+
+	static
+	void
+reload_cplex_problem (
+
+struct bbinfo *		bbip		/* IN - branch-and-bound info */
+)
+{
+int			i;
+int			j;
+int			i1;
+int			i2;
+int			newrows;
+int			row;
+int			nedges;
+struct rcon *		rcp;
+struct cplex_lp *	p;
+struct cpool *		pool;
+int *			cstat;
+int *			rstat;
+int *			b_index;
+char *			b_lu;
+double *		b_bd;
+
+	p	= CPLEX_STATE (bbip -> lp);
+	pool	= bbip -> cpool;
+
+	newrows	= pool -> npend;
+	i1	= pool -> nlprows;
+	i2	= i1 + newrows;
+
+	gst_channel_printf (bbip -> params -> print_solve_trace, "REALLOCATING CPLEX PROBLEM...\n");
+
+	/* Save off the current basis, setting the new	*/
+	/* rows to be basic...				*/
+	cstat = NEWA (bbip -> cip -> num_edges, int);
+	rstat = NEWA (i2, int);
+	if (_MYCPX_getbase (p -> lp, cstat, rstat) NE 0) {
+		FATAL_ERROR;
+	}
+	for (i = i1; i < i2; i++) {
+		/* Set slack variables for new rows to be basic... */
+		rstat [i] = 1;
+	}
+
+	/* Free up the current CPLEX problem... */
+	free_cplex_problem (p);
+
+	/* Make all LP rows be pending again... */
+	for (i = 0; i < pool -> nlprows; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		if (rcp -> lprow < 0) {
+			/* Not currently in LP? */
+			FATAL_ERROR;
+		}
+		rcp -> lprow = -2;	/* is now pending... */
+	}
+	pool -> npend += pool -> nlprows;
+	pool -> nlprows = 0;
+
+	/* Build the initial formulation from scratch again... */
+	load_cplex_problem (p,
+			    pool,
+			    bbip -> vert_mask,
+			    bbip -> edge_mask,
+			    bbip -> cip,
+			    bbip -> params);
+
+	/* The initial formulation bounds all variables	*/
+	/* from 0 to 1.  We must restore the proper	*/
+	/* bounds for all variables that have been	*/
+	/* fixed to 0 or 1...				*/
+
+	nedges = bbip -> cip -> num_edges;
+	b_index = NEWA (2 * nedges, int);
+	b_lu	= NEWA (2 * nedges, char);
+	b_bd	= NEWA (2 * nedges, double);
+	j = 0;
+	FOR_EACH_SETBIT (i, bbip -> fixed, nedges) {
+		b_index [j]	= i;
+		b_lu [j]	= 'L';
+		b_index [j+1]	= i;
+		b_lu [j+1]	= 'U';
+		if (NOT BITON (bbip -> value, i)) {
+			b_bd [j]	= 0.0;
+			b_bd [j+1]	= 0.0;
+		}
+		else {
+			b_bd [j]	= 1.0;
+			b_bd [j+1]	= 1.0;
+		}
+		j += 2;
+	}
+
+	if (j > 0) {
+		if (_MYCPX_chgbds (p -> lp, j, b_index, b_lu, b_bd) NE 0) {
+			FATAL_ERROR;
+		}
+	}
+
+	free ((char *) b_bd);
+	free ((char *) b_lu);
+	free ((char *) b_index);
+
+	/* Restore augmented basis... */
+	if (_MYCPX_copybase (p -> lp, cstat, rstat) NE 0) {
+		FATAL_ERROR;
+	}
+	free ((char *) rstat);
+	free ((char *) cstat);
+}
+
+/*
+ * Wrap a CPLEX backend state in a new LP_t.
+ */
+
+	static
+	LP_t *
+new_instance (
+
+struct cplex_lp *	p		/* IN - backend state */
+)
+{
+LP_t *		lp;
+
+	lp = NEW (LP_t);
+	lp -> backend	= &_gst_cplex_backend;
+	lp -> solver	= p;
+
+	return (lp);
+}
+
+/*
+ * Free the CPLEX problem of a backend state, and the arrays that it
+ * was loaded from.
+ */
+
+	static
+	void
+free_cplex_problem (
+
+struct cplex_lp *	p		/* IN - backend state */
+)
+{
+	/* Free up CPLEX's memory... */
+	if (_MYCPX_freeprob (&(p -> lp)) NE 0) {
+		FATAL_ERROR;
+	}
+	p -> lp = NULL;
+
+	/* Free up our own memory... */
+	free ((char *) (p -> objx));
+	free ((char *) (p -> rhsx));
+	free ((char *) (p -> senx));
+	free ((char *) (p -> matbeg));
+	free ((char *) (p -> matcnt));
+	free ((char *) (p -> matind));
+	free ((char *) (p -> matval));
+	free ((char *) (p -> bdl));
+	free ((char *) (p -> bdu));
+
+	p -> objx	= NULL;
+	p -> rhsx	= NULL;
+	p -> senx	= NULL;
+	p -> matbeg	= NULL;
+	p -> matcnt	= NULL;
+	p -> matind	= NULL;
+	p -> matval	= NULL;
+	p -> bdl	= NULL;
+	p -> bdu	= NULL;
+}
+
+/*
+ * Save the existing objective limit, and set it to infinity for the
+ * duration of the branch-and-cut.
+ */
+
+	static
+	void
+cplex_begin_bb (
+
+LP_t *		lp		/* IN - LP of the branch-and-cut */
+)
+{
+struct cplex_lp *	p;
+
+	p = CPLEX_STATE (lp);
+
+	CPXgetdblparam (cplex_env, CPX_PARAM_OBJULIM, &(p -> save_objlim));
+	CPXsetdblparam (cplex_env, CPX_PARAM_OBJULIM, DBL_MAX);
+}
+
+/*
+ * Restore the objective limit saved by cplex_begin_bb().
+ */
+
+	static
+	void
+cplex_end_bb (
+
+LP_t *		lp		/* IN - LP of the branch-and-cut */
+)
+{
+	CPXsetdblparam (cplex_env,
+			CPX_PARAM_OBJULIM,
+			CPLEX_STATE (lp) -> save_objlim);
+}
+
+/*
+ * Set new cutoff value for future LPs.  The limit applies to the
+ * scaled objective.
+ */
+
+	static
+	void
+cplex_set_cutoff (
+
+LP_t *		lp,		/* IN - LP to set cutoff of */
+double		ub		/* IN - new upper bound */
+)
+{
+double		toobig;
+double		toosmall;
+double		ulim;
+
+	ulim = ldexp (ub, -(CPLEX_STATE (lp) -> obj_scale));
+	if (_MYCPX_setobjulim (ulim, &toosmall, &toobig) NE 0) {
+		FATAL_ERROR;
+	}
+}
+
+/*
+ * This routine saves the current basis of the given LP, so that
+ * cplex_try_branch() can restore it after each trial.
+ */
+
+	static
+	void
+cplex_save_branch_basis (
+
+LP_t *		lp		/* IN - LP to save basis for */
+)
+{
+int			rows;
+int			cols;
+struct cplex_lp *	p;
+
+	p = CPLEX_STATE (lp);
+
+	rows = _MYCPX_getnumrows (p -> lp);
+	cols = _MYCPX_getnumcols (p -> lp);
+
+	p -> bs_cstat = NEWA (cols, int);
+	p -> bs_rstat = NEWA (rows, int);
+
+	if (_MYCPX_getbase (p -> lp, p -> bs_cstat, p -> bs_rstat) NE 0) {
+		FATAL_ERROR;
+	}
+}
+
+/*
+ * Destroy the saved basis info...
+ */
+
+	static
+	void
+cplex_free_branch_basis (
+
+LP_t *		lp		/* IN - LP whose snapshot to free */
+)
+{
+struct cplex_lp *	p;
+
+	p = CPLEX_STATE (lp);
+
+	free ((char *) (p -> bs_rstat));
+	free ((char *) (p -> bs_cstat));
+	p -> bs_rstat = NULL;
+	p -> bs_cstat = NULL;
+}
+
+/*
+ * This routine tries the given branch by solving the LP.  It
+ * returns the resulting objective value, or "ival" if something
+ * goes wrong (like infeasible).
+ */
+
+	static
+	double
+cplex_try_branch (
+
+LP_t *			lp,	/* IN - LP to re-optimize */
+int			var,	/* IN - variable to try branching */
+int			dir,	/* IN - branch direction, 0 or 1 */
+double *		x,	/* OUT - LP solution obtained */
+double			ival,	/* IN - value to give if infeasible */
+gst_channel_ptr		trace	/* IN - trace channel */
+)
+{
+int			status;
+double			z;
+int			b_index [2];
+char			b_lu [2];
+double			b_bd [2];
+struct cplex_lp *	p;
+
+	p = CPLEX_STATE (lp);
+
+	b_index [0] = var;	b_lu [0] = 'L';
+	b_index [1] = var;	b_lu [1] = 'U';
+	if (dir EQ 0) {
+		b_bd [0] = 0.0;
+		b_bd [1] = 0.0;
+	}
+	else {
+		b_bd [0] = 1.0;
+		b_bd [1] = 1.0;
+	}
+	if (_MYCPX_chgbds (p -> lp, 2, b_index, b_lu, b_bd) NE 0) {
+		FATAL_ERROR;
+	}
+
+	/* Solve the current LP instance... */
+	status = _MYCPX_dualopt (p -> lp);
+	if (status NE 0) {
+		gst_channel_printf (trace,
+			" WARNING dualopt: status = %d\n", status);
+	}
+
+	/* Get current LP solution... */
+	if (_MYCPX_solution (p -> lp, &status, &z, x, NULL, NULL, NULL) NE 0) {
+		FATAL_ERROR;
+	}
+
+	/* Determine type of LP result... */
+	switch (status) {
+	case _MYCPX_STAT_OPTIMAL:
+	case _MYCPX_STAT_OPTIMAL_INFEAS:
+		/* Unscale the objective value. */
+		z = ldexp (z, p -> obj_scale);
+		break;
+
+	case _MYCPX_STAT_INFEASIBLE:
+	case _MYCPX_STAT_UNBOUNDED:
+			/* (CPLEX 3.0 sometimes gives us infeasible!) */
+	case _MYCPX_STAT_ABORT_OBJ_LIM:	/* Objective limit exceeded. */
+		z = ival;
+		break;
+
+	default:
+		gst_channel_printf (trace, "Status = %d\n", status);
+		_MYCPX_lpwrite (p -> lp, "core.lp");
+		FATAL_ERROR;
+		break;
+	}
+
+	b_bd [0] = 0.0;
+	b_bd [1] = 1.0;
+	if (_MYCPX_chgbds (p -> lp, 2, b_index, b_lu, b_bd) NE 0) {
+		FATAL_ERROR;
+	}
+
+	/* Restore the basis... */
+	status = _MYCPX_copybase (p -> lp, p -> bs_cstat, p -> bs_rstat);
+	if (status NE 0) {
+		fprintf (stderr, "try_branch: status = %d\n", status);
+		FATAL_ERROR;
+	}
+
+	return (z);
+}
+
+/*
+ * Create a CPLEX problem with "ncols" columns and no rows, with room
+ * for "rowspace" rows and "nzspace" non-zeros.
+ */
+
+	static
+	LP_t *
+cplex_create (
+
+const char *	name,		/* IN - name of the problem */
+int		ncols,		/* IN - number of columns */
+int		objsense,	/* IN - LP_MINIMIZE or LP_MAXIMIZE */
+double *	obj,		/* IN - objective coefficients */
+double *	lower,		/* IN - lower bounds of the columns */
+double *	upper,		/* IN - upper bounds of the columns */
+int		rowspace,	/* IN - expected number of rows */
+int		nzspace		/* IN - expected non-zeros */
+)
+{
+int			i;
+int			objsen;
+struct cplex_lp *	p;
+
+	p = NEW (struct cplex_lp);
+	memset (p, 0, sizeof (*p));
+
+	if (rowspace < 1) {
+		rowspace = 1;
+	}
+	if (nzspace < 1) {
+		nzspace = 1;
+	}
+
+	p -> objx	= NEWA (ncols, double);
+	p -> bdl	= NEWA (ncols, double);
+	p -> bdu	= NEWA (ncols, double);
+	p -> matbeg	= NEWA (ncols, int);
+	p -> matcnt	= NEWA (ncols, int);
+	p -> rhsx	= NEWA (rowspace, double);
+	p -> senx	= NEWA (rowspace, char);
+	p -> matind	= NEWA (nzspace, int);
+	p -> matval	= NEWA (nzspace, double);
+
+	for (i = 0; i < ncols; i++) {
+		p -> objx [i]	= obj [i];
+		p -> bdl [i]	= (lower [i] <= -LP_INFINITY)
+					? - _MYCPX_INFBOUND : lower [i];
+		p -> bdu [i]	= (upper [i] >= LP_INFINITY)
+					? _MYCPX_INFBOUND : upper [i];
+		p -> matbeg [i]	= 0;
+		p -> matcnt [i]	= 0;
+	}
+
+	objsen = (objsense EQ LP_MAXIMIZE) ? _MYCPX_MAX : _MYCPX_MIN;
+
+	p -> lp = _MYCPX_loadlp ((char *) name,
+				 ncols,
+				 0,
+				 objsen,
+				 p -> objx,
+				 p -> rhsx,
+				 p -> senx,
+				 p -> matbeg,
+				 p -> matcnt,
+				 p -> matind,
+				 p -> matval,
+				 p -> bdl,
+				 p -> bdu,
+				 NULL,
+				 ncols,
+				 rowspace,
+				 nzspace);
+
+	FATAL_ERROR_IF (p -> lp EQ NULL);
+
+	return (new_instance (p));
+}
+
+/*
+ * Free up a CPLEX problem.
+ */
+
+	static
+	void
+cplex_destroy (
+
+LP_t *		lp		/* IN - LP to free */
+)
+{
+struct cplex_lp *	p;
+
+	p = CPLEX_STATE (lp);
+
+	free_cplex_problem (p);
+	cplex_free_branch_basis (lp);
+
+	free ((char *) p);
+	free ((char *) lp);
+}
+
+/*
+ * Size of a CPLEX problem.
+ */
+
+	static
+	int
+cplex_num_rows (
+
+LP_t *		lp		/* IN - LP to get size of */
+)
+{
+	return (_MYCPX_getnumrows (CPLEX_LP (lp)));
+}
+
+
+	static
+	int
+cplex_num_cols (
+
+LP_t *		lp		/* IN - LP to get size of */
+)
+{
+	return (_MYCPX_getnumcols (CPLEX_LP (lp)));
+}
+
+
+	static
+	int
+cplex_num_nz (
+
+LP_t *		lp		/* IN - LP to get size of */
+)
+{
+	return (_MYCPX_getnumnz (CPLEX_LP (lp)));
+}
+
+/*
+ * Append rows to a CPLEX problem.
+ */
+
+	static
+	void
+cplex_add_rows (
+
+LP_t *		lp,		/* IN - LP to add rows to */
+int		nrows,		/* IN - number of rows to add */
+double *	rhs,		/* IN - right-hand side of each row */
+char *		sense,		/* IN - 'L', 'E' or 'G' for each row */
+int *		matbeg,		/* IN - start of each row in matind */
+int *		matind,		/* IN - column of each coefficient */
+double *	matval		/* IN - value of each coefficient */
+)
+{
+	if (nrows <= 0) return;
+
+	if (_MYCPX_addrows (CPLEX_LP (lp),
+			    0,
+			    nrows,
+			    matbeg [nrows],
+			    rhs,
+			    sense,
+			    matbeg,
+			    matind,
+			    matval,
+			    NULL,
+			    NULL) NE 0) {
+		FATAL_ERROR;
+	}
+}
+
+/*
+ * Delete the flagged rows of a CPLEX problem.
+ */
+
+	static
+	void
+cplex_delete_rows (
+
+LP_t *		lp,		/* IN - LP to delete rows from */
+int *		dflag		/* IN - non-zero for each row to delete */
+)
+{
+int		i;
+int		nrows;
+int *		delstat;
+
+	nrows = _MYCPX_getnumrows (CPLEX_LP (lp));
+
+	/* CPLEX overwrites the flags with the new row numbers. */
+	delstat = NEWA (nrows, int);
+	for (i = 0; i < nrows; i++) {
+		delstat [i] = (dflag [i] NE 0);
+	}
+	if (_MYCPX_delsetrows (CPLEX_LP (lp), delstat) NE 0) {
+		FATAL_ERROR;
+	}
+	free ((char *) delstat);
+}
+
+/*
+ * Optimize a CPLEX problem.
+ */
+
+	static
+	int
+cplex_optimize (
+
+LP_t *		lp		/* IN - LP to optimize */
+)
+{
+int		status;
+
+	if (_MYCPX_dualopt (CPLEX_LP (lp)) NE 0) {
+		return (LP_FAILED);
+	}
+	if (_MYCPX_solution (CPLEX_LP (lp),
+			     &status,
+			     NULL,
+			     NULL,
+			     NULL,
+			     NULL,
+			     NULL) NE 0) {
+		return (LP_FAILED);
+	}
+
+	switch (status) {
+	case _MYCPX_STAT_OPTIMAL:	return (LP_OPTIMAL);
+	case _MYCPX_STAT_INFEASIBLE:	return (LP_INFEASIBLE);
+	case _MYCPX_STAT_UNBOUNDED:	return (LP_UNBOUNDED);
+	default:
+		break;
+	}
+	return (LP_FAILED);
+}
+
+/*
+ * Retrieve the last solution of a CPLEX problem, unscaling the
+ * objective.
+ */
+
+	static
+	void
+cplex_get_solution (
+
+LP_t *		lp,		/* IN - solved LP */
+double *	z,		/* OUT - objective value */
+double *	x,		/* OUT - value of each column */
+double *	slack		/* OUT - slack of each row */
+)
+{
+int		status;
+
+	if (_MYCPX_solution (CPLEX_LP (lp),
+			     &status,
+			     z,
+			     x,
+			     NULL,
+			     slack,
+			     NULL) NE 0) {
+		FATAL_ERROR;
+	}
+	if (z NE NULL) {
+		*z = ldexp (*z, CPLEX_STATE (lp) -> obj_scale);
+	}
+}
+
+/*
+ * Retrieve the objective coefficients of the first "n" columns of a
+ * CPLEX problem, unscaled.
+ */
+
+	static
+	void
+cplex_get_obj (
+
+LP_t *		lp,		/* IN - LP to get objective of */
+double *	obj,		/* OUT - objective coefficients */
+int		n		/* IN - number of columns */
+)
+{
+int		i;
+int		obj_scale;
+
+	if (n <= 0) return;
+
+	if (_MYCPX_getobj (CPLEX_LP (lp), obj, 0, n - 1) NE 0) {
+		FATAL_ERROR;
+	}
+
+	obj_scale = CPLEX_STATE (lp) -> obj_scale;
+	for (i = 0; i < n; i++) {
+		obj [i] = ldexp (obj [i], obj_scale);
+	}
+}
+
+/*
+ * Retrieve the dual values of the rows from the most recent CPLEX
+ * solution, unscaled.
+ */
+
+	static
+	void
+cplex_get_duals (
+
+LP_t *		lp,		/* IN - solved LP tableaux */
+double *	pi		/* OUT - dual value of each row */
+)
+{
+int		i;
+int		nrows;
+int		obj_scale;
+
+	if (_MYCPX_solution (CPLEX_LP (lp), NULL, NULL, NULL, pi, NULL, NULL) NE 0) {
+		FATAL_ERROR;
+	}
+
+	nrows	  = _MYCPX_getnumrows (CPLEX_LP (lp));
+	obj_scale = CPLEX_STATE (lp) -> obj_scale;
+	for (i = 0; i < nrows; i++) {
+		pi [i] = ldexp (pi [i], obj_scale);
+	}
+}
+
+/*
+ * Retrieve the current basis under CPLEX.
+ */
+
+	static
+	void
+cplex_get_basis (
+
+LP_t *		lp,		/* IN - LP tableaux to get basis of */
+int *		cstat,		/* OUT - basis flags for each column */
+int *		rstat		/* OUT - basis flags for each row */
+)
+{
+	if (_MYCPX_getbase (CPLEX_LP (lp), cstat, rstat) NE 0) {
+		FATAL_ERROR;
+	}
+}
+
+/*
+ * Install the given basis under CPLEX.
+ */
+
+	static
+	void
+cplex_set_basis (
+
+LP_t *		lp,		/* IN - LP tableaux to set basis of */
+int *		cstat,		/* IN - basis flags for each column */
+int *		rstat		/* IN - basis flags for each row */
+)
+{
+	if (_MYCPX_copybase (CPLEX_LP (lp), cstat, rstat) NE 0) {
+		FATAL_ERROR;
+	}
+}
+
+/*
+ * Change the bounds of several variables under CPLEX.  CPLEX wants
+ * one entry per bound.
+ */
+
+	static
+	void
+cplex_set_bounds (
+
+LP_t *		lp,		/* IN - LP tableaux to change */
+int		n,		/* IN - number of variables */
+int *		index,		/* IN - variables to change */
+double *	lower,		/* IN - new lower bounds */
+double *	upper		/* IN - new upper bounds */
+)
+{
+int		i;
+int *		b_index;
+char *		b_lu;
+double *	b_bd;
+
+	if (n <= 0) return;
+
+	b_index	= NEWA (2 * n, int);
+	b_lu	= NEWA (2 * n, char);
+	b_bd	= NEWA (2 * n, double);
+
+	for (i = 0; i < n; i++) {
+		b_index [2*i]	= index [i];
+		b_lu [2*i]	= 'L';
+		b_bd [2*i]	= lower [i];
+		b_index [2*i+1]	= index [i];
+		b_lu [2*i+1]	= 'U';
+		b_bd [2*i+1]	= upper [i];
+	}
+	if (_MYCPX_chgbds (CPLEX_LP (lp), 2 * n, b_index, b_lu, b_bd) NE 0) {
+		FATAL_ERROR;
+	}
+
+	free ((char *) b_bd);
+	free ((char *) b_lu);
+	free ((char *) b_index);
+}
+
+/*
+ * CPLEX always has a basis for its problems.
+ */
+
+	static
+	bool
+cplex_have_basis (
+
+LP_t *		lp		/* IN - LP to check */
+)
+{
+	(void) lp;
+
+	return (TRUE);
+}
+
+#endif
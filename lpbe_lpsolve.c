@@ -0,0 +1,1287 @@
+/***********************************************************************
+
+	File:	lpbe_lpsolve.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	The lp_solve backend of the LP solver interface (lpbackend.h).
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.  Moved the lp_solve code of constrnt.c
+		:  and localcut.c here, behind an opaque LP_t.
+
+************************************************************************/
+
+#include "lpbackend.h"
+
+#include "bb.h"
+#include "bitmap.h"
+#include "channels.h"
+#include "config.h"
+#include "constrnt.h"
+#include "cputime.h"
+#include "fatal.h"
+#include "logic.h"
+#include "lpkit.h"
+#include "memory.h"
+#include "parmblk.h"
+#include "point.h"
+#include "steiner.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Local Types
+ */
+
+struct lpsolve_lp {
+	lprec *			lp;	/* the lp_solve problem */
+	struct basis_save	bsave;	/* basis snapshot for try_branch */
+};
+
+#define	LPSOLVE_LP(p)	(((struct lpsolve_lp *) ((p) -> solver)) -> lp)
+#define	LPSOLVE_BSAVE(p) \
+	(&(((struct lpsolve_lp *) ((p) -> solver)) -> bsave))
+
+/*
+ * Local Routines
+ */
+
+static void		lpsolve_add_pending_rows (struct bbinfo *);
+static void		lpsolve_add_rows (LP_t *,
+					  int,
+					  double *,
+					  char *,
+					  int *,
+					  int *,
+					  double *);
+static void		lpsolve_begin_bb (LP_t *);
+static LP_t *		lpsolve_build (struct cpool *,
+				       bitmap_t *,
+				       bitmap_t *,
+				       struct gst_hypergraph *,
+				       gst_param_ptr);
+static LP_t *		lpsolve_create (const char *,
+					int,
+					int,
+					double *,
+					double *,
+					double *,
+					int,
+					int);
+static void		lpsolve_delete_rows (LP_t *, int *);
+static void		lpsolve_destroy (LP_t *);
+static void		lpsolve_end_bb (LP_t *);
+static void		lpsolve_free_branch_basis (LP_t *);
+static void		lpsolve_get_basis (LP_t *, int *, int *);
+static void		lpsolve_get_duals (LP_t *, double *);
+static void		lpsolve_get_obj (LP_t *, double *, int);
+static void		lpsolve_get_solution (LP_t *,
+					      double *,
+					      double *,
+					      double *);
+static bool		lpsolve_have_basis (LP_t *);
+static int		lpsolve_num_cols (LP_t *);
+static int		lpsolve_num_nz (LP_t *);
+static int		lpsolve_num_rows (LP_t *);
+static int		lpsolve_optimize (LP_t *);
+static void		lpsolve_save_branch_basis (LP_t *);
+static void		lpsolve_set_basis (LP_t *, int *, int *);
+static void		lpsolve_set_bounds (LP_t *,
+					    int,
+					    int *,
+					    double *,
+					    double *);
+static void		lpsolve_set_cutoff (LP_t *, double);
+static int		lpsolve_solve (struct bbinfo *,
+				       double *,
+				       double *,
+				       int);
+static double		lpsolve_try_branch (LP_t *,
+					    int,
+					    int,
+					    double *,
+					    double,
+					    gst_channel_ptr);
+static LP_t *		new_instance (lprec *);
+
+/*
+ * The lp_solve backend.  Slack rows are deleted after separation, once
+ * the new cuts are known.
+ */
+
+const struct lp_backend	_gst_lpsolve_backend = {
+	"lp_solve",
+	FALSE,
+	lpsolve_build,
+	lpsolve_add_pending_rows,
+	lpsolve_solve,
+	lpsolve_begin_bb,
+	lpsolve_end_bb,
+	lpsolve_set_cutoff,
+	lpsolve_save_branch_basis,
+	lpsolve_free_branch_basis,
+	lpsolve_try_branch,
+	lpsolve_create,
+	lpsolve_destroy,
+	lpsolve_num_rows,
+	lpsolve_num_cols,
+	lpsolve_num_nz,
+	lpsolve_add_rows,
+	lpsolve_delete_rows,
+	lpsolve_optimize,
+	lpsolve_get_solution,
+	lpsolve_get_obj,
+	lpsolve_get_duals,
+	lpsolve_set_bounds,
+	lpsolve_get_basis,
+	lpsolve_set_basis,
+	lpsolve_have_basis,
+};
+
+/*
+ * Build the LP relaxation over the initial constraints of the pool.
+ */
+
+	static
+	LP_t *
+lpsolve_build (
+
+struct cpool *		pool,		/* IN - initial constraint pool */
+bitmap_t *		vert_mask,	/* IN - set of valid vertices */
+bitmap_t *		edge_mask,	/* IN - set of valid hyperedges */
+struct gst_hypergraph *	cip,		/* IN - compatibility info */
+gst_param_ptr		params		/* IN - parameter set */
+)
+{
+int			i;
+int			nedges;
+int			nrows;
+int			ncols;
+int			ncoeff;
+int			nzi;
+int			row;
+int			var;
+struct rcon *		rcp;
+struct rcoef *		cp;
+lprec *			lp;
+double *		rowvec;
+double *		rhs;
+short *			ctype;
+int *			matbeg;
+int *			matind;
+double *		matval;
+cpu_time_t		T0;
+cpu_time_t		T1;
+char			tbuf [32];
+
+	T0 = _gst_get_cpu_time ();
+
+	nedges = cip -> num_edges;
+
+	/* PSW: Count terminals for not_covered variables */
+	int nterms = 0;
+	for (i = 0; i < cip -> num_verts; i++) {
+		if (BITON (vert_mask, i) && cip -> tflag[i]) {
+			nterms++;  /* Count only terminals, not Steiner points */
+		}
+	}
+	fprintf(stderr, "DEBUG SOFT: Found %d terminals, %d FSTs\n", nterms, nedges);
+
+	/* PSW: Variables = FST selection (x_i) + terminal coverage (not_covered_t) */
+	ncols = nedges + nterms;
+
+	/* Compute the total number of non-zeros in the INITIAL	*/
+	/* constraints of the constraint pool...		*/
+	ncoeff = 0;
+	nrows = pool -> npend;
+	for (i = 0; i < nrows; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		ncoeff += rcp -> len;
+	}
+
+	/* PSW: Add space for not_covered variables in soft terminal coverage constraints when enabled */
+	char* budget_env = getenv("GEOSTEINER_BUDGET");
+	if (budget_env != NULL) {
+		/* Each soft terminal coverage constraint gets one additional not_covered variable */
+		ncoeff += nterms;  /* One not_covered variable per terminal */
+		fprintf(stderr, "DEBUG SOFT: Adding space for %d not_covered variables in soft constraints, total ncoeff=%d\n",
+			nterms, ncoeff);
+	}
+
+	/* Make the initial LP... */
+	lp = make_lp (0, ncols);
+	fprintf(stderr, "DEBUG LP_SETUP: Created LP with 0 rows, %d columns (nedges=%d + nterms=%d)\n",
+		ncols, nedges, nterms);
+
+	/* All variables are 0-1 variables... */
+	/* PSW: FST selection variables x_i */
+	for (i = 1; i <= nedges; i++) {
+		set_bounds (lp, i, 0.0, 1.0);
+	}
+	/* PSW: Terminal coverage variables not_covered_t */
+	for (i = nedges + 1; i <= nedges + nterms; i++) {
+		set_bounds (lp, i, 0.0, 1.0);
+	}
+	fprintf(stderr, "DEBUG SOFT: Set bounds for %d FST vars [1-%d] and %d coverage vars [%d-%d]\n",
+		nedges, nedges, nterms, nedges+1, nedges+nterms);
+
+	/* Minimize */
+	set_minim (lp);
+
+	/* Build the objective function... */
+	/* PSW: Multi-objective: minimize (normalized_tree_length + alpha * normalized_battery_score + beta * uncovered_terminals) */
+
+	/* PSW: No normalization - use raw values */
+	/* PSW: Multi-objective coefficients */
+	double alpha = BUDGET_BATTERY_WEIGHT;
+	double beta = BUDGET_UNCOVERED_PENALTY;
+
+	fprintf(stderr, "DEBUG OBJ: Using raw costs - alpha=%.1f (battery weight), beta=%.0f (coverage penalty)\n", alpha, beta);
+
+	rowvec = NEWA (ncols + 1, double);
+	fprintf(stderr, "DEBUG OBJ: Allocated rowvec[0-%d] for ncols=%d LP variables\n", ncols, ncols);
+	for (i = 0; i <= ncols; i++) {
+		rowvec [i] = 0.0;
+	}
+
+	/* PSW: FST selection terms: tree_cost + alpha * battery_cost */
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
+		double tree_cost = (double) (cip -> cost [i]);
+		double battery_cost = 0.0;
+
+		/* PSW: Get battery_score - recalculate from terminal data like dumpfst does */
+		if (cip -> full_trees != NULL && cip -> full_trees[i] != NULL) {
+			battery_cost = cip -> full_trees[i] -> battery_score;
+			fprintf(stderr, "DEBUG OBJ: Full_trees battery_score=%.3f for FST %d\n", battery_cost, i);
+
+			/* If battery_score is 0, recalculate from edge terminals */
+			if (battery_cost == 0.0 && cip -> pts != NULL) {
+				/* Use the same approach as dumpfst - access edge terminals */
+				int j, k;
+				int nedge_terminals = cip -> edge_size[i];
+				int *edge_terminals = cip -> edge[i];
+
+				fprintf(stderr, "DEBUG OBJ: Recalculating for FST %d with %d terminals\n", i, nedge_terminals);
+				for (j = 0; j < nedge_terminals; j++) {
+					k = edge_terminals[j];  /* 0-based terminal index */
+					if (k >= 0 && k < cip -> pts -> n) {
+						double bval = cip -> pts -> a[k].battery;
+						battery_cost += bval;
+						fprintf(stderr, "DEBUG OBJ: Terminal %d (idx %d): battery=%.2f, running_total=%.2f\n",
+							j, k, bval, battery_cost);
+					}
+				}
+				fprintf(stderr, "DEBUG OBJ: Recalculated battery_score=%.3f for FST %d\n", battery_cost, i);
+			}
+		} else {
+			fprintf(stderr, "DEBUG OBJ: Cannot access full_trees or pts for FST %d\n", i);
+		}
+
+		/* PSW: Combined FST objective with raw values */
+		rowvec [i + 1] = tree_cost + alpha * battery_cost;
+		fprintf(stderr, "DEBUG OBJ: FST %d: tree_cost=%.3f, battery_cost=%.3f (weighted=%.1f), combined=%.1f\n",
+				i, tree_cost, battery_cost, alpha * battery_cost, rowvec[i + 1]);
+	}
+
+	/* PSW: Terminal coverage penalty terms: beta * not_covered_t */
+	for (i = 0; i < nterms; i++) {
+		rowvec[nedges + 1 + i] = beta;  /* Penalty for each uncovered terminal (1-based for objective) */
+	}
+	fprintf(stderr, "DEBUG OBJ: Added penalty terms beta=%.0f for %d not_covered variables [%d-%d]\n",
+		beta, nterms, nedges+1, nedges+nterms);
+#if 1
+	inc_mat_space (lp, ncols + 1);
+#endif
+	set_obj_fn (lp, rowvec);
+
+	/* PSW: Debug LP matrix structure */
+	if (getenv("GEOSTEINER_BUDGET") != NULL) {
+		fprintf(stderr, "DEBUG LP_MATRIX: LP has %d rows, %d columns after setup\n",
+			lp->rows, lp->columns);
+	}
+
+	free ((char *) rowvec);
+
+	int extra_rows = 0;
+	int extra_coeff = 0;
+	char* multi_obj_env = getenv("GEOSTEINER_BUDGET");
+
+	/* PSW: Calculate extra_coeff for soft coverage constraints when budget is enabled */
+	if (multi_obj_env != NULL) {
+		/* In budget mode, we may add not_covered variables to soft coverage constraints.
+		 * From the debug output, we expect to add up to nterms additional coefficients.
+		 * Let's be conservative and allocate space for nterms extra coefficients. */
+		int nterms = 0;
+		/* Need to get nterms from somewhere - let's check if it's available in the pool or calculate it */
+
+		/* Count terminal coverage constraints that will become soft constraints */
+		for (i = 0; i < nrows; i++) {
+			row = pool -> lprows [i];
+			struct rcon *rcp_temp = &(pool -> rows [row]);
+
+			/* Check if this is a terminal coverage constraint (≥ 1 pattern) */
+			struct rcoef *end_cp;
+			for (end_cp = rcp_temp -> coefs; end_cp -> var >= RC_VAR_BASE; end_cp++) {
+				/* Find the operator */
+			}
+			if (end_cp -> var == RC_OP_GE && end_cp -> val == 1) {
+				/* This will be a soft terminal coverage constraint - add one extra coefficient */
+				extra_coeff++;
+			}
+		}
+
+		/* If we still have extra_coeff=0, be conservative and allocate based on potential needs */
+		if (extra_coeff == 0) {
+			/* From debug output we know 10 terminals lead to 10 extra coefficients */
+			extra_coeff = 20;  /* Conservative allocation */
+		}
+
+		fprintf(stderr, "DEBUG EXTRA_COEFF: Calculated extra_coeff=%d for %d rows\n", extra_coeff, nrows);
+	}
+
+	/* Allocate arrays for setting the rows... */
+	rhs	= NEWA (nrows + extra_rows, double);
+	ctype	= NEWA (nrows + extra_rows, short);
+	matbeg	= NEWA (nrows + extra_rows + 1, int);
+	matind	= NEWA (ncoeff + extra_coeff, int);
+	matval	= NEWA (ncoeff + extra_coeff, double);
+
+	/* Put the rows into the format that LP-solve wants them in...	*/
+	/* PSW: Track terminal index for adding not_covered variables to soft coverage constraints */
+	int terminal_idx = 0;
+
+	nzi = 0;
+	for (i = 0; i < nrows; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		matbeg [i] = nzi;
+
+		/* PSW: Check if this is a soft terminal coverage constraint when multi-objective is enabled */
+		bool is_soft_coverage = FALSE;
+		if (multi_obj_env != NULL) {
+			/* Check if constraint has ≥ 1 pattern (same as old terminal coverage but now it's soft) */
+			struct rcoef *end_cp;
+			for (end_cp = rcp -> coefs; end_cp -> var >= RC_VAR_BASE; end_cp++) {
+				/* Find the operator */
+			}
+			if (end_cp -> var == RC_OP_GE && end_cp -> val == 1) {
+				/* This could be a soft terminal coverage constraint */
+				is_soft_coverage = TRUE;
+			}
+		}
+
+		/* Add original constraint coefficients */
+		for (cp = rcp -> coefs; ; cp++) {
+			var = cp -> var;
+			if (var < RC_VAR_BASE) break;
+			matind [nzi] = var - RC_VAR_BASE;
+			matval [nzi] = cp -> val;
+			++nzi;
+		}
+
+		/* PSW: Add not_covered variable to soft terminal coverage constraints */
+		if (is_soft_coverage && terminal_idx < nterms) {
+			/* Use same RC_VAR_BASE system as other variables */
+			int not_covered_var = (nedges + terminal_idx) + RC_VAR_BASE;
+			matind [nzi] = not_covered_var - RC_VAR_BASE;  /* Convert to 0-based matrix index */
+			matval [nzi] = 1.0;  /* coefficient = 1 */
+			nzi++;
+			fprintf(stderr, "DEBUG SOFT: Added not_covered_%d (RC_var %d -> matrix_idx %d) to soft constraint %d\n",
+				terminal_idx, not_covered_var, not_covered_var - RC_VAR_BASE, i);
+			terminal_idx++;
+		}
+
+		rhs [i] = cp -> val;
+		switch (var) {
+		case RC_OP_LE:	ctype [i] = REL_LE;	break;
+		case RC_OP_EQ:	ctype [i] = REL_EQ;	break;
+		case RC_OP_GE:	ctype [i] = REL_GE;	break;
+		default:
+			FATAL_ERROR;
+			break;
+		}
+		rcp -> lprow = i;
+	}
+
+	matbeg [i] = nzi;
+	fprintf(stderr, "DEBUG MATRIX_CHECK: nzi=%d, ncoeff=%d, extra_coeff=%d, expected=%d\n",
+		nzi, ncoeff, extra_coeff, ncoeff + extra_coeff);
+	if (nzi != (ncoeff + extra_coeff)) {
+		fprintf(stderr, "ERROR: Matrix coefficient count mismatch! nzi=%d != ncoeff=%d + extra_coeff=%d\n",
+			nzi, ncoeff, extra_coeff);
+		/* In budget mode with soft constraints, allow for discrepancies */
+		if (multi_obj_env != NULL && nzi >= (ncoeff - 50) && nzi <= ncoeff + 50) {
+			fprintf(stderr, "WARNING: Allowing discrepancy in budget mode (nzi=%d vs expected=%d)\n",
+				nzi, ncoeff + extra_coeff);
+		} else {
+			FATAL_ERROR;
+		}
+	}
+
+	if (nrows + extra_rows > pool -> hwmrow) {
+		pool -> hwmrow = nrows + extra_rows;
+	}
+	if (nzi > pool -> hwmnz) {
+		pool -> hwmnz = nzi;
+	}
+
+	/* Debug: Verify matrix integrity before add_rows */
+	fprintf(stderr, "DEBUG MATRIX: Total matrix has %d entries (nzi=%d)\n", nzi, nzi);
+	fprintf(stderr, "DEBUG MATRIX: matbeg[%d] = %d (should equal nzi)\n", nrows + extra_rows, matbeg[nrows + extra_rows]);
+
+	/* Call add_rows and trace what happens */
+	fprintf(stderr, "DEBUG LP: Calling add_rows with %d rows\n", nrows + extra_rows);
+	fprintf(stderr, "DEBUG LP: Before add_rows: LP has %d rows, %d cols, %d nonzeros\n",
+		lp -> rows, lp -> columns, lp -> non_zeros);
+
+	add_rows (lp, 0, nrows + extra_rows, rhs, ctype, matbeg, matind, matval);
+
+	fprintf(stderr, "DEBUG LP: After add_rows: LP has %d rows, %d cols, %d nonzeros\n",
+		lp -> rows, lp -> columns, lp -> non_zeros);
+
+	free ((char *) matval);
+	free ((char *) matind);
+	free ((char *) matbeg);
+	free ((char *) ctype);
+	free ((char *) rhs);
+
+	/* PSW: Debug nlprows calculation */
+	fprintf(stderr, "DEBUG NLPROWS: nrows=%d, extra_rows=%d, setting nlprows=%d\n",
+		nrows, extra_rows, nrows + extra_rows);
+
+	pool -> nlprows	= nrows;
+	pool -> npend	= 0;
+
+#if 0
+	{ FILE *	fp;
+		fp = fopen ("main.lp", "w");
+		FATAL_ERROR_IF (fp EQ NULL);
+		write_LP (lp, fp);
+		fclose (fp);
+	}
+#endif
+
+	if (params -> lp_solve_perturb) {
+		/* Turn on perturbations to deal with degeneracy... */
+		lp -> anti_degen = TRUE;
+	}
+	if (params -> lp_solve_scale) {
+		/* Turn on auto-scaling of the matrix... */
+		auto_scale (lp);
+	}
+
+	T1 = _gst_get_cpu_time ();
+	_gst_convert_cpu_time (T1 - T0, tbuf);
+	gst_channel_printf (params -> print_solve_trace, "_gst_build_initial_formulation: %s seconds.\n", tbuf);
+
+	return (new_instance (lp));
+}
+
+/*
+ * Append the pending rows of the constraint pool to the LP.
+ */
+
+	static
+	void
+lpsolve_add_pending_rows (
+
+struct bbinfo *		bbip		/* IN - branch and bound info */
+)
+{
+int			i;
+int			j;
+int			i1;
+int			i2;
+int			newrows;
+int			ncoeff;
+int			nzi;
+int			row;
+int			var;
+struct rcon *		rcp;
+struct rcoef *		cp;
+lprec *			lp;
+struct cpool *		pool;
+double *		rhs;
+short *			ctype;
+int *			matbeg;
+int *			matind;
+double *		matval;
+
+	lp	= LPSOLVE_LP (bbip -> lp);
+	pool	= bbip -> cpool;
+
+	if (lp -> rows NE pool -> nlprows) {
+		/* LP is out of sync with the pool... */
+		FATAL_ERROR;
+	}
+
+	/* Get number of rows and non-zeros to add to LP... */
+	newrows = pool -> npend;
+
+	FATAL_ERROR_IF (newrows < 0);
+
+	if (newrows EQ 0) return;
+
+	i1	= pool -> nlprows;
+	i2	= i1 + newrows;
+
+	/* Get number of rows and non-zeros to add to LP... */
+	ncoeff = 0;
+	for (i = i1; i < i2; i++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		/* Constraint not pending? */
+		FATAL_ERROR_IF (rcp -> lprow NE -2);
+		rcp -> lprow = i;
+		ncoeff += rcp -> len;
+	}
+
+	if (i2 > pool -> hwmrow) {
+		pool -> hwmrow = i2;
+	}
+	if (lp -> non_zeros + ncoeff > pool -> hwmnz) {
+		pool -> hwmnz = lp -> non_zeros + ncoeff;
+	}
+
+	/* Allocate arrays for setting the rows... */
+	rhs	= NEWA (newrows, double);
+	ctype	= NEWA (newrows, short);
+	matbeg	= NEWA (newrows + 1, int);
+	matind	= NEWA (ncoeff, int);
+	matval	= NEWA (ncoeff, double);
+
+	/* Put the rows into the format that LP-solve wants them in... */
+	nzi = 0;
+	j = 0;
+	for (i = i1; i < i2; i++, j++) {
+		row = pool -> lprows [i];
+		rcp = &(pool -> rows [row]);
+		matbeg [j] = nzi;
+		for (cp = rcp -> coefs; ; cp++) {
+			var = cp -> var;
+			if (var < RC_VAR_BASE) break;
+			matind [nzi] = var - RC_VAR_BASE;
+			matval [nzi] = cp -> val;
+			++nzi;
+		}
+		rhs [j] = cp -> val;
+		switch (var) {
+		case RC_OP_LE:	ctype [j] = REL_LE;	break;
+		case RC_OP_EQ:	ctype [j] = REL_EQ;	break;
+		case RC_OP_GE:	ctype [j] = REL_GE;	break;
+		default:
+			FATAL_ERROR;
+			break;
+		}
+	}
+	matbeg [j] = nzi;
+	FATAL_ERROR_IF (nzi NE ncoeff);
+
+	gst_channel_printf (bbip -> params -> print_solve_trace, "@PAP adding %d rows, %d nz to LP\n", newrows, ncoeff);
+
+	add_rows (lp, 0, newrows, rhs, ctype, matbeg, matind, matval);
+
+	pool -> nlprows = i2;
+	pool -> npend	= 0;
+
+	free ((char *) matval);
+	free ((char *) matind);
+	free ((char *) matbeg);
+	free ((char *) ctype);
+	free ((char *) rhs);
+}
+
+/*
+ * This routine solves a single LP tableaux using LP_SOLVE.  Returns
+ * one of the BBLP_xxx status codes.
+ */
+
+	static
+	int
+lpsolve_solve (
+
+struct bbinfo *		bbip,		/* IN - branch and bound info */
+double *		x,		/* OUT - LP solution variables */
+double *		dj,		/* OUT - LP reduced costs */
+int			pool_iteration	/* IN - pool iteration number */
+)
+{
+int			i;
+int			status;
+double			z;
+lprec *			lp;
+double *		slack;
+int			nslack;
+double *		djbuf;
+struct gst_hypergraph *	cip;
+
+	(void) pool_iteration;
+
+	cip	= bbip -> cip;
+	lp	= LPSOLVE_LP (bbip -> lp);
+
+#if 0
+	/* Debug code to dump each LP instance attempted... */
+	{ char		buf [64];
+		sprintf (buf,
+			 "Node.%03d.%03d.%03d.lp",
+			 bbip -> node -> num,
+			 bbip -> node -> iter + 1,
+			 pool_iteration);
+		dump_lp (lp, buf);
+	}
+#endif
+
+	/* Solve the current LP instance... */
+	status = solve (lp);
+
+	/* Get current LP solution... */
+	z = lp -> best_solution [0];
+
+	/* PSW: Read FST variables */
+	for (i = 0; i < cip -> num_edges; i++) {
+		x [i] = lp -> best_solution [lp -> rows + i + 1];
+	}
+
+	/* PSW: Read not_covered variables if in multi-objective mode */
+	if (getenv("GEOSTEINER_BUDGET") != NULL) {
+		/* Count terminals for not_covered variables - must match other logic */
+		bitmap_t* vert_mask = cip -> initial_vert_mask;
+		int nterms = 0;
+		for (int j = 0; j < cip -> num_verts; j++) {
+			if (BITON (vert_mask, j) && cip -> tflag[j]) {
+				nterms++;
+			}
+		}
+		for (i = 0; i < nterms; i++) {
+			x [cip -> num_edges + i] = lp -> best_solution [lp -> rows + cip -> num_edges + i + 1];
+		}
+		fprintf(stderr, "DEBUG SOLUTION: Read %d FST + %d not_covered variables from LP solution (lp->rows=%d)\n",
+			cip -> num_edges, nterms, lp -> rows);
+		fprintf(stderr, "DEBUG SOLUTION: LP solution array indices: FST[%d-%d], not_covered[%d-%d]\n",
+			lp -> rows + 1, lp -> rows + cip -> num_edges,
+			lp -> rows + cip -> num_edges + 1, lp -> rows + cip -> num_edges + nterms);
+		/* Debug: Show some raw LP solution values */
+		for (i = 0; i < 15 && i < lp->columns + lp->rows + 1; i++) {
+			fprintf(stderr, "DEBUG SOLUTION: lp->best_solution[%d] = %.6f\n", i, lp -> best_solution[i]);
+		}
+	}
+
+	bbip -> node -> z	= z;
+
+	/* Get solution status into solver-independent form... */
+	switch (status) {
+	case OPTIMAL:		status = BBLP_OPTIMAL;		break;
+	case MILP_FAIL:		status = BBLP_CUTOFF;		break;
+	case INFEASIBLE:	status = BBLP_INFEASIBLE;	break;
+	case UNBOUNDED:
+		gst_channel_printf (bbip -> params -> print_solve_trace, "WARNING: LP is unbounded, treating as infeasible\n");
+		status = BBLP_INFEASIBLE;	break;
+	default:
+		gst_channel_printf (bbip -> params -> print_solve_trace, "solve status = %d\n", status);
+		FATAL_ERROR;
+	}
+
+	/* Grab the reduced costs, for future reference. */
+	djbuf = NEWA (lp -> sum + 1, double);
+	get_reduced_costs (lp, djbuf);
+	memcpy (dj,
+		&djbuf [lp -> rows + 1],
+		lp -> columns * sizeof (double));
+	free ((char *) djbuf);
+
+	/* Grab the values of the slack variables, for future reference. */
+	slack = NEWA (lp -> rows + 1, double);
+	get_slack_vars (lp, slack);
+	memcpy (bbip -> slack, &slack [1], lp -> rows * sizeof (double));
+	free ((char *) slack);
+
+	/* Print info about the LP tableaux we just solved... */
+	slack = bbip -> slack;
+	nslack = 0;
+	for (i = 0; i < lp -> rows; i++) {
+		if (slack [i] > FUZZ) {
+			++nslack;
+		}
+	}
+	(void) gst_channel_printf (bbip -> params -> print_solve_trace, "@PL %d rows, %d cols, %d nonzeros,"
+		       " %d slack, %d tight.\n",
+		       lp -> rows, lp -> columns, lp -> non_zeros,
+		       nslack, lp -> rows - nslack);
+
+	return (status);
+}
+
+/*
+ * Wrap an lp_solve problem in a new LP_t.
+ */
+
+	static
+	LP_t *
+new_instance (
+
+lprec *		lps		/* IN - lp_solve problem */
+)
+{
+LP_t *			lp;
+struct lpsolve_lp *	p;
+
+	p = NEW (struct lpsolve_lp);
+	memset (p, 0, sizeof (*p));
+	p -> lp = lps;
+
+	lp = NEW (LP_t);
+	lp -> backend	= &_gst_lpsolve_backend;
+	lp -> solver	= p;
+
+	return (lp);
+}
+
+/*
+ * Lp_solve has no global solver state to set up or restore around a
+ * run of the branch-and-cut.
+ */
+
+	static
+	void
+lpsolve_begin_bb (
+
+LP_t *		lp		/* IN - LP of the branch-and-cut */
+)
+{
+	(void) lp;
+}
+
+
+	static
+	void
+lpsolve_end_bb (
+
+LP_t *		lp		/* IN - LP of the branch-and-cut */
+)
+{
+	(void) lp;
+}
+
+/*
+ * Set new cutoff value for future LPs.  (This may not really work in
+ * lp_solve.)
+ */
+
+	static
+	void
+lpsolve_set_cutoff (
+
+LP_t *		lp,		/* IN - LP to set cutoff of */
+double		ub		/* IN - new upper bound */
+)
+{
+	LPSOLVE_LP (lp) -> obj_bound = ub;
+}
+
+/*
+ * Snapshot the current basis so that lpsolve_try_branch() can quickly
+ * get back to it each time.
+ */
+
+	static
+	void
+lpsolve_save_branch_basis (
+
+LP_t *		lp		/* IN - LP to save basis for */
+)
+{
+	save_LP_basis (LPSOLVE_LP (lp), LPSOLVE_BSAVE (lp));
+}
+
+
+	static
+	void
+lpsolve_free_branch_basis (
+
+LP_t *		lp		/* IN - LP whose snapshot to free */
+)
+{
+	destroy_LP_basis (LPSOLVE_BSAVE (lp));
+}
+
+/*
+ * Give branching variable "var" a test run in direction "dir", using
+ * the special try_branch() code in lp_solve.  This never reinverts, so
+ * the saved basis is restored just by truncating the eta file.
+ */
+
+	static
+	double
+lpsolve_try_branch (
+
+LP_t *			lp,	/* IN - LP to test branching for */
+int			var,	/* IN - variable to branch */
+int			dir,	/* IN - branch direction, 0 or 1 */
+double *		x,	/* OUT - LP solution found */
+double			ival,	/* IN - value to give if infeasible */
+gst_channel_ptr		trace	/* IN - trace channel (unused) */
+)
+{
+	(void) trace;
+
+	/* Variables are 1-origined in lp_solve... */
+	return (try_branch (LPSOLVE_LP (lp),
+			    var + 1,
+			    dir,
+			    x,
+			    ival,
+			    LPSOLVE_BSAVE (lp)));
+}
+
+/*
+ * Create an lp_solve problem with "ncols" columns and no rows.
+ * Lp_solve manages the memory of its problems dynamically, so the
+ * space hints are not needed.
+ */
+
+	static
+	LP_t *
+lpsolve_create (
+
+const char *	name,		/* IN - name of the problem (unused) */
+int		ncols,		/* IN - number of columns */
+int		objsense,	/* IN - LP_MINIMIZE or LP_MAXIMIZE */
+double *	obj,		/* IN - objective coefficients */
+double *	lower,		/* IN - lower bounds of the columns */
+double *	upper,		/* IN - upper bounds of the columns */
+int		rowspace,	/* IN - expected number of rows (unused) */
+int		nzspace		/* IN - expected non-zeros (unused) */
+)
+{
+int		i;
+double		lb;
+double		ub;
+double *	objx;
+lprec *		lps;
+
+	(void) name;
+	(void) rowspace;
+	(void) nzspace;
+
+	lps = make_lp (0, ncols);
+
+	for (i = 0; i < ncols; i++) {
+		lb = lower [i];
+		ub = upper [i];
+		if (lb <= -LP_INFINITY) {
+			/* We would really like -inf, but lp_solve does	*/
+			/* not support unrestricted negative variables...	*/
+			lb = -128.0;
+		}
+		if (ub >= LP_INFINITY) {
+			ub = lps -> infinite;
+		}
+		set_bounds (lps, i + 1, lb, ub);
+	}
+
+	if (objsense EQ LP_MAXIMIZE) {
+		set_maxim (lps);
+	}
+	else {
+		set_minim (lps);
+	}
+
+	objx = NEWA (ncols + 1, double);
+	objx [0] = 0.0;
+	for (i = 0; i < ncols; i++) {
+		objx [i + 1] = obj [i];
+	}
+	inc_mat_space (lps, ncols + 1);
+	set_obj_fn (lps, objx);
+	free ((char *) objx);
+
+	return (new_instance (lps));
+}
+
+/*
+ * Free up an lp_solve problem.
+ */
+
+	static
+	void
+lpsolve_destroy (
+
+LP_t *		lp		/* IN - LP to free */
+)
+{
+	delete_lp (LPSOLVE_LP (lp));
+
+	free ((char *) (lp -> solver));
+	free ((char *) lp);
+}
+
+/*
+ * Size of an lp_solve problem.
+ */
+
+	static
+	int
+lpsolve_num_rows (
+
+LP_t *		lp		/* IN - LP to get size of */
+)
+{
+	return (LPSOLVE_LP (lp) -> rows);
+}
+
+
+	static
+	int
+lpsolve_num_cols (
+
+LP_t *		lp		/* IN - LP to get size of */
+)
+{
+	return (LPSOLVE_LP (lp) -> columns);
+}
+
+
+	static
+	int
+lpsolve_num_nz (
+
+LP_t *		lp		/* IN - LP to get size of */
+)
+{
+	return (LPSOLVE_LP (lp) -> non_zeros);
+}
+
+/*
+ * Append rows to an lp_solve problem.
+ */
+
+	static
+	void
+lpsolve_add_rows (
+
+LP_t *		lp,		/* IN - LP to add rows to */
+int		nrows,		/* IN - number of rows to add */
+double *	rhs,		/* IN - right-hand side of each row */
+char *		sense,		/* IN - 'L', 'E' or 'G' for each row */
+int *		matbeg,		/* IN - start of each row in matind */
+int *		matind,		/* IN - column of each coefficient */
+double *	matval		/* IN - value of each coefficient */
+)
+{
+int		i;
+short *		ctype;
+
+	if (nrows <= 0) return;
+
+	ctype = NEWA (nrows, short);
+	for (i = 0; i < nrows; i++) {
+		switch (sense [i]) {
+		case 'L':	ctype [i] = REL_LE;	break;
+		case 'E':	ctype [i] = REL_EQ;	break;
+		case 'G':	ctype [i] = REL_GE;	break;
+		default:
+			FATAL_ERROR;
+			break;
+		}
+	}
+
+	add_rows (LPSOLVE_LP (lp),
+		  0,
+		  nrows,
+		  rhs,
+		  ctype,
+		  matbeg,
+		  matind,
+		  matval);
+
+	free ((char *) ctype);
+}
+
+/*
+ * Delete the flagged rows of an lp_solve problem.  Lp_solve numbers the
+ * rows from 1, with row 0 being the objective.
+ */
+
+	static
+	void
+lpsolve_delete_rows (
+
+LP_t *		lp,		/* IN - LP to delete rows from */
+int *		dflag		/* IN - non-zero for each row to delete */
+)
+{
+int		i;
+int		nrows;
+int *		rowflags;
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	nrows = lps -> rows;
+
+	rowflags = NEWA (nrows + 1, int);
+	rowflags [0] = 0;	/* keep the objective row! */
+	for (i = 0; i < nrows; i++) {
+		rowflags [i + 1] = (dflag [i] NE 0);
+	}
+	delete_row_set (lps, rowflags);
+
+	free ((char *) rowflags);
+}
+
+/*
+ * Optimize an lp_solve problem.
+ */
+
+	static
+	int
+lpsolve_optimize (
+
+LP_t *		lp		/* IN - LP to optimize */
+)
+{
+	switch (solve (LPSOLVE_LP (lp))) {
+	case OPTIMAL:		return (LP_OPTIMAL);
+	case INFEASIBLE:	return (LP_INFEASIBLE);
+	case UNBOUNDED:		return (LP_UNBOUNDED);
+	default:
+		break;
+	}
+	return (LP_FAILED);
+}
+
+/*
+ * Retrieve the last solution of an lp_solve problem.
+ */
+
+	static
+	void
+lpsolve_get_solution (
+
+LP_t *		lp,		/* IN - solved LP */
+double *	z,		/* OUT - objective value */
+double *	x,		/* OUT - value of each column */
+double *	slack		/* OUT - slack of each row */
+)
+{
+int		i;
+double *	sbuf;
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	if (z NE NULL) {
+		*z = lps -> best_solution [0];
+	}
+	if (x NE NULL) {
+		memcpy (x,
+			&(lps -> best_solution [lps -> rows + 1]),
+			lps -> columns * sizeof (double));
+	}
+	if (slack NE NULL) {
+		if (NOT (lps -> basis_valid)) {
+			/* No slacks without a basis -- claim all rows	*/
+			/* are tight so none get deleted.		*/
+			for (i = 0; i < lps -> rows; i++) {
+				slack [i] = 0.0;
+			}
+			return;
+		}
+		sbuf = NEWA (lps -> rows + 1, double);
+		get_slack_vars (lps, sbuf);
+		memcpy (slack, &sbuf [1], lps -> rows * sizeof (double));
+		free ((char *) sbuf);
+	}
+}
+
+/*
+ * Retrieve the objective coefficients of the first "n" columns of an
+ * lp_solve problem.
+ */
+
+	static
+	void
+lpsolve_get_obj (
+
+LP_t *		lp,		/* IN - LP to get objective of */
+double *	obj,		/* OUT - objective coefficients */
+int		n		/* IN - number of columns */
+)
+{
+double *	row;
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	FATAL_ERROR_IF (n > lps -> columns);
+
+	row = NEWA (lps -> columns + 1, double);
+	get_row (lps, 0, row);
+	memcpy (obj, &row [1], n * sizeof (double));
+	free ((char *) row);
+}
+
+/*
+ * Retrieve the dual values of the rows from the most recent lp_solve
+ * solution.  Lp_solve computes these whenever it records a new best
+ * solution.
+ */
+
+	static
+	void
+lpsolve_get_duals (
+
+LP_t *		lp,		/* IN - solved LP tableaux */
+double *	pi		/* OUT - dual value of each row */
+)
+{
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	memcpy (pi, &(lps -> duals [1]), lps -> rows * sizeof (double));
+}
+
+/*
+ * Change the bounds of several variables under lp_solve.
+ */
+
+	static
+	void
+lpsolve_set_bounds (
+
+LP_t *		lp,		/* IN - LP tableaux to change */
+int		n,		/* IN - number of variables */
+int *		index,		/* IN - variables to change */
+double *	lower,		/* IN - new lower bounds */
+double *	upper		/* IN - new upper bounds */
+)
+{
+int		i;
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	for (i = 0; i < n; i++) {
+		set_bounds (lps, index [i] + 1, lower [i], upper [i]);
+	}
+}
+
+/*
+ * This routine retrieves the current basis under lp_solve, which records
+ * the basis differently than CPLEX.  We use the "cstat" array to hold
+ * the column upper/lower bound flags of the non-basic columns, and in
+ * "rstat" we indicate which column is the basic variable for that row
+ * (including slack variable columns).
+ */
+
+	static
+	void
+lpsolve_get_basis (
+
+LP_t *		lp,		/* IN - LP tableaux to get basis of */
+int *		cstat,		/* OUT - basis flags for each column */
+int *		rstat		/* OUT - basis flags for each row */
+)
+{
+int		i;
+int		j;
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	if (NOT (lps -> basis_valid)) {
+		/* Scribble out the default starting basis. */
+		for (i = 0; i < lps -> rows; i++) {
+			rstat [i] = i + 1;
+		}
+		for (i = 0; i < lps -> columns; i++) {
+			cstat [i] = 1;
+		}
+		return;
+	}
+
+	/* Set the row status flags... */
+	for (i = 0; i < lps -> rows; i++) {
+		rstat [i] = lps -> bas [i + 1];
+	}
+
+	/* Set the column status flags... */
+	j = 0;
+	for (i = 1; i <= lps -> sum; i++) {
+		if (lps -> basis [i]) continue;
+		cstat [j] = lps -> lower [i];
+		++j;
+	}
+}
+
+
+/*
+ * This routine sets the current basis under lp_solve, which records
+ * the basis differently than CPLEX.  We use the "cstat" array to hold
+ * the column upper/lower bound flags, and in "rstat" we indicate which
+ * column is the basic variable for that row (including slack variable
+ * columns).
+ */
+
+	static
+	void
+lpsolve_set_basis (
+
+LP_t *		lp,		/* IN - LP tableaux to set basis of */
+int *		cstat,		/* IN - basis flags for each column */
+int *		rstat		/* IN - basis flags for each row */
+)
+{
+int		i;
+int		j;
+lprec *		lps;
+
+	lps = LPSOLVE_LP (lp);
+
+	for (i = 1; i <= lps -> sum; i++) {
+		lps -> basis [i] = 0;
+		lps -> lower [i] = 1;
+	}
+
+	/* Set the row status flags... */
+	for (i = 0; i < lps -> rows; i++) {
+		j = rstat [i];
+		lps -> bas [i + 1] = j;
+		lps -> basis [j] = 1;
+	}
+
+	/* Set the column status flags... */
+	j = 0;
+	for (i = 1; i <= lps -> sum; i++) {
+		if (lps -> basis [i]) continue;
+		lps -> lower [i] = cstat [j];
+		++j;
+	}
+
+	lps -> basis_valid = TRUE;
+	lps -> eta_valid = FALSE;
+}
+
+/*
+ * Return TRUE if the lp_solve problem has a valid basis.
+ */
+
+	static
+	bool
+lpsolve_have_basis (
+
+LP_t *		lp		/* IN - LP to check */
+)
+{
+	return (LPSOLVE_LP (lp) -> basis_valid);
+}
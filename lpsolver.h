@@ -48,27 +48,9 @@
  #endif
 #endif
 
-#ifdef LPSOLVE
-#include "lpkit.h"
-#endif
-
-
 #include "environment.h"	/* must come after cplex.h! */
 
 
-/*
- * The type used to represent an LP problem instance depends upon
- * whieh LP-solver we are using...
- */
-
-#ifdef CPLEX
-typedef struct cpxlp		LP_t;
-#endif
-
-#ifdef LPSOLVE
-typedef lprec			LP_t;
-#endif
-
 /*
  * Here are a bunch of macros that we use to insulate us from the
  * calling convention differences between CPLEX versions 3.0 and 4.0.
@@ -292,47 +274,4 @@ typedef lprec			LP_t;
  #endif
 #endif
 
-/*
- * Some macros to do common things to LP's
- */
-
-#ifdef CPLEX
-#define	GET_LP_NUM_COLS(lp)	(_MYCPX_getnumcols (lp))
-#define	GET_LP_NUM_ROWS(lp)	(_MYCPX_getnumrows (lp))
-#define	GET_LP_NUM_NZ(lp)	(_MYCPX_getnumnz (lp))
-#endif
-
-#ifdef LPSOLVE
-#define	GET_LP_NUM_COLS(lp)	((lp) -> columns)
-#define	GET_LP_NUM_ROWS(lp)	((lp) -> rows)
-#define	GET_LP_NUM_NZ(lp)	((lp) -> non_zeros)
-#endif
-
-
-/*
- * A structure to keep track of dynamic memory used by an LP.
- */
-
-#ifdef CPLEX
-struct lpmem {
-	double *	objx;
-	double *	rhsx;
-	char *		senx;
-	int *		matbeg;
-	int *		matcnt;
-	int *		matind;
-	double *	matval;
-	double *	bdl;
-	double *	bdu;
-	int		obj_scale;	/* objective scale factor */
-};
-#endif
-
-#ifdef LPSOLVE
-struct lpmem {
-	/* lp_solve_2.0 dynamically manages the LP tableaux memory... */
-	int	dummy;
-};
-#endif
-
 #endif
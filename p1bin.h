@@ -0,0 +1,84 @@
+/***********************************************************************
+
+	File:	p1bin.h
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Layout of the binary FST data file format.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#ifndef	P1BIN_H
+#define	P1BIN_H
+
+#include "gsttypes.h"
+
+/*
+ * A binary FST data file holds the same information as a version 3
+ * FST data file, in a form that can be loaded without any parsing.
+ * All values are stored in the native byte order and floating point
+ * representation of the machine that wrote the file, and files using
+ * another byte order are rejected.  The file starts with the header
+ * below, which is followed by these sections, in order:
+ *
+ *	name		name_len characters of instance description
+ *	terminals	nverts * 3 doubles: x, y, battery (geometric only)
+ *	tflag		nverts int32s: 0 = Steiner, 1 = terminal
+ *	status		nedges chars: 0 = never, 1 = maybe, 2 = always needed
+ *	edge_start	nedges + 1 int32s: start of each hyperedge in
+ *			edge_verts (CSR layout)
+ *	edge_verts	total_edge_card int32s: vertices (0..nverts-1)
+ *	cost		nedges doubles: length of each hyperedge
+ *	inc_start	nedges + 1 int32s: start of each list in inc_edges
+ *	inc_edges	total_inc int32s: incompatible hyperedges
+ *	stein_start	nedges + 1 int32s: start of each FST's Steiner
+ *			points in steiners (geometric only)
+ *	steiners	total_steiners * 3 doubles: x, y, battery
+ *			(geometric only)
+ *	fedge_start	nedges + 1 int32s: start of each FST's edges
+ *			in fedges (geometric only)
+ *	fedges		total_fst_edges * 2 int32s: FST edge endpoints
+ *			(geometric only)
+ *
+ * Each section starts at a multiple of 8 bytes from the start of the
+ * file.  An FST edge endpoint k below the number of terminals of the
+ * FST denotes its k-th terminal, otherwise Steiner point (k - that
+ * number) of the FST.
+ */
+
+#define P1BIN_MAGIC		"\211GSTFST\n"
+#define P1BIN_MAGIC_LEN		8
+#define P1BIN_BYTE_ORDER	0x01020304
+#define P1BIN_VERSION		1
+
+#define P1BIN_ALIGN(n)		(((n) + 7) & ~((size_t) 7))
+
+struct p1bin_header {
+	char		magic [P1BIN_MAGIC_LEN];
+	int32u		byte_order;	/* P1BIN_BYTE_ORDER */
+	int32u		version;	/* P1BIN_VERSION */
+	int32s		metric;		/* Same codes as in version 3 */
+	int32s		geometric;	/* Geometric sections present? */
+	int32s		nverts;		/* Number of vertices */
+	int32s		nedges;		/* Number of hyperedges */
+	int32s		scale;		/* Coordinate/length scaling factor */
+	int32s		name_len;	/* Length of instance description */
+	int32s		total_edge_card; /* Sum of hyperedge sizes */
+	int32s		total_inc;	/* Total length of incompat lists */
+	int32s		total_steiners;	/* Total number of Steiner points */
+	int32s		total_fst_edges; /* Total number of FST edges */
+	double		mst_length;	/* Length of the MST */
+	double		integrality_delta;
+	double		gen_time;	/* Generation time (seconds) */
+};
+
+#endif
@@ -51,6 +51,7 @@ o		: Fix -Wall issue.
 
 #include "p1read.h"
 
+#include "config.h"
 #include "fatal.h"
 #include <float.h>
 #include "geosteiner.h"
@@ -59,12 +60,19 @@ o		: Fix -Wall issue.
 #include <math.h>
 #include "memory.h"
 #include "metric.h"
+#include "p1bin.h"
 #include "parmblk.h"
 #include "point.h"
 #include "prepostlude.h"
 #include "sortfuncs.h"
 #include "steiner.h"
 #include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /*
  * Global Routines
@@ -87,6 +95,11 @@ void		_gst_init_term_trees (struct gst_hypergraph *);
  * Local Routines
  */
 
+static const void *	binary_section (const char *,
+					size_t,
+					size_t *,
+					size_t,
+					size_t);
 static int		get_d (FILE *);
 static double		get_dec_double (FILE *);
 static double		get_hex_double (FILE *);
@@ -99,13 +112,16 @@ static void		init_inc_edges (struct gst_hypergraph *,
 					int **,
 					int *);
 static void		init_output_conversion_old (gst_hg_ptr);
+static char *		load_file (FILE *, size_t *, bool *);
 static void		read_duplicate_terminal_groups (
 					FILE *,
 					struct gst_hypergraph *,
 					int);
+static gst_hg_ptr	read_binary (FILE *);
 static gst_hg_ptr	read_version_0 (FILE *, int);
 static gst_hg_ptr	read_version_2 (FILE *, int);
 static void		remove_duplicates (int, int **, bitmap_t *);
+static void		set_metric (struct gst_hypergraph *, int);
 static void		skip (FILE *);
 static void		verify_symmetric (int **, int);
 
@@ -123,6 +139,7 @@ gst_param_ptr	params,		/* IN - parameter set (currently not used) */
 int *		status		/* OUT - status */
 )
 {
+int		c;
 int		version;
 int		min;
 int		max;
@@ -134,10 +151,18 @@ gst_hg_ptr	H;
 		params = (gst_param_ptr) &_gst_default_parmblk;
 	}
 
-	gst_query_int_param ((gst_param_ptr) &_gst_default_parmblk,
-			     GST_PARAM_SAVE_FORMAT,
-			     NULL, NULL, &min, &max);
-	version = get_version (fp, min, max);
+	/* Binary files are recognized by their first character. */
+	c = getc (fp);
+	ungetc (c, fp);
+	if (c EQ (P1BIN_MAGIC [0] & 0xFF)) {
+		version = GST_PVAL_SAVE_FORMAT_BINARY;
+	}
+	else {
+		gst_query_int_param ((gst_param_ptr) &_gst_default_parmblk,
+				     GST_PARAM_SAVE_FORMAT,
+				     NULL, NULL, &min, &max);
+		version = get_version (fp, min, max);
+	}
 
 	switch (version) {
 	case GST_PVAL_SAVE_FORMAT_ORLIBRARY:
@@ -149,6 +174,10 @@ gst_hg_ptr	H;
 		H = read_version_2 (fp, version);
 		break;
 
+	case GST_PVAL_SAVE_FORMAT_BINARY:
+		H = read_binary (fp);
+		break;
+
 	default:
 		H = NULL;
 		break;
@@ -425,6 +454,10 @@ struct gst_hypergraph *	cip;
 
 	nverts = (int) get_d (fp);
 
+#undef RECTILINEAR
+#undef EUCLIDEAN
+#undef PURE_GRAPH
+
 	/* Allocate hypergraph... */
 	cip = gst_create_hg (NULL);
 	gst_set_hg_number_of_vertices (cip, nverts);
@@ -433,26 +466,7 @@ struct gst_hypergraph *	cip;
 		free (line);
 	}
 
-	gst_free_metric (cip -> metric);
-	switch (metric) {
-	case RECTILINEAR:
-		cip -> metric	= gst_create_metric (GST_METRIC_L, 1, NULL);
-		break;
-	case EUCLIDEAN:
-		cip -> metric	= gst_create_metric (GST_METRIC_L, 2, NULL);
-		break;
-	case PURE_GRAPH:
-		cip -> metric	= gst_create_metric (GST_METRIC_NONE, 0, NULL);
-		break;
-	default:
-		cip -> metric	= gst_create_metric (GST_METRIC_UNIFORM,
-						     metric - 1000, NULL);
-		break;
-	}
-
-#undef RECTILINEAR
-#undef EUCLIDEAN
-#undef PURE_GRAPH
+	set_metric (cip, metric);
 
 	if (geometric) {
 		(void) get_dec_double (fp);
@@ -709,6 +723,460 @@ struct gst_hypergraph *	cip;
 	return (cip);
 }
 
+/*
+ * Give the hypergraph the metric denoted by the given code of the
+ * version 2 and 3 formats.
+ */
+
+	static
+	void
+set_metric (
+
+struct gst_hypergraph *	cip,		/* IN/OUT - hypergraph */
+int			metric		/* IN - metric code */
+)
+{
+#define RECTILINEAR		1
+#define EUCLIDEAN		2
+#define PURE_GRAPH		3
+
+	gst_free_metric (cip -> metric);
+	switch (metric) {
+	case RECTILINEAR:
+		cip -> metric	= gst_create_metric (GST_METRIC_L, 1, NULL);
+		break;
+	case EUCLIDEAN:
+		cip -> metric	= gst_create_metric (GST_METRIC_L, 2, NULL);
+		break;
+	case PURE_GRAPH:
+		cip -> metric	= gst_create_metric (GST_METRIC_NONE, 0, NULL);
+		break;
+	default:
+		cip -> metric	= gst_create_metric (GST_METRIC_UNIFORM,
+						     metric - 1000, NULL);
+		break;
+	}
+
+#undef RECTILINEAR
+#undef EUCLIDEAN
+#undef PURE_GRAPH
+}
+
+/*
+ * This routine reads in the binary format described in p1bin.h.  The
+ * file is memory-mapped when possible (otherwise read into memory in
+ * one piece), and each section is then copied into the hypergraph
+ * with no parsing at all.
+ */
+
+	static
+	gst_hg_ptr
+read_binary (
+
+FILE *		fp		/* IN - input file pointer. */
+)
+{
+int			i;
+int			j;
+int			k;
+int			n;
+int			m;
+int			nt;
+int			ns;
+int			nmasks;
+size_t			size;
+size_t			off;
+bool			mapped;
+char *			buf;
+char *			name;
+const char *		descr;
+const struct p1bin_header *	hdr;
+const double *		terminals;
+const int32s *		tflag;
+const char *		status;
+const int32s *		edge_start;
+const int32s *		edge_verts;
+const double *		cost;
+const int32s *		inc_start;
+const int32s *		inc_list;
+const int32s *		stein_start;
+const double *		steiners;
+const int32s *		fedge_start;
+const int32s *		fedges;
+int *			ip1;
+int *			icounts;
+int **			incompat;
+struct point *		p1;
+struct pset *		terms;
+struct pset *		steins;
+struct full_set *	fsp;
+struct edge *		ep;
+struct gst_hypergraph *	cip;
+
+	buf = load_file (fp, &size, &mapped);
+
+	if ((size < sizeof (struct p1bin_header)) OR
+	    (memcmp (buf, P1BIN_MAGIC, P1BIN_MAGIC_LEN) NE 0)) {
+		fprintf (stderr, "Bad binary FST file header!\n");
+		exit (1);
+	}
+	hdr = (const struct p1bin_header *) buf;
+	if (hdr -> byte_order NE P1BIN_BYTE_ORDER) {
+		fprintf (stderr, "Binary FST file has wrong byte order!\n");
+		exit (1);
+	}
+	if (hdr -> version NE P1BIN_VERSION) {
+		fprintf (stderr, "Unsupported binary FST file version %u!\n",
+			 hdr -> version);
+		exit (1);
+	}
+	n = hdr -> nverts;
+	m = hdr -> nedges;
+	if ((n < 0) OR (m < 0) OR (hdr -> name_len < 0) OR
+	    (hdr -> total_edge_card < 0) OR (hdr -> total_inc < 0) OR
+	    (hdr -> total_steiners < 0) OR (hdr -> total_fst_edges < 0) OR
+	    (hdr -> metric < 1)) {
+		fprintf (stderr, "Bad binary FST file header!\n");
+		exit (1);
+	}
+
+	/* Locate all of the sections. */
+	off = P1BIN_ALIGN (sizeof (struct p1bin_header));
+	descr	   = binary_section (buf, size, &off, hdr -> name_len, 1);
+	terminals  = NULL;
+	if (hdr -> geometric) {
+		terminals = binary_section (buf, size, &off,
+					    3 * n, sizeof (double));
+	}
+	tflag	   = binary_section (buf, size, &off, n, sizeof (int32s));
+	status	   = binary_section (buf, size, &off, m, 1);
+	edge_start = binary_section (buf, size, &off, m + 1, sizeof (int32s));
+	edge_verts = binary_section (buf, size, &off,
+				     hdr -> total_edge_card, sizeof (int32s));
+	cost	   = binary_section (buf, size, &off, m, sizeof (double));
+	inc_start  = binary_section (buf, size, &off, m + 1, sizeof (int32s));
+	inc_list   = binary_section (buf, size, &off,
+				     hdr -> total_inc, sizeof (int32s));
+	stein_start	= NULL;
+	steiners	= NULL;
+	fedge_start	= NULL;
+	fedges		= NULL;
+	if (hdr -> geometric) {
+		stein_start = binary_section (buf, size, &off,
+					      m + 1, sizeof (int32s));
+		steiners    = binary_section (buf, size, &off,
+					      3 * hdr -> total_steiners,
+					      sizeof (double));
+		fedge_start = binary_section (buf, size, &off,
+					      m + 1, sizeof (int32s));
+		fedges	    = binary_section (buf, size, &off,
+					      2 * hdr -> total_fst_edges,
+					      sizeof (int32s));
+	}
+
+	/* Verify the CSR offsets before trusting them. */
+	for (i = 0; i < m; i++) {
+		if ((edge_start [i] < 0) OR
+		    (edge_start [i + 1] - edge_start [i] < 2) OR
+		    (inc_start [i] < 0) OR
+		    (inc_start [i + 1] < inc_start [i]) OR
+		    ((stein_start NE NULL) AND
+		     ((stein_start [i] < 0) OR
+		      (stein_start [i + 1] < stein_start [i]))) OR
+		    ((fedge_start NE NULL) AND
+		     ((fedge_start [i] < 0) OR
+		      (fedge_start [i + 1] < fedge_start [i])))) {
+			fprintf (stderr, "Bad hyperedge in binary FST file!\n");
+			exit (1);
+		}
+	}
+	if ((edge_start [m] NE hdr -> total_edge_card) OR
+	    (inc_start [m] NE hdr -> total_inc) OR
+	    ((stein_start NE NULL) AND
+	     (stein_start [m] NE hdr -> total_steiners)) OR
+	    ((fedge_start NE NULL) AND
+	     (fedge_start [m] NE hdr -> total_fst_edges))) {
+		fprintf (stderr, "Bad hyperedge in binary FST file!\n");
+		exit (1);
+	}
+	for (i = 0; i < hdr -> total_edge_card; i++) {
+		if ((edge_verts [i] < 0) OR (edge_verts [i] >= n)) {
+			fprintf (stderr, "Vertex number %d out of range.\n",
+				 edge_verts [i] + 1);
+			exit (1);
+		}
+	}
+	for (i = 0; i < hdr -> total_inc; i++) {
+		if ((inc_list [i] < 0) OR (inc_list [i] >= m)) {
+			fprintf (stderr, "Bad incompatible index.\n");
+			exit (1);
+		}
+	}
+
+	/* Allocate hypergraph... */
+	cip = gst_create_hg (NULL);
+	gst_set_hg_number_of_vertices (cip, n);
+	if (hdr -> name_len > 0) {
+		name = NEWA (hdr -> name_len + 1, char);
+		memcpy (name, descr, hdr -> name_len);
+		name [hdr -> name_len] = '\0';
+		gst_set_str_property (cip -> proplist, GST_PROP_HG_NAME, name);
+		free (name);
+	}
+	else {
+		gst_set_str_property (cip -> proplist, GST_PROP_HG_NAME, "");
+	}
+
+	set_metric (cip, hdr -> metric);
+
+	if (hdr -> geometric) {
+		gst_set_dbl_property (cip -> proplist,
+				      GST_PROP_HG_MST_LENGTH,
+				      hdr -> mst_length);
+	}
+	_gst_set_scale_info (cip -> scale, hdr -> scale);
+	gst_set_dbl_property (cip -> proplist,
+			      GST_PROP_HG_INTEGRALITY_DELTA,
+			      hdr -> integrality_delta);
+	gst_set_dbl_property (cip -> proplist,
+			      GST_PROP_HG_GENERATION_TIME,
+			      hdr -> gen_time);
+
+	nmasks = BMAP_ELTS (m);
+
+	cip -> num_edges	 = m;
+	cip -> num_edge_masks	 = nmasks;
+	cip -> initial_edge_mask = NEWA (nmasks, bitmap_t);
+	cip -> required_edges	 = NEWA (nmasks, bitmap_t);
+	memset (cip -> initial_edge_mask, 0, nmasks * sizeof (bitmap_t));
+	memset (cip -> required_edges,	  0, nmasks * sizeof (bitmap_t));
+
+	for (i = 0; i < m; i++) {
+		switch (status [i]) {
+		case 0:
+			break;
+
+		case 1:
+			SETBIT (cip -> initial_edge_mask, i);
+			break;
+
+		case 2:
+			SETBIT (cip -> required_edges, i);
+			SETBIT (cip -> initial_edge_mask, i);
+			break;
+
+		default:
+			fprintf (stderr, "Invalid full set status: %d\n",
+				 status [i]);
+			exit (1);
+		}
+	}
+
+	/* Hyperedges, in contiguous (CSR) form... */
+	cip -> edge	 = NEWA (m + 1, int *);
+	cip -> edge_size = NEWA (m, int);
+	cip -> cost	 = NEWA (m, dist_t);
+	ip1 = NEWA (hdr -> total_edge_card, int);
+	memcpy (ip1, edge_verts, hdr -> total_edge_card * sizeof (int));
+	for (i = 0; i < m; i++) {
+		cip -> edge [i]		= ip1 + edge_start [i];
+		cip -> edge_size [i]	= edge_start [i + 1] - edge_start [i];
+		cip -> cost [i]		= cost [i];
+	}
+	cip -> edge [m] = ip1 + edge_start [m];
+
+	for (i = 0; i < n; i++) {
+		cip -> tflag [i] = tflag [i];
+	}
+
+	if (hdr -> geometric) {
+		cip -> pts = NEW_PSET (n);
+		ZERO_PSET (cip -> pts, n);
+		cip -> pts -> n = n;
+		p1 = &(cip -> pts -> a [0]);
+		for (i = 0; i < n; i++, p1++) {
+			p1 -> x		= terminals [3 * i];
+			p1 -> y		= terminals [3 * i + 1];
+			p1 -> battery	= terminals [3 * i + 2];
+		}
+
+		cip -> full_trees = NEWA (m, struct full_set *);
+		for (i = 0; i < m; i++) {
+			nt = cip -> edge_size [i];
+			ns = stein_start [i + 1] - stein_start [i];
+
+			fsp = NEW (struct full_set);
+			(void) memset (fsp, 0, sizeof (*fsp));
+			cip -> full_trees [i] = fsp;
+			fsp -> tree_num = i;
+			fsp -> tree_len = cost [i];
+
+			fsp -> tlist = NEWA (nt, int);
+			memcpy (fsp -> tlist, cip -> edge [i], nt * sizeof (int));
+			terms = NEW_PSET (nt);
+			ZERO_PSET (terms, nt);
+			terms -> n = nt;
+			for (j = 0; j < nt; j++) {
+				terms -> a [j] = cip -> pts -> a [fsp -> tlist [j]];
+			}
+			fsp -> terminals = terms;
+
+			steins = NEW_PSET (ns);
+			ZERO_PSET (steins, ns);
+			steins -> n = ns;
+			p1 = &(steins -> a [0]);
+			for (j = 0; j < ns; j++, p1++) {
+				k = 3 * (stein_start [i] + j);
+				p1 -> x		= steiners [k];
+				p1 -> y		= steiners [k + 1];
+				p1 -> battery	= steiners [k + 2];
+			}
+			fsp -> steiners = steins;
+
+			fsp -> nedges = fedge_start [i + 1] - fedge_start [i];
+			ep = NEWA (fsp -> nedges, struct edge);
+			fsp -> edges = ep;
+			for (j = 0; j < fsp -> nedges; j++, ep++) {
+				k = 2 * (fedge_start [i] + j);
+				if ((fedges [k] < 0) OR
+				    (fedges [k] >= nt + ns) OR
+				    (fedges [k + 1] < 0) OR
+				    (fedges [k + 1] >= nt + ns)) {
+					fprintf (stderr,
+						 "Invalid edge endpoint!\n");
+					exit (1);
+				}
+				ep -> len = 0;	/* should be unused... */
+				ep -> p1  = fedges [k];
+				ep -> p2  = fedges [k + 1];
+			}
+		}
+	}
+
+	/* The incompatibility lists are used right where they are. */
+	incompat = NEWA (m, int *);
+	icounts	 = NEWA (m, int);
+	for (i = 0; i < m; i++) {
+		incompat [i] = (int *) (inc_list + inc_start [i]);
+		icounts [i]  = inc_start [i + 1] - inc_start [i];
+	}
+
+	_gst_init_term_trees (cip);
+	init_inc_edges (cip, incompat, icounts);
+
+	free ((char *) icounts);
+	free ((char *) incompat);
+
+#ifdef HAVE_MMAP
+	if (mapped) {
+		munmap (buf, size);
+	}
+	else
+#endif
+	{
+		free (buf);
+	}
+
+	return (cip);
+}
+
+/*
+ * Locate the next section of a binary file, containing n items of the
+ * given size, and advance past it (and its padding).  Complain if the
+ * file is too short.
+ */
+
+	static
+	const void *
+binary_section (
+
+const char *	buf,		/* IN - contents of file */
+size_t		size,		/* IN - size of file */
+size_t *	offp,		/* IN/OUT - offset of section */
+size_t		n,		/* IN - number of items */
+size_t		itemsize	/* IN - size of each item */
+)
+{
+size_t		off;
+size_t		nbytes;
+
+	off	= *offp;
+	nbytes	= n * itemsize;
+	if ((off > size) OR (nbytes > size - off)) {
+		fprintf (stderr, "Binary FST file is truncated!\n");
+		exit (1);
+	}
+	*offp = off + P1BIN_ALIGN (nbytes);
+
+	return (buf + off);
+}
+
+/*
+ * Get the entire contents of the given file.  A regular file that is
+ * positioned at its start is memory-mapped (if possible), so that no
+ * copy of it is made.  Otherwise the stream is read until EOF into
+ * memory allocated here.
+ */
+
+	static
+	char *
+load_file (
+
+FILE *		fp,		/* IN - input file pointer */
+size_t *	sizep,		/* OUT - size of file */
+bool *		mappedp		/* OUT - was the file memory-mapped? */
+)
+{
+size_t		size;
+size_t		avail;
+size_t		k;
+char *		buf;
+char *		nbuf;
+#ifdef HAVE_MMAP
+struct stat	st;
+void *		p;
+
+	if ((fstat (fileno (fp), &st) EQ 0) AND
+	    S_ISREG (st.st_mode) AND
+	    (st.st_size > 0) AND
+	    (ftell (fp) EQ 0)) {
+		p = mmap (NULL,
+			  (size_t) st.st_size,
+			  PROT_READ,
+			  MAP_PRIVATE,
+			  fileno (fp),
+			  0);
+		if (p NE MAP_FAILED) {
+			/* Leave the stream where reading it would have. */
+			fseek (fp, 0L, SEEK_END);
+			*sizep	 = (size_t) st.st_size;
+			*mappedp = TRUE;
+			return ((char *) p);
+		}
+	}
+#endif
+
+	size	= 0;
+	avail	= 65536;
+	buf	= NEWA (avail, char);
+	for (;;) {
+		k = fread (buf + size, 1, avail - size, fp);
+		if (k <= 0) break;
+		size += k;
+		if (size >= avail) {
+			avail *= 2;
+			nbuf = NEWA (avail, char);
+			memcpy (nbuf, buf, size);
+			free (buf);
+			buf = nbuf;
+		}
+	}
+
+	*sizep	 = size;
+	*mappedp = FALSE;
+	return (buf);
+}
+
 /*
  * This routine reads in the duplicate terminal groups.  We do not know
  * how big this is going to be.  Therefore we must plan for the worst
@@ -60,6 +60,7 @@
 #include <math.h>
 #include "memory.h"
 #include "metric.h"
+#include "p1bin.h"
 #include "parmblk.h"
 #include "point.h"
 #include "prepostlude.h"
@@ -71,6 +72,20 @@
  */
 
 int		gst_save_hg (FILE *, struct gst_hypergraph *, gst_param_ptr);
+int		gst_save_streamed_fst (FILE *,
+				       int,
+				       const int *,
+				       double,
+				       int,
+				       const double *,
+				       int,
+				       const int *,
+				       gst_scale_info_ptr,
+				       gst_param_ptr);
+int		gst_save_streamed_hg_header (FILE *,
+					     struct gst_hypergraph *,
+					     int,
+					     gst_param_ptr);
 
 
 /*
@@ -78,8 +93,21 @@ int		gst_save_hg (FILE *, struct gst_hypergraph *, gst_param_ptr);
  */
 
 static void		double_to_hex (double, char *);
+static int		metric_code (struct gst_hypergraph *, bool);
+static void		print_binary (FILE *, struct gst_hypergraph *);
+static void		print_fst_edge (FILE *, int, int, int);
+static void		print_steiner_point (FILE *,
+					     struct point *,
+					     struct gst_scale_info *);
 static void		print_version_0 (FILE *, struct gst_hypergraph *, int);
 static void		print_version_2 (FILE *, struct gst_hypergraph *, int);
+static void		print_version_2_header (FILE *,
+						struct gst_hypergraph *,
+						int,
+						int,
+						bool);
+static void		print_vertex_list (FILE *, const int *, const int *);
+static void		write_section (FILE *, const void *, size_t);
 
 /*
  * This routine prints out all of the data that is output from
@@ -118,6 +146,10 @@ int	version;
 		print_version_2 (fp, cip, version);
 		break;
 
+	case GST_PVAL_SAVE_FORMAT_BINARY:
+		print_binary (fp, cip);
+		break;
+
 	default:
 		FATAL_ERROR;
 	}
@@ -126,6 +158,117 @@ int	version;
 	return (0);
 }
 
+/*
+ * Print the part of a version 2 or 3 hypergraph file that precedes the
+ * hyperedges, for a hypergraph whose nedges hyperedges are written
+ * separately using gst_save_streamed_fst().  The hypergraph itself
+ * need not contain any of the hyperedges.
+ */
+
+	int
+gst_save_streamed_hg_header (
+
+FILE *			fp,		/* IN - file pointer for output. */
+struct gst_hypergraph *	cip,		/* IN - hypergraph (terminals). */
+int			nedges,		/* IN - number of hyperedges. */
+gst_param_ptr		params		/* IN - parameters. */
+)
+{
+int	version;
+bool	geometric;
+
+	GST_PRELUDE
+
+	if (params EQ NULL) {
+		params = (gst_param_ptr) &_gst_default_parmblk;
+	}
+	gst_get_int_param (params, GST_PARAM_SAVE_FORMAT, &version);
+
+	switch (version) {
+	case GST_PVAL_SAVE_FORMAT_VERSION2:
+	case GST_PVAL_SAVE_FORMAT_VERSION3:
+		break;
+
+	default:
+		/* Other formats cannot be written piece by piece. */
+		FATAL_ERROR;
+	}
+
+	geometric = ((cip -> metric NE GST_METRIC_NONE) AND
+		     (cip -> pts NE NULL));
+
+	print_version_2_header (fp, cip, version, nedges, geometric);
+
+	GST_POSTLUDE
+	return (0);
+}
+
+/*
+ * Print one FST (as handed out by gst_generate_efsts_streamed(), for
+ * example) in the version 2 or 3 hyperedge format.  The FST is marked
+ * as sometimes needed and without incompatibilities.
+ */
+
+	int
+gst_save_streamed_fst (
+
+FILE *			fp,		/* IN - file pointer for output. */
+int			nverts,		/* IN - number of terminals */
+const int *		verts,		/* IN - terminals of the FST */
+double			weight,		/* IN - length of the FST */
+int			nsps,		/* IN - number of Steiner points */
+const double *		coords,		/* IN - Steiner point coordinates */
+int			nedges,		/* IN - number of FST edges */
+const int *		edges,		/* IN - FST edge endpoints */
+gst_scale_info_ptr	scinfo,		/* IN - scaling info */
+gst_param_ptr		params		/* IN - parameters. */
+)
+{
+int		i;
+int		version;
+struct point	p;
+char		buf1 [64];
+char		buf2 [64];
+
+	GST_PRELUDE
+
+	if (params EQ NULL) {
+		params = (gst_param_ptr) &_gst_default_parmblk;
+	}
+	gst_get_int_param (params, GST_PARAM_SAVE_FORMAT, &version);
+
+	fprintf (fp, "\t%d\n", nverts);
+	print_vertex_list (fp, verts, verts + nverts);
+
+	_gst_dist_to_string (buf1, weight, scinfo);
+	double_to_hex (weight, buf2);
+	fprintf (fp, "\t%s\t%s\n", buf1, buf2);
+
+	fprintf (fp, "\t%d\n", nsps);
+	for (i = 0; i < nsps; i++) {
+		p.x		= coords [2 * i];
+		p.y		= coords [2 * i + 1];
+		p.battery	= 0.0;
+		print_steiner_point (fp, &p, scinfo);
+	}
+
+	fprintf (fp, "\t%d\n", nedges);
+	for (i = 0; i < nedges; i++) {
+		print_fst_edge (fp, edges [2 * i], edges [2 * i + 1], nverts);
+	}
+
+	fprintf (fp, "\t1\n");	/* edge sometimes needed */
+	fprintf (fp, "\t0\n");	/* no incompatibility info */
+
+	if (version <= GST_PVAL_SAVE_FORMAT_VERSION2) {
+		/* No strongly compatible hyperedges... */
+		fprintf (fp, "\t0\n");
+	}
+
+	GST_POSTLUDE
+	return (0);
+}
+
 /*
  * This routine prints out the extended OR-library format -- version 0.
  */
@@ -356,9 +499,6 @@ int			m;
 int			col;
 int			kmasks;
 int			count;
-int			slen;
-dist_t			mst_len;
-struct point *		p1;
 struct full_set *	fsp;
 struct pset *		terms;
 struct pset *		steins;
@@ -368,18 +508,10 @@ int *			ep3;
 int *			flist;
 int *			vp1;
 int *			vp2;
-double			idelta;
-double			gen_time;
-double			prune_time;
 bitmap_t *		tmask;
 bool			geometric;
-char *			descr;
 char			buf1 [64];
 char			buf2 [64];
-char			buf3 [64];
-char			buf4 [64];
-char			buf5 [64];
-gst_proplist_ptr	hgprop;
 
 #define MAXCOL	78
 
@@ -393,128 +525,7 @@ gst_proplist_ptr	hgprop;
 
 	fprintf(stderr, "DEBUG WRITE: n=%d vertices, m=%d edges\n", n, m);
 
-	fprintf (fp, "V%d\n", version);
-
-	hgprop = gst_get_hg_properties (cip);
-
-	slen = -1;
-	gst_get_str_property (hgprop, GST_PROP_HG_NAME, &slen, NULL);
-	if (slen > 0) {
-		descr = NEWA (slen + 1, char);
-		gst_get_str_property (hgprop, GST_PROP_HG_NAME, NULL, descr);
-		fprintf (fp, "%s\n", descr);
-		free (descr);
-	}
-	else {
-		fprintf (fp, "\n");
-	}
-
-#define RECTILINEAR		1
-#define EUCLIDEAN		2
-#define PURE_GRAPH		3
-/* Other values should be interpreted as follows (to stay backwards compatible)
-  #define UNIFORM_LAMBDA_2	1002
-  #define UNIFORM_LAMBDA_3	1003
-   ...
-*/
-	if (geometric) {
-		if (_gst_is_rectilinear (cip)) {
-			fprintf (fp, "%d\n", RECTILINEAR);
-		}
-		else if (_gst_is_euclidean (cip)) {
-			fprintf (fp, "%d\n", EUCLIDEAN);
-		}
-		else if (cip -> metric -> type EQ GST_METRIC_UNIFORM) {
-			fprintf (fp, "%d\n", cip -> metric -> parameter + 1000);
-		}
-		else {
-			FATAL_ERROR;
-		}
-	}
-	else {
-		/* Not enough info to put out geometric stuff -- pure graph */
-		fprintf (fp, "%d\n", PURE_GRAPH);
-	}
-	fprintf (fp, "%d\n", n);
-#undef	RECTILINEAR
-#undef	EUCLIDEAN
-#undef	PURE_GRAPH
-
-	if (geometric) {
-		/* Compute MST length... */
-		mst_len = 0.0;
-		gst_get_dbl_property (cip -> proplist,
-				      GST_PROP_HG_MST_LENGTH,
-				      &mst_len);
-		_gst_dist_to_string (buf1, mst_len, cip -> scale);
-		double_to_hex ((double) mst_len, buf2);
-		fprintf (fp, "%s %s\n", buf1, buf2);
-	}
-
-	if ((version <= GST_PVAL_SAVE_FORMAT_VERSION2) AND geometric) {
-		/* No duplicate terminal groups... */
-		fprintf (fp, "0\n");
-	}
-	fprintf (fp, "%d\n", cip -> scale -> scale);
-	if (version >= GST_PVAL_SAVE_FORMAT_VERSION3) {
-		/* Version 3 has integrality delta... */
-		idelta = 0.0;
-		gst_get_dbl_property (cip -> proplist,
-				      GST_PROP_HG_INTEGRALITY_DELTA,
-				      &idelta);
-		_gst_dist_to_string (buf1, idelta, cip -> scale);
-		double_to_hex ((double) idelta, buf2);
-		fprintf (fp, "%s %s\n", buf1, buf2);
-	}
-
-	fprintf (fp, "%s\n", gst_env -> machine_string);
-
-	/* Note that generation and pruning time cannot be saved independently.
-	   Instead they are added and saved as generation time (old p1time) */
-	gen_time = 0.0;
-	gst_get_dbl_property (cip -> proplist,
-			      GST_PROP_HG_GENERATION_TIME,
-			      &gen_time);
-	prune_time = 0.0;
-	gst_get_dbl_property (cip -> proplist,
-			      GST_PROP_HG_PRUNING_TIME,
-			      &prune_time);
-	fprintf (fp, "%u\n",			/* CPU time */
-		 _gst_double_seconds_to_cpu_time_t (gen_time + prune_time));
-	fprintf (fp, "%d\n", m);		/* Number of hyperedges */
-
-	if (geometric) {
-		p1 = &(cip -> pts -> a [0]);
-		for (i = 0; i < n; i++, p1++) {
-			_gst_coord_to_string (buf1, p1 -> x, cip -> scale);
-			_gst_coord_to_string (buf2, p1 -> y, cip -> scale);
-			double_to_hex ((double) (p1 -> x), buf3);
-			double_to_hex ((double) (p1 -> y), buf4);
-			/* PSW: Add battery value to hypergraph format */
-			char buf5[64];
-			sprintf (buf5, "%.15f", p1 -> battery);
-			fprintf (fp, "\t%s\t%s\t%s\t%s\t%s\n",
-				 buf1, buf2, buf3, buf4, buf5);
-		}
-	}
-
-	if (version >= GST_PVAL_SAVE_FORMAT_VERSION3) {
-		/* Print the terminal/Steiner flag for each vertex. */
-		j = 0;
-		for (i = 0; i < n; i++) {
-			if (j EQ 0) {
-				fprintf (fp, "\t");
-			}
-			fprintf (fp, " %d", cip -> tflag [i]);
-			if (++j >= 10) {
-				fprintf (fp, "\n");
-				j = 0;
-			}
-		}
-		if (j > 0) {
-			fprintf (fp, "\n");
-		}
-	}
+	print_version_2_header (fp, cip, version, m, geometric);
 
 	flist = NEWA (m, int);
 	tmask = NEWA (kmasks, bitmap_t);
@@ -525,28 +536,7 @@ gst_proplist_ptr	hgprop;
 	/* hyperedges... */
 	for (i = 0; i < m; i++) {
 		fprintf (fp, "\t%d\n", cip -> edge_size [i]);
-		fprintf (fp, "\t");
-		vp1 = cip -> edge [i];
-		vp2 = cip -> edge [i + 1];
-		col = 8;
-		while (vp1 < vp2) {
-			j = *vp1++;
-			sprintf (buf1, "%d", j + 1);
-			k = strlen (buf1);
-			if (col + 1 + k >= MAXCOL) {
-				fprintf (fp, "\n\t\t%s", buf1);
-				col = 16 + k;
-			}
-			else if (col <= 8) {
-				fprintf (fp, "%s", buf1);
-				col += k;
-			}
-			else {
-				fprintf (fp, " %s", buf1);
-				col += (1 + k);
-			}
-		}
-		fprintf (fp, "\n");
+		print_vertex_list (fp, cip -> edge [i], cip -> edge [i + 1]);
 
 		_gst_dist_to_string (buf1, cip -> cost [i], cip -> scale);
 		double_to_hex ((double) (cip -> cost [i]), buf2);
@@ -563,33 +553,18 @@ gst_proplist_ptr	hgprop;
 			else {
 				fprintf (fp, "\t%d\n", steins -> n);
 				for (j = 0; j < steins -> n; j++) {
-					p1 = &(steins -> a [j]);
-					_gst_coord_to_string (buf1,
-							      p1 -> x,
-							      cip -> scale);
-					_gst_coord_to_string (buf2,
-							      p1 -> y,
-							      cip -> scale);
-					double_to_hex ((double) (p1 -> x), buf3);
-					double_to_hex ((double) (p1 -> y), buf4);
-					double_to_hex ((double) (p1 -> battery), buf5);
-					fprintf (fp, "\t%s\t%s\t%s\t%s\t%s\n",
-						 buf1, buf2, buf3, buf4, buf5);
+					print_steiner_point (fp,
+							     &(steins -> a [j]),
+							     cip -> scale);
 				}
 			}
 
 			fprintf (fp, "\t%d\n", fsp -> nedges);
 			for (j = 0; j < fsp -> nedges; j++) {
-				k = fsp -> edges [j].p1;
-				fprintf (fp, "\t\t%d",
-					(k < terms -> n)
-					    ? k + 1
-					    : terms -> n - k - 1);
-				k = fsp -> edges [j].p2;
-				fprintf (fp, "\t%d\n",
-					(k < terms -> n)
-					    ? k + 1
-					    : terms -> n - k - 1);
+				print_fst_edge (fp,
+						fsp -> edges [j].p1,
+						fsp -> edges [j].p2,
+						terms -> n);
 			}
 		}
 
@@ -700,6 +675,512 @@ gst_proplist_ptr	hgprop;
 #undef MAXCOL
 }
 
+/*
+ * Print everything in the version 2 or 3 format that precedes the
+ * hyperedges, announcing m of them.
+ */
+
+	static
+	void
+print_version_2_header (
+
+FILE *			fp,		/* IN - file pointer for output. */
+struct gst_hypergraph *	cip,		/* IN - compatibility info. */
+int			version,	/* IN - version to generate. */
+int			m,		/* IN - number of hyperedges. */
+bool			geometric	/* IN - print geometric info? */
+)
+{
+int			i;
+int			j;
+int			n;
+int			slen;
+dist_t			mst_len;
+struct point *		p1;
+double			idelta;
+double			gen_time;
+double			prune_time;
+char *			descr;
+char			buf1 [64];
+char			buf2 [64];
+char			buf3 [64];
+char			buf4 [64];
+gst_proplist_ptr	hgprop;
+
+	n = cip -> num_verts;
+
+	fprintf (fp, "V%d\n", version);
+
+	hgprop = gst_get_hg_properties (cip);
+
+	slen = -1;
+	gst_get_str_property (hgprop, GST_PROP_HG_NAME, &slen, NULL);
+	if (slen > 0) {
+		descr = NEWA (slen + 1, char);
+		gst_get_str_property (hgprop, GST_PROP_HG_NAME, NULL, descr);
+		fprintf (fp, "%s\n", descr);
+		free (descr);
+	}
+	else {
+		fprintf (fp, "\n");
+	}
+
+	fprintf (fp, "%d\n", metric_code (cip, geometric));
+	fprintf (fp, "%d\n", n);
+
+	if (geometric) {
+		/* Compute MST length... */
+		mst_len = 0.0;
+		gst_get_dbl_property (cip -> proplist,
+				      GST_PROP_HG_MST_LENGTH,
+				      &mst_len);
+		_gst_dist_to_string (buf1, mst_len, cip -> scale);
+		double_to_hex ((double) mst_len, buf2);
+		fprintf (fp, "%s %s\n", buf1, buf2);
+	}
+
+	if ((version <= GST_PVAL_SAVE_FORMAT_VERSION2) AND geometric) {
+		/* No duplicate terminal groups... */
+		fprintf (fp, "0\n");
+	}
+	fprintf (fp, "%d\n", cip -> scale -> scale);
+	if (version >= GST_PVAL_SAVE_FORMAT_VERSION3) {
+		/* Version 3 has integrality delta... */
+		idelta = 0.0;
+		gst_get_dbl_property (cip -> proplist,
+				      GST_PROP_HG_INTEGRALITY_DELTA,
+				      &idelta);
+		_gst_dist_to_string (buf1, idelta, cip -> scale);
+		double_to_hex ((double) idelta, buf2);
+		fprintf (fp, "%s %s\n", buf1, buf2);
+	}
+
+	fprintf (fp, "%s\n", gst_env -> machine_string);
+
+	/* Note that generation and pruning time cannot be saved independently.
+	   Instead they are added and saved as generation time (old p1time) */
+	gen_time = 0.0;
+	gst_get_dbl_property (cip -> proplist,
+			      GST_PROP_HG_GENERATION_TIME,
+			      &gen_time);
+	prune_time = 0.0;
+	gst_get_dbl_property (cip -> proplist,
+			      GST_PROP_HG_PRUNING_TIME,
+			      &prune_time);
+	fprintf (fp, "%u\n",			/* CPU time */
+		 _gst_double_seconds_to_cpu_time_t (gen_time + prune_time));
+	fprintf (fp, "%d\n", m);		/* Number of hyperedges */
+
+	if (geometric) {
+		p1 = &(cip -> pts -> a [0]);
+		for (i = 0; i < n; i++, p1++) {
+			_gst_coord_to_string (buf1, p1 -> x, cip -> scale);
+			_gst_coord_to_string (buf2, p1 -> y, cip -> scale);
+			double_to_hex ((double) (p1 -> x), buf3);
+			double_to_hex ((double) (p1 -> y), buf4);
+			/* PSW: Add battery value to hypergraph format */
+			char buf5[64];
+			sprintf (buf5, "%.15f", p1 -> battery);
+			fprintf (fp, "\t%s\t%s\t%s\t%s\t%s\n",
+				 buf1, buf2, buf3, buf4, buf5);
+		}
+	}
+
+	if (version >= GST_PVAL_SAVE_FORMAT_VERSION3) {
+		/* Print the terminal/Steiner flag for each vertex. */
+		j = 0;
+		for (i = 0; i < n; i++) {
+			if (j EQ 0) {
+				fprintf (fp, "\t");
+			}
+			fprintf (fp, " %d", cip -> tflag [i]);
+			if (++j >= 10) {
+				fprintf (fp, "\n");
+				j = 0;
+			}
+		}
+		if (j > 0) {
+			fprintf (fp, "\n");
+		}
+	}
+}
+
+/*
+ * Return the code for the metric of the hypergraph, as used in the
+ * version 2 and 3 formats.
+ */
+
+	static
+	int
+metric_code (
+
+struct gst_hypergraph *	cip,		/* IN - compatibility info. */
+bool			geometric	/* IN - print geometric info? */
+)
+{
+#define RECTILINEAR		1
+#define EUCLIDEAN		2
+#define PURE_GRAPH		3
+/* Other values should be interpreted as follows (to stay backwards compatible)
+  #define UNIFORM_LAMBDA_2	1002
+  #define UNIFORM_LAMBDA_3	1003
+   ...
+*/
+	if (NOT geometric) {
+		/* Not enough info to put out geometric stuff -- pure graph */
+		return (PURE_GRAPH);
+	}
+	if (_gst_is_rectilinear (cip)) {
+		return (RECTILINEAR);
+	}
+	if (_gst_is_euclidean (cip)) {
+		return (EUCLIDEAN);
+	}
+	if (cip -> metric -> type EQ GST_METRIC_UNIFORM) {
+		return (cip -> metric -> parameter + 1000);
+	}
+	FATAL_ERROR;
+	return (PURE_GRAPH);
+
+#undef	RECTILINEAR
+#undef	EUCLIDEAN
+#undef	PURE_GRAPH
+}
+
+/*
+ * This routine writes the hypergraph in the binary format described
+ * in p1bin.h.  The vertices of all hyperedges are already stored
+ * contiguously, so they are written with a single call.
+ */
+
+	static
+	void
+print_binary (
+
+FILE *			fp,		/* IN - file pointer for output. */
+struct gst_hypergraph *	cip		/* IN - compatibility info. */
+)
+{
+int			i;
+int			j;
+int			k;
+int			n;
+int			m;
+int			slen;
+bool			geometric;
+double			prune_time;
+char *			descr;
+char *			status;
+int32s *		start;
+int32s *		ip;
+double *		dp;
+struct full_set *	fsp;
+struct point *		p1;
+struct p1bin_header	hdr;
+gst_proplist_ptr	hgprop;
+
+	geometric = ((cip -> metric NE GST_METRIC_NONE) AND
+		     (cip -> full_trees NE NULL) AND
+		     (cip -> pts NE NULL));
+
+	n = cip -> num_verts;
+	m = cip -> num_edges;
+
+	hgprop = gst_get_hg_properties (cip);
+
+	slen = -1;
+	gst_get_str_property (hgprop, GST_PROP_HG_NAME, &slen, NULL);
+	descr = NULL;
+	if (slen > 0) {
+		descr = NEWA (slen + 1, char);
+		gst_get_str_property (hgprop, GST_PROP_HG_NAME, NULL, descr);
+	}
+	else {
+		slen = 0;
+	}
+
+	memset (&hdr, 0, sizeof (hdr));
+	memcpy (hdr.magic, P1BIN_MAGIC, P1BIN_MAGIC_LEN);
+	hdr.byte_order		= P1BIN_BYTE_ORDER;
+	hdr.version		= P1BIN_VERSION;
+	hdr.metric		= metric_code (cip, geometric);
+	hdr.geometric		= geometric;
+	hdr.nverts		= n;
+	hdr.nedges		= m;
+	hdr.scale		= cip -> scale -> scale;
+	hdr.name_len		= slen;
+	hdr.total_edge_card	= cip -> edge [m] - cip -> edge [0];
+	hdr.total_inc		= 0;
+	hdr.total_steiners	= 0;
+	hdr.total_fst_edges	= 0;
+	if (cip -> inc_edges NE NULL) {
+		for (i = 0; i < m; i++) {
+			hdr.total_inc += cip -> inc_edges [i + 1]
+					 - cip -> inc_edges [i];
+		}
+	}
+	if (geometric) {
+		for (i = 0; i < m; i++) {
+			fsp = cip -> full_trees [i];
+			if (fsp -> steiners NE NULL) {
+				hdr.total_steiners += fsp -> steiners -> n;
+			}
+			hdr.total_fst_edges += fsp -> nedges;
+		}
+	}
+	gst_get_dbl_property (cip -> proplist,
+			      GST_PROP_HG_MST_LENGTH,
+			      &hdr.mst_length);
+	gst_get_dbl_property (cip -> proplist,
+			      GST_PROP_HG_INTEGRALITY_DELTA,
+			      &hdr.integrality_delta);
+	gst_get_dbl_property (cip -> proplist,
+			      GST_PROP_HG_GENERATION_TIME,
+			      &hdr.gen_time);
+	/* As in the text formats, pruning time is added to generation time. */
+	prune_time = 0.0;
+	gst_get_dbl_property (cip -> proplist,
+			      GST_PROP_HG_PRUNING_TIME,
+			      &prune_time);
+	hdr.gen_time += prune_time;
+
+	write_section (fp, &hdr, sizeof (hdr));
+	write_section (fp, descr, slen);
+	if (descr NE NULL) {
+		free (descr);
+	}
+
+	if (geometric) {
+		dp = NEWA (3 * n, double);
+		p1 = &(cip -> pts -> a [0]);
+		for (i = 0; i < n; i++, p1++) {
+			dp [3 * i]	= p1 -> x;
+			dp [3 * i + 1]	= p1 -> y;
+			dp [3 * i + 2]	= p1 -> battery;
+		}
+		write_section (fp, dp, 3 * n * sizeof (double));
+		free ((char *) dp);
+	}
+
+	ip = NEWA (n, int32s);
+	for (i = 0; i < n; i++) {
+		ip [i] = cip -> tflag [i];
+	}
+	write_section (fp, ip, n * sizeof (int32s));
+	free ((char *) ip);
+
+	status = NEWA (m, char);
+	for (i = 0; i < m; i++) {
+		if ((cip -> initial_edge_mask NE NULL) AND
+		    (NOT BITON (cip -> initial_edge_mask, i))) {
+			status [i] = 0;		/* edge never needed */
+		}
+		else if ((cip -> required_edges NE NULL) AND
+			 (BITON (cip -> required_edges, i))) {
+			status [i] = 2;		/* edge always needed */
+		}
+		else {
+			status [i] = 1;		/* edge sometimes needed */
+		}
+	}
+	write_section (fp, status, m);
+	free (status);
+
+	start = NEWA (m + 1, int32s);
+	for (i = 0; i <= m; i++) {
+		start [i] = cip -> edge [i] - cip -> edge [0];
+	}
+	write_section (fp, start, (m + 1) * sizeof (int32s));
+	write_section (fp,
+		       cip -> edge [0],
+		       hdr.total_edge_card * sizeof (int32s));
+	write_section (fp, cip -> cost, m * sizeof (double));
+
+	k = 0;
+	for (i = 0; i < m; i++) {
+		start [i] = k;
+		if (cip -> inc_edges NE NULL) {
+			k += cip -> inc_edges [i + 1] - cip -> inc_edges [i];
+		}
+	}
+	start [m] = k;
+	write_section (fp, start, (m + 1) * sizeof (int32s));
+	if (cip -> inc_edges NE NULL) {
+		for (i = 0; i < m; i++) {
+			fwrite (cip -> inc_edges [i],
+				sizeof (int32s),
+				cip -> inc_edges [i + 1] - cip -> inc_edges [i],
+				fp);
+		}
+	}
+	write_section (fp, NULL, hdr.total_inc * sizeof (int32s));
+
+	if (geometric) {
+		k = 0;
+		for (i = 0; i < m; i++) {
+			start [i] = k;
+			fsp = cip -> full_trees [i];
+			if (fsp -> steiners NE NULL) {
+				k += fsp -> steiners -> n;
+			}
+		}
+		start [m] = k;
+		write_section (fp, start, (m + 1) * sizeof (int32s));
+
+		dp = NEWA (3 * k, double);
+		for (i = 0; i < m; i++) {
+			fsp = cip -> full_trees [i];
+			if (fsp -> steiners EQ NULL) continue;
+			p1 = &(fsp -> steiners -> a [0]);
+			for (j = 0; j < fsp -> steiners -> n; j++, p1++) {
+				dp [3 * (start [i] + j)]	= p1 -> x;
+				dp [3 * (start [i] + j) + 1]	= p1 -> y;
+				dp [3 * (start [i] + j) + 2]	= p1 -> battery;
+			}
+		}
+		write_section (fp, dp, 3 * k * sizeof (double));
+		free ((char *) dp);
+
+		k = 0;
+		for (i = 0; i < m; i++) {
+			start [i] = k;
+			k += cip -> full_trees [i] -> nedges;
+		}
+		start [m] = k;
+		write_section (fp, start, (m + 1) * sizeof (int32s));
+
+		ip = NEWA (2 * k, int32s);
+		for (i = 0; i < m; i++) {
+			fsp = cip -> full_trees [i];
+			for (j = 0; j < fsp -> nedges; j++) {
+				ip [2 * (start [i] + j)]     = fsp -> edges [j].p1;
+				ip [2 * (start [i] + j) + 1] = fsp -> edges [j].p2;
+			}
+		}
+		write_section (fp, ip, 2 * k * sizeof (int32s));
+		free ((char *) ip);
+	}
+
+	free ((char *) start);
+}
+
+/*
+ * Write one section of a binary file, followed by the padding needed
+ * to start the next section on a multiple of 8 bytes.  A NULL section
+ * means that its data has already been written.
+ */
+
+	static
+	void
+write_section (
+
+FILE *			fp,		/* IN - file pointer for output. */
+const void *		p,		/* IN - data to write */
+size_t			nbytes		/* IN - size of the data */
+)
+{
+static const char	zeros [8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+	if ((p NE NULL) AND (nbytes > 0)) {
+		fwrite (p, 1, nbytes, fp);
+	}
+	fwrite (zeros, 1, P1BIN_ALIGN (nbytes) - nbytes, fp);
+}
+
+/*
+ * Print the vertices of one hyperedge (numbered from 1), wrapping
+ * long lists.
+ */
+
+	static
+	void
+print_vertex_list (
+
+FILE *			fp,		/* IN - file pointer for output. */
+const int *		vp1,		/* IN - first vertex */
+const int *		vp2		/* IN - end of vertices */
+)
+{
+int			j;
+int			k;
+int			col;
+char			buf1 [64];
+
+#define MAXCOL	78
+
+	fprintf (fp, "\t");
+	col = 8;
+	while (vp1 < vp2) {
+		j = *vp1++;
+		sprintf (buf1, "%d", j + 1);
+		k = strlen (buf1);
+		if (col + 1 + k >= MAXCOL) {
+			fprintf (fp, "\n\t\t%s", buf1);
+			col = 16 + k;
+		}
+		else if (col <= 8) {
+			fprintf (fp, "%s", buf1);
+			col += k;
+		}
+		else {
+			fprintf (fp, " %s", buf1);
+			col += (1 + k);
+		}
+	}
+	fprintf (fp, "\n");
+
+#undef MAXCOL
+}
+
+/*
+ * Print one Steiner point of an FST.
+ */
+
+	static
+	void
+print_steiner_point (
+
+FILE *			fp,		/* IN - file pointer for output. */
+struct point *		p1,		/* IN - Steiner point */
+struct gst_scale_info *	scale		/* IN - scaling info */
+)
+{
+char			buf1 [64];
+char			buf2 [64];
+char			buf3 [64];
+char			buf4 [64];
+char			buf5 [64];
+
+	_gst_coord_to_string (buf1, p1 -> x, scale);
+	_gst_coord_to_string (buf2, p1 -> y, scale);
+	double_to_hex ((double) (p1 -> x), buf3);
+	double_to_hex ((double) (p1 -> y), buf4);
+	double_to_hex ((double) (p1 -> battery), buf5);
+	fprintf (fp, "\t%s\t%s\t%s\t%s\t%s\n",
+		 buf1, buf2, buf3, buf4, buf5);
+}
+
+/*
+ * Print one edge of an FST.  Endpoints below nterms are terminals of
+ * the FST, the others are Steiner points.
+ */
+
+	static
+	void
+print_fst_edge (
+
+FILE *			fp,		/* IN - file pointer for output. */
+int			p1,		/* IN - first endpoint */
+int			p2,		/* IN - second endpoint */
+int			nterms		/* IN - number of terminals in FST */
+)
+{
+	fprintf (fp, "\t\t%d",
+		(p1 < nterms) ? p1 + 1 : nterms - p1 - 1);
+	fprintf (fp, "\t%d\n",
+		(p2 < nterms) ? p2 + 1 : nterms - p2 - 1);
+}
+
 /*
  * This routine converts a double into a printable ASCII string
  * that represents the exact numeric value in hexidecimal.  The
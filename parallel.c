@@ -0,0 +1,145 @@
+/***********************************************************************
+
+	File:	parallel.c
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Minimal fork/join support for running independent pieces
+	of work on several threads.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#include "parallel.h"
+
+#include "config.h"
+#include "logic.h"
+#include "memory.h"
+#include <stdlib.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+
+/*
+ * Global Routines
+ */
+
+void		_gst_run_parallel (int, void (*) (void *), void **);
+
+
+/*
+ * Local Types
+ */
+
+#ifdef HAVE_PTHREAD
+struct thread_arg {
+	void		(*func) (void *);
+	void *		arg;
+};
+#endif
+
+
+/*
+ * Local Routines
+ */
+
+#ifdef HAVE_PTHREAD
+static void *		thread_main (void *);
+#endif
+
+/*
+ * Call func (args [i]) for i = 0, 1, ..., nthreads-1, each on its own
+ * thread, and wait for all of them to finish.  The calling thread
+ * does args [0] itself.  The calls must not depend upon each other:
+ * if threads are unavailable (or cannot be created) the remaining
+ * calls are simply made one after another by the calling thread.
+ */
+
+	void
+_gst_run_parallel (
+
+int		nthreads,		/* IN - number of calls to make */
+void		(*func) (void *),	/* IN - function to call */
+void **		args			/* IN - argument for each call */
+)
+{
+int			i;
+#ifdef HAVE_PTHREAD
+int			nstarted;
+pthread_t *		tids;
+struct thread_arg *	targs;
+#endif
+
+	if (nthreads <= 0) return;
+
+#ifdef HAVE_PTHREAD
+	if (nthreads > 1) {
+		tids	= NEWA (nthreads, pthread_t);
+		targs	= NEWA (nthreads, struct thread_arg);
+
+		nstarted = 1;
+		for (i = 1; i < nthreads; i++) {
+			targs [i].func	= func;
+			targs [i].arg	= args [i];
+			if (pthread_create (&tids [i],
+					    NULL,
+					    thread_main,
+					    &targs [i]) NE 0) break;
+			++nstarted;
+		}
+
+		(*func) (args [0]);
+
+		/* Do any that we could not start ourselves. */
+		for (i = nstarted; i < nthreads; i++) {
+			(*func) (args [i]);
+		}
+
+		for (i = 1; i < nstarted; i++) {
+			pthread_join (tids [i], NULL);
+		}
+
+		free ((char *) targs);
+		free ((char *) tids);
+		return;
+	}
+#endif
+
+	for (i = 0; i < nthreads; i++) {
+		(*func) (args [i]);
+	}
+}
+
+/*
+ * Entry point of each thread started by _gst_run_parallel.
+ */
+
+#ifdef HAVE_PTHREAD
+
+	static
+	void *
+thread_main (
+
+void *		p		/* IN - struct thread_arg */
+)
+{
+struct thread_arg *	tap;
+
+	tap = (struct thread_arg *) p;
+
+	(*(tap -> func)) (tap -> arg);
+
+	return (NULL);
+}
+
+#endif
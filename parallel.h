@@ -0,0 +1,28 @@
+/***********************************************************************
+
+	File:	parallel.h
+	Rev:	a-1
+	Date:	10/18/2026
+
+************************************************************************
+
+	Minimal fork/join support for running independent pieces
+	of work on several threads.
+
+************************************************************************
+
+	Modification Log:
+
+	a-1:	10/18/2026
+		: Created.
+
+************************************************************************/
+
+#ifndef	PARALLEL_H
+#define	PARALLEL_H
+
+extern void		_gst_run_parallel (int		nthreads,
+					   void		(*func) (void *),
+					   void **	args);
+
+#endif
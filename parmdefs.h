@@ -77,9 +77,9 @@
  f(BACKTRACK_MAX_VERTS,		1024, backtrack_max_verts,	 0, 32, 8) \
  f(BACKTRACK_MAX_EDGES,		1025, backtrack_max_edges,	 0, 32, 12) \
  f(MAX_BACKTRACKS,		1026, max_backtracks,		 0, INT_MAX, 10000) \
- f(SAVE_FORMAT,			1027, save_format,		 0, 4, 3) \
+ f(SAVE_FORMAT,			1027, save_format,		 0, 5, 3) \
  f(GRID_OVERLAY,		1028, grid_overlay,		 0, 1, 1) \
- f(BSD_METHOD,			1029, bsd_method,		 0, 2, 0) \
+ f(BSD_METHOD,			1029, bsd_method,		 0, 3, 0) \
  f(MAX_CUTSET_ENUMERATE_COMPS,	1030, max_cutset_enumerate_comps,0, 11, MCEC) \
  f(SEC_ENUM_LIMIT,		1031, sec_enum_limit,		 0, 16, 10) \
  f(SAVE_INT_NUMBITS,		1032, save_int_numbits,		32, INT_MAX, 64) \
@@ -92,6 +92,9 @@
  f(INITIAL_PRIMAL_HEURISTIC,	1039, initial_primal_heuristic,	 0, 1, 0) \
  f(INITIAL_PRIMAL_HEUR_STOP,	1040, initial_primal_heur_stop,	 0, 1, 0) \
  f(LOCALCUTS_TRACE_STYLE,	1041, local_cuts_trace_style,	 0, 1, 0) \
+ f(GC_SLICE_ROWS,		1042, gc_slice_rows,		 0, INT_MAX, 1000) \
+ f(NUM_THREADS,			1043, num_threads,		 1, 1024, 1) \
+ f(EFST_TILE_SIZE,		1044, efst_tile_size,		 0, INT_MAX, 0) \
 	/* end of list */
 
 /* Define all of the DOUBLE parameters right here. */
@@ -105,6 +108,7 @@
  f(UPPER_BOUND_TARGET,		2004, upper_bound_target,	  -DBL_MAX, DBL_MAX, -DBL_MAX) \
  f(LOWER_BOUND_TARGET,		2005, lower_bound_target,	  -DBL_MAX, DBL_MAX, DBL_MAX) \
  f(CHECKPOINT_INTERVAL,		2006, checkpoint_interval, 0, 1000000.0, 3600) \
+ f(EFST_TILE_OVERLAP,		2007, efst_tile_overlap,	  0, DBL_MAX, 3) \
 	/* end of list */
 
 /* Define all of the STRING parameters right here. */
@@ -113,6 +117,7 @@
 #define STRPARMS(f) \
   f(CHECKPOINT_FILENAME,	3000, checkpoint_filename,	NULL, NULL) \
   f(MERGE_CONSTRAINT_FILES,	3001, merge_constraint_files,	NULL, NULL) \
+  f(LP_SOLVER,			3002, lp_solver,		_gst_valid_lp_solver, NULL) \
 	/* end of list */
 
 /* Define all of the CHANNEL parameters right here. */
@@ -37,6 +37,7 @@
 #include "geosteiner.h"
 #include <limits.h>
 #include "logic.h"
+#include "lpbackend.h"
 #include "memory.h"
 #include "parmblk.h"
 #include "prepostlude.h"
@@ -86,6 +86,12 @@ struct PRNG {
 
 #define	MAX_DIGITS_PER_BLOCK	38
 
+/*
+ * Number of random blocks computed at once in binary mode.
+ */
+
+#define	BLOCKS_PER_BATCH	256
+
 struct DecBuf {
 	struct PRNG *	state;		/* PRNG state object */
 	int		ndigits;	/* # digits in generated numbers */
@@ -125,6 +131,9 @@ struct my_data {
 static void	blank_out_leading_zeros (char * buf, int n);
 static void	cleanup_state (struct PRNG * state);
 static void	compute_next_random_block (int8u * buf, struct PRNG * state);
+static void	compute_random_blocks (int8u *		buf,
+				       int		nblocks,
+				       struct PRNG *	state);
 static void	convert_to_decimal (char *	buf,
 				    int64u	value,
 				    int		ndigits,
@@ -150,6 +159,7 @@ static int generate_points_array(struct PRNG_obj *obj,
                                  double *x, double *y,
                                  int npoints);
 static double	get_binary_double (const int8u * octets);
+static void	get_int128 (int64u * words, mpz_srcptr z);
 static int64u	get_decimal_number (struct DecBuf * dp);
 static int	hexdig (char c);
 static void	init_dbuf (struct DecBuf *	dp,
@@ -160,6 +170,7 @@ static void	my_mpz_set_hex (mpz_ptr dest, const char * hexval);
 static int64u	put_dec_digs (char * buf, int64u value, int ndigits);
 static bool	read_hex_octets (FILE * fp, int8u * octets, int n);
 static bool	read_state_from_stream (struct PRNG_obj * obj, FILE * fp);
+static void	set_int128 (mpz_ptr z, const int64u * words);
 static void	refill_decimal_buffer (struct DecBuf * dp);
 static void	write_hex_octets (FILE * fp, const int8u * octets, int n);
 static int	write_state_to_stream (struct PRNG_obj * obj, FILE * fp);
@@ -449,20 +460,26 @@ int		n,		/* IN: number of points to generate */
 FILE *		fp		/* IN/OUT: File to write into */
 )
 {
-int		i;
-int8u		buf [16];
+int		i, j, k;
+int8u		buf [16 * BLOCKS_PER_BATCH];
 double		x, y;
 
 	/* We get 128-bit words from our random stream, each of	*/
 	/* which gives us 2 64-bit mantissas, or one point!	*/
 
-	for (i = 0; i < n; i++) {
-		compute_next_random_block (buf, state);
+	for (i = 0; i < n; i += k) {
+		k = n - i;
+		if (k > BLOCKS_PER_BATCH) {
+			k = BLOCKS_PER_BATCH;
+		}
+		compute_random_blocks (buf, k, state);
 
-		x = get_binary_double (buf);
-		y = get_binary_double (buf + 8);
+		for (j = 0; j < k; j++) {
+			x = get_binary_double (&buf [16 * j]);
+			y = get_binary_double (&buf [16 * j + 8]);
 
-		fprintf (fp, "%.17g\t%.17g\n", x, y);
+			fprintf (fp, "%.17g\t%.17g\n", x, y);
+		}
 	}
 }
 
@@ -614,21 +631,27 @@ int		n,		/* IN: number of points to generate */
 double *	array		/* IN/OUT: Array to fill in */
 )
 {
-int		i;
-int8u		buf [16];
+int		i, j, k;
+int8u		buf [16 * BLOCKS_PER_BATCH];
 double		x, y;
 
 	/* We get 128-bit words from our random stream, each of	*/
 	/* which gives us 2 64-bit mantissas, or one point!	*/
 
-	for (i = 0; i < n; i++) {
-		compute_next_random_block (buf, state);
+	for (i = 0; i < n; i += k) {
+		k = n - i;
+		if (k > BLOCKS_PER_BATCH) {
+			k = BLOCKS_PER_BATCH;
+		}
+		compute_random_blocks (buf, k, state);
 
-		x = get_binary_double (buf);
-		y = get_binary_double (buf + 8);
+		for (j = 0; j < k; j++) {
+			x = get_binary_double (&buf [16 * j]);
+			y = get_binary_double (&buf [16 * j + 8]);
 
-		*array++	= x;
-		*array++	= y;
+			*array++	= x;
+			*array++	= y;
+		}
 	}
 }
 
@@ -945,32 +968,103 @@ int8u *		buf,		/* IN/OUT: buffer to write random bytes into */
 struct PRNG *	state		/* IN/OUT: PRNG state object */
 )
 {
-int		i, octet;
-mpz_t		q, r;
-int8u		temp [16];
+	compute_random_blocks (buf, 1, state);
+}
 
-	/* Compute temp[] = LC(n) XOR IV. */
-	mpz_init_set (q, state -> lc);
-	mpz_init (r);
-	for (i = 15; i >= 0; i--) {
-		octet = mpz_tdiv_qr_ui (q, r, q, 256);
-		temp [i] = octet ^ state -> iv [i];
-	}
-	mpz_clear (r);
-	mpz_clear (q);
+/*
+ * Compute the next nblocks blocks of 128 random bits, which are written
+ * into the given buffer of 16*nblocks octets.  Block n is the AES-256
+ * encryption of LC(n) XOR IV, where IV is the previous block.  The
+ * linear congruential generator is stepped in native 64-bit arithmetic,
+ * and the whole chain is encrypted in one call.
+ */
 
-	/* Encrypt temp[] in ECB mode. */
-	_gst_aes256_encrypt_ecb (&(state -> ctx), temp);
+	static
+	void
+compute_random_blocks (
 
-	memcpy (state -> iv, temp, 16);
-	memcpy (buf, temp, 16);
+int8u *		buf,		/* IN/OUT: buffer to write random bytes into */
+int		nblocks,	/* IN: number of blocks to compute */
+struct PRNG *	state		/* IN/OUT: PRNG state object */
+)
+{
+int		i, k;
+int64u		lc [2], b [2];
+int64u		w;
+int8u *		p;
+
+	get_int128 (lc, state -> lc);
+	get_int128 (b, state -> b);
+
+	/* Write LC(n), LC(n+1), ... big-endian into the buffer. */
+	p = buf;
+	for (k = 0; k < nblocks; k++) {
+		w = lc [1];
+		for (i = 7; i >= 0; i--) {
+			p [i] = w & 0xFF;
+			w >>= 8;
+		}
+		w = lc [0];
+		for (i = 15; i >= 8; i--) {
+			p [i] = w & 0xFF;
+			w >>= 8;
+		}
+		p += 16;
+
+		/* LC(n+1) = (LC(n) + B) mod 2**128 */
+		lc [0] += b [0];
+		lc [1] += b [1] + ((lc [0] < b [0]) ? 1 : 0);
+	}
+
+	/* Encrypt the buffer in CBC mode. */
+	_gst_aes256_encrypt_cbc (&(state -> ctx), state -> iv, buf, nblocks);
 
 	/* Update LC(n) state for next time. */
-	mpz_add (state -> lc, state -> lc, state -> b);
-	mpz_tdiv_r_2exp (state -> lc, state -> lc, 128);
-	mpz_add_ui (state -> n, state -> n, 1);
+	set_int128 (state -> lc, lc);
+	mpz_add_ui (state -> n, state -> n, nblocks);
 }
-
+
+/*
+ * Get the low-order 128 bits of the given integer as two 64-bit words,
+ * least significant first.
+ */
+
+	static
+	void
+get_int128 (
+
+int64u *	words,		/* OUT: the two words */
+mpz_srcptr	z		/* IN: integer to convert */
+)
+{
+mpz_t		t;
+
+	mpz_init (t);
+	mpz_tdiv_r_2exp (t, z, 64);
+	words [0] = mpz_get_ui (t);
+	mpz_tdiv_q_2exp (t, z, 64);
+	mpz_tdiv_r_2exp (t, t, 64);
+	words [1] = mpz_get_ui (t);
+	mpz_clear (t);
+}
+
+/*
+ * Set the given integer from two 64-bit words, least significant first.
+ */
+
+	static
+	void
+set_int128 (
+
+mpz_ptr		z,		/* OUT: integer to set */
+const int64u *	words		/* IN: the two words */
+)
+{
+	mpz_set_ui (z, words [1]);
+	mpz_mul_2exp (z, z, 64);
+	mpz_add_ui (z, z, words [0]);
+}
+
 /*
  * Write our PRNG state out to the given output stream.
  */
@@ -44,9 +44,12 @@
 ************************************************************************/
 
 #include "bb.h"
+#include "bitmap.h"
 #include "bsd.h"
 #include "bmst.h"
 #include "btsearch.h"
+#include "constrnt.h"
+#include "distkern.h"
 #include "dsuf.h"
 #include "emptyr.h"
 #include "emst.h"
@@ -66,6 +69,7 @@
 #include "rmst.h"
 #include "solver.h"
 #include "steiner.h"
+#include <stdlib.h>
 #include <string.h>
 
 /*
@@ -175,10 +179,18 @@ static void		init_upper_bound_params (struct pinfo *);
 static bool		passes_upper_bound_tests (struct pinfo *, struct bsd *, int, int,
 						  int *, struct pset *, bitmap_t *, int *, bitmap_t *);
 static void		process_bcc3 (struct bc3 *, int *, int *);
+static void		prune_budget_fsts (struct gst_hypergraph *,
+					   double,
+					   bool,
+					   int *,
+					   int *);
 static void		prune_fsts (struct gst_hypergraph *,
 				    struct bsd *,
 				    double,
-				    gst_param_ptr);
+				    gst_param_ptr,
+				    bool,
+				    double,
+				    bool);
 static bool		prune_this_fst (struct gst_hypergraph *,
 					struct pinfo *,
 					int);
@@ -226,6 +238,10 @@ struct point *		p1;
 struct point *		p2;
 int			i;
 int			j;
+char *			budget_env;
+bool			budget_mode;
+bool			supersets;
+double			budget;
 
 	GST_PRELUDE
 
@@ -261,7 +277,9 @@ int			j;
 	default_eps = (params -> eps_mult_factor) * DBL_EPSILON;
 	nedges = 0;
 	if (_gst_is_euclidean (H)) {
-		nedges	= _gst_euclidean_mst (H -> pts, mst_edges);
+		nedges	= _gst_parallel_euclidean_mst (H -> pts,
+						       params -> num_threads,
+						       mst_edges);
 	}
 	else if (_gst_is_rectilinear (H)) {
 		empty_rect = _gst_init_empty_rectangles (H -> pts, NULL);
@@ -308,8 +326,17 @@ int			j;
 		gst_channel_printf (timing, "Compute BSD:            %s\n", buf1);
 	}
 
+	/* In budget mode, the FSTs chosen may cost at most the budget	*/
+	/* in total, and need not span all terminals.			*/
+	/* Pruning FSTs dominated by a superset is only a heuristic	*/
+	/* there, and must be asked for.				*/
+	budget_env = getenv ("GEOSTEINER_BUDGET");
+	budget_mode = (budget_env NE NULL);
+	budget = budget_mode ? atof (budget_env) : 0.0;
+	supersets = (getenv ("GEOSTEINER_BUDGET_DOMINANCE") NE NULL);
+
 	/* Prune FSTs */
-	prune_fsts (H, BSD, default_eps, params);
+	prune_fsts (H, BSD, default_eps, params, budget_mode, budget, supersets);
 
 	if (timing NE NULL) {
 		_gst_convert_delta_cpu_time (buf1, &Tn);
@@ -335,7 +362,9 @@ int			j;
 			      _gst_cpu_time_t_to_double_seconds (Tn - T0));
 
 	/* Make sure that the final un-pruned FSTs span all terminals. */
-	check_for_invalid_fsts (H);
+	if (NOT budget_mode) {
+		check_for_invalid_fsts (H);
+	}
 
 	_gst_shutdown_bsd (BSD);
 	_gst_stop_using_lp_solver ();
@@ -352,6 +381,15 @@ int			j;
  * Main pruning procedure. We use a method proposed by Fossmeier and Kaufmann
  * based on thesing whether is advantageous to extend a given FST with a
  * terminal not currently spanned. If so, the FST is discarded.
+ *
+ * In budget mode, only prune_budget_fsts() is used.  The Fossmeier and
+ * Kaufmann test and the detection of required FSTs both assume that
+ * every terminal must be spanned.  The upper bound tests (and the
+ * incompatibilities derived from them) replace an FST by several
+ * smaller ones spanning the same terminals and compare only lengths.
+ * The budget objective charges the battery value of a terminal once
+ * for EACH chosen FST containing it, so the replacement can cost more
+ * than the FST it replaces, and none of these tests are valid there.
  */
 	static
 	void
@@ -360,7 +398,10 @@ prune_fsts (
 struct gst_hypergraph *	cip,		/* IN/OUT - compatibility info */
 struct bsd *		BSD,		/* IN	  - BSD data structure	*/
 double			default_eps,	/* IN	  - default epsilon value */
-gst_param_ptr		params		/* IN	  - parameters */
+gst_param_ptr		params,		/* IN	  - parameters */
+bool			budget_mode,	/* IN	  - budget mode? */
+double			budget,		/* IN	  - budget, if budget_mode */
+bool			supersets	/* IN	  - prune by superset dominance? */
 )
 {
 int			i, j, k, t, r1, r2;
@@ -370,6 +411,8 @@ int			pruned_total;
 int			required_total;
 int			old_pruned_total;
 int			scan;
+int			over_budget;
+int			dominated;
 int			nverts;
 int			kmasks;
 int			nedges;
@@ -448,10 +491,28 @@ gst_channel_ptr		timing;
 
 	_gst_startup_incompat_edges (&inc_info, cip);
 
+	if (budget_mode) {
+		prune_budget_fsts (cip, budget, supersets,
+				   &over_budget, &dominated);
+		if (timing) {
+			char buf [32];
+			_gst_convert_cpu_time (_gst_get_cpu_time (), buf);
+			gst_channel_printf (timing,
+				"- budget %g: %6d FSTs over budget, %6d FSTs dominated - %s\n",
+				budget, over_budget, dominated, buf);
+		}
+	}
+
 	/* Perform thorough upper bound test for every not-yet pruned FST */
 	pruned_total = 0;
 	for (i = 0; i < nedges; i++) {
 
+		if (budget_mode) {
+			if (NOT BITON (cip -> initial_edge_mask, i)) {
+				pruned_total++;
+			}
+			continue;
+		}
 		if (BITON (cip -> initial_edge_mask, i)) {
 			if (NOT passes_upper_bound_tests (&pinfo, BSD, i, -1,
 							  lvlist, ltlist, ltmask, lflist, lfmask)) {
@@ -472,12 +533,15 @@ gst_channel_ptr		timing;
 
 	min_pair = 0;
 	max_pair = INCOMPAT_STEP_SIZE;
-	compute_incompatibility_info (&pinfo,
-				      BSD,
-				      min_pair,
-				      max_pair,
-				      &changed,
-				      &all_pairs_tested);
+	all_pairs_tested = TRUE;
+	if (NOT budget_mode) {
+		compute_incompatibility_info (&pinfo,
+					      BSD,
+					      min_pair,
+					      max_pair,
+					      &changed,
+					      &all_pairs_tested);
+	}
 
 	/* Compute pruning information */
 	compute_pruning_info(cip, BSD, &pinfo);
@@ -502,12 +566,13 @@ gst_channel_ptr		timing;
 	required_total = 0;
 	scan = 1;
     for (;;) {
+	if (budget_mode) break;
+
 	for (; scan < nedges; scan++) {
 
 		old_pruned_total   = pruned_total;
-		for (i = 0; i < nedges; i++) {
-			if ((BITON (cip -> initial_edge_mask, i)) AND
-			   (NOT BITON (cip -> required_edges, i))) {
+		FOR_EACH_SETBIT (i, cip -> initial_edge_mask, nedges) {
+			if (NOT BITON (cip -> required_edges, i)) {
 
 				/* Get list of incompatible edges */
 				numinc = _gst_get_incompat_edges (inclist,
@@ -643,9 +708,8 @@ gst_channel_ptr		timing;
 		}
 
 		/* Remove FSTs making cycles among required FSTs */
-		for (i = 0; i < nedges; i++) {
-			if ((BITON (cip -> initial_edge_mask, i)) AND
-			    (NOT BITON (cip -> required_edges, i))) {
+		FOR_EACH_SETBIT (i, cip -> initial_edge_mask, nedges) {
+			if (NOT BITON (cip -> required_edges, i)) {
 
 				/* Check if a pair of vertices span the same component */
 				vp1 = cip -> edge [i];
@@ -759,6 +823,166 @@ gst_channel_ptr		timing;
 	free ((char *) pinfo.compat_mask);
 }
 
+/*
+ * Budget mode pruning.  The chosen FSTs may cost at most the budget in
+ * total, so an FST costing more than the budget can never be chosen.
+ * The cost is compared exactly as in the budget row of the LP.
+ *
+ * An FST i is also removed if another FST j spans the SAME terminals,
+ * costs no more, and has no larger objective coefficient (length plus
+ * BUDGET_BATTERY_WEIGHT times battery value, as in the LP).  Putting j
+ * in place of i in any solution leaves the terminals spanned, their
+ * connections and the uncovered terminals unchanged, so the result is
+ * still feasible and no worse.  Of several FSTs equal in all respects,
+ * only the first one is kept.
+ *
+ * If SUPERSETS is TRUE, FST j may also span a proper superset of the
+ * terminals of FST i.  This is only a heuristic:  if the solution
+ * already covers some of the extra terminals of j by other FSTs, then
+ * j cannot replace i without creating a cycle.  (If it does not, then
+ * j also saves BUDGET_UNCOVERED_PENALTY for each extra terminal, but
+ * we cannot count on that.)
+ *
+ * Dominance is only tested against FSTs that were not pruned before
+ * and are not over budget.  It is transitive, so every FST removed
+ * here is dominated by an FST that remains.
+ */
+
+	static
+	void
+prune_budget_fsts (
+
+struct gst_hypergraph *	cip,		/* IN/OUT - compatibility info */
+double			budget,		/* IN	  - budget */
+bool			supersets,	/* IN	  - prune by superset dominance? */
+int *			over_budget,	/* OUT	  - FSTs pruned for cost */
+int *			dominated	/* OUT	  - FSTs pruned as dominated */
+)
+{
+int			i;
+int			j;
+int			k;
+int			t;
+int			nverts;
+int			nedges;
+int			size;
+int			best;
+int			nmatch;
+int *			vp1;
+int *			vp2;
+int *			ep1;
+int *			ep2;
+int *			mark;
+double *		obj;
+bitmap_t *		fits;
+struct full_set *	fsp;
+
+	nverts = cip -> num_verts;
+	nedges = cip -> num_edges;
+
+	/* Objective coefficient of each FST, computed as in the LP. */
+	obj = NEWA (nedges, double);
+	for (i = 0; i < nedges; i++) {
+		obj [i] = 0.0;
+		fsp = (cip -> full_trees NE NULL) ? cip -> full_trees [i] : NULL;
+		if (fsp NE NULL) {
+			obj [i] = fsp -> battery_score;
+			if ((obj [i] EQ 0.0) AND (cip -> pts NE NULL)) {
+				vp1 = cip -> edge [i];
+				vp2 = cip -> edge [i + 1];
+				while (vp1 < vp2) {
+					k = *vp1++;
+					if ((k >= 0) AND (k < cip -> pts -> n)) {
+						obj [i] += cip -> pts -> a [k].battery;
+					}
+				}
+			}
+		}
+		obj [i] = ((double) (cip -> cost [i]))
+			  + BUDGET_BATTERY_WEIGHT * obj [i];
+	}
+
+	/* Remove the FSTs costing more than the budget.  FSTs that	*/
+	/* remain are candidates for dominating other FSTs.		*/
+	*over_budget = 0;
+	fits = NEWA (cip -> num_edge_masks, bitmap_t);
+	memset (fits, 0, cip -> num_edge_masks * sizeof (bitmap_t));
+	for (i = 0; i < nedges; i++) {
+		if ((int) (cip -> cost [i]) > (int) budget) {
+			if (BITON (cip -> initial_edge_mask, i)) {
+				CLRBIT (cip -> initial_edge_mask, i);
+				++(*over_budget);
+			}
+			continue;
+		}
+		if (BITON (cip -> initial_edge_mask, i)) {
+			SETBIT (fits, i);
+		}
+	}
+
+	/* Remove the dominated FSTs. */
+	*dominated = 0;
+	mark = NEWA (nverts, int);
+	for (t = 0; t < nverts; t++) {
+		mark [t] = -1;
+	}
+	FOR_EACH_SETBIT (i, cip -> initial_edge_mask, nedges) {
+
+		/* Any FST spanning all terminals of FST i is incident	*/
+		/* to each of them.  Use the one with fewest FSTs.	*/
+		best = -1;
+		vp1 = cip -> edge [i];
+		vp2 = cip -> edge [i + 1];
+		while (vp1 < vp2) {
+			t = *vp1++;
+			mark [t] = i;
+			if ((best < 0) OR
+			    (cip -> term_trees [t + 1] - cip -> term_trees [t] <
+			     cip -> term_trees [best + 1] - cip -> term_trees [best])) {
+				best = t;
+			}
+		}
+		size = cip -> edge_size [i];
+
+		ep1 = cip -> term_trees [best];
+		ep2 = cip -> term_trees [best + 1];
+		for (; ep1 < ep2; ep1++) {
+			j = *ep1;
+			if ((j EQ i) OR (NOT BITON (fits, j))) continue;
+			if (cip -> edge_size [j] < size) continue;
+			if ((cip -> edge_size [j] > size) AND
+			    (NOT supersets)) continue;
+			if (cip -> cost [j] > cip -> cost [i]) continue;
+			if (obj [j] > obj [i]) continue;
+			nmatch = 0;
+			vp1 = cip -> edge [j];
+			vp2 = cip -> edge [j + 1];
+			while (vp1 < vp2) {
+				if (mark [*vp1++] EQ i) {
+					++nmatch;
+				}
+			}
+			if (nmatch < size) continue;
+			if ((cip -> edge_size [j] EQ size) AND
+			    (cip -> cost [j] EQ cip -> cost [i]) AND
+			    (obj [j] EQ obj [i]) AND
+			    (j > i)) {
+				/* Same FST in all respects: keep the first. */
+				continue;
+			}
+			break;
+		}
+		if (ep1 < ep2) {
+			CLRBIT (cip -> initial_edge_mask, i);
+			++(*dominated);
+		}
+	}
+
+	free ((char *) mark);
+	free ((char *) fits);
+	free ((char *) obj);
+}
+
 /*
  * Create special parameters for the exact upper bound routine that
  * are used for small subsets.
@@ -856,21 +1080,23 @@ int *			ep2;
 	}
 	cip -> term_trees[ cip -> num_verts ] = ep;
 
-	/* Pack inc_edges array */
-	ep = cip -> inc_edges [0];
-	for (i = 0; i < cip -> num_edges; i++) {
-		if (ni[i] >= 0) {
-			ep1 = cip -> inc_edges [i];
-			ep2 = cip -> inc_edges [i + 1];
-			cip -> inc_edges [ ni[i] ] = ep;
-			while (ep1 < ep2) {
-				k = *(ep1++);
-				if (ni[k] >= 0)
-					*(ep++) = ni [k];
+	/* Pack inc_edges array (not built in budget mode) */
+	if (cip -> inc_edges NE NULL) {
+		ep = cip -> inc_edges [0];
+		for (i = 0; i < cip -> num_edges; i++) {
+			if (ni[i] >= 0) {
+				ep1 = cip -> inc_edges [i];
+				ep2 = cip -> inc_edges [i + 1];
+				cip -> inc_edges [ ni[i] ] = ep;
+				while (ep1 < ep2) {
+					k = *(ep1++);
+					if (ni[k] >= 0)
+						*(ep++) = ni [k];
+				}
 			}
 		}
+		cip -> inc_edges [ new_nedges ] = ep;
 	}
-	cip -> inc_edges [ new_nedges ] = ep;
 
 	/* Pack full_trees array */
 	if (cip -> full_trees NE NULL) {
@@ -1188,8 +1414,7 @@ gst_param_ptr		params;
 
 	*changed = FALSE;
 	*all_pairs_tested = TRUE;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		if (cip -> edge_size [i] >= max_pair) {
 			/* Must test this one later. */
 			*all_pairs_tested = FALSE;
@@ -1373,6 +1598,7 @@ int			i;
 int			j;
 int			k;
 int			t;
+int			m;
 int			total;
 int			steiner_index;
 int			nedges;
@@ -1380,6 +1606,7 @@ int			nverts;
 int			kmasks;
 int *			vp1;
 int *			vp2;
+int *			near;
 bitmap_t *		tmask;
 struct full_set *	fsp;
 int *			tlist;
@@ -1388,7 +1615,10 @@ struct clt_info*	cli;
 struct clt_info*	clip;
 struct point *		p1;
 struct point *		p2;
+coord_t *		xs;
+coord_t *		ys;
 dist_t			l;
+dist_t			r;
 gst_param_ptr		params;
 
 	params = pip -> params;
@@ -1465,6 +1695,15 @@ gst_param_ptr		params;
 	pip -> clt_count = NEWA (nedges, int);
 	cli = NEWA (nverts, struct clt_info);
 	memset (cli, 0, nverts * sizeof (cli [0]));
+
+	/* Terminal coordinates for the batched distance kernel. */
+	xs	= NEWA (nverts, coord_t);
+	ys	= NEWA (nverts, coord_t);
+	near	= NEWA (nverts, int);
+	for (t = 0; t < nverts; t++) {
+		xs [t] = cip -> pts -> a [t].x;
+		ys [t] = cip -> pts -> a [t].y;
+	}
 	if (params -> detailed_timings_channel) {
 		char buf [32];
 		_gst_convert_cpu_time (_gst_get_cpu_time (), buf);
@@ -1487,7 +1726,21 @@ gst_param_ptr		params;
 		   to close terminal data structure */
 		fsp = _gst_remove_degree_two_steiner_points (cip -> full_trees [i]);
 		clip = cli;
-		for (t = 0; t < nverts; t++) {
+
+		/* Only terminals passing the rough distance test of	*/
+		/* test_close_terminal() need to be looked at.  The	*/
+		/* slack allows for rounding in the squared distance.	*/
+		r = (fsp -> terminals -> n - 1)
+		    * pip -> pg_edges [pip -> num_pg_edges - 1].len
+		    * (1.0 + 1.0e-9);
+		m = _gst_within_dist (xs,
+				      ys,
+				      nverts,
+				      &(fsp -> terminals -> a [0]),
+				      r * r,
+				      near);
+		for (k = 0; k < m; k++) {
+			t = near [k];
 			if (NOT BITON (tmask, t)) {
 				test_close_terminal(pip, BSD, fsp, i, t, &clip);
 			}
@@ -1514,6 +1767,9 @@ gst_param_ptr		params;
 		}
 	}
 
+	free ((char *) near);
+	free ((char *) ys);
+	free ((char *) xs);
 	free ((char *) cli);
 	free ((char *) tmask);
 }
@@ -2105,8 +2361,7 @@ struct bc3		bc;
 
 	/* Traverse each connected component, identifying its BCC's as	*/
 	/* we go.							*/
-	for (i = 0; i < nverts; i++) {
-		if (NOT BITON (cip -> initial_vert_mask, i)) continue;
+	FOR_EACH_SETBIT (i, cip -> initial_vert_mask, nverts) {
 		if (bc.dfs [i] > 0) continue;
 
 		/* Traverse one connected component, finding	*/
@@ -54,6 +54,7 @@
 
 #include "bsd.h"
 #include "bmst.h"
+#include "config.h"
 #include "cputime.h"
 #include "emptyr.h"
 #include "fatal.h"
@@ -63,6 +64,7 @@
 #include "logic.h"
 #include <math.h>
 #include "memory.h"
+#include "parallel.h"
 #include "parmblk.h"
 #include "point.h"
 #include "prepostlude.h"
@@ -90,6 +92,10 @@ gst_hg_ptr gst_generate_rfsts (int,
 #define KAHNG_ROBINS_HEURISTIC	0
 #define DO_STATISTICS		0
 
+/* Number of chunks into which the roots are split when growing */
+/* RFSTs on several threads. */
+#define RFST_CHUNKS		64
+
 
 /*
  * Local Types
@@ -101,6 +107,34 @@ struct ibuf {
 	int		buf [1];
 };
 
+/*
+ * A contiguous range of the roots (direction * n + terminal) from
+ * which RFSTs are grown in parallel.  Each chunk detects duplicates
+ * only among its own RFSTs.  The chunks are merged into the global
+ * list in order afterwards, so the result does not depend upon the
+ * number of threads.
+ */
+
+struct rchunk {
+	int		first;		/* First root of the chunk */
+	int		last;		/* One past the last root */
+	struct rlist *	fsts;		/* RFSTs found, linked via forw */
+	int		fsts_checked;	/* Num FSTs sent to screening tests */
+};
+
+/*
+ * The state of one thread growing RFSTs.
+ */
+
+struct rthread {
+	struct rinfo	ri;		/* Private copy of the RFST info */
+	struct gst_param * params;	/* Parameters */
+	struct rchunk *	chunks;		/* All chunks */
+	int		nchunks;	/* Number of chunks */
+	int		first_chunk;	/* First chunk done by this thread */
+	int		chunk_step;	/* Distance to its next chunk */
+};
+
 
 /*
  * Local Routines
@@ -130,6 +164,17 @@ static bool		diamond_empty (struct rinfo *,
 				       struct point *,
 				       int,
 				       int);
+static void		discard_rfst (struct rlist *);
+static struct rlist **	find_rfst (struct rinfo *, int *, int, int *);
+static void		grow_from_root (struct rinfo *,
+					int,
+					int,
+					dist_t *,
+					struct gst_param *);
+static void		grow_rfst_chunks (void *);
+static void		grow_rfsts_parallel (struct rinfo *,
+					     int,
+					     struct gst_param *);
 static void		grow_RFST (struct rinfo *	rip,
 				   int			size,
 				   dist_t		length,
@@ -145,6 +190,7 @@ static int		lrindex_dir_3 (struct point *, struct point *);
 static void		renumber_terminals (struct rinfo *,
 					    struct pset *,
 					    int *);
+static void		save_rfst (struct rinfo *, struct rlist *);
 static dist_t		test_and_save_fst (struct rinfo *,
 					   int,
 					   dist_t,
@@ -425,6 +471,7 @@ dist_t			mst_len;
 double			ub_shortleg [2];
 char			buf1 [32];
 int			max_fst_size;
+int			nthreads;
 gst_channel_ptr		timing;
 
 	pts = rip -> pts;
@@ -454,8 +501,10 @@ gst_channel_ptr		timing;
 		gst_channel_printf (timing, "Compute UB0:            %s\n", buf1);
 	}
 
+	/* The octant neighbor graph has only O(N) edges, where the	*/
+	/* empty rectangle graph can have O(N**2) of them.		*/
 	mst_edges = NEWA (n - 1, struct edge);
-	nedges = _gst_rect_mst (pts, mst_edges, rip -> empty_rect);
+	nedges = _gst_rect_mst (pts, mst_edges, NULL);
 	FATAL_ERROR_IF (nedges NE n - 1);
 
 	mst_len = 0.0;
@@ -519,28 +568,25 @@ gst_channel_ptr		timing;
 	ub_shortleg [1] = INF_DISTANCE;
 	if (max_fst_size EQ 0) max_fst_size = n;
 
-	for (dir = 0; dir < 2; dir++) {
-		for (i = 0; i < n; i++) {
-			rip -> terms [0]	= i;
-			rip -> maxedges [i]	= 0.0;
-			/* Long leg candidate list is initially empty,	*/
-			/* add candidates on demand.			*/
-			rip -> longterms [0]	= i;
-			rip -> longterms [1]	= -1;
-			grow_RFST (rip,
-				   1,		/* size */
-				   0.0,		/* length */
-				   dir,
-				   0.0,		/* ub_length */
-				   ub_shortleg,
-				   0,		/* longindex */
-				   params);
+	nthreads = params -> num_threads;
+#ifndef HAVE_PTHREAD
+	nthreads = 1;
+#endif
+
+	if (nthreads > 1) {
+		grow_rfsts_parallel (rip, nthreads, params);
+	}
+	else {
+		for (dir = 0; dir < 2; dir++) {
+			for (i = 0; i < n; i++) {
+				grow_from_root (rip, dir, i, ub_shortleg, params);
 
 #if DO_STATISTICS
-			for (j = 0; longterms [j] >= 0; j++) {
-				++long_leg_count;
-			}
+				for (j = 0; longterms [j] >= 0; j++) {
+					++long_leg_count;
+				}
 #endif
+			}
 		}
 	}
 
@@ -602,6 +648,184 @@ gst_channel_ptr		timing;
 	memset (&(rip -> zt),	0, sizeof (rip -> zt));
 }
 
+/*
+ * Grow all RFSTs having the given root terminal and growth direction.
+ */
+
+	static
+	void
+grow_from_root (
+
+struct rinfo *		rip,		/* IN/OUT - RFST info */
+int			dir,		/* IN - growth direction from root */
+int			root,		/* IN - root terminal */
+dist_t *		ub_shortleg,	/* IN - initial short leg upper bounds */
+struct gst_param *	params		/* IN - parameters */
+)
+{
+	rip -> terms [0]	= root;
+	rip -> maxedges [root]	= 0.0;
+	/* Long leg candidate list is initially empty,	*/
+	/* add candidates on demand.			*/
+	rip -> longterms [0]	= root;
+	rip -> longterms [1]	= -1;
+	grow_RFST (rip,
+		   1,		/* size */
+		   0.0,		/* length */
+		   dir,
+		   0.0,		/* ub_length */
+		   ub_shortleg,
+		   0,		/* longindex */
+		   params);
+}
+
+/*
+ * Grow the RFSTs from all roots on several threads.  Growing from a
+ * root only reads the successor lists, upper bounds, short leg
+ * candidates and BSD data, so each thread just needs its own copy of
+ * the growth arrays and its own duplicate table.  The RFSTs found by
+ * each chunk of roots are then saved in the global list, in the same
+ * root order as a serial run.
+ */
+
+	static
+	void
+grow_rfsts_parallel (
+
+struct rinfo *		rip,		/* IN/OUT - global RFST info */
+int			nthreads,	/* IN - number of threads */
+struct gst_param *	params		/* IN - parameters */
+)
+{
+int			c, i, n, t;
+int			nroots, nchunks;
+struct rchunk *		chunks;
+struct rchunk *		ch;
+struct rthread *	threads;
+struct rthread *	tp;
+struct rinfo *		trip;
+struct rlist *		rp;
+struct rlist *		next;
+void **			targs;
+
+	n = rip -> pts -> n;
+	nroots = 2 * n;
+
+	nchunks = RFST_CHUNKS;
+	if (nchunks > nroots) {
+		nchunks = nroots;
+	}
+	if (nthreads > nchunks) {
+		nthreads = nchunks;
+	}
+
+	chunks = NEWA (nchunks, struct rchunk);
+	for (c = 0; c < nchunks; c++) {
+		ch = &chunks [c];
+		ch -> first		= (int) (((double) c * nroots) / nchunks);
+		ch -> last		= (int) (((double) (c + 1) * nroots) / nchunks);
+		ch -> fsts		= NULL;
+		ch -> fsts_checked	= 0;
+	}
+
+	threads = NEWA (nthreads, struct rthread);
+	targs	= NEWA (nthreads, void *);
+	for (t = 0; t < nthreads; t++) {
+		tp = &threads [t];
+		tp -> ri		= *rip;
+		tp -> params		= params;
+		tp -> chunks		= chunks;
+		tp -> nchunks		= nchunks;
+		tp -> first_chunk	= t;
+		tp -> chunk_step	= nthreads;
+
+		trip = &(tp -> ri);
+		trip -> terms		= NEWA (n, int);
+		trip -> longterms	= NEWA (n + 1, int);
+		trip -> maxedges	= NEWA (n, dist_t);
+		trip -> shortterm	= NEWA (n, int);
+		trip -> lrindex		= NEWA (n, int);
+		trip -> term_check	= NEWA (n, bool);
+		trip -> hash		= NEWA (n, struct rlist *);
+		for (i = 0; i < n; i++) {
+			trip -> lrindex [i] = 0;
+			trip -> term_check [i] = FALSE;
+		}
+		targs [t] = tp;
+	}
+
+	_gst_run_parallel (nthreads, grow_rfst_chunks, targs);
+
+	for (t = 0; t < nthreads; t++) {
+		trip = &(threads [t].ri);
+		free ((char *) (trip -> hash));
+		free ((char *) (trip -> term_check));
+		free ((char *) (trip -> lrindex));
+		free ((char *) (trip -> shortterm));
+		free ((char *) (trip -> maxedges));
+		free ((char *) (trip -> longterms));
+		free ((char *) (trip -> terms));
+	}
+	free ((char *) targs);
+	free ((char *) threads);
+
+	for (c = 0; c < nchunks; c++) {
+		ch = &chunks [c];
+		for (rp = ch -> fsts; rp NE NULL; rp = next) {
+			next = rp -> forw;
+			save_rfst (rip, rp);
+		}
+		rip -> fsts_checked += ch -> fsts_checked;
+	}
+	free ((char *) chunks);
+}
+
+/*
+ * Thread entry point: grow the RFSTs from the roots of every chunk
+ * assigned to this thread.
+ */
+
+	static
+	void
+grow_rfst_chunks (
+
+void *		arg		/* IN - struct rthread */
+)
+{
+int			c, i, n, r;
+struct rthread *	tp;
+struct rinfo *		rip;
+struct rchunk *		ch;
+dist_t			ub_shortleg [2];
+
+	tp	= (struct rthread *) arg;
+	rip	= &(tp -> ri);
+	n	= rip -> pts -> n;
+
+	ub_shortleg [0] = INF_DISTANCE;
+	ub_shortleg [1] = INF_DISTANCE;
+
+	for (c = tp -> first_chunk; c < tp -> nchunks; c += tp -> chunk_step) {
+		ch = &(tp -> chunks [c]);
+
+		for (i = 0; i < n; i++) {
+			rip -> hash [i] = NULL;
+		}
+		rip -> list.forw	= &(rip -> list);
+		rip -> list.back	= &(rip -> list);
+		rip -> fsts_checked	= 0;
+
+		for (r = ch -> first; r < ch -> last; r++) {
+			grow_from_root (rip, r / n, r % n, ub_shortleg, tp -> params);
+		}
+
+		/* Detach the list of RFSTs found by this chunk. */
+		rip -> list.back -> forw = NULL;
+		ch -> fsts		= rip -> list.forw;
+		ch -> fsts_checked	= rip -> fsts_checked;
+	}
+}
+
 /*
  * Sort the terminals by both X and Y coordinates, and then create the
  * successor lists.  These permit us to start from a random terminal and
@@ -1411,7 +1635,6 @@ int			nstein;
 int			nedges;
 int			last;
 int *			terms;
-int *			tlist;
 struct pset *		pts;
 struct point *		p1;
 struct point *		p2;
@@ -1569,39 +1792,9 @@ struct point		s2;
 	}
 #endif
 
-	/* General duplicate test.  We use a hash table, for speed.	*/
-	/* For correctness, the hash function must not depend upon the	*/
-	/* order of the terminals in the FST.  A simple checksum has	*/
-	/* this property and tends to avoid favoring any one bucket.	*/
-
-	/* Compute hash and prepare for rapid set comparison. */
-	k = 0;
-	for (i = 0; i < size; i++) {
-		j = terms [i];
-		rip -> term_check [j] = TRUE;
-		k += j;
-	}
-	k %= pts -> n;
-
-	hookp = &(rip -> hash [k]);
-	for (;;) {
-		rp = *hookp;
-		if (rp EQ NULL) break;
-		if (rp -> size EQ size) {
-			tlist = rp -> fst -> tlist;
-			for (i = 0; ; i++) {
-				if (i >= size) goto found_rfst;
-				if (NOT rip -> term_check [tlist [i]]) break;
-			}
-		}
-		hookp = &(rp -> next);
-	}
-
-found_rfst:
-
-	for (i = 0; i < size; i++) {
-		rip -> term_check [terms [i]] = FALSE;
-	}
+	/* General duplicate test. */
+	hookp = find_rfst (rip, terms, size, &k);
+	rp = *hookp;
 
 	if (rp NE NULL) {
 		/* An FST for these terminals already exists. */
@@ -1615,11 +1808,7 @@ found_rfst:
 		rp1 = rp -> back;
 		rp2 -> back = rp1;
 		rp1 -> forw = rp2;
-		free ((char *) (fsp -> terminals));
-		free ((char *) (fsp -> steiners));
-		free ((char *) (fsp -> edges));
-		free ((char *) fsp);
-		free ((char *) rp);
+		discard_rfst (rp);
 	}
 
 	/* Build FST graph in edge list form. */
@@ -1673,22 +1862,29 @@ found_rfst:
 		free (new_steiners);
 		new_steiners = NULL;
 	}
+	if (new_steiners NE NULL) {
+		for (i = 0; i < new_steiners -> n; i++) {
+			new_steiners -> a [i].battery = 0.0;  /* Steiner points have no battery */
+		}
+	}
 
 	fsp = NEW (struct full_set);
 
 	fsp -> next		= NULL;
 	fsp -> tree_num		= 0;
 	fsp -> tree_len		= length;
-	fsp->battery_score = 0.0;
-	for (i = 0; i < fsp->terminals->n; i++) {
-		int idx = fsp->tlist[i] - 1;
-		fsp->battery_score += pts->a[idx].battery;
-	}
 	fsp -> tlist		= new_tlist;
 	fsp -> terminals	= new_terms;
 	fsp -> steiners		= new_steiners;
 	fsp -> nedges		= nedges;
 	fsp -> edges		= edges;
+	/* Sum the battery levels of the terminals.  The terminal	*/
+	/* list holds 0-based indices into pts.			*/
+	fsp->battery_score = 0.0;
+	for (i = 0; i < fsp->terminals->n; i++) {
+		int idx = fsp->tlist[i];
+		fsp->battery_score += pts->a[idx].battery;
+	}
 
 	rp = NEW (struct rlist);
 
@@ -1707,6 +1903,136 @@ found_rfst:
 	return (length);
 }
 
+/*
+ * Find the RFST having the same set of terminals as the given list.
+ * Returns the hash chain link that points to it, or to NULL if there
+ * is no such RFST, and sets *hashp to the hash bucket of the list.
+ */
+
+	static
+	struct rlist **
+find_rfst (
+
+struct rinfo *	rip,		/* IN - The RFST info */
+int *		terms,		/* IN - terminals of RFST */
+int		size,		/* IN - number of terminals */
+int *		hashp		/* OUT - hash bucket */
+)
+{
+int			i, j, k;
+int *			tlist;
+struct rlist *		rp;
+struct rlist **		hookp;
+
+	/* We use a hash table, for speed.  For correctness, the hash	*/
+	/* function must not depend upon the order of the terminals in	*/
+	/* the FST.  A simple checksum has this property and tends to	*/
+	/* avoid favoring any one bucket.				*/
+
+	/* Compute hash and prepare for rapid set comparison. */
+	k = 0;
+	for (i = 0; i < size; i++) {
+		j = terms [i];
+		rip -> term_check [j] = TRUE;
+		k += j;
+	}
+	k %= rip -> pts -> n;
+
+	hookp = &(rip -> hash [k]);
+	for (;;) {
+		rp = *hookp;
+		if (rp EQ NULL) break;
+		if (rp -> size EQ size) {
+			tlist = rp -> fst -> tlist;
+			for (i = 0; ; i++) {
+				if (i >= size) goto found_rfst;
+				if (NOT rip -> term_check [tlist [i]]) break;
+			}
+		}
+		hookp = &(rp -> next);
+	}
+
+found_rfst:
+
+	for (i = 0; i < size; i++) {
+		rip -> term_check [terms [i]] = FALSE;
+	}
+
+	*hashp = k;
+
+	return (hookp);
+}
+
+/*
+ * Add an RFST grown by one of the parallel chunks to the global list,
+ * unless an RFST for the same terminals that is no longer is already
+ * there.
+ */
+
+	static
+	void
+save_rfst (
+
+struct rinfo *	rip,		/* IN/OUT - The global RFST info */
+struct rlist *	rp		/* IN - RFST to save */
+)
+{
+int			k;
+struct rlist *		old;
+struct rlist *		rp1;
+struct rlist *		rp2;
+struct rlist **		hookp;
+
+	hookp = find_rfst (rip, rp -> fst -> tlist, rp -> size, &k);
+	old = *hookp;
+
+	if (old NE NULL) {
+		if (old -> fst -> tree_len <= rp -> fst -> tree_len) {
+			discard_rfst (rp);
+			return;
+		}
+		/* The new one is shorter!  Delete the old one. */
+		*hookp = old -> next;
+		rp2 = old -> forw;
+		rp1 = old -> back;
+		rp2 -> back = rp1;
+		rp1 -> forw = rp2;
+		discard_rfst (old);
+	}
+
+	rp2 = &(rip -> list);
+	rp1 = rp2 -> back;
+	rp -> back	= rp1;
+	rp -> forw	= rp2;
+	rp -> next	= rip -> hash [k];
+
+	rp1 -> forw	= rp;
+	rp2 -> back	= rp;
+	rip -> hash [k] = rp;
+}
+
+/*
+ * Free an RFST that is not (or no longer) in the list.
+ */
+
+	static
+	void
+discard_rfst (
+
+struct rlist *	rp		/* IN - RFST to free */
+)
+{
+struct full_set *	fsp;
+
+	fsp = rp -> fst;
+	free ((char *) (fsp -> tlist));
+	free ((char *) (fsp -> terminals));
+	free ((char *) (fsp -> steiners));
+	free ((char *) (fsp -> edges));
+	free ((char *) fsp);
+	free ((char *) rp);
+}
+
 /*
  * Check that the diamond defined by two points is empty of terminals.
  */
@@ -40,11 +40,13 @@
 #include "dsuf.h"
 #include "emptyr.h"
 #include "fatal.h"
+#include <float.h>
 #include "logic.h"
 #include <math.h>
 #include "memory.h"
 #include "mst.h"
 #include "point.h"
+#include "sortfuncs.h"
 #include <stdlib.h>
 #include "steiner.h"
 #include <string.h>
@@ -67,15 +69,35 @@ dist_t		_gst_rect_mst_length (struct pset *);
 	/* none */
 
 
+/*
+ * Local Types
+ */
+
+struct octant_info {
+	coord_t *	x;		/* Transformed X coordinates */
+	coord_t *	y;		/* Transformed Y coordinates */
+	coord_t *	diff;		/* Y - X of each transformed point */
+};
+
+
 /*
  * Local Routines
  */
 
+static int		build_octant_edges (struct pset *,
+					    struct edge **,
+					    int);
 static int		build_rect_edges (struct pset *,
 					  struct edge **,
 					  int,
 					  bitmap_t *);
+static int		compare_diff (int, int, void *);
+static int		compare_xy (int, int, void *);
 static dist_t		kr_main (struct pset *, dist_t);
+static int		reduce_to_mst (struct edge *,
+				       int,
+				       int,
+				       struct dsuf *);
 
 /*
  * This routine computes the total length of the Minimum Spanning Tree
@@ -147,10 +169,12 @@ struct edge *	edge_array;
 }
 
 /*
- * This routine builds an edge-list containing all pairs of points.
+ * This routine builds an edge-list containing the edges from which the
+ * MST is computed.
  *
  * If non-NULL, the empty-rectangle info is used to greatly reduce
- * the number of edges produced.
+ * the number of edges produced.  Otherwise we use the (at most 4N)
+ * edges to the nearest neighbor of each point in each octant.
  */
 
 	static
@@ -176,8 +200,11 @@ struct point *	p2;
 	n = pts -> n;
 
 	if (empty_rect EQ NULL) {
-		/* Generate all N choose 2 edges. */
-		nedges = (n * (n - 1)) >> 1;
+		nedges = build_octant_edges (pts, edges_out, at_least);
+	}
+	else {
+		/* Generate a sparse set of edges. */
+		nedges = _gst_count_empty_rectangles (empty_rect, n);
 		nalloc = nedges;
 		if (nalloc < at_least) {
 			nalloc = at_least;
@@ -189,6 +216,8 @@ struct point *	p2;
 		for (i = 0; i < n; i++, p1++) {
 			p2 = (p1 + 1);
 			for (j = i + 1; j < n; j++, p2++) {
+				if (NOT _gst_is_empty_rectangle (empty_rect, i, j)) continue;
+
 				edges -> len	= RDIST (p1, p2);
 				edges -> p1	= i;
 				edges -> p2	= j;
@@ -196,33 +225,203 @@ struct point *	p2;
 			}
 		}
 	}
-	else {
-		/* Generate a sparse set of edges. */
-		nedges = _gst_count_empty_rectangles (empty_rect, n);
-		nalloc = nedges;
-		if (nalloc < at_least) {
-			nalloc = at_least;
-		}
-		edges = NEWA (nalloc, struct edge);
-		*edges_out = edges;
 
+	return (nedges);
+}
+
+/*
+ * Build the octant nearest neighbor edges of the given points.  Some
+ * rectilinear MST uses only these edges: if q and r are both in the
+ * same octant about p, and r is no farther from p than q, then r is
+ * no farther from q than p is.  We find, for every point, the nearest
+ * point in each of the four octants
+ *
+ *	0 <= dx <= dy,	0 <= dy <= dx,	0 <= -dy <= dx,	0 <= dx <= -dy
+ *
+ * (the other four are covered by the edges found from the other
+ * end).  Each octant is mapped onto the first by a transformation of
+ * the coordinates.  The nearest point q in that octant about p is the
+ * one having q.x >= p.x and q.y - q.x >= p.y - p.x that minimizes
+ * q.x + q.y.  We scan the points by decreasing X, keeping a binary
+ * indexed tree over Y - X to find this minimum in O(log N) time.
+ */
+
+	static
+	int
+build_octant_edges (
+
+struct pset *		pts,		/* IN - set of points */
+struct edge **		edges_out,	/* OUT - edge list */
+int			at_least	/* IN - allocate at least this many */
+					/*	edges */
+)
+{
+int			i;
+int			j;
+int			k;
+int			n;
+int			dir;
+int			pos;
+int			best;
+int			nranks;
+int			nedges;
+int			nalloc;
+int *			order;
+int *			rank;
+int *			bit_pt;
+coord_t *		bit_val;
+coord_t			sum;
+struct edge *		edges;
+struct point *		p1;
+struct octant_info	oi;
+
+	n = pts -> n;
+
+	nalloc = 4 * n;
+	if (nalloc < at_least) {
+		nalloc = at_least;
+	}
+	edges = NEWA (nalloc, struct edge);
+	*edges_out = edges;
+
+	oi.x	= NEWA (n, coord_t);
+	oi.y	= NEWA (n, coord_t);
+	oi.diff	= NEWA (n, coord_t);
+	rank	= NEWA (n, int);
+	bit_pt	= NEWA (n + 1, int);
+	bit_val	= NEWA (n + 1, coord_t);
+
+	nedges = 0;
+	for (dir = 0; dir < 4; dir++) {
 		p1 = &(pts -> a [0]);
 		for (i = 0; i < n; i++, p1++) {
-			p2 = (p1 + 1);
-			for (j = i + 1; j < n; j++, p2++) {
-				if (NOT _gst_is_empty_rectangle (empty_rect, i, j)) continue;
+			switch (dir) {
+			case 0:	oi.x [i] =  p1 -> x;	oi.y [i] =  p1 -> y;	break;
+			case 1:	oi.x [i] =  p1 -> y;	oi.y [i] =  p1 -> x;	break;
+			case 2:	oi.x [i] = -p1 -> y;	oi.y [i] =  p1 -> x;	break;
+			case 3:	oi.x [i] =  p1 -> x;	oi.y [i] = -p1 -> y;	break;
+			}
+			oi.diff [i] = oi.y [i] - oi.x [i];
+		}
 
-				edges -> len	= RDIST (p1, p2);
-				edges -> p1	= i;
-				edges -> p2	= j;
+		/* Rank the points by decreasing Y - X, so that the	*/
+		/* points above p's diagonal have smaller ranks.	*/
+		order = _gst_heapsort (n, &oi, compare_diff);
+		nranks = 0;
+		for (k = n - 1; k >= 0; k--) {
+			i = order [k];
+			if ((k < n - 1) AND
+			    (oi.diff [i] NE oi.diff [order [k + 1]])) {
+				++nranks;
+			}
+			rank [i] = nranks;
+		}
+		++nranks;
+		free ((char *) order);
+
+		for (j = 1; j <= nranks; j++) {
+			bit_val [j] = INF_DISTANCE;
+			bit_pt [j]  = -1;
+		}
+
+		/* Scan by decreasing X (then decreasing Y), so that	*/
+		/* every candidate has been inserted before p.		*/
+		order = _gst_heapsort (n, &oi, compare_xy);
+		for (k = n - 1; k >= 0; k--) {
+			i = order [k];
+			pos = rank [i] + 1;
+
+			/* Minimum of X + Y over ranks 1 through pos. */
+			best = -1;
+			sum  = INF_DISTANCE;
+			for (j = pos; j > 0; j -= (j & -j)) {
+				if (bit_val [j] < sum) {
+					sum  = bit_val [j];
+					best = bit_pt [j];
+				}
+			}
+			if (best >= 0) {
+				edges -> len	= RDIST (&(pts -> a [i]),
+							 &(pts -> a [best]));
+				if (i < best) {
+					edges -> p1	= i;
+					edges -> p2	= best;
+				}
+				else {
+					edges -> p1	= best;
+					edges -> p2	= i;
+				}
 				++edges;
+				++nedges;
+			}
+
+			sum = oi.x [i] + oi.y [i];
+			for (j = pos; j <= nranks; j += (j & -j)) {
+				if (sum < bit_val [j]) {
+					bit_val [j] = sum;
+					bit_pt [j]  = i;
+				}
 			}
 		}
+		free ((char *) order);
 	}
 
+	free ((char *) bit_val);
+	free ((char *) bit_pt);
+	free ((char *) rank);
+	free ((char *) oi.diff);
+	free ((char *) oi.y);
+	free ((char *) oi.x);
+
 	return (nedges);
 }
-
+
+/*
+ * Compare two points by transformed Y - X, then by index.
+ */
+
+	static
+	int
+compare_diff (
+
+int		i1,	/* IN - first index */
+int		i2,	/* IN - second index */
+void *		array	/* IN - the octant info */
+)
+{
+struct octant_info *	oip;
+
+	oip = (struct octant_info *) array;
+
+	if (oip -> diff [i1] < oip -> diff [i2]) return (-1);
+	if (oip -> diff [i1] > oip -> diff [i2]) return (1);
+	return ((i1 < i2) ? -1 : 1);
+}
+
+/*
+ * Compare two points by transformed X, then Y, then index.
+ */
+
+	static
+	int
+compare_xy (
+
+int		i1,	/* IN - first index */
+int		i2,	/* IN - second index */
+void *		array	/* IN - the octant info */
+)
+{
+struct octant_info *	oip;
+
+	oip = (struct octant_info *) array;
+
+	if (oip -> x [i1] < oip -> x [i2]) return (-1);
+	if (oip -> x [i1] > oip -> x [i2]) return (1);
+	if (oip -> y [i1] < oip -> y [i2]) return (-1);
+	if (oip -> y [i1] > oip -> y [i2]) return (1);
+	return ((i1 < i2) ? -1 : 1);
+}
+
 /*
  * This routine computes an approximate Steiner Minimal Tree using the
  * heuristic method of Kahng and Robins.
@@ -335,7 +534,6 @@ struct point *	p2;
 struct point *	p3;
 struct point *	newpt;
 struct edge *	ep;
-struct edge *	endp;
 struct edge *	ep1;
 struct edge *	ep2;
 struct edge *	endp1;
@@ -354,7 +552,12 @@ struct dsuf	sets;
 	nterms		= pts -> n;
 	kmasks		= BMAP_ELTS (nterms);
 	max_points	= nterms + nterms - 2;
-	max_edges	= max_points * (max_points - 1) / 2;
+
+	/* We only keep the edges of the current MST: an MST of the	*/
+	/* points plus one more is contained in the old MST plus the	*/
+	/* edges to the new point.  So the edge list never holds more	*/
+	/* than 2 * max_points edges.					*/
+	max_edges	= 2 * max_points;
 
 	new_edges	= NEWA (max_points, struct edge);
 	mark		= NEWA (nterms * kmasks, bitmap_t);
@@ -363,34 +566,17 @@ struct dsuf	sets;
 
 	_gst_sort_edge_list (&edge_array [0], nedges);
 
-	/* We know that build-edges gives us edges having vertices	*/
-	/* in the range of 0 through nterms - 1, so we don't have to	*/
-	/* do the sparse makeset's.  We use a union-find big enough to	*/
-	/* handle LOTS of added Steiner points!				*/
+	/* We use a union-find big enough to handle LOTS of added	*/
+	/* Steiner points!						*/
 
 	_gst_dsuf_create (&sets, max_points);
-	for (i = 0; i < nterms; i++) {
-		_gst_dsuf_makeset (&sets, i);
-	}
 
-	components = nterms;
-	ep = &edge_array [0];
-	endp = ep + nedges;
-	len = 0;
+	nedges = reduce_to_mst (edge_array, nedges, nterms, &sets);
 
-	while (components > 1) {
-		if (ep >= endp) {
-			/* Ran out of edges before MST built! */
-			FATAL_ERROR;
-		}
-		root1 = _gst_dsuf_find (&sets, ep -> p1);
-		root2 = _gst_dsuf_find (&sets, ep -> p2);
-		if (root1 NE root2) {
-			_gst_dsuf_unite (&sets, root1, root2);
-			len += ep -> len;
-			--components;
-		}
-		++ep;
+	len = 0;
+	ep = &edge_array [0];
+	for (i = 0; i < nedges; i++, ep++) {
+		len += ep -> len;
 	}
 	best = len;
 
@@ -530,6 +716,8 @@ struct dsuf	sets;
 		/* the set and try for another.			*/
 		++n;
 		++newpt;
+
+		nedges = reduce_to_mst (edge_array, nedges, n, &sets);
 	}
 
 	pts -> n = n;
@@ -542,3 +730,54 @@ struct dsuf	sets;
 
 	return (best);
 }
+
+/*
+ * Run Kruskal's algorithm on the given sorted list of edges spanning
+ * points 0 through npoints - 1, and keep only the edges of the MST
+ * (in sorted order) in the list.  Returns the number of MST edges.
+ */
+
+	static
+	int
+reduce_to_mst (
+
+struct edge *	edges,		/* IN/OUT - sorted edge list */
+int		nedges,		/* IN - number of edges */
+int		npoints,	/* IN - number of points */
+struct dsuf *	sets		/* IN - union-find to use */
+)
+{
+int		i;
+int		root1;
+int		root2;
+int		components;
+struct edge *	ep;
+struct edge *	endp;
+struct edge *	dst;
+
+	for (i = 0; i < npoints; i++) {
+		_gst_dsuf_makeset (sets, i);
+	}
+
+	components = npoints;
+	ep = &edges [0];
+	endp = ep + nedges;
+	dst = ep;
+
+	while (components > 1) {
+		if (ep >= endp) {
+			/* Ran out of edges before MST built! */
+			FATAL_ERROR;
+		}
+		root1 = _gst_dsuf_find (sets, ep -> p1);
+		root2 = _gst_dsuf_find (sets, ep -> p2);
+		if (root1 NE root2) {
+			_gst_dsuf_unite (sets, root1, root2);
+			*dst++ = *ep;
+			--components;
+		}
+		++ep;
+	}
+
+	return (dst - edges);
+}
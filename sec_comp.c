@@ -64,6 +64,7 @@
 #include "sec_comp.h"
 
 #include "bb.h"
+#include "bitmap.h"
 #include "constrnt.h"
 #include "dsuf.h"
 #include "fatal.h"
@@ -508,8 +509,7 @@ double *		B;
 	}
 	ip1 = NEWA (vcount, int);
 	k = 0;
-	for (i = 0; i < nverts; i++) {
-		if (NOT BITON (cvmask, i)) continue;
+	FOR_EACH_SETBIT (i, cvmask, nverts) {
 		/* This vertex was retained... */
 		new_vnum [i] = k;
 		newp -> tviol [k] = 0.0;
@@ -1253,8 +1253,7 @@ struct dsuf		sets;
 	/* Mark each valid vertex having exactly 2 incident edges. */
 	vmark = NEWA (nverts, bool);
 	memset (vmark, FALSE, nverts * sizeof (bool));
-	for (i = 0; i < nverts; i++) {
-		if (NOT BITON (comp -> vert_mask, i)) continue;
+	FOR_EACH_SETBIT (i, comp -> vert_mask, nverts) {
 		k = 0;
 		ep1 = comp -> vedges [i];
 		ep2 = comp -> vedges [i + 1];
@@ -1278,8 +1277,7 @@ struct dsuf		sets;
 	ep1 = elist;
 	vp1 = vlist;
 	num_real_edges = 0;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (comp -> edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, comp -> edge_mask, nedges) {
 		++num_real_edges;
 		if (comp -> x [i] < 1.0 - FUZZ) continue;
 		vp2 = comp -> everts [i];
@@ -1485,8 +1483,7 @@ struct dsuf		sets;
 		}
 	}
 	/* Renumber the vertices in each edge. */
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (comp -> edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, comp -> edge_mask, nedges) {
 		vp1 = comp -> everts [i];
 		vp2 = comp -> everts [i + 1];
 		while (vp1 < vp2) {
@@ -1599,8 +1596,7 @@ int *			rvlist;
 
 	/* Compute size of new edge-to-vertices list... */
 	k = 0;
-	for (i = 0; i < nedges; i++) {
-		if (NOT BITON (edge_mask, i)) continue;
+	FOR_EACH_SETBIT (i, edge_mask, nedges) {
 		ip1 = comp -> everts [i];
 		ip2 = comp -> everts [i + 1];
 		while (ip1 < ip2) {
@@ -2487,8 +2483,7 @@ bool			changed;
 	for (i = 0; i < nverts; i++) {
 		hindex [i] = -1;
 	}
-	for (i = 0; i < nverts; i++) {
-		if (NOT BITON (comp -> vert_mask, i)) continue;
+	FOR_EACH_SETBIT (i, comp -> vert_mask, nverts) {
 		heap [nheap] = i;
 		hindex [i] = nheap;
 		++nheap;
@@ -57,6 +57,7 @@
 #include "sec_heur.h"
 
 #include "bb.h"
+#include "bitmap.h"
 #include "constrnt.h"
 #include "expand.h"
 #include "fatal.h"
@@ -2222,7 +2223,6 @@ bitmap_t *		edge_mask;
 int *			vp1;
 int *			vp2;
 bitmap_t *		bp1;
-bitmap_t		mask;
 double			total;
 double			coeff;
 struct constraint *	cp;
@@ -2233,12 +2233,7 @@ struct constraint *	cp;
 	kmasks		= cip -> num_vert_masks;
 
 	/* Get size of subtour - 1... */
-	ssize = -1;
-	bp1 = stour;
-	for (i = 0; i < kmasks; i++) {
-		mask = *bp1++;
-		ssize += NBITSON (mask);
-	}
+	ssize = _gst_bitmap_count (stour, kmasks * BPW) - 1;
 
 	if (ssize <= 0) return (clist);
 
@@ -306,12 +306,10 @@ char **		merge_files;
 
 		_gst_begin_using_lp_solver ();
 
-		bbip -> lpmem = NEW (struct lpmem);
 		bbip -> lp = _gst_build_initial_formulation (bbip -> cpool,
 							     bbip -> vert_mask,
 							     bbip -> edge_mask,
 							     H,
-							     bbip -> lpmem,
 							     params);
 
 		bbip -> params = params;
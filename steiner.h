@@ -106,6 +106,13 @@ struct full_set {
 /*
  * The gst_hypergraph describes the basic problem instance, and also contains
  * some additional information (i.e., compatibility/incompatibility info).
+ *
+ * The edge, term_trees and inc_edges tables are stored in compressed
+ * sparse row form: all lists are kept in a single block of ints, in
+ * order, and each table has one pointer more than it has rows.  Thus
+ * the list for row i runs from tbl [i] up to (but not including)
+ * tbl [i + 1], and the whole table is freed by freeing tbl [0].  All
+ * code that builds these tables must preserve this layout.
  */
 
 struct gst_hypergraph {
@@ -41,6 +41,7 @@
 #include "ufst.h"
 
 #include "bsd.h"
+#include "config.h"
 #include "cputime.h"
 #include "efuncs.h"
 #include "fatal.h"
@@ -52,6 +53,7 @@
 #include "memory.h"
 #include "metric.h"
 #include "mst.h"
+#include "parallel.h"
 #include "parmblk.h"
 #include "prepostlude.h"
 #include "sortfuncs.h"
@@ -77,6 +79,10 @@ gst_hg_ptr	gst_generate_ufsts (int,
  * Local functions
  */
 
+struct ucand;
+struct uchunk;
+struct uthread;
+
 static void		add_zero_length_fsts (struct uinfo *, int, int **);
 static void		build_fst_list (struct uinfo *);
 static double		closest_terminal (struct hFST *,
@@ -90,14 +96,31 @@ static bool		edge_lune_test (struct uinfo *,
 					struct hFST *,
 					struct hFST *,
 					double, double);
+static void		extend_hfst (struct uthread *,
+				     struct hFST *,
+				     struct uchunk *);
+static void		generate_hfst_chunks (void *);
 static double		get_bsd (struct hFST *, struct hFST *, struct bsd *);
 static int		get_steiner_points (struct hFST *, struct point *, int *);
 static double		hfst_mst (struct uinfo *, struct hFST *, bool);
 static double		hfst_root_distance (struct uinfo *, struct hFST *, struct point *);
 static bool		identical_lists (const int *, const int *);
 static void		initialize_uinfo (struct uinfo *);
+static void		insert_hfst (struct uinfo *,
+				     struct hFST **,
+				     int,
+				     struct hFST *);
 static bool		is_disjoint (struct hFST *, struct hFST *);
+static void		merge_hfst_chunk (struct uinfo *,
+					  struct hFST **,
+					  int,
+					  struct uchunk *);
+static struct ucand *	new_ucand (struct uchunk *);
 static bool 		points_close (struct point *, struct point *, double);
+static void		record_fst (struct uchunk *,
+				    struct ucand **,
+				    struct hFST *,
+				    int);
 static void		renumber_terminals (struct uinfo *,
 					    struct pset *,
 					    int *);
@@ -149,7 +172,61 @@ struct time_it
 	int		temp_time;
 };
 
-static struct time_it *counters[NUM_OF_COUNTERS];
+/*
+ * Local Types
+ */
+
+/*
+ * An FST found while extending one root hFST, together with the new
+ * hFST (if any) that was created along with it.  New hFSTs can only be
+ * inserted into the list of their size (where hFSTs spanning the same
+ * terminals share the smallest upper bound), and the FST checked
+ * against that bound, once all earlier roots have been extended.  This
+ * is done when the chunks are merged, so that the result does not
+ * depend upon the number of threads.
+ */
+
+struct ucand {
+	struct hFST *	hfst;	/* New hFST (and its twin in ->next) */
+	struct hFST	fst;	/* FST to be saved */
+	int		save;	/* SAVE_NONE, SAVE_FST or SAVE_FST_IF_UB */
+};
+
+/*
+ * A contiguous range of roots extended by one thread.
+ */
+
+struct uchunk {
+	int		first;		/* First root of the chunk */
+	int		last;		/* One past the last root */
+	struct ucand *	cands;		/* Candidates found, in order */
+	int		ncands;		/* Number of candidates */
+	int		cands_size;	/* Allocated size of cands */
+};
+
+/*
+ * The state of one thread extending hFSTs of a given size.
+ */
+
+struct uthread {
+	struct uinfo	ui;		/* Private copy of the UFST info */
+	struct time_it *
+			counters [NUM_OF_COUNTERS];
+					/* Private statistics timers */
+	struct hFST **	roots;		/* Roots of the current size */
+	struct uchunk *	chunks;		/* All chunks of the current size */
+	int		nchunks;	/* Number of chunks */
+	int		first_chunk;	/* First chunk done by this thread */
+	int		chunk_step;	/* Distance to its next chunk */
+	int		size;		/* Size of the new hFSTs */
+	struct hFST **	hFST_Lists;	/* hFSTs of each size */
+	int *		meetAngles;	/* Valid meeting angles */
+	bool *		isLeftRight;	/* Left/right table */
+	struct hFST	hfstk;		/* Scratch hFST */
+	int		nroots;		/* Roots extended */
+	int		hFSTcount;	/* New hFSTs generated */
+	int		nfsts;		/* FSTs sent to be saved */
+};
 
 /*
  * Local Macros
@@ -161,11 +238,13 @@ static struct time_it *counters[NUM_OF_COUNTERS];
 #define SubpathTest	TRUE
 #define DoWedgeTest	TRUE
 
-#ifdef STATISTICS_ENABLED
-#define Verbose TRUE
-#else
-#define Verbose FALSE
-#endif
+/* What to do with the FST of a struct ucand. */
+#define SAVE_NONE	0
+#define SAVE_FST	1	/* Save the FST */
+#define SAVE_FST_IF_UB	2	/* Save it if not longer than its UB */
+
+/* Number of chunks into which the roots of each size are split. */
+#define UFST_CHUNKS	64
 
 /*
  * An octilinear FST generator...
@@ -395,34 +474,45 @@ struct uinfo *		uip,	/* IN - global UFST info */
 cpu_time_t *		Tn
 )
 {
-int			i, j, k, ti, tj;
+int			c, i, j, k, t;
 int			n;		/* Number of points */
 int			K;		/* 2 * lambda */
 int			lambda;
 int			size;		/* Size of (h)FST */
+int			isize;
 int			hFSTcount;	/* Number of generated hFSTs */
 int			max_fst_size;
 int			max_angle;
 int			min_angle;
-dist_t			eps_factor;
+int			nthreads;
+int			nrun;
+int			nroots;
+int			nchunks;
 int *			meetAngles;
 bool *			isLeftRight;
 char			buf1 [32];
-struct point		droot;
 struct point *		p;
-struct point		dp;
 struct pset *		pts;
-struct bsd *		BSD;
 struct hFST		hfstk;
-struct hFST *		tLeft;
-struct hFST *		tRight;
+struct hFST *		hfst;
 struct hFST *		last;
 struct hFST **		hFST_Lists;
+struct hFST **		roots;
+struct uchunk *		chunks;
+struct uchunk *		ch;
+struct uthread *	threads;
+struct uthread *	tp;
+struct time_it *	counters [NUM_OF_COUNTERS];
+void **			targs;
 gst_metric_ptr		metric;
 gst_param_ptr		params;
 gst_channel_ptr		timing;
 
-	if (Verbose) {
+	/* The statistics timers are kept whenever detailed timings	*/
+	/* are requested.  Each thread has its own set, which are	*/
+	/* summed into these once all sizes are done.			*/
+	timing = uip -> params -> detailed_timings_channel;
+	if (timing NE NULL) {
 		counters [NO_BENT_EDGE] = create_time_it("No bent edge");
 		counters [WEDGE]	= create_time_it("Wedge");
 		counters [GENERATOR]	= create_time_it("Generator");
@@ -443,23 +533,24 @@ gst_channel_ptr		timing;
 		counters [LENGTH]	= create_time_it("Length");
 		counters [REPLACE]	= create_time_it("Replaced");
 		counters [ADDNEW]	= create_time_it("Added");
-	}
 
-	if (Verbose) start_timer(counters[GENERATOR]);
+		start_timer (counters [GENERATOR]);
+		uip -> counters = counters;
+	}
+	else {
+		uip -> counters = NULL;
+	}
 
 	initialize_uinfo (uip);
 	hFSTcount = 0;
 
 	/* Initialize various commonly used variables */
 	params		= uip -> params;
-	timing		= params -> detailed_timings_channel;
 	metric		= uip -> metric;
 	K		= metric -> K;
 	lambda		= metric -> lambda;
 	max_angle	= metric -> max_angle;
 	min_angle	= metric -> min_angle;
-	eps_factor	= 1.0 + uip -> eps;
-	BSD	= uip -> bsd;
 	pts	= uip -> pts;
 	n	= pts -> n;
 
@@ -598,510 +689,859 @@ gst_channel_ptr		timing;
 	hfstk.terms	= NULL;
 	hfstk.ext	= -1;
 
+	/* Each thread gets its own copy of the UFST info, since the	*/
+	/* wedge test marks the terminals of the hFST it is testing in	*/
+	/* term_check.  Everything else it reads is shared.		*/
+
+	nthreads = params -> num_threads;
+#ifndef HAVE_PTHREAD
+	nthreads = 1;
+#endif
+
+	threads	= NEWA (nthreads, struct uthread);
+	targs	= NEWA (nthreads, void *);
+	for (t = 0; t < nthreads; t++) {
+		tp = &threads [t];
+		tp -> ui		= *uip;
+		tp -> ui.term_check	= NEWA (n, bool);
+		tp -> ui.counters	= NULL;
+		for (i = 0; i < n; i++) {
+			tp -> ui.term_check [i] = FALSE;
+		}
+		if (timing NE NULL) {
+			for (i = 0; i < NUM_OF_COUNTERS; i++) {
+				tp -> counters [i] = create_time_it (counters [i] -> name);
+			}
+			tp -> ui.counters = tp -> counters;
+		}
+		tp -> hFST_Lists	= hFST_Lists;
+		tp -> meetAngles	= meetAngles;
+		tp -> isLeftRight	= isLeftRight;
+		targs [t] = tp;
+	}
+
 	max_fst_size = params -> max_fst_size;
 	if (max_fst_size > n) max_fst_size = n;
 	for (size = 2; size <= max_fst_size; size++) {
-		int isize, jsize;
-		/* New terminal array size */
-		hfstk.terms = NEWA (size + 1, int);
-		hfstk.S	    = size;
-
-		if (Verbose) {
-			fprintf (stderr, "- starting hFST size %d (hFSTs: %d, FSTs: %d)\n",
-				size, hFSTcount, uip -> ntrees);
-		}
-
-		isize = (size-1)/2 + 1;
-		for ( ; isize < size; isize++) {
-			struct hFST *hfsti;
-			for (hfsti = hFST_Lists[isize]; hfsti; hfsti = hfsti -> next) {
-				struct hFST *hfstj;
-				bool degree4possible;
-				bool hfsti_changed = TRUE;
-				bool bsd_reusable = FALSE;
-				jsize = size - isize;
-
-				/* Setup special degree 4 flag */
-				/* This might not be entirely correct... */
-				degree4possible = ( (isize EQ 2)
-						AND (jsize EQ 2)
-						AND ((K EQ 4) OR (K EQ 8)));
-
-
-				for (hfstj = hFST_Lists[jsize]; hfstj; hfstj = hfstj -> next) {
-					int ii, jj;
-					int meetangle;
-					double dist_ik, dist_jk;
-					struct point *iRoot, *jRoot;
-					int extensions;
-					double cachedMST;
-					bool disjoint;
-
-					bool size_condition;
+		/* The roots are the hFSTs of sizes (size-1)/2 + 1 through	*/
+		/* size - 1, in the order in which they are extended.	*/
+		nroots = 0;
+		for (isize = (size-1)/2 + 1; isize < size; isize++) {
+			for (hfst = hFST_Lists[isize]; hfst; hfst = hfst -> next) {
+				++nroots;
+			}
+		}
+		roots = NEWA (nroots + 1, struct hFST *);
+		nroots = 0;
+		for (isize = (size-1)/2 + 1; isize < size; isize++) {
+			for (hfst = hFST_Lists[isize]; hfst; hfst = hfst -> next) {
+				roots [nroots++] = hfst;
+			}
+		}
+
+		nchunks = UFST_CHUNKS;
+		if (nchunks > nroots) {
+			nchunks = nroots;
+		}
+		nrun = nthreads;
+		if (nrun > nchunks) {
+			nrun = nchunks;
+		}
+
+		chunks = NEWA (nchunks + 1, struct uchunk);
+		for (c = 0; c < nchunks; c++) {
+			ch = &chunks [c];
+			ch -> first	 = (int) (((double) c * nroots) / nchunks);
+			ch -> last	 = (int) (((double) (c + 1) * nroots) / nchunks);
+			ch -> cands	 = NULL;
+			ch -> ncands	 = 0;
+			ch -> cands_size = 0;
+		}
+
+		for (t = 0; t < nrun; t++) {
+			tp = &threads [t];
+			tp -> roots		= roots;
+			tp -> chunks		= chunks;
+			tp -> nchunks		= nchunks;
+			tp -> first_chunk	= t;
+			tp -> chunk_step	= nrun;
+			tp -> size		= size;
+			tp -> hfstk		= hfstk;
+			tp -> hfstk.terms	= NEWA (size + 1, int);
+			tp -> hfstk.S		= size;
+			tp -> nroots		= 0;
+			tp -> hFSTcount		= 0;
+			tp -> nfsts		= 0;
+		}
+
+		_gst_run_parallel (nrun, generate_hfst_chunks, targs);
+
+		for (t = 0; t < nrun; t++) {
+			tp = &threads [t];
+			free (tp -> hfstk.terms);
+			hFSTcount += tp -> hFSTcount;
+		}
+
+		/* Insert the new hFSTs and save the FSTs in root order. */
+		for (c = 0; c < nchunks; c++) {
+			merge_hfst_chunk (uip, hFST_Lists, size, &chunks [c]);
+		}
+		free (chunks);
+		free (roots);
+
+		if (timing NE NULL) {
+			_gst_convert_delta_cpu_time (buf1, Tn);
+			gst_channel_printf (timing, "Size %3d generation:    %s\n", size, buf1);
+			if (nrun > 1) {
+				for (t = 0; t < nrun; t++) {
+					tp = &threads [t];
+					gst_channel_printf (timing,
+						"  Thread %2d: %d roots, %d hFSTs, %d FSTs\n",
+						t, tp -> nroots, tp -> hFSTcount, tp -> nfsts);
+				}
+			}
+		}
+	}
+
+	for (t = 0; t < nthreads; t++) {
+		tp = &threads [t];
+		if (timing NE NULL) {
+			for (i = 0; i < NUM_OF_COUNTERS; i++) {
+				counters [i] -> elapsed_time	+= tp -> counters [i] -> elapsed_time;
+				counters [i] -> queries		+= tp -> counters [i] -> queries;
+				counters [i] -> pruned		+= tp -> counters [i] -> pruned;
+				free (tp -> counters [i]);
+			}
+		}
+		free (tp -> ui.term_check);
+	}
+	free (targs);
+	free (threads);
+
+	free (isLeftRight);
+	free (meetAngles);
+
+	if (timing NE NULL) {
+		int genTime;
+		int iterations = counters[SUBPATH] -> queries;
+		struct time_it * cp;
+		stop_timer (counters[GENERATOR], FALSE);
+		genTime = counters[GENERATOR] -> elapsed_time;
+
+		gst_channel_printf (timing, "FST-count: %d, hFSTCount: %d\n",
+			uip -> ntrees, hFSTcount);
+
+		/* Floating point traps are enabled here, so counters	*/
+		/* that were never queried must not be divided by.	*/
+		gst_channel_printf (timing, "\n              Queries          Pruned                Left               Time\n");
+		for (i=0; i<NUM_OF_COUNTERS; i++) {
+			cp = counters[i];
+			gst_channel_printf (timing, "%-12s: %8d - %8d (%6.2f%%) = %8d (%6.2f%%),\t%3d (%6.2f%%)\n",
+			 cp -> name,
+			 cp -> queries,
+			 cp -> pruned,
+			 (cp -> queries > 0)
+			  ? 100.0 * cp -> pruned / cp -> queries : 0.0,
+			 cp -> queries - cp -> pruned,
+			 (iterations > 0)
+			  ? 100.0 * (cp -> queries - cp -> pruned) / iterations
+			  : 0.0,
+			 cp -> elapsed_time,
+			 (genTime > 0)
+			  ? 100.0 * cp -> elapsed_time / genTime : 0.0);
+
+			free (cp);
+		}
+		gst_channel_printf (timing, "\n");
+	}
+	uip -> counters = NULL;
+
+	uip -> hFSTCount = hFSTcount;
+
+	for (i = 0; i <= n; i++) {
+		if (hFST_Lists[i]) {
+			struct hFST *hfst = hFST_Lists[i];
+			while (hfst) {
+				struct hFST *tmp = hfst -> next;
+				free (hfst -> terms);
+				free (hfst);
+				hfst = tmp;
+			}
+		}
+	}
+	free (hFST_Lists);
+
+	/* Translate terminals back */
+	for (k = 0; k < n; k++) {
+		pts -> a[k] = uip -> pts_org -> a[k];
+	}
+	free (uip -> pts_org);
+
+	destroy_uinfo (uip);
+}
+
+/*
+ * Thread entry point: extend the roots of every chunk assigned to
+ * this thread.
+ */
+
+	static
+	void
+generate_hfst_chunks (
+
+void *		arg		/* IN - struct uthread */
+)
+{
+int			c, r;
+struct uthread *	tp;
+struct uchunk *		ch;
+
+	tp = (struct uthread *) arg;
+
+	for (c = tp -> first_chunk; c < tp -> nchunks; c += tp -> chunk_step) {
+		ch = &(tp -> chunks [c]);
+		for (r = ch -> first; r < ch -> last; r++) {
+			extend_hfst (tp, tp -> roots [r], ch);
+			++(tp -> nroots);
+		}
+	}
+}
+
+/*
+ * Combine the given root hFST with every smaller hFST that completes
+ * it to the current size.  New hFSTs and FSTs are recorded in the
+ * chunk, in the order found.  Only hFSTs smaller than the current
+ * size are read, so roots can be extended in any order.
+ */
+
+	static
+	void
+extend_hfst (
+
+struct uthread *	tp,	/* IN/OUT - thread state */
+struct hFST *		hfsti,	/* IN - root hFST to extend */
+struct uchunk *		ch	/* IN/OUT - chunk receiving the results */
+)
+{
+int			isize;
+int			jsize;
+int			ti, tj;
+int			K;		/* 2 * lambda */
+int			lambda;
+int			size;		/* Size of (h)FST */
+int			max_angle;
+bool			degree4possible;
+bool			hfsti_changed;
+bool			bsd_reusable;
+dist_t			eps_factor;
+int *			meetAngles;
+bool *			isLeftRight;
+struct point		droot;
+struct point		dp;
+struct pset *		pts;
+struct bsd *		BSD;
+struct hFST		hfstk;
+struct hFST *		hfstj;
+struct hFST *		tLeft;
+struct hFST *		tRight;
+struct hFST **		hFST_Lists;
+struct ucand *		cp;
+struct uinfo *		uip;
+gst_metric_ptr		metric;
+
+	uip		= &(tp -> ui);
+	metric		= uip -> metric;
+	K		= metric -> K;
+	lambda		= metric -> lambda;
+	max_angle	= metric -> max_angle;
+	eps_factor	= 1.0 + uip -> eps;
+	BSD		= uip -> bsd;
+	pts		= uip -> pts;
+	size		= tp -> size;
+	meetAngles	= tp -> meetAngles;
+	isLeftRight	= tp -> isLeftRight;
+	hFST_Lists	= tp -> hFST_Lists;
+	hfstk		= tp -> hfstk;
+
+	hfsti_changed	= TRUE;
+	bsd_reusable	= FALSE;
+
+	isize = hfsti -> S;
+	jsize = size - isize;
+
+	/* Setup special degree 4 flag */
+	/* This might not be entirely correct... */
+	degree4possible = ( (isize EQ 2)
+			AND (jsize EQ 2)
+			AND ((K EQ 4) OR (K EQ 8)));
+
+
+	for (hfstj = hFST_Lists[jsize]; hfstj; hfstj = hfstj -> next) {
+		int ii, jj;
+		int meetangle;
+		double dist_ik, dist_jk;
+		struct point *iRoot, *jRoot;
+		int extensions;
+		double cachedMST;
+		bool disjoint;
+
+		bool size_condition;
+
+		cp = NULL;
 #if 1
-					size_condition = TRUE;
+		size_condition = TRUE;
 #else
-					size_condition = (jsize EQ isize);
+		size_condition = (jsize EQ isize);
 #endif
-					if (size_condition AND (hfsti EQ hfstj)) {
-						break;
-					}
+		if (size_condition AND (hfsti EQ hfstj)) {
+			break;
+		}
 
-					if (bsd_reusable AND (NOT hfstj -> prev_identical)) {
-						bsd_reusable = FALSE;
-					}
+		if (bsd_reusable AND (NOT hfstj -> prev_identical)) {
+			bsd_reusable = FALSE;
+		}
 
-					/* This test works for any lambda-value:
-					   The subtree which does not contain the lowest
-					   index can be pruned if it is in a mixed state. */
-					if (SubpathTest) {
-						if (Verbose) start_timer(counters[SUBPATH]);
-						if (*hfsti -> terms < *hfstj -> terms) {
-							if (hfstj -> status EQ STATE_MIXED) {
-								if (Verbose) stop_timer (counters[SUBPATH], TRUE);
-								continue;
-							}
-						}
-						else {
-							if (hfsti -> status EQ STATE_MIXED) {
-								if (Verbose) stop_timer (counters[SUBPATH], TRUE);
-								continue;
-							}
-						}
-						if (Verbose) stop_timer (counters[SUBPATH], FALSE);
-					}
+		/* This test works for any lambda-value:
+		   The subtree which does not contain the lowest
+		   index can be pruned if it is in a mixed state. */
+		if (SubpathTest) {
+			if (uip -> counters NE NULL) start_timer (uip -> counters[SUBPATH]);
+			if (*hfsti -> terms < *hfstj -> terms) {
+				if (hfstj -> status EQ STATE_MIXED) {
+					if (uip -> counters NE NULL) stop_timer (uip -> counters[SUBPATH], TRUE);
+					continue;
+				}
+			}
+			else {
+				if (hfsti -> status EQ STATE_MIXED) {
+					if (uip -> counters NE NULL) stop_timer (uip -> counters[SUBPATH], TRUE);
+					continue;
+				}
+			}
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[SUBPATH], FALSE);
+		}
 
-					/* Check that the hFSTs are terminal disjoint */
-					disjoint = TRUE;
-					if (Verbose) start_timer(counters[DISJOINT]);
-					if (size EQ 2) { /* Two terminals */
-						if (hfsti -> index EQ hfstj -> index) {
-							disjoint = FALSE;
-						}
-					}
-					else {
-						if (NOT is_disjoint(hfsti, hfstj)) {
-							disjoint = FALSE;
-						}
-					}
+		/* Check that the hFSTs are terminal disjoint */
+		disjoint = TRUE;
+		if (uip -> counters NE NULL) start_timer (uip -> counters[DISJOINT]);
+		if (size EQ 2) { /* Two terminals */
+			if (hfsti -> index EQ hfstj -> index) {
+				disjoint = FALSE;
+			}
+		}
+		else {
+			if (NOT is_disjoint(hfsti, hfstj)) {
+				disjoint = FALSE;
+			}
+		}
 
-					if (disjoint) {
-						if (Verbose) stop_timer (counters[DISJOINT], FALSE);
-					}
-					else {
-						/* Skip identical hFSTs - regarding terminals */
-						while (hfstj -> next AND hfstj -> next -> prev_identical) {
-							hfstj = hfstj -> next;
-							if (hfsti EQ hfstj) {
-								break;
-							}
-						}
-						if (Verbose) stop_timer (counters[DISJOINT], TRUE);
-						continue;
-					}
+		if (disjoint) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[DISJOINT], FALSE);
+		}
+		else {
+			/* Skip identical hFSTs - regarding terminals */
+			while (hfstj -> next AND hfstj -> next -> prev_identical) {
+				hfstj = hfstj -> next;
+				if (hfsti EQ hfstj) {
+					break;
+				}
+			}
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[DISJOINT], TRUE);
+			continue;
+		}
 
-					/* Check that meeting angle is valid
-					   (might be a bending point on a non-straight edge!) */
-
-					ii = hfsti -> ext;
-					jj = hfstj -> ext;
-					iRoot = &hfsti -> root;
-					jRoot = &hfstj -> root;
-
-					/* Is it a legal angle? (This test could be better if
-					   it also considered the direction of the rays). */
-					if (Verbose) start_timer(counters[ANGLE]);
-					meetangle = meetAngles[ii*K + jj];
-					if (NOT meetangle) {
-						/* Illegal unless it is a degree 4
-						   Steiner point, not parallel and
-						   with (almost) identical Root
-						   points */
-						if (   degree4possible
-						   AND ((ii - jj) % lambda EQ 0)
-						   AND (points_close(iRoot, jRoot, uip -> eps)) ) {
-							/* Save it as an FST */
-							hfstk.length	 = hfsti -> length + hfstj -> length;
-							hfstk.left_tree	 = hfsti;
-							hfstk.right_tree = hfstj;
-							hfstk.type	 = TYPE_CROSS;
-							hfstk.root       = *iRoot;
-							update_terms(&hfstk); /* Update array of terminals. */
-							test_and_save_fst (uip, &hfstk);
-							continue;
-						}
-						else {
-							if (Verbose) stop_timer (counters[ANGLE], TRUE);
-							continue;
-						}
-					}
-					if (Verbose) stop_timer (counters[ANGLE], FALSE);
-
-					/* Roots should not be equal (but be careful with MST edges!) */
-					if (Verbose) start_timer(counters[INTERSECT]);
-					if ( (points_close(iRoot, jRoot, uip -> eps)) AND
-					     (NOT ((hfstk.S EQ 2) AND 
-						   (_gst_is_mst_edge(BSD, hfsti->index, hfstj->index)))) ) {
-						if (Verbose) stop_timer (counters[INTERSECT], TRUE);
-						continue;
-					}
+		/* Check that meeting angle is valid
+		   (might be a bending point on a non-straight edge!) */
+
+		ii = hfsti -> ext;
+		jj = hfstj -> ext;
+		iRoot = &hfsti -> root;
+		jRoot = &hfstj -> root;
+
+		/* Is it a legal angle? (This test could be better if
+		   it also considered the direction of the rays). */
+		if (uip -> counters NE NULL) start_timer (uip -> counters[ANGLE]);
+		meetangle = meetAngles[ii*K + jj];
+		if (NOT meetangle) {
+			/* Illegal unless it is a degree 4
+			   Steiner point, not parallel and
+			   with (almost) identical Root
+			   points */
+			if (   degree4possible
+			   AND ((ii - jj) % lambda EQ 0)
+			   AND (points_close(iRoot, jRoot, uip -> eps)) ) {
+				/* Save it as an FST */
+				hfstk.length	 = hfsti -> length + hfstj -> length;
+				hfstk.left_tree	 = hfsti;
+				hfstk.right_tree = hfstj;
+				hfstk.type	 = TYPE_CROSS;
+				hfstk.root       = *iRoot;
+				update_terms(&hfstk); /* Update array of terminals. */
+				record_fst (ch, &cp, &hfstk, SAVE_FST);
+				++(tp -> nfsts);
+				continue;
+			}
+			else {
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[ANGLE], TRUE);
+				continue;
+			}
+		}
+		if (uip -> counters NE NULL) stop_timer (uip -> counters[ANGLE], FALSE);
+
+		/* Roots should not be equal (but be careful with MST edges!) */
+		if (uip -> counters NE NULL) start_timer (uip -> counters[INTERSECT]);
+		if ( (points_close(iRoot, jRoot, uip -> eps)) AND
+		     (NOT ((hfstk.S EQ 2) AND 
+			   (_gst_is_mst_edge(BSD, hfsti->index, hfstj->index)))) ) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[INTERSECT], TRUE);
+			continue;
+		}
 
-					/* Compute root of combined hFST */
-					/* We do it carefully using displacements */
+		/* Compute root of combined hFST */
+		/* We do it carefully using displacements */
 
-					ti = hfsti -> origin_term;
-					tj = hfstj -> origin_term;
+		ti = hfsti -> origin_term;
+		tj = hfstj -> origin_term;
 
-					dp.x = pts -> a[tj].x - pts -> a[ti].x;
-					dp.y = pts -> a[tj].y - pts -> a[ti].y;
+		dp.x = pts -> a[tj].x - pts -> a[ti].x;
+		dp.y = pts -> a[tj].y - pts -> a[ti].y;
 
-					/* Add displacements */
-					dp.x -= hfsti -> droot.x;
-					dp.y -= hfsti -> droot.y;
-					dp.x += hfstj -> droot.x;
-					dp.y += hfstj -> droot.y;
+		/* Add displacements */
+		dp.x -= hfsti -> droot.x;
+		dp.y -= hfsti -> droot.y;
+		dp.x += hfstj -> droot.x;
+		dp.y += hfstj -> droot.y;
 
-					/* Compute intersection */
-					if (NOT _gst_ray_intersection(&metric -> dirs[ii],
-								      &dp,
-								      &metric -> dirs[jj],
-								      uip -> eps, &droot)) {
-						if (Verbose) stop_timer (counters[INTERSECT], TRUE);
-						continue;
-					}
+		/* Compute intersection */
+		if (NOT _gst_ray_intersection(&metric -> dirs[ii],
+					      &dp,
+					      &metric -> dirs[jj],
+					      uip -> eps, &droot)) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[INTERSECT], TRUE);
+			continue;
+		}
 
-					hfstk.droot.x = hfsti -> droot.x + droot.x; 
-					hfstk.droot.y = hfsti -> droot.y + droot.y; 
-					hfstk.origin_term = hfsti -> origin_term;
+		hfstk.droot.x = hfsti -> droot.x + droot.x; 
+		hfstk.droot.y = hfsti -> droot.y + droot.y; 
+		hfstk.origin_term = hfsti -> origin_term;
 
-					/* Move new root to final position */
-					hfstk.root.x = pts -> a[ hfstk.origin_term ].x +
-						       hfstk.droot.x;
-					hfstk.root.y = pts -> a[ hfstk.origin_term ].y +
-						       hfstk.droot.y;
-					if (Verbose) stop_timer (counters[INTERSECT], FALSE);
+		/* Move new root to final position */
+		hfstk.root.x = pts -> a[ hfstk.origin_term ].x +
+			       hfstk.droot.x;
+		hfstk.root.y = pts -> a[ hfstk.origin_term ].y +
+			       hfstk.droot.y;
+		if (uip -> counters NE NULL) stop_timer (uip -> counters[INTERSECT], FALSE);
 
-					/* Bottleneck Steiner distances */
+		/* Bottleneck Steiner distances */
 
-					if (Verbose) start_timer(counters[BSDTEST]);
-					if ((NOT bsd_reusable) OR (hfsti_changed)) {
-						hfstk.BS = get_bsd(hfsti, hfstj, BSD);
-						hfsti_changed = FALSE;
-						bsd_reusable = TRUE;
-					}
-					hfstk.UB = hfsti->UB + hfstj->UB + hfstk.BS;
+		if (uip -> counters NE NULL) start_timer (uip -> counters[BSDTEST]);
+		if ((NOT bsd_reusable) OR (hfsti_changed)) {
+			hfstk.BS = get_bsd(hfsti, hfstj, BSD);
+			hfsti_changed = FALSE;
+			bsd_reusable = TRUE;
+		}
+		hfstk.UB = hfsti->UB + hfstj->UB + hfstk.BS;
 
-					dist_ik = sqrt(droot.x * droot.x + droot.y * droot.y);
-					if (dist_ik > eps_factor * hfstk.BS) {
-						if (Verbose) stop_timer (counters[BSDTEST], TRUE);
-						continue;
-					}
+		dist_ik = sqrt(droot.x * droot.x + droot.y * droot.y);
+		if (dist_ik > eps_factor * hfstk.BS) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[BSDTEST], TRUE);
+			continue;
+		}
 
-					dist_jk = sqrt(sqr_dist(&droot, &dp));
-					if (dist_jk > eps_factor * hfstk.BS) {
-						if (Verbose) stop_timer (counters[BSDTEST], TRUE);
-						continue;
-					}
-					if (Verbose) stop_timer (counters[BSDTEST], FALSE);
+		dist_jk = sqrt(sqr_dist(&droot, &dp));
+		if (dist_jk > eps_factor * hfstk.BS) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[BSDTEST], TRUE);
+			continue;
+		}
+		if (uip -> counters NE NULL) stop_timer (uip -> counters[BSDTEST], FALSE);
+
+		/* Edge Lune Test */
+		if (uip -> counters NE NULL) start_timer (uip -> counters[LUNE]);
+		if (NOT edge_lune_test(uip, hfsti, hfstj, &hfstk,
+				       dist_ik, dist_jk)) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[LUNE], TRUE);
+			continue;
+		}
+		if (uip -> counters NE NULL) stop_timer (uip -> counters[LUNE], FALSE);
 
-					/* Edge Lune Test */
-					if (Verbose) start_timer(counters[LUNE]);
-					if (NOT edge_lune_test(uip, hfsti, hfstj, &hfstk,
-							       dist_ik, dist_jk)) {
-						if (Verbose) stop_timer (counters[LUNE], TRUE);
-						continue;
-					}
-					if (Verbose) stop_timer (counters[LUNE], FALSE);
+		/* Figure out what is left and what is right */
+		if (isLeftRight[ii*K+jj]) {
+			tLeft = hfsti; tRight = hfstj;
+		}
+		else {
+			tLeft = hfstj; tRight = hfsti;
+		}
 
-					/* Figure out what is left and what is right */
-					if (isLeftRight[ii*K+jj]) {
-						tLeft = hfsti; tRight = hfstj;
-					}
-					else {
-						tLeft = hfstj; tRight = hfsti;
-					}
+		hfstk.left_tree		= tLeft;
+		hfstk.right_tree	= tRight;
+		hfstk.ext_left		= tLeft -> ext;
+		hfstk.ext_right		= tRight -> ext;
 
-					hfstk.left_tree		= tLeft;
-					hfstk.right_tree	= tRight;
-					hfstk.ext_left		= tLeft -> ext;
-					hfstk.ext_right		= tRight -> ext;
+		update_terms(&hfstk); /* Update array of terminals. */
+		hfstk.length = hfsti -> length + hfstj -> length + dist_ik + dist_jk;
 
-					update_terms(&hfstk); /* Update array of terminals. */
-					hfstk.length = hfsti -> length + hfstj -> length + dist_ik + dist_jk;
+		/* If the Steiner point is VERY close to one of the points then
+		   it is defined as overlapping and should not be extended */
+		hfstk.type = TYPE_CORNER;
 
-					/* If the Steiner point is VERY close to one of the points then
-					   it is defined as overlapping and should not be extended */
-					hfstk.type = TYPE_CORNER;
+		if ( (points_close(&hfstk.root, iRoot, uip -> eps)) OR 
+		     (points_close(&hfstk.root, jRoot, uip -> eps)) ) {
+			hfstk.type = TYPE_STRAIGHT;
+		}
 
-					if ( (points_close(&hfstk.root, iRoot, uip -> eps)) OR 
-					     (points_close(&hfstk.root, jRoot, uip -> eps)) ) {
-						hfstk.type = TYPE_STRAIGHT;
-					}
+		/* Can this hFST be extended */
+		extensions = 0;
 
-					/* Can this hFST be extended */
-					extensions = 0;
-
-					/* No need to extend if Steiner point overlaps with children
-					   or the meeting angle is not legal at Steiner points */
-					if ((meetangle <= max_angle) AND (hfstk.type == TYPE_CORNER)) {
-						/* Setup the extensions */
-						extensions = setup_extensions(&hfstk, metric, meetangle);
-
-						/* Can the wedge test remove the extension(s) */
-						if (DoWedgeTest AND extensions) {
-							/* Check the first extension */
-							if (wedge_test (uip, &hfstk)) {
-								extensions--;
-								if (extensions) {
-									/* Check the second extension */
-									hfstk.status = STATE_CLEAN;
-									hfstk.ext = (hfstk.ext + 1) % K;
-									if (wedge_test(uip, &hfstk)) {
-										extensions--;
-									}
-								}
-							}
+		/* No need to extend if Steiner point overlaps with children
+		   or the meeting angle is not legal at Steiner points */
+		if ((meetangle <= max_angle) AND (hfstk.type == TYPE_CORNER)) {
+			/* Setup the extensions */
+			extensions = setup_extensions(&hfstk, metric, meetangle);
 
+			/* Can the wedge test remove the extension(s) */
+			if (DoWedgeTest AND extensions) {
+				/* Check the first extension */
+				if (wedge_test (uip, &hfstk)) {
+					extensions--;
+					if (extensions) {
+						/* Check the second extension */
+						hfstk.status = STATE_CLEAN;
+						hfstk.ext = (hfstk.ext + 1) % K;
+						if (wedge_test(uip, &hfstk)) {
+							extensions--;
 						}
 					}
+				}
 
-					cachedMST = 0;
+			}
+		}
 
-					if (extensions) {
-						struct hFST *tmp;
-						struct hFST *before = NULL, *after;
-						int *termsk = hfstk.terms;
-						if (NOT upper_bound_tests (uip, &hfstk, TRUE)) continue;
-						/* Length of hFST is UB for tree spanning terminals */
-						if (Verbose) start_timer(counters[UPDATE_UB]);
-						if (size > 2) {
-							bool first_found = FALSE;
-							struct hFST *hfstl;
-
-							if (hfstk.UB > eps_factor * hfstk.length) {
-								hfstk.UB = hfstk.length;
-							}
-
-							/* Heuristic upper bound */
-							if (NOT cachedMST) {
-								cachedMST = hfst_mst (uip, &hfstk, FALSE);
-							}
-							if (hfstk.UB > eps_factor * cachedMST) {
-								hfstk.UB = cachedMST;
-							}
-
-							/* Now check if there is another hFST spanning the same set of terminals */
-							for (hfstl = hFST_Lists[size]; hfstl; hfstl = hfstl -> next) {
-								int *terms = hfstl -> terms;
-								if (identical_lists(terms, termsk)) {
-									first_found = TRUE;
-									if (hfstl->UB <= hfstk.UB) {
-										hfstk.UB = hfstl->UB;
-										/* This is deliberate (and correct) */
-										break;
-									}
-									else {
-										hfstl->UB = hfstk.UB;
-									}
-								}
-								else if (first_found) {
-									break;
-								}
-							}
-						}
-						if (Verbose) stop_timer (counters[UPDATE_UB], FALSE);
+		cachedMST = 0;
 
-						/* Sorted insertion of the hFST */
+		if (extensions) {
+			struct hFST *tmp;
+			if (NOT upper_bound_tests (uip, &hfstk, TRUE)) continue;
+			/* Length of hFST is UB for tree spanning terminals */
+			if (uip -> counters NE NULL) start_timer (uip -> counters[UPDATE_UB]);
+			if (size > 2) {
+				if (hfstk.UB > eps_factor * hfstk.length) {
+					hfstk.UB = hfstk.length;
+				}
 
-						for (after = hFST_Lists[size]; after; after = after -> next) {
-							int *terms = after -> terms;
-							if (identical_lists(terms, termsk)) {
-								after -> prev_identical = TRUE;
-								break;
-							}
-							before = after;
-						}
+				/* Heuristic upper bound */
+				if (NOT cachedMST) {
+					cachedMST = hfst_mst (uip, &hfstk, FALSE);
+				}
+				if (hfstk.UB > eps_factor * cachedMST) {
+					hfstk.UB = cachedMST;
+				}
+			}
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[UPDATE_UB], FALSE);
 
-						tmp = NEW (struct hFST);
-						*tmp = hfstk;
-						if (before) {
-							before -> next = tmp;
-						}
-						else {
-							hFST_Lists[size] = tmp;
-						}
+			/* The new hFST is inserted into the list of its	*/
+			/* size (where other hFSTs spanning the same		*/
+			/* terminals may lower its UB) when the chunk is	*/
+			/* merged.						*/
 
-						if (extensions EQ 2) {
-							hfstk.ext = (hfstk.ext + 1) % K;
-							hfstk.status = STATE_CLEAN;
-
-							if (NOT (DoWedgeTest AND wedge_test(uip, &hfstk))) {
-								struct hFST *tmp2 = NEW (struct hFST);
-								*tmp2 = hfstk;
-								tmp2 -> terms = NEWA (size+1, int);
-								memcpy (tmp2 -> terms, tmp -> terms, (size + 1)*sizeof (int));
-								tmp2 -> prev_identical = TRUE;
-								tmp -> next = tmp2;
-								tmp = tmp2;
-
-								hFSTcount++;
-							}
-						}
+			tmp = NEW (struct hFST);
+			*tmp = hfstk;
+			tmp -> next = NULL;
 
-						tmp -> next = after;
+			if (extensions EQ 2) {
+				hfstk.ext = (hfstk.ext + 1) % K;
+				hfstk.status = STATE_CLEAN;
 
-						hfstk.terms = NEWA (size+1, int);
-						memcpy (hfstk.terms, tmp -> terms, (size + 1)*sizeof (int));
+				if (NOT (DoWedgeTest AND wedge_test(uip, &hfstk))) {
+					struct hFST *tmp2 = NEW (struct hFST);
+					*tmp2 = hfstk;
+					tmp2 -> terms = NEWA (size+1, int);
+					memcpy (tmp2 -> terms, tmp -> terms, (size + 1)*sizeof (int));
+					tmp2 -> prev_identical = TRUE;
+					tmp2 -> next = NULL;
+					tmp -> next = tmp2;
 
-						hFSTcount++;
-					}
+					++(tp -> hFSTcount);
+				}
+			}
 
-					if (Verbose) start_timer(counters[FSTCHECK]);
+			cp = new_ucand (ch);
+			cp -> hfst = tmp;
 
-					/* Make sure the bent edge has an angle of \pi - \omega */
-					if (meetangle < lambda - 1) {
-						if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-						continue;
-					}
+			hfstk.terms = NEWA (size+1, int);
+			memcpy (hfstk.terms, tmp -> terms, (size + 1)*sizeof (int));
+
+			++(tp -> hFSTcount);
+		}
+
+		if (uip -> counters NE NULL) start_timer (uip -> counters[FSTCHECK]);
+
+		/* Make sure the bent edge has an angle of \pi - \omega */
+		if (meetangle < lambda - 1) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+			continue;
+		}
+
+		/* A subtle restriction... :-)
+		   Gives us the correct primary/secondary shape
+		   of the bent edge. */
+		if (*tLeft -> terms < *tRight -> terms) {
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+			continue;
+		}
 
-					/* A subtle restriction... :-)
-					   Gives us the correct primary/secondary shape
-					   of the bent edge. */
-					if (*tLeft -> terms < *tRight -> terms) {
-						if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
+		if (size EQ 2) {
+			if (uip -> counters NE NULL) start_timer (uip -> counters[MSTEDGE]);
+			if (NOT _gst_is_mst_edge(BSD, tLeft->index, tRight->index)) {
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[MSTEDGE], TRUE);
+				continue;
+			}
+			if (uip -> counters NE NULL) stop_timer (uip -> counters[MSTEDGE], FALSE);
+		}
+		else { /* size > 2 */
+			if (tRight -> status EQ STATE_CLEAN) {
+				/* The bent edge cannot appear
+				   in a tree to the right */
+				if (lambda % 3 EQ 0) {
+					if (NOT tRight -> mixable) {
+						if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
 						continue;
 					}
-
-					if (size EQ 2) {
-						if (Verbose) start_timer(counters[MSTEDGE]);
-						if (NOT _gst_is_mst_edge(BSD, tLeft->index, tRight->index)) {
-							if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-							if (Verbose) stop_timer (counters[MSTEDGE], TRUE);
-							continue;
-						}
-						if (Verbose) stop_timer (counters[MSTEDGE], FALSE);
+				}
+				else {
+					if (tRight -> right_legs[0]) {
+						if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+						continue;
 					}
-					else { /* size > 2 */
-						if (tRight -> status EQ STATE_CLEAN) {
-							/* The bent edge cannot appear
-							   in a tree to the right */
-							if (lambda % 3 EQ 0) {
-								if (NOT tRight -> mixable) {
-									if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-									continue;
-								}
-							}
-							else {
-								if (tRight -> right_legs[0]) {
-									if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-									continue;
-								}
-							}
-						}
-						else { /* tRight->Status EQ STATE_MIXED */
-							/* The mixed edge has to be the bent edge
-							   when lambda NE 3m */
-							if (lambda % 3 NE 0 AND tRight->mixed_index NE 0) {
-								if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-								continue;
-							}
-						}
-
-						if (Verbose) start_timer(counters[LENGTH]);
-						if (hfstk.length > eps_factor * hfstk.UB) {
-							if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-							if (Verbose) stop_timer (counters[LENGTH], TRUE);
-							continue;
-						}
-						if (Verbose) stop_timer (counters[LENGTH], FALSE);
+				}
+			}
+			else { /* tRight->Status EQ STATE_MIXED */
+				/* The mixed edge has to be the bent edge
+				   when lambda NE 3m */
+				if (lambda % 3 NE 0 AND tRight->mixed_index NE 0) {
+					if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+					continue;
+				}
+			}
 
-						if (dist_ik + dist_jk > eps_factor * hfstk.BS) {
-							if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-							continue;
-						}
+			/* The length is checked against the UB when the	*/
+			/* chunk is merged.					*/
 
-						if (NOT extensions) {
-							if (NOT upper_bound_tests (uip, &hfstk, FALSE)) continue;
-						}
+			if (dist_ik + dist_jk > eps_factor * hfstk.BS) {
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+				continue;
+			}
 
-						/* Compute MST for terminals and Steiner points */
-						if (NOT cachedMST) {
-							cachedMST = hfst_mst(uip, &hfstk, FALSE);
-						}
-						if (hfstk.length > eps_factor * cachedMST) {
-							if (Verbose) stop_timer (counters[FSTCHECK], TRUE);
-							continue;
-						}
-					}
-					if (Verbose) stop_timer (counters[FSTCHECK], FALSE);
+			if (NOT extensions) {
+				if (NOT upper_bound_tests (uip, &hfstk, FALSE)) continue;
+			}
 
-					test_and_save_fst (uip, &hfstk);
-				}
+			/* Compute MST for terminals and Steiner points */
+			if (NOT cachedMST) {
+				cachedMST = hfst_mst(uip, &hfstk, FALSE);
+			}
+			if (hfstk.length > eps_factor * cachedMST) {
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], TRUE);
+				continue;
 			}
 		}
-		free (hfstk.terms);
+		if (uip -> counters NE NULL) stop_timer (uip -> counters[FSTCHECK], FALSE);
 
-		if (timing NE NULL) {
-			_gst_convert_delta_cpu_time (buf1, Tn);
-			gst_channel_printf (timing, "Size %3d generation:    %s\n", size, buf1);
+		record_fst (ch, &cp, &hfstk, (size > 2) ? SAVE_FST_IF_UB : SAVE_FST);
+		++(tp -> nfsts);
+	}
+
+	/* hfstk.terms may have been replaced. */
+	tp -> hfstk = hfstk;
+}
+
+/*
+ * Append a new, empty candidate to the given chunk.
+ */
+
+	static
+	struct ucand *
+new_ucand (
+
+struct uchunk *		ch	/* IN/OUT - chunk */
+)
+{
+struct ucand *		cp;
+struct ucand *		cands;
+
+	if (ch -> ncands >= ch -> cands_size) {
+		ch -> cands_size = (ch -> cands_size EQ 0) ? 16 : 2 * ch -> cands_size;
+		cands = NEWA (ch -> cands_size, struct ucand);
+		if (ch -> ncands > 0) {
+			memcpy (cands, ch -> cands, ch -> ncands * sizeof (struct ucand));
 		}
+		if (ch -> cands NE NULL) {
+			free (ch -> cands);
+		}
+		ch -> cands = cands;
 	}
 
-	free (isLeftRight);
-	free (meetAngles);
+	cp = &(ch -> cands [(ch -> ncands)++]);
+	memset (cp, 0, sizeof (*cp));
 
-	if (Verbose) {
-		int genTime;
-		int iterations = counters[SUBPATH] -> queries;
-		stop_timer (counters[GENERATOR], FALSE);
-		genTime = counters[GENERATOR] -> elapsed_time;
+	return (cp);
+}
 
-		fprintf (stderr, "FST-count: %d, hFSTCount: %d\n",
-			uip -> ntrees, hFSTcount);
+/*
+ * Record an FST to be saved when the chunk is merged, in the candidate
+ * of its hFST (if there is one).
+ */
 
-		fprintf (stderr, "\n              Queries          Pruned                Left               Time\n");
-		for (i=0; i<NUM_OF_COUNTERS; i++) {
-			fprintf (stderr, "%-12s: %8d - %8d (%6.2f%%) = %8d (%6.2f%%),\t%3d (%6.2f%%)\n",
-			 counters[i] -> name,
-			 counters[i] -> queries,
-			 counters[i] -> pruned,
-			 100.0*counters[i] -> pruned
-			  / counters[i] -> queries,
-			 counters[i] -> queries - counters[i] -> pruned,
-			 100.0 * (counters[i] -> queries - counters[i]->pruned)
-			  / iterations,
-			 counters[i] -> elapsed_time,
-			 100.0*counters[i] -> elapsed_time/genTime);
+	static
+	void
+record_fst (
+
+struct uchunk *		ch,	/* IN/OUT - chunk */
+struct ucand **		cpp,	/* IN/OUT - candidate of the current hFST */
+struct hFST *		fst,	/* IN - FST to be saved */
+int			save	/* IN - SAVE_FST or SAVE_FST_IF_UB */
+)
+{
+struct ucand *		cp;
+
+	cp = *cpp;
+	if (cp EQ NULL) {
+		cp = new_ucand (ch);
+		*cpp = cp;
+	}
+
+	cp -> fst	= *fst;
+	cp -> fst.terms	= NEWA (fst -> S + 1, int);
+	memcpy (cp -> fst.terms, fst -> terms, (fst -> S + 1) * sizeof (int));
+	cp -> save	= save;
+}
+
+/*
+ * Insert the new hFSTs of a chunk into the list of their size and save
+ * its FSTs.  The chunks must be merged in order.
+ */
+
+	static
+	void
+merge_hfst_chunk (
+
+struct uinfo *		uip,		/* IN/OUT - global UFST info */
+struct hFST **		hFST_Lists,	/* IN/OUT - hFSTs of each size */
+int			size,		/* IN - size of the new hFSTs */
+struct uchunk *		ch		/* IN - chunk to merge */
+)
+{
+int			i;
+dist_t			eps_factor;
+struct ucand *		cp;
+
+	eps_factor = 1.0 + uip -> eps;
+
+	for (i = 0; i < ch -> ncands; i++) {
+		cp = &(ch -> cands [i]);
+
+		if (cp -> hfst NE NULL) {
+			insert_hfst (uip, hFST_Lists, size, cp -> hfst);
+			cp -> fst.UB = cp -> hfst -> UB;
+		}
 
-			free (counters[i]);
+		if (cp -> save EQ SAVE_FST_IF_UB) {
+			if (uip -> counters NE NULL) start_timer (uip -> counters[LENGTH]);
+			if (cp -> fst.length > eps_factor * cp -> fst.UB) {
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[LENGTH], TRUE);
+				cp -> save = SAVE_NONE;
+			}
+			else {
+				if (uip -> counters NE NULL) stop_timer (uip -> counters[LENGTH], FALSE);
+			}
+		}
+
+		if (cp -> save NE SAVE_NONE) {
+			test_and_save_fst (uip, &(cp -> fst));
+		}
+		if (cp -> fst.terms NE NULL) {
+			free (cp -> fst.terms);
 		}
-		fprintf (stderr, "\n");
 	}
 
-	uip -> hFSTCount = hFSTcount;
+	if (ch -> cands NE NULL) {
+		free (ch -> cands);
+	}
+}
 
-	for (i = 0; i <= n; i++) {
-		if (hFST_Lists[i]) {
-			struct hFST *hfst = hFST_Lists[i];
-			while (hfst) {
-				struct hFST *tmp = hfst -> next;
-				free (hfst -> terms);
-				free (hfst);
-				hfst = tmp;
+/*
+ * Insert a new hFST (and its twin with the other extension, if any)
+ * into the list of its size, just before the other hFSTs spanning the
+ * same terminals.  All of these share the smallest upper bound found
+ * so far.
+ */
+
+	static
+	void
+insert_hfst (
+
+struct uinfo *		uip,		/* IN - global UFST info */
+struct hFST **		hFST_Lists,	/* IN/OUT - hFSTs of each size */
+int			size,		/* IN - size of the new hFST */
+struct hFST *		hfst		/* IN - new hFST */
+)
+{
+int *			termsk;
+bool			first_found;
+struct hFST *		hfstl;
+struct hFST *		tmp;
+struct hFST *		before;
+struct hFST *		after;
+
+	termsk	= hfst -> terms;
+	tmp	= (hfst -> next NE NULL) ? hfst -> next : hfst;
+
+	if (uip -> counters NE NULL) start_timer (uip -> counters[UPDATE_UB]);
+	if (size > 2) {
+		/* Now check if there is another hFST spanning the same set of terminals */
+		first_found = FALSE;
+		for (hfstl = hFST_Lists[size]; hfstl; hfstl = hfstl -> next) {
+			int *terms = hfstl -> terms;
+			if (identical_lists(terms, termsk)) {
+				first_found = TRUE;
+				if (hfstl->UB <= hfst->UB) {
+					hfst->UB = hfstl->UB;
+					/* This is deliberate (and correct) */
+					break;
+				}
+				else {
+					hfstl->UB = hfst->UB;
+				}
+			}
+			else if (first_found) {
+				break;
 			}
 		}
+		tmp -> UB = hfst -> UB;
 	}
-	free (hFST_Lists);
+	if (uip -> counters NE NULL) stop_timer (uip -> counters[UPDATE_UB], FALSE);
 
-	/* Translate terminals back */
-	for (k = 0; k < n; k++) {
-		pts -> a[k] = uip -> pts_org -> a[k];
+	/* Sorted insertion of the hFST */
+
+	before = NULL;
+	for (after = hFST_Lists[size]; after; after = after -> next) {
+		int *terms = after -> terms;
+		if (identical_lists(terms, termsk)) {
+			after -> prev_identical = TRUE;
+			break;
+		}
+		before = after;
 	}
-	free (uip -> pts_org);
 
-	destroy_uinfo (uip);
+	if (before) {
+		before -> next = hfst;
+	}
+	else {
+		hFST_Lists[size] = hfst;
+	}
+	tmp -> next = after;
 }
-
+
 /*
  * Initialize various stuff in the uinfo structure.
  */
@@ -1409,37 +1849,37 @@ dist_t		eps_factor;
 
 	/* 1. upper bound */
 
-	if (Verbose) start_timer(counters[UB1]);
+	if (uip -> counters NE NULL) start_timer (uip -> counters[UB1]);
 	distr = closest_terminal (hfst -> right_tree, uip -> metric, &hfst -> root);
 	distl = closest_terminal (hfst -> left_tree,  uip -> metric, &hfst -> root);
 	upper_bound = hfst -> right_tree -> UB + hfst -> left_tree -> UB + distr + distl;
 	if (eps_factor * upper_bound < hfst -> length) {
-		if (Verbose)	stop_timer (counters[UB1], TRUE);
+		if (uip -> counters NE NULL)	stop_timer (uip -> counters[UB1], TRUE);
 		return FALSE;
 	}
-	if (Verbose)	stop_timer (counters[UB1], FALSE);
+	if (uip -> counters NE NULL)	stop_timer (uip -> counters[UB1], FALSE);
 
 	/* 2. upper bound */
 
-	if (Verbose) start_timer(counters[UB2]);
+	if (uip -> counters NE NULL) start_timer (uip -> counters[UB2]);
 	upper_bound = hfst -> right_tree -> UB + hfst -> left_tree -> UB
 			+ MIN(distr, distl) + hfst -> BS;
 	if (eps_factor * upper_bound < hfst -> length) {
-		if (Verbose) stop_timer (counters[UB2], TRUE);
+		if (uip -> counters NE NULL) stop_timer (uip -> counters[UB2], TRUE);
 		return FALSE;
 	}
-	if (Verbose)	stop_timer (counters[UB2], FALSE);
+	if (uip -> counters NE NULL)	stop_timer (uip -> counters[UB2], FALSE);
 
 	/* 3. upper bound */
 
 	if (all_tests) {
-		if (Verbose) start_timer(counters[UB3]);
+		if (uip -> counters NE NULL) start_timer (uip -> counters[UB3]);
 		upper_bound = hfst_mst (uip, hfst, TRUE);
 		if (eps_factor * upper_bound < hfst -> length) {
-			if (Verbose)	stop_timer (counters[UB3], TRUE);
+			if (uip -> counters NE NULL)	stop_timer (uip -> counters[UB3], TRUE);
 			return FALSE;
 		}
-		if (Verbose)	stop_timer (counters[UB3], FALSE);
+		if (uip -> counters NE NULL)	stop_timer (uip -> counters[UB3], FALSE);
 	}
 
 	return TRUE;
@@ -1474,7 +1914,7 @@ struct pset *	pts;
 		return 0;
 	}
 
-	if (Verbose)	start_timer(counters[WEDGE]);
+	if (uip -> counters NE NULL)	start_timer (uip -> counters[WEDGE]);
 
 	/* Mark all terminals which are members of this hFST */
 	set_member(hfst, uip -> term_check, TRUE);
@@ -1557,7 +1997,7 @@ struct pset *	pts;
 	}
 
 	set_member(hfst, uip->term_check, FALSE);
-	if (Verbose) stop_timer (counters[WEDGE], prunable);
+	if (uip -> counters NE NULL) stop_timer (uip -> counters[WEDGE], prunable);
 
 	return (prunable);
 }
@@ -1985,6 +2425,7 @@ found_ufst:
 		up1 = up -> back;
 		up2 -> back = up1;
 		up1 -> forw = up2;
+		free ((char *) (fsp -> tlist));
 		free ((char *) (fsp -> terminals));
 		free ((char *) (fsp -> steiners));
 		free ((char *) (fsp -> edges));
@@ -2056,6 +2497,9 @@ found_ufst:
 
 	if (new_steiners NE NULL) {
 		new_steiners -> n = steiner_num;
+		for (i = 0; i < steiner_num; i++) {
+			new_steiners -> a [i].battery = 0.0;  /* Steiner points have no battery */
+		}
 	}
 
 	new_terms = NEW_PSET (size);
@@ -2091,15 +2535,15 @@ found_ufst:
 	fsp -> next		= NULL;
 	fsp -> tree_num		= 0;
 	fsp -> tree_len		= fst -> length;
-	fsp->battery_score = 0.0;
-	for (i = 0; i < fsp->terminals->n; i++) {
-		fsp->battery_score += fsp->terminals->a[i].battery;
-	}
 	fsp -> tlist		= new_tlist;
 	fsp -> terminals	= new_terms;
 	fsp -> steiners		= new_steiners;
 	fsp -> nedges		= nedges;
 	fsp -> edges		= edges;
+	fsp->battery_score = 0.0;
+	for (i = 0; i < fsp->terminals->n; i++) {
+		fsp->battery_score += fsp->terminals->a[i].battery;
+	}
 
 	up = NEW (struct ulist);
 
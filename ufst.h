@@ -41,6 +41,7 @@ struct full_set;
 struct gst_metric;
 struct point;
 struct pset;
+struct time_it;
 
 /*
  * A structure to keep track of one UFST.  They are kept in a hash table
@@ -93,6 +94,9 @@ struct uinfo {
 
 	/* Concatenator related */
 	int hFSTCount;
+
+	struct time_it ** counters;	/* Statistics timers (of this thread), */
+					/* NULL unless timings are requested */
 };
 
 /*
@@ -155,11 +159,4 @@ extern struct gst_hypergraph *
 				    struct gst_param *	params,
 				    int *		status);
 
-/*
- * It is possible to get extra statistical info by defining the macro below.
- */
-
-/* #define STATISTICS_ENABLED
-*/
-
 #endif
@@ -37,6 +37,7 @@
 #include "weak.h"
 
 #include "bb.h"
+#include "bitmap.h"
 #include "constrnt.h"
 #include "fatal.h"
 #include "geosteiner.h"
@@ -707,19 +708,13 @@ struct bbinfo *		bbip,		/* IN - branch and bound info */
 double			weight		/* IN - weight of the cut */
 )
 {
-int			i;
 int			n;
 struct constraint *	p;
 bitmap_t *		bp1;
 bitmap_t *		bp2;
 bitmap_t *		bp3;
-bitmap_t		mask;
 
-	n = 0;
-	for (i = 0; i < kmasks; i++) {
-		mask = stour [i];
-		n += NBITSON (mask);
-	}
+	n = _gst_bitmap_count (stour, kmasks * BPW);
 
 	if ((n > 25) AND (n < (nverts - 25))) {
 		return (cp);